@@ -0,0 +1,223 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <core23/logger.hpp>
+#include <core23/tracer.hpp>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+
+namespace HugeCTR {
+
+namespace {
+
+size_t read_buffer_size() {
+  const char* const size_str = std::getenv("HUGECTR_TRACE_BUFFER_SIZE");
+  if (size_str != nullptr && size_str[0] != '\0') {
+    size_t size;
+    if (std::sscanf(size_str, "%zu", &size) == 1 && size > 0) {
+      return size;
+    }
+  }
+  return Tracer::default_buffer_size;
+}
+
+void write_json_string(std::ostream& os, const char* s) {
+  os << '"';
+  for (; *s != '\0'; ++s) {
+    const char c = *s;
+    if (c == '"' || c == '\\') {
+      os << '\\' << c;
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      char code[8];
+      std::snprintf(code, sizeof(code), "\\u%04x", c);
+      os << code;
+    } else {
+      os << c;
+    }
+  }
+  os << '"';
+}
+
+void write_timestamp(std::ostream& os, const int64_t ns) {
+  // Chrome traces are in microseconds.
+  char us[32];
+  std::snprintf(us, sizeof(us), "%.3f", static_cast<double>(ns) * 1e-3);
+  os << us;
+}
+
+}  // namespace
+
+std::atomic<bool> Tracer::enabled_{false};
+
+// Querying the logger here also ensures that it outlives the tracer.
+Tracer::Tracer()
+    : rank_{Logger::get().get_rank()}, buffer_size_{read_buffer_size()}, origin_ns_{now()} {
+  const char* const trace_str = std::getenv("HUGECTR_TRACE");
+  if (trace_str != nullptr && std::atoi(trace_str) > 0) {
+    enable();
+  }
+
+  const char* const path_str = std::getenv("HUGECTR_TRACE_FILE");
+  if (path_str != nullptr && path_str[0] != '\0') {
+    dump_path_ = path_str;
+    const size_t pos = dump_path_.find("{rank}");
+    if (pos != std::string::npos) {
+      dump_path_.replace(pos, 6, std::to_string(rank_));
+    }
+  }
+}
+
+Tracer::~Tracer() {
+  if (!dump_path_.empty()) {
+    disable();
+    try {
+      dump(dump_path_);
+    } catch (...) {
+      // The process is shutting down; there is nobody left to report to.
+    }
+  }
+}
+
+Tracer& Tracer::get() {
+  static Tracer instance;
+  return instance;
+}
+
+int64_t Tracer::now() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+void Tracer::enable() { enabled_.store(true, std::memory_order_relaxed); }
+
+void Tracer::disable() { enabled_.store(false, std::memory_order_relaxed); }
+
+void Tracer::clear() {
+  const std::lock_guard<std::mutex> lock(mutex_);
+  for (const auto& buffer : buffers_) {
+    const std::lock_guard<std::mutex> buffer_lock(buffer->mutex);
+    buffer->num_recorded = 0;
+  }
+}
+
+Tracer::ThreadBuffer& Tracer::local_buffer_() {
+  // The tracer shares ownership, so that events of threads that have already exited can still be
+  // dumped.
+  static thread_local std::shared_ptr<ThreadBuffer> local;
+  if (!local) {
+    local = std::make_shared<ThreadBuffer>();
+    local->events.resize(buffer_size_);
+    if (Logger::has_thread_name()) {
+      local->thread_name = Logger::get_thread_name();
+    }
+
+    const std::lock_guard<std::mutex> lock(mutex_);
+    local->tid = buffers_.size() + 1;
+    if (local->thread_name.empty()) {
+      local->thread_name = "thread " + std::to_string(local->tid);
+    }
+    buffers_.emplace_back(local);
+  }
+  return *local;
+}
+
+void Tracer::record(const char* const name, const int64_t begin_ns, const int64_t end_ns) {
+  ThreadBuffer& buffer = local_buffer_();
+
+  // Only contended while dumping.
+  const std::lock_guard<std::mutex> lock(buffer.mutex);
+  buffer.events[buffer.num_recorded % buffer.events.size()] = {name, begin_ns, end_ns};
+  ++buffer.num_recorded;
+}
+
+size_t Tracer::num_events() const {
+  size_t n = 0;
+  const std::lock_guard<std::mutex> lock(mutex_);
+  for (const auto& buffer : buffers_) {
+    const std::lock_guard<std::mutex> buffer_lock(buffer->mutex);
+    n += std::min(buffer->num_recorded, buffer->events.size());
+  }
+  return n;
+}
+
+size_t Tracer::num_dropped() const {
+  size_t n = 0;
+  const std::lock_guard<std::mutex> lock(mutex_);
+  for (const auto& buffer : buffers_) {
+    const std::lock_guard<std::mutex> buffer_lock(buffer->mutex);
+    if (buffer->num_recorded > buffer->events.size()) {
+      n += buffer->num_recorded - buffer->events.size();
+    }
+  }
+  return n;
+}
+
+void Tracer::dump(std::ostream& os) const {
+  const int pid = rank_;
+
+  os << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+  os << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << pid
+     << ",\"tid\":0,\"args\":{\"name\":\"HugeCTR rank " << pid << "\"}}";
+
+  std::vector<TraceEvent> events;
+  const std::lock_guard<std::mutex> lock(mutex_);
+  for (const auto& buffer : buffers_) {
+    // Copy, so that the recording thread is blocked as briefly as possible.
+    size_t num_recorded;
+    {
+      const std::lock_guard<std::mutex> buffer_lock(buffer->mutex);
+      num_recorded = buffer->num_recorded;
+      const size_t n = std::min(num_recorded, buffer->events.size());
+      const size_t first = num_recorded - n;
+      events.resize(n);
+      for (size_t i = 0; i < n; ++i) {
+        events[i] = buffer->events[(first + i) % buffer->events.size()];
+      }
+    }
+    if (num_recorded == 0) {
+      continue;
+    }
+
+    os << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << pid << ",\"tid\":" << buffer->tid
+       << ",\"args\":{\"name\":";
+    write_json_string(os, buffer->thread_name.c_str());
+    os << "}}";
+
+    for (const TraceEvent& event : events) {
+      os << ",\n{\"name\":";
+      write_json_string(os, event.name);
+      os << ",\"ph\":\"X\",\"pid\":" << pid << ",\"tid\":" << buffer->tid << ",\"ts\":";
+      write_timestamp(os, event.begin_ns - origin_ns_);
+      os << ",\"dur\":";
+      write_timestamp(os, event.end_ns - event.begin_ns);
+      os << '}';
+    }
+  }
+  os << "\n]}\n";
+}
+
+void Tracer::dump(const std::string& path) const {
+  std::ofstream file(path);
+  HCTR_THROW_IF(!file.is_open(), Error_t::FileCannotOpen, "Cannot open trace file '", path, "'.");
+  dump(file);
+  HCTR_THROW_IF(!file.good(), Error_t::BrokenFile, "Failed to write trace file '", path, "'.");
+}
+
+}  // namespace HugeCTR
@@ -0,0 +1,174 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+/*
+ * Host-side timeline tracing.
+ *
+ * Code regions are marked with HCTR_TRACE_SCOPE, which records when the enclosing scope was entered
+ * and left by the calling thread. Each thread appends its events to its own ring buffer, so that
+ * recording does not contend with other threads. If a buffer is full, the oldest events of that
+ * thread are overwritten. The collected events can be written as Chrome trace JSON at any time,
+ * and opened in chrome://tracing or https://ui.perfetto.dev.
+ *
+ * Tracing is disabled by default. While it is disabled, a marker costs a single relaxed load.
+ *
+ * 1. Examples:
+     void Model::eval() {
+       HCTR_TRACE_SCOPE("Model::eval");
+       ...
+     }
+
+     Tracer::get().enable();
+     ...
+     Tracer::get().dump("trace.json");
+
+ * 2. Environment variables:
+     HUGECTR_TRACE=1                Enable tracing at startup.
+     HUGECTR_TRACE_FILE=<path>      Dump the trace at exit. "{rank}" is replaced by the MPI rank.
+     HUGECTR_TRACE_BUFFER_SIZE=<n>  Events kept per thread (default 65536).
+ */
+
+#include <atomic>
+#include <core/macro.hpp>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace HugeCTR {
+
+struct TraceEvent {
+  const char* name;  // Must point to a string with static storage duration.
+  int64_t begin_ns;
+  int64_t end_ns;
+};
+
+class Tracer final {
+ public:
+  static constexpr size_t default_buffer_size{65536};
+
+  HCTR_DISALLOW_COPY_AND_MOVE(Tracer);
+
+  static Tracer& get();
+
+  inline static bool enabled() { return enabled_.load(std::memory_order_relaxed); }
+
+  /**
+   * @return Nanoseconds on a steady clock.
+   */
+  static int64_t now();
+
+  void enable();
+
+  void disable();
+
+  /**
+   * Drops all events recorded so far.
+   */
+  void clear();
+
+  /**
+   * Records that the calling thread spent [begin_ns, end_ns) in \p name.
+   */
+  void record(const char* name, int64_t begin_ns, int64_t end_ns);
+
+  /**
+   * @return Number of events that are currently held.
+   */
+  size_t num_events() const;
+
+  /**
+   * @return Number of events that were overwritten, because a thread's buffer was full.
+   */
+  size_t num_dropped() const;
+
+  /**
+   * Writes the recorded events in Chrome trace JSON format. Recording may continue meanwhile.
+   */
+  void dump(std::ostream& os) const;
+
+  void dump(const std::string& path) const;
+
+ private:
+  struct ThreadBuffer final {
+    std::mutex mutex;
+    size_t tid;
+    std::string thread_name;
+    std::vector<TraceEvent> events;  // Ring buffer.
+    size_t num_recorded{0};
+  };
+
+  static std::atomic<bool> enabled_;
+
+  const int rank_;
+  const size_t buffer_size_;
+  const int64_t origin_ns_;
+  std::string dump_path_;
+
+  mutable std::mutex mutex_;
+  std::vector<std::shared_ptr<ThreadBuffer>> buffers_;
+
+  Tracer();
+
+  ~Tracer();
+
+  ThreadBuffer& local_buffer_();
+};
+
+/**
+ * @brief Records the lifetime of this object, if tracing is enabled when it is created.
+ */
+class TraceScope final {
+ public:
+  HCTR_DISALLOW_COPY_AND_MOVE(TraceScope);
+
+  inline explicit TraceScope(const char* const name)
+      : name_{name}, begin_ns_{Tracer::enabled() ? Tracer::now() : -1} {}
+
+  inline ~TraceScope() {
+    if (begin_ns_ >= 0) {
+      Tracer::get().record(name_, begin_ns_, Tracer::now());
+    }
+  }
+
+ private:
+  const char* const name_;
+  const int64_t begin_ns_;
+};
+
+}  // namespace HugeCTR
+
+#ifdef HCTR_TRACE_CONCAT_
+#error HCTR_TRACE_CONCAT_ already defined. Potential naming conflict!
+#endif
+#define HCTR_TRACE_CONCAT_(A, B) A##B
+
+#ifdef HCTR_TRACE_SCOPE_
+#error HCTR_TRACE_SCOPE_ already defined. Potential naming conflict!
+#endif
+#define HCTR_TRACE_SCOPE_(NAME, LINE) \
+  const HugeCTR::TraceScope HCTR_TRACE_CONCAT_(_hctr_trace_scope_, LINE)("" NAME)
+
+/**
+ * Traces the enclosing scope. \p NAME must be a string literal.
+ */
+#ifdef HCTR_TRACE_SCOPE
+#error HCTR_TRACE_SCOPE already defined. Potential naming conflict!
+#endif
+#define HCTR_TRACE_SCOPE(NAME) HCTR_TRACE_SCOPE_(NAME, __LINE__)
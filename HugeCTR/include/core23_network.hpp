@@ -31,6 +31,8 @@
 
 namespace HugeCTR {
 
+class FileSystem;
+
 /**
  * @brief Dense network (embedding is not included)
  *
@@ -94,11 +96,13 @@ class Network final {
    * Writing parameters to file.
    */
   void download_params_to_host(const std::string& write_path);
+  void download_params_to_host(const std::string& write_path, FileSystem& fs);
 
   /**
    * Writing opt states to file.
    */
   void download_opt_states_to_host(const std::string& write_path);
+  void download_opt_states_to_host(const std::string& write_path, FileSystem& fs);
 
   /**
    * Get no trained parameters (such as parameters in Batch nomalization) to string.
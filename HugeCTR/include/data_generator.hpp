@@ -113,12 +113,16 @@ class IntPowerLawDataSimulator : public IDataSimulator<T> {
     min_ = 1.0;
     max_ = max - min + 1.0;
     offset_ = min - 1.0;  // to handle the case min_ <= 0
+
+    // Loop invariant terms of the inverse CDF. Leaves a single pow() per sample.
+    pow_min_ = pow(min_, 1 - alpha_);
+    pow_range_ = pow(max_, 1 - alpha_) - pow_min_;
+    inv_exponent_ = 1.0 / (1.0 - alpha_);
   }
 
   T get_num() override {
     double x = dis_(gen_);
-    double y = (pow((pow(max_, 1 - alpha_) - pow(min_, 1 - alpha_)) * x + pow(min_, 1 - alpha_),
-                    1.0 / (1.0 - alpha_)));
+    double y = pow(pow_range_ * x + pow_min_, inv_exponent_);
     return static_cast<T>(round(y) + offset_);
   }
 
@@ -127,6 +131,7 @@ class IntPowerLawDataSimulator : public IDataSimulator<T> {
   std::uniform_real_distribution<float> dis_;
   float alpha_;  // requiring alpha_ > 0 and alpha_ != 1.0
   double min_, max_, offset_;
+  double pow_min_, pow_range_, inv_exponent_;
 };
 
 /**
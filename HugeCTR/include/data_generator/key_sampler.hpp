@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <data_generator/philox.hpp>
+#include <memory>
+#include <vector>
+
+namespace HugeCTR {
+
+/**
+ * Draws keys from [0, vocabulary_size). Samplers are immutable after construction. Hence, a single
+ * instance can be shared by all generator threads. Randomness is supplied by the caller's stream.
+ */
+class KeySampler {
+ public:
+  virtual ~KeySampler() = default;
+
+  virtual uint64_t vocabulary_size() const = 0;
+
+  virtual uint64_t sample(PhiloxStream& rng) const = 0;
+
+  virtual void sample(PhiloxStream& rng, uint64_t* keys, size_t num_keys) const;
+};
+
+class UniformKeySampler final : public KeySampler {
+ public:
+  UniformKeySampler(uint64_t vocabulary_size);
+
+  uint64_t vocabulary_size() const override { return vocabulary_size_; }
+
+  uint64_t sample(PhiloxStream& rng) const override { return rng.next_below(vocabulary_size_); }
+
+ private:
+  const uint64_t vocabulary_size_;
+};
+
+/**
+ * Vose's alias method. O(1) per sample with exactly one random word and one table probe. Used for
+ * vocabularies small enough that the table (8 bytes per key) stays cache/memory friendly.
+ */
+class AliasTableKeySampler final : public KeySampler {
+ public:
+  AliasTableKeySampler(const std::vector<double>& weights);
+
+  uint64_t vocabulary_size() const override { return entries_.size(); }
+
+  uint64_t sample(PhiloxStream& rng) const override {
+    const uint64_t r{rng.next_u64()};
+    const Entry& entry{entries_[((r >> 32) * entries_.size()) >> 32]};
+    return static_cast<uint32_t>(r) < entry.threshold ? (&entry - entries_.data()) : entry.alias;
+  }
+
+  void sample(PhiloxStream& rng, uint64_t* keys, size_t num_keys) const override;
+
+ private:
+  struct Entry {
+    uint32_t threshold;  // Acceptance probability of this bucket, scaled to 2^32.
+    uint32_t alias;      // Key returned if the bucket's own key is rejected.
+  };
+  std::vector<Entry> entries_;
+};
+
+/**
+ * Zipf sampler based on rejection-inversion (W. Hormann, G. Derflinger, "Rejection-inversion to
+ * generate variates from monotone discrete distributions", 1996). O(1) expected time and no
+ * tables, so it is used for vocabularies too large for an alias table.
+ */
+class ZipfRejectionInversionKeySampler final : public KeySampler {
+ public:
+  ZipfRejectionInversionKeySampler(uint64_t vocabulary_size, double alpha);
+
+  uint64_t vocabulary_size() const override { return vocabulary_size_; }
+
+  uint64_t sample(PhiloxStream& rng) const override;
+
+ private:
+  const uint64_t vocabulary_size_;
+  const double alpha_;
+  const double h_integral_x1_;
+  const double h_integral_n_;
+  const double s_;
+
+  double h_(double x) const;
+  double h_integral_(double x) const;
+  double h_integral_inverse_(double x) const;
+};
+
+/**
+ * Creates the cheapest sampler for a Zipf/power-law distribution with exponent `alpha` over
+ * `vocabulary_size` keys. Rank 0 (i.e., key 0) is the most frequent key.
+ */
+std::shared_ptr<KeySampler> make_zipf_key_sampler(uint64_t vocabulary_size, double alpha,
+                                                  uint64_t alias_table_limit = 1 << 22);
+
+}  // namespace HugeCTR
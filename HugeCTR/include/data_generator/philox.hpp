@@ -0,0 +1,144 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace HugeCTR {
+
+/**
+ * Philox4x32-10 counter-based random number generator (Salmon et al., "Parallel random numbers:
+ * as easy as 1, 2, 3", SC'11). The output is a pure function of (key, counter). Hence, any number
+ * of threads can draw from disjoint counter ranges without sharing state, and the generated
+ * sequence does not depend on how work is distributed.
+ */
+class Philox4x32 {
+ public:
+  using Counter = std::array<uint32_t, 4>;
+  using Key = std::array<uint32_t, 2>;
+
+  static inline Counter generate(Counter ctr, Key key) {
+    for (int round{0}; round < 10; ++round) {
+      if (round) {
+        key[0] += W0;
+        key[1] += W1;
+      }
+      const uint64_t p0{static_cast<uint64_t>(M0) * ctr[0]};
+      const uint64_t p1{static_cast<uint64_t>(M1) * ctr[2]};
+      ctr = {static_cast<uint32_t>(p1 >> 32) ^ ctr[1] ^ key[0], static_cast<uint32_t>(p1),
+             static_cast<uint32_t>(p0 >> 32) ^ ctr[3] ^ key[1], static_cast<uint32_t>(p0)};
+    }
+    return ctr;
+  }
+
+ private:
+  static constexpr uint32_t M0{0xD2511F53};
+  static constexpr uint32_t M1{0xCD9E8D57};
+  static constexpr uint32_t W0{0x9E3779B9};
+  static constexpr uint32_t W1{0xBB67AE85};
+};
+
+/**
+ * Sequential view onto one Philox substream. `stream` selects the substream (e.g., a block index),
+ * so that all values within a block are reproducible regardless of which thread produces it.
+ */
+class PhiloxStream {
+ public:
+  PhiloxStream(const uint64_t seed, const uint64_t stream)
+      : key_{static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32)},
+        ctr_{0, 0, static_cast<uint32_t>(stream), static_cast<uint32_t>(stream >> 32)} {}
+
+  inline uint32_t next_u32() {
+    if (pos_ == buffer_.size()) {
+      refill_();
+    }
+    return buffer_[pos_++];
+  }
+
+  inline uint64_t next_u64() {
+    const uint64_t lo{next_u32()};
+    return lo | (static_cast<uint64_t>(next_u32()) << 32);
+  }
+
+  /**
+   * Uniform double in [0, 1) with 53 bits of randomness.
+   */
+  inline double next_double() {
+    return static_cast<double>(next_u64() >> 11) * (1.0 / static_cast<double>(UINT64_C(1) << 53));
+  }
+
+  /**
+   * Uniform float in [0, 1) with 24 bits of randomness.
+   */
+  inline float next_float() {
+    return static_cast<float>(next_u32() >> 8) * (1.0f / static_cast<float>(1U << 24));
+  }
+
+  /**
+   * Integer in [0, n) using Lemire's multiply-shift reduction. The bias is negligible as long as
+   * n is small compared to the 32/64 bit range drawn.
+   */
+  inline uint64_t next_below(const uint64_t n) {
+    if (n <= UINT64_C(0xFFFFFFFF)) {
+      return (static_cast<uint64_t>(next_u32()) * n) >> 32;
+    }
+    return static_cast<uint64_t>((static_cast<unsigned __int128>(next_u64()) * n) >> 64);
+  }
+
+  /**
+   * Bulk generation. Produces four words per Philox invocation without going through the
+   * per-call buffer check, which lets the compiler keep the rounds in registers.
+   */
+  inline void fill_u32(uint32_t* out, const size_t n) {
+    size_t i{0};
+    for (; pos_ != buffer_.size() && i < n; ++i) {
+      out[i] = buffer_[pos_++];
+    }
+    for (; i + 4 <= n; i += 4) {
+      const Philox4x32::Counter r{Philox4x32::generate(ctr_, key_)};
+      advance_();
+      out[i] = r[0];
+      out[i + 1] = r[1];
+      out[i + 2] = r[2];
+      out[i + 3] = r[3];
+    }
+    for (; i < n; ++i) {
+      out[i] = next_u32();
+    }
+  }
+
+ private:
+  const Philox4x32::Key key_;
+  Philox4x32::Counter ctr_;
+  Philox4x32::Counter buffer_{};
+  size_t pos_{buffer_.size()};
+
+  inline void advance_() {
+    if (++ctr_[0] == 0) {
+      ++ctr_[1];
+    }
+  }
+
+  inline void refill_() {
+    buffer_ = Philox4x32::generate(ctr_, key_);
+    advance_();
+    pos_ = 0;
+  }
+};
+
+}  // namespace HugeCTR
@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <data_generator/key_sampler.hpp>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace HugeCTR {
+
+struct RawAsyncGeneratorParams {
+  size_t num_samples{0};
+  size_t label_dim{1};
+  size_t dense_dim{13};
+  std::vector<size_t> slot_size_array;  // Vocabulary size per slot.
+  std::vector<int> nnz_array;           // Hotness per slot (all 1 if empty).
+  bool i64_input_key{false};            // Write keys as int64 instead of uint32.
+  bool float_label_dense{true};  // Write label and dense values as float instead of int32.
+  bool long_tail{true};          // Zipf keys (true) or uniform keys (false).
+  float alpha{1.2f};             // Zipf exponent.
+  size_t alias_table_limit{1 << 22};  // Largest vocabulary for which an alias table is built.
+  size_t num_threads{1};
+  size_t block_size_bytes{16L * 1024 * 1024};  // Target size of each write.
+  size_t io_alignment{4096};  // Every write except the last one is a multiple of this.
+  uint64_t seed{0};
+};
+
+struct RawAsyncGeneratorStats {
+  size_t num_samples{0};
+  size_t num_bytes{0};
+  size_t num_blocks{0};
+  double elapsed_s{0};
+
+  inline double gbps() const { return elapsed_s > 0 ? num_bytes / elapsed_s / 1e9 : 0; }
+};
+
+/**
+ * Generates synthetic datasets in the fixed-size sample layout consumed by the multi-hot
+ * `AsyncDataReader` (DataReaderType_t::RawAsync):
+ *
+ *   [label_dim x int32/float][dense_dim x int32/float][sum(nnz) x uint32/int64 keys]
+ *
+ * The file is cut into blocks of whole samples whose byte size is a multiple of `io_alignment`.
+ * Worker threads claim blocks, fill them using a Philox substream keyed by the block index, and
+ * write them with a single positioned write. The output is therefore bit-identical for any thread
+ * count, and throughput scales with the number of cores until the device saturates.
+ */
+class RawAsyncGenerator {
+ public:
+  RawAsyncGenerator(const RawAsyncGeneratorParams& params);
+
+  RawAsyncGenerator(const RawAsyncGenerator&) = delete;
+  RawAsyncGenerator& operator=(const RawAsyncGenerator&) = delete;
+
+  inline size_t sample_size_bytes() const { return sample_size_bytes_; }
+
+  inline size_t samples_per_block() const { return samples_per_block_; }
+
+  RawAsyncGeneratorStats generate(const std::string& file_name) const;
+
+  /**
+   * Fills `buffer` with the first `num_samples` samples of block `block_index`. Exposed for
+   * testing and for callers that want to stream data elsewhere.
+   */
+  void fill_block(size_t block_index, size_t num_samples, char* buffer) const;
+
+ private:
+  const RawAsyncGeneratorParams params_;
+  std::vector<std::shared_ptr<KeySampler>> samplers_;  // One per slot. Shared if identical.
+  size_t total_nnz_{0};
+  size_t key_size_bytes_{0};
+  size_t sample_size_bytes_{0};
+  size_t samples_per_block_{0};
+
+  template <typename KeyType, typename DenseType>
+  void fill_block_(size_t block_index, size_t num_samples, char* buffer) const;
+};
+
+}  // namespace HugeCTR
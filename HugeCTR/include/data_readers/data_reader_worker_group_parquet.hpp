@@ -23,11 +23,14 @@ namespace HugeCTR {
 
 template <typename TypeKey>
 class DataReaderWorkerGroupParquet : public DataReaderWorkerGroup {
+  size_t cpu_decoder_threads_; /**< decode row groups with a ParquetCPUDecoder if not 0 */
+
   std::shared_ptr<Source> create_source(size_t worker_id, size_t num_worker,
                                         const std::string& file_name, bool repeat,
                                         const DataSourceParams& data_source_params) override {
-    return std::make_shared<ParquetFileSource>(
-        worker_id, num_worker, file_name, strict_order_of_batches_, repeat, data_source_params);
+    return std::make_shared<ParquetFileSource>(worker_id, num_worker, file_name,
+                                               strict_order_of_batches_, repeat,
+                                               data_source_params, cpu_decoder_threads_ > 0);
   }
 
  public:
@@ -38,10 +41,12 @@ class DataReaderWorkerGroupParquet : public DataReaderWorkerGroup {
                                const DataSourceParams data_source_params,
                                const std::shared_ptr<ResourceManager>& resource_manager_,
                                bool start_reading_from_beginning = true, int label_dense_num = 0,
-                               int label_dense_dim = 0, long long max_samples_per_group = 0)
+                               int label_dense_dim = 0, long long max_samples_per_group = 0,
+                               size_t cpu_decoder_threads = 0)
       : DataReaderWorkerGroup(start_reading_from_beginning, DataReaderType_t::Parquet,
                               strict_order_of_batches, std::make_shared<std::vector<size_t>>(),
-                              output_buffers.size()) {
+                              output_buffers.size()),
+        cpu_decoder_threads_(cpu_decoder_threads) {
     if (file_list.empty()) {
       HCTR_OWN_THROW(Error_t::WrongInput, "file_name.empty()");
     }
@@ -92,6 +97,11 @@ class DataReaderWorkerGroupParquet : public DataReaderWorkerGroup {
     // scalar, it will be initialized until the first iteration begins by the data reader worker
     workers_has_read_.resize(num_workers * num_workers, 0);
     for (size_t i = 0; i < num_workers; i++) {
+      // the CPU decoder uploads straight to the output buffers
+      if (cpu_decoder_threads_ > 0) {
+        df_container_consumer.push_back(nullptr);
+        continue;
+      }
       df_container_producer_.emplace_back(std::make_shared<DFContainer<TypeKey>>(
           local_device_list[i], max_samples_per_group, std::vector<size_t>(label_dense_num, 0),
           max_sparse_size, dense_bytes_per_sample * max_samples_per_group));
@@ -119,7 +129,7 @@ class DataReaderWorkerGroupParquet : public DataReaderWorkerGroup {
           local_device_list[i], df_container_consumer[i], df_container_producer,
           df_container_producer_stats_, workers_has_read_, accomplished_workers_, resource_manager_,
           dense_width_dim_, this->go_next_epoch_.data() + i, this->epoch_mtx_[i],
-          this->epoch_cv_[i]));
+          this->epoch_cv_[i], cpu_decoder_threads_));
       data_readers_.push_back(data_reader);
     }
     this->create_data_reader_threads();
@@ -57,6 +57,7 @@ class ParquetFileSource : public Source {
 
   const bool repeat_;
   const bool sequential_file_consumption_;
+  const bool cpu_decoding_; /**< Files are read by a ParquetCPUDecoder, not loaded for cudf */
   /**
    * Private Helper function to get metadata file address
    */
@@ -85,10 +86,12 @@ class ParquetFileSource : public Source {
  public:
   /**
    * Ctor
+   * @param cpu_decoding Only locate the files in `next_source()`. The caller decodes them with a
+   * `ParquetCPUDecoder`, which reads them itself, so they are neither loaded nor handed to cudf.
    */
   ParquetFileSource(unsigned int worker_id, unsigned int stride, const std::string& file_list,
                     bool sequtial_file_consumption, bool repeat,
-                    const DataSourceParams& data_source_params);
+                    const DataSourceParams& data_source_params, bool cpu_decoding = false);
 
   ~ParquetFileSource();
   /**
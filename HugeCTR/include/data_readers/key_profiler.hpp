@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <atomic>
+#include <common.hpp>
+#include <core/macro.hpp>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace HugeCTR {
+
+struct KeyProfilerParams {
+  DataReaderType_t format{DataReaderType_t::RawAsync};  // RawAsync or Norm.
+
+  // Sample layout of RawAsync files. Norm files describe themselves in their header.
+  size_t label_dim{1};
+  size_t dense_dim{13};
+  std::vector<int> nnz_array;  // Keys per slot.
+  bool i64_input_key{false};   // Keys are int64 instead of uint32.
+
+  size_t num_threads{1};
+  size_t block_size_bytes{8L * 1024 * 1024};  // Amount of data that a thread claims at a time.
+
+  // Keys are counted exactly until the hash tables of all slots together would exceed this size.
+  // Afterwards, each slot switches to a count-min sketch that tracks the heaviest keys.
+  size_t max_exact_bytes{4L * 1024 * 1024 * 1024};
+  size_t sketch_width{1 << 20};       // Counters per row of the count-min sketches.
+  size_t num_heavy_hitters{1 << 16};  // Keys per slot that are tracked in sketch mode.
+};
+
+/**
+ * Key-frequency statistics of one slot.
+ */
+struct KeyProfile {
+  uint64_t num_accesses{0};
+  uint64_t cardinality{0};  // Number of distinct keys. Estimated if not exact.
+  bool exact{true};
+
+  /**
+   * Keys with their number of accesses, in descending order. All keys if exact, otherwise only the
+   * heaviest ones, whose counts may be overestimated.
+   */
+  std::vector<std::pair<int64_t, uint64_t>> keys;
+
+  /**
+   * @return Number of accesses to the \p num_keys most frequent keys. Keys that were not tracked
+   * are assumed to be accessed equally often.
+   */
+  double accesses_of_top(double num_keys) const;
+
+  /**
+   * @return Smallest number of most frequent keys that receive \p fraction of all accesses.
+   */
+  uint64_t keys_for_coverage(double fraction) const;
+
+  /**
+   * @return Cumulative coverage curve. In each point, the most frequent `first` fraction of the
+   * keys receives the `second` fraction of all accesses. Points are spaced logarithmically in the
+   * number of keys, and the last point is (1, 1).
+   */
+  std::vector<std::pair<double, double>> coverage(size_t num_points) const;
+};
+
+/**
+ * @brief Counts how often each key occurs in RawAsync or Norm datasets, per slot.
+ *
+ * Files are mapped into memory and processed in blocks by \p num_threads threads. RawAsync blocks
+ * are found by arithmetic. For Norm files, the threads take turns to find the end of the next
+ * block, and then decode it in parallel.
+ *
+ * Each thread first groups the keys of a block by slot and hash table shard, and then inserts
+ * them with one lock per shard. Once the tables reach \p max_exact_bytes , all slots switch to
+ * count-min sketches with lock-free counters and a HyperLogLog cardinality estimate. Keys whose
+ * estimate exceeds that of the least frequent tracked key are kept as heavy hitters.
+ */
+class KeyProfiler final {
+ public:
+  KeyProfiler(const KeyProfilerParams& params);
+
+  ~KeyProfiler();
+
+  HCTR_DISALLOW_COPY_AND_MOVE(KeyProfiler);
+
+  /**
+   * Counts the keys of \p file_name . Can be called for several files.
+   */
+  void profile(const std::string& file_name);
+
+  inline uint64_t num_samples() const { return num_samples_; }
+
+  inline size_t num_slots() const { return slots_.size(); }
+
+  /**
+   * @return True as long as all counts are exact.
+   */
+  inline bool exact() const { return !sketch_mode_; }
+
+  std::vector<KeyProfile> result() const;
+
+ private:
+  class Slot;
+
+  const KeyProfilerParams params_;
+  std::vector<std::unique_ptr<Slot>> slots_;
+  uint64_t num_samples_{0};
+
+  // Shared by threads that insert keys, exclusive while switching to sketch mode.
+  mutable std::shared_mutex mode_guard_;
+  std::atomic<bool> sketch_mode_{false};
+  std::atomic<size_t> num_exact_entries_{0};
+
+  void init_slots_(size_t num_slots);
+
+  /**
+   * Runs \p num_threads threads that call \p next_block until it returns false. \p next_block
+   * appends the keys of the next block to the vector of each slot.
+   */
+  void run_(const std::function<bool(std::vector<std::vector<uint64_t>>&)>& next_block);
+
+  void insert_(const std::vector<std::vector<uint64_t>>& keys,
+               std::vector<std::vector<uint64_t>>& scratch);
+
+  void switch_to_sketch_();
+
+  void profile_raw_async_(const char* data, size_t size, const std::string& file_name);
+
+  void profile_norm_(const char* data, size_t size, const std::string& file_name);
+};
+
+}  // namespace HugeCTR
@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <common.hpp>
+#include <core/macro.hpp>
+#include <cstring>
+#include <string>
+
+namespace HugeCTR {
+
+/**
+ * Read-only memory mapping of a whole file.
+ */
+class MappedFile final {
+ public:
+  explicit MappedFile(const std::string& file_name) {
+    fd_ = open(file_name.c_str(), O_RDONLY);
+    HCTR_THROW_IF(fd_ < 0, Error_t::FileCannotOpen, "Unable to open \"", file_name,
+                  "\": ", std::strerror(errno));
+    struct stat st;
+    HCTR_THROW_IF(fstat(fd_, &st) != 0, Error_t::FileCannotOpen, "Unable to stat \"", file_name,
+                  "\": ", std::strerror(errno));
+    size_ = static_cast<size_t>(st.st_size);
+    if (size_ > 0) {
+      void* const map{mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd_, 0)};
+      HCTR_THROW_IF(map == MAP_FAILED, Error_t::FileCannotOpen, "Unable to map \"", file_name,
+                    "\": ", std::strerror(errno));
+      madvise(map, size_, MADV_SEQUENTIAL);
+      data_ = static_cast<const char*>(map);
+    }
+  }
+
+  ~MappedFile() {
+    if (data_) {
+      munmap(const_cast<char*>(data_), size_);
+    }
+    if (fd_ >= 0) {
+      close(fd_);
+    }
+  }
+
+  HCTR_DISALLOW_COPY_AND_MOVE(MappedFile);
+
+  inline const char* data() const { return data_; }
+
+  inline size_t size() const { return size_; }
+
+ private:
+  int fd_{-1};
+  const char* data_{nullptr};
+  size_t size_{0};
+};
+
+}  // namespace HugeCTR
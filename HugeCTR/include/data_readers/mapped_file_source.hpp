@@ -0,0 +1,150 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <common.hpp>
+#include <data_readers/file_list.hpp>
+#include <data_readers/mapped_file.hpp>
+#include <data_readers/source.hpp>
+#include <memory>
+#include <vector>
+
+namespace HugeCTR {
+
+/**
+ * @brief Zero-copy alternative to \p FileSource.
+ *
+ * Files are either mapped into memory as a whole, or read with large \p pread calls into an
+ * internal buffer. Instead of copying every field out of a stream, callers can \p peek at the next
+ * bytes of the file and \p consume them once they are done. \p read is still provided, so that the
+ * source can be used with the existing checkers.
+ */
+class MappedFileSource : public Source {
+ public:
+  static constexpr size_t default_read_size{16 * 1024 * 1024};
+
+  /**
+   * @param use_mmap Map files into memory. Otherwise, read them in chunks of \p read_size bytes.
+   */
+  MappedFileSource(long long offset, long long stride, const std::string& file_list, bool repeat,
+                   bool use_mmap = true, size_t read_size = default_read_size);
+
+  ~MappedFileSource() override;
+
+  HCTR_DISALLOW_COPY_AND_MOVE(MappedFileSource);
+
+  /**
+   * Copy "bytes_to_read" bytes to the memory associated to ptr.
+   * @return `FileCannotOpen` `OutOfBound` `Success` `UnspecificError`
+   */
+  Error_t read(char* ptr, size_t bytes_to_read) noexcept override;
+
+  /**
+   * @return Pointer to the next unread byte. The memory must not be modified.
+   */
+  char* get_ptr() override { return const_cast<char*>(cur_); }
+
+  /**
+   * Makes the next \p num_bytes bytes of the file available without consuming them.
+   * @return Pointer to the bytes, or \p nullptr if fewer than \p num_bytes bytes are left. When
+   * reading with \p pread, the pointer is valid until the next call to \p peek or \p read.
+   */
+  const char* peek(size_t num_bytes) noexcept;
+
+  /**
+   * Skips \p num_bytes bytes, which must have been made available by \p peek.
+   */
+  void consume(size_t num_bytes) noexcept;
+
+  /**
+   * Start a new file to read.
+   * @return `Success`, `EndOfFile`, `FileCannotOpen` or `UnspecificError`
+   */
+  Error_t next_source(long long expected_next_source_items) noexcept override;
+
+  bool is_open() noexcept override { return fd_ >= 0 || mapped_; }
+
+  std::string get_current_file_name() const { return file_name_; }
+
+ private:
+  FileList file_list_;
+  std::string file_name_;
+  const long long offset_;
+  const long long stride_;
+  const bool repeat_;
+  const bool use_mmap_;
+  const size_t read_size_;
+  unsigned int counter_{0};
+
+  std::unique_ptr<MappedFile> mapped_;
+  int fd_{-1};  // Only used with pread.
+  size_t file_size_{0};
+  size_t file_offset_{0};  // Next offset to read with pread.
+  std::vector<char> buffer_;
+
+  // The bytes [cur_, end_) have been mapped or read, but not consumed yet.
+  const char* cur_{nullptr};
+  const char* end_{nullptr};
+
+  void close_() noexcept;
+
+  bool fill_(size_t num_bytes);
+};
+
+/**
+ * @return The sum of \p size bytes modulo 256, as computed by \p CheckSum.
+ */
+char compute_check_sum(const char* data, size_t size);
+
+/**
+ * @brief Reads samples in the \p CheckSum format (an int length, the payload and a one-byte
+ * checksum) from a \p MappedFileSource, a block at a time.
+ *
+ * The samples of a block are not copied. Their checksums are verified together, once the block
+ * boundaries are known.
+ */
+class BlockCheckSum {
+ public:
+  struct Sample {
+    const char* data;
+    size_t size;
+  };
+
+  explicit BlockCheckSum(MappedFileSource& src) : src_(src) {}
+
+  /**
+   * Reads up to \p max_samples samples of the current file. The pointers in \p samples stay valid
+   * until the next call.
+   * @return `Success`, `EndOfFile` if the file has no samples left, `DataCheckError` if a checksum
+   * does not match, or `BrokenFile` if the file ends in the middle of a sample.
+   */
+  Error_t read_block(size_t max_samples, std::vector<Sample>& samples);
+
+  /**
+   * Start a new file to read.
+   * @return `Success` or `EndOfFile`
+   */
+  Error_t next_source(long long expected_next_source_items);
+
+  bool is_open() noexcept { return src_.is_open(); }
+
+ private:
+  const int MAX_TRY_{10};
+  MappedFileSource& src_;
+  std::vector<size_t> offsets_;
+};
+
+}  // namespace HugeCTR
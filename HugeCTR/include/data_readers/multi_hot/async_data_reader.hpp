@@ -34,7 +34,9 @@ class AsyncDataReader : public SchedulableDataReader {
                   size_t num_threads_per_file, size_t num_batches_per_thread,
                   const std::vector<DataReaderSparseParam>& params, size_t label_dim,
                   size_t dense_dim, bool mixed_precision, bool shuffle,
-                  bool schedule_uploads = false, bool is_dense_float = false);
+                  bool schedule_uploads = false, bool is_dense_float = false,
+                  const IOAutotunerParams& autotuner_params = {},
+                  const HostCacheParams& cache_params = {});
 
   long long read_a_batch_to_device_delay_release() override;
   long long get_full_batchsize() const override;
@@ -96,7 +98,7 @@ class AsyncDataReader : public SchedulableDataReader {
                            const std::vector<long long> slot_offset,
                            bool start_reading_from_beginning = true,
                            long long max_samples_per_group = 0, int label_dense_num = 0,
-                           int label_dense_dim = 0) override;
+                           int label_dense_dim = 0, size_t cpu_decoder_threads = 0) override;
 #endif
   void set_source(std::string file_list = std::string()) override;
 
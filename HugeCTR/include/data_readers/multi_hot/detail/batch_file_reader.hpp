@@ -16,11 +16,19 @@
 #pragma once
 
 #include <data_readers/multi_hot/detail/batch_locations.hpp>
+#include <data_readers/multi_hot/detail/host_batch_cache.hpp>
 #include <data_readers/multi_hot/detail/io_context.hpp>
 #include <data_readers/multi_hot/detail/time_helper.hpp>
 #include <data_readers/multi_hot/detail/work_queue.hpp>
+#include <data_readers/raw_async_packed.hpp>
+#include <exception>
+#include <functional>
 #include <memory>
+#include <mutex>
 #include <queue>
+#include <string>
+#include <thread_pool.hpp>
+#include <vector>
 
 // High level
 // - specify num batches in-flight
@@ -43,6 +51,8 @@
 namespace HugeCTR {
 class BatchFileReader {
  public:
+  using IOContextFactory = std::function<std::unique_ptr<IOContext>(size_t io_depth)>;
+
   class Batch {
     friend class BatchFileReader;
 
@@ -70,11 +80,35 @@ class BatchFileReader {
 
    private:
     uint8_t* aligned_data = nullptr;
+    size_t offset = 0;
+    size_t pending_ios = 0;  // Sub-requests of a striped read that have not completed yet
+    uint8_t* packed_data = nullptr;  // Encoded blocks of a packed file, decoded into aligned_data
+    size_t packed_misalignment = 0;
+    size_t first_block = 0;
+    size_t end_block = 0;
     BatchFileReader* reader;
   };
 
   BatchFileReader(const std::string& fname, size_t slot, size_t max_batches_inflight,
                   std::unique_ptr<IBatchLocations> batch_locations);
+
+  // The logical file is striped RAID-0 style over `stripes`, which are typically on different
+  // devices: stripe unit i (of stripe_size_bytes) is stored in stripes[i % stripes.size()]. Each
+  // stripe gets its own IO context, and every batch is read with one sub-request per stripe unit
+  // it touches, directly into its place in the batch buffer.
+  // Reads go through AIOContexts unless `io_context_factory` is given, e.g. to simulate devices.
+  BatchFileReader(const std::vector<std::string>& stripes, size_t stripe_size_bytes, size_t slot,
+                  size_t max_batches_inflight, std::unique_ptr<IBatchLocations> batch_locations,
+                  const IOContextFactory& io_context_factory = nullptr);
+
+  // Reads a file written by pack_raw_async(). Batch locations address the uncompressed samples.
+  // Each batch is read as the encoded blocks it overlaps, which are decoded on `decoder` after the
+  // read completes, so that IO and decompression of different batches overlap. Batches are only
+  // returned once decoded.
+  BatchFileReader(const std::string& fname, std::shared_ptr<const RawAsyncPackedIndex> packed_index,
+                  ThreadPool& decoder, size_t slot, size_t max_batches_inflight,
+                  std::unique_ptr<IBatchLocations> batch_locations,
+                  const IOContextFactory& io_context_factory = nullptr);
   BatchFileReader(const BatchFileReader& other) = delete;
   ~BatchFileReader();
 
@@ -83,28 +117,68 @@ class BatchFileReader {
   void release_batch(const Batch* batch);
   size_t get_queue_depth() const;
 
+  // Limits the batches in-flight to [1, max_batches_inflight]. Batch buffers are allocated on
+  // first use, so a smaller limit also saves host memory. Can be called while reading.
+  void set_max_batches_inflight(size_t n);
+  size_t get_max_batches_inflight() const;
+  size_t get_num_inflight() const { return num_inflight_; }
+  size_t get_buffer_size() const { return buf_size_; }
+
+  // Serves batches from `cache` if it holds them, and caches the batches read from disk. `source`
+  // identifies the file in the cache. Has to be called before reading.
+  void set_cache(std::shared_ptr<HostBatchCache> cache, size_t source);
+
  private:
   void submit_reads();
+  Batch* allocate_batch();
   const std::vector<const Batch*>& collect(size_t timeout_us);
+  void collect_device(size_t device, size_t min_reqs, size_t timeout_us);
+  void decode_batch(Batch* batch);
+
+  struct Device {
+    int fd = -1;
+    std::unique_ptr<IOContext> io_ctx;
+    size_t num_inflight_ios = 0;
+  };
 
   // Files stored feature-major (i.e multi-hot) will have a distinct slot_id for each file
   // Files that are batch-major will have the same slot_id value of 0.
   size_t slot_id_ = 0;
   size_t max_batches_inflight_ = 0;
+  std::atomic<size_t> window_ = {0};  // Current limit of batches in-flight
 
   std::vector<const Batch*> tmp_completed_batches_;
   // To handle the case where a batch doesn't span all numas but we still need to return a read
   // request.
   std::vector<const Batch*> empty_batches_;
-  std::vector<Batch> batches_;      // So we can free memory if not all batches are released
+  // Loaded from the cache, returned by the next collect
+  std::vector<const Batch*> cached_batches_;
+  // So we can free memory if not all batches are released. Capacity is reserved upfront, so
+  // pointers stay valid while batches are allocated on demand.
+  std::vector<Batch> batches_;
   WorkQueue<Batch*> free_batches_;  // TODO: Can be optimized to SPSC queue instead of MPMC
 
   std::unique_ptr<IBatchLocations> batch_locations_;
   IBatchLocations::iterator batch_locations_iterator_;
-  std::unique_ptr<IOContext> io_ctx_;
+  std::vector<Device> devices_;  // One per stripe
+  size_t stripe_size_bytes_ = 0;
+  size_t alignment_ = 0;
+  size_t next_device_ = 0;  // Device to block on when nothing completed, round-robin
 
-  int fd_;
   size_t buf_size_ = 0;  // used for numa_free
   std::atomic<size_t> num_inflight_ = {0};
+
+  std::shared_ptr<HostBatchCache> cache_;
+  size_t cache_source_ = 0;
+
+  // Packed files only
+  std::shared_ptr<const RawAsyncPackedIndex> packed_index_;
+  std::unique_ptr<RawAsyncPackedCodec> codec_;
+  ThreadPool* decoder_ = nullptr;
+  size_t packed_buf_size_ = 0;
+  WorkQueue<Batch*> decoded_batches_;
+  std::atomic<size_t> num_decoding_ = {0};
+  std::mutex decode_error_mutex_;
+  std::exception_ptr decode_error_;
 };
 }  // namespace HugeCTR
\ No newline at end of file
@@ -45,6 +45,8 @@ class IBatchLocations {
  public:
   using iterator = BatchForwardIterator;
 
+  virtual ~IBatchLocations() = default;
+
   virtual iterator begin() = 0;
   virtual iterator end() = 0;
   virtual size_t count() = 0;
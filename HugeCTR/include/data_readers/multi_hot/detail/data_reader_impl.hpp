@@ -19,6 +19,8 @@
 #include <data_readers/multi_hot/detail/atomic_wrapper.hpp>
 #include <data_readers/multi_hot/detail/batch_file_reader.hpp>
 #include <data_readers/multi_hot/detail/device_transfer.hpp>
+#include <data_readers/multi_hot/detail/host_batch_cache.hpp>
+#include <data_readers/multi_hot/detail/io_autotuner.hpp>
 #include <data_readers/multi_hot/detail/system_latch.hpp>
 #include <future>
 #include <memory>
@@ -34,9 +36,14 @@ namespace MultiHot {
 //#define BENCH_IO
 
 struct FileSource {
-  std::string name;
+  std::string name;  // Raw or packed (see pack_raw_async()) file, detected by its footer
   size_t sample_size_bytes;
   size_t slot_id;
+  // If not empty, the file is striped over these files, typically on different devices: stripe unit
+  // i of stripe_size_bytes is stored in stripes[i % stripes.size()]. This is the layout written by
+  // RawAsyncRepacker, and `name` is only used for messages.
+  std::vector<std::string> stripes = {};
+  size_t stripe_size_bytes = 0;
 };
 
 enum BatchState {
@@ -124,11 +131,17 @@ class DataReaderImpl {
    *                                input_5.bin | 0 0 0 0       input_5.bin | 1 0 0 0
    *                                input_6.bin | 0 0 0 0       input_6.bin | 0 1 0 0
    *                                input_7.bin | 0 0 0 0       input_7.bin | 0 0 0 1
+   * @param autotuner_params If enabled, num_batches_per_thread is the upper limit of the in-flight
+   *                         batches per thread, which are adjusted to the observed read latency and
+   *                         consumer wait time.
+   * @param cache_params If enabled, the batches of the first epoch are kept in host memory and
+   *                     later epochs are served from there, up to the memory budget.
    */
   DataReaderImpl(const std::vector<FileSource>& source_files,
                  const std::shared_ptr<ResourceManager>& resource_manager, size_t batch_size,
                  size_t num_threads_per_file, size_t num_batches_per_thread, bool shuffle,
-                 bool schedule_uploads);
+                 bool schedule_uploads, const IOAutotunerParams& autotuner_params = {},
+                 const HostCacheParams& cache_params = {});
   ~DataReaderImpl();
 
   void start();
@@ -143,6 +156,17 @@ class DataReaderImpl {
 
   size_t get_total_inflight_batches() const;
 
+  struct IOStats {
+    double batch_min_latency = 0;
+    double batch_max_latency = 0;
+    double batch_avg_latency = 0;
+    size_t num_epochs = 0;
+    double epoch_time = 0;       // Of the last epoch
+    double cache_hit_ratio = 0;  // Of the last epoch, slabs served from the host cache
+  };
+
+  const IOStats& get_io_stats() const { return io_stats; }
+
  private:
   Batch& get_parent(size_t batch_i);
 
@@ -150,19 +174,22 @@ class DataReaderImpl {
 
   void upload_batches(size_t device_id);
 
-  std::unique_ptr<IBatchLocations> configure_locations(FileSource source, size_t batch_size,
-                                                       bool shuffle) const;
+  // Locations address the uncompressed samples of packed files
+  std::unique_ptr<IBatchLocations> configure_locations(FileSource source,
+                                                       const RawAsyncPackedIndex* packed_index,
+                                                       size_t batch_size, bool shuffle) const;
 
   static void CUDART_CB release_batch_callback(cudaStream_t stream, cudaError_t status,
                                                void* user_data);
 
-  void compute_batch_stats(Batch* batch);
+  // Returns the read latency of the batch
+  double compute_batch_stats(Batch* batch);
 
-  struct IOStats {
-    double batch_min_latency;
-    double batch_max_latency;
-    double batch_avg_latency;
-  } io_stats;
+  void autotune(double read_latency, double wait_time);
+
+  void update_epoch_stats();
+
+  IOStats io_stats;
 
   std::shared_ptr<ResourceManager> resource_manager_;
   size_t batch_i_ = 0;
@@ -172,6 +199,15 @@ class DataReaderImpl {
   Batch* last_batch_ = nullptr;
   std::vector<std::unique_ptr<Batch>> batch_buffers_;
 
+  std::unique_ptr<IOAutotuner> autotuner_;
+  double last_batch_time_ = 0;
+
+  std::shared_ptr<HostBatchCache> cache_;
+  HostBatchCache::Stats last_cache_stats_;
+  double epoch_start_time_ = 0;
+
+  // Shared by the readers of packed files. Declared first, so that it outlives them.
+  std::unique_ptr<ThreadPool> decoder_;
   std::unordered_map<int, std::vector<std::unique_ptr<BatchFileReader>>> file_readers_;
   std::vector<std::thread> file_reader_threads_;
 
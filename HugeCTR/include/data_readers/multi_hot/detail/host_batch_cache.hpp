@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <data_readers/raw_async_packed.hpp>
+#include <memory>
+#include <shared_mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace HugeCTR {
+
+struct HostCacheParams {
+  bool enabled = false;
+  // Host memory for cached slabs of all readers. Slabs beyond it are read from disk every epoch.
+  // 0: no limit
+  size_t max_bytes = 0;
+  // Compress slabs with RawAsyncPackedCodec, treating every 4 bytes of a sample as a column
+  bool compress = false;
+};
+
+/**
+ * Keeps the slabs that the readers of the first epoch got from disk in host memory, so that later
+ * epochs are served from RAM. Slabs are identified by their source file and offset, which the
+ * batch locations repeat every epoch, so shuffling and ordering are unchanged. Nothing is evicted:
+ * once the budget is used up, the remaining slabs keep being read from disk.
+ *
+ * Thread safe. Sources have to be added before reading starts.
+ */
+class HostBatchCache {
+ public:
+  struct Stats {
+    size_t hits = 0;
+    size_t misses = 0;
+    size_t num_slabs = 0;
+    size_t num_bytes = 0;      // Host memory of the cached slabs
+    size_t num_raw_bytes = 0;  // Uncompressed size of the cached slabs
+
+    inline double hit_ratio() const {
+      return hits + misses > 0 ? static_cast<double>(hits) / (hits + misses) : 0;
+    }
+  };
+
+  explicit HostBatchCache(const HostCacheParams& params);
+
+  /**
+   * @return Id of a new source with samples of \p sample_size_bytes .
+   */
+  size_t add_source(size_t sample_size_bytes);
+
+  /**
+   * Copies the slab of \p size bytes at \p offset of \p source to \p data if it is cached.
+   * @return Whether it was a hit.
+   */
+  bool load(size_t source, size_t offset, size_t size, uint8_t* data);
+
+  /**
+   * Caches a slab that was read from disk, if it fits into the budget.
+   * @return Whether it was cached.
+   */
+  bool store(size_t source, size_t offset, const uint8_t* data, size_t size);
+
+  Stats get_stats() const;
+
+ private:
+  struct Slab {
+    std::unique_ptr<uint8_t[]> data;
+    size_t size = 0;  // Stored size
+    bool compressed = false;
+  };
+
+  struct Source {
+    std::unique_ptr<RawAsyncPackedCodec> codec;  // Null if not compressed
+    size_t sample_size_bytes = 0;
+    std::unordered_map<size_t, Slab> slabs;  // By offset
+  };
+
+  bool reserve(size_t size);
+
+  const HostCacheParams params_;
+  std::vector<Source> sources_;
+  mutable std::shared_mutex mutex_;
+
+  std::atomic<size_t> num_bytes_ = {0};
+  std::atomic<bool> full_ = {false};
+  std::atomic<size_t> hits_ = {0};
+  std::atomic<size_t> misses_ = {0};
+  std::atomic<size_t> num_slabs_ = {0};
+  std::atomic<size_t> num_raw_bytes_ = {0};
+};
+
+}  // namespace HugeCTR
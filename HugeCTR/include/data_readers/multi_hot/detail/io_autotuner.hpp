@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+
+namespace HugeCTR {
+
+struct IOAutotunerParams {
+  bool enabled = false;
+  size_t min_window = 1;  // In-flight batches per reader thread
+  size_t max_window = 0;  // 0: as many as the readers were created with
+  // Host memory for the batch buffers of all readers. The window is capped accordingly, and it must
+  // fit at least min_window. 0: no limit
+  size_t max_inflight_bytes = 0;
+  size_t interval_batches = 32;  // Consumed batches per decision
+  // Consumer is starved if it spends more than this fraction of its time waiting for batches
+  double starvation_threshold = 0.05;
+  // Reads are congested if their latency exceeds this multiple of the lowest observed latency
+  double latency_tolerance = 2.0;
+  double min_gain = 0.05;  // Relative throughput gain that a larger window has to bring
+  double decrease_factor = 0.5;
+  size_t hold_intervals = 8;  // Intervals to wait after a decrease or an increase that didn't help
+};
+
+/**
+ * Adjusts the number of in-flight batches per reader thread like a TCP congestion window.
+ *
+ * The consumer reports every batch it gets. After each interval:
+ * - While the consumer waits for batches, the window grows, doubling at first (slow start) and by
+ *   one after the first setback.
+ * - If the last increase didn't improve throughput, the device is saturated and the window is
+ *   reverted. The next probe waits longer after each revert in a row.
+ * - If the consumer doesn't wait but the read latency is inflated, batches only queue up in the
+ *   device, and the window shrinks by `decrease_factor` to release memory.
+ */
+class IOAutotuner {
+ public:
+  enum class Decision { Hold, SlowStart, Increase, Revert, Decrease };
+
+  IOAutotuner(const IOAutotunerParams& params, size_t initial_window, size_t max_window);
+
+  /**
+   * Records one consumed batch.
+   * @param read_latency_s Time between submitting the read of the batch and its completion
+   * @param wait_s Time the consumer spent waiting for the batch
+   * @param step_s Time since the consumer got the previous batch, including \p wait_s
+   * @return Whether the window changed.
+   */
+  bool record(double read_latency_s, double wait_s, double step_s);
+
+  size_t window() const { return window_; }
+  size_t max_window() const { return max_window_; }
+  Decision last_decision() const { return last_decision_; }
+
+ private:
+  Decision decide(double latency, double wait_fraction, double throughput);
+
+  const IOAutotunerParams params_;
+  const size_t max_window_;
+  size_t window_;
+  size_t ssthresh_;
+  bool slow_start_ = true;
+  Decision last_decision_ = Decision::Hold;
+
+  size_t num_batches_ = 0;
+  double latency_sum_ = 0;
+  double wait_sum_ = 0;
+  double step_sum_ = 0;
+
+  double base_latency_ = 0;
+  double prev_throughput_ = 0;
+  size_t prev_window_ = 0;
+  size_t hold_ = 0;
+  size_t backoff_ = 1;
+};
+
+}  // namespace HugeCTR
@@ -0,0 +1,233 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <common.hpp>
+#include <core/macro.hpp>
+#include <data_readers/metadata.hpp>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread_pool.hpp>
+#include <vector>
+
+namespace parquet::arrow {
+class FileReader;
+}  // namespace parquet::arrow
+
+namespace HugeCTR {
+
+/**
+ * Growable host buffer, which is optionally page-locked so that it can be uploaded with
+ * \p cudaMemcpyAsync without an intermediate staging copy. The contents are not preserved when
+ * the buffer grows, and it never shrinks.
+ */
+template <typename T>
+class ParquetHostBuffer final {
+ public:
+  HCTR_DISALLOW_COPY(ParquetHostBuffer);
+
+  explicit ParquetHostBuffer(bool pinned = false) : pinned_{pinned} {}
+
+  ParquetHostBuffer(ParquetHostBuffer&& other) noexcept
+      : pinned_{other.pinned_}, data_{other.data_}, capacity_{other.capacity_} {
+    other.data_ = nullptr;
+    other.capacity_ = 0;
+  }
+
+  ParquetHostBuffer& operator=(ParquetHostBuffer&& other) noexcept;
+
+  ~ParquetHostBuffer() { release_(); }
+
+  inline bool pinned() const { return pinned_; }
+
+  inline size_t capacity() const { return capacity_; }
+
+  inline T* data() { return data_; }
+
+  inline const T* data() const { return data_; }
+
+  /**
+   * Makes room for at least \p n elements.
+   */
+  void reserve(size_t n);
+
+ private:
+  bool pinned_;
+  T* data_{nullptr};
+  size_t capacity_{0};
+
+  void release_() noexcept;
+};
+
+/**
+ * One decoded row group, in the layout that \p parquet_data_converter.cu produces on the device.
+ *
+ * - \p label_dense holds \p num_rows rows of \p label_dense_dim floats. The label columns come
+ *   first, followed by the dense columns, each ordered by their index in the metadata.
+ * - For each \p DataReaderSparseParam, \p row_offsets and \p values form a CSR matrix with one
+ *   row per (sample, slot) pair. Row \p sample * \p slot_num + \p slot holds the keys of that slot,
+ *   shifted by the slot offset.
+ */
+template <typename T, typename IndexType>
+struct ParquetHostBatch {
+  struct Sparse {
+    ParquetHostBuffer<IndexType> row_offsets;  // `num_rows * slot_num + 1` entries.
+    ParquetHostBuffer<T> values;               // `nnz` entries.
+    size_t nnz{0};
+
+    explicit Sparse(bool pinned) : row_offsets{pinned}, values{pinned} {}
+  };
+
+  std::string file_name;
+  int row_group{-1};
+  size_t num_rows{0};
+
+  size_t label_dense_dim{0};
+  std::vector<size_t> dense_dim_array;  // Width of each label and dense column.
+  ParquetHostBuffer<float> label_dense;
+
+  std::vector<Sparse> sparse;
+
+  ParquetHostBatch(size_t num_params, bool pinned) : label_dense{pinned} {
+    sparse.reserve(num_params);
+    for (size_t i{0}; i < num_params; ++i) {
+      sparse.emplace_back(pinned);
+    }
+  }
+};
+
+/**
+ * Alternative to the cudf-based decoding of \p RowGroupReadingThread and
+ * \p parquet_data_converter.cu . Row groups are read, decompressed and decoded with the Apache
+ * Arrow/Parquet C++ library on a pool of CPU threads, and are assembled straight into the final
+ * host layout (see \p ParquetHostBatch ). The result can be uploaded with one copy per buffer, and
+ * no GPU is involved until then.
+ *
+ * Each row group is decoded by a single thread. Parallelism comes from having several row groups in
+ * flight, which avoids any synchronization within a row group. Opened files are kept for the next
+ * row groups, so that the footer is parsed once per file and thread rather than per row group.
+ *
+ * @tparam T Key type of the sparse inputs.
+ * @tparam IndexType Type of the CSR row offsets.
+ */
+template <typename T, typename IndexType>
+class ParquetCPUDecoder final {
+ public:
+  using Batch = ParquetHostBatch<T, IndexType>;
+
+  HCTR_DISALLOW_COPY_AND_MOVE(ParquetCPUDecoder);
+
+  ParquetCPUDecoder() = delete;
+
+  /**
+   * @param label_dense_cols Names of the label and dense columns, in output order.
+   * @param cat_cols Names of the categorical columns, in output order. Columns are assigned to the
+   * \p params in order, \p slot_num columns each.
+   * @param slot_offset Added to the keys of each slot. Either empty or one entry per slot.
+   * @param num_threads Number of row groups that are decoded concurrently.
+   * @param use_pinned_memory Allocate the batches in page-locked memory. Requires a CUDA device.
+   */
+  ParquetCPUDecoder(const std::vector<std::string>& label_dense_cols,
+                    const std::vector<std::string>& cat_cols,
+                    const std::vector<DataReaderSparseParam>& params,
+                    const std::vector<long long>& slot_offset, size_t num_threads,
+                    bool use_pinned_memory);
+
+  ~ParquetCPUDecoder();
+
+  /**
+   * @return The label and dense columns of \p metadata , in the order the GPU converter uses.
+   */
+  static std::vector<std::string> label_dense_columns(Metadata& metadata);
+
+  /**
+   * @return The categorical columns of \p metadata , in the order the GPU converter uses.
+   */
+  static std::vector<std::string> cat_columns(Metadata& metadata);
+
+  /**
+   * @return Number of row groups of \p file_name , from its footer.
+   */
+  static int num_row_groups(const std::string& file_name);
+
+  inline size_t num_threads() const { return pool_.size(); }
+
+  /**
+   * Schedules \p row_group of \p file_name for decoding.
+   */
+  void submit(const std::string& file_name, int row_group);
+
+  /**
+   * Waits for the oldest submitted row group. Exceptions raised while decoding it are rethrown
+   * here.
+   */
+  std::unique_ptr<Batch> next();
+
+  size_t num_pending() const;
+
+  /**
+   * Returns a batch after its contents have been uploaded, so that its buffers can be reused.
+   */
+  void recycle(std::unique_ptr<Batch> batch);
+
+  /**
+   * Decodes \p row_group of \p file_name into \p batch on the calling thread.
+   */
+  void decode(const std::string& file_name, int row_group, Batch& batch) const;
+
+ private:
+  const std::vector<std::string> label_dense_cols_;
+  const std::vector<std::string> cat_cols_;
+  const std::vector<DataReaderSparseParam> params_;
+  const std::vector<T> slot_offset_;
+  const bool use_pinned_memory_;
+  size_t num_slots_{0};
+
+  struct Pending {
+    std::unique_ptr<Batch> batch;
+    std::future<void> done;
+  };
+
+  ThreadPool pool_;
+  std::deque<Pending> pending_;
+
+  mutable std::mutex free_batches_guard_;
+  std::vector<std::unique_ptr<Batch>> free_batches_;
+
+  // Idle readers, oldest first. A reader is used by one thread at a time, so there are at most as
+  // many readers as threads, and this many are kept.
+  struct CachedReader {
+    std::string file_name;
+    std::unique_ptr<parquet::arrow::FileReader> reader;
+  };
+  mutable std::mutex readers_guard_;
+  mutable std::deque<CachedReader> readers_;
+
+  std::unique_ptr<Batch> acquire_batch_();
+
+  std::unique_ptr<parquet::arrow::FileReader> acquire_reader_(const std::string& file_name) const;
+
+  void release_reader_(const std::string& file_name,
+                       std::unique_ptr<parquet::arrow::FileReader> reader) const;
+
+  void decode_(parquet::arrow::FileReader& reader, const std::string& file_name, int row_group,
+               Batch& batch) const;
+};
+
+}  // namespace HugeCTR
@@ -43,7 +43,9 @@
 #include <condition_variable>
 #include <data_readers/file_list.hpp>
 #include <data_readers/metadata.hpp>
+#include <data_readers/parquet_cpu_decoder.hpp>
 #include <data_readers/parquet_data_converter.hpp>
+#include <deque>
 #include <memory>
 #include <mutex>
 
@@ -97,10 +99,45 @@ class ParquetDataReaderWorker : public IDataReaderWorker,
 
   std::shared_ptr<RowGroupReadingThread<T>> row_group_reader_;
 
+  /**
+   * Hands an empty batch to the data collector and waits for the next epoch.
+   */
+  void end_epoch_();
+
   char* go_next_epoch_;
   std::mutex& epoch_mtx_;
   std::condition_variable& epoch_cv_;
 
+  // CPU decoding. Row groups are decoded by `cpu_decoder_` and uploaded from its host batches, so
+  // `row_group_reader_` and the DFContainers are not used.
+  using CPUDecoder = ParquetCPUDecoder<T, int64_t>;
+  std::unique_ptr<CPUDecoder> cpu_decoder_;
+  std::deque<std::unique_ptr<typename CPUDecoder::Batch>> cpu_batches_; /**< decoded, in order */
+  size_t cpu_batch_row_{0};  /**< first row of `cpu_batches_.front()` that is not consumed */
+  int cpu_row_group_{0};     /**< next row group of the current file to submit */
+  bool cpu_source_eof_{false};
+  core23::Tensor host_pinned_csr_row_offsets_; /**< row offsets of the batch, for all params */
+
+  /**
+   * Submits row groups to `cpu_decoder_` until enough of them are in flight or the source ends.
+   */
+  void submit_row_groups_();
+
+  /**
+   * `read_a_batch()` for CPU decoding.
+   */
+  void read_a_batch_from_host_();
+
+  /**
+   * Copies the first `batch_size` rows of `cpu_batches_` to the output buffer.
+   */
+  void upload_host_rows_(long long batch_size);
+
+  /**
+   * Drops the decoded and pending row groups, e.g. when the source changes.
+   */
+  void reset_cpu_decoder_();
+
  public:
   void set_source(std::shared_ptr<Source> source) override {
     if (!source) {
@@ -110,6 +147,11 @@ class ParquetDataReaderWorker : public IDataReaderWorker,
         HCTR_LOG(INFO, WORLD, "source is open!!\n");
       }
     }
+    if (cpu_decoder_) {
+      reset_cpu_decoder_();
+      this->source_ = source;
+      return;
+    }
     this->source_ = source;
     auto& consumer = row_group_reader_->get_df_container_consumer();
     auto& producer = row_group_reader_->get_df_container_producer(worker_id_);
@@ -132,6 +174,8 @@ class ParquetDataReaderWorker : public IDataReaderWorker,
   }
   /**
    * Ctor
+   * @param cpu_decoder_threads Decode the row groups with a `ParquetCPUDecoder` on this many
+   * threads instead of cudf. 0 selects cudf.
    */
   ParquetDataReaderWorker(
       unsigned int worker_id, unsigned int worker_num,
@@ -147,7 +191,7 @@ class ParquetDataReaderWorker : public IDataReaderWorker,
       std::vector<std::shared_ptr<std::atomic<int>>>& accomplished_workers,
       const std::shared_ptr<ResourceManager>& resource_manager,
       std::shared_ptr<std::vector<size_t>> dense_width_dim_, char* go_next_epoch_,
-      std::mutex& epoch_mtx_, std::condition_variable& epoch_cv_);
+      std::mutex& epoch_mtx_, std::condition_variable& epoch_cv_, size_t cpu_decoder_threads = 0);
 
   ~ParquetDataReaderWorker();
   /**
@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace HugeCTR {
+
+/**
+ * Sample layout of a batch-major RawAsync file: `label_dense_dim` 4-byte values (float or int32)
+ * followed by `num_keys` keys of `key_bytes` each.
+ */
+struct RawAsyncPackedLayout {
+  size_t label_dense_dim{0};
+  size_t num_keys{0};
+  size_t key_bytes{4};
+
+  inline size_t sample_size_bytes() const { return label_dense_dim * 4 + num_keys * key_bytes; }
+};
+
+/**
+ * @brief Frame-of-reference codec for blocks of RawAsync samples.
+ *
+ * Every column of a block (one label or dense value, or one key position) is stored as its minimum
+ * followed by the differences to it, bit-packed with the width of the largest difference. Keys of
+ * a slot are usually drawn from a small range, so they shrink to a fraction of their size, and
+ * constant columns (e.g. labels of a negative-only block) take no space at all. Float values are
+ * packed by their bit patterns.
+ *
+ * Encoded block: [uint64 num_samples], then per column [uint64 base][uint64 width][packed words],
+ * with the values packed LSB first into little-endian 64-bit words.
+ */
+class RawAsyncPackedCodec final {
+ public:
+  explicit RawAsyncPackedCodec(const RawAsyncPackedLayout& layout);
+
+  inline const RawAsyncPackedLayout& layout() const { return layout_; }
+
+  /**
+   * @return Upper bound of the encoded size of \p num_samples samples.
+   */
+  size_t max_encoded_size(size_t num_samples) const;
+
+  /**
+   * Encodes \p num_samples samples from \p samples into \p out , which must hold
+   * `max_encoded_size(num_samples)` bytes.
+   * @return Encoded size, a multiple of 8 bytes.
+   */
+  size_t encode(const uint8_t* samples, size_t num_samples, uint8_t* out) const;
+
+  /**
+   * Decodes the block of \p size bytes at \p in into \p samples .
+   * @return Number of decoded samples, which must not exceed \p max_samples .
+   */
+  size_t decode(const uint8_t* in, size_t size, uint8_t* samples, size_t max_samples) const;
+
+ private:
+  const RawAsyncPackedLayout layout_;
+  std::vector<size_t> column_bytes_;
+  std::vector<size_t> column_offsets_;
+};
+
+/**
+ * @brief Index of a packed RawAsync file.
+ *
+ * A packed file holds the encoded blocks of `block_samples` samples each (the last one may be
+ * shorter) back to back, followed by the block offsets and a footer. Readers address it by the
+ * offsets of the uncompressed file.
+ */
+struct RawAsyncPackedIndex {
+  RawAsyncPackedLayout layout;
+  size_t num_samples{0};
+  size_t block_samples{0};
+  std::vector<uint64_t> offsets;  // num_blocks + 1 file offsets of the encoded blocks
+
+  inline size_t num_blocks() const { return offsets.size() - 1; }
+  inline size_t block_size_bytes() const { return block_samples * layout.sample_size_bytes(); }
+  inline size_t size_bytes() const { return num_samples * layout.sample_size_bytes(); }
+
+  /**
+   * @return Largest encoded size of \p n consecutive blocks.
+   */
+  size_t max_span_bytes(size_t n) const;
+
+  /**
+   * @return The index of \p file_name , or nullptr if it is not a packed file.
+   */
+  static std::shared_ptr<const RawAsyncPackedIndex> read(const std::string& file_name);
+};
+
+struct RawAsyncPackerStats {
+  size_t num_samples{0};
+  size_t num_bytes{0};         // Uncompressed
+  size_t num_packed_bytes{0};  // Including index and footer
+  double elapsed_s{0};
+
+  inline double ratio() const {
+    return num_packed_bytes > 0 ? static_cast<double>(num_bytes) / num_packed_bytes : 0;
+  }
+};
+
+/**
+ * Packs the batch-major RawAsync file \p input_file into \p output_file , encoding blocks of
+ * \p block_samples samples on \p num_threads threads.
+ */
+RawAsyncPackerStats pack_raw_async(const std::string& input_file, const std::string& output_file,
+                                   const RawAsyncPackedLayout& layout, size_t block_samples,
+                                   size_t num_threads);
+
+}  // namespace HugeCTR
@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <common.hpp>
+#include <core/macro.hpp>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace HugeCTR {
+
+enum class RawAsyncLayout {
+  BatchMajor,   // One file of whole samples, as written by `RawAsyncGenerator`.
+  FeatureMajor  // One file for the labels and dense features, and one file per slot.
+};
+
+struct RawAsyncRepackerParams {
+  DataReaderType_t format{DataReaderType_t::Norm};  // Norm, Raw, RawAsync or Parquet.
+
+  // Sample layout of the input. Every sample must have exactly `nnz_array[slot]` keys per slot.
+  size_t label_dim{1};
+  size_t dense_dim{13};
+  std::vector<int> nnz_array;
+  bool i64_input_key{false};  // Keys are int64 instead of uint32.
+  // Raw and RawAsync only: label and dense values are floats instead of integers. Raw integers have
+  // the size of a key, RawAsync integers are int32.
+  bool float_label_dense{true};
+  std::string parquet_metadata;  // Defaults to `_metadata.json` next to the first Parquet file.
+
+  RawAsyncLayout layout{RawAsyncLayout::BatchMajor};
+  bool i64_output_key{false};
+  bool float_output_label_dense{true};
+
+  // Every output file is striped over all directories: stripe unit `i` of a file goes to directory
+  // `i % output_dirs.size()` (RAID-0).
+  std::vector<std::string> output_dirs{"."};
+  size_t stripe_size_bytes{1 << 20};
+
+  size_t batch_size{0};  // If nonzero, samples that do not fill a whole batch are dropped.
+
+  size_t num_threads{1};
+  size_t block_size_bytes{16L * 1024 * 1024};  // Target size of each write.
+  size_t io_alignment{4096};  // Writes and stripe units are multiples of this, except at the end.
+};
+
+struct RawAsyncRepackerStats {
+  size_t num_samples{0};
+  size_t num_bytes{0};
+  size_t num_blocks{0};
+  double elapsed_s{0};
+
+  inline double gbps() const { return elapsed_s > 0 ? num_bytes / elapsed_s / 1e9 : 0; }
+};
+
+/**
+ * One logical output file. Its stripes have the same name in each output directory.
+ */
+struct RawAsyncOutputFile {
+  std::string name;
+  size_t sample_size_bytes{0};
+  size_t slot_id{0};  // `FileSource::slot_id`. 0 for the label and dense file.
+  std::vector<std::string> stripes;
+};
+
+/**
+ * @brief Converts Norm, Raw, RawAsync or Parquet datasets into the fixed-size sample layout of the
+ * multi-hot `AsyncDataReader`.
+ *
+ * All input files are concatenated into one dataset. The output is cut into blocks of whole
+ * samples, such that the byte size of each block is a multiple of \p io_alignment in every output
+ * file. Worker threads claim blocks, decode them from the input, and write each file's part with
+ * positioned writes, split at stripe boundaries. RawAsync and Raw inputs are located by arithmetic,
+ * Norm sample boundaries are found by the threads in turns, and Parquet row groups are decoded by
+ * a \p ParquetCPUDecoder and copied into blocks in order.
+ *
+ * Besides the data files, \p repack writes `<output_name>.json` to the first output directory,
+ * which describes the layout and lists the files with the parameters of their `FileSource`.
+ */
+class RawAsyncRepacker final {
+ public:
+  RawAsyncRepacker(const RawAsyncRepackerParams& params);
+
+  HCTR_DISALLOW_COPY_AND_MOVE(RawAsyncRepacker);
+
+  inline size_t sample_size_bytes() const { return sample_size_bytes_; }
+
+  inline size_t samples_per_block() const { return samples_per_block_; }
+
+  /**
+   * @return The files that \p repack writes for \p output_name .
+   */
+  std::vector<RawAsyncOutputFile> output_files(const std::string& output_name) const;
+
+  RawAsyncRepackerStats repack(const std::vector<std::string>& input_files,
+                               const std::string& output_name) const;
+
+ private:
+  struct Block;
+  struct Output;
+
+  const RawAsyncRepackerParams params_;
+  size_t total_nnz_{0};
+  size_t sample_size_bytes_{0};
+  size_t samples_per_block_{0};
+
+  /**
+   * @return Size of a Raw or RawAsync sample, or of a Norm sample payload, in the input.
+   */
+  size_t input_sample_size_() const;
+
+  /**
+   * @return Number of samples in each input file.
+   */
+  std::vector<size_t> count_samples_(const std::vector<std::string>& input_files) const;
+
+  /**
+   * Runs \p num_threads threads that call \p next_block until it returns false, and write each
+   * block to \p output .
+   */
+  void run_(const std::function<bool(Block&)>& next_block, const Output& output) const;
+
+  void write_block_(const Block& block, const Output& output, char* buffer) const;
+
+  void repack_fixed_(const std::string& file_name, size_t first_sample, size_t num_samples,
+                     const Output& output) const;
+
+  void repack_norm_(const std::string& file_name, size_t first_sample, size_t num_samples,
+                    const Output& output) const;
+
+  void repack_parquet_(const std::vector<std::string>& input_files, size_t num_samples,
+                       const Output& output) const;
+};
+
+}  // namespace HugeCTR
@@ -23,6 +23,7 @@
 namespace HugeCTR {
 
 struct BufferBag;
+class FileSystem;
 class IEmbedding {
  public:
   virtual ~IEmbedding() {}
@@ -34,6 +35,8 @@ class IEmbedding {
   virtual void init_params() = 0;
   virtual void load_parameters(std::string sparse_model) = 0;
   virtual void dump_parameters(std::string sparse_model) const = 0;
+  // Writes through `fs` instead of the file system of the path (e.g., to stage a snapshot).
+  virtual void dump_parameters(const std::string& sparse_model, FileSystem& fs) const = 0;
   virtual void set_learning_rate(float lr) = 0;
   // TODO: a workaround to enable GPU LR for HE only; need a better way
   virtual GpuLearningRateSchedulers get_learning_rate_schedulers() const {
@@ -50,6 +53,7 @@ class IEmbedding {
   virtual void reset_optimizer() = 0;
 
   virtual void dump_opt_states(std::string write_path) = 0;
+  virtual void dump_opt_states(const std::string& write_path, FileSystem& fs) = 0;
   virtual void load_opt_states(std::string read_path) = 0;
 
   virtual const SparseEmbeddingHashParams& get_embedding_params() const = 0;
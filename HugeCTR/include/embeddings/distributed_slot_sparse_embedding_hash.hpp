@@ -122,6 +122,7 @@ class DistributedSlotSparseEmbeddingHash : public IEmbedding {
    * dump_parameters for DistributedSlotSparseEmbeddingHash
    * download hash_table from GPUs to CPU.
    * @param sparse_model the folder name of sparse model.
+   * @param fs the file system to write to.
    * @param vocabulary_size the total row number of hash table.
    * @param embedding_vec_size embedding vector size.
    * @param hash_table_value_tensors the tensors of hash table value on multi GPUs.
@@ -130,7 +131,8 @@ class DistributedSlotSparseEmbeddingHash : public IEmbedding {
    * @param context gpu device context, for switching device
    */
   void dump_parameters(
-      const std::string &sparse_model, size_t vocabulary_size, size_t embedding_vec_size,
+      const std::string &sparse_model, FileSystem &fs, size_t vocabulary_size,
+      size_t embedding_vec_size,
       const Tensors2<float> &hash_table_value_tensors,
       const std::vector<std::shared_ptr<HashTable<TypeHashKey, size_t>>> &hash_tables) const;
   void dump_parameters(
@@ -271,9 +273,11 @@ class DistributedSlotSparseEmbeddingHash : public IEmbedding {
    * @param sparse_model the folder name of sparse model.
    */
   void dump_parameters(std::string sparse_model) const override;
+  void dump_parameters(const std::string &sparse_model, FileSystem &fs) const override;
   void dump_parameters(BufferBag &buf_bag, size_t *num) const override;
 
   void dump_opt_states(std::string sparse_model) override;
+  void dump_opt_states(const std::string &write_path, FileSystem &fs) override;
   void load_opt_states(std::string read_path) override;
   void reset_optimizer() override;
 
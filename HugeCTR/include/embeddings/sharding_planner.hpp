@@ -0,0 +1,165 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace HugeCTR {
+
+/**
+ * Statistics of one embedding table, as seen by the sharding planner.
+ */
+struct ShardingTableStats {
+  std::string name;
+  int64_t vocabulary_size{0};
+  int ev_size{0};
+  int num_lookups{1};
+  double hotness{1};   // Average number of keys per sample, summed over all lookups.
+  bool concat{false};  // Lookups concatenate the embeddings instead of pooling them.
+
+  /**
+   * Key-frequency histogram as a cumulative coverage curve: the most frequent `first` fraction of
+   * the keys receives the `second` fraction of all accesses. Points are sorted by key fraction. If
+   * empty, keys are assumed to be accessed uniformly.
+   */
+  std::vector<std::pair<double, double>> coverage;
+};
+
+/**
+ * Description of the cluster. Bandwidths are in bytes per second and per GPU.
+ */
+struct ShardingHardware {
+  size_t num_nodes{1};
+  size_t gpus_per_node{8};
+  double memory_per_gpu{32e9};  // Bytes available for embedding tables and optimizer states.
+  double hbm_bandwidth{1e12};   // Effective bandwidth of random embedding row accesses.
+  double intra_node_bandwidth{150e9};
+  double inter_node_bandwidth{25e9};
+  double table_overhead{10e-6};  // Fixed cost of each table shard per step (kernel launches).
+
+  inline size_t num_gpus() const { return num_nodes * gpus_per_node; }
+};
+
+struct ShardingPlannerParams {
+  size_t batch_size{65536};  // Global batch size.
+  size_t emb_type_size{4};
+  size_t key_type_size{8};
+  size_t optimizer_states{0};  // Values per embedding value kept by the optimizer (Adam: 2).
+
+  bool allow_data_parallel{true};
+  bool allow_row_wise{true};
+  bool allow_hierarchical{true};
+
+  size_t max_passes{16};  // Refinement passes over all tables after the greedy assignment.
+};
+
+/**
+ * Data-parallel tables are replicated on all GPUs, and their gradients are all-reduced. A
+ * model-parallel table is placed on \p gpus , and its rows are split evenly if there are several.
+ */
+struct ShardingTablePlacement {
+  bool data_parallel{false};
+  std::vector<int> gpus;
+};
+
+/**
+ * Modeled cost of a plan, in seconds per training step.
+ */
+struct ShardingCost {
+  double step_time{0};  // Slowest GPU plus all-reduce.
+  double all_reduce_time{0};
+  std::vector<double> lookup_time;  // Per GPU.
+  std::vector<double> comm_time;    // Per GPU.
+  std::vector<double> memory;       // Per GPU, in bytes.
+  bool fits{true};
+};
+
+struct ShardingPlan {
+  bool hierarchical{false};  // Use CommunicationStrategy::Hierarchical.
+  std::vector<ShardingTablePlacement> placements;
+  ShardingCost cost;
+
+  /**
+   * @return Names of the tables on each GPU, as expected by \p EmbeddingCollectionConfig::shard .
+   */
+  std::vector<std::vector<std::string>> shard_matrix(
+      const std::vector<ShardingTableStats>& tables, size_t num_gpus) const;
+
+  /**
+   * @return The placement groups ("mp" and "dp") with their table names.
+   */
+  std::vector<std::pair<std::string, std::vector<std::string>>> shard_strategy(
+      const std::vector<ShardingTableStats>& tables) const;
+
+  /**
+   * @return `num_gpus * num_tables` 0/1 matrix, as in \p EmbeddingCollectionParam::shard_matrix .
+   */
+  std::vector<std::vector<int>> shard_matrix_ids(size_t num_gpus) const;
+};
+
+/**
+ * Finds a placement of embedding tables that minimizes the modeled step time within the memory
+ * limits of the GPUs.
+ *
+ * Per GPU, the model charges the HBM traffic of the unique keys it looks up and updates, the
+ * all-to-all traffic for keys, embeddings and gradients (split into NVLink and network shares),
+ * and a fixed overhead per table shard. All-reduce of data-parallel gradients is charged to every
+ * GPU. Unique keys per batch are estimated from the coverage curves.
+ *
+ * Tables are first assigned greedily, heaviest first, each to its cheapest option: data-parallel,
+ * or model-parallel on the 1, 2, 4, ... (up to all) least loaded GPUs, or whole nodes in
+ * hierarchical mode. Then each table is repeatedly taken out and reinserted in its best position
+ * until the plan stops improving. The search runs with and without restricting row-wise splits to
+ * the tables that need them, and, with several nodes, for uniform and hierarchical communication.
+ */
+class ShardingPlanner final {
+ public:
+  ShardingPlanner(const std::vector<ShardingTableStats>& tables, const ShardingHardware& hardware,
+                  const ShardingPlannerParams& params);
+
+  /**
+   * @return The best plan found. \p cost.fits is false if no plan satisfies the memory limits.
+   */
+  ShardingPlan plan() const;
+
+  /**
+   * Computes the modeled cost of \p plan .
+   */
+  ShardingCost evaluate(const ShardingPlan& plan) const;
+
+  /**
+   * @return Expected number of distinct keys among \p num_keys accesses to \p table .
+   */
+  double expected_unique_keys(size_t table, double num_keys) const;
+
+ private:
+  class State;
+
+  const std::vector<ShardingTableStats> tables_;
+  const ShardingHardware hardware_;
+  const ShardingPlannerParams params_;
+
+  /**
+   * @param min_splits Only split tables across as many GPUs (or nodes) as their size requires.
+   */
+  ShardingPlan plan_(bool hierarchical, bool min_splits) const;
+};
+
+}  // namespace HugeCTR
@@ -489,7 +489,8 @@ class SparseEmbeddingFunctors {
       Optimizer_t optimizer_type, size_t local_gpu_count);
 
   template <typename TypeEmbeddingComp>
-  void dump_opt_states(std::string &write_path, const ResourceManager &resource_manager,
+  void dump_opt_states(const std::string &write_path, FileSystem &fs,
+                       const ResourceManager &resource_manager,
                        std::vector<Tensors2<TypeEmbeddingComp>> &opt_states);
   template <typename TypeEmbeddingComp>
   void load_opt_states(std::string &read_path, const ResourceManager &resource_manager,
@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <core/macro.hpp>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace HugeCTR {
+
+/**
+ * TinyLFU admission filter. Decides whether a key is requested often enough to be worth inserting
+ * into a cache.
+ *
+ * The first occurrence of a key within a window only sets its bits in a Bloom filter (the
+ * doorkeeper). Further occurrences are counted in a count-min sketch with 4-bit counters. A key is
+ * admitted once its estimated frequency reaches \p threshold . After \p window recorded keys, all
+ * counters are halved and the doorkeeper is cleared, so that keys which were popular a long time
+ * ago eventually have to prove themselves again.
+ *
+ * All methods are thread-safe.
+ *
+ * @tparam Key The data-type that is used for keys in this database.
+ */
+template <typename Key>
+class AdmissionFilter final {
+ public:
+  // The doorkeeper contributes one occurrence, and a counter saturates at 15.
+  static constexpr uint32_t max_threshold{16};
+
+  HCTR_DISALLOW_COPY_AND_MOVE(AdmissionFilter);
+
+  AdmissionFilter() = delete;
+
+  /**
+   * @param threshold Number of occurrences within a window before a key is admitted.
+   * @param window Number of recorded keys after which the frequencies are aged.
+   */
+  AdmissionFilter(uint32_t threshold, size_t window);
+
+  inline uint32_t threshold() const { return threshold_; }
+
+  inline size_t window() const { return window_; }
+
+  /**
+   * Records an occurrence of each key in \p keys that is referenced by \p indices . Then removes
+   * the indices of keys that should not be admitted, preserving the order of the others.
+   */
+  void filter(std::vector<size_t>& indices, const Key* keys);
+
+  /**
+   * @return Estimated number of occurrences of \p key in the current window, capped at 16.
+   */
+  uint32_t estimate(Key key) const;
+
+ private:
+  static constexpr size_t depth_{4};
+  static constexpr size_t doorkeeper_hashes_{3};
+
+  const uint32_t threshold_;
+  const size_t window_;
+
+  mutable std::mutex guard_;
+  size_t num_samples_{0};
+
+  // Count-min sketch with `depth_` rows of `width_mask_ + 1` counters, 16 per word.
+  size_t width_mask_;
+  std::vector<uint64_t> counters_;
+
+  // Bloom filter with `doorkeeper_mask_ + 1` bits.
+  size_t doorkeeper_mask_;
+  std::vector<uint64_t> doorkeeper_;
+
+  bool doorkeeper_insert_(uint64_t hash);
+
+  bool doorkeeper_contains_(uint64_t hash) const;
+
+  uint32_t estimate_(uint64_t hash) const;
+
+  uint32_t increment_(uint64_t hash);
+
+  void age_();
+};
+
+}  // namespace HugeCTR
@@ -47,6 +47,18 @@ enum class DatabaseTableDumpFormat_t {
   SST,            // Write data as an "Static Sorted Table" file.
 };
 
+/**
+ * Memory accounting of a database table. Backends report 0 for quantities they cannot determine.
+ */
+struct DatabaseTableStats {
+  size_t num_keys{0};
+  size_t bytes_resident{0};   // Bytes occupied by the values of the stored keys.
+  size_t bytes_allocated{0};  // Bytes reserved for values, including free slots.
+  size_t free_slot_bytes{0};  // Reserved bytes that are currently unused.
+  size_t num_overflows{0};    // Number of times a partition exceeded its overflow margin.
+  size_t num_evictions{0};    // Keys evicted while resolving overflows.
+};
+
 /**
  * Base class for database backends. Implementations that inherit from this should override all
  * public members.
@@ -240,6 +252,14 @@ class DatabaseBackendBase {
 
   virtual size_t load_dump_sst(const std::string& table_name, const std::string& path);
 
+  /**
+   * Gathers memory and overflow statistics of a table. The default implementation only reports the
+   * number of keys.
+   *
+   * @param table_name The name of the table to be queried.
+   */
+  virtual DatabaseTableStats table_stats(const std::string& table_name) const;
+
  private:
   const size_t max_batch_size_;  // Temporary, until find a better solution.
 };
@@ -21,8 +21,10 @@
 #include <hps/embedding_cache_gpu.hpp>
 #include <hps/inference_utils.hpp>
 #include <hps/memory_pool.hpp>
+#include <hps/unique_op/cpu_unique_op.hpp>
 #include <hps/unique_op/unique_op.hpp>
 #include <memory>
+#include <nv_cpu_cache.hpp>
 #include <nv_gpu_cache.hpp>
 #include <thread_pool.hpp>
 
@@ -82,9 +84,13 @@ class EmbeddingCache : public EmbeddingCacheBase,
   using NVCache =
       gpu_cache::gpu_cache<TypeHashKey, uint64_t, std::numeric_limits<TypeHashKey>::max(),
                            SET_ASSOCIATIVITY, SLAB_SIZE>;
+  using HostCache =
+      gpu_cache::cpu_cache<TypeHashKey, uint64_t, std::numeric_limits<TypeHashKey>::max(),
+                           SET_ASSOCIATIVITY, SLAB_SIZE>;
   using UniqueOp =
       unique_op::unique_op<TypeHashKey, uint64_t, std::numeric_limits<TypeHashKey>::max(),
                            std::numeric_limits<uint64_t>::max()>;
+  using CpuUniqueOp = unique_op::CpuUniqueOp<TypeHashKey>;
 
   // The parameter server that it is bound to
   HierParameterServerBase* parameter_server_;
@@ -95,6 +101,9 @@ class EmbeddingCache : public EmbeddingCacheBase,
   // The shared thread-safe embedding cache
   std::vector<std::unique_ptr<gpu_cache::gpu_cache_api<TypeHashKey>>> gpu_emb_caches_;
 
+  // The host embedding cache, used instead if the GPU embedding cache is disabled
+  std::vector<std::unique_ptr<HostCache>> host_emb_caches_;
+
   // streams for asynchronous parameter server insert threads
   std::vector<cudaStream_t> insert_streams_;
 
@@ -112,6 +121,16 @@ class EmbeddingCache : public EmbeddingCacheBase,
 
   // benchmark profiler
   std::unique_ptr<profiler> ec_profiler_;
+
+  // Lookup path if the GPU embedding cache is disabled. Deduplicates the keys on the host, fetches
+  // them from the parameter server, and leaves the results in `h_missing_emb_vec_`.
+  void lookup_from_host_(size_t table_id, EmbeddingCacheWorkspace& workspace_handler,
+                         const void* h_keys, size_t num_keys);
+
+  // Looks up the `num_unique` keys in `h_embeddingcolumns_` from the host embedding cache, fetches
+  // the misses from the parameter server, and inserts them into the cache.
+  void lookup_from_host_cache_(size_t table_id, EmbeddingCacheWorkspace& workspace_handler,
+                               size_t num_unique);
 };
 
 }  // namespace HugeCTR
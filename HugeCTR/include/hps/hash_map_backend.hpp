@@ -17,11 +17,18 @@
 
 #include <parallel_hashmap/phmap.h>
 
+#include <algorithm>
 #include <condition_variable>
 #include <core/memory.hpp>
 #include <deque>
 #include <functional>
 #include <hps/database_backend.hpp>
+#include <hps/hot_key_replica.hpp>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <optional>
 #include <shared_mutex>
 #include <thread>
 #include <thread_pool.hpp>
@@ -37,6 +44,26 @@ namespace HugeCTR {
 struct HashMapBackendParams final : public VolatileBackendParams {
   size_t allocation_rate{256L * 1024 *
                          1024};  // Number of additional bytes to allocate per allocation cycle.
+  bool numa_aware{false};  // Assign partitions to NUMA nodes, and process them on node-local CPUs.
+  size_t hot_key_capacity{0};  // Number of hottest keys per table to replicate (0 = disabled).
+  size_t hot_key_refresh_interval{1024L * 1024};  // Number of fetched keys between refreshes.
+  size_t compaction_interval_ms{0};               // Period of background compaction (0 = disabled).
+  size_t compaction_time_budget_us{1000};         // Max. time a compaction may lock a table.
+  double compaction_slack{0.25};                  // Tolerated fraction of unused value memory.
+};
+
+/**
+ * Distribution of fetch traffic of a \p HashMapBackend table.
+ */
+struct HashMapBackendLoadStats final {
+  std::vector<size_t> partition_loads;  // Number of keys dispatched to each partition.
+  size_t replica_hits{0};               // Number of keys served by the hot key replica.
+  size_t replica_size{0};               // Number of keys currently replicated.
+
+  /**
+   * @return Load of the busiest partition relative to the mean load (1 = perfectly balanced).
+   */
+  double imbalance() const;
 };
 
 /**
@@ -59,12 +86,16 @@ class HashMapBackend final : public VolatileBackend<Key, HashMapBackendParams> {
    */
   HashMapBackend(const HashMapBackendParams& params);
 
+  ~HashMapBackend() override;
+
   bool is_shared() const override final { return false; }
 
   const char* get_name() const override { return "HashMapBackend"; }
 
   size_t size(const std::string& table_name) const override;
 
+  DatabaseTableStats table_stats(const std::string& table_name) const override;
+
   size_t contains(const std::string& table_name, size_t num_keys, const Key* keys,
                   const std::chrono::nanoseconds& time_budget) const override;
 
@@ -92,6 +123,27 @@ class HashMapBackend final : public VolatileBackend<Key, HashMapBackendParams> {
   size_t dump_sst(const std::string& table_name, rocksdb::SstFileWriter& file) override;
 #endif  // HCTR_USE_ROCKS_DB
 
+  /**
+   * @return The NUMA node that hosts partition \p part_index, or -1 if NUMA placement is disabled.
+   */
+  int numa_node(size_t part_index) const;
+
+  /**
+   * @return Distribution of the fetch traffic of \p table_name since it was created.
+   */
+  HashMapBackendLoadStats load_stats(const std::string& table_name) const;
+
+  /**
+   * Moves values out of sparsely used value pages of \p table_name , and returns the emptied pages
+   * to the system. Only partitions whose unused value memory exceeds the configured slack are
+   * compacted, sparsest pages first. The table is locked while compaction runs. It stops shortly
+   * after \p time_budget elapsed, also within a page, and continues where it stopped at the next
+   * call.
+   *
+   * @return Number of bytes released.
+   */
+  size_t compact(const std::string& table_name, const std::chrono::microseconds& time_budget);
+
  protected:
 #if 1
   // Better performance on most systems.
@@ -126,6 +178,19 @@ class HashMapBackend final : public VolatileBackend<Key, HashMapBackendParams> {
     std::vector<ValuePage> value_pages;
     std::vector<ValuePtr> value_slots;
 
+    // Number of values stored in each page, and the pages sorted by address, to find the page of
+    // a value.
+    std::vector<size_t> page_loads;
+    std::vector<std::pair<const char*, size_t>> page_addrs;
+
+    // Compaction progress. Pages are drained one at a time. The free slots of the draining page are
+    // withheld from `value_slots` first, then its values are moved to other pages.
+    static constexpr size_t no_page{std::numeric_limits<size_t>::max()};
+    size_t draining_page{no_page};
+    bool slots_withheld{false};
+    size_t slot_cursor{0};        // `value_slots` below this index hold no slot of the page.
+    std::optional<Key> next_key;  // Entry at which the search for values of the page continues.
+
     // Key -> Payload map.
     phmap::flat_hash_map<Key, Payload> entries;
 
@@ -133,6 +198,31 @@ class HashMapBackend final : public VolatileBackend<Key, HashMapBackendParams> {
 
     Partition(const uint32_t value_size, const HashMapBackendParams& params)
         : value_size{value_size}, allocation_rate{params.allocation_rate} {}
+
+    size_t find_page(const char* const value) const {
+      return std::prev(std::upper_bound(page_addrs.begin(), page_addrs.end(),
+                                        std::make_pair(value, no_page)))
+          ->second;
+    }
+
+    // Must be called after a value was stored in the slot \p value .
+    void on_store(const ValuePtr value) {
+      while (page_loads.size() != value_pages.size()) {
+        const std::pair<const char*, size_t> page{value_pages[page_loads.size()].data(),
+                                                  page_loads.size()};
+        page_addrs.insert(std::upper_bound(page_addrs.begin(), page_addrs.end(), page), page);
+        page_loads.emplace_back(0);
+      }
+      ++page_loads[find_page(value)];
+    }
+
+    // Must be called after the value in the slot \p value was erased.
+    // @return Whether the slot can be reused. Slots of the draining page are withheld.
+    bool on_erase(const ValuePtr value) {
+      const size_t page{find_page(value)};
+      --page_loads[page];
+      return page != draining_page;
+    }
   };
 
   // Actual data.
@@ -142,8 +232,76 @@ class HashMapBackend final : public VolatileBackend<Key, HashMapBackendParams> {
   // Access control.
   mutable std::shared_mutex read_write_guard_;
 
+  // NUMA placement. Partition `i` lives on `numa_nodes_[i % numa_nodes_.size()]`. Its memory is
+  // allocated (first-touched) and accessed by workers of the matching pool, which are pinned to
+  // that node. Empty if NUMA placement is disabled or unavailable.
+  std::vector<int> numa_nodes_;
+  std::vector<std::unique_ptr<ThreadPool>> numa_thread_pools_;
+
+  ThreadPool& part_thread_pool_(size_t part_index) const;
+
+  // Load balancing. Partitions are assigned by key hash, which balances keys, but not traffic. If
+  // enabled, the hottest keys of each table are tracked online, and periodically replicated into
+  // a compact array that is probed before dispatching keys to the partitions.
+  static constexpr size_t hot_key_sample_stride{4};
+
+  struct TableLoad final {
+    std::vector<std::atomic<size_t>> part_loads;  // Keys dispatched to each partition.
+    std::atomic<size_t> replica_hits{0};
+    std::unique_ptr<HotKeyTracker<Key>> tracker;  // nullptr if replication is disabled.
+    std::shared_ptr<HotKeyReplica<Key>> replica;  // Only access through std::atomic_load/store.
+    std::atomic<size_t> num_keys_since_refresh{0};
+    std::mutex refresh_guard;
+    std::atomic<size_t> num_overflows{0};
+    std::atomic<size_t> num_evictions{0};
+    size_t next_compaction_part{0};  // Protected by `read_write_guard_`.
+
+    TableLoad(size_t num_partitions, const HashMapBackendParams& params);
+  };
+
+  std::unordered_map<std::string, std::unique_ptr<TableLoad>> table_loads_;
+
+  size_t fetch_direct_(const std::string& table_name, std::vector<Partition>& parts,
+                       TableLoad& load, size_t num_keys, const Key* keys, char* values,
+                       size_t value_stride, const DatabaseMissCallback& on_miss,
+                       const std::chrono::nanoseconds& time_budget,
+                       const std::chrono::high_resolution_clock::time_point& begin);
+
+  size_t fetch_indirect_(const std::string& table_name, std::vector<Partition>& parts,
+                         TableLoad& load, size_t num_indices, const size_t* indices,
+                         const Key* keys, char* values, size_t value_stride,
+                         const DatabaseMissCallback& on_miss,
+                         const std::chrono::nanoseconds& time_budget,
+                         const std::chrono::high_resolution_clock::time_point& begin);
+
+  // Copies values of replicated keys, and collects the indices of all other keys in
+  // `cold_indices`. Returns the number of replicated keys (`cold_indices` is empty if 0).
+  size_t fetch_replicated_(TableLoad& load, size_t num_indices, const size_t* indices,
+                           const Key* keys, char* values, size_t value_stride,
+                           std::vector<size_t>& cold_indices) const;
+
+  void refresh_hot_keys_(const std::string& table_name, std::vector<Partition>& parts,
+                         TableLoad& load);
+
   // Overflow resolution.
   size_t resolve_overflow_(const std::string& table_name, size_t part_index, Partition& part);
+
+  // Memory compaction. If enabled, a background thread periodically compacts all tables.
+  std::thread compaction_thread_;
+  std::mutex compaction_guard_;
+  std::condition_variable compaction_cv_;
+  bool stop_compaction_{false};
+
+  void run_compaction_();
+
+  // Number of slots or entries compaction visits between checks of its deadline.
+  static constexpr size_t compaction_step{256};
+
+  // Selects the sparsest page of \p part for draining. Returns false if compaction is not needed.
+  bool select_draining_page_(Partition& part) const;
+
+  size_t compact_partition_(Partition& part,
+                            const std::chrono::steady_clock::time_point& deadline);
 };
 
 // TODO: Remove me!
@@ -55,7 +55,9 @@ namespace HugeCTR {
       const Payload& payload{it->second};                           \
                                                                     \
       /* Stash pointer and reference in map. */                     \
-      part.value_slots.emplace_back(payload.value);                 \
+      if (part.on_erase(payload.value)) {                           \
+        part.value_slots.emplace_back(payload.value);               \
+      }                                                             \
       part.entries.erase(it);                                       \
       ++num_deletions;                                              \
     }                                                               \
@@ -164,6 +166,7 @@ namespace HugeCTR {
       /* Fetch storage slot. */                                                              \
       payload.value = part.value_slots.back();                                               \
       part.value_slots.pop_back();                                                           \
+      part.on_store(payload.value);                                                          \
       ++num_inserts;                                                                         \
     }                                                                                        \
                                                                                              \
@@ -195,6 +198,25 @@ namespace HugeCTR {
     return true;                                                                              \
   }()
 
+/**
+ * HashMap Backend / Parallel dispatch. Like `HCTR_HPS_DB_PARALLEL_FOR_EACH_PART_`, but runs each
+ * partition on the thread pool that is local to its NUMA node.
+ */
+#ifdef HCTR_HPS_HASH_MAP_PARALLEL_FOR_EACH_PART_
+#error HCTR_HPS_HASH_MAP_PARALLEL_FOR_EACH_PART_ already defined. Potential naming conflict!
+#endif
+#define HCTR_HPS_HASH_MAP_PARALLEL_FOR_EACH_PART_(...)                               \
+  do {                                                                               \
+    std::vector<std::future<void>> tasks;                                            \
+    tasks.reserve(num_partitions);                                                   \
+                                                                                     \
+    for (size_t part_index{0}; part_index < num_partitions; ++part_index) {          \
+      tasks.emplace_back(                                                            \
+          part_thread_pool_(part_index).submit([&, part_index]() { __VA_ARGS__; })); \
+    }                                                                                \
+    ThreadPool::await(tasks.begin(), tasks.end());                                   \
+  } while (0)
+
 // TODO: Remove me!
 #pragma GCC diagnostic pop
 
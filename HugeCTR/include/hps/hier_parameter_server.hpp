@@ -16,14 +16,17 @@
 #pragma once
 
 #include <common.hpp>
+#include <hps/admission_filter.hpp>
 #include <hps/database_backend.hpp>
 #include <hps/embedding_cache_base.hpp>
 #include <hps/hier_parameter_server_base.hpp>
 #include <hps/inference_utils.hpp>
 #include <hps/memory_pool.hpp>
 #include <hps/message.hpp>
+#include <hps/versioned_table.hpp>
 #include <iostream>
 #include <memory>
+#include <shared_mutex>
 #include <string>
 #include <thread>
 #include <unordered_map>
@@ -53,8 +56,34 @@ class HierParameterServer : public HierParameterServerBase {
   virtual void* apply_buffer(const std::string& model_name, int device_id,
                              CACHE_SPACE_TYPE cache_type = CACHE_SPACE_TYPE::WORKER);
   virtual void free_buffer(void* p);
+  virtual MemoryPoolStats get_buffer_pool_stats(
+      const std::string& model_name, int device_id,
+      CACHE_SPACE_TYPE cache_type = CACHE_SPACE_TYPE::WORKER);
   virtual void lookup(const void* h_keys, size_t length, float* h_vectors,
                       const std::string& model_name, size_t table_id);
+  /**
+   * @return The counters of an embedding table. They are shared with the embedding caches, which
+   * report their own lookups.
+   */
+  virtual std::shared_ptr<HPSTableCounters> get_table_counters(const std::string& model_name,
+                                                               size_t table_id);
+  /**
+   * Takes a snapshot of the statistics of all embedding tables of a model, or of all models if
+   * \p model_name is empty.
+   */
+  virtual std::vector<HPSTableStats> get_stats(const std::string& model_name = "");
+  /**
+   * Stages new values for some rows of an embedding table. Staged rows are invisible to lookups
+   * until \p publish_model_update is called. Keys that are not part of the table are added.
+   */
+  virtual void stage_model_update(const std::string& model_name, size_t table_id,
+                                  const void* h_keys, const float* h_vectors, size_t length);
+  /**
+   * Atomically switches all database lookups of each embedding table of the model to the staged
+   * rows. Cached copies of these rows are updated before this call returns. Older versions are
+   * merged and reclaimed in the background, once in-flight lookups drained.
+   */
+  virtual void publish_model_update(const std::string& model_name);
   virtual void refresh_embedding_cache(const std::string& model_name, int device_id);
   virtual void insert_embedding_cache(size_t table_id,
                                       std::shared_ptr<EmbeddingCacheBase> embedding_cache,
@@ -76,10 +105,41 @@ class HierParameterServer : public HierParameterServerBase {
   bool volatile_db_initialize_after_startup_;
   double volatile_db_cache_rate_;
   bool volatile_db_cache_missed_embeddings_;
+  size_t volatile_db_elevation_admission_threshold_{0};
+  size_t volatile_db_elevation_admission_window_{0};
   mutable ThreadPool volatile_db_async_inserter_{"vdb inserter", 1};
 
   std::unique_ptr<DatabaseBackendBase<TypeHashKey>> persistent_db_;
   bool persistent_db_initialize_after_startup_;
+  bool persistent_db_read_only_{false};
+
+  // Versioned views of tables that received model updates (see stage_model_update). These live in
+  // the first database tier, and are written through to the persistent database.
+  std::map<std::string, std::shared_ptr<VersionedTable<TypeHashKey>>> versioned_tables_;
+  mutable std::shared_mutex versioned_tables_guard_;
+  // Merges published versions. Separate from `volatile_db_async_inserter_`, because a merge may
+  // wait for in-flight lookups.
+  mutable ThreadPool versioned_table_reclaimer_{"vdb reclaimer", 1};
+
+  std::shared_ptr<VersionedTable<TypeHashKey>> find_versioned_table_(
+      const std::string& tag_name) const;
+
+  // Overwrites the rows of `keys` that are held by the embedding caches of the model with their
+  // current values.
+  void update_embedding_cache_(const std::string& model_name, size_t table_id,
+                               const std::vector<TypeHashKey>& keys);
+
+  // Lookup statistics of each table, by tag name. Created on first use.
+  std::map<std::string, std::shared_ptr<HPSTableCounters>> table_counters_;
+  mutable std::shared_mutex table_counters_guard_;
+
+  std::shared_ptr<HPSTableCounters> find_table_counters_(const std::string& tag_name);
+
+  // Admission filters for missed embeddings of each table, by tag name. Created on first use.
+  std::map<std::string, std::shared_ptr<AdmissionFilter<TypeHashKey>>> elevation_filters_;
+  mutable std::shared_mutex elevation_filters_guard_;
+
+  std::shared_ptr<AdmissionFilter<TypeHashKey>> find_elevation_filter_(const std::string& tag_name);
 
   // Realtime data ingestion.
   std::unique_ptr<MessageSource<TypeHashKey>> volatile_db_source_;
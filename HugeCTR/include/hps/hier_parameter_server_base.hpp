@@ -16,6 +16,7 @@
 #pragma once
 
 #include <hps/embedding_cache_base.hpp>
+#include <hps/hps_stats.hpp>
 #include <hps/inference_utils.hpp>
 #include <memory>
 #include <string>
@@ -59,8 +60,17 @@ class HierParameterServerBase {
   virtual void* apply_buffer(const std::string& model_name, int device_id,
                              CACHE_SPACE_TYPE cache_type = CACHE_SPACE_TYPE::WORKER) = 0;
   virtual void free_buffer(void* p) = 0;
+  virtual MemoryPoolStats get_buffer_pool_stats(
+      const std::string& model_name, int device_id,
+      CACHE_SPACE_TYPE cache_type = CACHE_SPACE_TYPE::WORKER) = 0;
   virtual void lookup(const void* h_keys, size_t length, float* h_vectors,
                       const std::string& model_name, size_t table_id) = 0;
+  virtual std::shared_ptr<HPSTableCounters> get_table_counters(const std::string& model_name,
+                                                               size_t table_id) = 0;
+  virtual std::vector<HPSTableStats> get_stats(const std::string& model_name = "") = 0;
+  virtual void stage_model_update(const std::string& model_name, size_t table_id,
+                                  const void* h_keys, const float* h_vectors, size_t length) = 0;
+  virtual void publish_model_update(const std::string& model_name) = 0;
   virtual void refresh_embedding_cache(const std::string& model_name, int device_id) = 0;
   virtual void insert_embedding_cache(size_t table_id,
                                       std::shared_ptr<EmbeddingCacheBase> embedding_cache,
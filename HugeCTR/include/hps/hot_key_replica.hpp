@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <parallel_hashmap/phmap.h>
+
+#include <atomic>
+#include <core/macro.hpp>
+#include <core/memory.hpp>
+#include <limits>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace HugeCTR {
+
+/**
+ * Online heavy hitter detection. Estimates key frequencies with a count-min sketch and keeps the
+ * keys with the highest estimates as candidates. Only every n-th key is sampled, and estimates
+ * are halved at each \p decay , so that the tracker follows changes in the key distribution.
+ *
+ * \p record is thread-safe and lock-free, except for keys that enter the candidate set.
+ *
+ * @tparam Key The data-type that is used for keys in this database.
+ */
+template <typename Key>
+class HotKeyTracker final {
+ public:
+  HCTR_DISALLOW_COPY_AND_MOVE(HotKeyTracker);
+
+  HotKeyTracker() = delete;
+
+  /**
+   * @param capacity Number of heavy hitters to track.
+   * @param sample_stride Only every \p sample_stride -th recorded key is counted.
+   */
+  HotKeyTracker(size_t capacity, size_t sample_stride);
+
+  inline size_t capacity() const { return capacity_; }
+
+  void record(size_t num_keys, const Key* keys);
+
+  void record(size_t num_indices, const size_t* indices, const Key* keys);
+
+  /**
+   * @return Estimated frequency of \p key (in samples).
+   */
+  uint32_t estimate(Key key) const;
+
+  /**
+   * @return Up to \p capacity keys with the highest estimated frequency, in descending order.
+   */
+  std::vector<std::pair<Key, uint32_t>> top() const;
+
+  /**
+   * Halves all counts.
+   */
+  void decay();
+
+ private:
+  static constexpr size_t depth_{4};
+
+  const size_t capacity_;
+  const size_t sample_stride_;
+  std::atomic<size_t> sample_offset_{0};
+
+  // Count-min sketch with `depth_` rows of `width_mask_ + 1` counters.
+  size_t width_mask_;
+  std::vector<std::atomic<uint32_t>> counters_;
+
+  // Heavy hitter candidates. Holds between `capacity_` and `2 * capacity_` keys.
+  mutable std::mutex candidates_guard_;
+  phmap::flat_hash_map<Key, uint32_t> candidates_;
+  std::atomic<uint32_t> admission_threshold_{0};
+
+  size_t counter_index_(Key key, size_t row) const;
+
+  uint32_t increment_(Key key);
+
+  void admit_(const std::vector<std::pair<Key, uint32_t>>& keys);
+};
+
+/**
+ * Compact read-optimized copy of a small number of rows. Lookups probe an open addressing table
+ * of packed (key, slot) pairs. Values are stored back-to-back with cache line alignment.
+ *
+ * The replica is not synchronized. Readers may share it, but writers require exclusive access.
+ *
+ * @tparam Key The data-type that is used for keys in this database.
+ */
+template <typename Key>
+class HotKeyReplica final {
+ public:
+  HCTR_DISALLOW_COPY_AND_MOVE(HotKeyReplica);
+
+  HotKeyReplica() = delete;
+
+  HotKeyReplica(size_t capacity, uint32_t value_size);
+
+  inline size_t size() const { return size_; }
+
+  inline size_t capacity() const { return capacity_; }
+
+  inline uint32_t value_size() const { return value_size_; }
+
+  /**
+   * @return Pointer to the value of \p key , or \p nullptr if \p key is not replicated.
+   */
+  inline const char* find(const Key key) const {
+    for (size_t i{hash_(key) & mask_};; i = (i + 1) & mask_) {
+      const Slot& slot{slots_[i]};
+      if (slot.value_index == empty_slot) {
+        return nullptr;
+      }
+      if (slot.key == key) {
+        return &values_[slot.value_index * value_stride_];
+      }
+    }
+  }
+
+  inline char* find(const Key key) {
+    return const_cast<char*>(static_cast<const HotKeyReplica*>(this)->find(key));
+  }
+
+  /**
+   * Adds \p key to the replica, or updates its value.
+   *
+   * @return \p false if the replica is full.
+   */
+  bool insert(Key key, const char* value);
+
+ private:
+  static constexpr uint32_t empty_slot{std::numeric_limits<uint32_t>::max()};
+
+  struct Slot final {
+    Key key;
+    uint32_t value_index;
+  };
+
+  const size_t capacity_;
+  const uint32_t value_size_;
+  const size_t value_stride_;
+  size_t size_{0};
+
+  size_t mask_;
+  std::vector<Slot, AlignedAllocator<Slot>> slots_;
+  std::vector<char, AlignedAllocator<char>> values_;
+
+  static inline size_t hash_(const Key key) {
+    // Fibonacci hashing. Independent enough from the partition hash for our purposes.
+    const uint64_t h{static_cast<uint64_t>(key) * UINT64_C(0x9E3779B97F4A7C15)};
+    return static_cast<size_t>(h ^ (h >> 32));
+  }
+};
+
+}  // namespace HugeCTR
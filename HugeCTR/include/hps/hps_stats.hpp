@@ -0,0 +1,145 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <hps/database_backend.hpp>
+#include <string>
+
+namespace HugeCTR {
+
+/**
+ * Lookup statistics of one level of the HPS storage hierarchy.
+ */
+struct HPSTierStats {
+  size_t num_lookups{0};  // Keys queried in this tier.
+  size_t num_hits{0};     // Keys that were found.
+
+  size_t num_misses() const { return num_lookups - num_hits; }
+
+  double hit_ratio() const {
+    return num_lookups ? static_cast<double>(num_hits) / static_cast<double>(num_lookups) : 0.0;
+  }
+};
+
+/**
+ * Snapshot of the statistics of an embedding table, across all levels of the HPS.
+ */
+struct HPSTableStats {
+  std::string model_name;
+  std::string table_name;
+
+  // Unique keys queried by the GPU embedding caches of all devices.
+  HPSTierStats embedding_cache;
+  // Keys queried by the parameter server.
+  HPSTierStats volatile_db;
+  // Keys that were missing in the volatile database, or all keys if there is no volatile database.
+  HPSTierStats persistent_db;
+
+  size_t num_defaults{0};              // Keys that were not found in any database.
+  size_t num_elevation_candidates{0};  // Keys that could be elevated into the volatile database.
+  size_t num_elevations{0};            // Keys copied from the persistent to the volatile database.
+
+  // Keys looked up by embedding caches without a GPU cache, before and after host deduplication.
+  size_t num_host_keys{0};
+  size_t num_host_unique_keys{0};
+
+  DatabaseTableStats volatile_db_table;
+  DatabaseTableStats persistent_db_table;
+
+  double elevation_admission_ratio() const {
+    return num_elevation_candidates ? static_cast<double>(num_elevations) /
+                                          static_cast<double>(num_elevation_candidates)
+                                    : 0.0;
+  }
+
+  double host_dedup_ratio() const {
+    return num_host_keys ? 1.0 - static_cast<double>(num_host_unique_keys) /
+                                     static_cast<double>(num_host_keys)
+                         : 0.0;
+  }
+};
+
+/**
+ * Always-on counters of an embedding table. They are updated once per lookup batch, with relaxed
+ * atomics, and can be read at any time.
+ */
+class HPSTableCounters final {
+ public:
+  class Tier final {
+   public:
+    void record(const size_t num_lookups, const size_t num_hits) {
+      num_lookups_.fetch_add(num_lookups, std::memory_order_relaxed);
+      num_hits_.fetch_add(num_hits, std::memory_order_relaxed);
+    }
+
+    HPSTierStats snapshot() const {
+      HPSTierStats stats;
+      stats.num_hits = num_hits_.load(std::memory_order_relaxed);
+      // Concurrent updates may be observed partially. Never report more hits than lookups.
+      stats.num_lookups = std::max(num_lookups_.load(std::memory_order_relaxed), stats.num_hits);
+      return stats;
+    }
+
+   private:
+    std::atomic<size_t> num_lookups_{0};
+    std::atomic<size_t> num_hits_{0};
+  };
+
+  Tier embedding_cache;
+  Tier volatile_db;
+  Tier persistent_db;
+
+  void record_defaults(const size_t num_keys) {
+    num_defaults_.fetch_add(num_keys, std::memory_order_relaxed);
+  }
+
+  void record_elevations(const size_t num_candidates, const size_t num_keys) {
+    num_elevation_candidates_.fetch_add(num_candidates, std::memory_order_relaxed);
+    num_elevations_.fetch_add(num_keys, std::memory_order_relaxed);
+  }
+
+  void record_host_dedup(const size_t num_keys, const size_t num_unique_keys) {
+    num_host_keys_.fetch_add(num_keys, std::memory_order_relaxed);
+    num_host_unique_keys_.fetch_add(num_unique_keys, std::memory_order_relaxed);
+  }
+
+  /**
+   * Copies the counters into \p stats. Database table statistics are not touched.
+   */
+  void snapshot(HPSTableStats& stats) const {
+    stats.embedding_cache = embedding_cache.snapshot();
+    stats.volatile_db = volatile_db.snapshot();
+    stats.persistent_db = persistent_db.snapshot();
+    stats.num_defaults = num_defaults_.load(std::memory_order_relaxed);
+    stats.num_elevations = num_elevations_.load(std::memory_order_relaxed);
+    stats.num_elevation_candidates =
+        std::max(num_elevation_candidates_.load(std::memory_order_relaxed), stats.num_elevations);
+    stats.num_host_unique_keys = num_host_unique_keys_.load(std::memory_order_relaxed);
+    stats.num_host_keys =
+        std::max(num_host_keys_.load(std::memory_order_relaxed), stats.num_host_unique_keys);
+  }
+
+ private:
+  std::atomic<size_t> num_defaults_{0};
+  std::atomic<size_t> num_elevation_candidates_{0};
+  std::atomic<size_t> num_elevations_{0};
+  std::atomic<size_t> num_host_keys_{0};
+  std::atomic<size_t> num_host_unique_keys_{0};
+};
+
+}  // namespace HugeCTR
@@ -159,7 +159,13 @@ struct VolatileDatabaseParams {
   std::string user_name{"default"};       // "default" = Standard user for Redis!
   std::string password;
   size_t num_partitions{16};
-  size_t allocation_rate{256L * 1024 * 1024};  // Only used with HashMap type backends.
+  size_t allocation_rate{256L * 1024 * 1024};     // Only used with HashMap type backends.
+  bool numa_aware{false};                         // Only used with HashMap type backends.
+  size_t hot_key_capacity{0};                     // Only used with HashMap type backends.
+  size_t hot_key_refresh_interval{1024L * 1024};  // Only used with HashMap type backends.
+  size_t compaction_interval_ms{0};               // Only used with HashMap type backends.
+  size_t compaction_time_budget_us{1000};         // Only used with HashMap type backends.
+  double compaction_slack{0.25};                  // Only used with HashMap type backends.
   size_t shared_memory_size{
       16L * 1024 * 1024 *
       1024};  // Size-limit of the shared memory (only for Multi-Process hashmap).
@@ -184,6 +190,8 @@ struct VolatileDatabaseParams {
   bool initialize_after_startup{true};
   double initial_cache_rate{1.0};
   bool cache_missed_embeddings{false};
+  size_t elevation_admission_threshold{0};  // 0 = Elevate all missed embeddings.
+  size_t elevation_admission_window{1024L * 1024};
 
   // Real-time update mechanism related.
   std::vector<std::string> update_filters{{"^hps_.+$"}};  // Should be a regex for Kafka.
@@ -193,7 +201,9 @@ struct VolatileDatabaseParams {
       DatabaseType_t type,
       // Backend specific.
       const std::string& address, const std::string& user_name, const std::string& password,
-      size_t num_partitions, size_t allocation_rate, size_t shared_memory_size,
+      size_t num_partitions, size_t allocation_rate, bool numa_aware, size_t hot_key_capacity,
+      size_t hot_key_refresh_interval, size_t compaction_interval_ms,
+      size_t compaction_time_budget_us, double compaction_slack, size_t shared_memory_size,
       const std::string& shared_memory_name, bool shared_memory_auto_remove,
       size_t num_node_connections, size_t max_batch_size, bool enable_tls,
       const std::string& tls_ca_certificate, const std::string& tls_client_certificate,
@@ -203,6 +213,7 @@ struct VolatileDatabaseParams {
       double overflow_resolution_target,
       // Caching behavior related.
       bool initialize_after_startup, double initial_cache_rate, bool cache_missed_embeddings,
+      size_t elevation_admission_threshold, size_t elevation_admission_window,
       // Real-time update mechanism related.
       const std::vector<std::string>& update_filters);
 
@@ -311,6 +322,17 @@ struct InferenceParams {
   bool init_ec;
   bool enable_pagelock;
   bool fp8_quant;
+  // Elastic growth of the worker memory pool (0 = fixed size), and how long lookups wait for a
+  // free worker buffer before giving up (0 = wait indefinitely).
+  int max_number_of_worker_buffers_in_pool;
+  int memory_pool_wait_timeout_ms;
+  // Merge concurrent single-table lookups that arrive within the given delay into one lookup of
+  // at most `lookup_batching_max_keys` keys (0 = max_batchsize * maxnum_catfeature_query).
+  bool enable_lookup_batching;
+  int lookup_batching_delay_us;
+  int lookup_batching_max_keys;
+  // Cache embeddings in host memory if the GPU embedding cache is disabled.
+  bool use_host_embedding_cache;
 
   InferenceParams(const std::string& model_name, size_t max_batchsize, float hit_rate_threshold,
                   const std::string& dense_model_file,
@@ -338,7 +360,11 @@ struct InferenceParams {
                   const EmbeddingCacheType_t embedding_cache_type = EmbeddingCacheType_t::Dynamic,
                   bool use_context_stream = true, bool fuse_embedding_table = false,
                   bool use_hctr_cache_implementation = true, bool init_ec = true,
-                  bool enable_pagelock = false, bool fp8_quant = false);
+                  bool enable_pagelock = false, bool fp8_quant = false,
+                  int max_number_of_worker_buffers_in_pool = 0,
+                  int memory_pool_wait_timeout_ms = 1000, bool enable_lookup_batching = false,
+                  int lookup_batching_delay_us = 100, int lookup_batching_max_keys = 0,
+                  bool use_host_embedding_cache = false);
 };
 
 struct parameter_server_config {
@@ -393,6 +419,29 @@ struct parameter_server_config {
 struct inference_memory_pool_size_config {
   std::map<std::string, int> num_woker_buffer_size_per_model;
   std::map<std::string, int> num_refresh_buffer_size_per_model;
+  std::map<std::string, int> max_num_woker_buffer_size_per_model;
+  std::map<std::string, int> wait_timeout_ms_per_model;
+};
+
+struct MemoryPoolStats {
+  size_t num_blocks{0};   // Currently allocated buffers.
+  size_t max_blocks{0};   // Upper bound for elastic growth.
+  size_t num_in_use{0};   // Buffers currently handed out.
+  size_t peak_in_use{0};  // High watermark of `num_in_use`.
+  size_t num_waiting{0};  // Threads currently queued for a buffer.
+  size_t num_allocs{0};
+  size_t num_waits{0};     // Allocations that had to queue.
+  size_t num_timeouts{0};  // Queued allocations that gave up.
+  size_t num_grows{0};     // Buffers added by elastic growth.
+  double total_wait_ms{0};
+  double max_wait_ms{0};
+
+  inline double occupancy() const {
+    return num_blocks ? static_cast<double>(num_in_use) / static_cast<double>(num_blocks) : 0.0;
+  }
+  inline double mean_wait_ms() const {
+    return num_waits ? total_wait_ms / static_cast<double>(num_waits) : 0.0;
+  }
 };
 
 struct embedding_cache_config {
@@ -404,6 +453,8 @@ struct embedding_cache_config {
   std::string model_name_;        // Which model this cache belongs to
   int cuda_dev_id_;               // Which CUDA device this cache belongs to
   bool use_gpu_embedding_cache_;  // Whether enable GPU embedding cache or not
+  // Whether the host embedding cache is used instead of the GPU embedding cache
+  bool use_host_embedding_cache_ = false;
   // Each vector will have the size of E(# of embedding tables in the model)
   std::vector<size_t> embedding_vec_size_;  // # of float in emb_vec
   std::vector<size_t> num_set_in_cache_;    // # of cache set in the cache
@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <core/macro.hpp>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace HugeCTR {
+
+struct LookupBatcherStats {
+  size_t num_batches{0};
+  size_t num_requests{0};
+  size_t num_keys{0};
+
+  inline double mean_requests_per_batch() const {
+    return num_batches ? static_cast<double>(num_requests) / static_cast<double>(num_batches) : 0.0;
+  }
+  inline double mean_keys_per_batch() const {
+    return num_batches ? static_cast<double>(num_keys) / static_cast<double>(num_batches) : 0.0;
+  }
+};
+
+/**
+ * Merges concurrent lookup requests for the same table into a single lookup.
+ *
+ * Each table is served by a dispatcher thread. Once a request arrives, the dispatcher waits until
+ * either `max_delay` has passed since the arrival of the oldest pending request, or the pending
+ * requests contain at least `max_batch_keys` keys. It then concatenates the keys of as many
+ * requests as fit into `max_batch_keys` (but at least one request), and hands them to the lookup
+ * function in one go. Requests for different tables are batched independently.
+ */
+class LookupBatcher final {
+ public:
+  HCTR_DISALLOW_COPY_AND_MOVE(LookupBatcher);
+
+  /**
+   * Output rows of one request. The rows of all requests in a batch are stored back-to-back in
+   * the order of `slices`.
+   */
+  struct Slice final {
+    float* vectors;
+    size_t num_keys;
+  };
+
+  /**
+   * Looks up the concatenated `keys` of a batch, and writes the results to the `slices`. Once the
+   * function returns, the outputs must be ready. Exceptions are forwarded to all requests in the
+   * batch.
+   */
+  using LookupFunction = std::function<void(size_t table_id, const void* keys, size_t num_keys,
+                                            const std::vector<Slice>& slices)>;
+
+  /**
+   * @param max_batch_keys_per_table Soft limit for the number of keys per batch of each table.
+   * @param key_size Size of a key in bytes.
+   * @param max_delay Maximum time that a request waits for other requests to join its batch.
+   * @param lookup_fn Function that executes the batched lookup.
+   */
+  LookupBatcher(const std::vector<size_t>& max_batch_keys_per_table, size_t key_size,
+                std::chrono::microseconds max_delay, LookupFunction lookup_fn);
+
+  /**
+   * Completes all pending requests, and stops the dispatcher threads.
+   */
+  ~LookupBatcher();
+
+  /**
+   * Enqueues a lookup request. \p keys and \p vectors must stay valid until the returned future
+   * becomes ready.
+   */
+  std::future<void> submit(size_t table_id, const void* keys, size_t num_keys, float* vectors);
+
+  /**
+   * Convenience wrapper for \p submit that blocks until the lookup has finished.
+   */
+  inline void lookup(const size_t table_id, const void* const keys, const size_t num_keys,
+                     float* const vectors) {
+    submit(table_id, keys, num_keys, vectors).get();
+  }
+
+  inline size_t num_tables() const { return tables_.size(); }
+
+  LookupBatcherStats get_stats() const;
+
+ private:
+  struct Request final {
+    const void* keys;
+    size_t num_keys;
+    float* vectors;
+    std::chrono::steady_clock::time_point arrival;
+    std::promise<void> promise;
+  };
+
+  struct Table final {
+    size_t max_batch_keys;
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::deque<Request> pending;
+    size_t num_pending_keys{0};
+    bool stop{false};
+
+    std::thread dispatcher;
+  };
+
+  const size_t key_size_;
+  const std::chrono::microseconds max_delay_;
+  const LookupFunction lookup_fn_;
+  std::vector<std::unique_ptr<Table>> tables_;
+
+  std::atomic<size_t> num_batches_{0};
+  std::atomic<size_t> num_requests_{0};
+  std::atomic<size_t> num_keys_{0};
+
+  void dispatch_(size_t table_id);
+
+  void execute_(size_t table_id, std::vector<Request>& batch, std::vector<char>& key_buffer,
+                std::vector<Slice>& slices);
+};
+
+}  // namespace HugeCTR
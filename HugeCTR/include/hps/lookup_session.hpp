@@ -16,6 +16,7 @@
 #pragma once
 
 #include <chrono>
+#include <hps/lookup_batcher.hpp>
 #include <hps/lookup_session_base.hpp>
 #include <thread_pool.hpp>
 
@@ -59,6 +60,11 @@ class LookupSession : public LookupSessionBase {
   };
   virtual void profiler_print() { ls_profiler_->print(); };
 
+  /**
+   * Statistics of the dynamic lookup batching (all zero if batching is disabled).
+   */
+  LookupBatcherStats get_batching_stats() const;
+
  private:
   std::vector<cudaStream_t> lookup_streams_;
   std::shared_ptr<EmbeddingCacheBase> embedding_cache_;
@@ -80,6 +86,14 @@ class LookupSession : public LookupSessionBase {
 
   ThreadPool table_fusion_thread_pool_;
   const std::chrono::milliseconds wait_duration_{1000};
+
+  // Dynamic batching of concurrent single-table lookups. The rows of batches with several
+  // requests are gathered in a staging buffer before being copied to the requests' outputs.
+  std::unique_ptr<LookupBatcher> lookup_batcher_;
+  std::vector<float*> vec_buffer_for_each_batched_table_;
+
+  void lookup_batch_(size_t table_id, const void* h_keys, size_t num_keys,
+                     const std::vector<LookupBatcher::Slice>& slices);
 };
 
 }  // namespace HugeCTR
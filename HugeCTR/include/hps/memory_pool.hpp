@@ -17,7 +17,12 @@
 
 #include <cuda_runtime_api.h>
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <core23/logger.hpp>
+#include <deque>
 #include <hps/embedding_cache.hpp>
 #include <iostream>
 #include <map>
@@ -34,34 +39,49 @@ class MemoryPool;
 
 class MemoryBlock {
  public:
-  MemoryBlock* pNext;  // next mem block
   EmbeddingCacheWorkspace worker_buffer;
   EmbeddingCacheRefreshspace refresh_buffer;
   bool bUsed;        // occupied
   bool bBelong;      // belong to current pool
   MemoryPool* pMem;  // belong to which pool
+  size_t nIndex;     // position in the pool
   MemoryBlock() {
     this->bBelong = false;
     this->bUsed = false;
     this->pMem = nullptr;
-    this->pNext = nullptr;
+    this->nIndex = 0;
   };
 };
+
+/**
+ * Pool of embedding cache workspaces.
+ *
+ * Free blocks are kept in a lock-free stack, so that uncontended allocations never block. If the
+ * pool is exhausted, it grows up to \p nMaxBlock blocks. Beyond that, callers queue in FIFO order
+ * and freed blocks are handed to the longest waiting caller. A waiting caller gives up after
+ * \p waitTimeout (returns \p nullptr ), or if the pool is destroyed (throws). Destroying the pool
+ * waits until all waiters have left. Callers must keep the pool alive while they allocate.
+ */
 class MemoryPool {
  public:
   MemoryPool(size_t nBlock, std::shared_ptr<EmbeddingCacheBase> embedding_cache,
-             CACHE_SPACE_TYPE cache_type = CACHE_SPACE_TYPE::WORKER) {
-    _nBlock = nBlock;
-    _pHeader = nullptr;
-    _pBuffer = nullptr;
+             CACHE_SPACE_TYPE cache_type = CACHE_SPACE_TYPE::WORKER, size_t nMaxBlock = 0,
+             std::chrono::milliseconds waitTimeout = std::chrono::milliseconds::zero()) {
+    _nBlock = 0;
+    _nMaxBlock = std::min(std::max(nBlock, nMaxBlock), static_cast<size_t>(MAX_MEMORY_SIZE));
+    _waitTimeout = waitTimeout;
     _embedding_cache = embedding_cache;
     _device_id = embedding_cache->get_cache_config().cuda_dev_id_;
     _cache_type = cache_type;
-    InitMemory(cache_type);
+    HCTR_CHECK_HINT(nBlock <= _nMaxBlock, "Memory pool cannot hold more than ", MAX_MEMORY_SIZE,
+                    " buffers.");
+    InitMemory(nBlock, cache_type);
   }
-  static MemoryPool* create(size_t nBlock, std::shared_ptr<EmbeddingCacheBase> embedding_cache,
-                            CACHE_SPACE_TYPE cache_type = CACHE_SPACE_TYPE::WORKER) {
-    return (new MemoryPool(nBlock, embedding_cache, cache_type));
+  static MemoryPool* create(
+      size_t nBlock, std::shared_ptr<EmbeddingCacheBase> embedding_cache,
+      CACHE_SPACE_TYPE cache_type = CACHE_SPACE_TYPE::WORKER, size_t nMaxBlock = 0,
+      std::chrono::milliseconds waitTimeout = std::chrono::milliseconds::zero()) {
+    return (new MemoryPool(nBlock, embedding_cache, cache_type, nMaxBlock, waitTimeout));
   }
   virtual ~MemoryPool() {
     for (size_t i = 0; i < _nBlock; i++) {
@@ -71,68 +91,47 @@ class MemoryPool {
     }
   }
   void* AllocMemory() {
-    std::lock_guard<std::mutex> lock(_mutex);
-    MemoryBlock* pRes = nullptr;
-    if (_pHeader == nullptr) {
-      HCTR_LOG(WARNING, WORLD, "memory pool is empty\n");
-    } else {
-      pRes = _pHeader;
-      _pHeader = _pHeader->pNext;
-      pRes->bUsed = true;
+    // Fast path. Only taken if nobody is queued, so that new callers cannot overtake waiters.
+    if (_nWaiting.load() == 0 && !_bShutdown.load()) {
+      MemoryBlock* pRes = _PopFree();
+      if (pRes != nullptr) {
+        return _Acquire(pRes);
+      }
     }
-    return (void*)(pRes);
+    return _AllocMemorySlow();
   }
 
-  void InitMemory(CACHE_SPACE_TYPE space_type = CACHE_SPACE_TYPE::WORKER) {
+  void InitMemory(size_t nBlock, CACHE_SPACE_TYPE space_type = CACHE_SPACE_TYPE::WORKER) {
+    std::lock_guard<std::mutex> lock(_mutex);
     CudaDeviceContext dev_restorer{_device_id};
-    if (_pBuffer) return;
-    _Alloc[0] = (MemoryBlock*)(new MemoryBlock());
-    _pBuffer = _Alloc[0];
-    _pHeader = _pBuffer;
-    _pHeader->bUsed = false;
-    _pHeader->bBelong = true;
-    if (space_type == CACHE_SPACE_TYPE::WORKER) {
-      EmbeddingCacheWorkspace worker_buffer = _embedding_cache->create_workspace();
-      _pHeader->worker_buffer = (worker_buffer);
-    }
-    if (space_type == CACHE_SPACE_TYPE::REFRESHER) {
-      EmbeddingCacheRefreshspace refresh_buffer = _embedding_cache->create_refreshspace();
-      _pHeader->refresh_buffer = (refresh_buffer);
-    }
-    _pHeader->pMem = this;
-    MemoryBlock* tmp1 = _pHeader;
-    for (size_t i = 1; i < _nBlock; i++) {
-      _Alloc[i] = (MemoryBlock*)(new MemoryBlock());
-      _Alloc[i]->bUsed = false;
-      _Alloc[i]->pNext = NULL;
-      if (space_type == CACHE_SPACE_TYPE::WORKER) {
-        EmbeddingCacheWorkspace worker_buffer = _embedding_cache->create_workspace();
-        _Alloc[i]->worker_buffer = (worker_buffer);
-      }
-      if (space_type == CACHE_SPACE_TYPE::REFRESHER) {
-        EmbeddingCacheRefreshspace refresh_buffer = _embedding_cache->create_refreshspace();
-        _Alloc[i]->refresh_buffer = (refresh_buffer);
-      }
-      _Alloc[i]->bBelong = true;
-      _Alloc[i]->pMem = this;
-      tmp1->pNext = _Alloc[i];
-      tmp1 = _Alloc[i];
+    while (_nBlock < nBlock) {
+      _PushFree(_NewBlock(space_type));
     }
   }
 
   void FreeMemory(void* p) {
-    std::lock_guard<std::mutex> lock(_mutex);
     MemoryBlock* pBlock = (MemoryBlock*)p;
     if (pBlock->bBelong) {
       pBlock->bUsed = false;
-      pBlock->pNext = _pHeader;
-      _pHeader = pBlock;
+      _nInUse--;
+      _PushFree(pBlock);
+      // Must be checked after the push. See `_AllocMemorySlow`.
+      if (_nWaiting.load() > 0) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _DispatchLocked();
+      }
     }
     return;
   }
 
   void DestoryMemoryPool(CACHE_SPACE_TYPE space_type = CACHE_SPACE_TYPE::WORKER) {
-    std::lock_guard<std::mutex> lock(_mutex);
+    std::unique_lock<std::mutex> lock(_mutex);
+    // Release all waiters, and wait until they no longer touch the pool.
+    _bShutdown = true;
+    for (Waiter* waiter : _waiters) {
+      waiter->cv.notify_one();
+    }
+    _waitersLeft.wait(lock, [this]() { return _nWaiting.load() == 0; });
     CudaDeviceContext dev_restorer{_device_id};
     for (size_t i = 0; i < _nBlock; i++) {
       if (_Alloc[i] != NULL) {
@@ -146,15 +145,186 @@ class MemoryPool {
     }
   }
 
+  MemoryPoolStats GetStats() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    MemoryPoolStats stats;
+    stats.num_blocks = _nBlock;
+    stats.max_blocks = _nMaxBlock;
+    stats.num_in_use = _nInUse.load();
+    stats.peak_in_use = _nPeakInUse.load();
+    stats.num_waiting = _nWaiting.load();
+    stats.num_allocs = _nAllocs.load();
+    stats.num_waits = _nWaits;
+    stats.num_timeouts = _nTimeouts;
+    stats.num_grows = _nGrows;
+    stats.total_wait_ms = _totalWaitMs;
+    stats.max_wait_ms = _maxWaitMs;
+    return stats;
+  }
+
+ private:
+  struct Waiter {
+    std::condition_variable cv;
+    MemoryBlock* pBlock = nullptr;
+  };
+
+  MemoryBlock* _NewBlock(CACHE_SPACE_TYPE space_type) {
+    MemoryBlock* pBlock = new MemoryBlock();
+    if (space_type == CACHE_SPACE_TYPE::WORKER) {
+      EmbeddingCacheWorkspace worker_buffer = _embedding_cache->create_workspace();
+      pBlock->worker_buffer = (worker_buffer);
+    }
+    if (space_type == CACHE_SPACE_TYPE::REFRESHER) {
+      EmbeddingCacheRefreshspace refresh_buffer = _embedding_cache->create_refreshspace();
+      pBlock->refresh_buffer = (refresh_buffer);
+    }
+    pBlock->bBelong = true;
+    pBlock->pMem = this;
+    pBlock->nIndex = _nBlock;
+    _Alloc[_nBlock++] = pBlock;
+    return pBlock;
+  }
+
+  // Treiber stack of block indices. The upper 32 bits of the head are a modification counter that
+  // prevents ABA problems.
+  MemoryBlock* _PopFree() {
+    uint64_t head = _freeHead.load();
+    while (true) {
+      const uint32_t idx = static_cast<uint32_t>(head);
+      if (idx == 0) {
+        return nullptr;
+      }
+      const uint64_t next = _freeNext[idx - 1].load(std::memory_order_relaxed);
+      if (_freeHead.compare_exchange_weak(head, (((head >> 32) + 1) << 32) | next)) {
+        return _Alloc[idx - 1];
+      }
+    }
+  }
+
+  void _PushFree(MemoryBlock* pBlock) {
+    const uint64_t idx = pBlock->nIndex + 1;
+    uint64_t head = _freeHead.load();
+    do {
+      _freeNext[idx - 1].store(static_cast<uint32_t>(head), std::memory_order_relaxed);
+    } while (!_freeHead.compare_exchange_weak(head, (((head >> 32) + 1) << 32) | idx));
+  }
+
+  void* _Acquire(MemoryBlock* pBlock) {
+    pBlock->bUsed = true;
+    _nAllocs++;
+    const size_t nInUse = ++_nInUse;
+    size_t nPeak = _nPeakInUse.load();
+    while (nPeak < nInUse && !_nPeakInUse.compare_exchange_weak(nPeak, nInUse)) {
+    }
+    return (void*)(pBlock);
+  }
+
+  // Hands free blocks to waiters in FIFO order.
+  void _DispatchLocked() {
+    while (!_waiters.empty()) {
+      MemoryBlock* pBlock = _PopFree();
+      if (pBlock == nullptr) {
+        break;
+      }
+      Waiter* waiter = _waiters.front();
+      _waiters.pop_front();
+      waiter->pBlock = pBlock;
+      waiter->cv.notify_one();
+    }
+  }
+
+  void* _AllocMemorySlow() {
+    std::unique_lock<std::mutex> lock(_mutex);
+    if (_bShutdown) {
+      HCTR_OWN_THROW(Error_t::IllegalCall, "Memory pool has been destroyed.");
+    }
+    if (_waiters.empty()) {
+      MemoryBlock* pRes = _PopFree();
+      if (pRes != nullptr) {
+        return _Acquire(pRes);
+      }
+    }
+
+    // Overload degrades into queueing only once the pool has reached its size limit.
+    if (_nBlock < _nMaxBlock) {
+      CudaDeviceContext dev_restorer{_device_id};
+      MemoryBlock* pRes = _NewBlock(_cache_type);
+      _nGrows++;
+      HCTR_LOG_S(INFO, WORLD) << "Memory pool on device " << _device_id << " grew to " << _nBlock
+                              << " / " << _nMaxBlock << " buffers." << std::endl;
+      return _Acquire(pRes);
+    }
+
+    // Queue up. The counter is raised before the free list is checked again, while `FreeMemory`
+    // pushes before checking the counter. Hence, a concurrently freed block cannot be missed.
+    Waiter waiter;
+    _waiters.push_back(&waiter);
+    _nWaiting++;
+    _nWaits++;
+    _DispatchLocked();
+
+    const auto t0 = std::chrono::steady_clock::now();
+    const auto ready = [&]() { return waiter.pBlock != nullptr || _bShutdown; };
+    if (_waitTimeout.count() > 0) {
+      waiter.cv.wait_for(lock, _waitTimeout, ready);
+    } else {
+      waiter.cv.wait(lock, ready);
+    }
+    const double waitMs =
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    _totalWaitMs += waitMs;
+    _maxWaitMs = std::max(_maxWaitMs, waitMs);
+
+    if (waiter.pBlock == nullptr) {
+      _waiters.erase(std::find(_waiters.begin(), _waiters.end(), &waiter));
+    }
+    // Waiters are counted until they are done with the pool, so that `DestoryMemoryPool` can wait
+    // for them. The lock is held until this call returns.
+    _nWaiting--;
+    if (_bShutdown) {
+      // A block that was handed over is dropped with the pool.
+      _waitersLeft.notify_all();
+      HCTR_OWN_THROW(Error_t::IllegalCall, "Memory pool has been destroyed.");
+    }
+    if (waiter.pBlock != nullptr) {
+      return _Acquire(waiter.pBlock);
+    }
+    _nTimeouts++;
+    HCTR_LOG_S(WARNING, WORLD) << "No free buffer in memory pool on device " << _device_id
+                               << " after " << waitMs << " ms (" << _nBlock << " buffers, "
+                               << _waiters.size() << " waiting)." << std::endl;
+    return nullptr;
+  }
+
  public:
-  MemoryBlock* _pBuffer;
-  MemoryBlock* _pHeader;
   std::shared_ptr<EmbeddingCacheBase> _embedding_cache;
   int _device_id;
   size_t _nBlock;
+  size_t _nMaxBlock;
+  std::chrono::milliseconds _waitTimeout;
   std::mutex _mutex;
-  MemoryBlock* _Alloc[MAX_MEMORY_SIZE];
+  MemoryBlock* _Alloc[MAX_MEMORY_SIZE] = {};
   CACHE_SPACE_TYPE _cache_type;
+
+ private:
+  std::atomic<uint64_t> _freeHead{0};  // (counter << 32) | (index + 1), or 0 if empty.
+  std::atomic<uint32_t> _freeNext[MAX_MEMORY_SIZE] = {};
+
+  // Wait queue. Guarded by `_mutex`.
+  std::deque<Waiter*> _waiters;
+  std::atomic<size_t> _nWaiting{0};  // Queued callers, until they return.
+  std::atomic<bool> _bShutdown{false};
+  std::condition_variable _waitersLeft;
+
+  // Metrics.
+  std::atomic<size_t> _nInUse{0};
+  std::atomic<size_t> _nPeakInUse{0};
+  std::atomic<size_t> _nAllocs{0};
+  size_t _nWaits = 0;
+  size_t _nTimeouts = 0;
+  size_t _nGrows = 0;
+  double _totalWaitMs = 0;
+  double _maxWaitMs = 0;
 };
 
 class ManagerPool {
@@ -166,7 +336,9 @@ class ManagerPool {
       auto device_pool_map = _model_pool_map.find(model_name);
       auto cache = device_pool_map->second.find(device_id);
       if (cache != device_pool_map->second.end()) {
-        return cache->second->AllocMemory();
+        // Keeps the pool alive if it is destroyed while this call waits for a block.
+        const std::shared_ptr<MemoryPool> pool = cache->second;
+        return pool->AllocMemory();
       }
     }
     if (space_type == CACHE_SPACE_TYPE::REFRESHER &&
@@ -174,12 +346,28 @@ class ManagerPool {
       auto device_pool_map = _model_refresh_pool_map.find(model_name);
       auto cache = device_pool_map->second.find(device_id);
       if (cache != device_pool_map->second.end()) {
-        return cache->second->AllocMemory();
+        // Keeps the pool alive if it is destroyed while this call waits for a block.
+        const std::shared_ptr<MemoryPool> pool = cache->second;
+        return pool->AllocMemory();
       }
     }
     return NULL;
   }
 
+  MemoryPoolStats GetStats(const std::string& model_name, int device_id,
+                           CACHE_SPACE_TYPE space_type = CACHE_SPACE_TYPE::WORKER) {
+    const auto& pool_map =
+        space_type == CACHE_SPACE_TYPE::WORKER ? _model_pool_map : _model_refresh_pool_map;
+    const auto device_pool_map = pool_map.find(model_name);
+    if (device_pool_map != pool_map.end()) {
+      const auto pool = device_pool_map->second.find(device_id);
+      if (pool != device_pool_map->second.end()) {
+        return pool->second->GetStats();
+      }
+    }
+    return {};
+  }
+
   void FreeBuffer(void* p) {
     MemoryBlock* pBlock = (MemoryBlock*)((char*)p);
     if (pBlock->bBelong) {
@@ -245,10 +433,12 @@ class ManagerPool {
   void _create_memory_pool_per_model(
       std::string model_name, int pool_size,
       std::map<int64_t, std::shared_ptr<EmbeddingCacheBase>> embedding_cache_map,
-      CACHE_SPACE_TYPE space_type) {
+      CACHE_SPACE_TYPE space_type, int max_pool_size = 0, int wait_timeout_ms = 0) {
     std::map<int64_t, std::shared_ptr<MemoryPool>> device_mempool;
     for (auto& f : embedding_cache_map) {
-      MemoryPool* tempmemorypool = MemoryPool::create(pool_size, f.second, space_type);
+      MemoryPool* tempmemorypool =
+          MemoryPool::create(pool_size, f.second, space_type, std::max(max_pool_size, 0),
+                             std::chrono::milliseconds(std::max(wait_timeout_ms, 0)));
       device_mempool[f.first] = std::shared_ptr<MemoryPool>(tempmemorypool);
     }
     if (space_type == CACHE_SPACE_TYPE::WORKER) {
@@ -265,9 +455,16 @@ class ManagerPool {
     std::map<std::string, std::map<int64_t, std::shared_ptr<EmbeddingCacheBase>>>::iterator iter;
     for (iter = _model_cache_map.begin(); iter != _model_cache_map.end(); ++iter) {
       std::map<int64_t, std::shared_ptr<MemoryPool>> device_mempool;
+      // Only worker pools grow. Refresh buffers are not on the lookup path.
+      const int max_pool_size =
+          space_type == CACHE_SPACE_TYPE::WORKER
+              ? _memory_pool_config.max_num_woker_buffer_size_per_model[iter->first]
+              : 0;
+      const int wait_timeout_ms = _memory_pool_config.wait_timeout_ms_per_model[iter->first];
       for (auto& f : iter->second) {
-        MemoryPool* tempmemorypool =
-            MemoryPool::create(num_cache_per_model[iter->first], f.second, space_type);
+        MemoryPool* tempmemorypool = MemoryPool::create(
+            num_cache_per_model[iter->first], f.second, space_type, std::max(max_pool_size, 0),
+            std::chrono::milliseconds(std::max(wait_timeout_ms, 0)));
         device_mempool[f.first] = std::shared_ptr<MemoryPool>(tempmemorypool);
       }
       (*model_cache_pool_map)[iter->first] = device_mempool;
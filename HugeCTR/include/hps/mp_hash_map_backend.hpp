@@ -150,6 +150,10 @@ class MultiProcessHashMapBackend final
           value_pages(segment.get_allocator<ValuePage>()),
           value_slots(segment.get_allocator<ValuePtr>()),
           entries(segment.get_allocator<Entry>()) {}
+
+    // Pages are never compacted, so their use is not tracked.
+    void on_store(const ValuePtr) {}
+    bool on_erase(const ValuePtr) { return true; }
   };
 
   struct SharedMemory final {
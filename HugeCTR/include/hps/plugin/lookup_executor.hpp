@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <condition_variable>
+#include <core/macro.hpp>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+namespace HierarchicalParameterServer {
+
+struct LookupExecutorParams {
+  size_t num_workers{0};              // Number of worker threads (0 = hardware concurrency).
+  size_t max_inflight_per_device{0};  // Dispatches that may run on one device (0 = no limit).
+  size_t max_inflight_per_table{0};   // Dispatches that may run for one table (0 = no limit).
+  size_t max_coalesced_tasks{8};      // Maximum number of tasks that a worker takes at once.
+
+  /**
+   * Reads the parameters from the environment (HPS_LOOKUP_WORKERS,
+   * HPS_LOOKUP_MAX_INFLIGHT_PER_DEVICE, HPS_LOOKUP_MAX_INFLIGHT_PER_TABLE and
+   * HPS_LOOKUP_MAX_COALESCED_TASKS). Unset variables keep their default.
+   */
+  static LookupExecutorParams from_env();
+};
+
+struct LookupExecutorStats {
+  size_t num_tasks{0};
+  size_t num_dispatches{0};  // Groups of tasks that were taken by a worker at once.
+  size_t num_pending{0};     // Tasks currently queued.
+  size_t peak_pending{0};
+  size_t peak_inflight{0};  // Maximum number of concurrently running dispatches.
+
+  inline double mean_tasks_per_dispatch() const {
+    return num_dispatches ? static_cast<double>(num_tasks) / static_cast<double>(num_dispatches)
+                          : 0.0;
+  }
+};
+
+/**
+ * Executes embedding lookups of the framework plugins asynchronously on a shared pool of workers.
+ *
+ * Tasks are queued per (model, table, device). Workers serve the queues round-robin, so that a
+ * burst of requests for one table cannot starve the others. The number of dispatches that run
+ * concurrently can be bounded per device and per table. If a queue is backed up, a worker takes
+ * several of its tasks at once and runs them back-to-back ("coalescing"), which saves wake-ups and
+ * keeps consecutive lookups of a table on the same thread.
+ */
+class LookupExecutor final {
+ public:
+  HCTR_DISALLOW_COPY_AND_MOVE(LookupExecutor);
+
+  using Task = std::function<void()>;
+
+  explicit LookupExecutor(const LookupExecutorParams& params);
+
+  /**
+   * Completes all queued tasks, and stops the workers.
+   */
+  ~LookupExecutor();
+
+  /**
+   * Enqueues a task. Errors have to be reported through the task's own completion mechanism
+   * (e.g., the status of the TensorFlow op). Exceptions that escape a task are only logged.
+   */
+  void submit(const std::string& model_name, int table_id, int device_id, Task task);
+
+  inline size_t num_workers() const { return num_workers_; }
+
+  LookupExecutorStats get_stats() const;
+
+  /**
+   * Process-wide executor that is shared by all ops. Configured via \p LookupExecutorParams
+   * ::from_env upon first use.
+   */
+  static LookupExecutor& shared();
+
+ private:
+  using QueueKey = std::tuple<std::string, int, int>;
+
+  struct Queue final {
+    int device_id;
+    std::deque<Task> tasks;
+    size_t num_inflight{0};
+  };
+
+  const LookupExecutorParams params_;
+  const size_t num_workers_;
+  std::vector<std::thread> workers_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable cv_;
+  std::map<QueueKey, std::unique_ptr<Queue>> queues_;
+  std::vector<Queue*> queue_list_;  // Round-robin order.
+  size_t next_queue_{0};
+  std::map<int, size_t> num_inflight_per_device_;
+  size_t num_inflight_{0};
+  bool stop_{false};
+  LookupExecutorStats stats_;
+
+  void run_();
+
+  Queue* pick_();
+};
+
+}  // namespace HierarchicalParameterServer
@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <core/macro.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace HugeCTR {
+namespace unique_op {
+
+/**
+ * Host counterpart of \p unique_op for lookups that bypass the GPU embedding cache. Removes
+ * duplicate keys from a batch, so that each distinct key is only fetched once, and afterwards
+ * expands the fetched rows back to the original key order.
+ *
+ * The hash set is sized to the batch and reused across batches (slots are invalidated by bumping
+ * an epoch counter instead of clearing them). Instances are not thread-safe. The intended usage is
+ * one instance per thread.
+ *
+ * @tparam KeyType The data-type that is used for keys.
+ */
+template <typename KeyType>
+class CpuUniqueOp final {
+ public:
+  HCTR_DISALLOW_COPY_AND_MOVE(CpuUniqueOp);
+
+  CpuUniqueOp() = default;
+
+  /**
+   * Deduplicates \p keys . Distinct keys are written to \p unique_keys in order of their first
+   * occurrence. \p unique_keys may alias \p keys .
+   *
+   * @return Number of distinct keys.
+   */
+  size_t unique(const KeyType* keys, size_t num_keys, KeyType* unique_keys);
+
+  /**
+   * Expands \p values in-place from one row per distinct key (as returned by the last call of
+   * \p unique ) to one row per input key. \p values must be large enough to hold all rows.
+   */
+  void expand(float* values, size_t value_size) const;
+
+  inline size_t num_keys() const { return indices_.size(); }
+
+  inline size_t num_unique() const { return num_unique_; }
+
+  /**
+   * @return Fraction of keys in the last batch that were duplicates.
+   */
+  inline double dedup_ratio() const {
+    return indices_.empty() ? 0.0
+                            : 1.0 - static_cast<double>(num_unique_) /
+                                        static_cast<double>(indices_.size());
+  }
+
+ private:
+  struct Slot final {
+    KeyType key;
+    uint32_t epoch;
+    uint32_t index;
+  };
+
+  std::vector<Slot> slots_;
+  size_t shift_{64};
+  uint32_t epoch_{0};
+
+  std::vector<uint32_t> indices_;  // Index of the distinct key for each input key.
+  size_t num_unique_{0};
+
+  void reserve_(size_t num_keys);
+};
+
+}  // namespace unique_op
+}  // namespace HugeCTR
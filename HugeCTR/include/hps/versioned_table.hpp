@@ -0,0 +1,148 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <condition_variable>
+#include <core/macro.hpp>
+#include <hps/database_backend.hpp>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace HugeCTR {
+
+/**
+ * Adds versioning to a table in a \p DatabaseBackendBase, so that a model can be updated without
+ * downtime and without exposing readers to a half-updated table.
+ *
+ * Updates are staged into a delta table that only holds the rows that changed (copy-on-write at
+ * row granularity). Unchanged rows are shared with the base table. \p publish atomically switches
+ * readers to the new version. Readers \p pin a version for the duration of a lookup, and resolve
+ * keys through the delta table first and the base table second. Once all readers of the previous
+ * version have drained, \p reclaim folds the delta into the base table and drops it. Hence, the
+ * memory overhead of a version is proportional to the number of changed rows.
+ *
+ * At most one published delta exists at any time. Staging the next version first reclaims the
+ * previous one (which may block until its readers drain).
+ *
+ * If the table is cached from a lower database tier, merged rows are also written through to that
+ * tier. Otherwise, readers would fall back to outdated rows once the merged rows are evicted.
+ *
+ * @tparam Key The data-type that is used for keys in this database.
+ */
+template <typename Key>
+class VersionedTable final {
+ public:
+  struct Version final {
+    uint64_t id;
+    std::string delta_table_name;  // Empty if this version is fully merged into the base table.
+  };
+
+  HCTR_DISALLOW_COPY_AND_MOVE(VersionedTable);
+
+  VersionedTable() = delete;
+
+  /**
+   * @param db Backend that holds the base table. Must outlive this object.
+   * @param table_name Name of the base table (see also HierParameterServerBase::make_tag_name).
+   * @param write_through_db Optional backend that receives a copy of all merged rows. Must outlive
+   * this object.
+   */
+  VersionedTable(DatabaseBackendBase<Key>& db, const std::string& table_name,
+                 DatabaseBackendBase<Key>* write_through_db = nullptr);
+
+  ~VersionedTable();
+
+  inline const std::string& table_name() const { return table_name_; }
+
+  /**
+   * @return The currently published version. Holding on to the returned pointer keeps the version
+   * alive (i.e., prevents it from being reclaimed).
+   */
+  std::shared_ptr<const Version> pin() const;
+
+  /**
+   * Stage an update for the next version. Invisible to readers until \p publish is called.
+   *
+   * @return Number of rows staged so far for the next version.
+   */
+  size_t stage(size_t num_pairs, const Key* keys, const char* values, uint32_t value_size,
+               size_t value_stride);
+
+  /**
+   * @return Number of rows currently staged for the next version.
+   */
+  size_t num_staged() const;
+
+  /**
+   * Atomically makes the staged rows visible to all subsequent lookups. Throws and discards the
+   * staged rows if some of them were lost in the meantime (e.g., evicted by an overflow policy).
+   *
+   * @param published_keys If not null, receives the (unique) keys of the rows that changed.
+   *
+   * @return Id of the published version (unchanged if nothing was staged).
+   */
+  uint64_t publish(std::vector<Key>* published_keys = nullptr);
+
+  /**
+   * Waits for readers of retired versions to drain. Then folds the published delta into the base
+   * table and drops it.
+   *
+   * @return Number of rows that were merged into the base table.
+   */
+  size_t reclaim();
+
+  /**
+   * Like \p DatabaseBackendBase::fetch, but resolves \p keys against the current version.
+   */
+  size_t fetch(
+      size_t num_keys, const Key* keys, char* values, size_t value_stride,
+      const DatabaseMissCallback& on_miss,
+      const std::chrono::nanoseconds& time_budget = std::chrono::nanoseconds::zero()) const;
+
+ private:
+  DatabaseBackendBase<Key>& db_;
+  const std::string table_name_;
+  DatabaseBackendBase<Key>* const write_through_db_;
+
+  std::shared_ptr<const Version> current_;  // Only access through std::atomic_load/store.
+
+  // Signaled whenever a reader releases a pinned version. Shared with the pins.
+  struct DrainSignal final {
+    std::mutex mutex;
+    std::condition_variable released;
+  };
+  const std::shared_ptr<DrainSignal> drain_{std::make_shared<DrainSignal>()};
+
+  // Writer state. Serialized by `writer_guard_`.
+  mutable std::mutex writer_guard_;
+  uint64_t next_id_{1};
+  std::shared_ptr<const Version> retired_;  // Previous version, until its readers drain.
+  std::vector<Key> staged_keys_;            // Rows changed by the staged version.
+  std::vector<Key> published_keys_;         // Rows changed by the published delta.
+  uint32_t value_size_{0};
+
+  std::string make_delta_table_name_(uint64_t id) const;
+
+  void await_drain_(const std::shared_ptr<const Version>& version) const;
+
+  size_t reclaim_();
+
+  size_t merge_(const Version& version);
+};
+
+}  // namespace HugeCTR
@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <core/macro.hpp>
+#include <inference/cpu_gemm.hpp>
+#include <memory>
+#include <nlohmann/json.hpp>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace HugeCTR {
+
+class CpuLayer;
+struct CpuTensor;
+
+struct CpuDenseNetworkParams {
+  size_t max_batch_size{256};  // Larger batches are processed in several passes.
+  size_t num_threads{1};
+  bool bf16_weights{false};  // Store GEMM weights as bfloat16. Activations stay in fp32.
+  CpuIsa isa{cpu_isa()};
+};
+
+/**
+ * @brief Runs the dense part of a trained model on the CPU, for inference.
+ *
+ * The network is built from the same graph JSON as the GPU model (`Model.graph_to_json`), and the
+ * weights are read from the dense model file written by `Model.save_params_to_files`, in which the
+ * weights of all trainable layers are stored back to back in layer order.
+ *
+ * Supported layers are InnerProduct, MLP, MultiCross (DCN v1 and v2), Interaction, ReLU, Sigmoid,
+ * Concat, Reshape, Slice, Add, ElementwiseMultiply, and Dropout and Cast, which are no-ops. A
+ * BinaryCrossEntropyLoss is replaced by a Sigmoid, so that the output is the prediction. ReLUs that
+ * directly follow an InnerProduct are fused into its GEMM.
+ *
+ * The embedding layers are inputs. For each of them, `predict` takes the combined embedding
+ * vectors of all slots of a sample, for instance as looked up by the HPS.
+ */
+class CpuDenseNetwork final {
+ public:
+  CpuDenseNetwork(const std::string& graph_config_file, const std::string& dense_model_file,
+                  const CpuDenseNetworkParams& params);
+
+  CpuDenseNetwork(const nlohmann::json& graph_config, const std::vector<float>& dense_model,
+                  const CpuDenseNetworkParams& params);
+
+  ~CpuDenseNetwork();
+
+  HCTR_DISALLOW_COPY_AND_MOVE(CpuDenseNetwork);
+
+  inline size_t dense_dim() const { return dense_dim_; }
+
+  /**
+   * @return Names of the embedding layers, in the order that `predict` expects their vectors.
+   */
+  inline const std::vector<std::string>& embedding_names() const { return embedding_names_; }
+
+  /**
+   * @return Number of values per sample (slots times vector size) of each embedding layer.
+   */
+  inline const std::vector<size_t>& embedding_dims() const { return embedding_dims_; }
+
+  inline size_t output_dim() const { return output_dim_; }
+
+  /**
+   * @param dense \p batch_size x `dense_dim()` dense features.
+   * @param embeddings For each embedding layer, \p batch_size x `embedding_dims()[i]` values.
+   * @param output \p batch_size x `output_dim()` predictions.
+   */
+  void predict(const float* dense, const std::vector<const float*>& embeddings, size_t batch_size,
+               float* output);
+
+ private:
+  const CpuDenseNetworkParams params_;
+  std::vector<std::unique_ptr<CpuTensor>> tensors_;
+  std::unordered_map<std::string, CpuTensor*> tensor_map_;
+  std::vector<std::unique_ptr<CpuLayer>> layers_;
+
+  size_t dense_dim_{0};
+  CpuTensor* dense_{nullptr};
+  std::vector<std::string> embedding_names_;
+  std::vector<size_t> embedding_dims_;
+  std::vector<CpuTensor*> embeddings_;
+  size_t output_dim_{0};
+  CpuTensor* output_{nullptr};
+
+  /**
+   * Adds a tensor for \p max_batch_size samples of shape \p dims , or a view of \p alias .
+   */
+  CpuTensor* add_tensor_(const std::string& name, const std::vector<int64_t>& dims,
+                         const CpuTensor* alias = nullptr);
+
+  CpuTensor* get_tensor_(const std::string& name) const;
+
+  void build_(const nlohmann::json& graph_config, const std::vector<float>& dense_model);
+};
+
+}  // namespace HugeCTR
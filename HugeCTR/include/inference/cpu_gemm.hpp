@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace HugeCTR {
+
+/**
+ * Instruction sets of the CPU GEMM kernels, in ascending order.
+ */
+enum class CpuIsa { Scalar, AVX2, AVX512 };
+
+/**
+ * @return The best instruction set supported by this CPU.
+ */
+CpuIsa cpu_isa();
+
+const char* cpu_isa_name(CpuIsa isa);
+
+/**
+ * Converts to bfloat16 with round-to-nearest-even.
+ */
+uint16_t float_to_bf16(float value);
+
+float bf16_to_float(uint16_t value);
+
+/**
+ * @brief Right-hand side (weights) of `cpu_gemm`, packed once into panels of `panel_width`
+ * columns.
+ *
+ * Within a panel, the `panel_width` values of each row are contiguous, so that the kernels stream
+ * through the panel with aligned vector loads. The last panel is zero-padded. With \p bf16 , the
+ * values are stored as bfloat16 and widened to fp32 in the kernels, which halves the memory
+ * traffic of the weights. Accumulation is always in fp32.
+ */
+class CpuPackedMatrix final {
+ public:
+  static constexpr int64_t panel_width{16};
+
+  CpuPackedMatrix() = default;
+
+  /**
+   * @param b Row-major matrix with \p rows rows and \p cols columns.
+   */
+  CpuPackedMatrix(const float* b, int64_t rows, int64_t cols, bool bf16);
+
+  inline int64_t rows() const { return rows_; }
+  inline int64_t cols() const { return cols_; }
+  inline bool bf16() const { return bf16_; }
+  inline int64_t num_panels() const { return (cols_ + panel_width - 1) / panel_width; }
+
+  inline const float* f32_panel(int64_t panel) const {
+    return &f32_[panel * rows_ * panel_width];
+  }
+  inline const uint16_t* bf16_panel(int64_t panel) const {
+    return &bf16_data_[panel * rows_ * panel_width];
+  }
+
+ private:
+  int64_t rows_{0};
+  int64_t cols_{0};
+  bool bf16_{false};
+  std::vector<float> f32_;
+  std::vector<uint16_t> bf16_data_;
+};
+
+/**
+ * Computes `c = a * b + bias`, and applies ReLU if \p relu is set.
+ *
+ * The work is split into tiles of rows and panels, which are distributed over \p num_threads
+ * OpenMP threads. Within a tile, the shared dimension is processed in blocks, so that the slice of
+ * the panel stays in the L1 cache while the kernel passes over the rows of the tile.
+ *
+ * @param a Row-major matrix with \p m rows and `b.rows()` columns.
+ * @param bias `b.cols()` values, or nullptr.
+ * @param c Row-major matrix with \p m rows and `b.cols()` columns.
+ * @param isa Must not exceed `cpu_isa()`.
+ */
+void cpu_gemm(const float* a, int64_t m, const CpuPackedMatrix& b, const float* bias, bool relu,
+              float* c, size_t num_threads, CpuIsa isa);
+
+}  // namespace HugeCTR
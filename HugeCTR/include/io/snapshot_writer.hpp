@@ -0,0 +1,217 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <core/macro.hpp>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <io/filesystem.hpp>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace HugeCTR {
+
+/**
+ * @brief Host-side copy of the files that make up one snapshot.
+ *
+ * Consecutive writes to the same file are concatenated. The file buffers are kept when the
+ * snapshot buffer is cleared, so that subsequent snapshots of the same model do not have to
+ * allocate (and page in) host memory again.
+ */
+class SnapshotBuffer final {
+ public:
+  struct File {
+    std::string path;
+    bool append;  // Append to the existing file instead of replacing it.
+    std::vector<char> data;
+  };
+
+  void create_dir(const std::string& path);
+
+  void write(const std::string& path, const void* data, size_t data_size, bool overwrite);
+
+  /**
+   * @return The staged file, or \p nullptr if nothing was written to \p path.
+   */
+  const File* find(const std::string& path) const;
+
+  inline size_t num_files() const { return num_files_; }
+
+  inline const File& file(const size_t index) const { return files_[index]; }
+
+  inline const std::vector<std::string>& dirs() const { return dirs_; }
+
+  size_t size_in_bytes() const;
+
+  void clear();
+
+ private:
+  std::vector<std::string> dirs_;
+  std::vector<File> files_;
+  size_t num_files_{0};
+};
+
+/**
+ * @brief File system that stages all writes in a \p SnapshotBuffer instead of performing them.
+ *
+ * Only the operations that are needed to dump a model are supported. Reading is limited to files
+ * that have been staged.
+ */
+class StagingFileSystem final : public FileSystem {
+ public:
+  explicit StagingFileSystem(SnapshotBuffer& buffer);
+
+  size_t get_file_size(const std::string& path) const override;
+
+  void create_dir(const std::string& path) override;
+
+  void delete_file(const std::string& path) override;
+
+  void fetch(const std::string& source_path, const std::string& target_path) override;
+
+  void upload(const std::string& source_path, const std::string& target_path) override;
+
+  int write(const std::string& path, const void* data, size_t data_size, bool overwrite) override;
+
+  int read(const std::string& path, void* buffer, size_t buffer_size, size_t offset) override;
+
+  void copy(const std::string& source_file, const std::string& target_file) override;
+
+  void batch_fetch(const std::string& source_dir, const std::string& target_dir) override;
+
+  void batch_upload(const std::string& source_dir, const std::string& target_dir) override;
+
+ private:
+  SnapshotBuffer& buffer_;
+};
+
+struct SnapshotWriterParams {
+  size_t num_buffers{2};               // Snapshots that can be staged or written at once.
+  size_t num_threads{2};               // Threads that write files concurrently.
+  size_t chunk_size{8 * 1024 * 1024};  // Bytes per write call for local files.
+  bool sync{true};                     // Flush local files to the disk before renaming them.
+
+  /**
+   * Optional compression. If set, each replaced file is passed through this function, and the
+   * result is written to the file's path plus \p compressed_suffix. Appended files are written
+   * uncompressed.
+   */
+  std::function<void(const char* data, size_t data_size, std::vector<char>& out)> compress;
+  std::string compressed_suffix;
+};
+
+struct SnapshotWriterStats {
+  size_t num_snapshots{0};
+  size_t num_files{0};
+  size_t num_bytes{0};  // Bytes written (after compression).
+  size_t num_errors{0};
+  // Time between submitting a snapshot and its last file being written.
+  double write_time_s{0};
+  // Time that callers of \p acquire waited for a free buffer.
+  double stall_time_s{0};
+};
+
+/**
+ * @brief Writes staged snapshots to their destination in the background.
+ *
+ * The caller acquires a free buffer, stages a snapshot into it (usually by passing a
+ * \p StagingFileSystem to the dump routines), and submits it. It can then resume immediately,
+ * while a pool of threads writes the files. Local files are written sequentially in large chunks
+ * to a temporary file, which is then atomically renamed to its final path. Hence, readers never
+ * observe partially written files. Remote files are written through their \p FileSystem.
+ *
+ * If all buffers are busy, \p acquire blocks until the oldest snapshot has been written. Errors
+ * are logged, and are rethrown by the next \p wait call.
+ */
+class SnapshotWriter final {
+ public:
+  HCTR_DISALLOW_COPY_AND_MOVE(SnapshotWriter);
+
+  explicit SnapshotWriter(const SnapshotWriterParams& params);
+
+  /**
+   * Completes all submitted snapshots.
+   */
+  ~SnapshotWriter();
+
+  /**
+   * @return An empty buffer.
+   */
+  SnapshotBuffer& acquire();
+
+  /**
+   * Starts writing the snapshot that was staged in \p buffer. The buffer is returned to the pool
+   * once all of its files have been written.
+   */
+  void submit(SnapshotBuffer& buffer);
+
+  /**
+   * Returns \p buffer to the pool without writing it.
+   */
+  void discard(SnapshotBuffer& buffer);
+
+  /**
+   * Blocks until all submitted snapshots have been written, and rethrows the first error that
+   * occurred since the last call.
+   */
+  void wait();
+
+  SnapshotWriterStats get_stats() const;
+
+ private:
+  enum class BufferState { Free, Staging, Writing };
+
+  struct Slot final {
+    SnapshotBuffer buffer;
+    BufferState state{BufferState::Free};
+    size_t num_pending_files{0};
+    std::chrono::steady_clock::time_point submit_time;
+  };
+
+  struct Job final {
+    Slot* slot;
+    size_t file_index;
+  };
+
+  const SnapshotWriterParams params_;
+  std::vector<std::unique_ptr<Slot>> slots_;
+  std::vector<std::thread> threads_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable job_cv_;
+  std::condition_variable slot_cv_;
+  std::deque<Job> jobs_;
+  bool stop_{false};
+  std::exception_ptr error_;
+  SnapshotWriterStats stats_;
+
+  Slot& find_slot_(const SnapshotBuffer& buffer);
+
+  void run_();
+
+  size_t write_file_(const SnapshotBuffer::File& file, std::vector<char>& compressed) const;
+
+  void write_local_file_(const std::string& path, const char* data, size_t data_size,
+                         bool append) const;
+};
+
+}  // namespace HugeCTR
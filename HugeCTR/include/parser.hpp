@@ -94,6 +94,8 @@ struct Solver {
   size_t num_iterations_statistics;
   bool perf_logging;
   bool drop_incomplete_batch;
+  bool async_snapshot{false};
+  size_t num_snapshot_threads{2};
   std::string kafka_brokers;
   DataSourceParams data_source_params;
   std::vector<std::shared_ptr<TrainingCallback>> training_callbacks;
@@ -50,6 +50,7 @@ class HPS {
                                   size_t table_id, int64_t device_id);
   void lookup_fromdlpack(pybind11::capsule& keys, pybind11::capsule& out_tensor,
                          const std::string& model_name, size_t table_id, int64_t device_id);
+  std::vector<HPSTableStats> get_stats(const std::string& model_name);
 
  private:
   void initialize();
@@ -273,6 +274,10 @@ pybind11::array_t<float> HPS::lookup(pybind11::array_t<size_t>& h_keys,
   return h_vectors;
 }
 
+std::vector<HPSTableStats> HPS::get_stats(const std::string& model_name) {
+  return parameter_server_->get_stats(model_name);
+}
+
 void HPSPybind(pybind11::module& m) {
   pybind11::module infer = m.def_submodule("inference", "inference submodule of hugectr");
 
@@ -283,12 +288,13 @@ void HPSPybind(pybind11::module& m) {
           pybind11::init<DatabaseType_t,
                          // Backend specific.
                          const std::string&, const std::string&, const std::string&, size_t, size_t,
-                         size_t, const std::string&, bool, size_t, size_t, bool, const std::string&,
-                         const std::string&, const std::string&, const std::string&,
+                         bool, size_t, size_t, size_t, size_t, double, size_t, const std::string&,
+                         bool, size_t, size_t, bool, const std::string&, const std::string&,
+                         const std::string&, const std::string&,
                          // Overflow handling related.
                          size_t, DatabaseOverflowPolicy_t, double,
                          // Caching behavior related.
-                         bool, double, bool,
+                         bool, double, bool, size_t, size_t,
                          // Real-time update mechanism related.
                          const std::vector<std::string>&>(),
           pybind11::arg("type") = DatabaseType_t::ParallelHashMap,
@@ -297,6 +303,11 @@ void HPSPybind(pybind11::module& m) {
           pybind11::arg("password") = "",
           pybind11::arg("num_partitions") = std::min(16u, std::thread::hardware_concurrency()),
           pybind11::arg("allocation_rate") = 256L * 1024L * 1024L,
+          pybind11::arg("numa_aware") = false, pybind11::arg("hot_key_capacity") = 0,
+          pybind11::arg("hot_key_refresh_interval") = 1024L * 1024L,
+          pybind11::arg("compaction_interval_ms") = 0,
+          pybind11::arg("compaction_time_budget_us") = 1000,
+          pybind11::arg("compaction_slack") = 0.25,
           pybind11::arg("shared_memory_size") = 16L * 1024L * 1024L * 1024L,
           pybind11::arg("shared_memory_name") = "hctr_mp_hash_map_database",
           pybind11::arg("shared_memory_auto_remove") = true,
@@ -314,6 +325,8 @@ void HPSPybind(pybind11::module& m) {
           pybind11::arg("initialize_after_startup") = true,
           pybind11::arg("initial_cache_rate") = 1.0,
           pybind11::arg("cache_missed_embeddings") = false,
+          pybind11::arg("elevation_admission_threshold") = 0,
+          pybind11::arg("elevation_admission_window") = 1024L * 1024L,
           // Real-time update mechanism related.
           pybind11::arg("update_filters") = std::vector<std::string>{"^hps_.+$"});
 
@@ -370,7 +383,8 @@ void HPSPybind(pybind11::module& m) {
                           const float, const float, const std::vector<size_t>&,
                           const std::vector<size_t>&, const std::vector<std::string>&,
                           const std::string&, const size_t, const size_t, const std::string&, bool,
-                          const EmbeddingCacheType_t&, bool, bool, bool, bool, bool, bool>(),
+                          const EmbeddingCacheType_t&, bool, bool, bool, bool, bool, bool,
+                          const int, const int, bool, const int, const int, bool>(),
 
            pybind11::arg("model_name"), pybind11::arg("max_batchsize"),
            pybind11::arg("hit_rate_threshold"), pybind11::arg("dense_model_file"),
@@ -402,7 +416,13 @@ void HPSPybind(pybind11::module& m) {
            pybind11::arg("use_context_stream") = true,
            pybind11::arg("fuse_embedding_table") = false,
            pybind11::arg("use_hctr_cache_implementation") = true, pybind11::arg("init_ec") = true,
-           pybind11::arg("enable_pagelock") = false, pybind11::arg("fp8_quant") = false);
+           pybind11::arg("enable_pagelock") = false, pybind11::arg("fp8_quant") = false,
+           pybind11::arg("max_number_of_worker_buffers_in_pool") = 0,
+           pybind11::arg("memory_pool_wait_timeout_ms") = 1000,
+           pybind11::arg("enable_lookup_batching") = false,
+           pybind11::arg("lookup_batching_delay_us") = 100,
+           pybind11::arg("lookup_batching_max_keys") = 0,
+           pybind11::arg("use_host_embedding_cache") = false);
 
   pybind11::class_<HugeCTR::parameter_server_config,
                    std::shared_ptr<HugeCTR::parameter_server_config>>(infer,
@@ -419,6 +439,37 @@ void HPSPybind(pybind11::module& m) {
            pybind11::arg("persistent_db") = PersistentDatabaseParams{},
            pybind11::arg("update_source") = UpdateSourceParams{});
 
+  pybind11::class_<HugeCTR::HPSTierStats>(infer, "HPSTierStats")
+      .def_readonly("num_lookups", &HugeCTR::HPSTierStats::num_lookups)
+      .def_readonly("num_hits", &HugeCTR::HPSTierStats::num_hits)
+      .def_property_readonly("num_misses", &HugeCTR::HPSTierStats::num_misses)
+      .def_property_readonly("hit_ratio", &HugeCTR::HPSTierStats::hit_ratio);
+
+  pybind11::class_<HugeCTR::DatabaseTableStats>(infer, "DatabaseTableStats")
+      .def_readonly("num_keys", &HugeCTR::DatabaseTableStats::num_keys)
+      .def_readonly("bytes_resident", &HugeCTR::DatabaseTableStats::bytes_resident)
+      .def_readonly("bytes_allocated", &HugeCTR::DatabaseTableStats::bytes_allocated)
+      .def_readonly("free_slot_bytes", &HugeCTR::DatabaseTableStats::free_slot_bytes)
+      .def_readonly("num_overflows", &HugeCTR::DatabaseTableStats::num_overflows)
+      .def_readonly("num_evictions", &HugeCTR::DatabaseTableStats::num_evictions);
+
+  pybind11::class_<HugeCTR::HPSTableStats>(infer, "HPSTableStats")
+      .def_readonly("model_name", &HugeCTR::HPSTableStats::model_name)
+      .def_readonly("table_name", &HugeCTR::HPSTableStats::table_name)
+      .def_readonly("embedding_cache", &HugeCTR::HPSTableStats::embedding_cache)
+      .def_readonly("volatile_db", &HugeCTR::HPSTableStats::volatile_db)
+      .def_readonly("persistent_db", &HugeCTR::HPSTableStats::persistent_db)
+      .def_readonly("num_defaults", &HugeCTR::HPSTableStats::num_defaults)
+      .def_readonly("num_elevation_candidates", &HugeCTR::HPSTableStats::num_elevation_candidates)
+      .def_readonly("num_elevations", &HugeCTR::HPSTableStats::num_elevations)
+      .def_property_readonly("elevation_admission_ratio",
+                             &HugeCTR::HPSTableStats::elevation_admission_ratio)
+      .def_readonly("num_host_keys", &HugeCTR::HPSTableStats::num_host_keys)
+      .def_readonly("num_host_unique_keys", &HugeCTR::HPSTableStats::num_host_unique_keys)
+      .def_property_readonly("host_dedup_ratio", &HugeCTR::HPSTableStats::host_dedup_ratio)
+      .def_readonly("volatile_db_table", &HugeCTR::HPSTableStats::volatile_db_table)
+      .def_readonly("persistent_db_table", &HugeCTR::HPSTableStats::persistent_db_table);
+
   pybind11::class_<HugeCTR::python_lib::HPS, std::shared_ptr<HugeCTR::python_lib::HPS>>(infer,
                                                                                         "HPS")
       .def(pybind11::init<parameter_server_config&>(), pybind11::arg("ps_config"))
@@ -427,7 +478,8 @@ void HPSPybind(pybind11::module& m) {
            pybind11::arg("model_name"), pybind11::arg("table_id"), pybind11::arg("device_id") = 0)
       .def("lookup_fromdlpack", &HugeCTR::python_lib::HPS::lookup_fromdlpack, pybind11::arg("keys"),
            pybind11::arg("out_tensor"), pybind11::arg("model_name"), pybind11::arg("table_id"),
-           pybind11::arg("device_id") = 0);
+           pybind11::arg("device_id") = 0)
+      .def("get_stats", &HugeCTR::python_lib::HPS::get_stats, pybind11::arg("model_name") = "");
 }
 
 }  // namespace python_lib
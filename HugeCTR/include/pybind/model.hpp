@@ -29,6 +29,7 @@
 #include <hps/message.hpp>
 #include <inference/preallocated_buffer2.hpp>
 #include <io/filesystem.hpp>
+#include <io/snapshot_writer.hpp>
 #include <loss.hpp>
 #include <metrics.hpp>
 #include <optimizer.hpp>
@@ -152,18 +153,21 @@ struct DataReaderParams {
   std::vector<long long int> slot_size_array;
   DataSourceParams data_source_params;
   AsyncParam async_param;
+  size_t parquet_cpu_decoder_threads;
   DataReaderParams(DataReaderType_t data_reader_type, std::string source, std::string keyset,
                    std::string eval_source, Check_t check_type, int cache_eval_data,
                    long long num_samples, long long eval_num_samples, bool float_label_dense,
                    bool read_file_sequentially, int num_workers,
                    std::vector<long long>& slot_size_array,
-                   const DataSourceParams& data_source_params, const AsyncParam& async_param);
+                   const DataSourceParams& data_source_params, const AsyncParam& async_param,
+                   size_t parquet_cpu_decoder_threads = 0);
   DataReaderParams(DataReaderType_t data_reader_type, std::vector<std::string> source,
                    std::vector<std::string> keyset, std::string eval_source, Check_t check_type,
                    int cache_eval_data, long long num_samples, long long eval_num_samples,
                    bool float_label_dense, bool read_file_sequentially, int num_workers,
                    std::vector<long long>& slot_size_array,
-                   const DataSourceParams& data_source_params, const AsyncParam& async_param);
+                   const DataSourceParams& data_source_params, const AsyncParam& async_param,
+                   size_t parquet_cpu_decoder_threads = 0);
 };
 
 struct Input {
@@ -609,11 +613,26 @@ class Model final {
 
   std::vector<std::shared_ptr<TrainingCallback>> training_callbacks_;
 
+  std::unique_ptr<SnapshotWriter> snapshot_writer_; /**< writes snapshots during fit. */
+
+  /**
+   * Takes a snapshot during fit. With async_snapshot, the files are only staged in host memory
+   * here, and written in the background.
+   */
+  Error_t snapshot_params_to_files_(const std::string& prefix, int iter);
+
+  /**
+   * Like \p download_params_to_files, but writes all files through \p fs , if it is not null.
+   */
+  Error_t download_params_to_files_(const std::string& prefix, int iter, FileSystem* fs);
+
   Error_t download_dense_params_to_files_(std::string weights_file,
-                                          std::string dense_opt_states_file);
+                                          std::string dense_opt_states_file,
+                                          FileSystem* fs = nullptr);
 
   Error_t download_sparse_params_to_files_(const std::vector<std::string>& embedding_files,
-                                           const std::vector<std::string>& sparse_opt_state_files);
+                                           const std::vector<std::string>& sparse_opt_state_files,
+                                           FileSystem* fs = nullptr);
 
   void init_params_for_dense_();
   void init_params_for_sparse_();
@@ -30,7 +30,7 @@ void ModelPybind(pybind11::module &m) {
       m, "DataReaderParams")
       .def(pybind11::init<DataReaderType_t, std::string, std::string, std::string, Check_t, int,
                           long long, long long, bool, bool, int, std::vector<long long> &,
-                          const DataSourceParams &, const AsyncParam &>(),
+                          const DataSourceParams &, const AsyncParam &, size_t>(),
            pybind11::arg("data_reader_type"), pybind11::arg("source"), pybind11::arg("keyset") = "",
            pybind11::arg("eval_source"), pybind11::arg("check_type"),
            pybind11::arg("cache_eval_data") = 0, pybind11::arg("num_samples") = 0,
@@ -39,10 +39,12 @@ void ModelPybind(pybind11::module &m) {
            pybind11::arg("slot_size_array") = std::vector<long long>(),
            pybind11::arg("data_source_params") = new DataSourceParams(),
            pybind11::arg("async_param") =
-               AsyncParam{16, 4, 512000, 4, 512, false, Alignment_t::None, false, false})
+               AsyncParam{16, 4, 512000, 4, 512, false, Alignment_t::None, false, false},
+           pybind11::arg("parquet_cpu_decoder_threads") = 0)
       .def(pybind11::init<DataReaderType_t, std::vector<std::string>, std::vector<std::string>,
                           std::string, Check_t, int, long long, long long, bool, bool, int,
-                          std::vector<long long> &, const DataSourceParams &, const AsyncParam &>(),
+                          std::vector<long long> &, const DataSourceParams &, const AsyncParam &,
+                          size_t>(),
            pybind11::arg("data_reader_type"), pybind11::arg("source"),
            pybind11::arg("keyset") = std::vector<std::string>(), pybind11::arg("eval_source"),
            pybind11::arg("check_type"), pybind11::arg("cache_eval_data") = 0,
@@ -52,7 +54,8 @@ void ModelPybind(pybind11::module &m) {
            pybind11::arg("slot_size_array") = std::vector<long long>(),
            pybind11::arg("data_source_params") = new DataSourceParams(),
            pybind11::arg("async_param") =
-               AsyncParam{16, 4, 512000, 4, 512, false, Alignment_t::None, false, false});
+               AsyncParam{16, 4, 512000, 4, 512, false, Alignment_t::None, false, false},
+           pybind11::arg("parquet_cpu_decoder_threads") = 0);
   pybind11::class_<HugeCTR::Input, std::shared_ptr<HugeCTR::Input>>(m, "Input")
       .def(pybind11::init<int, std::string, int, std::string,
                           std::vector<DataReaderSparseParam> &>(),
@@ -37,7 +37,8 @@ std::unique_ptr<Solver> CreateSolver(
     DeviceMap::Layout device_layout, bool use_embedding_collection, AllReduceAlgo all_reduce_algo,
     bool grouped_all_reduce, size_t num_iterations_statistics, bool perf_logging,
     bool drop_incomplete_batch, std::string& kafka_brokers,
-    const std::vector<std::shared_ptr<TrainingCallback>>& training_callbacks) {
+    const std::vector<std::shared_ptr<TrainingCallback>>& training_callbacks, bool async_snapshot,
+    size_t num_snapshot_threads) {
   if (use_mixed_precision && enable_tf32_compute) {
     HCTR_OWN_THROW(Error_t::WrongInput,
                    "use_mixed_precision and enable_tf32_compute cannot be true at the same time");
@@ -81,6 +82,8 @@ std::unique_ptr<Solver> CreateSolver(
   solver->num_iterations_statistics = num_iterations_statistics;
   solver->perf_logging = perf_logging;
   solver->drop_incomplete_batch = drop_incomplete_batch;
+  solver->async_snapshot = async_snapshot;
+  solver->num_snapshot_threads = num_snapshot_threads;
   solver->kafka_brokers = kafka_brokers;
   solver->training_callbacks = training_callbacks;
   return solver;
@@ -123,6 +126,8 @@ void SolverPybind(pybind11::module& m) {
       .def_readonly("num_iterations_statistics", &HugeCTR::Solver::num_iterations_statistics)
       .def_readonly("perf_logging", &HugeCTR::Solver::perf_logging)
       .def_readonly("drop_incomplete_batch", &HugeCTR::Solver::drop_incomplete_batch)
+      .def_readonly("async_snapshot", &HugeCTR::Solver::async_snapshot)
+      .def_readonly("num_snapshot_threads", &HugeCTR::Solver::num_snapshot_threads)
       .def_readonly("training_callbacks", &HugeCTR::Solver::training_callbacks);
   m.def("CreateSolver", &HugeCTR::python_lib::CreateSolver, pybind11::arg("model_name") = "",
         pybind11::arg("seed") = 0, pybind11::arg("lr_policy") = LrPolicy_t::fixed,
@@ -147,7 +152,8 @@ void SolverPybind(pybind11::module& m) {
         pybind11::arg("grouped_all_reduce") = false,
         pybind11::arg("num_iterations_statistics") = 20, pybind11::arg("perf_logging") = false,
         pybind11::arg("drop_incomplete_batch") = true, pybind11::arg("kafka_brockers") = "",
-        pybind11::arg("training_callbacks") = std::vector<std::shared_ptr<TrainingCallback>>());
+        pybind11::arg("training_callbacks") = std::vector<std::shared_ptr<TrainingCallback>>(),
+        pybind11::arg("async_snapshot") = false, pybind11::arg("num_snapshot_threads") = 2);
 }
 
 }  // namespace python_lib
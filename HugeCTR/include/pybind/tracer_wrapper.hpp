@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <pybind11/pybind11.h>
+
+#include <core23/tracer.hpp>
+
+namespace HugeCTR {
+
+namespace python_lib {
+
+void TracerPybind(pybind11::module &m) {
+  pybind11::module tracing = m.def_submodule("tracing", "tracing submodule of hugectr");
+  tracing.def(
+      "enable", []() { Tracer::get().enable(); }, "Start recording trace events.");
+  tracing.def(
+      "disable", []() { Tracer::get().disable(); }, "Stop recording trace events.");
+  tracing.def("is_enabled", &Tracer::enabled);
+  tracing.def(
+      "clear", []() { Tracer::get().clear(); }, "Drop all recorded trace events.");
+  tracing.def(
+      "dump",
+      [](const std::string &path) {
+        pybind11::gil_scoped_release release;
+        Tracer::get().dump(path);
+      },
+      pybind11::arg("path"), "Write the recorded trace events as Chrome trace JSON.");
+  tracing.def("num_events", []() { return Tracer::get().num_events(); });
+  tracing.def("num_dropped", []() { return Tracer::get().num_dropped(); });
+}
+
+}  // namespace python_lib
+}  // namespace HugeCTR
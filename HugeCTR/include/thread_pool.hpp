@@ -37,6 +37,13 @@ class ThreadPool final {
 
   ThreadPool(const std::string& name, size_t num_workers);
 
+  /**
+   * @param on_start Invoked by each worker thread (with its index) before processing any task.
+   * Useful to pin workers to a set of CPUs or to set a thread-local memory policy.
+   */
+  ThreadPool(const std::string& name, size_t num_workers,
+             const std::function<void(size_t)>& on_start);
+
   virtual ~ThreadPool();
 
   inline const std::string& name() const { return name_; }
@@ -60,6 +67,7 @@ class ThreadPool final {
 
  private:
   const std::string name_;
+  const std::function<void(size_t)> on_start_;
   std::vector<std::thread> workers_;
 
   mutable std::mutex barrier_;  // Must be obtained to ensure exclusive access.
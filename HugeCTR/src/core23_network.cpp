@@ -115,6 +115,11 @@ metrics::Core23RawMetricMap Network::get_raw_metrics(std::string loss_name) cons
 }
 
 void Network::download_params_to_host(const std::string& write_path) {
+  auto fs = FileSystemBuilder::build_unique_by_path(write_path);
+  download_params_to_host(write_path, *fs);
+}
+
+void Network::download_params_to_host(const std::string& write_path, FileSystem& fs) {
   // forward
   CudaDeviceContext context(get_device_id());
 
@@ -122,17 +127,20 @@ void Network::download_params_to_host(const std::string& write_path) {
   HCTR_LIB_THROW(cudaMemcpy(weight.get(), train_weight_tensor_->data(),
                             train_weight_tensor_->num_bytes(), cudaMemcpyDeviceToHost));
 
-  auto fs = FileSystemBuilder::build_unique_by_path(write_path);
-  fs->write(write_path, weight.get(), train_weight_tensor_->num_bytes(), true);
+  fs.write(write_path, weight.get(), train_weight_tensor_->num_bytes(), true);
   return;
 }
 
 void Network::download_opt_states_to_host(const std::string& write_path) {
+  auto fs = FileSystemBuilder::build_unique_by_path(write_path);
+  download_opt_states_to_host(write_path, *fs);
+}
+
+void Network::download_opt_states_to_host(const std::string& write_path, FileSystem& fs) {
   // forward
   CudaDeviceContext context(get_device_id());
-  auto fs = FileSystemBuilder::build_unique_by_path(write_path);
   if (opt_tensor_->empty()) {
-    fs->write(write_path, nullptr, 0, true);
+    fs.write(write_path, nullptr, 0, true);
     return;
   }
   size_t dst_size_in_byte = opt_tensor_->num_bytes();
@@ -141,7 +149,7 @@ void Network::download_opt_states_to_host(const std::string& write_path) {
   void* src = (void*)opt_tensor_->data();
   HCTR_LIB_THROW(cudaMemcpy(h_opt_states.get(), src, dst_size_in_byte, cudaMemcpyDeviceToHost));
 
-  fs->write(write_path, h_opt_states.get(), dst_size_in_byte, true);
+  fs.write(write_path, h_opt_states.get(), dst_size_in_byte, true);
 }
 
 std::string Network::get_no_trained_params_in_string() {
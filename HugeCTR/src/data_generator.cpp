@@ -15,6 +15,7 @@
  */
 
 #include <data_generator.hpp>
+#include <data_generator/raw_async_generator.hpp>
 #include <fstream>
 #include <ios>
 #include <iostream>
@@ -82,7 +83,8 @@ DataGenerator::~DataGenerator() {}
 
 DataGenerator::DataGenerator(const DataGeneratorParams& data_generator_params)
     : data_generator_params_(data_generator_params) {
-  if (data_generator_params_.format == DataReaderType_t::Raw) {
+  if (data_generator_params_.format == DataReaderType_t::Raw ||
+      data_generator_params_.format == DataReaderType_t::RawAsync) {
     data_generator_params_.check_type = Check_t::None;
   }
 }
@@ -237,6 +239,41 @@ void DataGenerator::generate() {
       }
       break;
     }
+    case DataReaderType_t::RawAsync: {
+      HCTR_LOG_S(INFO, WORLD) << "Generate RawAsync dataset" << std::endl;
+      HCTR_LOG_S(INFO, WORLD) << "train data folder: " << train_data_folder
+                              << ", eval data folder: " << eval_data_folder << ", slot_size_array: "
+                              << vec_to_string(data_generator_params_.slot_size_array)
+                              << ", nnz array: " << vec_to_string(data_generator_params_.nnz_array)
+                              << ", Number of train samples: " << data_generator_params_.num_samples
+                              << ", Number of eval samples: "
+                              << data_generator_params_.eval_num_samples
+                              << ", #threads: " << data_generator_params_.num_threads
+                              << ", Use power law distribution: " << use_long_tail
+                              << ", alpha of power law: " << alpha << std::endl;
+      check_make_dir(train_data_folder);
+      check_make_dir(eval_data_folder);
+
+      RawAsyncGeneratorParams params;
+      params.label_dim = static_cast<size_t>(data_generator_params_.label_dim);
+      params.dense_dim = static_cast<size_t>(data_generator_params_.dense_dim);
+      params.slot_size_array = data_generator_params_.slot_size_array;
+      params.nnz_array = data_generator_params_.nnz_array;
+      params.i64_input_key = data_generator_params_.i64_input_key;
+      params.float_label_dense = data_generator_params_.float_label_dense;
+      params.long_tail = use_long_tail;
+      params.alpha = alpha;
+      params.num_threads = static_cast<size_t>(data_generator_params_.num_threads);
+
+      params.num_samples = static_cast<size_t>(data_generator_params_.num_samples);
+      RawAsyncGenerator(params).generate(data_generator_params_.source);
+
+      // Use a different substream family for the evaluation set.
+      params.num_samples = static_cast<size_t>(data_generator_params_.eval_num_samples);
+      params.seed = 1;
+      RawAsyncGenerator(params).generate(data_generator_params_.eval_source);
+      break;
+    }
     case DataReaderType_t::Parquet: {
 #ifdef DISABLE_CUDF
       HCTR_OWN_THROW(Error_t::WrongInput, "Parquet is not supported under DISABLE_CUDF");
@@ -0,0 +1,170 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <core23/logger.hpp>
+#include <data_generator/key_sampler.hpp>
+#include <limits>
+#include <numeric>
+
+namespace HugeCTR {
+
+void KeySampler::sample(PhiloxStream& rng, uint64_t* const keys, const size_t num_keys) const {
+  for (size_t i{0}; i < num_keys; ++i) {
+    keys[i] = sample(rng);
+  }
+}
+
+UniformKeySampler::UniformKeySampler(const uint64_t vocabulary_size)
+    : vocabulary_size_{vocabulary_size} {
+  HCTR_CHECK_HINT(vocabulary_size > 0, "Vocabulary must not be empty.");
+}
+
+AliasTableKeySampler::AliasTableKeySampler(const std::vector<double>& weights) {
+  const size_t n{weights.size()};
+  HCTR_CHECK_HINT(n > 0, "Vocabulary must not be empty.");
+  HCTR_CHECK_HINT(n <= std::numeric_limits<uint32_t>::max(),
+                  "Vocabulary too large for alias table.");
+
+  const double sum{std::accumulate(weights.begin(), weights.end(), 0.0)};
+  HCTR_CHECK_HINT(sum > 0, "Weights must not all be zero.");
+
+  // Scale, so that the average bucket probability is 1.
+  std::vector<double> p(n);
+  std::vector<uint32_t> small;
+  std::vector<uint32_t> large;
+  for (size_t i{0}; i < n; ++i) {
+    p[i] = weights[i] * static_cast<double>(n) / sum;
+    (p[i] < 1 ? small : large).emplace_back(static_cast<uint32_t>(i));
+  }
+
+  const auto to_threshold{[](const double prob) {
+    return prob >= 1 ? std::numeric_limits<uint32_t>::max()
+                     : static_cast<uint32_t>(prob * 4294967296.0);
+  }};
+
+  entries_.resize(n);
+  while (!small.empty() && !large.empty()) {
+    const uint32_t s{small.back()};
+    small.pop_back();
+    const uint32_t l{large.back()};
+
+    entries_[s] = {to_threshold(p[s]), l};
+    p[l] = (p[l] + p[s]) - 1;
+    if (p[l] < 1) {
+      large.pop_back();
+      small.emplace_back(l);
+    }
+  }
+
+  // Leftovers are (up to rounding errors) full buckets.
+  for (const uint32_t i : large) {
+    entries_[i] = {std::numeric_limits<uint32_t>::max(), i};
+  }
+  for (const uint32_t i : small) {
+    entries_[i] = {std::numeric_limits<uint32_t>::max(), i};
+  }
+}
+
+void AliasTableKeySampler::sample(PhiloxStream& rng, uint64_t* const keys,
+                                  const size_t num_keys) const {
+  // Draw random words in chunks to amortize the per-call overhead of the stream.
+  constexpr size_t chunk_size{256};
+  uint32_t r[chunk_size * 2];
+  const uint64_t n{entries_.size()};
+
+  for (size_t i{0}; i < num_keys; i += chunk_size) {
+    const size_t m{std::min(num_keys - i, chunk_size)};
+    rng.fill_u32(r, m * 2);
+    for (size_t j{0}; j < m; ++j) {
+      const uint64_t bucket{(static_cast<uint64_t>(r[2 * j + 1]) * n) >> 32};
+      const Entry& entry{entries_[bucket]};
+      keys[i + j] = r[2 * j] < entry.threshold ? bucket : entry.alias;
+    }
+  }
+}
+
+namespace {
+
+/**
+ * log1p(x) / x, numerically stable around 0.
+ */
+inline double helper1(const double x) {
+  return std::abs(x) > 1e-8 ? std::log1p(x) / x : 1 - x * (0.5 - x * (1.0 / 3.0 - 0.25 * x));
+}
+
+/**
+ * expm1(x) / x, numerically stable around 0.
+ */
+inline double helper2(const double x) {
+  return std::abs(x) > 1e-8 ? std::expm1(x) / x : 1 + x * 0.5 * (1 + x / 3.0 * (1 + 0.25 * x));
+}
+
+}  // namespace
+
+ZipfRejectionInversionKeySampler::ZipfRejectionInversionKeySampler(const uint64_t vocabulary_size,
+                                                                   const double alpha)
+    : vocabulary_size_{vocabulary_size},
+      alpha_{alpha},
+      h_integral_x1_{h_integral_(1.5) - 1},
+      h_integral_n_{h_integral_(static_cast<double>(vocabulary_size) + 0.5)},
+      s_{2 - h_integral_inverse_(h_integral_(2.5) - h_(2))} {
+  HCTR_CHECK_HINT(vocabulary_size > 0, "Vocabulary must not be empty.");
+  HCTR_CHECK_HINT(alpha > 0, "Zipf exponent must be positive.");
+}
+
+uint64_t ZipfRejectionInversionKeySampler::sample(PhiloxStream& rng) const {
+  const double n{static_cast<double>(vocabulary_size_)};
+  while (true) {
+    const double u{h_integral_n_ + rng.next_double() * (h_integral_x1_ - h_integral_n_)};
+    const double x{h_integral_inverse_(u)};
+    const double k{std::clamp(std::floor(x + 0.5), 1.0, n)};
+    if (k - x <= s_ || u >= h_integral_(k + 0.5) - h_(k)) {
+      return static_cast<uint64_t>(k) - 1;
+    }
+  }
+}
+
+double ZipfRejectionInversionKeySampler::h_(const double x) const {
+  return std::exp(-alpha_ * std::log(x));
+}
+
+double ZipfRejectionInversionKeySampler::h_integral_(const double x) const {
+  const double log_x{std::log(x)};
+  return helper2((1 - alpha_) * log_x) * log_x;
+}
+
+double ZipfRejectionInversionKeySampler::h_integral_inverse_(const double x) const {
+  const double t{std::max(x * (1 - alpha_), -1.0)};
+  return std::exp(helper1(t) * x);
+}
+
+std::shared_ptr<KeySampler> make_zipf_key_sampler(const uint64_t vocabulary_size,
+                                                  const double alpha,
+                                                  const uint64_t alias_table_limit) {
+  if (vocabulary_size > alias_table_limit) {
+    return std::make_shared<ZipfRejectionInversionKeySampler>(vocabulary_size, alpha);
+  }
+
+  std::vector<double> weights(vocabulary_size);
+  for (size_t i{0}; i < weights.size(); ++i) {
+    weights[i] = std::exp(-alpha * std::log(static_cast<double>(i + 1)));
+  }
+  return std::make_shared<AliasTableKeySampler>(weights);
+}
+
+}  // namespace HugeCTR
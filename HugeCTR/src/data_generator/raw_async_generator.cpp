@@ -0,0 +1,202 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <core/memory.hpp>
+#include <core23/logger.hpp>
+#include <cstring>
+#include <data_generator/raw_async_generator.hpp>
+#include <map>
+#include <numeric>
+#include <thread>
+
+namespace HugeCTR {
+
+RawAsyncGenerator::RawAsyncGenerator(const RawAsyncGeneratorParams& params) : params_{params} {
+  HCTR_CHECK_HINT(!params_.slot_size_array.empty(), "slot_size_array must not be empty.");
+  HCTR_CHECK_HINT(
+      params_.nnz_array.empty() || params_.nnz_array.size() == params_.slot_size_array.size(),
+      "nnz_array and slot_size_array must have the same length.");
+  HCTR_CHECK_HINT(params_.num_threads > 0, "Need at least one thread.");
+  HCTR_CHECK_HINT(params_.io_alignment > 0, "io_alignment must be positive.");
+
+  // Slots with the same vocabulary share one sampler, so that alias tables are only built once.
+  std::map<size_t, std::shared_ptr<KeySampler>> samplers;
+  for (size_t slot{0}; slot < params_.slot_size_array.size(); ++slot) {
+    const size_t vocabulary_size{params_.slot_size_array[slot]};
+    HCTR_CHECK_HINT(vocabulary_size > 0, "Slot ", slot, " has an empty vocabulary.");
+    HCTR_CHECK_HINT(params_.i64_input_key || vocabulary_size <= (UINT64_C(1) << 32),
+                    "Slot ", slot, " vocabulary exceeds 32 bit key range.");
+
+    std::shared_ptr<KeySampler>& sampler{samplers[vocabulary_size]};
+    if (!sampler) {
+      if (params_.long_tail) {
+        sampler = make_zipf_key_sampler(vocabulary_size, params_.alpha, params_.alias_table_limit);
+      } else {
+        sampler = std::make_shared<UniformKeySampler>(vocabulary_size);
+      }
+    }
+    samplers_.emplace_back(sampler);
+
+    const int nnz{params_.nnz_array.empty() ? 1 : params_.nnz_array[slot]};
+    HCTR_CHECK_HINT(nnz > 0, "Slot ", slot, " must have a positive nnz.");
+    total_nnz_ += static_cast<size_t>(nnz);
+  }
+
+  key_size_bytes_ = params_.i64_input_key ? sizeof(int64_t) : sizeof(uint32_t);
+  sample_size_bytes_ = (params_.label_dim + params_.dense_dim) * sizeof(float) +
+                       total_nnz_ * key_size_bytes_;
+
+  // Smallest number of samples that fills an integral number of aligned IO units, scaled up to
+  // approximately match the requested block size.
+  const size_t unit{params_.io_alignment / std::gcd(sample_size_bytes_, params_.io_alignment)};
+  samples_per_block_ =
+      std::max(params_.block_size_bytes / (unit * sample_size_bytes_), size_t{1}) * unit;
+}
+
+template <typename KeyType, typename DenseType>
+void RawAsyncGenerator::fill_block_(const size_t block_index, const size_t num_samples,
+                                    char* const buffer) const {
+  PhiloxStream rng(params_.seed, block_index);
+  std::vector<uint64_t> keys(total_nnz_);
+
+  char* ptr{buffer};
+  for (size_t i{0}; i < num_samples; ++i) {
+    DenseType* const label{reinterpret_cast<DenseType*>(ptr)};
+    for (size_t j{0}; j < params_.label_dim; ++j) {
+      label[j] = static_cast<DenseType>(rng.next_u32() & 1);
+    }
+
+    DenseType* const dense{label + params_.label_dim};
+    for (size_t j{0}; j < params_.dense_dim; ++j) {
+      if constexpr (std::is_floating_point_v<DenseType>) {
+        dense[j] = rng.next_float();
+      } else {
+        dense[j] = static_cast<DenseType>(rng.next_below(1 << 16));
+      }
+    }
+
+    // Draw keys slot by slot, and then narrow them into the output in one pass.
+    uint64_t* k{keys.data()};
+    for (size_t slot{0}; slot < samplers_.size(); ++slot) {
+      const size_t nnz{params_.nnz_array.empty() ? 1
+                                                 : static_cast<size_t>(params_.nnz_array[slot])};
+      samplers_[slot]->sample(rng, k, nnz);
+      k += nnz;
+    }
+    KeyType* const out_keys{reinterpret_cast<KeyType*>(dense + params_.dense_dim)};
+    for (size_t j{0}; j < total_nnz_; ++j) {
+      out_keys[j] = static_cast<KeyType>(keys[j]);
+    }
+
+    ptr += sample_size_bytes_;
+  }
+}
+
+void RawAsyncGenerator::fill_block(const size_t block_index, const size_t num_samples,
+                                   char* const buffer) const {
+  if (params_.i64_input_key) {
+    if (params_.float_label_dense) {
+      fill_block_<int64_t, float>(block_index, num_samples, buffer);
+    } else {
+      fill_block_<int64_t, int32_t>(block_index, num_samples, buffer);
+    }
+  } else {
+    if (params_.float_label_dense) {
+      fill_block_<uint32_t, float>(block_index, num_samples, buffer);
+    } else {
+      fill_block_<uint32_t, int32_t>(block_index, num_samples, buffer);
+    }
+  }
+}
+
+RawAsyncGeneratorStats RawAsyncGenerator::generate(const std::string& file_name) const {
+  const int fd{open(file_name.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644)};
+  HCTR_CHECK_HINT(fd != -1, "Unable to open \"", file_name, "\" for writing.");
+
+  RawAsyncGeneratorStats stats;
+  stats.num_samples = params_.num_samples;
+  stats.num_bytes = params_.num_samples * sample_size_bytes_;
+  stats.num_blocks = (params_.num_samples + samples_per_block_ - 1) / samples_per_block_;
+
+  const size_t block_bytes{samples_per_block_ * sample_size_bytes_};
+  const size_t num_threads{std::min(params_.num_threads, std::max(stats.num_blocks, size_t{1}))};
+
+  // Reserve the space upfront, so that the file system does not have to extend the file while
+  // concurrent writers fill holes.
+  HCTR_CHECK_HINT(ftruncate(fd, static_cast<off_t>(stats.num_bytes)) == 0,
+                  "Unable to resize \"", file_name, "\": ", std::strerror(errno));
+
+  const auto t0{std::chrono::steady_clock::now()};
+
+  std::atomic<size_t> next_block{0};
+  std::atomic<bool> failed{false};
+  std::vector<std::thread> workers;
+  workers.reserve(num_threads);
+  for (size_t i{0}; i < num_threads; ++i) {
+    workers.emplace_back([&]() {
+      std::vector<char, AlignedAllocator<char, 4096>> buffer(block_bytes);
+
+      while (!failed) {
+        const size_t block_index{next_block.fetch_add(1, std::memory_order_relaxed)};
+        if (block_index >= stats.num_blocks) {
+          break;
+        }
+        const size_t first_sample{block_index * samples_per_block_};
+        const size_t num_samples{std::min(samples_per_block_, params_.num_samples - first_sample)};
+        fill_block(block_index, num_samples, buffer.data());
+
+        const char* data{buffer.data()};
+        size_t size{num_samples * sample_size_bytes_};
+        off_t offset{static_cast<off_t>(block_index * block_bytes)};
+        while (size > 0) {
+          const ssize_t n{pwrite(fd, data, size, offset)};
+          if (n <= 0) {
+            if (n < 0 && errno == EINTR) {
+              continue;
+            }
+            HCTR_LOG_S(ERROR, WORLD) << "Write to \"" << file_name << "\" failed: "
+                                     << std::strerror(errno) << std::endl;
+            failed = true;
+            break;
+          }
+          data += n;
+          size -= static_cast<size_t>(n);
+          offset += n;
+        }
+      }
+    });
+  }
+  for (auto& worker : workers) {
+    worker.join();
+  }
+  close(fd);
+  HCTR_CHECK_HINT(!failed, "Generating \"", file_name, "\" failed.");
+
+  stats.elapsed_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+  HCTR_LOG_S(INFO, WORLD) << "Generated " << stats.num_samples << " samples ("
+                          << stats.num_bytes << " bytes, " << stats.num_blocks << " blocks) in "
+                          << stats.elapsed_s << " s using " << num_threads
+                          << " thread(s): " << stats.gbps() << " GB/s" << std::endl;
+  return stats;
+}
+
+}  // namespace HugeCTR
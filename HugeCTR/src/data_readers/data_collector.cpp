@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 
+#include <core23/tracer.hpp>
 #include <data_readers/data_collector.hpp>
 
 namespace HugeCTR {
@@ -67,6 +68,7 @@ void DataCollector<T>::BackgroundDataCollectorThread::start() {
       dst_buffer->current_batch_size = current_src_buffer->current_batch_size;
       if (current_src_buffer->current_batch_size != 0) {
         // P2P
+        HCTR_TRACE_SCOPE("DataCollector::broadcast");
         broadcast<T>(current_src_buffer, dst_buffer, last_batch_nnz_, resource_manager_);
 
         current_src_buffer->state.store(BufferState::ReadyForWrite);
@@ -99,7 +101,10 @@ DataCollector<T>::DataCollector(const std::vector<std::shared_ptr<ThreadBuffer23
       last_batch_nnz_(
           broadcast_buffer->is_fixed_length.size() * resource_manager->get_local_gpu_count(), 0),
       resource_manager_(resource_manager) {
-  background_collector_thread_ = std::thread([this]() { background_collector_.start(); });
+  background_collector_thread_ = std::thread([this]() {
+    Logger::set_thread_name("data collector");
+    background_collector_.start();
+  });
 }
 template <typename T>
 void DataCollector<T>::stop() {
@@ -112,15 +117,19 @@ DataCollector<T>::~DataCollector() {
 }
 template <typename T>
 long long DataCollector<T>::read_a_batch_to_device() {
-  BufferState expected = BufferState::ReadyForRead;
-  while (!broadcast_buffer_->state.compare_exchange_weak(expected, BufferState::Reading)) {
-    expected = BufferState::ReadyForRead;
-    usleep(2);
+  {
+    HCTR_TRACE_SCOPE("DataCollector::wait_for_batch");
+    BufferState expected = BufferState::ReadyForRead;
+    while (!broadcast_buffer_->state.compare_exchange_weak(expected, BufferState::Reading)) {
+      expected = BufferState::ReadyForRead;
+      usleep(2);
+    }
   }
   long long current_batch_size = broadcast_buffer_->current_batch_size;
   if (current_batch_size != 0) {
     // D2D
     int local_gpu_count = resource_manager_->get_local_gpu_count();
+    HCTR_TRACE_SCOPE("DataCollector::to_output");
     nvtxRangePushA("to_output");
 #pragma omp parallel for num_threads(local_gpu_count)
     for (int i = 0; i < local_gpu_count; ++i) {
@@ -182,6 +191,7 @@ long long DataCollector<T>::read_a_batch_to_device() {
 }
 template <typename T>
 void DataCollector<T>::finalize_batch() {
+  HCTR_TRACE_SCOPE("DataCollector::finalize_batch");
 #pragma omp parallel num_threads(resource_manager_->get_local_gpu_count())
   {
     size_t id = omp_get_thread_num();
@@ -22,7 +22,8 @@ namespace cudf_io = cudf::io;
 
 ParquetFileSource::ParquetFileSource(unsigned int worker_id, unsigned int stride,
                                      const std::string& file_list, bool sequtial_file_consumption,
-                                     bool repeat, const DataSourceParams& data_source_params)
+                                     bool repeat, const DataSourceParams& data_source_params,
+                                     bool cpu_decoding)
     : file_list_(file_list),
       offset_(worker_id * !(sequtial_file_consumption)),
       worker_id_(worker_id),
@@ -34,7 +35,8 @@ ParquetFileSource::ParquetFileSource(unsigned int worker_id, unsigned int stride
       curr_row_group_(0),
       num_row_groups_(0),
       repeat_(repeat),
-      sequential_file_consumption_(sequtial_file_consumption) {
+      sequential_file_consumption_(sequtial_file_consumption),
+      cpu_decoding_(cpu_decoding) {
   slice_stream_ = NULL;
   file_loader_ = std::make_unique<FileLoader>(data_source_params);
   // load _metadata.json
@@ -118,6 +120,10 @@ Error_t ParquetFileSource::next_source(long long expected_num_row_group) noexcep
     if (res != Error_t::Success) {
       HCTR_OWN_THROW(res, "Library Dependency Error. Rebuild with Arrow::Parquet Library");
     }
+    if (cpu_decoding_) {
+      can_read_file_ = true;
+      return Error_t::Success;
+    }
     // check if file exists
     Error_t err = file_loader_->load(file_name_);
     if (err != Error_t::Success) {
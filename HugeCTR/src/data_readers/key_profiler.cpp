@@ -0,0 +1,607 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <parallel_hashmap/phmap.h>
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <data_readers/key_profiler.hpp>
+#include <data_readers/mapped_file.hpp>
+#include <exception>
+#include <limits>
+#include <mutex>
+#include <numeric>
+#include <thread>
+
+namespace HugeCTR {
+
+namespace {
+
+constexpr size_t num_shards_log2{6};
+constexpr size_t num_shards{size_t{1} << num_shards_log2};
+constexpr size_t sketch_depth{4};
+constexpr size_t hll_bits{14};
+
+// Hash table memory per key, including empty slots and the slack left after growing.
+constexpr size_t exact_entry_bytes{32};
+
+inline uint64_t mix(uint64_t x) {
+  x ^= x >> 30;
+  x *= UINT64_C(0xBF58476D1CE4E5B9);
+  x ^= x >> 27;
+  x *= UINT64_C(0x94D049BB133111EB);
+  return x ^ (x >> 31);
+}
+
+template <typename T>
+inline T load(const char* const ptr) {
+  T value;
+  std::memcpy(&value, ptr, sizeof(T));
+  return value;
+}
+
+}  // namespace
+
+/**
+ * Counts of one slot. Exact counts are kept in sharded hash tables. In sketch mode, the slot uses a
+ * count-min sketch, a set of heavy hitter candidates and a HyperLogLog.
+ */
+class KeyProfiler::Slot {
+ public:
+  std::atomic<uint64_t> num_accesses{0};
+
+  /**
+   * @return Number of keys that were not seen before.
+   */
+  size_t insert(const std::vector<uint64_t>& keys, std::vector<std::vector<uint64_t>>& scratch) {
+    scratch.resize(num_shards);
+    for (std::vector<uint64_t>& shard_keys : scratch) {
+      shard_keys.clear();
+    }
+    for (const uint64_t key : keys) {
+      scratch[mix(key) >> (64 - num_shards_log2)].push_back(key);
+    }
+
+    size_t num_added{0};
+    for (size_t i{0}; i < num_shards; ++i) {
+      if (scratch[i].empty()) {
+        continue;
+      }
+      Shard& shard{shards_[i]};
+      const std::lock_guard lock(shard.guard);
+      const size_t prev_size{shard.counts.size()};
+      for (const uint64_t key : scratch[i]) {
+        ++shard.counts[key];
+      }
+      num_added += shard.counts.size() - prev_size;
+    }
+    num_accesses.fetch_add(keys.size(), std::memory_order_relaxed);
+    return num_added;
+  }
+
+  /**
+   * Moves the exact counts into the sketches. Requires exclusive access.
+   */
+  void to_sketch(const KeyProfilerParams& params) {
+    capacity_ = std::max(params.num_heavy_hitters, size_t{1});
+    size_t width{1};
+    while (width < std::max(params.sketch_width, size_t{1024})) {
+      width *= 2;
+    }
+    width_mask_ = width - 1;
+    counters_ = std::vector<std::atomic<uint64_t>>(sketch_depth * width);
+    registers_ = std::vector<std::atomic<uint8_t>>(size_t{1} << hll_bits);
+
+    std::vector<std::pair<uint64_t, uint64_t>> counts;
+    for (Shard& shard : shards_) {
+      for (const auto& [key, count] : shard.counts) {
+        increment_(key, count);
+        add_to_hll_(key);
+        counts.emplace_back(key, count);
+      }
+      shard.counts = {};
+    }
+    admit_(counts);
+  }
+
+  /**
+   * Sketch mode only.
+   */
+  void record(const std::vector<uint64_t>& keys,
+              std::vector<std::pair<uint64_t, uint64_t>>& admissions) {
+    const uint64_t threshold{admission_threshold_.load(std::memory_order_relaxed)};
+    admissions.clear();
+    for (const uint64_t key : keys) {
+      const uint64_t count{increment_(key, 1)};
+      add_to_hll_(key);
+      if (count > threshold) {
+        admissions.emplace_back(key, count);
+      }
+    }
+    if (!admissions.empty()) {
+      const std::lock_guard lock(candidates_guard_);
+      admit_(admissions);
+    }
+    num_accesses.fetch_add(keys.size(), std::memory_order_relaxed);
+  }
+
+  KeyProfile result(const bool sketch_mode) const {
+    KeyProfile profile;
+    profile.num_accesses = num_accesses;
+    profile.exact = !sketch_mode;
+    if (sketch_mode) {
+      for (const auto& candidate : candidates_) {
+        // Estimates only grow, so that the current one is the tightest.
+        profile.keys.emplace_back(static_cast<int64_t>(candidate.first),
+                                  estimate_(candidate.first));
+      }
+      profile.cardinality =
+          std::max<uint64_t>(std::llround(cardinality_estimate_()), profile.keys.size());
+    } else {
+      for (const Shard& shard : shards_) {
+        for (const auto& [key, count] : shard.counts) {
+          profile.keys.emplace_back(static_cast<int64_t>(key), count);
+        }
+      }
+      profile.cardinality = profile.keys.size();
+    }
+    std::sort(profile.keys.begin(), profile.keys.end(), [](const auto& a, const auto& b) {
+      return a.second > b.second || (a.second == b.second && a.first < b.first);
+    });
+    return profile;
+  }
+
+ private:
+  struct Shard {
+    std::mutex guard;
+    phmap::flat_hash_map<uint64_t, uint64_t> counts;
+  };
+  std::array<Shard, num_shards> shards_;
+
+  // Count-min sketch with `sketch_depth` rows of `width_mask_ + 1` counters.
+  size_t width_mask_{0};
+  std::vector<std::atomic<uint64_t>> counters_;
+
+  // Heavy hitter candidates. Holds between `capacity_` and `2 * capacity_` keys.
+  size_t capacity_{0};
+  std::mutex candidates_guard_;
+  phmap::flat_hash_map<uint64_t, uint64_t> candidates_;
+  std::atomic<uint64_t> admission_threshold_{0};
+
+  // HyperLogLog registers.
+  std::vector<std::atomic<uint8_t>> registers_;
+
+  size_t counter_index_(const uint64_t hash, const size_t row) const {
+    // Kirsch-Mitzenmacher: derive the row hashes from two halves of a single strong hash.
+    const size_t h1{static_cast<size_t>(hash)};
+    const size_t h2{static_cast<size_t>(hash >> 32) | 1};
+    return row * (width_mask_ + 1) + ((h1 + row * h2) & width_mask_);
+  }
+
+  uint64_t increment_(const uint64_t key, const uint64_t count) {
+    const uint64_t hash{mix(key ^ UINT64_C(0x5851F42D4C957F2D))};
+    uint64_t estimate{std::numeric_limits<uint64_t>::max()};
+    for (size_t row{0}; row < sketch_depth; ++row) {
+      std::atomic<uint64_t>& counter{counters_[counter_index_(hash, row)]};
+      estimate = std::min(estimate, counter.fetch_add(count, std::memory_order_relaxed) + count);
+    }
+    return estimate;
+  }
+
+  uint64_t estimate_(const uint64_t key) const {
+    const uint64_t hash{mix(key ^ UINT64_C(0x5851F42D4C957F2D))};
+    uint64_t estimate{std::numeric_limits<uint64_t>::max()};
+    for (size_t row{0}; row < sketch_depth; ++row) {
+      estimate = std::min(estimate,
+                          counters_[counter_index_(hash, row)].load(std::memory_order_relaxed));
+    }
+    return estimate;
+  }
+
+  void admit_(const std::vector<std::pair<uint64_t, uint64_t>>& keys) {
+    for (const auto& [key, count] : keys) {
+      uint64_t& candidate_count{candidates_[key]};
+      candidate_count = std::max(candidate_count, count);
+    }
+
+    // Prune back to `capacity_` keys. Amortized over at least `capacity_` admissions.
+    if (candidates_.size() >= 2 * capacity_) {
+      std::vector<std::pair<uint64_t, uint64_t>> sorted(candidates_.begin(), candidates_.end());
+      std::nth_element(sorted.begin(), sorted.begin() + static_cast<ptrdiff_t>(capacity_ - 1),
+                       sorted.end(),
+                       [](const auto& a, const auto& b) { return a.second > b.second; });
+      sorted.resize(capacity_);
+
+      candidates_.clear();
+      candidates_.insert(sorted.begin(), sorted.end());
+      admission_threshold_.store(sorted.back().second, std::memory_order_relaxed);
+    }
+  }
+
+  void add_to_hll_(const uint64_t key) {
+    const uint64_t hash{mix(key ^ UINT64_C(0x2545F4914F6CDD1D))};
+    const size_t index{static_cast<size_t>(hash >> (64 - hll_bits))};
+    const uint64_t rest{hash << hll_bits};
+    const uint8_t rank{static_cast<uint8_t>(
+        rest ? __builtin_clzll(rest) + 1 : static_cast<int>(64 - hll_bits + 1))};
+
+    std::atomic<uint8_t>& reg{registers_[index]};
+    uint8_t prev{reg.load(std::memory_order_relaxed)};
+    while (prev < rank && !reg.compare_exchange_weak(prev, rank, std::memory_order_relaxed)) {
+    }
+  }
+
+  double cardinality_estimate_() const {
+    const double m{static_cast<double>(registers_.size())};
+    double sum{0};
+    size_t num_zeros{0};
+    for (const std::atomic<uint8_t>& reg : registers_) {
+      const uint8_t rank{reg.load(std::memory_order_relaxed)};
+      sum += std::ldexp(1., -rank);
+      num_zeros += rank == 0;
+    }
+    const double estimate{0.7213 / (1 + 1.079 / m) * m * m / sum};
+    if (estimate <= 2.5 * m && num_zeros > 0) {
+      // Linear counting is more accurate for small cardinalities.
+      return m * std::log(m / static_cast<double>(num_zeros));
+    }
+    return estimate;
+  }
+};
+
+double KeyProfile::accesses_of_top(const double num_keys) const {
+  const double total{static_cast<double>(num_accesses)};
+  double accesses{0};
+  size_t i{0};
+  for (; i < keys.size() && i + 1 <= num_keys; ++i) {
+    accesses += static_cast<double>(keys[i].second);
+  }
+  if (i < keys.size()) {
+    accesses += static_cast<double>(keys[i].second) * (num_keys - static_cast<double>(i));
+    return std::min(accesses, total);
+  }
+  accesses = std::min(accesses, total);
+
+  // Keys that were not tracked share the remaining accesses.
+  const double num_untracked{static_cast<double>(cardinality) - static_cast<double>(keys.size())};
+  if (num_untracked > 0 && num_keys > static_cast<double>(keys.size())) {
+    const double share{
+        std::min((num_keys - static_cast<double>(keys.size())) / num_untracked, 1.)};
+    accesses += (total - accesses) * share;
+  }
+  return accesses;
+}
+
+uint64_t KeyProfile::keys_for_coverage(const double fraction) const {
+  const double target{std::min(fraction, 1.) * static_cast<double>(num_accesses)};
+  double accesses{0};
+  for (size_t i{0}; i < keys.size(); ++i) {
+    if (accesses >= target) {
+      return i;
+    }
+    accesses += static_cast<double>(keys[i].second);
+  }
+  if (accesses >= target || cardinality <= keys.size()) {
+    return keys.size();
+  }
+
+  const double num_untracked{static_cast<double>(cardinality - keys.size())};
+  const double per_key{(static_cast<double>(num_accesses) - accesses) / num_untracked};
+  const double needed{per_key > 0 ? std::ceil((target - accesses) / per_key) : num_untracked};
+  return keys.size() + static_cast<uint64_t>(std::min(needed, num_untracked));
+}
+
+std::vector<std::pair<double, double>> KeyProfile::coverage(const size_t num_points) const {
+  std::vector<std::pair<double, double>> curve;
+  if (num_accesses == 0 || cardinality == 0) {
+    return curve;
+  }
+
+  const double num_keys{static_cast<double>(cardinality)};
+  const double total{static_cast<double>(num_accesses)};
+  uint64_t prev_rank{0};
+  for (size_t i{0}; i + 1 < num_points; ++i) {
+    const double x{static_cast<double>(i) / static_cast<double>(num_points - 1)};
+    const uint64_t rank{static_cast<uint64_t>(std::llround(std::pow(num_keys, x)))};
+    if (rank > prev_rank && rank < cardinality) {
+      curve.emplace_back(static_cast<double>(rank) / num_keys,
+                         std::min(accesses_of_top(static_cast<double>(rank)) / total, 1.));
+      prev_rank = rank;
+    }
+  }
+  curve.emplace_back(1, 1);
+  return curve;
+}
+
+KeyProfiler::KeyProfiler(const KeyProfilerParams& params) : params_{params} {
+  HCTR_THROW_IF(params_.format != DataReaderType_t::RawAsync &&
+                    params_.format != DataReaderType_t::Norm,
+                Error_t::WrongInput, "Only RawAsync and Norm datasets can be profiled.");
+  HCTR_THROW_IF(params_.block_size_bytes == 0, Error_t::WrongInput,
+                "Block size must be positive.");
+  if (params_.format == DataReaderType_t::RawAsync) {
+    HCTR_THROW_IF(params_.nnz_array.empty(), Error_t::WrongInput,
+                  "RawAsync datasets require the number of keys per slot.");
+    for (const int nnz : params_.nnz_array) {
+      HCTR_THROW_IF(nnz < 0, Error_t::WrongInput, "Keys per slot must not be negative.");
+    }
+    HCTR_THROW_IF(params_.label_dim + params_.dense_dim == 0 &&
+                      std::accumulate(params_.nnz_array.begin(), params_.nnz_array.end(), 0) == 0,
+                  Error_t::WrongInput, "Samples must not be empty.");
+    init_slots_(params_.nnz_array.size());
+  }
+}
+
+KeyProfiler::~KeyProfiler() = default;
+
+void KeyProfiler::init_slots_(const size_t num_slots) {
+  if (!slots_.empty()) {
+    HCTR_THROW_IF(slots_.size() != num_slots, Error_t::WrongInput, "Expected ", slots_.size(),
+                  " slots, but the file has ", num_slots, ".");
+    return;
+  }
+  for (size_t i{0}; i < num_slots; ++i) {
+    slots_.emplace_back(std::make_unique<Slot>());
+  }
+}
+
+void KeyProfiler::profile(const std::string& file_name) {
+  const MappedFile file{file_name};
+  if (params_.format == DataReaderType_t::RawAsync) {
+    profile_raw_async_(file.data(), file.size(), file_name);
+  } else {
+    profile_norm_(file.data(), file.size(), file_name);
+  }
+}
+
+std::vector<KeyProfile> KeyProfiler::result() const {
+  const std::shared_lock lock(mode_guard_);
+  std::vector<KeyProfile> profiles;
+  for (const auto& slot : slots_) {
+    profiles.push_back(slot->result(sketch_mode_));
+  }
+  return profiles;
+}
+
+void KeyProfiler::run_(
+    const std::function<bool(std::vector<std::vector<uint64_t>>&)>& next_block) {
+  const size_t num_threads{std::max(params_.num_threads, size_t{1})};
+
+  std::atomic<bool> failed{false};
+  std::exception_ptr error;
+  std::mutex error_guard;
+  std::vector<std::thread> workers;
+  workers.reserve(num_threads);
+  for (size_t i{0}; i < num_threads; ++i) {
+    workers.emplace_back([&]() {
+      std::vector<std::vector<uint64_t>> keys(slots_.size());
+      std::vector<std::vector<uint64_t>> scratch;
+      try {
+        while (!failed) {
+          for (std::vector<uint64_t>& slot_keys : keys) {
+            slot_keys.clear();
+          }
+          if (!next_block(keys)) {
+            break;
+          }
+          insert_(keys, scratch);
+        }
+      } catch (...) {
+        const std::lock_guard lock(error_guard);
+        if (!error) {
+          error = std::current_exception();
+        }
+        failed = true;
+      }
+    });
+  }
+  for (auto& worker : workers) {
+    worker.join();
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
+void KeyProfiler::insert_(const std::vector<std::vector<uint64_t>>& keys,
+                          std::vector<std::vector<uint64_t>>& scratch) {
+  std::shared_lock lock(mode_guard_);
+  if (sketch_mode_) {
+    std::vector<std::pair<uint64_t, uint64_t>> admissions;
+    for (size_t i{0}; i < slots_.size(); ++i) {
+      slots_[i]->record(keys[i], admissions);
+    }
+    return;
+  }
+
+  size_t num_added{0};
+  for (size_t i{0}; i < slots_.size(); ++i) {
+    num_added += slots_[i]->insert(keys[i], scratch);
+  }
+  const size_t num_entries{num_exact_entries_.fetch_add(num_added) + num_added};
+  lock.unlock();
+
+  if (num_entries * exact_entry_bytes > params_.max_exact_bytes) {
+    switch_to_sketch_();
+  }
+}
+
+void KeyProfiler::switch_to_sketch_() {
+  const std::unique_lock lock(mode_guard_);
+  if (sketch_mode_) {
+    return;
+  }
+  HCTR_LOG_S(INFO, WORLD) << "Exact key counts exceed " << params_.max_exact_bytes
+                          << " bytes. Switching to count-min sketches." << std::endl;
+  for (const auto& slot : slots_) {
+    slot->to_sketch(params_);
+  }
+  num_exact_entries_ = 0;
+  sketch_mode_ = true;
+}
+
+void KeyProfiler::profile_raw_async_(const char* const data, const size_t size,
+                                     const std::string& file_name) {
+  const size_t key_size{params_.i64_input_key ? sizeof(int64_t) : sizeof(uint32_t)};
+  const size_t total_nnz{static_cast<size_t>(
+      std::accumulate(params_.nnz_array.begin(), params_.nnz_array.end(), 0))};
+  const size_t dense_bytes{(params_.label_dim + params_.dense_dim) * sizeof(float)};
+  const size_t sample_size{dense_bytes + total_nnz * key_size};
+  HCTR_THROW_IF(size % sample_size != 0, Error_t::BrokenFile, "The size of \"", file_name,
+                "\" (", size, " bytes) is not a multiple of the sample size (", sample_size,
+                " bytes).");
+
+  const size_t num_samples{size / sample_size};
+  const size_t samples_per_block{std::max(params_.block_size_bytes / sample_size, size_t{1})};
+  std::atomic<size_t> next_sample{0};
+  run_([&](std::vector<std::vector<uint64_t>>& keys) {
+    const size_t begin{next_sample.fetch_add(samples_per_block, std::memory_order_relaxed)};
+    if (begin >= num_samples) {
+      return false;
+    }
+    const size_t end{std::min(begin + samples_per_block, num_samples)};
+    for (size_t slot{0}; slot < keys.size(); ++slot) {
+      keys[slot].reserve((end - begin) * static_cast<size_t>(params_.nnz_array[slot]));
+    }
+
+    for (size_t sample{begin}; sample < end; ++sample) {
+      const char* ptr{data + sample * sample_size + dense_bytes};
+      for (size_t slot{0}; slot < keys.size(); ++slot) {
+        std::vector<uint64_t>& slot_keys{keys[slot]};
+        const int nnz{params_.nnz_array[slot]};
+        if (params_.i64_input_key) {
+          for (int i{0}; i < nnz; ++i, ptr += sizeof(int64_t)) {
+            slot_keys.push_back(static_cast<uint64_t>(load<int64_t>(ptr)));
+          }
+        } else {
+          for (int i{0}; i < nnz; ++i, ptr += sizeof(uint32_t)) {
+            slot_keys.push_back(load<uint32_t>(ptr));
+          }
+        }
+      }
+    }
+    return true;
+  });
+  num_samples_ += num_samples;
+}
+
+void KeyProfiler::profile_norm_(const char* const data, const size_t size,
+                                const std::string& file_name) {
+  // With checksums, the header and every sample are framed as [int length][payload][char sum].
+  HCTR_THROW_IF(size < sizeof(DataSetHeader), Error_t::BrokenFile, "\"", file_name,
+                "\" is too short for a Norm dataset.");
+  const bool framed{load<int>(data) == static_cast<int>(sizeof(DataSetHeader)) &&
+                    size >= sizeof(int) + sizeof(DataSetHeader) + 1 &&
+                    load<long long>(data + sizeof(int)) == 1};
+  const DataSetHeader header{load<DataSetHeader>(data + (framed ? sizeof(int) : 0))};
+  HCTR_THROW_IF(header.number_of_records < 0 || header.label_dim < 0 || header.dense_dim < 0 ||
+                    header.slot_num <= 0,
+                Error_t::BrokenFile, "\"", file_name, "\" has an invalid header.");
+  init_slots_(static_cast<size_t>(header.slot_num));
+
+  const size_t key_size{params_.i64_input_key ? sizeof(long long) : sizeof(unsigned int)};
+  const size_t dense_bytes{static_cast<size_t>(header.label_dim + header.dense_dim) *
+                           sizeof(float)};
+  const size_t num_slots{slots_.size()};
+
+  // Returns the end of the sample payload that starts at `pos`, or 0 if it is cut off.
+  const auto payload_end{[&](size_t pos, const size_t end) -> size_t {
+    pos += dense_bytes;
+    for (size_t slot{0}; slot < num_slots; ++slot) {
+      if (pos + sizeof(int) > end) {
+        return 0;
+      }
+      const int nnz{load<int>(data + pos)};
+      if (nnz < 0) {
+        return 0;
+      }
+      pos += sizeof(int) + static_cast<size_t>(nnz) * key_size;
+    }
+    return pos <= end ? pos : 0;
+  }};
+
+  // Threads take turns to find the sample boundaries of the next block.
+  std::mutex scan_guard;
+  size_t cursor{framed ? sizeof(int) + sizeof(DataSetHeader) + 1 : sizeof(DataSetHeader)};
+  size_t samples_left{static_cast<size_t>(header.number_of_records)};
+  const auto next_range{[&](size_t& begin, size_t& end, size_t& num_samples) {
+    const std::lock_guard lock(scan_guard);
+    begin = cursor;
+    num_samples = 0;
+    while (samples_left > 0 && cursor - begin < params_.block_size_bytes) {
+      size_t next{0};
+      if (framed) {
+        if (cursor + sizeof(int) <= size) {
+          next = cursor + sizeof(int) + static_cast<size_t>(load<int>(data + cursor)) + 1;
+        }
+      } else {
+        next = payload_end(cursor, size);
+      }
+      HCTR_THROW_IF(next == 0 || next > size, Error_t::BrokenFile, "\"", file_name,
+                    "\" ends within a sample.");
+      cursor = next;
+      --samples_left;
+      ++num_samples;
+    }
+    end = cursor;
+    return num_samples > 0;
+  }};
+
+  run_([&](std::vector<std::vector<uint64_t>>& keys) {
+    size_t pos;
+    size_t end;
+    size_t num_samples;
+    if (!next_range(pos, end, num_samples)) {
+      return false;
+    }
+    for (size_t sample{0}; sample < num_samples; ++sample) {
+      size_t sample_end{end};
+      if (framed) {
+        sample_end = pos + sizeof(int) + static_cast<size_t>(load<int>(data + pos));
+        pos += sizeof(int);
+        HCTR_THROW_IF(payload_end(pos, sample_end) != sample_end, Error_t::BrokenFile,
+                      "A sample in \"", file_name, "\" does not match its length.");
+      }
+      pos += dense_bytes;
+      for (size_t slot{0}; slot < num_slots; ++slot) {
+        const size_t nnz{static_cast<size_t>(load<int>(data + pos))};
+        pos += sizeof(int);
+        std::vector<uint64_t>& slot_keys{keys[slot]};
+        if (params_.i64_input_key) {
+          for (size_t i{0}; i < nnz; ++i, pos += sizeof(long long)) {
+            slot_keys.push_back(static_cast<uint64_t>(load<long long>(data + pos)));
+          }
+        } else {
+          for (size_t i{0}; i < nnz; ++i, pos += sizeof(unsigned int)) {
+            slot_keys.push_back(load<unsigned int>(data + pos));
+          }
+        }
+      }
+      if (framed) {
+        pos = sample_end + 1;  // Skip the checksum.
+      }
+    }
+    return true;
+  });
+  HCTR_THROW_IF(samples_left > 0, Error_t::BrokenFile, "\"", file_name, "\" has fewer samples ",
+                "than its header states.");
+  num_samples_ += static_cast<uint64_t>(header.number_of_records);
+}
+
+}  // namespace HugeCTR
@@ -0,0 +1,285 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <data_readers/mapped_file_source.hpp>
+
+namespace HugeCTR {
+
+MappedFileSource::MappedFileSource(const long long offset, const long long stride,
+                                   const std::string& file_list, const bool repeat,
+                                   const bool use_mmap, const size_t read_size)
+    : file_list_(file_list),
+      file_name_("__empty.bin"),
+      offset_(offset),
+      stride_(stride),
+      repeat_(repeat),
+      use_mmap_(use_mmap),
+      read_size_(read_size) {
+  HCTR_CHECK_HINT(
+      file_list_.get_num_of_files() >= stride_,
+      "The number of data reader workers should be no greater than the number of files in the "
+      "file list. Please re-configure num_workers within DataReaderParams.");
+  HCTR_CHECK_HINT(read_size_ > 0, "read_size must be greater than 0.");
+}
+
+MappedFileSource::~MappedFileSource() { close_(); }
+
+void MappedFileSource::close_() noexcept {
+  mapped_.reset();
+  if (fd_ >= 0) {
+    close(fd_);
+    fd_ = -1;
+  }
+  file_size_ = 0;
+  file_offset_ = 0;
+  cur_ = end_ = nullptr;
+}
+
+Error_t MappedFileSource::next_source(long long expected_next_source_items) noexcept {
+  try {
+    close_();
+    const std::string file_name =
+        file_list_.get_a_file_with_id(offset_ + counter_ * stride_, repeat_);
+    file_name_ = file_name;
+    counter_++;  // counter_ should be accum for every source.
+    if (file_name.empty()) {
+      return Error_t::EndOfFile;
+    }
+
+    if (use_mmap_) {
+      mapped_ = std::make_unique<MappedFile>(file_name);
+      file_size_ = mapped_->size();
+      cur_ = mapped_->data();
+      end_ = cur_ + file_size_;
+      return Error_t::Success;
+    }
+
+    fd_ = open(file_name.c_str(), O_RDONLY);
+    struct stat file_stat;
+    if (fd_ < 0 || fstat(fd_, &file_stat) != 0) {
+      HCTR_LOG_S(ERROR, WORLD) << "Cannot open " << file_name << ": " << std::strerror(errno)
+                               << ' ' << HCTR_LOCATION() << std::endl;
+      close_();
+      return Error_t::FileCannotOpen;
+    }
+    file_size_ = static_cast<size_t>(file_stat.st_size);
+    posix_fadvise(fd_, 0, 0, POSIX_FADV_SEQUENTIAL);
+    cur_ = end_ = buffer_.data();
+    return Error_t::Success;
+  } catch (const core23::RuntimeError& rt_err) {
+    HCTR_LOG_S(ERROR, WORLD) << rt_err.what() << std::endl;
+    close_();
+    return rt_err.error;
+  } catch (const std::runtime_error& rt_err) {
+    HCTR_LOG_S(ERROR, WORLD) << rt_err.what() << std::endl;
+    return Error_t::UnspecificError;
+  }
+}
+
+bool MappedFileSource::fill_(const size_t num_bytes) {
+  const size_t num_available = end_ - cur_;
+  if (num_available >= num_bytes) {
+    return true;
+  }
+  if (mapped_ || file_offset_ >= file_size_) {
+    return false;
+  }
+
+  // Keep the unconsumed bytes, and append as much of the file as fits into the buffer.
+  if (buffer_.size() < std::max(read_size_, num_bytes)) {
+    std::vector<char> buffer(std::max({read_size_, num_bytes, buffer_.size() * 2}));
+    if (num_available > 0) {
+      std::memcpy(buffer.data(), cur_, num_available);
+    }
+    buffer_.swap(buffer);
+  } else if (num_available > 0) {
+    std::memmove(buffer_.data(), cur_, num_available);
+  }
+  cur_ = buffer_.data();
+  size_t size = num_available;
+
+  while (size < num_bytes && file_offset_ < file_size_) {
+    const size_t to_read = std::min(buffer_.size() - size, file_size_ - file_offset_);
+    const ssize_t n = pread(fd_, buffer_.data() + size, to_read, static_cast<off_t>(file_offset_));
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      HCTR_OWN_THROW(Error_t::BrokenFile, "pread failed: " + std::string(std::strerror(errno)));
+    }
+    if (n == 0) {
+      // The file was truncated since we opened it.
+      file_size_ = file_offset_;
+      break;
+    }
+    size += n;
+    file_offset_ += n;
+  }
+  end_ = cur_ + size;
+  return size >= num_bytes;
+}
+
+const char* MappedFileSource::peek(const size_t num_bytes) noexcept {
+  try {
+    if (!is_open() || !fill_(num_bytes)) {
+      return nullptr;
+    }
+    return cur_;
+  } catch (const std::runtime_error& rt_err) {
+    HCTR_LOG_S(ERROR, WORLD) << rt_err.what() << std::endl;
+    return nullptr;
+  }
+}
+
+void MappedFileSource::consume(const size_t num_bytes) noexcept {
+  HCTR_CHECK_HINT(num_bytes <= static_cast<size_t>(end_ - cur_),
+                  "Cannot consume bytes that have not been peeked at.");
+  cur_ += num_bytes;
+}
+
+Error_t MappedFileSource::read(char* const ptr, const size_t bytes_to_read) noexcept {
+  if (!is_open()) {
+    return Error_t::FileCannotOpen;
+  }
+  if (bytes_to_read == 0) {
+    return Error_t::Success;
+  }
+
+  // Large reads do not need to go through the buffer.
+  if (!mapped_ && cur_ == end_ && bytes_to_read >= read_size_) {
+    size_t size = 0;
+    while (size < bytes_to_read) {
+      const ssize_t n =
+          pread(fd_, ptr + size, bytes_to_read - size, static_cast<off_t>(file_offset_));
+      if (n < 0 && errno == EINTR) {
+        continue;
+      }
+      if (n < 0) {
+        HCTR_LOG_S(ERROR, WORLD) << "pread failed: " << std::strerror(errno) << std::endl;
+        return Error_t::UnspecificError;
+      }
+      if (n == 0) {
+        return Error_t::OutOfBound;
+      }
+      size += n;
+      file_offset_ += n;
+    }
+    return Error_t::Success;
+  }
+
+  const char* const src = peek(bytes_to_read);
+  if (!src) {
+    return Error_t::OutOfBound;
+  }
+  std::memcpy(ptr, src, bytes_to_read);
+  consume(bytes_to_read);
+  return Error_t::Success;
+}
+
+char compute_check_sum(const char* data, size_t size) {
+  // Bytes are summed in parallel within 64-bit words, using four 16-bit lanes. Each word adds up
+  // to 2 * 255 to a lane, so the lanes are folded every 128 words, before they can overflow into
+  // their neighbors.
+  constexpr uint64_t mask = 0x00FF00FF00FF00FFull;
+  constexpr size_t max_words = 128;
+
+  uint64_t sum = 0;
+  while (size >= sizeof(uint64_t)) {
+    const size_t num_words = std::min(size / sizeof(uint64_t), max_words);
+    uint64_t lanes = 0;
+    for (size_t i = 0; i < num_words; ++i) {
+      uint64_t word;
+      std::memcpy(&word, data + i * sizeof(uint64_t), sizeof(uint64_t));
+      lanes += (word & mask) + ((word >> 8) & mask);
+    }
+    sum += (lanes & 0xFFFF) + ((lanes >> 16) & 0xFFFF) + ((lanes >> 32) & 0xFFFF) + (lanes >> 48);
+    data += num_words * sizeof(uint64_t);
+    size -= num_words * sizeof(uint64_t);
+  }
+  for (size_t i = 0; i < size; ++i) {
+    sum += static_cast<unsigned char>(data[i]);
+  }
+  return static_cast<char>(sum);
+}
+
+Error_t BlockCheckSum::read_block(const size_t max_samples, std::vector<Sample>& samples) {
+  samples.clear();
+  offsets_.clear();
+
+  // Find the sample boundaries first. Offsets are relative to the current position, because the
+  // source may move its buffer while we peek further ahead.
+  size_t block_size = 0;
+  while (offsets_.size() < max_samples) {
+    const char* ptr = src_.peek(block_size + sizeof(int));
+    if (!ptr) {
+      if (src_.peek(block_size + 1)) {
+        return Error_t::BrokenFile;
+      }
+      break;
+    }
+    int length;
+    std::memcpy(&length, ptr + block_size, sizeof(int));
+    if (length < 0) {
+      return Error_t::BrokenFile;
+    }
+    const size_t sample_size = sizeof(int) + static_cast<size_t>(length) + sizeof(char);
+    if (!src_.peek(block_size + sample_size)) {
+      return Error_t::BrokenFile;
+    }
+    offsets_.push_back(block_size);
+    block_size += sample_size;
+  }
+  if (offsets_.empty()) {
+    return Error_t::EndOfFile;
+  }
+
+  // Then verify the whole block at once.
+  const char* const block = src_.peek(block_size);
+  Error_t err = Error_t::Success;
+  samples.resize(offsets_.size());
+  for (size_t i = 0; i < offsets_.size(); ++i) {
+    const char* const sample = block + offsets_[i];
+    int length;
+    std::memcpy(&length, sample, sizeof(int));
+    samples[i] = {sample + sizeof(int), static_cast<size_t>(length)};
+    if (compute_check_sum(samples[i].data, samples[i].size) != samples[i].data[length]) {
+      err = Error_t::DataCheckError;
+    }
+  }
+  src_.consume(block_size);
+  return err;
+}
+
+Error_t BlockCheckSum::next_source(long long expected_next_source_items) {
+  for (int i = MAX_TRY_; i > 0; i--) {
+    const Error_t flag_eof = src_.next_source(expected_next_source_items);
+    if (flag_eof == Error_t::Success || flag_eof == Error_t::EndOfFile) {
+      return flag_eof;
+    }
+  }
+  HCTR_OWN_THROW(Error_t::FileCannotOpen, "src_.next_source() == Error_t::Success failed");
+  return Error_t::FileCannotOpen;  // to elimate compile error
+}
+
+}  // namespace HugeCTR
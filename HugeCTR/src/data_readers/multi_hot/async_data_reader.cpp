@@ -16,6 +16,7 @@
 
 #include <common.hpp>
 #include <core23/tensor.hpp>
+#include <core23/tracer.hpp>
 #include <data_reader.hpp>
 #include <data_readers/multi_hot/async_data_reader.hpp>
 #include <data_readers/multi_hot/async_reader_common.hpp>
@@ -32,7 +33,8 @@ AsyncDataReader<SparseType>::AsyncDataReader(
     std::vector<FileSource> data_files, const std::shared_ptr<ResourceManager>& resource_manager,
     size_t batch_size, size_t num_threads_per_file, size_t num_batches_per_thread,
     const std::vector<DataReaderSparseParam>& params, size_t label_dim, size_t dense_dim,
-    bool mixed_precision, bool shuffle, bool schedule_uploads, bool is_dense_float)
+    bool mixed_precision, bool shuffle, bool schedule_uploads, bool is_dense_float,
+    const IOAutotunerParams& autotuner_params, const HostCacheParams& cache_params)
     : resource_manager_(resource_manager),
       mixed_precision_(mixed_precision),
       batch_size_(batch_size),
@@ -79,7 +81,7 @@ AsyncDataReader<SparseType>::AsyncDataReader(
 
   reader_impl_.reset(new DataReaderImpl(data_files, resource_manager, batch_size,
                                         num_threads_per_file, num_batches_per_thread, shuffle,
-                                        schedule_uploads));
+                                        schedule_uploads, autotuner_params, cache_params));
 
   for (size_t i = 0; i < resource_manager_->get_local_gpu_count(); i++) {
     auto local_gpu = resource_manager_->get_local_gpu(i);
@@ -251,6 +253,7 @@ void AsyncDataReader<SparseType>::init_batch_tensors(size_t num_inflight) {
 
 template <typename SparseType>
 long long AsyncDataReader<SparseType>::read_a_batch_to_device_delay_release() {
+  HCTR_TRACE_SCOPE("AsyncDataReader::read_a_batch");
   const DataReaderImpl::Batch& batch = reader_impl_->get_batch();
 
   const size_t slot_id = 0;  // TODO: multi-hot
@@ -523,7 +526,8 @@ void AsyncDataReader<SparseType>::create_drwg_parquet(std::string file_list,
                                                       const std::vector<long long> slot_offset,
                                                       bool start_reading_from_beginning,
                                                       long long max_samples_per_group,
-                                                      int label_dense_num, int label_dense_dim) {}
+                                                      int label_dense_num, int label_dense_dim,
+                                                      size_t cpu_decoder_threads) {}
 #endif
 template <typename SparseType>
 void AsyncDataReader<SparseType>::set_source(std::string file_list) {}
@@ -18,55 +18,122 @@
 #include <numa.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <common.hpp>
 #include <data_readers/multi_hot/detail/aio_context.hpp>
 #include <data_readers/multi_hot/detail/batch_file_reader.hpp>
+#include <stdexcept>
+#include <string>
 
 namespace HugeCTR {
 
 BatchFileReader::BatchFileReader(const std::string& fname, size_t slot, size_t max_batches_inflight,
                                  std::unique_ptr<IBatchLocations> batch_locations)
+    : BatchFileReader(std::vector<std::string>{fname}, 0, slot, max_batches_inflight,
+                      std::move(batch_locations)) {}
+
+BatchFileReader::BatchFileReader(const std::vector<std::string>& stripes, size_t stripe_size_bytes,
+                                 size_t slot, size_t max_batches_inflight,
+                                 std::unique_ptr<IBatchLocations> batch_locations,
+                                 const IOContextFactory& io_context_factory)
     : slot_id_(slot)
       // having multiple IOs in-flight to the same location will break data reader
       ,
       max_batches_inflight_(std::min(max_batches_inflight, batch_locations->count())),
+      window_(max_batches_inflight_),
       free_batches_(max_batches_inflight_),
       batch_locations_(std::move(batch_locations)),
       batch_locations_iterator_(batch_locations_->begin()),
-      io_ctx_(new AIOContext(max_batches_inflight_)),
-      buf_size_(batch_locations_->get_batch_size_bytes() + io_ctx_->get_alignment()) {
-  tmp_completed_batches_.reserve(max_batches_inflight_);
-  empty_batches_.reserve(max_batches_inflight_);
+      devices_(stripes.size()),
+      stripe_size_bytes_(stripe_size_bytes),
+      decoded_batches_(max_batches_inflight_) {
+  if (stripes.empty()) {
+    throw std::invalid_argument("BatchFileReader needs at least one file");
+  }
 
-  for (size_t i = 0; i < max_batches_inflight_; ++i) {
-    uint8_t* data = (uint8_t*)numa_alloc_local(
-        buf_size_);  // aligned_alloc(io_ctx_->get_alignment(), buf_size);
-    HCTR_LIB_THROW(cudaHostRegister(data, buf_size_, 0));
+  const size_t batch_size_bytes = batch_locations_->get_batch_size_bytes();
 
-    batches_.emplace_back(this, data, slot);
+  // Upper bound of the sub-requests that one batch sends to each device. A read covers at most
+  // batch_size_bytes plus the misalignment, which is less than a stripe unit.
+  size_t ios_per_batch = 1;
+  if (devices_.size() > 1) {
+    if (stripe_size_bytes_ == 0) {
+      throw std::invalid_argument("Stripe size of a striped file must be nonzero");
+    }
+    const size_t max_units = batch_size_bytes / stripe_size_bytes_ + 3;
+    ios_per_batch = (max_units + devices_.size() - 1) / devices_.size();
   }
 
-  for (size_t i = 0; i < max_batches_inflight_; ++i) {
-    free_batches_.push(batches_.data() + i);
+  for (size_t i = 0; i < devices_.size(); ++i) {
+    const size_t io_depth = max_batches_inflight_ * ios_per_batch;
+    if (io_context_factory) {
+      devices_[i].io_ctx = io_context_factory(io_depth);
+    } else {
+      devices_[i].io_ctx.reset(new AIOContext(io_depth));
+    }
+    devices_[i].fd = open(stripes[i].c_str(), O_RDONLY | O_DIRECT);
+    if (devices_[i].fd == -1) {
+      throw std::runtime_error("No such file: " + stripes[i]);
+    };
   }
+  alignment_ = devices_[0].io_ctx->get_alignment();
+  if (devices_.size() > 1 && stripe_size_bytes_ % alignment_ != 0) {
+    throw std::invalid_argument("Stripe size must be a multiple of " + std::to_string(alignment_) +
+                                " bytes");
+  }
+  buf_size_ = batch_size_bytes + alignment_;
 
-  fd_ = open(fname.c_str(), O_RDONLY | O_DIRECT);
-  if (fd_ == -1) {
-    throw std::runtime_error("No such file: " + fname);
-  };
+  tmp_completed_batches_.reserve(max_batches_inflight_);
+  empty_batches_.reserve(max_batches_inflight_);
+  cached_batches_.reserve(max_batches_inflight_);
+  batches_.reserve(max_batches_inflight_);
+}
+
+BatchFileReader::BatchFileReader(const std::string& fname,
+                                 std::shared_ptr<const RawAsyncPackedIndex> packed_index,
+                                 ThreadPool& decoder, size_t slot, size_t max_batches_inflight,
+                                 std::unique_ptr<IBatchLocations> batch_locations,
+                                 const IOContextFactory& io_context_factory)
+    : BatchFileReader(std::vector<std::string>{fname}, 0, slot, max_batches_inflight,
+                      std::move(batch_locations), io_context_factory) {
+  if (!packed_index) {
+    throw std::invalid_argument("Packed file " + fname + " needs an index");
+  }
+  packed_index_ = std::move(packed_index);
+  codec_ = std::make_unique<RawAsyncPackedCodec>(packed_index_->layout);
+  decoder_ = &decoder;
+
+  // A batch overlaps at most one more block than it covers
+  const size_t block_size_bytes = packed_index_->block_size_bytes();
+  const size_t max_blocks =
+      (batch_locations_->get_batch_size_bytes() + block_size_bytes - 1) / block_size_bytes + 1;
+  buf_size_ = max_blocks * block_size_bytes;
+  packed_buf_size_ = packed_index_->max_span_bytes(max_blocks) + 2 * alignment_;
 }
 
 BatchFileReader::~BatchFileReader() {
-  // Call destructor on IO context to wait for in-flight IOs to complete first before we
+  // Call destructor on IO contexts to wait for in-flight IOs to complete first before we
   // free our buffers
-  io_ctx_.reset();
+  for (auto& device : devices_) {
+    device.io_ctx.reset();
+  }
+  while (num_decoding_ > 0) {
+    usleep(10);
+  }
 
   for (auto& batch : batches_) {
     cudaHostUnregister(batch.aligned_data);
     numa_free(batch.aligned_data, buf_size_);
     // free(batch.aligned_data);
+    if (batch.packed_data) {
+      numa_free(batch.packed_data, packed_buf_size_);
+    }
+  }
+  for (auto& device : devices_) {
+    if (device.fd != -1) {
+      close(device.fd);
+    }
   }
-  close(fd_);
 }
 
 // SLOT:  0 1 2 3 0 1 2 3
@@ -92,7 +159,14 @@ void BatchFileReader::submit_reads() {
       }
     }
 
-    if (free_batches_.try_pop(batch)) {
+    if (num_inflight_ >= window_.load(std::memory_order_relaxed)) {
+      break;  // queue depth full
+    }
+    if (!free_batches_.try_pop(batch)) {
+      batch = allocate_batch();
+    }
+
+    if (batch) {
       BatchDescriptor descriptor = *batch_locations_iterator_;
       batch_locations_iterator_++;
 
@@ -102,6 +176,7 @@ void BatchFileReader::submit_reads() {
       batch->batch_size_bytes = descriptor.batch_size_bytes;
       batch->batch_id = descriptor.id;
       batch->batch_i = descriptor.i;
+      batch->offset = descriptor.offset;
       batch->start_time = 0.f;
       batch->end_time = 0.f;
 
@@ -111,15 +186,69 @@ void BatchFileReader::submit_reads() {
       if (empty_batch) {
         batch->data = nullptr;  // no data to return
         empty_batches_.emplace_back(const_cast<const Batch*>(batch));
+      } else if (cache_ && cache_->load(cache_source_, descriptor.offset,
+                                        descriptor.shard_size_bytes, batch->aligned_data)) {
+        batch->data = batch->aligned_data;
+        batch->start_time = time_double();
+        batch->end_time = batch->start_time;
+        cached_batches_.emplace_back(const_cast<const Batch*>(batch));
+      } else if (packed_index_) {
+        // Read the encoded blocks that overlap the batch. They are decoded into the batch buffer
+        // starting at the first one.
+        const size_t block_size_bytes = packed_index_->block_size_bytes();
+        batch->first_block = descriptor.offset / block_size_bytes;
+        batch->end_block =
+            (descriptor.offset + descriptor.shard_size_bytes - 1) / block_size_bytes + 1;
+        if (batch->end_block > packed_index_->num_blocks()) {
+          throw std::out_of_range("Batch " + std::to_string(descriptor.id) +
+                                  " is beyond the end of the packed file");
+        }
+        batch->data =
+            batch->aligned_data + (descriptor.offset - batch->first_block * block_size_bytes);
+        batch->start_time = time_double();
+
+        const size_t packed_offset = packed_index_->offsets[batch->first_block];
+        batch->packed_misalignment = packed_offset % alignment_;
+        IORequest io_req{devices_[0].fd, batch->packed_data,
+                         packed_index_->offsets[batch->end_block] - packed_offset, packed_offset,
+                         (void*)batch};
+        devices_[0].io_ctx->submit(io_req);
+        devices_[0].num_inflight_ios++;
+        batch->pending_ios = 1;
       } else {
         // Our data will start further into the buffer if the offset is not aligned
-        size_t misalignment = descriptor.offset % io_ctx_->get_alignment();
+        size_t misalignment = descriptor.offset % alignment_;
         batch->data = batch->aligned_data + misalignment;
         batch->start_time = time_double();
 
-        IORequest io_req{fd_, batch->aligned_data, descriptor.shard_size_bytes, descriptor.offset,
-                         (void*)batch};
-        io_ctx_->submit(io_req);
+        if (devices_.size() == 1) {
+          IORequest io_req{devices_[0].fd, batch->aligned_data, descriptor.shard_size_bytes,
+                           descriptor.offset, (void*)batch};
+          devices_[0].io_ctx->submit(io_req);
+          devices_[0].num_inflight_ios++;
+          batch->pending_ios = 1;
+        } else {
+          // Split the read at stripe unit boundaries. As the units are aligned, only the last
+          // sub-request can have an unaligned size, so the reads fill the buffer exactly like a
+          // single read of the logical file would.
+          const size_t begin = descriptor.offset - misalignment;
+          const size_t end = descriptor.offset + descriptor.shard_size_bytes;
+          batch->pending_ios = 0;
+          for (size_t pos = begin; pos < end;) {
+            const size_t unit = pos / stripe_size_bytes_;
+            const size_t unit_end = std::min((unit + 1) * stripe_size_bytes_, end);
+            Device& device = devices_[unit % devices_.size()];
+
+            const size_t device_offset =
+                (unit / devices_.size()) * stripe_size_bytes_ + pos % stripe_size_bytes_;
+            IORequest io_req{device.fd, batch->aligned_data + (pos - begin), unit_end - pos,
+                             device_offset, (void*)batch};
+            device.io_ctx->submit(io_req);
+            device.num_inflight_ios++;
+            batch->pending_ios++;
+            pos = unit_end;
+          }
+        }
       }
     } else {
       break;  // queue depth full
@@ -128,26 +257,133 @@ void BatchFileReader::submit_reads() {
 }
 
 const std::vector<const BatchFileReader::Batch*>& BatchFileReader::collect(size_t timeout_us) {
-  std::vector<IOEvent> events = io_ctx_->collect(1, timeout_us);
-  auto time = time_double();
   tmp_completed_batches_.clear();
-  for (const auto& event : events) {
-    auto batch = reinterpret_cast<Batch*>(event.user_data);
-    batch->end_time = time;
-    tmp_completed_batches_.emplace_back(const_cast<const Batch*>(batch));
+  if (packed_index_) {
+    // Don't block on the device if all remaining batches are being decoded
+    collect_device(0, devices_[0].num_inflight_ios > 0 ? 1 : 0, timeout_us);
+    Batch* batch = nullptr;
+    while (decoded_batches_.try_pop(batch)) {
+      tmp_completed_batches_.emplace_back(const_cast<const Batch*>(batch));
+    }
+    // Failed batches are never queued, so check after draining to not miss a failure that
+    // happened meanwhile
+    std::lock_guard<std::mutex> lock(decode_error_mutex_);
+    if (decode_error_) {
+      std::rethrow_exception(decode_error_);
+    }
+  } else if (devices_.size() == 1) {
+    collect_device(0, 1, timeout_us);
+  } else {
+    // Drain every device without blocking, so that a slow device does not hold back batches
+    // whose sub-requests have all completed.
+    for (size_t i = 0; i < devices_.size(); ++i) {
+      if (devices_[i].num_inflight_ios > 0) {
+        collect_device(i, 0, 0);
+      }
+    }
+    if (tmp_completed_batches_.empty()) {
+      size_t device = next_device_;
+      for (size_t i = 0; i < devices_.size(); ++i) {
+        if (devices_[(next_device_ + i) % devices_.size()].num_inflight_ios > 0) {
+          device = (next_device_ + i) % devices_.size();
+          break;
+        }
+      }
+      next_device_ = (device + 1) % devices_.size();
+      collect_device(device, 1, timeout_us);
+    }
   }
   for (const auto batch : empty_batches_) {
     tmp_completed_batches_.emplace_back(batch);
   }
   empty_batches_.clear();
+  for (const auto batch : cached_batches_) {
+    tmp_completed_batches_.emplace_back(batch);
+  }
+  cached_batches_.clear();
   return tmp_completed_batches_;
 }
 
+void BatchFileReader::collect_device(size_t device, size_t min_reqs, size_t timeout_us) {
+  const std::vector<IOEvent>& events = devices_[device].io_ctx->collect(min_reqs, timeout_us);
+  devices_[device].num_inflight_ios -= events.size();
+  auto time = time_double();
+  for (const auto& event : events) {
+    auto batch = reinterpret_cast<Batch*>(event.user_data);
+    if (--batch->pending_ios == 0) {
+      if (packed_index_) {
+        num_decoding_++;
+        decoder_->submit([this, batch]() { decode_batch(batch); });
+      } else {
+        if (cache_) {
+          cache_->store(cache_source_, batch->offset, batch->data, batch->shard_size_bytes);
+        }
+        batch->end_time = time;
+        tmp_completed_batches_.emplace_back(const_cast<const Batch*>(batch));
+      }
+    }
+  }
+}
+
+void BatchFileReader::decode_batch(Batch* batch) {
+  try {
+    const auto& offsets = packed_index_->offsets;
+    const uint8_t* packed = batch->packed_data + batch->packed_misalignment;
+    uint8_t* data = batch->aligned_data;
+    for (size_t block = batch->first_block; block < batch->end_block; ++block) {
+      codec_->decode(packed + (offsets[block] - offsets[batch->first_block]),
+                     offsets[block + 1] - offsets[block], data, packed_index_->block_samples);
+      data += packed_index_->block_size_bytes();
+    }
+    if (cache_) {
+      cache_->store(cache_source_, batch->offset, batch->data, batch->shard_size_bytes);
+    }
+  } catch (...) {
+    {
+      std::lock_guard<std::mutex> lock(decode_error_mutex_);
+      decode_error_ = std::current_exception();
+    }
+    num_decoding_--;
+    return;
+  }
+  batch->end_time = time_double();
+  decoded_batches_.push(batch);
+  num_decoding_--;
+}
+
+BatchFileReader::Batch* BatchFileReader::allocate_batch() {
+  if (batches_.size() == batches_.capacity()) {
+    return nullptr;
+  }
+  // Allocated by the reader thread, so the buffer is local to its numa node
+  uint8_t* data = (uint8_t*)numa_alloc_local(
+      buf_size_);  // aligned_alloc(io_ctx_->get_alignment(), buf_size);
+  HCTR_LIB_THROW(cudaHostRegister(data, buf_size_, 0));
+
+  batches_.emplace_back(this, data, slot_id_);
+  if (packed_index_) {
+    batches_.back().packed_data = (uint8_t*)numa_alloc_local(packed_buf_size_);
+  }
+  return &batches_.back();
+}
+
 void BatchFileReader::release_batch(const BatchFileReader::Batch* batch) {
-  num_inflight_--;
+  // Push first, so that the reader never sees a free slot without a free batch and allocates one
   free_batches_.push(const_cast<BatchFileReader::Batch*>(batch));
+  num_inflight_--;
+}
+
+void BatchFileReader::set_cache(std::shared_ptr<HostBatchCache> cache, size_t source) {
+  cache_ = std::move(cache);
+  cache_source_ = source;
 }
 
 size_t BatchFileReader::get_queue_depth() const { return max_batches_inflight_; }
 
+void BatchFileReader::set_max_batches_inflight(size_t n) {
+  window_ = std::clamp<size_t>(n, 1, max_batches_inflight_);
+}
+
+size_t BatchFileReader::get_max_batches_inflight() const { return window_; }
+
 }  // namespace HugeCTR
\ No newline at end of file
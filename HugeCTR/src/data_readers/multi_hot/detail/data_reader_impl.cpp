@@ -15,8 +15,10 @@
  */
 
 #include <cassert>
+#include <core23/tracer.hpp>
 #include <data_readers/multi_hot/detail/data_reader_impl.hpp>
 #include <filesystem>
+#include <iomanip>
 #include <set>
 
 namespace HugeCTR {
@@ -25,24 +27,58 @@ namespace MultiHot {
 DataReaderImpl::DataReaderImpl(const std::vector<FileSource>& source_files,
                                const std::shared_ptr<ResourceManager>& resource_manager,
                                size_t batch_size, size_t num_reader_threads_per_device,
-                               size_t num_batches_per_thread, bool shuffle, bool schedule_uploads)
+                               size_t num_batches_per_thread, bool shuffle, bool schedule_uploads,
+                               const IOAutotunerParams& autotuner_params,
+                               const HostCacheParams& cache_params)
     : resource_manager_(resource_manager), schedule_uploads_(schedule_uploads) {
   const size_t local_gpu_count = resource_manager->get_local_gpu_count();
   const size_t global_gpu_count = resource_manager->get_global_gpu_count();
   const size_t num_slots = source_files.size();
 
+  if (cache_params.enabled) {
+    cache_ = std::make_shared<HostBatchCache>(cache_params);
+    HCTR_LOG_S(INFO, ROOT) << "Caching batches in host memory"
+                           << (cache_params.compress ? ", compressed" : "") << ", up to "
+                           << (cache_params.max_bytes > 0 ? std::to_string(cache_params.max_bytes)
+                                                          : std::string("unlimited"))
+                           << " bytes" << std::endl;
+  }
+
   for (auto source : source_files) {
     if (batch_size % global_gpu_count) {
       throw std::invalid_argument("Batch size not divisible by number of GPUs");
     }
 
-    std::unique_ptr<IBatchLocations> locations = configure_locations(source, batch_size, shuffle);
+    // Files written by pack_raw_async() are detected by their footer
+    std::shared_ptr<const RawAsyncPackedIndex> packed_index;
+    if (source.stripes.empty()) {
+      packed_index = RawAsyncPackedIndex::read(source.name);
+    }
+    if (packed_index) {
+      if (packed_index->layout.sample_size_bytes() != source.sample_size_bytes) {
+        throw std::invalid_argument("Packed file " + source.name + " has samples of " +
+                                    std::to_string(packed_index->layout.sample_size_bytes()) +
+                                    " bytes, expected " +
+                                    std::to_string(source.sample_size_bytes));
+      }
+      if (!decoder_) {
+        const size_t num_workers = std::max(1u, std::thread::hardware_concurrency() / 2);
+        decoder_ = std::make_unique<ThreadPool>("packed decoder", num_workers);
+        HCTR_LOG_S(INFO, ROOT) << "Decoding packed files on " << num_workers << " threads"
+                               << std::endl;
+      }
+    }
+
+    std::unique_ptr<IBatchLocations> locations =
+        configure_locations(source, packed_index.get(), batch_size, shuffle);
     if (num_batches_ == 0) {
       num_batches_ = locations->count();
     } else if (num_batches_ != locations->count()) {
       throw std::invalid_argument("files do not contain the same number of batches");
     }
 
+    const size_t cache_source = cache_ ? cache_->add_source(source.sample_size_bytes) : 0;
+
     // TODO: refactor this for dynamic pooling
     const size_t local_batch_size_bytes =
         (batch_size / global_gpu_count) * source.sample_size_bytes;
@@ -59,8 +95,20 @@ DataReaderImpl::DataReaderImpl(const std::vector<FileSource>& source_files,
           device_locations[global_gpu_id]->distribute(num_reader_threads_per_device);
 
       for (size_t thread = 0; thread < thread_locations.size(); ++thread) {
-        auto reader = new BatchFileReader(source.name, source.slot_id, num_batches_per_thread,
-                                          std::move(thread_locations[thread]));
+        BatchFileReader* reader = nullptr;
+        if (packed_index) {
+          reader = new BatchFileReader(source.name, packed_index, *decoder_, source.slot_id,
+                                       num_batches_per_thread, std::move(thread_locations[thread]));
+        } else if (source.stripes.empty()) {
+          reader = new BatchFileReader(source.name, source.slot_id, num_batches_per_thread,
+                                       std::move(thread_locations[thread]));
+        } else {
+          reader = new BatchFileReader(source.stripes, source.stripe_size_bytes, source.slot_id,
+                                       num_batches_per_thread, std::move(thread_locations[thread]));
+        }
+        if (cache_) {
+          reader->set_cache(cache_, cache_source);
+        }
         file_readers_[i].emplace_back(reader);
       }
     }
@@ -69,6 +117,42 @@ DataReaderImpl::DataReaderImpl(const std::vector<FileSource>& source_files,
   size_t num_inflight_batches =
       std::min(num_reader_threads_per_device * num_batches_per_thread, num_batches_);
 
+  if (autotuner_params.enabled) {
+    // Host memory that one more in-flight batch per thread costs across all readers
+    size_t window_bytes = 0;
+    size_t max_window = num_batches_per_thread;
+    for (const auto& entry : file_readers_) {
+      for (const auto& reader : entry.second) {
+        window_bytes += reader->get_buffer_size();
+        max_window = std::min(max_window, reader->get_queue_depth());
+      }
+    }
+    if (autotuner_params.max_window > 0) {
+      max_window = std::min(max_window, autotuner_params.max_window);
+    }
+    if (autotuner_params.max_inflight_bytes > 0 && window_bytes > 0) {
+      const size_t budget_window = autotuner_params.max_inflight_bytes / window_bytes;
+      if (budget_window < std::max<size_t>(autotuner_params.min_window, 1)) {
+        throw std::invalid_argument(
+            "IO autotuner: max_inflight_bytes fits " + std::to_string(budget_window) +
+            " in-flight batches per reader, but min_window is " +
+            std::to_string(autotuner_params.min_window) + " (" + std::to_string(window_bytes) +
+            " bytes each)");
+      }
+      max_window = std::min(max_window, budget_window);
+    }
+    autotuner_ = std::make_unique<IOAutotuner>(autotuner_params, autotuner_params.min_window,
+                                               max_window);
+    for (const auto& entry : file_readers_) {
+      for (const auto& reader : entry.second) {
+        reader->set_max_batches_inflight(autotuner_->window());
+      }
+    }
+    HCTR_LOG_S(INFO, ROOT) << "IO autotuner: in-flight batches per reader "
+                           << autotuner_->window() << ", at most " << autotuner_->max_window()
+                           << " (" << window_bytes << " bytes each)" << std::endl;
+  }
+
   // Init batches
   batch_buffers_.resize(num_inflight_batches);
   for (size_t i = 0; i < batch_buffers_.size(); ++i) {
@@ -146,10 +230,19 @@ DataReaderImpl::~DataReaderImpl() {
   // TODO: free GPU mem
 }
 
-std::unique_ptr<IBatchLocations> DataReaderImpl::configure_locations(FileSource source,
-                                                                     size_t batch_size,
-                                                                     bool shuffle) const {
-  const size_t file_size = std::filesystem::file_size(source.name);
+std::unique_ptr<IBatchLocations> DataReaderImpl::configure_locations(
+    FileSource source, const RawAsyncPackedIndex* packed_index, size_t batch_size,
+    bool shuffle) const {
+  size_t file_size = 0;
+  if (packed_index) {
+    file_size = packed_index->size_bytes();
+  } else if (source.stripes.empty()) {
+    file_size = std::filesystem::file_size(source.name);
+  } else {
+    for (const auto& stripe : source.stripes) {
+      file_size += std::filesystem::file_size(stripe);
+    }
+  }
   assert(file_size > 0);
 
   auto locations = std::make_unique<BatchLocations>(
@@ -185,15 +278,27 @@ const DataReaderImpl::Batch& DataReaderImpl::get_batch() {
 
   Batch* batch = batch_buffers_[buf_pos].get();
 
+  if (batch_i_ == 0) {
+    update_epoch_stats();
+  }
+
   // needs to be set to NOT_READY on calling thread, not callback thread, otherwise there will be
   // race condition where CPU runs ahead and the next batch could be ready to consume from the
   // previous iteration.
-  while (batch->state.load(std::memory_order_acquire) != BatchState::READY_TO_CONSUME) {
-    // spin
+  const double wait_start = autotuner_ ? time_double() : 0;
+  {
+    HCTR_TRACE_SCOPE("DataReaderImpl::wait_for_batch");
+    while (batch->state.load(std::memory_order_acquire) != BatchState::READY_TO_CONSUME) {
+      // spin
+    }
   }
+  const double wait_time = autotuner_ ? time_double() - wait_start : 0;
   batch->state = BatchState::NOT_READY;
 
-  compute_batch_stats(batch);
+  const double read_latency = compute_batch_stats(batch);
+  if (autotuner_) {
+    autotune(read_latency, wait_time);
+  }
 
   batch_i_ = (batch_i_ + 1) % num_batches_;
 
@@ -245,8 +350,10 @@ DataReaderImpl::Batch& DataReaderImpl::get_parent(size_t batch_i) {
 
 void DataReaderImpl::read_batches(BatchFileReader& file_reader, int device_id) {
   CudaCPUDeviceContext ctx(device_id);  // move thread to appropriate numa
+  Logger::set_thread_name("file reader #" + std::to_string(device_id));
 
   while (running_) {
+    HCTR_TRACE_SCOPE("DataReaderImpl::read_batches");
     const std::vector<const BatchFileReader::Batch*>& io_batches = file_reader.read_batches(10);
     for (const auto io_batch : io_batches) {
       Batch& batch = get_parent(io_batch->batch_i);
@@ -293,6 +400,7 @@ void DataReaderImpl::read_batches(BatchFileReader& file_reader, int device_id) {
 void DataReaderImpl::upload_batches(size_t device_id) {
   // move thread to correct numa
   CudaCPUDeviceContext ctx(resource_manager_->get_local_gpu(device_id)->get_device_id());
+  Logger::set_thread_name("uploader #" + std::to_string(device_id));
 
   // FIXME: Need to initialize in thread, otherwise cache coherency initialization problem.
   //  placement_barriers_[device_i].sem_[0] = 1;
@@ -311,6 +419,7 @@ void DataReaderImpl::upload_batches(size_t device_id) {
     // acquire so we guarantee all previous writes before memory_order_release of state are visible
     if (batch->state.load(std::memory_order_acquire) == BatchState::READY_TO_UPLOAD &&
         local_batch.num_transfers.raw.load(std::memory_order_relaxed) > 0) {
+      HCTR_TRACE_SCOPE("DataReaderImpl::upload_batch");
       // Schedule transfers at correct place in iteration
       if (schedule_uploads_) {
         while (pending_transfers_[device_id].raw == 0) {
@@ -370,7 +479,46 @@ void DataReaderImpl::release_batch_callback(cudaStream_t stream, cudaError_t sta
   }
 }
 
-void DataReaderImpl::compute_batch_stats(Batch* batch) {
+void DataReaderImpl::autotune(double read_latency, double wait_time) {
+  const double now = time_double();
+  // The first batch includes the startup, so only measure from the second
+  if (last_batch_time_ > 0 && autotuner_->record(read_latency, wait_time, now - last_batch_time_)) {
+    for (const auto& entry : file_readers_) {
+      for (const auto& reader : entry.second) {
+        reader->set_max_batches_inflight(autotuner_->window());
+      }
+    }
+  }
+  last_batch_time_ = now;
+}
+
+void DataReaderImpl::update_epoch_stats() {
+  const double now = time_double();
+  // The first epoch is measured from its first batch, so it doesn't include the startup
+  if (epoch_start_time_ > 0) {
+    io_stats.num_epochs++;
+    io_stats.epoch_time = now - epoch_start_time_;
+    if (cache_) {
+      // Lookups happen when batches are submitted, so they run ahead by the in-flight batches
+      const HostBatchCache::Stats stats = cache_->get_stats();
+      HostBatchCache::Stats epoch_stats;
+      epoch_stats.hits = stats.hits - last_cache_stats_.hits;
+      epoch_stats.misses = stats.misses - last_cache_stats_.misses;
+      io_stats.cache_hit_ratio = epoch_stats.hit_ratio();
+      last_cache_stats_ = stats;
+
+      HCTR_LOG_S(INFO, ROOT) << "Epoch " << io_stats.num_epochs << ": " << std::fixed
+                             << std::setprecision(3) << io_stats.epoch_time
+                             << " s, cache hit ratio " << std::setprecision(1)
+                             << io_stats.cache_hit_ratio * 100 << "%, " << stats.num_slabs
+                             << " slabs cached in " << stats.num_bytes << " bytes ("
+                             << stats.num_raw_bytes << " uncompressed)" << std::endl;
+    }
+  }
+  epoch_start_time_ = now;
+}
+
+double DataReaderImpl::compute_batch_stats(Batch* batch) {
   static uint64_t n = 0;
   static double batch_avg = 0.f;
   n++;
@@ -393,6 +541,7 @@ void DataReaderImpl::compute_batch_stats(Batch* batch) {
   io_stats.batch_min_latency = n == 1 ? latency : std::min(io_stats.batch_min_latency, latency);
   io_stats.batch_max_latency = n == 1 ? latency : std::max(io_stats.batch_max_latency, latency);
   io_stats.batch_avg_latency = batch_avg;
+  return latency;
 }
 
 }  // namespace MultiHot
@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <common.hpp>
+#include <cstring>
+#include <data_readers/multi_hot/detail/host_batch_cache.hpp>
+#include <mutex>
+
+namespace HugeCTR {
+
+HostBatchCache::HostBatchCache(const HostCacheParams& params) : params_(params) {}
+
+size_t HostBatchCache::add_source(size_t sample_size_bytes) {
+  HCTR_THROW_IF(sample_size_bytes == 0, Error_t::WrongInput, "Samples are empty");
+  std::unique_lock<std::shared_mutex> lock(mutex_);
+  Source source;
+  source.sample_size_bytes = sample_size_bytes;
+  if (params_.compress && sample_size_bytes % 4 == 0) {
+    source.codec = std::make_unique<RawAsyncPackedCodec>(
+        RawAsyncPackedLayout{sample_size_bytes / 4, 0, 4});
+  }
+  sources_.emplace_back(std::move(source));
+  return sources_.size() - 1;
+}
+
+bool HostBatchCache::load(size_t source, size_t offset, size_t size, uint8_t* data) {
+  std::shared_lock<std::shared_mutex> lock(mutex_);
+  const Source& src = sources_.at(source);
+  const auto it = src.slabs.find(offset);
+  if (it == src.slabs.end()) {
+    misses_++;
+    return false;
+  }
+
+  const Slab& slab = it->second;
+  if (slab.compressed) {
+    const size_t num_samples = size / src.sample_size_bytes;
+    HCTR_THROW_IF(src.codec->decode(slab.data.get(), slab.size, data, num_samples) != num_samples,
+                  Error_t::UnspecificError, "Cached slab at offset ", offset, " of source ",
+                  source, " has fewer than ", num_samples, " samples");
+  } else {
+    HCTR_THROW_IF(slab.size != size, Error_t::UnspecificError, "Cached slab at offset ", offset,
+                  " of source ", source, " has ", slab.size, " bytes, expected ", size);
+    std::memcpy(data, slab.data.get(), size);
+  }
+  hits_++;
+  return true;
+}
+
+bool HostBatchCache::store(size_t source, size_t offset, const uint8_t* data, size_t size) {
+  if (full_) {
+    return false;
+  }
+
+  // Sources are only added before reading, so they can be accessed without the lock
+  const Source& src = sources_.at(source);
+  Slab slab;
+  if (src.codec && size % src.sample_size_bytes == 0) {
+    const size_t num_samples = size / src.sample_size_bytes;
+    thread_local std::vector<uint8_t> encoded;
+    encoded.resize(src.codec->max_encoded_size(num_samples));
+    slab.size = src.codec->encode(data, num_samples, encoded.data());
+    slab.compressed = true;
+    if (!reserve(slab.size)) {
+      return false;
+    }
+    slab.data.reset(new uint8_t[slab.size]);
+    std::memcpy(slab.data.get(), encoded.data(), slab.size);
+  } else {
+    slab.size = size;
+    if (!reserve(slab.size)) {
+      return false;
+    }
+    slab.data.reset(new uint8_t[slab.size]);
+    std::memcpy(slab.data.get(), data, size);
+  }
+
+  const size_t stored_size = slab.size;
+  std::unique_lock<std::shared_mutex> lock(mutex_);
+  if (!sources_[source].slabs.emplace(offset, std::move(slab)).second) {
+    num_bytes_ -= stored_size;
+    return false;
+  }
+  num_slabs_++;
+  num_raw_bytes_ += size;
+  return true;
+}
+
+bool HostBatchCache::reserve(size_t size) {
+  size_t num_bytes = num_bytes_.load();
+  do {
+    if (params_.max_bytes > 0 && num_bytes + size > params_.max_bytes) {
+      full_ = true;
+      return false;
+    }
+  } while (!num_bytes_.compare_exchange_weak(num_bytes, num_bytes + size));
+  return true;
+}
+
+HostBatchCache::Stats HostBatchCache::get_stats() const {
+  Stats stats;
+  stats.hits = hits_;
+  stats.misses = misses_;
+  stats.num_slabs = num_slabs_;
+  stats.num_bytes = num_bytes_;
+  stats.num_raw_bytes = num_raw_bytes_;
+  return stats;
+}
+
+}  // namespace HugeCTR
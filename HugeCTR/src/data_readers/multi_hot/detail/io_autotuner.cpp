@@ -0,0 +1,138 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <common.hpp>
+#include <data_readers/multi_hot/detail/io_autotuner.hpp>
+#include <iomanip>
+
+namespace HugeCTR {
+
+namespace {
+
+const char* decision_name(IOAutotuner::Decision decision) {
+  switch (decision) {
+    case IOAutotuner::Decision::SlowStart:
+      return "slow start";
+    case IOAutotuner::Decision::Increase:
+      return "increase";
+    case IOAutotuner::Decision::Revert:
+      return "revert, no throughput gain";
+    case IOAutotuner::Decision::Decrease:
+      return "decrease, congested";
+    default:
+      return "hold";
+  }
+}
+
+}  // namespace
+
+IOAutotuner::IOAutotuner(const IOAutotunerParams& params, size_t initial_window,
+                         size_t max_window)
+    : params_(params),
+      max_window_(std::max(max_window, std::max<size_t>(params.min_window, 1))),
+      window_(std::clamp(initial_window, std::max<size_t>(params.min_window, 1), max_window_)),
+      ssthresh_(max_window_) {
+  HCTR_THROW_IF(params_.interval_batches == 0, Error_t::WrongInput,
+                "IO autotuner interval must be nonzero");
+  HCTR_THROW_IF(params_.decrease_factor <= 0 || params_.decrease_factor >= 1, Error_t::WrongInput,
+                "IO autotuner decrease factor must be in (0, 1)");
+}
+
+bool IOAutotuner::record(double read_latency_s, double wait_s, double step_s) {
+  num_batches_++;
+  latency_sum_ += read_latency_s;
+  wait_sum_ += wait_s;
+  step_sum_ += step_s;
+  if (num_batches_ < params_.interval_batches) {
+    return false;
+  }
+
+  const double latency = latency_sum_ / num_batches_;
+  const double wait_fraction = step_sum_ > 0 ? wait_sum_ / step_sum_ : 0;
+  const double throughput = step_sum_ > 0 ? num_batches_ / step_sum_ : 0;
+  num_batches_ = 0;
+  latency_sum_ = 0;
+  wait_sum_ = 0;
+  step_sum_ = 0;
+
+  const size_t old_window = window_;
+  last_decision_ = decide(latency, wait_fraction, throughput);
+  if (window_ == old_window) {
+    return false;
+  }
+
+  HCTR_LOG_S(INFO, ROOT) << "IO autotuner: in-flight batches per reader " << old_window << " -> "
+                         << window_ << " (" << decision_name(last_decision_) << "), consumer wait "
+                         << std::fixed << std::setprecision(1) << wait_fraction * 100
+                         << "%, read latency " << std::setprecision(3) << latency * 1e3
+                         << " ms (base " << base_latency_ * 1e3 << " ms), "
+                         << std::setprecision(1) << throughput << " batches/s" << std::endl;
+  return true;
+}
+
+IOAutotuner::Decision IOAutotuner::decide(double latency, double wait_fraction,
+                                          double throughput) {
+  base_latency_ = base_latency_ > 0 ? std::min(base_latency_, latency) : latency;
+  const bool starving = wait_fraction > params_.starvation_threshold;
+  const bool congested = latency > params_.latency_tolerance * base_latency_;
+  const bool increased =
+      last_decision_ == Decision::SlowStart || last_decision_ == Decision::Increase;
+  const double prev_throughput = prev_throughput_;
+  prev_throughput_ = throughput;
+
+  if (hold_ > 0) {
+    hold_--;
+    return Decision::Hold;
+  }
+
+  const size_t min_window = std::max<size_t>(params_.min_window, 1);
+  if (increased) {
+    if (starving && throughput < prev_throughput * (1 + params_.min_gain)) {
+      window_ = prev_window_;
+      ssthresh_ = window_;
+      slow_start_ = false;
+      // Probe less often every time the device turns out to be saturated at the same window
+      hold_ = params_.hold_intervals * backoff_;
+      backoff_ = std::min<size_t>(backoff_ * 2, 64);
+      return Decision::Revert;
+    }
+    backoff_ = 1;
+  }
+
+  if (starving && window_ < max_window_) {
+    prev_window_ = window_;
+    if (slow_start_ && window_ < ssthresh_) {
+      window_ = std::min(window_ * 2, ssthresh_);
+      return Decision::SlowStart;
+    }
+    slow_start_ = false;
+    window_++;
+    return Decision::Increase;
+  }
+
+  if (!starving && congested && window_ > min_window) {
+    window_ = std::max(min_window, static_cast<size_t>(window_ * params_.decrease_factor));
+    ssthresh_ = window_;
+    slow_start_ = false;
+    hold_ = params_.hold_intervals;
+    return Decision::Decrease;
+  }
+
+  return Decision::Hold;
+}
+
+}  // namespace HugeCTR
@@ -0,0 +1,458 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <arrow/api.h>
+#include <parquet/arrow/reader.h>
+#include <parquet/arrow/schema.h>
+#include <parquet/file_reader.h>
+
+#include <algorithm>
+#include <cstring>
+#include <data_readers/parquet_cpu_decoder.hpp>
+#include <general_buffer2.hpp>
+#include <limits>
+
+namespace HugeCTR {
+
+namespace {
+
+void check_status(const arrow::Status& status, const std::string& file_name) {
+  HCTR_THROW_IF(!status.ok(), Error_t::BrokenFile, "Cannot decode ", file_name, ": ",
+                status.ToString());
+}
+
+/**
+ * Flattened view of one column chunk. Scalar columns have one value per row and no offsets.
+ */
+struct ColumnView {
+  arrow::Type::type type_id;
+  int bit_width;
+  const uint8_t* values;
+  const int32_t* offsets;
+  size_t num_values;
+};
+
+ColumnView make_column_view(const arrow::Array& array, const std::string& name) {
+  HCTR_THROW_IF(array.null_count() != 0, Error_t::WrongInput, "Parquet column ", name,
+                " contains nulls.");
+
+  const arrow::Array* values{&array};
+  const int32_t* offsets{nullptr};
+  if (array.type_id() == arrow::Type::LIST) {
+    const auto& list{static_cast<const arrow::ListArray&>(array)};
+    values = list.values().get();
+    offsets = list.raw_value_offsets();
+    HCTR_THROW_IF(values->null_count() != 0, Error_t::WrongInput, "Parquet column ", name,
+                  " contains nulls.");
+  }
+
+  const auto* const type{dynamic_cast<const arrow::FixedWidthType*>(values->type().get())};
+  HCTR_THROW_IF(!type || values->type_id() == arrow::Type::BOOL, Error_t::WrongInput,
+                "Parquet column ", name, " has unsupported type ", array.type()->ToString(), ".");
+
+  const int bit_width{type->bit_width()};
+  return {values->type_id(), bit_width,
+          values->data()->GetValues<uint8_t>(1, 0) + values->offset() * (bit_width / 8), offsets,
+          static_cast<size_t>(values->length())};
+}
+
+inline bool is_key_type(const arrow::Type::type type_id) {
+  switch (type_id) {
+    case arrow::Type::INT32:
+    case arrow::Type::UINT32:
+    case arrow::Type::INT64:
+    case arrow::Type::UINT64:
+      return true;
+    default:
+      return false;
+  }
+}
+
+template <typename T>
+std::vector<T> convert_slot_offset(const std::vector<long long>& slot_offset) {
+  std::vector<T> result;
+  result.reserve(slot_offset.size());
+  for (const long long c : slot_offset) {
+    HCTR_THROW_IF(c < static_cast<long long>(std::numeric_limits<T>::min()) ||
+                      static_cast<unsigned long long>(c) >
+                          static_cast<unsigned long long>(std::numeric_limits<T>::max()),
+                  Error_t::DataCheckError, "Slot offset value exceed the key type range");
+    result.push_back(static_cast<T>(c));
+  }
+  return result;
+}
+
+std::vector<std::string> sorted_names(std::vector<Cols> cols) {
+  std::stable_sort(cols.begin(), cols.end(),
+                   [](const Cols& a, const Cols& b) { return a.index < b.index; });
+  std::vector<std::string> names;
+  names.reserve(cols.size());
+  for (const Cols& col : cols) {
+    names.push_back(col.col_name);
+  }
+  return names;
+}
+
+}  // namespace
+
+template <typename T>
+ParquetHostBuffer<T>& ParquetHostBuffer<T>::operator=(ParquetHostBuffer&& other) noexcept {
+  if (this != &other) {
+    release_();
+    pinned_ = other.pinned_;
+    data_ = other.data_;
+    capacity_ = other.capacity_;
+    other.data_ = nullptr;
+    other.capacity_ = 0;
+  }
+  return *this;
+}
+
+template <typename T>
+void ParquetHostBuffer<T>::reserve(const size_t n) {
+  if (n <= capacity_) {
+    return;
+  }
+
+  // Row groups differ slightly in size. Grow geometrically to settle quickly.
+  const size_t capacity{std::max(n, capacity_ + capacity_ / 2)};
+  release_();
+  if (pinned_) {
+    data_ = static_cast<T*>(CudaHostAllocator().allocate(capacity * sizeof(T)));
+  } else {
+    data_ = static_cast<T*>(HostAllocator().allocate(capacity * sizeof(T)));
+    HCTR_THROW_IF(!data_, Error_t::OutOfMemory, "Cannot allocate ", capacity * sizeof(T),
+                  " bytes of host memory.");
+  }
+  capacity_ = capacity;
+}
+
+template <typename T>
+void ParquetHostBuffer<T>::release_() noexcept {
+  if (data_) {
+    if (pinned_) {
+      try {
+        CudaHostAllocator().deallocate(data_);
+      } catch (const std::exception& error) {
+        HCTR_LOG_S(ERROR, WORLD) << error.what() << std::endl;
+      }
+    } else {
+      HostAllocator().deallocate(data_);
+    }
+    data_ = nullptr;
+    capacity_ = 0;
+  }
+}
+
+template class ParquetHostBuffer<float>;
+template class ParquetHostBuffer<int32_t>;
+template class ParquetHostBuffer<int64_t>;
+template class ParquetHostBuffer<unsigned int>;
+template class ParquetHostBuffer<long long>;
+
+template <typename T, typename IndexType>
+ParquetCPUDecoder<T, IndexType>::ParquetCPUDecoder(
+    const std::vector<std::string>& label_dense_cols, const std::vector<std::string>& cat_cols,
+    const std::vector<DataReaderSparseParam>& params, const std::vector<long long>& slot_offset,
+    const size_t num_threads, const bool use_pinned_memory)
+    : label_dense_cols_{label_dense_cols},
+      cat_cols_{cat_cols},
+      params_{params},
+      slot_offset_{convert_slot_offset<T>(slot_offset)},
+      use_pinned_memory_{use_pinned_memory},
+      pool_{"parquet decoder", std::max(num_threads, size_t{1})} {
+  for (const DataReaderSparseParam& param : params_) {
+    num_slots_ += static_cast<size_t>(param.slot_num);
+  }
+  HCTR_CHECK_HINT(num_slots_ == cat_cols_.size(), "The sparse params cover ", num_slots_,
+                  " slots, but there are ", cat_cols_.size(), " categorical columns.");
+  HCTR_CHECK_HINT(slot_offset_.empty() || slot_offset_.size() == num_slots_,
+                  "Expected one slot offset per slot.");
+}
+
+template <typename T, typename IndexType>
+ParquetCPUDecoder<T, IndexType>::~ParquetCPUDecoder() {
+  // The tasks write into the pending batches, which must outlive them.
+  for (Pending& pending : pending_) {
+    pending.done.wait();
+  }
+}
+
+template <typename T, typename IndexType>
+std::vector<std::string> ParquetCPUDecoder<T, IndexType>::label_dense_columns(Metadata& metadata) {
+  std::vector<std::string> names{sorted_names(metadata.get_label_names())};
+  const std::vector<std::string> cont_names{sorted_names(metadata.get_cont_names())};
+  names.insert(names.end(), cont_names.begin(), cont_names.end());
+  return names;
+}
+
+template <typename T, typename IndexType>
+std::vector<std::string> ParquetCPUDecoder<T, IndexType>::cat_columns(Metadata& metadata) {
+  return sorted_names(metadata.get_cat_names());
+}
+
+template <typename T, typename IndexType>
+int ParquetCPUDecoder<T, IndexType>::num_row_groups(const std::string& file_name) {
+  try {
+    return parquet::ParquetFileReader::OpenFile(file_name, false)->metadata()->num_row_groups();
+  } catch (const parquet::ParquetException& e) {
+    HCTR_OWN_THROW(Error_t::BrokenFile, "Cannot open " + file_name + ": " + e.what());
+  }
+  return 0;
+}
+
+template <typename T, typename IndexType>
+std::unique_ptr<typename ParquetCPUDecoder<T, IndexType>::Batch>
+ParquetCPUDecoder<T, IndexType>::acquire_batch_() {
+  {
+    const std::lock_guard lock(free_batches_guard_);
+    if (!free_batches_.empty()) {
+      std::unique_ptr<Batch> batch{std::move(free_batches_.back())};
+      free_batches_.pop_back();
+      return batch;
+    }
+  }
+  return std::make_unique<Batch>(params_.size(), use_pinned_memory_);
+}
+
+template <typename T, typename IndexType>
+void ParquetCPUDecoder<T, IndexType>::submit(const std::string& file_name, const int row_group) {
+  std::unique_ptr<Batch> batch{acquire_batch_()};
+  Batch* const batch_ptr{batch.get()};
+  std::future<void> done{pool_.submit(
+      [this, file_name, row_group, batch_ptr]() { decode(file_name, row_group, *batch_ptr); })};
+  pending_.push_back({std::move(batch), std::move(done)});
+}
+
+template <typename T, typename IndexType>
+std::unique_ptr<typename ParquetCPUDecoder<T, IndexType>::Batch>
+ParquetCPUDecoder<T, IndexType>::next() {
+  HCTR_CHECK_HINT(!pending_.empty(), "No row group has been submitted.");
+  Pending pending{std::move(pending_.front())};
+  pending_.pop_front();
+
+  try {
+    pending.done.get();
+  } catch (...) {
+    recycle(std::move(pending.batch));
+    throw;
+  }
+  return std::move(pending.batch);
+}
+
+template <typename T, typename IndexType>
+size_t ParquetCPUDecoder<T, IndexType>::num_pending() const {
+  return pending_.size();
+}
+
+template <typename T, typename IndexType>
+void ParquetCPUDecoder<T, IndexType>::recycle(std::unique_ptr<Batch> batch) {
+  if (batch) {
+    const std::lock_guard lock(free_batches_guard_);
+    free_batches_.emplace_back(std::move(batch));
+  }
+}
+
+template <typename T, typename IndexType>
+void ParquetCPUDecoder<T, IndexType>::decode(const std::string& file_name, const int row_group,
+                                             Batch& batch) const {
+  std::unique_ptr<parquet::arrow::FileReader> reader{acquire_reader_(file_name)};
+  decode_(*reader, file_name, row_group, batch);
+  // Readers that failed are dropped, in case they are in a bad state.
+  release_reader_(file_name, std::move(reader));
+}
+
+template <typename T, typename IndexType>
+std::unique_ptr<parquet::arrow::FileReader> ParquetCPUDecoder<T, IndexType>::acquire_reader_(
+    const std::string& file_name) const {
+  {
+    const std::lock_guard lock(readers_guard_);
+    const auto it{std::find_if(readers_.rbegin(), readers_.rend(), [&](const CachedReader& r) {
+      return r.file_name == file_name;
+    })};
+    if (it != readers_.rend()) {
+      std::unique_ptr<parquet::arrow::FileReader> reader{std::move(it->reader)};
+      readers_.erase(std::next(it).base());
+      return reader;
+    }
+  }
+
+  // Decoding threads are managed by us, so Arrow must not spawn its own.
+  parquet::arrow::FileReaderBuilder builder;
+  check_status(builder.OpenFile(file_name, true), file_name);
+  parquet::ArrowReaderProperties properties;
+  properties.set_use_threads(false);
+  std::unique_ptr<parquet::arrow::FileReader> reader;
+  check_status(builder.properties(properties)->Build(&reader), file_name);
+  return reader;
+}
+
+template <typename T, typename IndexType>
+void ParquetCPUDecoder<T, IndexType>::release_reader_(
+    const std::string& file_name, std::unique_ptr<parquet::arrow::FileReader> reader) const {
+  const std::lock_guard lock(readers_guard_);
+  readers_.push_back({file_name, std::move(reader)});
+  while (readers_.size() > pool_.size()) {
+    readers_.pop_front();
+  }
+}
+
+template <typename T, typename IndexType>
+void ParquetCPUDecoder<T, IndexType>::decode_(parquet::arrow::FileReader& reader,
+                                              const std::string& file_name, const int row_group,
+                                              Batch& batch) const {
+  const auto metadata{reader.parquet_reader()->metadata()};
+  HCTR_THROW_IF(row_group < 0 || row_group >= metadata->num_row_groups(), Error_t::OutOfBound,
+                "Row group ", row_group, " does not exist in ", file_name, ".");
+  const size_t num_rows{static_cast<size_t>(metadata->RowGroup(row_group)->num_rows())};
+
+  // Maps column names to the index of their (only) leaf in the Parquet schema.
+  const parquet::arrow::SchemaManifest& manifest{reader.manifest()};
+  const auto read_column{[&](const std::string& name) {
+    const auto field{std::find_if(
+        manifest.schema_fields.begin(), manifest.schema_fields.end(),
+        [&](const parquet::arrow::SchemaField& f) { return f.field->name() == name; })};
+    HCTR_THROW_IF(field == manifest.schema_fields.end(), Error_t::WrongInput, "Column ", name,
+                  " does not exist in ", file_name, ".");
+    const parquet::arrow::SchemaField* leaf{&*field};
+    while (!leaf->children.empty()) {
+      leaf = &leaf->children.front();
+    }
+
+    std::shared_ptr<arrow::ChunkedArray> column;
+    check_status(reader.RowGroup(row_group)->Column(leaf->column_index)->Read(&column),
+                 file_name);
+    HCTR_THROW_IF(static_cast<size_t>(column->length()) != num_rows ||
+                      column->num_chunks() != 1,
+                  Error_t::BrokenFile, "Column ", name, " of row group ", row_group, " in ",
+                  file_name, " has an unexpected layout.");
+    return column->chunk(0);
+  }};
+
+  batch.file_name = file_name;
+  batch.row_group = row_group;
+  batch.num_rows = num_rows;
+
+  // Label and dense columns. Lists of floats must have the same length in every row.
+  std::vector<std::shared_ptr<arrow::Array>> dense_arrays;
+  std::vector<ColumnView> dense_views;
+  batch.dense_dim_array.clear();
+  batch.label_dense_dim = 0;
+  for (const std::string& name : label_dense_cols_) {
+    dense_arrays.emplace_back(read_column(name));
+    const ColumnView& view{dense_views.emplace_back(make_column_view(*dense_arrays.back(), name))};
+    HCTR_THROW_IF(view.type_id != arrow::Type::FLOAT, Error_t::WrongInput, "Parquet column ", name,
+                  " must be float or list<float>.");
+
+    size_t width{1};
+    if (view.offsets) {
+      width = num_rows > 0 ? view.num_values / num_rows : 0;
+      HCTR_THROW_IF(width * num_rows != view.num_values, Error_t::WrongInput,
+                    "Dense column ", name, " does not have a fixed width.");
+      for (size_t row{0}; row < num_rows; ++row) {
+        HCTR_THROW_IF(static_cast<size_t>(view.offsets[row + 1] - view.offsets[row]) != width,
+                      Error_t::WrongInput, "Dense column ", name, " does not have a fixed width.");
+      }
+    }
+    batch.dense_dim_array.push_back(width);
+    batch.label_dense_dim += width;
+  }
+
+  batch.label_dense.reserve(num_rows * batch.label_dense_dim);
+  float* const label_dense{batch.label_dense.data()};
+  size_t column_offset{0};
+  for (size_t col{0}; col < dense_views.size(); ++col) {
+    const ColumnView& view{dense_views[col]};
+    const size_t width{batch.dense_dim_array[col]};
+    const float* src{reinterpret_cast<const float*>(view.values)};
+    if (view.offsets) {
+      src += view.offsets[0];
+    }
+    float* dst{label_dense + column_offset};
+    for (size_t row{0}; row < num_rows; ++row) {
+      std::memcpy(dst, src, width * sizeof(float));
+      src += width;
+      dst += batch.label_dense_dim;
+    }
+    column_offset += width;
+  }
+
+  // Categorical columns, converted into one CSR matrix per sparse param.
+  size_t first_slot{0};
+  for (size_t param_id{0}; param_id < params_.size(); ++param_id) {
+    const size_t slot_num{static_cast<size_t>(params_[param_id].slot_num)};
+    typename Batch::Sparse& sparse{batch.sparse[param_id]};
+
+    std::vector<std::shared_ptr<arrow::Array>> arrays;
+    std::vector<ColumnView> views;
+    for (size_t slot{0}; slot < slot_num; ++slot) {
+      const std::string& name{cat_cols_[first_slot + slot]};
+      arrays.emplace_back(read_column(name));
+      const ColumnView& view{views.emplace_back(make_column_view(*arrays.back(), name))};
+      HCTR_THROW_IF(!is_key_type(view.type_id), Error_t::WrongInput, "Parquet column ", name,
+                    " must hold uint64/int64/int32/uint32 keys.");
+      HCTR_THROW_IF(static_cast<size_t>(view.bit_width) != sizeof(T) * 8, Error_t::WrongInput,
+                    "Parquet column ", name, " type is not consistent with solver.i64_input_key.");
+    }
+
+    // Count the keys per (sample, slot), and turn the counts into offsets.
+    const size_t num_csr_rows{num_rows * slot_num};
+    sparse.row_offsets.reserve(num_csr_rows + 1);
+    IndexType* const row_offsets{sparse.row_offsets.data()};
+    row_offsets[0] = 0;
+    for (size_t slot{0}; slot < slot_num; ++slot) {
+      const int32_t* const offsets{views[slot].offsets};
+      for (size_t row{0}; row < num_rows; ++row) {
+        row_offsets[row * slot_num + slot + 1] =
+            offsets ? static_cast<IndexType>(offsets[row + 1] - offsets[row]) : 1;
+      }
+    }
+    for (size_t i{1}; i <= num_csr_rows; ++i) {
+      row_offsets[i] += row_offsets[i - 1];
+    }
+    sparse.nnz = static_cast<size_t>(row_offsets[num_csr_rows]);
+
+    // Scatter the keys of each slot into their rows.
+    sparse.values.reserve(std::max(sparse.nnz, size_t{1}));
+    T* const values{sparse.values.data()};
+    for (size_t slot{0}; slot < slot_num; ++slot) {
+      const ColumnView& view{views[slot]};
+      const T* const keys{reinterpret_cast<const T*>(view.values)};
+      const T offset{slot_offset_.empty() ? T{0} : slot_offset_[first_slot + slot]};
+      if (view.offsets) {
+        for (size_t row{0}; row < num_rows; ++row) {
+          T* dst{values + row_offsets[row * slot_num + slot]};
+          for (int32_t i{view.offsets[row]}; i < view.offsets[row + 1]; ++i) {
+            *dst++ = keys[i] + offset;
+          }
+        }
+      } else {
+        for (size_t row{0}; row < num_rows; ++row) {
+          values[row_offsets[row * slot_num + slot]] = keys[row] + offset;
+        }
+      }
+    }
+
+    first_slot += slot_num;
+  }
+}
+
+template class ParquetCPUDecoder<unsigned int, int32_t>;
+template class ParquetCPUDecoder<unsigned int, int64_t>;
+template class ParquetCPUDecoder<long long, int32_t>;
+template class ParquetCPUDecoder<long long, int64_t>;
+
+}  // namespace HugeCTR
@@ -19,8 +19,27 @@
 #include <data_readers/parquet_data_reader_worker.hpp>
 namespace HugeCTR {
 
+namespace {
+
+// Appends `num_rows` rows of `src`, starting at `first_row`, to the `dst_rows` rows of `dst`, which
+// hold `dst_nnz` values.
+template <typename IndexType>
+void append_row_offsets(const int64_t* src, size_t first_row, size_t num_rows, IndexType* dst,
+                        size_t dst_rows, int64_t dst_nnz) {
+  const int64_t base = src[first_row];
+  for (size_t i = 1; i <= num_rows; i++) {
+    dst[dst_rows + i] = static_cast<IndexType>(dst_nnz + src[first_row + i] - base);
+  }
+}
+
+}  // namespace
+
 template <typename T>
 void ParquetDataReaderWorker<T>::do_h2d() {
+  if (cpu_decoder_) {
+    // The decoder has its own threads, and read_a_batch() keeps them busy.
+    return;
+  }
   CudaDeviceContext context(device_id_);
   if (!row_group_reader_) {
     HCTR_OWN_THROW(Error_t::NotInitialized, "please init parquet row group reader first\n");
@@ -90,9 +109,36 @@ void ParquetDataReaderWorker<T>::do_h2d() {
   }
 }
 
+template <typename T>
+void ParquetDataReaderWorker<T>::end_epoch_() {
+  if (!wait_until_h2d_ready()) {
+    return;
+  }
+  is_eof_ = true;
+  buffer23_->current_batch_size = 0;
+  assert(buffer23_->state.load() == BufferState::Writing);
+  // notify data collector the empty batch, it will switch state to
+  // BufferState::ReadyForWrite
+  buffer23_->state.store(BufferState::ReadyForRead);
+  while (buffer23_->state.load() != BufferState::ReadyForWrite) {
+    usleep(2);
+    if (!loop_flag_->load()) {
+      return;
+    }
+  }
+  std::unique_lock<std::mutex> lck(this->epoch_mtx_);
+  this->epoch_cv_.wait(lck, [&]() { return *this->go_next_epoch_; });
+  *this->go_next_epoch_ = 0;
+  global_row_group_id_ = 0;
+}
+
 // consumer
 template <class T>
 void ParquetDataReaderWorker<T>::read_a_batch() {
+  if (cpu_decoder_) {
+    read_a_batch_from_host_();
+    return;
+  }
   // int dev_id = -1;
   // cudaGetDevice(&dev_id);
   // std::cout<<"read_a_batch on device "<<dev_id <<std::endl;
@@ -147,25 +193,7 @@ void ParquetDataReaderWorker<T>::read_a_batch() {
             }
             elements_to_forward = row_group_consumer->get_available_rows();
             if (current_batch_size == 0) {
-              if (!wait_until_h2d_ready()) {
-                return;
-              }
-              is_eof_ = true;
-              buffer23_->current_batch_size = 0;
-              assert(buffer23_->state.load() == BufferState::Writing);
-              // notify data collector the empty batch, it will switch state to
-              // BufferState::ReadyForWrite
-              buffer23_->state.store(BufferState::ReadyForRead);
-              while (buffer23_->state.load() != BufferState::ReadyForWrite) {
-                usleep(2);
-                if (!loop_flag_->load()) {
-                  return;
-                }
-              }
-              std::unique_lock<std::mutex> lck(this->epoch_mtx_);
-              this->epoch_cv_.wait(lck, [&]() { return *this->go_next_epoch_; });
-              *this->go_next_epoch_ = 0;
-              global_row_group_id_ = 0;
+              end_epoch_();
               return;
             } else {
               break;
@@ -343,6 +371,188 @@ void ParquetDataReaderWorker<T>::read_a_batch() {
   return;
 }
 
+template <typename T>
+void ParquetDataReaderWorker<T>::submit_row_groups_() {
+  ParquetFileSource* source = parquet_file_source();
+  // two row groups per thread, so that the threads don't wait for this one
+  const size_t max_pending = 2 * cpu_decoder_->num_threads();
+  while (!cpu_source_eof_ && cpu_decoder_->num_pending() < max_pending) {
+    if (!source->is_open() || cpu_row_group_ >= source->get_num_row_groups()) {
+      Error_t err = source->next_source(1);
+      if (err == Error_t::EndOfFile) {
+        cpu_source_eof_ = true;
+      } else if (err != Error_t::Success) {
+        HCTR_OWN_THROW(err, "Parquet reader: failed to read a file");
+      } else {
+        cpu_row_group_ = source->get_row_group();
+      }
+      continue;
+    }
+    cpu_decoder_->submit(source->get_cur_file(), cpu_row_group_++);
+  }
+}
+
+template <typename T>
+void ParquetDataReaderWorker<T>::read_a_batch_from_host_() {
+  CudaDeviceContext context(device_id_);
+  if (!skip_read_) {
+    const long long batch_size = buffer23_->batch_size;
+    submit_row_groups_();
+    long long available_rows = -static_cast<long long>(cpu_batch_row_);
+    for (const auto& batch : cpu_batches_) {
+      available_rows += batch->num_rows;
+    }
+    while (available_rows < batch_size && cpu_decoder_->num_pending() > 0) {
+      // rethrows the errors of the decoder threads
+      cpu_batches_.emplace_back(cpu_decoder_->next());
+      available_rows += cpu_batches_.back()->num_rows;
+      submit_row_groups_();
+    }
+
+    const long long current_batch_size = std::min(available_rows, batch_size);
+    if (current_batch_size == 0) {
+      end_epoch_();
+      return;
+    }
+    if (!wait_until_h2d_ready()) {
+      return;
+    }
+    buffer23_->current_batch_size = current_batch_size;
+    upload_host_rows_(current_batch_size);
+  }
+  buffer23_->state.store(BufferState::ReadyForRead);
+}
+
+template <typename T>
+void ParquetDataReaderWorker<T>::upload_host_rows_(const long long batch_size) {
+  // Host batches are in the output layout, and in page-locked memory, so the dense rows and the
+  // keys are copied straight from them. Only the row offsets are rebased, on the host.
+  const int label_dense_dim = buffer23_->label_dim + buffer23_->dense_dim;
+  const long long dense_start = std::min<long long>(buffer23_->batch_size_start_idx, batch_size);
+  const long long dense_end = std::min<long long>(buffer23_->batch_size_end_idx, batch_size);
+  float* dst_dense = reinterpret_cast<float*>(buffer23_->device_dense_buffers.data());
+  HCTR_LIB_THROW(cudaMemsetAsync(
+      dst_dense, 0,
+      sizeof(float) * label_dense_dim *
+          (buffer23_->batch_size_end_idx - buffer23_->batch_size_start_idx),
+      task_stream_));
+
+  auto& dst_sparse_tensors = buffer23_->device_sparse_buffers;
+  const size_t offset_size = dst_sparse_tensors[0].get_rowoffset_tensor().data_type().size();
+  std::vector<int64_t*> row_offsets(params_.size());
+  int64_t* staging = host_pinned_csr_row_offsets_.data<int64_t>();
+  for (size_t k = 0; k < params_.size(); k++) {
+    row_offsets[k] = staging;
+    staging += static_cast<size_t>(buffer23_->batch_size) * params_[k].slot_num + 1;
+    if (offset_size == 4) {
+      reinterpret_cast<int32_t*>(row_offsets[k])[0] = 0;
+    } else {
+      row_offsets[k][0] = 0;
+    }
+  }
+  std::vector<int64_t> nnz(params_.size(), 0);
+
+  long long row = 0;
+  size_t first_row = cpu_batch_row_;
+  for (auto it = cpu_batches_.begin(); row < batch_size; ++it, first_row = 0) {
+    const auto& batch = **it;
+    if (batch.label_dense_dim != static_cast<size_t>(label_dense_dim)) {
+      HCTR_LOG(INFO, WORLD, "worker %d dense_dim_check %zu vs label_dense_dim %d \n", worker_id_,
+               batch.label_dense_dim, label_dense_dim);
+      HCTR_OWN_THROW(Error_t::WrongInput,
+                     "Parquet reader: Dense dim of given file and dense dim "
+                     "doesn't match ");
+    }
+    const long long num_rows =
+        std::min(static_cast<long long>(batch.num_rows - first_row), batch_size - row);
+
+    // only proceed dense for local gpu
+    const long long lo = std::max(row, dense_start);
+    const long long hi = std::min(row + num_rows, dense_end);
+    if (lo < hi) {
+      HCTR_LIB_THROW(cudaMemcpyAsync(
+          dst_dense + (lo - dense_start) * label_dense_dim,
+          batch.label_dense.data() + (first_row + lo - row) * label_dense_dim,
+          sizeof(float) * (hi - lo) * label_dense_dim, cudaMemcpyHostToDevice, task_stream_));
+    }
+
+    for (size_t k = 0; k < params_.size(); k++) {
+      const size_t slot_num = params_[k].slot_num;
+      const auto& sparse = batch.sparse[k];
+      const int64_t* src = sparse.row_offsets.data();
+      const int64_t value_begin = src[first_row * slot_num];
+      const int64_t value_end = src[(first_row + num_rows) * slot_num];
+      auto& dst_sparse_tensor = dst_sparse_tensors[k];
+      if (nnz[k] + value_end - value_begin > dst_sparse_tensor.get_value_tensor().num_elements()) {
+        HCTR_OWN_THROW(Error_t::OutOfBound,
+                       "Parquet reader: the batch has more keys than max_feature_num allows");
+      }
+      if (value_end > value_begin) {
+        HCTR_LIB_THROW(cudaMemcpyAsync(
+            reinterpret_cast<T*>(dst_sparse_tensor.get_value_ptr()) + nnz[k],
+            sparse.values.data() + value_begin, sizeof(T) * (value_end - value_begin),
+            cudaMemcpyHostToDevice, task_stream_));
+      }
+      if (offset_size == 4) {
+        append_row_offsets(src, first_row * slot_num, num_rows * slot_num,
+                           reinterpret_cast<int32_t*>(row_offsets[k]), row * slot_num, nnz[k]);
+      } else {
+        append_row_offsets(src, first_row * slot_num, num_rows * slot_num, row_offsets[k],
+                           row * slot_num, nnz[k]);
+      }
+      nnz[k] += value_end - value_begin;
+    }
+    row += num_rows;
+  }
+
+  for (size_t k = 0; k < params_.size(); k++) {
+    auto& dst_sparse_tensor = dst_sparse_tensors[k];
+    const size_t slot_num = params_[k].slot_num;
+    HCTR_LIB_THROW(cudaMemsetAsync(dst_sparse_tensor.get_rowoffset_ptr(), 0,
+                                   offset_size * (slot_num * buffer23_->batch_size + 1),
+                                   task_stream_));
+    HCTR_LIB_THROW(cudaMemcpyAsync(dst_sparse_tensor.get_rowoffset_ptr(), row_offsets[k],
+                                   offset_size * (slot_num * batch_size + 1),
+                                   cudaMemcpyHostToDevice, task_stream_));
+    *dst_sparse_tensor.get_nnz_ptr() = nnz[k];
+  }
+  HCTR_LIB_THROW(cudaStreamSynchronize(task_stream_));
+
+  // The copies are done, so the consumed batches can be reused
+  long long rows_left = batch_size;
+  while (rows_left > 0 || (!cpu_batches_.empty() && cpu_batches_.front()->num_rows == 0)) {
+    auto& front = cpu_batches_.front();
+    const long long num_rows =
+        std::min(static_cast<long long>(front->num_rows - cpu_batch_row_), rows_left);
+    cpu_batch_row_ += num_rows;
+    rows_left -= num_rows;
+    if (cpu_batch_row_ == front->num_rows) {
+      cpu_decoder_->recycle(std::move(front));
+      cpu_batches_.pop_front();
+      cpu_batch_row_ = 0;
+    }
+  }
+}
+
+template <typename T>
+void ParquetDataReaderWorker<T>::reset_cpu_decoder_() {
+  while (cpu_decoder_->num_pending() > 0) {
+    try {
+      cpu_decoder_->recycle(cpu_decoder_->next());
+    } catch (const std::exception& error) {
+      // the row group is dropped anyway
+      HCTR_LOG_S(WARNING, WORLD) << error.what() << std::endl;
+    }
+  }
+  for (auto& batch : cpu_batches_) {
+    cpu_decoder_->recycle(std::move(batch));
+  }
+  cpu_batches_.clear();
+  cpu_batch_row_ = 0;
+  cpu_row_group_ = 0;
+  cpu_source_eof_ = false;
+}
+
 // loop_flag is readonly
 template <typename T>
 ParquetDataReaderWorker<T>::ParquetDataReaderWorker(
@@ -359,7 +569,7 @@ ParquetDataReaderWorker<T>::ParquetDataReaderWorker(
     std::vector<std::shared_ptr<std::atomic<int>>>& accomplished_workers,
     const std::shared_ptr<ResourceManager>& resource_manager,
     std::shared_ptr<std::vector<size_t>> dense_width_dim, char* go_next_epoch,
-    std::mutex& epoch_mtx, std::condition_variable& epoch_cv)
+    std::mutex& epoch_mtx, std::condition_variable& epoch_cv, size_t cpu_decoder_threads)
 
     : IDataReaderWorker(worker_id, worker_num, gpu_resource, !repeat, loop_flag, buffer),
       params_(params),
@@ -415,8 +625,9 @@ ParquetDataReaderWorker<T>::ParquetDataReaderWorker(
   // TODO this eager allocation is a WAR of resolving race condition with the main thread;
   // Do not remove the allocation before we have a better way to resolve the race condition
   device_memory_dense_dim_array_.data();
-  source_ = std::make_shared<ParquetFileSource>(
-      worker_id, worker_num, file_list, strict_order_of_batches, repeat, data_source_params);
+  source_ = std::make_shared<ParquetFileSource>(worker_id, worker_num, file_list,
+                                                strict_order_of_batches, repeat,
+                                                data_source_params, cpu_decoder_threads > 0);
 
   if ((int)slot_offset_.size() < slots_) {
     slot_offset_.resize(slots_, static_cast<long long int>(0));
@@ -440,11 +651,36 @@ ParquetDataReaderWorker<T>::ParquetDataReaderWorker(
                                    slot_offset_buf_size, cudaMemcpyHostToDevice, task_stream_));
     thread_resource_allocated_ = true;
   }
-  row_group_reader_ = std::make_unique<RowGroupReadingThread<T>>(
-      device_id, worker_id, worker_num, strict_order_of_batches ? worker_num : 1, end_flag,
-      parquet_file_source(), memory_resource_.get(), strict_order_of_batches,
-      dense_idx_to_parquet_col_, categorical_idx_parquet_col_, df_container_consumer,
-      df_container_producer, producer_buffer_stats, workers_has_read, accomplished_workers);
+  if (cpu_decoder_threads > 0) {
+    // each worker decodes its own row groups, while sequential reading shares them among workers
+    if (strict_order_of_batches) {
+      HCTR_OWN_THROW(Error_t::WrongInput,
+                     "Parquet reader: CPU decoding does not support read_file_sequentially");
+    }
+    // the decoder opens the files itself
+    if (data_source_params.type != FileSystemType_t::Local) {
+      HCTR_OWN_THROW(Error_t::WrongInput, "Parquet reader: CPU decoding only reads local files");
+    }
+    Metadata metadata = parquet_file_source()->get_file_metadata();
+    cpu_decoder_ = std::make_unique<CPUDecoder>(
+        CPUDecoder::label_dense_columns(metadata), CPUDecoder::cat_columns(metadata), params_,
+        slot_offset_, cpu_decoder_threads, true);
+    int64_t num_row_offsets = 0;
+    for (auto& p : params_) {
+      num_row_offsets += static_cast<int64_t>(buffer23_->batch_size) * p.slot_num + 1;
+    }
+    host_pinned_csr_row_offsets_ =
+        core23::Tensor({num_row_offsets}, core23::ScalarType::Int64,
+                       default_param.device(core23::Device(core23::DeviceType::CPU)));
+    // eager allocation, see host_memory_dense_dim_array_
+    host_pinned_csr_row_offsets_.data();
+  } else {
+    row_group_reader_ = std::make_unique<RowGroupReadingThread<T>>(
+        device_id, worker_id, worker_num, strict_order_of_batches ? worker_num : 1, end_flag,
+        parquet_file_source(), memory_resource_.get(), strict_order_of_batches,
+        dense_idx_to_parquet_col_, categorical_idx_parquet_col_, df_container_consumer,
+        df_container_producer, producer_buffer_stats, workers_has_read, accomplished_workers);
+  }
 }
 
 template <typename T>
@@ -0,0 +1,355 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <common.hpp>
+#include <core23/logger.hpp>
+#include <cstring>
+#include <data_readers/mapped_file.hpp>
+#include <data_readers/raw_async_packed.hpp>
+#include <fstream>
+#include <future>
+#include <limits>
+#include <thread_pool.hpp>
+
+namespace HugeCTR {
+
+namespace {
+
+constexpr uint64_t packed_magic{0x4b43504152544348};  // "HCTRAPCK"
+constexpr uint64_t packed_version{1};
+
+struct PackedFooter {
+  uint64_t magic;
+  uint64_t version;
+  uint64_t label_dense_dim;
+  uint64_t num_keys;
+  uint64_t key_bytes;
+  uint64_t num_samples;
+  uint64_t block_samples;
+  uint64_t num_blocks;
+  uint64_t index_offset;
+};
+
+template <typename T>
+inline T load(const uint8_t* const ptr) {
+  T value;
+  std::memcpy(&value, ptr, sizeof(T));
+  return value;
+}
+
+template <typename T>
+inline void store(uint8_t* const ptr, const T value) {
+  std::memcpy(ptr, &value, sizeof(T));
+}
+
+inline uint64_t load_column(const uint8_t* const ptr, const size_t bytes) {
+  return bytes == 4 ? load<uint32_t>(ptr) : load<uint64_t>(ptr);
+}
+
+inline size_t num_words(const size_t num_samples, const size_t width) {
+  return (num_samples * width + 63) / 64;
+}
+
+struct PackedColumn {
+  uint64_t base;
+  size_t width;
+  const uint8_t* words;
+};
+
+template <typename T>
+void decode_column(const PackedColumn& column, uint8_t* const values, const size_t stride,
+                   const size_t begin, const size_t end) {
+  if (column.width == 0) {
+    for (size_t i{begin}; i < end; ++i) {
+      store(values + i * stride, static_cast<T>(column.base));
+    }
+    return;
+  }
+
+  const size_t width{column.width};
+  const uint64_t mask{width == 64 ? ~uint64_t{0} : (uint64_t{1} << width) - 1};
+  for (size_t i{begin}, bit{begin * width}; i < end; ++i, bit += width) {
+    const uint8_t* const word{column.words + bit / 64 * sizeof(uint64_t)};
+    const size_t shift{bit % 64};
+    uint64_t delta{load<uint64_t>(word) >> shift};
+    if (shift + width > 64) {
+      delta |= load<uint64_t>(word + 8) << (64 - shift);
+    }
+    store(values + i * stride, static_cast<T>(column.base + (delta & mask)));
+  }
+}
+
+}  // namespace
+
+RawAsyncPackedCodec::RawAsyncPackedCodec(const RawAsyncPackedLayout& layout) : layout_(layout) {
+  HCTR_THROW_IF(layout_.key_bytes != 4 && layout_.key_bytes != 8, Error_t::WrongInput,
+                "Keys must have 4 or 8 bytes, not ", layout_.key_bytes);
+  HCTR_THROW_IF(layout_.sample_size_bytes() == 0, Error_t::WrongInput, "Samples are empty");
+  size_t offset{0};
+  for (size_t i{0}; i < layout_.label_dense_dim + layout_.num_keys; ++i) {
+    column_bytes_.push_back(i < layout_.label_dense_dim ? 4 : layout_.key_bytes);
+    column_offsets_.push_back(offset);
+    offset += column_bytes_.back();
+  }
+}
+
+size_t RawAsyncPackedCodec::max_encoded_size(const size_t num_samples) const {
+  size_t size{sizeof(uint64_t)};
+  for (const size_t bytes : column_bytes_) {
+    size += 2 * sizeof(uint64_t) + num_words(num_samples, bytes * 8) * sizeof(uint64_t);
+  }
+  return size;
+}
+
+size_t RawAsyncPackedCodec::encode(const uint8_t* const samples, const size_t num_samples,
+                                   uint8_t* const out) const {
+  const size_t sample_size{layout_.sample_size_bytes()};
+  const size_t num_columns{column_bytes_.size()};
+  // Like decode(), go through a few samples at a time
+  constexpr size_t chunk_samples{64};
+
+  thread_local std::vector<uint64_t> mins;
+  thread_local std::vector<uint64_t> maxs;
+  mins.assign(num_columns, num_samples > 0 ? std::numeric_limits<uint64_t>::max() : 0);
+  maxs.assign(num_columns, 0);
+  for (size_t begin{0}; begin < num_samples; begin += chunk_samples) {
+    const size_t end{std::min(begin + chunk_samples, num_samples)};
+    for (size_t c{0}; c < num_columns; ++c) {
+      const uint8_t* const column{samples + column_offsets_[c]};
+      for (size_t i{begin}; i < end; ++i) {
+        const uint64_t value{load_column(column + i * sample_size, column_bytes_[c])};
+        mins[c] = std::min(mins[c], value);
+        maxs[c] = std::max(maxs[c], value);
+      }
+    }
+  }
+
+  thread_local std::vector<PackedColumn> columns;
+  columns.resize(num_columns);
+  store<uint64_t>(out, num_samples);
+  size_t pos{sizeof(uint64_t)};
+  for (size_t c{0}; c < num_columns; ++c) {
+    PackedColumn& column{columns[c]};
+    const uint64_t range{maxs[c] - mins[c]};
+    column.base = mins[c];
+    column.width = range == 0 ? 0 : 64 - static_cast<size_t>(__builtin_clzll(range));
+    store<uint64_t>(out + pos, column.base);
+    store<uint64_t>(out + pos + 8, column.width);
+    pos += 2 * sizeof(uint64_t);
+
+    const size_t n_words{num_words(num_samples, column.width)};
+    std::memset(out + pos, 0, n_words * sizeof(uint64_t));
+    column.words = out + pos;
+    pos += n_words * sizeof(uint64_t);
+  }
+
+  for (size_t begin{0}; begin < num_samples; begin += chunk_samples) {
+    const size_t end{std::min(begin + chunk_samples, num_samples)};
+    for (size_t c{0}; c < num_columns; ++c) {
+      const PackedColumn& column{columns[c]};
+      if (column.width == 0) {
+        continue;
+      }
+      const uint8_t* const values{samples + column_offsets_[c]};
+      uint8_t* const words{const_cast<uint8_t*>(column.words)};
+      for (size_t i{begin}, bit{begin * column.width}; i < end; ++i, bit += column.width) {
+        const uint64_t delta{load_column(values + i * sample_size, column_bytes_[c]) -
+                             column.base};
+        uint8_t* const word{words + bit / 64 * sizeof(uint64_t)};
+        const size_t shift{bit % 64};
+        store(word, load<uint64_t>(word) | delta << shift);
+        if (shift + column.width > 64) {
+          store(word + 8, load<uint64_t>(word + 8) | delta >> (64 - shift));
+        }
+      }
+    }
+  }
+  return pos;
+}
+
+size_t RawAsyncPackedCodec::decode(const uint8_t* const in, const size_t size,
+                                   uint8_t* const samples, const size_t max_samples) const {
+  const size_t sample_size{layout_.sample_size_bytes()};
+  HCTR_THROW_IF(size < sizeof(uint64_t), Error_t::BrokenFile, "Packed block is truncated");
+  const size_t num_samples{load<uint64_t>(in)};
+  HCTR_THROW_IF(num_samples > max_samples, Error_t::BrokenFile, "Packed block has ", num_samples,
+                " samples, expected at most ", max_samples);
+  size_t pos{sizeof(uint64_t)};
+
+  thread_local std::vector<PackedColumn> columns;
+  columns.resize(column_bytes_.size());
+  for (size_t c{0}; c < column_bytes_.size(); ++c) {
+    PackedColumn& column{columns[c]};
+    const size_t bytes{column_bytes_[c]};
+    HCTR_THROW_IF(pos + 2 * sizeof(uint64_t) > size, Error_t::BrokenFile,
+                  "Packed block is truncated");
+    column.base = load<uint64_t>(in + pos);
+    column.width = load<uint64_t>(in + pos + 8);
+    pos += 2 * sizeof(uint64_t);
+    HCTR_THROW_IF(column.width > bytes * 8, Error_t::BrokenFile, "Packed column is ",
+                  column.width, " bits wide, expected at most ", bytes * 8);
+    const size_t n_words{num_words(num_samples, column.width)};
+    HCTR_THROW_IF(pos + n_words * sizeof(uint64_t) > size, Error_t::BrokenFile,
+                  "Packed block is truncated");
+    column.words = in + pos;
+    pos += n_words * sizeof(uint64_t);
+  }
+
+  // Decode a few samples at a time, so that the columns are written to cached lines
+  constexpr size_t chunk_samples{64};
+  for (size_t begin{0}; begin < num_samples; begin += chunk_samples) {
+    const size_t end{std::min(begin + chunk_samples, num_samples)};
+    for (size_t c{0}; c < columns.size(); ++c) {
+      uint8_t* const column{samples + column_offsets_[c]};
+      if (column_bytes_[c] == 4) {
+        decode_column<uint32_t>(columns[c], column, sample_size, begin, end);
+      } else {
+        decode_column<uint64_t>(columns[c], column, sample_size, begin, end);
+      }
+    }
+  }
+  return num_samples;
+}
+
+size_t RawAsyncPackedIndex::max_span_bytes(const size_t n) const {
+  size_t max_span{0};
+  for (size_t i{0}; i < num_blocks(); ++i) {
+    const size_t end{std::min(i + n, num_blocks())};
+    max_span = std::max<size_t>(max_span, offsets[end] - offsets[i]);
+  }
+  return max_span;
+}
+
+std::shared_ptr<const RawAsyncPackedIndex> RawAsyncPackedIndex::read(const std::string& file_name) {
+  std::ifstream file(file_name, std::ios::binary | std::ios::ate);
+  HCTR_THROW_IF(!file.is_open(), Error_t::FileCannotOpen, "Unable to open \"", file_name, "\"");
+  const size_t file_size{static_cast<size_t>(file.tellg())};
+  if (file_size < sizeof(PackedFooter)) {
+    return nullptr;
+  }
+
+  PackedFooter footer;
+  file.seekg(file_size - sizeof(PackedFooter));
+  file.read(reinterpret_cast<char*>(&footer), sizeof(PackedFooter));
+  if (!file || footer.magic != packed_magic) {
+    return nullptr;
+  }
+  HCTR_THROW_IF(footer.version != packed_version, Error_t::BrokenFile, "\"", file_name,
+                "\" has packed format version ", footer.version, ", expected ", packed_version);
+  const size_t index_size{(footer.num_blocks + 1) * sizeof(uint64_t)};
+  HCTR_THROW_IF(footer.index_offset + index_size + sizeof(PackedFooter) != file_size,
+                Error_t::BrokenFile, "\"", file_name, "\" has an invalid packed index");
+
+  auto index{std::make_shared<RawAsyncPackedIndex>()};
+  index->layout.label_dense_dim = footer.label_dense_dim;
+  index->layout.num_keys = footer.num_keys;
+  index->layout.key_bytes = footer.key_bytes;
+  index->num_samples = footer.num_samples;
+  index->block_samples = footer.block_samples;
+  index->offsets.resize(footer.num_blocks + 1);
+  file.seekg(footer.index_offset);
+  file.read(reinterpret_cast<char*>(index->offsets.data()), index_size);
+  HCTR_THROW_IF(!file, Error_t::BrokenFile, "Unable to read the packed index of \"", file_name,
+                "\"");
+
+  HCTR_THROW_IF(index->block_samples == 0 ||
+                    (index->num_samples + index->block_samples - 1) / index->block_samples !=
+                        index->num_blocks() ||
+                    index->offsets.front() != 0 || index->offsets.back() != footer.index_offset ||
+                    !std::is_sorted(index->offsets.begin(), index->offsets.end()),
+                Error_t::BrokenFile, "\"", file_name, "\" has an invalid packed index");
+  return index;
+}
+
+RawAsyncPackerStats pack_raw_async(const std::string& input_file, const std::string& output_file,
+                                   const RawAsyncPackedLayout& layout, const size_t block_samples,
+                                   const size_t num_threads) {
+  const auto begin{std::chrono::steady_clock::now()};
+  const RawAsyncPackedCodec codec(layout);
+  const size_t sample_size{layout.sample_size_bytes()};
+  HCTR_THROW_IF(block_samples == 0, Error_t::WrongInput, "Blocks must have at least one sample");
+
+  const MappedFile input(input_file);
+  HCTR_THROW_IF(input.size() % sample_size != 0, Error_t::WrongInput, "Size of \"", input_file,
+                "\" is not a multiple of the sample size ", sample_size);
+  RawAsyncPackerStats stats;
+  stats.num_samples = input.size() / sample_size;
+  stats.num_bytes = input.size();
+  const size_t num_blocks{(stats.num_samples + block_samples - 1) / block_samples};
+
+  std::ofstream output(output_file, std::ios::binary | std::ios::trunc);
+  HCTR_THROW_IF(!output.is_open(), Error_t::FileCannotOpen, "Unable to open \"", output_file,
+                "\" for writing");
+
+  // Blocks are encoded in rounds of a few per thread, and written in order.
+  ThreadPool pool("packer", std::max<size_t>(num_threads, 1));
+  const size_t round_blocks{pool.size() * 4};
+  std::vector<std::vector<uint8_t>> buffers(round_blocks);
+  std::vector<size_t> sizes(round_blocks);
+  std::vector<uint64_t> offsets{0};
+  offsets.reserve(num_blocks + 1);
+  for (size_t first{0}; first < num_blocks; first += round_blocks) {
+    const size_t n{std::min(round_blocks, num_blocks - first)};
+    std::vector<std::future<void>> futures;
+    for (size_t i{0}; i < n; ++i) {
+      futures.push_back(pool.submit([&, i]() {
+        const size_t sample{(first + i) * block_samples};
+        const size_t count{std::min(block_samples, stats.num_samples - sample)};
+        buffers[i].resize(codec.max_encoded_size(count));
+        sizes[i] = codec.encode(reinterpret_cast<const uint8_t*>(input.data()) +
+                                    sample * sample_size,
+                                count, buffers[i].data());
+      }));
+    }
+    ThreadPool::await(futures.begin(), futures.end());
+    for (size_t i{0}; i < n; ++i) {
+      output.write(reinterpret_cast<const char*>(buffers[i].data()), sizes[i]);
+      offsets.push_back(offsets.back() + sizes[i]);
+    }
+  }
+
+  PackedFooter footer;
+  footer.magic = packed_magic;
+  footer.version = packed_version;
+  footer.label_dense_dim = layout.label_dense_dim;
+  footer.num_keys = layout.num_keys;
+  footer.key_bytes = layout.key_bytes;
+  footer.num_samples = stats.num_samples;
+  footer.block_samples = block_samples;
+  footer.num_blocks = num_blocks;
+  footer.index_offset = offsets.back();
+  output.write(reinterpret_cast<const char*>(offsets.data()), offsets.size() * sizeof(uint64_t));
+  output.write(reinterpret_cast<const char*>(&footer), sizeof(footer));
+  output.close();
+  HCTR_THROW_IF(!output, Error_t::UnspecificError, "Unable to write \"", output_file, "\"");
+
+  stats.num_packed_bytes = offsets.back() + offsets.size() * sizeof(uint64_t) + sizeof(footer);
+  stats.elapsed_s =
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+  HCTR_LOG_S(INFO, WORLD) << "Packed " << stats.num_samples << " samples in " << num_blocks
+                          << " block(s) from " << stats.num_bytes << " to "
+                          << stats.num_packed_bytes << " bytes (" << stats.ratio() << "x) in "
+                          << stats.elapsed_s << " s" << std::endl;
+  return stats;
+}
+
+}  // namespace HugeCTR
@@ -0,0 +1,682 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <core/memory.hpp>
+#include <core23/logger.hpp>
+#include <cstring>
+#include <data_readers/mapped_file.hpp>
+#include <data_readers/raw_async_repacker.hpp>
+#include <exception>
+#include <fstream>
+#include <limits>
+#include <mutex>
+#include <nlohmann/json.hpp>
+#include <numeric>
+#include <thread>
+#ifndef DISABLE_CUDF
+#include <data_readers/metadata.hpp>
+#include <data_readers/parquet_cpu_decoder.hpp>
+#endif
+
+namespace HugeCTR {
+
+namespace {
+
+template <typename T>
+inline T load(const char* const ptr) {
+  T value;
+  std::memcpy(&value, ptr, sizeof(T));
+  return value;
+}
+
+std::string join_path(const std::string& dir, const std::string& name) {
+  if (dir.empty()) {
+    return name;
+  }
+  return dir.back() == '/' ? dir + name : dir + "/" + name;
+}
+
+#ifndef DISABLE_CUDF
+std::string parquet_metadata_file(const RawAsyncRepackerParams& params,
+                                  const std::vector<std::string>& input_files) {
+  if (!params.parquet_metadata.empty()) {
+    return params.parquet_metadata;
+  }
+  const std::string& path{input_files.front()};
+  const size_t found{path.find_last_of('/')};
+  return found == std::string::npos ? "_metadata.json" : path.substr(0, found) + "/_metadata.json";
+}
+
+std::string base_name(const std::string& path) {
+  const size_t found{path.find_last_of('/')};
+  return found == std::string::npos ? path : path.substr(found + 1);
+}
+#endif
+
+/**
+ * @return The header of a Norm file. \p framed is set if the header and every sample are framed as
+ * [int length][payload][char sum], which is the case with checksums.
+ */
+DataSetHeader load_norm_header(const char* const data, const size_t size, bool& framed,
+                               const std::string& file_name) {
+  HCTR_THROW_IF(size < sizeof(DataSetHeader), Error_t::BrokenFile, "\"", file_name,
+                "\" is too short for a Norm dataset.");
+  framed = load<int>(data) == static_cast<int>(sizeof(DataSetHeader)) &&
+           size >= sizeof(int) + sizeof(DataSetHeader) + 1 &&
+           load<long long>(data + sizeof(int)) == 1;
+  const DataSetHeader header{load<DataSetHeader>(data + (framed ? sizeof(int) : 0))};
+  HCTR_THROW_IF(header.number_of_records < 0 || header.label_dim < 0 || header.dense_dim < 0 ||
+                    header.slot_num <= 0,
+                Error_t::BrokenFile, "\"", file_name, "\" has an invalid header.");
+  return header;
+}
+
+/**
+ * Writes all of \p size bytes, retrying short and interrupted writes.
+ */
+void pwrite_all(const int fd, const char* data, size_t size, off_t offset,
+                const std::string& file_name) {
+  while (size > 0) {
+    const ssize_t n{pwrite(fd, data, size, offset)};
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    HCTR_THROW_IF(n <= 0, Error_t::UnspecificError, "Write to \"", file_name,
+                  "\" failed: ", std::strerror(errno));
+    data += n;
+    size -= static_cast<size_t>(n);
+    offset += n;
+  }
+}
+
+/**
+ * Decodes samples of the fixed-size Raw and RawAsync layouts:
+ * [label_dense_dim x DenseType][total_nnz x KeyType].
+ */
+template <typename KeyType, typename DenseType>
+void decode_fixed(const char* ptr, const size_t num_samples, const size_t label_dense_dim,
+                  const size_t total_nnz, double* label_dense, int64_t* keys) {
+  for (size_t i{0}; i < num_samples; ++i) {
+    for (size_t j{0}; j < label_dense_dim; ++j, ptr += sizeof(DenseType)) {
+      *label_dense++ = static_cast<double>(load<DenseType>(ptr));
+    }
+    for (size_t j{0}; j < total_nnz; ++j, ptr += sizeof(KeyType)) {
+      *keys++ = static_cast<int64_t>(load<KeyType>(ptr));
+    }
+  }
+}
+
+}  // namespace
+
+/**
+ * Samples in decoded form, before they are converted to the output types.
+ */
+struct RawAsyncRepacker::Block {
+  size_t first_sample{0};  // Index in the output dataset.
+  size_t num_samples{0};
+  std::vector<double> label_dense;  // `num_samples x (label_dim + dense_dim)`, exact for int32.
+  std::vector<int64_t> keys;        // `num_samples x total_nnz`.
+};
+
+struct RawAsyncRepacker::Output {
+  struct File {
+    RawAsyncOutputFile desc;
+    bool label_dense{false};
+    size_t key_begin{0};  // Range of the sample's keys stored in this file.
+    size_t key_end{0};
+    std::vector<int> fds;  // One per stripe.
+  };
+
+  std::vector<File> files;
+  size_t stripe_size_bytes{0};
+
+  Output() = default;
+
+  HCTR_DISALLOW_COPY_AND_MOVE(Output);
+
+  ~Output() {
+    for (const File& file : files) {
+      for (const int fd : file.fds) {
+        close(fd);
+      }
+    }
+  }
+
+  /**
+   * Writes \p size bytes at logical \p offset of \p file , split into stripe units.
+   */
+  void write(const File& file, const char* data, size_t size, size_t offset) const {
+    const size_t num_stripes{file.fds.size()};
+    while (size > 0) {
+      const size_t unit{offset / stripe_size_bytes};
+      const size_t unit_offset{offset % stripe_size_bytes};
+      const size_t n{std::min(size, stripe_size_bytes - unit_offset)};
+      const size_t stripe{unit % num_stripes};
+      pwrite_all(file.fds[stripe], data, n,
+                 static_cast<off_t>((unit / num_stripes) * stripe_size_bytes + unit_offset),
+                 file.desc.stripes[stripe]);
+      data += n;
+      size -= n;
+      offset += n;
+    }
+  }
+
+  /**
+   * @return Size of \p stripe of a logical file of \p size bytes.
+   */
+  size_t stripe_size(const size_t stripe, const size_t num_stripes, const size_t size) const {
+    const size_t num_units{size / stripe_size_bytes};
+    const size_t tail{num_units % num_stripes};
+    return (num_units / num_stripes + (stripe < tail ? 1 : 0)) * stripe_size_bytes +
+           (stripe == tail ? size % stripe_size_bytes : 0);
+  }
+};
+
+RawAsyncRepacker::RawAsyncRepacker(const RawAsyncRepackerParams& params) : params_{params} {
+  HCTR_CHECK_HINT(params_.format == DataReaderType_t::Norm ||
+                      params_.format == DataReaderType_t::Raw ||
+                      params_.format == DataReaderType_t::RawAsync ||
+                      params_.format == DataReaderType_t::Parquet,
+                  "Unsupported input format.");
+  HCTR_CHECK_HINT(!params_.nnz_array.empty(), "nnz_array must not be empty.");
+  HCTR_CHECK_HINT(!params_.output_dirs.empty(), "Need at least one output directory.");
+  HCTR_CHECK_HINT(params_.num_threads > 0, "Need at least one thread.");
+  HCTR_CHECK_HINT(params_.io_alignment > 0, "io_alignment must be positive.");
+  HCTR_CHECK_HINT(
+      params_.stripe_size_bytes > 0 && params_.stripe_size_bytes % params_.io_alignment == 0,
+      "stripe_size_bytes must be a positive multiple of io_alignment.");
+  for (size_t slot{0}; slot < params_.nnz_array.size(); ++slot) {
+    HCTR_CHECK_HINT(params_.nnz_array[slot] > 0, "Slot ", slot, " must have a positive nnz.");
+    total_nnz_ += static_cast<size_t>(params_.nnz_array[slot]);
+  }
+
+  const size_t key_size{params_.i64_output_key ? sizeof(int64_t) : sizeof(uint32_t)};
+  const size_t label_dense_bytes{(params_.label_dim + params_.dense_dim) * sizeof(float)};
+  sample_size_bytes_ = label_dense_bytes + total_nnz_ * key_size;
+
+  // Smallest number of samples that fills an integral number of aligned IO units in every output
+  // file, scaled up to approximately match the requested block size.
+  std::vector<size_t> file_sample_sizes{sample_size_bytes_};
+  if (params_.layout == RawAsyncLayout::FeatureMajor) {
+    file_sample_sizes = {label_dense_bytes};
+    for (const int nnz : params_.nnz_array) {
+      file_sample_sizes.push_back(static_cast<size_t>(nnz) * key_size);
+    }
+  }
+  size_t unit{1};
+  for (const size_t size : file_sample_sizes) {
+    if (size > 0) {
+      unit = std::lcm(unit, params_.io_alignment / std::gcd(size, params_.io_alignment));
+    }
+  }
+  samples_per_block_ =
+      std::max(params_.block_size_bytes / (unit * sample_size_bytes_), size_t{1}) * unit;
+}
+
+std::vector<RawAsyncOutputFile> RawAsyncRepacker::output_files(
+    const std::string& output_name) const {
+  const size_t key_size{params_.i64_output_key ? sizeof(int64_t) : sizeof(uint32_t)};
+  std::vector<RawAsyncOutputFile> files;
+  if (params_.layout == RawAsyncLayout::BatchMajor) {
+    files.push_back({output_name, sample_size_bytes_, 0, {}});
+  } else {
+    files.push_back({output_name + ".label_dense",
+                     (params_.label_dim + params_.dense_dim) * sizeof(float), 0, {}});
+    for (size_t slot{0}; slot < params_.nnz_array.size(); ++slot) {
+      files.push_back({output_name + ".slot" + std::to_string(slot),
+                       static_cast<size_t>(params_.nnz_array[slot]) * key_size, slot + 1, {}});
+    }
+  }
+  for (RawAsyncOutputFile& file : files) {
+    for (const std::string& dir : params_.output_dirs) {
+      file.stripes.push_back(join_path(dir, file.name));
+    }
+  }
+  return files;
+}
+
+size_t RawAsyncRepacker::input_sample_size_() const {
+  const size_t key_size{params_.i64_input_key ? sizeof(int64_t) : sizeof(uint32_t)};
+  const size_t label_dense_dim{params_.label_dim + params_.dense_dim};
+  if (params_.format == DataReaderType_t::Norm) {
+    return label_dense_dim * sizeof(float) + params_.nnz_array.size() * sizeof(int) +
+           total_nnz_ * key_size;
+  }
+  const bool key_sized_dense{params_.format == DataReaderType_t::Raw && !params_.float_label_dense};
+  return label_dense_dim * (key_sized_dense ? key_size : sizeof(float)) + total_nnz_ * key_size;
+}
+
+std::vector<size_t> RawAsyncRepacker::count_samples_(
+    const std::vector<std::string>& input_files) const {
+  std::vector<size_t> counts;
+  if (params_.format == DataReaderType_t::Parquet) {
+#ifdef DISABLE_CUDF
+    HCTR_OWN_THROW(Error_t::WrongInput, "Parquet is not supported under DISABLE_CUDF");
+#else
+    Metadata metadata;
+    metadata.get_parquet_metadata(parquet_metadata_file(params_, input_files));
+    for (const std::string& file_name : input_files) {
+      counts.push_back(static_cast<size_t>(metadata.get_file_stats(base_name(file_name)).num_rows));
+    }
+#endif
+    return counts;
+  }
+
+  for (const std::string& file_name : input_files) {
+    const MappedFile file{file_name};
+    if (params_.format == DataReaderType_t::Norm) {
+      bool framed;
+      counts.push_back(static_cast<size_t>(
+          load_norm_header(file.data(), file.size(), framed, file_name).number_of_records));
+    } else {
+      const size_t sample_size{input_sample_size_()};
+      HCTR_THROW_IF(file.size() % sample_size != 0, Error_t::BrokenFile, "The size of \"",
+                    file_name, "\" (", file.size(),
+                    " bytes) is not a multiple of the sample size (", sample_size, " bytes).");
+      counts.push_back(file.size() / sample_size);
+    }
+  }
+  return counts;
+}
+
+RawAsyncRepackerStats RawAsyncRepacker::repack(const std::vector<std::string>& input_files,
+                                               const std::string& output_name) const {
+  HCTR_CHECK_HINT(!input_files.empty(), "No input files.");
+  const std::vector<size_t> counts{count_samples_(input_files)};
+
+  RawAsyncRepackerStats stats;
+  stats.num_samples = std::accumulate(counts.begin(), counts.end(), size_t{0});
+  if (params_.batch_size > 0) {
+    stats.num_samples -= stats.num_samples % params_.batch_size;
+  }
+  stats.num_bytes = stats.num_samples * sample_size_bytes_;
+  stats.num_blocks = (stats.num_samples + samples_per_block_ - 1) / samples_per_block_;
+
+  // Create all stripes and reserve their space upfront, so that the file system does not have to
+  // extend the files while concurrent writers fill holes.
+  Output output;
+  output.stripe_size_bytes = params_.stripe_size_bytes;
+  size_t key_begin{0};
+  for (RawAsyncOutputFile& desc : output_files(output_name)) {
+    Output::File file;
+    file.label_dense = desc.slot_id == 0;
+    file.key_begin = key_begin;
+    file.key_end = total_nnz_;
+    if (params_.layout == RawAsyncLayout::FeatureMajor) {
+      const size_t nnz{
+          desc.slot_id == 0 ? 0 : static_cast<size_t>(params_.nnz_array[desc.slot_id - 1])};
+      file.key_end = key_begin + nnz;
+    }
+    key_begin = file.key_end;
+    file.desc = std::move(desc);
+    output.files.push_back(std::move(file));
+
+    Output::File& f{output.files.back()};
+    const size_t size{stats.num_samples * f.desc.sample_size_bytes};
+    for (size_t stripe{0}; stripe < f.desc.stripes.size(); ++stripe) {
+      const std::string& stripe_name{f.desc.stripes[stripe]};
+      const int fd{open(stripe_name.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644)};
+      HCTR_THROW_IF(fd == -1, Error_t::FileCannotOpen, "Unable to open \"", stripe_name,
+                    "\" for writing: ", std::strerror(errno));
+      f.fds.push_back(fd);
+      const size_t stripe_size{output.stripe_size(stripe, f.desc.stripes.size(), size)};
+      HCTR_THROW_IF(ftruncate(fd, static_cast<off_t>(stripe_size)) != 0, Error_t::UnspecificError,
+                    "Unable to resize \"", stripe_name, "\": ", std::strerror(errno));
+    }
+  }
+
+  const auto t0{std::chrono::steady_clock::now()};
+
+  if (params_.format == DataReaderType_t::Parquet) {
+    repack_parquet_(input_files, stats.num_samples, output);
+  } else {
+    size_t first_sample{0};
+    for (size_t i{0}; i < input_files.size() && first_sample < stats.num_samples; ++i) {
+      const size_t num_samples{std::min(counts[i], stats.num_samples - first_sample)};
+      if (params_.format == DataReaderType_t::Norm) {
+        repack_norm_(input_files[i], first_sample, num_samples, output);
+      } else {
+        repack_fixed_(input_files[i], first_sample, num_samples, output);
+      }
+      first_sample += num_samples;
+    }
+  }
+
+  stats.elapsed_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+  nlohmann::json manifest;
+  manifest["layout"] =
+      params_.layout == RawAsyncLayout::BatchMajor ? "batch_major" : "feature_major";
+  manifest["num_samples"] = stats.num_samples;
+  manifest["label_dim"] = params_.label_dim;
+  manifest["dense_dim"] = params_.dense_dim;
+  manifest["nnz_array"] = params_.nnz_array;
+  manifest["i64_input_key"] = params_.i64_output_key;
+  manifest["float_label_dense"] = params_.float_output_label_dense;
+  manifest["stripe_size_bytes"] = params_.stripe_size_bytes;
+  manifest["files"] = nlohmann::json::array();
+  for (const Output::File& file : output.files) {
+    manifest["files"].push_back({{"name", file.desc.name},
+                                 {"sample_size_bytes", file.desc.sample_size_bytes},
+                                 {"slot_id", file.desc.slot_id},
+                                 {"stripes", file.desc.stripes}});
+  }
+  const std::string manifest_name{join_path(params_.output_dirs.front(), output_name + ".json")};
+  std::ofstream manifest_file(manifest_name);
+  HCTR_THROW_IF(!manifest_file.is_open(), Error_t::FileCannotOpen, "Unable to open \"",
+                manifest_name, "\" for writing.");
+  manifest_file << manifest.dump(2) << std::endl;
+
+  HCTR_LOG_S(INFO, WORLD) << "Repacked " << stats.num_samples << " samples into "
+                          << output.files.size() << " file(s) of " << params_.output_dirs.size()
+                          << " stripe(s) (" << stats.num_bytes
+                          << " bytes, " << stats.num_blocks << " blocks) in " << stats.elapsed_s
+                          << " s using " << params_.num_threads << " thread(s): " << stats.gbps()
+                          << " GB/s" << std::endl;
+  return stats;
+}
+
+void RawAsyncRepacker::run_(const std::function<bool(Block&)>& next_block,
+                            const Output& output) const {
+  std::atomic<bool> failed{false};
+  std::exception_ptr error;
+  std::mutex error_guard;
+  std::vector<std::thread> workers;
+  workers.reserve(params_.num_threads);
+  for (size_t i{0}; i < params_.num_threads; ++i) {
+    workers.emplace_back([&]() {
+      Block block;
+      std::vector<char, AlignedAllocator<char, 4096>> buffer(samples_per_block_ *
+                                                             sample_size_bytes_);
+      try {
+        while (!failed && next_block(block)) {
+          write_block_(block, output, buffer.data());
+        }
+      } catch (...) {
+        const std::lock_guard lock(error_guard);
+        if (!error) {
+          error = std::current_exception();
+        }
+        failed = true;
+      }
+    });
+  }
+  for (auto& worker : workers) {
+    worker.join();
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
+void RawAsyncRepacker::write_block_(const Block& block, const Output& output,
+                                    char* const buffer) const {
+  const size_t label_dense_dim{params_.label_dim + params_.dense_dim};
+  for (const Output::File& file : output.files) {
+    char* ptr{buffer};
+    for (size_t i{0}; i < block.num_samples; ++i) {
+      if (file.label_dense) {
+        const double* const label_dense{&block.label_dense[i * label_dense_dim]};
+        for (size_t j{0}; j < label_dense_dim; ++j, ptr += sizeof(float)) {
+          if (params_.float_output_label_dense) {
+            const float value{static_cast<float>(label_dense[j])};
+            std::memcpy(ptr, &value, sizeof(float));
+          } else {
+            const int32_t value{static_cast<int32_t>(label_dense[j])};
+            std::memcpy(ptr, &value, sizeof(int32_t));
+          }
+        }
+      }
+      const int64_t* const keys{&block.keys[i * total_nnz_]};
+      for (size_t j{file.key_begin}; j < file.key_end; ++j) {
+        if (params_.i64_output_key) {
+          std::memcpy(ptr, &keys[j], sizeof(int64_t));
+          ptr += sizeof(int64_t);
+        } else {
+          HCTR_THROW_IF(keys[j] < 0 || keys[j] > std::numeric_limits<uint32_t>::max(),
+                        Error_t::OutOfBound, "Key ", keys[j], " of sample ",
+                        block.first_sample + i, " exceeds the 32 bit key range.");
+          const uint32_t key{static_cast<uint32_t>(keys[j])};
+          std::memcpy(ptr, &key, sizeof(uint32_t));
+          ptr += sizeof(uint32_t);
+        }
+      }
+    }
+    output.write(file, buffer, block.num_samples * file.desc.sample_size_bytes,
+                 block.first_sample * file.desc.sample_size_bytes);
+  }
+}
+
+void RawAsyncRepacker::repack_fixed_(const std::string& file_name, const size_t first_sample,
+                                     const size_t num_samples, const Output& output) const {
+  const MappedFile file{file_name};
+  const size_t label_dense_dim{params_.label_dim + params_.dense_dim};
+  const size_t sample_size{input_sample_size_()};
+  const bool raw{params_.format == DataReaderType_t::Raw};
+
+  std::atomic<size_t> next_sample{0};
+  run_(
+      [&](Block& block) {
+        const size_t begin{next_sample.fetch_add(samples_per_block_, std::memory_order_relaxed)};
+        if (begin >= num_samples) {
+          return false;
+        }
+        block.first_sample = first_sample + begin;
+        block.num_samples = std::min(samples_per_block_, num_samples - begin);
+        block.label_dense.resize(block.num_samples * label_dense_dim);
+        block.keys.resize(block.num_samples * total_nnz_);
+
+        const char* const data{file.data() + begin * sample_size};
+        double* const label_dense{block.label_dense.data()};
+        int64_t* const keys{block.keys.data()};
+        if (params_.i64_input_key) {
+          if (params_.float_label_dense) {
+            decode_fixed<int64_t, float>(data, block.num_samples, label_dense_dim, total_nnz_,
+                                         label_dense, keys);
+          } else if (raw) {
+            decode_fixed<int64_t, int64_t>(data, block.num_samples, label_dense_dim, total_nnz_,
+                                           label_dense, keys);
+          } else {
+            decode_fixed<int64_t, int32_t>(data, block.num_samples, label_dense_dim, total_nnz_,
+                                           label_dense, keys);
+          }
+        } else {
+          if (params_.float_label_dense) {
+            decode_fixed<uint32_t, float>(data, block.num_samples, label_dense_dim, total_nnz_,
+                                          label_dense, keys);
+          } else if (raw) {
+            decode_fixed<uint32_t, uint32_t>(data, block.num_samples, label_dense_dim, total_nnz_,
+                                             label_dense, keys);
+          } else {
+            decode_fixed<uint32_t, int32_t>(data, block.num_samples, label_dense_dim, total_nnz_,
+                                            label_dense, keys);
+          }
+        }
+        return true;
+      },
+      output);
+}
+
+void RawAsyncRepacker::repack_norm_(const std::string& file_name, const size_t first_sample,
+                                    const size_t num_samples, const Output& output) const {
+  const MappedFile file{file_name};
+  const char* const data{file.data()};
+  bool framed;
+  const DataSetHeader header{load_norm_header(data, file.size(), framed, file_name)};
+  HCTR_THROW_IF(header.label_dim != static_cast<long long>(params_.label_dim) ||
+                    header.dense_dim != static_cast<long long>(params_.dense_dim) ||
+                    header.slot_num != static_cast<long long>(params_.nnz_array.size()),
+                Error_t::WrongInput, "The header of \"", file_name,
+                "\" does not match label_dim, dense_dim and nnz_array.");
+
+  // Since every sample must match `nnz_array`, all samples have the same size, and blocks are
+  // found by arithmetic. Decoding checks the nnz of each sample, which catches the first sample
+  // that does not match, before any sample after it is misread.
+  const size_t payload_size{input_sample_size_()};
+  const size_t record_size{framed ? sizeof(int) + payload_size + 1 : payload_size};
+  const size_t data_begin{framed ? sizeof(int) + sizeof(DataSetHeader) + 1
+                                 : sizeof(DataSetHeader)};
+  const size_t key_size{params_.i64_input_key ? sizeof(long long) : sizeof(unsigned int)};
+  const size_t label_dense_dim{params_.label_dim + params_.dense_dim};
+
+  std::atomic<size_t> next_sample{0};
+  run_(
+      [&](Block& block) {
+        const size_t begin{next_sample.fetch_add(samples_per_block_, std::memory_order_relaxed)};
+        if (begin >= num_samples) {
+          return false;
+        }
+        block.first_sample = first_sample + begin;
+        block.num_samples = std::min(samples_per_block_, num_samples - begin);
+        block.label_dense.resize(block.num_samples * label_dense_dim);
+        block.keys.resize(block.num_samples * total_nnz_);
+
+        double* label_dense{block.label_dense.data()};
+        int64_t* keys{block.keys.data()};
+        size_t pos{data_begin + begin * record_size};
+        for (size_t i{0}; i < block.num_samples; ++i) {
+          HCTR_THROW_IF(pos + record_size > file.size(), Error_t::BrokenFile, "\"", file_name,
+                        "\" ends within sample ", begin + i, ".");
+          if (framed) {
+            HCTR_THROW_IF(load<int>(data + pos) != static_cast<int>(payload_size),
+                          Error_t::WrongInput, "Sample ", begin + i, " of \"", file_name,
+                          "\" does not match nnz_array.");
+            pos += sizeof(int);
+          }
+          for (size_t j{0}; j < label_dense_dim; ++j, pos += sizeof(float)) {
+            *label_dense++ = load<float>(data + pos);
+          }
+          for (size_t slot{0}; slot < params_.nnz_array.size(); ++slot) {
+            const int nnz{load<int>(data + pos)};
+            HCTR_THROW_IF(nnz != params_.nnz_array[slot], Error_t::WrongInput, "Sample ",
+                          begin + i, " of \"", file_name, "\" has ", nnz, " keys in slot ", slot,
+                          " instead of ", params_.nnz_array[slot], ".");
+            pos += sizeof(int);
+            for (int k{0}; k < nnz; ++k, pos += key_size) {
+              *keys++ = params_.i64_input_key
+                            ? load<long long>(data + pos)
+                            : static_cast<int64_t>(load<unsigned int>(data + pos));
+            }
+          }
+          if (framed) {
+            pos += 1;
+          }
+        }
+        return true;
+      },
+      output);
+}
+
+void RawAsyncRepacker::repack_parquet_(const std::vector<std::string>& input_files,
+                                       const size_t num_samples, const Output& output) const {
+#ifdef DISABLE_CUDF
+  HCTR_OWN_THROW(Error_t::WrongInput, "Parquet is not supported under DISABLE_CUDF");
+#else
+  using Decoder = ParquetCPUDecoder<long long, int64_t>;
+
+  Metadata metadata;
+  metadata.get_parquet_metadata(parquet_metadata_file(params_, input_files));
+  const std::vector<std::string> label_dense_cols{Decoder::label_dense_columns(metadata)};
+  const std::vector<std::string> cat_cols{Decoder::cat_columns(metadata)};
+  HCTR_THROW_IF(cat_cols.size() != params_.nnz_array.size(), Error_t::WrongInput,
+                "The dataset has ", cat_cols.size(), " categorical columns, but nnz_array has ",
+                params_.nnz_array.size(), " entries.");
+  const size_t num_slots{params_.nnz_array.size()};
+  const std::vector<DataReaderSparseParam> sparse_params{
+      {"data", params_.nnz_array, false, static_cast<int>(num_slots)}};
+  Decoder decoder{label_dense_cols, cat_cols, sparse_params, {}, params_.num_threads, false};
+
+  std::vector<std::pair<std::string, int>> row_groups;
+  for (const std::string& file_name : input_files) {
+    const int num_groups{Decoder::num_row_groups(file_name)};
+    for (int rg{0}; rg < num_groups; ++rg) {
+      row_groups.emplace_back(file_name, rg);
+    }
+  }
+
+  // Keep the decoder busy, without holding more than a few row groups in memory.
+  const size_t max_pending{2 * params_.num_threads};
+  size_t next_row_group{0};
+  for (; next_row_group < std::min(max_pending, row_groups.size()); ++next_row_group) {
+    decoder.submit(row_groups[next_row_group].first, row_groups[next_row_group].second);
+  }
+
+  const size_t label_dense_dim{params_.label_dim + params_.dense_dim};
+  std::mutex guard;
+  std::unique_ptr<Decoder::Batch> batch;
+  size_t row{0};
+  size_t next_sample{0};
+
+  // Row groups arrive in order and are copied into blocks under the lock. Conversion and writes
+  // happen outside of it.
+  run_(
+      [&](Block& block) {
+        const std::lock_guard lock(guard);
+        if (next_sample >= num_samples) {
+          return false;
+        }
+        block.first_sample = next_sample;
+        block.num_samples = std::min(samples_per_block_, num_samples - next_sample);
+        block.label_dense.resize(block.num_samples * label_dense_dim);
+        block.keys.resize(block.num_samples * total_nnz_);
+
+        double* label_dense{block.label_dense.data()};
+        int64_t* keys{block.keys.data()};
+        for (size_t i{0}; i < block.num_samples; ++i, ++row) {
+          while (!batch || row == batch->num_rows) {
+            if (batch) {
+              decoder.recycle(std::move(batch));
+            }
+            batch = decoder.next();
+            row = 0;
+            if (next_row_group < row_groups.size()) {
+              decoder.submit(row_groups[next_row_group].first, row_groups[next_row_group].second);
+              ++next_row_group;
+            }
+            HCTR_THROW_IF(batch->label_dense_dim != label_dense_dim, Error_t::WrongInput,
+                          "The dataset has ", batch->label_dense_dim,
+                          " label and dense values per sample instead of ", label_dense_dim, ".");
+          }
+
+          const float* const values{batch->label_dense.data() + row * label_dense_dim};
+          label_dense = std::copy(values, values + label_dense_dim, label_dense);
+
+          const auto& sparse{batch->sparse[0]};
+          for (size_t slot{0}; slot < num_slots; ++slot) {
+            const int64_t* const offsets{sparse.row_offsets.data() + row * num_slots + slot};
+            const int64_t nnz{offsets[1] - offsets[0]};
+            HCTR_THROW_IF(nnz != params_.nnz_array[slot], Error_t::WrongInput, "Sample ",
+                          next_sample + i, " has ", nnz, " keys in slot ", slot, " instead of ",
+                          params_.nnz_array[slot], ".");
+            keys = std::copy(sparse.values.data() + offsets[0], sparse.values.data() + offsets[1],
+                             keys);
+          }
+        }
+        next_sample += block.num_samples;
+        return true;
+      },
+      output);
+#endif
+}
+
+}  // namespace HugeCTR
@@ -782,7 +782,14 @@ void DistributedSlotSparseEmbeddingHash<TypeHashKey, TypeEmbeddingComp>::load_pa
 template <typename TypeHashKey, typename TypeEmbeddingComp>
 void DistributedSlotSparseEmbeddingHash<TypeHashKey, TypeEmbeddingComp>::dump_parameters(
     std::string sparse_model) const {
-  dump_parameters(sparse_model, max_vocabulary_size_,
+  auto fs = FileSystemBuilder::build_unique_by_path(sparse_model);
+  dump_parameters(sparse_model, *fs);
+}
+
+template <typename TypeHashKey, typename TypeEmbeddingComp>
+void DistributedSlotSparseEmbeddingHash<TypeHashKey, TypeEmbeddingComp>::dump_parameters(
+    const std::string &sparse_model, FileSystem &fs) const {
+  dump_parameters(sparse_model, fs, max_vocabulary_size_,
                   embedding_data_.embedding_params_.embedding_vec_size, hash_table_value_tensors_,
                   hash_tables_);
 }
@@ -800,20 +807,20 @@ void DistributedSlotSparseEmbeddingHash<TypeHashKey, TypeEmbeddingComp>::dump_pa
 
 template <typename TypeHashKey, typename TypeEmbeddingComp>
 void DistributedSlotSparseEmbeddingHash<TypeHashKey, TypeEmbeddingComp>::dump_parameters(
-    const std::string &sparse_model, size_t vocabulary_size, size_t embedding_vec_size,
-    const Tensors2<float> &hash_table_value_tensors,
+    const std::string &sparse_model, FileSystem &fs, size_t vocabulary_size,
+    size_t embedding_vec_size, const Tensors2<float> &hash_table_value_tensors,
     const std::vector<std::shared_ptr<HashTable<TypeHashKey, size_t>>> &hash_tables) const {
   CudaDeviceContext context;
   size_t local_gpu_count = embedding_data_.get_resource_manager().get_local_gpu_count();
 
-  auto fs = FileSystemBuilder::build_unique_by_path(sparse_model);
   bool is_local_path = IOUtils::is_local_path(sparse_model);
   const std::string key_file(sparse_model + "/key");
   const std::string vec_file(sparse_model + "/emb_vector");
 
 #ifdef ENABLE_MPI
   HCTR_CHECK_HINT(is_local_path, "Dumping to remote file system in MPI mode is not supported.");
-  fs->create_dir(sparse_model);
+  // MPI-IO writes the files directly. Hence, the folder must exist regardless of `fs`.
+  FileSystemBuilder::build_unique_by_path(sparse_model)->create_dir(sparse_model);
   MPI_File key_fh, vec_fh;
   HCTR_MPI_THROW(MPI_File_open(MPI_COMM_WORLD, key_file.c_str(), MPI_MODE_CREATE | MPI_MODE_WRONLY,
                                MPI_INFO_NULL, &key_fh));
@@ -938,8 +945,8 @@ void DistributedSlotSparseEmbeddingHash<TypeHashKey, TypeEmbeddingComp>::dump_pa
   HCTR_MPI_THROW(MPI_File_close(&vec_fh));
   HCTR_MPI_THROW(MPI_Type_free(&TYPE_EMB_VECTOR));
 #else
-  fs->write(key_file, reinterpret_cast<char *>(h_key_ptr), total_count * key_size, true);
-  fs->write(vec_file, reinterpret_cast<char *>(h_hash_table_value), total_count * vec_size, true);
+  fs.write(key_file, reinterpret_cast<char *>(h_key_ptr), total_count * key_size, true);
+  fs.write(vec_file, reinterpret_cast<char *>(h_hash_table_value), total_count * vec_size, true);
 #endif
 
   for (size_t id = 0; id < local_gpu_count; id++) {
@@ -1044,6 +1051,13 @@ void DistributedSlotSparseEmbeddingHash<TypeHashKey, TypeEmbeddingComp>::dump_pa
 template <typename TypeHashKey, typename TypeEmbeddingComp>
 void DistributedSlotSparseEmbeddingHash<TypeHashKey, TypeEmbeddingComp>::dump_opt_states(
     std::string write_path) {
+  auto fs = FileSystemBuilder::build_unique_by_path(write_path);
+  dump_opt_states(write_path, *fs);
+}
+
+template <typename TypeHashKey, typename TypeEmbeddingComp>
+void DistributedSlotSparseEmbeddingHash<TypeHashKey, TypeEmbeddingComp>::dump_opt_states(
+    const std::string &write_path, FileSystem &fs) {
   std::vector<OptimizerTensor<TypeEmbeddingComp>> opt_tensors_;
   for (auto &opt : embedding_optimizers_) {
     opt_tensors_.push_back(opt.opt_tensors_);
@@ -1052,7 +1066,7 @@ void DistributedSlotSparseEmbeddingHash<TypeHashKey, TypeEmbeddingComp>::dump_op
       functors_.get_opt_states(opt_tensors_, embedding_data_.embedding_params_.opt_params.optimizer,
                                embedding_data_.get_resource_manager().get_local_gpu_count());
 
-  functors_.dump_opt_states(write_path, embedding_data_.get_resource_manager(), opt_states);
+  functors_.dump_opt_states(write_path, fs, embedding_data_.get_resource_manager(), opt_states);
 }
 
 template <typename TypeHashKey, typename TypeEmbeddingComp>
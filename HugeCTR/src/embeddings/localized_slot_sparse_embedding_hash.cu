@@ -932,7 +932,14 @@ void LocalizedSlotSparseEmbeddingHash<TypeHashKey, TypeEmbeddingComp>::load_para
 template <typename TypeHashKey, typename TypeEmbeddingComp>
 void LocalizedSlotSparseEmbeddingHash<TypeHashKey, TypeEmbeddingComp>::dump_parameters(
     std::string sparse_model) const {
-  dump_parameters(sparse_model, max_vocabulary_size_,
+  auto fs = FileSystemBuilder::build_unique_by_path(sparse_model);
+  dump_parameters(sparse_model, *fs);
+}
+
+template <typename TypeHashKey, typename TypeEmbeddingComp>
+void LocalizedSlotSparseEmbeddingHash<TypeHashKey, TypeEmbeddingComp>::dump_parameters(
+    const std::string &sparse_model, FileSystem &fs) const {
+  dump_parameters(sparse_model, fs, max_vocabulary_size_,
                   embedding_data_.embedding_params_.embedding_vec_size, hash_table_value_tensors_,
                   hash_table_slot_id_tensors_, hash_tables_);
 }
@@ -952,14 +959,13 @@ void LocalizedSlotSparseEmbeddingHash<TypeHashKey, TypeEmbeddingComp>::dump_para
 
 template <typename TypeHashKey, typename TypeEmbeddingComp>
 void LocalizedSlotSparseEmbeddingHash<TypeHashKey, TypeEmbeddingComp>::dump_parameters(
-    const std::string &sparse_model, size_t vocabulary_size, size_t embedding_vec_size,
-    const Tensors2<float> &hash_table_value_tensors,
+    const std::string &sparse_model, FileSystem &fs, size_t vocabulary_size,
+    size_t embedding_vec_size, const Tensors2<float> &hash_table_value_tensors,
     const Tensors2<size_t> &hash_table_slot_id_tensors,
     const std::vector<std::shared_ptr<HashTable<TypeHashKey, size_t>>> &hash_tables) const {
   CudaDeviceContext context;
   size_t local_gpu_count = embedding_data_.get_resource_manager().get_local_gpu_count();
 
-  auto fs = FileSystemBuilder::build_unique_by_path(sparse_model);
   bool is_local_path = IOUtils::is_local_path(sparse_model);
   const std::string key_file(sparse_model + "/key");
   const std::string slot_file(sparse_model + "/slot_id");
@@ -967,7 +973,8 @@ void LocalizedSlotSparseEmbeddingHash<TypeHashKey, TypeEmbeddingComp>::dump_para
 
 #ifdef ENABLE_MPI
   HCTR_CHECK_HINT(is_local_path, "Dumping to remote file system in MPI mode is not supported.");
-  fs->create_dir(sparse_model);
+  // MPI-IO writes the files directly. Hence, the folder must exist regardless of `fs`.
+  FileSystemBuilder::build_unique_by_path(sparse_model)->create_dir(sparse_model);
   MPI_File key_fh, slot_fh, vec_fh;
   HCTR_MPI_THROW(MPI_File_open(MPI_COMM_WORLD, key_file.c_str(), MPI_MODE_CREATE | MPI_MODE_WRONLY,
                                MPI_INFO_NULL, &key_fh));
@@ -1110,10 +1117,10 @@ void LocalizedSlotSparseEmbeddingHash<TypeHashKey, TypeEmbeddingComp>::dump_para
   HCTR_MPI_THROW(MPI_File_close(&vec_fh));
   HCTR_MPI_THROW(MPI_Type_free(&TYPE_EMB_VECTOR));
 #else
-  fs->write(key_file, reinterpret_cast<char *>(h_key_ptr), total_count * key_size, true);
-  fs->write(slot_file, reinterpret_cast<char *>(h_hash_table_slot_id), total_count * slot_size,
+  fs.write(key_file, reinterpret_cast<char *>(h_key_ptr), total_count * key_size, true);
+  fs.write(slot_file, reinterpret_cast<char *>(h_hash_table_slot_id), total_count * slot_size,
             true);
-  fs->write(vec_file, reinterpret_cast<char *>(h_hash_table_value), total_count * vec_size, true);
+  fs.write(vec_file, reinterpret_cast<char *>(h_hash_table_value), total_count * vec_size, true);
 #endif
   HCTR_LOG(INFO, ROOT, "Done\n");
 
@@ -1232,6 +1239,13 @@ void LocalizedSlotSparseEmbeddingHash<TypeHashKey, TypeEmbeddingComp>::dump_para
 template <typename TypeHashKey, typename TypeEmbeddingComp>
 void LocalizedSlotSparseEmbeddingHash<TypeHashKey, TypeEmbeddingComp>::dump_opt_states(
     std::string write_path) {
+  auto fs = FileSystemBuilder::build_unique_by_path(write_path);
+  dump_opt_states(write_path, *fs);
+}
+
+template <typename TypeHashKey, typename TypeEmbeddingComp>
+void LocalizedSlotSparseEmbeddingHash<TypeHashKey, TypeEmbeddingComp>::dump_opt_states(
+    const std::string &write_path, FileSystem &fs) {
   std::vector<OptimizerTensor<TypeEmbeddingComp>> opt_tensors_;
   for (auto &opt : embedding_optimizers_) {
     opt_tensors_.push_back(opt.opt_tensors_);
@@ -1240,7 +1254,7 @@ void LocalizedSlotSparseEmbeddingHash<TypeHashKey, TypeEmbeddingComp>::dump_opt_
       functors_.get_opt_states(opt_tensors_, embedding_data_.embedding_params_.opt_params.optimizer,
                                embedding_data_.get_resource_manager().get_local_gpu_count());
 
-  functors_.dump_opt_states(write_path, embedding_data_.get_resource_manager(), opt_states);
+  functors_.dump_opt_states(write_path, fs, embedding_data_.get_resource_manager(), opt_states);
 }
 
 template <typename TypeHashKey, typename TypeEmbeddingComp>
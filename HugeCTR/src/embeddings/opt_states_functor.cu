@@ -75,7 +75,7 @@ std::vector<Tensors2<TypeEmbeddingComp>> SparseEmbeddingFunctors::get_opt_states
 
 template <typename TypeEmbeddingComp>
 void SparseEmbeddingFunctors::dump_opt_states(
-    std::string& write_path, const ResourceManager& resource_manager,
+    const std::string& write_path, FileSystem& fs, const ResourceManager& resource_manager,
     std::vector<Tensors2<TypeEmbeddingComp>>& opt_states) {
   size_t local_gpu_count = resource_manager.get_local_gpu_count();
 
@@ -109,12 +109,11 @@ void SparseEmbeddingFunctors::dump_opt_states(
     int pid = resource_manager.get_process_id();
     if (resource_manager.is_master_process()) {
       HCTR_LOG_S(INFO, WORLD) << "Rank" << pid << ": Write optimzer state to file" << std::endl;
-      auto fs = FileSystemBuilder::build_unique_by_path(write_path);
       if (!append_flag) {
-        fs->write(write_path, h_opt_state.get(), total_size, true);
+        fs.write(write_path, h_opt_state.get(), total_size, true);
         append_flag = true;
       } else {
-        fs->write(write_path, h_opt_state.get(), total_size, false);
+        fs.write(write_path, h_opt_state.get(), total_size, false);
       }
     }
 #ifdef ENABLE_MPI
@@ -138,12 +137,11 @@ void SparseEmbeddingFunctors::dump_opt_states(
         HCTR_MPI_THROW(MPI_Recv(h_opt_state.get(), recv_size, MPI_CHAR, r, tag, MPI_COMM_WORLD,
                                 MPI_STATUS_IGNORE));
 
-        auto fs = FileSystemBuilder::build_unique_by_path(write_path);
         if (!append_flag) {
-          fs->write(write_path, h_opt_state.get(), recv_size, true);
+          fs.write(write_path, h_opt_state.get(), recv_size, true);
           append_flag = true;
         } else {
-          fs->write(write_path, h_opt_state.get(), recv_size, false);
+          fs.write(write_path, h_opt_state.get(), recv_size, false);
         }
       }
     }
@@ -249,11 +247,11 @@ template std::vector<Tensors2<__half>> SparseEmbeddingFunctors::get_opt_states(
     size_t local_gpu_count);
 
 template void SparseEmbeddingFunctors::dump_opt_states<float>(
-    std::string& write_path, const ResourceManager& resource_manager,
+    const std::string& write_path, FileSystem& fs, const ResourceManager& resource_manager,
     std::vector<Tensors2<float>>& opt_states);
 
 template void SparseEmbeddingFunctors::dump_opt_states<__half>(
-    std::string& write_path, const ResourceManager& resource_manager,
+    const std::string& write_path, FileSystem& fs, const ResourceManager& resource_manager,
     std::vector<Tensors2<__half>>& opt_states);
 
 template void SparseEmbeddingFunctors::load_opt_states<float>(
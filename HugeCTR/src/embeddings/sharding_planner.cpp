@@ -0,0 +1,643 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <core23/logger.hpp>
+#include <embeddings/sharding_planner.hpp>
+#include <limits>
+#include <numeric>
+
+namespace HugeCTR {
+
+namespace {
+
+/**
+ * Candidates are ranked by memory overflow first, then by step time, and then by how evenly the
+ * load is spread, so that moves which do not change the slowest GPU can still make progress.
+ */
+struct Score {
+  double overflow;
+  double step_time;
+  double balance;
+
+  bool operator<(const Score& other) const {
+    constexpr double rel_eps{1e-9};
+    if (overflow > 0 || other.overflow > 0) {
+      if (std::abs(overflow - other.overflow) > rel_eps * std::max(overflow, other.overflow)) {
+        return overflow < other.overflow;
+      }
+    }
+    if (std::abs(step_time - other.step_time) > rel_eps * std::max(step_time, other.step_time)) {
+      return step_time < other.step_time;
+    }
+    return balance < other.balance * (1 - rel_eps);
+  }
+};
+
+}  // namespace
+
+/**
+ * Accumulates the modeled cost of a (partial) plan. Tables can be added and removed in O(#GPUs),
+ * which keeps the search cheap.
+ */
+class ShardingPlanner::State {
+ public:
+  State(const ShardingPlanner& planner, const bool hierarchical)
+      : hw_{planner.hardware_},
+        hierarchical_{hierarchical},
+        num_gpus_{planner.hardware_.num_gpus()},
+        batch_size_{static_cast<double>(planner.params_.batch_size)},
+        key_bytes_{static_cast<double>(planner.params_.key_type_size)},
+        memory_(num_gpus_),
+        lookup_time_(num_gpus_),
+        num_shards_(num_gpus_),
+        keys_(num_gpus_),
+        outputs_(num_gpus_) {
+    const double local_batch_size{batch_size_ / static_cast<double>(num_gpus_)};
+    for (size_t i{0}; i < planner.tables_.size(); ++i) {
+      const ShardingTableStats& stats{planner.tables_[i]};
+      Table& table{tables_.emplace_back()};
+      table.rows = static_cast<double>(stats.vocabulary_size);
+      table.row_bytes = static_cast<double>(stats.ev_size * planner.params_.emb_type_size);
+      table.state_bytes =
+          table.row_bytes * static_cast<double>(1 + planner.params_.optimizer_states);
+      table.keys_per_sample = stats.hotness;
+      table.pooled_bytes = table.row_bytes * stats.num_lookups;
+      table.concat = stats.concat;
+
+      // Forward reads each unique row once. Backward reads and writes the rows and their states.
+      table.update_bytes = table.row_bytes + 2 * table.state_bytes;
+      table.unique_global = planner.expected_unique_keys(i, batch_size_ * stats.hotness);
+      table.unique_local = planner.expected_unique_keys(i, local_batch_size * stats.hotness);
+    }
+  }
+
+  inline size_t num_gpus() const { return num_gpus_; }
+
+  inline double memory_limit() const { return hw_.memory_per_gpu; }
+
+  inline double free_memory(const size_t gpu) const { return hw_.memory_per_gpu - memory_[gpu]; }
+
+  inline double replica_memory(const size_t table) const {
+    return tables_[table].rows * tables_[table].state_bytes;
+  }
+
+  inline double shard_memory(const size_t table, const size_t num_shards) const {
+    return replica_memory(table) / static_cast<double>(num_shards);
+  }
+
+  inline size_t num_shards(const size_t gpu) const {
+    return static_cast<size_t>(std::lround(num_shards_[gpu]));
+  }
+
+  /**
+   * @return Rough time to serve \p table on a single GPU, used to order the tables.
+   */
+  double work(const size_t table) const {
+    const Table& t{tables_[table]};
+    return t.unique_global * t.update_bytes / hw_.hbm_bandwidth +
+           batch_size_ * t.pooled_bytes / hw_.intra_node_bandwidth;
+  }
+
+  void add(const size_t table, const ShardingTablePlacement& placement, const double sign = 1) {
+    const Table& t{tables_[table]};
+    const double gpn{static_cast<double>(hw_.gpus_per_node)};
+    const double num_gpus{static_cast<double>(num_gpus_)};
+    const double local_batch_size{batch_size_ / num_gpus};
+
+    if (placement.data_parallel) {
+      for (size_t gpu{0}; gpu < num_gpus_; ++gpu) {
+        memory_[gpu] += sign * replica_memory(table);
+        lookup_time_[gpu] +=
+            sign * (t.unique_local * t.update_bytes / hw_.hbm_bandwidth + hw_.table_overhead);
+        num_shards_[gpu] += sign;
+      }
+      all_reduce_bytes_ += sign * t.rows * t.row_bytes;
+      return;
+    }
+
+    const double k{static_cast<double>(placement.gpus.size())};
+    std::vector<double> shards_per_node(hw_.num_nodes);
+    std::vector<bool> is_shard(num_gpus_);
+    for (const int gpu : placement.gpus) {
+      shards_per_node[gpu / hw_.gpus_per_node] += 1;
+      is_shard[gpu] = true;
+    }
+
+    // Lookup and update of the shards, and the keys they receive from all GPUs.
+    const double keys_per_shard{batch_size_ * t.keys_per_sample / k * key_bytes_};
+    for (const int gpu : placement.gpus) {
+      memory_[gpu] += sign * replica_memory(table) / k;
+      lookup_time_[gpu] +=
+          sign * (t.unique_global / k * t.update_bytes / hw_.hbm_bandwidth + hw_.table_overhead);
+      num_shards_[gpu] += sign;
+      keys_[gpu].recv_local += sign * keys_per_shard * (gpn - 1) / num_gpus;
+      keys_[gpu].recv_remote += sign * keys_per_shard * (num_gpus - gpn) / num_gpus;
+    }
+
+    const bool reduce_in_node{hierarchical_ && !t.concat};
+    for (size_t gpu{0}; gpu < num_gpus_; ++gpu) {
+      const double node_shards{shards_per_node[gpu / hw_.gpus_per_node]};
+      const double self{is_shard[gpu] ? 1. : 0.};
+
+      // Each GPU sends its keys to the shards.
+      const double keys{local_batch_size * t.keys_per_sample * key_bytes_};
+      keys_[gpu].send_local += sign * keys * (node_shards - self) / k;
+      keys_[gpu].send_remote += sign * keys * (k - node_shards) / k;
+
+      if (reduce_in_node) {
+        // Pooled partial results are reduced within each node before they cross the network. Hence,
+        // each node sends one result per sample instead of one per shard.
+        const double num_nodes{static_cast<double>(hw_.num_nodes)};
+        const double node_batch{batch_size_ / num_nodes * t.pooled_bytes};
+        if (is_shard[gpu]) {
+          const double reduce{batch_size_ * t.pooled_bytes * (gpn - 1) / gpn};
+          outputs_[gpu].send_local += sign * (reduce + node_batch / gpn * (gpn - 1) / gpn);
+          outputs_[gpu].recv_local += sign * reduce;
+          outputs_[gpu].send_remote += sign * node_batch / gpn * (num_nodes - 1);
+        }
+        const double own_node{node_shards > 0 ? 1. : 0.};
+        outputs_[gpu].recv_local += sign * own_node * local_batch_size * t.pooled_bytes;
+        outputs_[gpu].recv_remote +=
+            sign * local_batch_size * t.pooled_bytes * (k / gpn - own_node);
+      } else {
+        // Pooled lookups return one partial result per shard. Concatenated lookups return the
+        // shard's share of the embeddings.
+        const double per_gpu{t.concat ? local_batch_size * t.keys_per_sample * t.row_bytes / k
+                                      : local_batch_size * t.pooled_bytes};
+        if (is_shard[gpu]) {
+          outputs_[gpu].send_local += sign * per_gpu * (gpn - 1);
+          outputs_[gpu].send_remote += sign * per_gpu * (num_gpus - gpn);
+        }
+        outputs_[gpu].recv_local += sign * per_gpu * (node_shards - self);
+        outputs_[gpu].recv_remote += sign * per_gpu * (k - node_shards);
+      }
+    }
+  }
+
+  double comm_time(const size_t gpu) const {
+    const Traffic& k{keys_[gpu]};
+    const Traffic& o{outputs_[gpu]};
+    const double intra{hw_.intra_node_bandwidth};
+    const double inter{hw_.inter_node_bandwidth};
+
+    // Forward moves keys and embeddings, backward moves gradients the opposite way.
+    const double fwd{std::max(
+        std::max(k.send_remote + o.send_remote, k.recv_remote + o.recv_remote) / inter,
+        std::max(k.send_local + o.send_local, k.recv_local + o.recv_local) / intra)};
+    const double bwd{std::max(std::max(o.send_remote, o.recv_remote) / inter,
+                              std::max(o.send_local, o.recv_local) / intra)};
+    return fwd + bwd;
+  }
+
+  inline double load(const size_t gpu) const { return lookup_time_[gpu] + comm_time(gpu); }
+
+  double total_load() const {
+    double total{0};
+    for (size_t gpu{0}; gpu < num_gpus_; ++gpu) {
+      total += load(gpu);
+    }
+    return total;
+  }
+
+  double all_reduce_time() const {
+    if (num_gpus_ < 2) {
+      return 0;
+    }
+    const double num_gpus{static_cast<double>(num_gpus_)};
+    const double bandwidth{hw_.num_nodes > 1 ? hw_.inter_node_bandwidth
+                                             : hw_.intra_node_bandwidth};
+    return 2 * (num_gpus - 1) / num_gpus * all_reduce_bytes_ / bandwidth;
+  }
+
+  Score score() const {
+    Score score{0, 0, 0};
+    for (size_t gpu{0}; gpu < num_gpus_; ++gpu) {
+      const double load{this->load(gpu)};
+      score.overflow = std::max(score.overflow, memory_[gpu] - hw_.memory_per_gpu);
+      score.step_time = std::max(score.step_time, load);
+      score.balance += load * load;
+    }
+    score.step_time += all_reduce_time();
+    return score;
+  }
+
+  ShardingCost cost() const {
+    ShardingCost cost;
+    cost.all_reduce_time = all_reduce_time();
+    cost.step_time = score().step_time;
+    for (size_t gpu{0}; gpu < num_gpus_; ++gpu) {
+      cost.lookup_time.push_back(lookup_time_[gpu]);
+      cost.comm_time.push_back(comm_time(gpu));
+      cost.memory.push_back(memory_[gpu]);
+      cost.fits &= memory_[gpu] <= hw_.memory_per_gpu;
+    }
+    return cost;
+  }
+
+ private:
+  struct Table {
+    double rows;
+    double row_bytes;
+    double state_bytes;  // Row plus optimizer states.
+    double update_bytes;
+    double pooled_bytes;
+    double keys_per_sample;
+    double unique_global;  // Per step, over the global batch.
+    double unique_local;   // Per step, over one GPU's batch.
+    bool concat;
+  };
+
+  struct Traffic {
+    double send_local{0};
+    double send_remote{0};
+    double recv_local{0};
+    double recv_remote{0};
+  };
+
+  const ShardingHardware& hw_;
+  const bool hierarchical_;
+  const size_t num_gpus_;
+  const double batch_size_;
+  const double key_bytes_;
+
+  std::vector<Table> tables_;
+  std::vector<double> memory_;
+  std::vector<double> lookup_time_;
+  std::vector<double> num_shards_;
+  std::vector<Traffic> keys_;
+  std::vector<Traffic> outputs_;
+  double all_reduce_bytes_{0};
+};
+
+ShardingPlanner::ShardingPlanner(const std::vector<ShardingTableStats>& tables,
+                                 const ShardingHardware& hardware,
+                                 const ShardingPlannerParams& params)
+    : tables_{tables}, hardware_{hardware}, params_{params} {
+  HCTR_THROW_IF(tables_.empty(), Error_t::WrongInput, "No embedding tables to shard.");
+  HCTR_THROW_IF(hardware_.num_gpus() == 0, Error_t::WrongInput, "The cluster has no GPUs.");
+  HCTR_THROW_IF(hardware_.hbm_bandwidth <= 0 || hardware_.intra_node_bandwidth <= 0 ||
+                    hardware_.inter_node_bandwidth <= 0,
+                Error_t::WrongInput, "Bandwidths must be positive.");
+  HCTR_THROW_IF(params_.batch_size == 0, Error_t::WrongInput, "Batch size must be positive.");
+
+  for (const ShardingTableStats& table : tables_) {
+    HCTR_THROW_IF(table.vocabulary_size <= 0 || table.ev_size <= 0 || table.num_lookups <= 0 ||
+                      table.hotness < 0,
+                  Error_t::WrongInput, "Table \"", table.name, "\" has invalid statistics.");
+    std::pair<double, double> prev{0, 0};
+    for (const auto& point : table.coverage) {
+      HCTR_THROW_IF(point.first < prev.first || point.second < prev.second || point.first > 1 ||
+                        point.second > 1 + 1e-6,
+                    Error_t::WrongInput, "Coverage curve of table \"", table.name,
+                    "\" must be non-decreasing and within [0, 1].");
+      prev = point;
+    }
+  }
+}
+
+double ShardingPlanner::expected_unique_keys(const size_t table, const double num_keys) const {
+  const ShardingTableStats& stats{tables_.at(table)};
+  const double vocabulary_size{static_cast<double>(stats.vocabulary_size)};
+
+  // A key with access probability p appears at least once among n accesses with probability
+  // 1 - (1 - p)^n ~ 1 - exp(-n * p). The coverage curve is linear in between its points, so the
+  // keys within each segment are equally likely.
+  double unique{0};
+  std::pair<double, double> prev{0, 0};
+  const auto add_segment{[&](const std::pair<double, double>& point) {
+    const double keys{(point.first - prev.first) * vocabulary_size};
+    const double mass{point.second - prev.second};
+    if (keys > 0 && mass > 0) {
+      unique += keys * -std::expm1(-num_keys * mass / keys);
+    } else if (mass > 0) {
+      // Accesses to a vanishing number of keys.
+      unique += std::min(1., num_keys * mass);
+    }
+    prev = point;
+  }};
+  for (const auto& point : stats.coverage) {
+    add_segment(point);
+  }
+  add_segment({1, 1});
+  return std::min(unique, num_keys);
+}
+
+ShardingCost ShardingPlanner::evaluate(const ShardingPlan& plan) const {
+  HCTR_THROW_IF(plan.placements.size() != tables_.size(), Error_t::WrongInput,
+                "The plan must place all ", tables_.size(), " tables.");
+  State state{*this, plan.hierarchical};
+  for (size_t table{0}; table < tables_.size(); ++table) {
+    const ShardingTablePlacement& placement{plan.placements[table]};
+    if (!placement.data_parallel) {
+      HCTR_THROW_IF(placement.gpus.empty(), Error_t::WrongInput, "Table \"", tables_[table].name,
+                    "\" is not placed on any GPU.");
+      for (const int gpu : placement.gpus) {
+        HCTR_THROW_IF(gpu < 0 || static_cast<size_t>(gpu) >= state.num_gpus(),
+                      Error_t::WrongInput, "Table \"", tables_[table].name,
+                      "\" is placed on non-existent GPU ", gpu, ".");
+      }
+    }
+    state.add(table, placement);
+  }
+  return state.cost();
+}
+
+ShardingPlan ShardingPlanner::plan_(const bool hierarchical, const bool min_splits) const {
+  State state{*this, hierarchical};
+  const size_t num_gpus{state.num_gpus()};
+  const size_t gpn{hardware_.gpus_per_node};
+
+  const auto candidates{[&](const size_t table) {
+    std::vector<ShardingTablePlacement> result;
+    if (params_.allow_data_parallel) {
+      result.push_back({true, {}});
+    }
+
+    // Shards go to the least loaded GPUs (or nodes) with enough free memory.
+    std::vector<int> order(hierarchical ? hardware_.num_nodes : num_gpus);
+    std::iota(order.begin(), order.end(), 0);
+    const auto load{[&](const int i) {
+      if (!hierarchical) {
+        return state.load(i);
+      }
+      double max_load{0};
+      for (size_t gpu{i * gpn}; gpu < (i + 1) * gpn; ++gpu) {
+        max_load = std::max(max_load, state.load(gpu));
+      }
+      return max_load;
+    }};
+    const auto free_memory{[&](const int i) {
+      if (!hierarchical) {
+        return state.free_memory(i);
+      }
+      double min_free{state.memory_limit()};
+      for (size_t gpu{i * gpn}; gpu < (i + 1) * gpn; ++gpu) {
+        min_free = std::min(min_free, state.free_memory(gpu));
+      }
+      return min_free;
+    }};
+    std::stable_sort(order.begin(), order.end(),
+                     [&](const int a, const int b) { return load(a) < load(b); });
+
+    const size_t max_units{params_.allow_row_wise || hierarchical ? order.size() : 1};
+    for (size_t num_units{1}; num_units <= max_units;
+         num_units = num_units == max_units ? max_units + 1 : std::min(num_units * 2, max_units)) {
+      const double memory{state.shard_memory(table, num_units * (hierarchical ? gpn : 1))};
+      std::vector<int> units;
+      for (const int unit : order) {
+        if (units.size() < num_units && free_memory(unit) >= memory) {
+          units.push_back(unit);
+        }
+      }
+      const bool fits{units.size() == num_units};
+      for (size_t i{0}; units.size() < num_units; ++i) {
+        if (std::find(units.begin(), units.end(), order[i]) == units.end()) {
+          units.push_back(order[i]);
+        }
+      }
+
+      ShardingTablePlacement& placement{result.emplace_back()};
+      for (const int unit : units) {
+        if (hierarchical) {
+          for (size_t gpu{unit * gpn}; gpu < (unit + 1) * gpn; ++gpu) {
+            placement.gpus.push_back(static_cast<int>(gpu));
+          }
+        } else {
+          placement.gpus.push_back(unit);
+        }
+      }
+      std::sort(placement.gpus.begin(), placement.gpus.end());
+      if (min_splits && fits) {
+        break;
+      }
+    }
+    return result;
+  }};
+
+  // While tables remain unplaced, the step time cannot drop below the average load that they will
+  // add. Bounding by it keeps the greedy phase from spreading early tables over all GPUs.
+  double remaining_load{0};
+  const auto score_of{[&](const size_t table, const ShardingTablePlacement& placement) {
+    state.add(table, placement);
+    Score score{state.score()};
+    const double average{(state.total_load() + remaining_load) / static_cast<double>(num_gpus)};
+    score.step_time = std::max(score.step_time, average + state.all_reduce_time());
+    state.add(table, placement, -1);
+    return score;
+  }};
+
+  const auto best_of{[&](const size_t table, const std::vector<ShardingTablePlacement>& options) {
+    size_t best{0};
+    Score best_score{score_of(table, options[0])};
+    for (size_t i{1}; i < options.size(); ++i) {
+      const Score score{score_of(table, options[i])};
+      if (score < best_score) {
+        best = i;
+        best_score = score;
+      }
+    }
+    return std::make_pair(options[best], best_score);
+  }};
+
+  // Greedy assignment, heaviest tables first. A table's weight is its share of the total work or
+  // memory, whichever is larger.
+  std::vector<double> weights(tables_.size());
+  double total_work{0};
+  double total_memory{0};
+  for (size_t table{0}; table < tables_.size(); ++table) {
+    total_work += state.work(table);
+    total_memory += state.replica_memory(table);
+  }
+  for (size_t table{0}; table < tables_.size(); ++table) {
+    weights[table] = std::max(state.work(table) / std::max(total_work, 1e-30),
+                              state.replica_memory(table) / std::max(total_memory, 1e-30));
+  }
+  std::vector<size_t> order(tables_.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(),
+                   [&](const size_t a, const size_t b) { return weights[a] > weights[b]; });
+
+  // Cheapest total load that each table adds on its own.
+  std::vector<double> min_load(tables_.size());
+  for (size_t table{0}; table < tables_.size(); ++table) {
+    min_load[table] = std::numeric_limits<double>::max();
+    for (const ShardingTablePlacement& placement : candidates(table)) {
+      state.add(table, placement);
+      min_load[table] = std::min(min_load[table], state.total_load());
+      state.add(table, placement, -1);
+    }
+    remaining_load += min_load[table];
+  }
+
+  ShardingPlan plan;
+  plan.hierarchical = hierarchical;
+  plan.placements.resize(tables_.size());
+  for (const size_t table : order) {
+    remaining_load -= min_load[table];
+    plan.placements[table] = best_of(table, candidates(table)).first;
+    state.add(table, plan.placements[table]);
+  }
+  remaining_load = 0;
+
+  // Refinement. Take each table out and reinsert it where it is cheapest given all others.
+  for (size_t pass{0}; pass < params_.max_passes; ++pass) {
+    bool improved{false};
+    for (const size_t table : order) {
+      ShardingTablePlacement& placement{plan.placements[table]};
+      state.add(table, placement, -1);
+      const Score current{score_of(table, placement)};
+      auto [best, best_score] = best_of(table, candidates(table));
+      if (best_score < current) {
+        placement = std::move(best);
+        improved = true;
+      }
+      state.add(table, placement);
+    }
+    if (!improved) {
+      break;
+    }
+  }
+
+  // Every GPU must hold at least one shard. Extend the model-parallel table for which this is
+  // cheapest onto idle GPUs, or, without row-wise splits, move a table there from a GPU that holds
+  // several.
+  const bool extend{params_.allow_row_wise || hierarchical};
+  for (size_t gpu{0}; gpu < num_gpus; ++gpu) {
+    if (state.num_shards(gpu) > 0) {
+      continue;
+    }
+    std::vector<int> idle{static_cast<int>(gpu)};
+    if (hierarchical) {
+      idle.clear();
+      const size_t node{gpu / gpn};
+      for (size_t i{node * gpn}; i < (node + 1) * gpn; ++i) {
+        idle.push_back(static_cast<int>(i));
+      }
+    }
+
+    bool found{false};
+    size_t best_table{0};
+    ShardingTablePlacement best_placement;
+    Score best_score{};
+    for (size_t table{0}; table < tables_.size(); ++table) {
+      const ShardingTablePlacement& current{plan.placements[table]};
+      if (current.data_parallel) {
+        continue;
+      }
+      ShardingTablePlacement extended{current};
+      if (extend) {
+        extended.gpus.insert(extended.gpus.end(), idle.begin(), idle.end());
+        std::sort(extended.gpus.begin(), extended.gpus.end());
+      } else if (current.gpus.size() == 1 && state.num_shards(current.gpus[0]) > 1) {
+        extended.gpus = idle;
+      } else {
+        continue;
+      }
+
+      state.add(table, current, -1);
+      const Score score{score_of(table, extended)};
+      state.add(table, current);
+      if (!found || score < best_score) {
+        found = true;
+        best_table = table;
+        best_placement = std::move(extended);
+        best_score = score;
+      }
+    }
+    if (found) {
+      state.add(best_table, plan.placements[best_table], -1);
+      plan.placements[best_table] = std::move(best_placement);
+      state.add(best_table, plan.placements[best_table]);
+    }
+  }
+
+  plan.cost = state.cost();
+  return plan;
+}
+
+ShardingPlan ShardingPlanner::plan() const {
+  // Moving one table at a time rarely undoes a row-wise split that stopped paying off once more
+  // tables were placed. Hence, also search with tables split only as far as memory requires.
+  std::vector<ShardingPlan> plans{plan_(false, true)};
+  if (params_.allow_row_wise) {
+    plans.push_back(plan_(false, false));
+    if (hardware_.num_nodes > 1 && params_.allow_hierarchical) {
+      plans.push_back(plan_(true, true));
+      plans.push_back(plan_(true, false));
+    }
+  }
+
+  return *std::min_element(plans.begin(), plans.end(),
+                           [](const ShardingPlan& a, const ShardingPlan& b) {
+                             if (a.cost.fits != b.cost.fits) {
+                               return a.cost.fits;
+                             }
+                             return a.cost.step_time < b.cost.step_time;
+                           });
+}
+
+std::vector<std::vector<std::string>> ShardingPlan::shard_matrix(
+    const std::vector<ShardingTableStats>& tables, const size_t num_gpus) const {
+  std::vector<std::vector<std::string>> matrix(num_gpus);
+  const std::vector<std::vector<int>> ids{shard_matrix_ids(num_gpus)};
+  for (size_t gpu{0}; gpu < num_gpus; ++gpu) {
+    for (size_t table{0}; table < placements.size(); ++table) {
+      if (ids[gpu][table]) {
+        matrix[gpu].push_back(tables.at(table).name);
+      }
+    }
+  }
+  return matrix;
+}
+
+std::vector<std::pair<std::string, std::vector<std::string>>> ShardingPlan::shard_strategy(
+    const std::vector<ShardingTableStats>& tables) const {
+  std::vector<std::string> mp;
+  std::vector<std::string> dp;
+  for (size_t table{0}; table < placements.size(); ++table) {
+    (placements[table].data_parallel ? dp : mp).push_back(tables.at(table).name);
+  }
+
+  std::vector<std::pair<std::string, std::vector<std::string>>> strategy;
+  if (!mp.empty()) {
+    strategy.emplace_back("mp", std::move(mp));
+  }
+  if (!dp.empty()) {
+    strategy.emplace_back("dp", std::move(dp));
+  }
+  return strategy;
+}
+
+std::vector<std::vector<int>> ShardingPlan::shard_matrix_ids(const size_t num_gpus) const {
+  std::vector<std::vector<int>> matrix(num_gpus, std::vector<int>(placements.size()));
+  for (size_t table{0}; table < placements.size(); ++table) {
+    const ShardingTablePlacement& placement{placements[table]};
+    if (placement.data_parallel) {
+      for (size_t gpu{0}; gpu < num_gpus; ++gpu) {
+        matrix[gpu][table] = 1;
+      }
+    } else {
+      for (const int gpu : placement.gpus) {
+        matrix.at(gpu)[table] = 1;
+      }
+    }
+  }
+  return matrix;
+}
+
+}  // namespace HugeCTR
@@ -0,0 +1,162 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <core23/logger.hpp>
+#include <hps/admission_filter.hpp>
+#include <hps/database_backend_detail.hpp>
+
+namespace HugeCTR {
+
+namespace {
+
+inline size_t next_pow2(const size_t n) {
+  size_t p{1};
+  while (p < n) {
+    p <<= 1;
+  }
+  return p;
+}
+
+constexpr uint64_t counter_mask{0xF};
+
+}  // namespace
+
+template <typename Key>
+AdmissionFilter<Key>::AdmissionFilter(const uint32_t threshold, const size_t window)
+    : threshold_{threshold}, window_{window} {
+  HCTR_CHECK_HINT(threshold_ >= 1 && threshold_ <= max_threshold,
+                  "Admission threshold must be between 1 and ", max_threshold, ".");
+  HCTR_CHECK_HINT(window_ > 0, "Admission window must be positive.");
+
+  // Most keys in a window are distinct. Counters are only incremented by repeated keys, and the
+  // doorkeeper absorbs the first occurrence of every key, so it receives more bits.
+  const size_t width{next_pow2(std::max(window_ / 2, size_t{1024}))};
+  width_mask_ = width - 1;
+  counters_.resize(depth_ * width / 16);
+
+  const size_t doorkeeper_size{next_pow2(std::max(window_, size_t{1024})) * 8};
+  doorkeeper_mask_ = doorkeeper_size - 1;
+  doorkeeper_.resize(doorkeeper_size / 64);
+}
+
+template <typename Key>
+bool AdmissionFilter<Key>::doorkeeper_insert_(const uint64_t hash) {
+  const size_t h1{static_cast<size_t>(hash)};
+  const size_t h2{static_cast<size_t>(hash >> 32) | 1};
+
+  bool contained{true};
+  for (size_t i{0}; i < doorkeeper_hashes_; ++i) {
+    const size_t bit{(h1 + (depth_ + i) * h2) & doorkeeper_mask_};
+    uint64_t& word{doorkeeper_[bit / 64]};
+    const uint64_t mask{UINT64_C(1) << (bit % 64)};
+    contained &= (word & mask) != 0;
+    word |= mask;
+  }
+  return contained;
+}
+
+template <typename Key>
+bool AdmissionFilter<Key>::doorkeeper_contains_(const uint64_t hash) const {
+  const size_t h1{static_cast<size_t>(hash)};
+  const size_t h2{static_cast<size_t>(hash >> 32) | 1};
+
+  for (size_t i{0}; i < doorkeeper_hashes_; ++i) {
+    const size_t bit{(h1 + (depth_ + i) * h2) & doorkeeper_mask_};
+    if ((doorkeeper_[bit / 64] & (UINT64_C(1) << (bit % 64))) == 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+template <typename Key>
+uint32_t AdmissionFilter<Key>::estimate_(const uint64_t hash) const {
+  // Kirsch-Mitzenmacher: derive the row hashes from two halves of a single strong hash.
+  const size_t h1{static_cast<size_t>(hash)};
+  const size_t h2{static_cast<size_t>(hash >> 32) | 1};
+
+  uint64_t count{counter_mask};
+  for (size_t row{0}; row < depth_; ++row) {
+    const size_t index{row * (width_mask_ + 1) + ((h1 + row * h2) & width_mask_)};
+    count = std::min(count, (counters_[index / 16] >> (index % 16 * 4)) & counter_mask);
+  }
+  return static_cast<uint32_t>(count);
+}
+
+template <typename Key>
+uint32_t AdmissionFilter<Key>::increment_(const uint64_t hash) {
+  const size_t h1{static_cast<size_t>(hash)};
+  const size_t h2{static_cast<size_t>(hash >> 32) | 1};
+
+  uint64_t count{counter_mask};
+  for (size_t row{0}; row < depth_; ++row) {
+    const size_t index{row * (width_mask_ + 1) + ((h1 + row * h2) & width_mask_)};
+    uint64_t& word{counters_[index / 16]};
+    const size_t shift{index % 16 * 4};
+    uint64_t counter{(word >> shift) & counter_mask};
+    if (counter < counter_mask) {
+      ++counter;
+      word += UINT64_C(1) << shift;
+    }
+    count = std::min(count, counter);
+  }
+  return static_cast<uint32_t>(count);
+}
+
+template <typename Key>
+void AdmissionFilter<Key>::age_() {
+  // Halve all 4-bit counters at once. The mask drops the bits shifted in from the next counter.
+  for (uint64_t& word : counters_) {
+    word = (word >> 1) & UINT64_C(0x7777777777777777);
+  }
+  std::fill(doorkeeper_.begin(), doorkeeper_.end(), 0);
+  num_samples_ = 0;
+}
+
+template <typename Key>
+void AdmissionFilter<Key>::filter(std::vector<size_t>& indices, const Key* const keys) {
+  const std::lock_guard lock(guard_);
+
+  auto admitted_end{indices.begin()};
+  for (const size_t index : indices) {
+    const uint64_t hash{rrxmrrxmsx_0(static_cast<uint64_t>(keys[index]))};
+
+    // Only keys that passed the doorkeeper before are counted in the sketch.
+    const uint32_t count{doorkeeper_insert_(hash) ? increment_(hash) : estimate_(hash)};
+    if (count + 1 >= threshold_) {
+      *admitted_end++ = index;
+    }
+
+    if (++num_samples_ >= window_) {
+      age_();
+    }
+  }
+  indices.erase(admitted_end, indices.end());
+}
+
+template <typename Key>
+uint32_t AdmissionFilter<Key>::estimate(const Key key) const {
+  const uint64_t hash{rrxmrrxmsx_0(static_cast<uint64_t>(key))};
+
+  const std::lock_guard lock(guard_);
+  return estimate_(hash) + (doorkeeper_contains_(hash) ? 1 : 0);
+}
+
+template class AdmissionFilter<unsigned int>;
+template class AdmissionFilter<long long>;
+
+}  // namespace HugeCTR
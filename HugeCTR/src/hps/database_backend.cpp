@@ -265,6 +265,16 @@ size_t DatabaseBackendBase<Key>::load_dump_sst(const std::string& table_name,
   return hit_count;
 }
 
+template <typename Key>
+DatabaseTableStats DatabaseBackendBase<Key>::table_stats(const std::string& table_name) const {
+  DatabaseTableStats stats;
+  const size_t num_keys = size(table_name);
+  if (num_keys != static_cast<size_t>(-1)) {
+    stats.num_keys = num_keys;
+  }
+  return stats;
+}
+
 template class DatabaseBackendBase<unsigned int>;
 template class DatabaseBackendBase<long long>;
 
@@ -139,6 +139,9 @@ EmbeddingCache<TypeHashKey>::EmbeddingCache(const InferenceParams& inference_par
   cache_config_.model_name_ = inference_params.model_name;
   cache_config_.cuda_dev_id_ = inference_params.device_id;
   cache_config_.use_gpu_embedding_cache_ = inference_params.use_gpu_embedding_cache;
+  cache_config_.use_host_embedding_cache_ = !inference_params.use_gpu_embedding_cache &&
+                                            inference_params.use_host_embedding_cache &&
+                                            inference_params.cache_size_percentage > 0;
   cache_config_.use_hctr_cache_implementation = inference_params.use_hctr_cache_implementation;
   auto b2s = [](const char val) { return val ? "True" : "False"; };
   HCTR_LOG(INFO, ROOT, "Model name: %s\n", inference_params.model_name.c_str());
@@ -147,6 +150,8 @@ EmbeddingCache<TypeHashKey>::EmbeddingCache(const InferenceParams& inference_par
   HCTR_LOG(INFO, ROOT, "Number of embedding tables: %zu\n", cache_config_.num_emb_table_);
   HCTR_LOG(INFO, ROOT, "Use GPU embedding cache: %s, cache size percentage: %f\n",
            b2s(inference_params.use_gpu_embedding_cache), inference_params.cache_size_percentage);
+  HCTR_LOG(INFO, ROOT, "Use host embedding cache: %s\n",
+           b2s(cache_config_.use_host_embedding_cache_));
   HCTR_LOG(INFO, ROOT, "Embedding cache type: %s\n",
            hctr_enum_to_c_str(inference_params.embedding_cache_type));
   HCTR_LOG(INFO, ROOT, "Use I64 input key: %s\n", b2s(inference_params.i64_input_key));
@@ -184,7 +189,7 @@ EmbeddingCache<TypeHashKey>::EmbeddingCache(const InferenceParams& inference_par
   }
 
   // Query the size of all embedding tables and calculate the size of each embedding cache
-  if (cache_config_.use_gpu_embedding_cache_) {
+  if (cache_config_.use_gpu_embedding_cache_ || cache_config_.use_host_embedding_cache_) {
     cache_config_.num_set_in_cache_.reserve(cache_config_.num_emb_table_);
     for (size_t i = 0; i < cache_config_.num_emb_table_; i++) {
       const size_t row_num = ps_config.embedding_key_count_.at(inference_params.model_name)[i];
@@ -235,6 +240,15 @@ EmbeddingCache<TypeHashKey>::EmbeddingCache(const InferenceParams& inference_par
       refresh_streams_.push_back(stream);
     }
   }
+
+  // Construct host embedding cache, 1 per embedding table
+  if (cache_config_.use_host_embedding_cache_) {
+    host_emb_caches_.reserve(cache_config_.num_emb_table_);
+    for (size_t i = 0; i < cache_config_.num_emb_table_; i++) {
+      host_emb_caches_.emplace_back(std::make_unique<HostCache>(
+          cache_config_.num_set_in_cache_[i], cache_config_.embedding_vec_size_[i]));
+    }
+  }
 }
 
 template <typename TypeHashKey>
@@ -286,13 +300,7 @@ void EmbeddingCache<TypeHashKey>::lookup(size_t const table_id, float* const d_v
   }
   // Not using GPU embedding cache
   else {
-    memcpy(workspace_handler.h_embeddingcolumns_[table_id], h_keys, num_keys * sizeof(TypeHashKey));
-    start = profiler::start();
-    parameter_server_->lookup(workspace_handler.h_embeddingcolumns_[table_id], num_keys,
-                              workspace_handler.h_missing_emb_vec_[table_id],
-                              cache_config_.model_name_, table_id);
-    ec_profiler_->end(
-        start, "Lookup the embedding keys from Database backend(disable the Embedding Cache)");
+    lookup_from_host_(table_id, workspace_handler, h_keys, num_keys);
     HCTR_LIB_THROW(
         cudaMemcpyAsync(d_vectors, workspace_handler.h_missing_emb_vec_[table_id],
                         num_keys * cache_config_.embedding_vec_size_[table_id] * sizeof(float),
@@ -302,6 +310,91 @@ void EmbeddingCache<TypeHashKey>::lookup(size_t const table_id, float* const d_v
   }
 }
 
+template <typename TypeHashKey>
+void EmbeddingCache<TypeHashKey>::lookup_from_host_(size_t const table_id,
+                                                    EmbeddingCacheWorkspace& workspace_handler,
+                                                    const void* const h_keys,
+                                                    size_t const num_keys) {
+  // Each thread keeps its own hash set, which is reused across batches.
+  thread_local CpuUniqueOp cpu_unique_op;
+
+  // Deduplicate, so that each distinct key is only fetched once.
+  BaseUnit* start = profiler::start();
+  const size_t num_unique = cpu_unique_op.unique(
+      static_cast<const TypeHashKey*>(h_keys), num_keys,
+      static_cast<TypeHashKey*>(workspace_handler.h_embeddingcolumns_[table_id]));
+  ec_profiler_->end(start, "Deduplicate the input embedding key on host");
+  start = profiler::start(cpu_unique_op.dedup_ratio(), ProfilerType_t::Occupancy);
+  ec_profiler_->end(start, "The dedup ratio of Database backend lookup", ProfilerType_t::Occupancy);
+  parameter_server_->get_table_counters(cache_config_.model_name_, table_id)
+      ->record_host_dedup(num_keys, num_unique);
+
+  if (cache_config_.use_host_embedding_cache_) {
+    lookup_from_host_cache_(table_id, workspace_handler, num_unique);
+  } else {
+    start = profiler::start();
+    parameter_server_->lookup(workspace_handler.h_embeddingcolumns_[table_id], num_unique,
+                              workspace_handler.h_missing_emb_vec_[table_id],
+                              cache_config_.model_name_, table_id);
+    ec_profiler_->end(
+        start, "Lookup the embedding keys from Database backend(disable the Embedding Cache)");
+  }
+
+  // Scatter the fetched rows back to the positions of the original keys.
+  start = profiler::start();
+  cpu_unique_op.expand(workspace_handler.h_missing_emb_vec_[table_id],
+                       cache_config_.embedding_vec_size_[table_id]);
+  ec_profiler_->end(start, "Expand the deduplicated embedding vectors on host");
+}
+
+template <typename TypeHashKey>
+void EmbeddingCache<TypeHashKey>::lookup_from_host_cache_(
+    size_t const table_id, EmbeddingCacheWorkspace& workspace_handler, size_t const num_unique) {
+  // Buffers for the misses, reused across batches like the unique op.
+  thread_local std::vector<uint64_t> missing_index;
+  thread_local std::vector<TypeHashKey> missing_keys;
+  thread_local std::vector<float> missing_vectors;
+
+  const size_t embedding_vec_size = cache_config_.embedding_vec_size_[table_id];
+  const TypeHashKey* const keys =
+      static_cast<const TypeHashKey*>(workspace_handler.h_embeddingcolumns_[table_id]);
+  float* const vectors = workspace_handler.h_missing_emb_vec_[table_id];
+
+  // Query
+  BaseUnit* start = profiler::start();
+  missing_index.resize(num_unique);
+  missing_keys.resize(num_unique);
+  size_t num_missing = 0;
+  host_emb_caches_[table_id]->Query(keys, num_unique, vectors, missing_index.data(),
+                                    missing_keys.data(), &num_missing, nullptr);
+  ec_profiler_->end(start, "Host Embedding Cache Query API");
+  parameter_server_->get_table_counters(cache_config_.model_name_, table_id)
+      ->embedding_cache.record(num_unique, num_unique - num_missing);
+  const double hit_rate =
+      num_unique ? 1.0 - static_cast<double>(num_missing) / static_cast<double>(num_unique) : 1.0;
+  start = profiler::start(hit_rate, ProfilerType_t::Occupancy);
+  ec_profiler_->end(start, "The hit rate of Host Embedding Cache", ProfilerType_t::Occupancy);
+  if (num_missing == 0) {
+    return;
+  }
+
+  // Fetch the misses, and merge them into the output
+  start = profiler::start();
+  missing_vectors.resize(num_missing * embedding_vec_size);
+  parameter_server_->lookup(missing_keys.data(), num_missing, missing_vectors.data(),
+                            cache_config_.model_name_, table_id);
+  for (size_t i = 0; i < num_missing; ++i) {
+    std::copy_n(&missing_vectors[i * embedding_vec_size], embedding_vec_size,
+                &vectors[missing_index[i] * embedding_vec_size]);
+  }
+  ec_profiler_->end(start, "Lookup the missing keys of Host Embedding Cache from Database backend");
+
+  start = profiler::start();
+  host_emb_caches_[table_id]->Replace(missing_keys.data(), num_missing, missing_vectors.data(),
+                                      nullptr);
+  ec_profiler_->end(start, "Missing key insert into Host Embedding Cache");
+}
+
 template <typename TypeHashKey>
 void EmbeddingCache<TypeHashKey>::lookup_from_device(size_t const table_id, float* const d_vectors,
                                                      const void* const d_keys,
@@ -333,12 +426,8 @@ void EmbeddingCache<TypeHashKey>::lookup_from_device(size_t const table_id, floa
   else {
     HCTR_LIB_THROW(cudaMemcpy(workspace_handler.h_embeddingcolumns_[table_id], d_keys,
                               num_keys * sizeof(TypeHashKey), cudaMemcpyDeviceToHost));
-    start = profiler::start();
-    parameter_server_->lookup(workspace_handler.h_embeddingcolumns_[table_id], num_keys,
-                              workspace_handler.h_missing_emb_vec_[table_id],
-                              cache_config_.model_name_, table_id);
-    ec_profiler_->end(
-        start, "Lookup the embedding keys from Database backend(disable the Embedding Cache)");
+    lookup_from_host_(table_id, workspace_handler,
+                      workspace_handler.h_embeddingcolumns_[table_id], num_keys);
     HCTR_LIB_THROW(
         cudaMemcpyAsync(d_vectors, workspace_handler.h_missing_emb_vec_[table_id],
                         num_keys * cache_config_.embedding_vec_size_[table_id] * sizeof(float),
@@ -395,6 +484,9 @@ void EmbeddingCache<TypeHashKey>::lookup_from_device(size_t const table_id, floa
           1.0 - (static_cast<double>(workspace_handler.h_missing_length_[table_id]) /
                  static_cast<double>(workspace_handler.h_unique_length_[table_id]));
     }
+    parameter_server_->get_table_counters(cache_config_.model_name_, table_id)
+        ->embedding_cache.record(query_length,
+                                 query_length - workspace_handler.h_missing_length_[table_id]);
     bool async_insert_flag{workspace_handler.h_hit_rate_[table_id] >= hit_rate_threshold};
     start = profiler::start(workspace_handler.h_hit_rate_[table_id], ProfilerType_t::Occupancy);
     ec_profiler_->end(start, "The hit rate of Embedding Cache", ProfilerType_t::Occupancy);
@@ -495,8 +587,7 @@ template <typename TypeHashKey>
 void EmbeddingCache<TypeHashKey>::dump(const size_t table_id, void* const d_keys,
                                        size_t* const d_length, const size_t start_index,
                                        const size_t end_index, cudaStream_t stream) {
-  // If GPU embedding cache is enabled
-  if (cache_config_.use_gpu_embedding_cache_) {
+  if (cache_config_.use_gpu_embedding_cache_ || cache_config_.use_host_embedding_cache_) {
     // Check for corner case
     if (start_index >= cache_config_.num_set_in_cache_[table_id]) {
       HCTR_OWN_THROW(Error_t::WrongInput, "Error: Invalid value for start_index.");
@@ -504,6 +595,14 @@ void EmbeddingCache<TypeHashKey>::dump(const size_t table_id, void* const d_keys
     if (end_index <= start_index || end_index > cache_config_.num_set_in_cache_[table_id]) {
       HCTR_OWN_THROW(Error_t::WrongInput, "Error: Invalid value for end_index.");
     }
+  }
+  // The host embedding cache dumps to host memory
+  if (cache_config_.use_host_embedding_cache_) {
+    host_emb_caches_[table_id]->Dump(static_cast<TypeHashKey*>(d_keys), d_length, start_index,
+                                     end_index, stream);
+  }
+  // If GPU embedding cache is enabled
+  if (cache_config_.use_gpu_embedding_cache_) {
     CudaDeviceContext dev_restorer;
     dev_restorer.check_device(cache_config_.cuda_dev_id_);
     // Call GPU cache API
@@ -519,12 +618,19 @@ template <typename TypeHashKey>
 void EmbeddingCache<TypeHashKey>::refresh(const size_t table_id, const void* const d_keys,
                                           const void* const d_vectors, const size_t length,
                                           cudaStream_t stream) {
+  // Check for corner case
+  if (length == 0) {
+    return;
+  }
+  // The host embedding cache is refreshed from host memory
+  if (cache_config_.use_host_embedding_cache_) {
+    BaseUnit* start = profiler::start();
+    host_emb_caches_[table_id]->Update(static_cast<const TypeHashKey*>(d_keys), length,
+                                       static_cast<const float*>(d_vectors), stream);
+    ec_profiler_->end(start, "Refresh/Update exist embedding vector in Host Embedding cache");
+  }
   // If GPU embedding cache is enabled
   if (cache_config_.use_gpu_embedding_cache_) {
-    // Check for corner case
-    if (length == 0) {
-      return;
-    }
     CudaDeviceContext dev_restorer;
     dev_restorer.check_device(cache_config_.cuda_dev_id_);
     BaseUnit* start = profiler::start();
@@ -728,8 +834,7 @@ void EmbeddingCache<TypeHashKey>::destroy_workspace(EmbeddingCacheWorkspace& wor
 template <typename TypeHashKey>
 EmbeddingCacheRefreshspace EmbeddingCache<TypeHashKey>::create_refreshspace() {
   EmbeddingCacheRefreshspace refreshspace_handler;
-  // If GPU embedding cache is enabled
-  if (cache_config_.use_gpu_embedding_cache_) {
+  if (cache_config_.use_gpu_embedding_cache_ || cache_config_.use_host_embedding_cache_) {
     const int max_num_cache_set = *max_element(cache_config_.num_set_in_cache_.begin(),
                                                cache_config_.num_set_in_cache_.end());
     const int max_embedding_size = *max_element(cache_config_.embedding_vec_size_.begin(),
@@ -742,6 +847,16 @@ EmbeddingCacheRefreshspace EmbeddingCache<TypeHashKey>::create_refreshspace() {
         (max_num_key_in_buffer + SLAB_SIZE * SET_ASSOCIATIVITY - 1) /
         (SLAB_SIZE * SET_ASSOCIATIVITY);
 
+    // The host embedding cache only needs host buffers.
+    if (cache_config_.use_host_embedding_cache_) {
+      refreshspace_handler.h_refresh_embeddingcolumns_ =
+          malloc(max_num_key_in_buffer * sizeof(TypeHashKey));
+      refreshspace_handler.h_refresh_emb_vec_ =
+          (float*)malloc(max_num_key_in_buffer * max_embedding_size * sizeof(float));
+      refreshspace_handler.h_length_ = (size_t*)malloc(sizeof(size_t));
+      return refreshspace_handler;
+    }
+
     CudaDeviceContext dev_restorer;
     dev_restorer.check_device(cache_config_.cuda_dev_id_);
 
@@ -767,6 +882,14 @@ EmbeddingCacheRefreshspace EmbeddingCache<TypeHashKey>::create_refreshspace() {
 template <typename TypeHashKey>
 void EmbeddingCache<TypeHashKey>::destroy_refreshspace(
     EmbeddingCacheRefreshspace& refreshspace_handler) {
+  if (cache_config_.use_host_embedding_cache_) {
+    free(refreshspace_handler.h_refresh_embeddingcolumns_);
+    refreshspace_handler.h_refresh_embeddingcolumns_ = nullptr;
+    free(refreshspace_handler.h_refresh_emb_vec_);
+    refreshspace_handler.h_refresh_emb_vec_ = nullptr;
+    free(refreshspace_handler.h_length_);
+    refreshspace_handler.h_length_ = nullptr;
+  }
   // If GPU embedding cache is enabled
   if (cache_config_.use_gpu_embedding_cache_) {
     CudaDeviceContext dev_restorer;
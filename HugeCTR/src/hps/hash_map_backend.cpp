@@ -14,6 +14,8 @@
  * limitations under the License.
  */
 
+#include <numa.h>
+
 #include <algorithm>
 #include <atomic>
 #include <core23/logger.hpp>
@@ -24,6 +26,10 @@
 #include <hps/hier_parameter_server_base.hpp>
 #include <random>
 
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
 // TODO: Remove me!
 #pragma GCC diagnostic error "-Wconversion"
 
@@ -31,9 +37,93 @@ namespace HugeCTR {
 
 template <typename Key>
 HashMapBackend<Key>::HashMapBackend(const HashMapBackendParams& params) : Base(params) {
+  if (params.numa_aware) {
+    if (numa_available() < 0) {
+      HCTR_LOG_C(WARNING, WORLD, get_name(),
+                 ": NUMA is not available on this system. Partitions will not be placed.\n");
+    } else {
+      // Create one pool of pinned worker threads for each node that has CPUs.
+      struct bitmask* const cpus{numa_allocate_cpumask()};
+      for (int node{0}; node <= numa_max_node(); ++node) {
+        if (numa_node_to_cpus(node, cpus) != 0) {
+          continue;
+        }
+        const size_t num_cpus{numa_bitmask_weight(cpus)};
+        if (num_cpus == 0) {
+          continue;
+        }
+
+        numa_nodes_.emplace_back(node);
+        numa_thread_pools_.emplace_back(std::make_unique<ThreadPool>(
+            "hps hm numa " + std::to_string(node), num_cpus, [node](size_t) {
+              numa_run_on_node(node);
+              numa_set_preferred(node);
+            }));
+      }
+      numa_free_cpumask(cpus);
+
+      HCTR_LOG_C(INFO, WORLD, get_name(), ": Placing ", params.num_partitions,
+                 " partitions on ", numa_nodes_.size(), " NUMA node(s).\n");
+    }
+  }
+
+  if (params.compaction_interval_ms) {
+    compaction_thread_ = std::thread(&HashMapBackend::run_compaction_, this);
+  }
+
   HCTR_LOG_C(DEBUG, WORLD, "Created blank database backend in local memory!\n");
 }
 
+template <typename Key>
+HashMapBackend<Key>::~HashMapBackend() {
+  if (compaction_thread_.joinable()) {
+    {
+      const std::lock_guard lock(compaction_guard_);
+      stop_compaction_ = true;
+    }
+    compaction_cv_.notify_all();
+    compaction_thread_.join();
+  }
+}
+
+template <typename Key>
+int HashMapBackend<Key>::numa_node(const size_t part_index) const {
+  return numa_nodes_.empty() ? -1 : numa_nodes_[part_index % numa_nodes_.size()];
+}
+
+template <typename Key>
+ThreadPool& HashMapBackend<Key>::part_thread_pool_(const size_t part_index) const {
+  return numa_thread_pools_.empty() ? ThreadPool::get()
+                                    : *numa_thread_pools_[part_index % numa_thread_pools_.size()];
+}
+
+template <typename Key>
+HashMapBackend<Key>::TableLoad::TableLoad(const size_t num_partitions,
+                                          const HashMapBackendParams& params)
+    : part_loads(num_partitions) {
+  if (params.hot_key_capacity) {
+    tracker = std::make_unique<HotKeyTracker<Key>>(params.hot_key_capacity, hot_key_sample_stride);
+  }
+}
+
+template <typename Key>
+HashMapBackendLoadStats HashMapBackend<Key>::load_stats(const std::string& table_name) const {
+  const std::shared_lock lock(read_write_guard_);
+
+  HashMapBackendLoadStats stats;
+  const auto& it{table_loads_.find(table_name)};
+  if (it != table_loads_.end()) {
+    const TableLoad& load{*it->second};
+    for (const std::atomic<size_t>& part_load : load.part_loads) {
+      stats.partition_loads.emplace_back(part_load.load(std::memory_order_relaxed));
+    }
+    stats.replica_hits = load.replica_hits.load(std::memory_order_relaxed);
+    const std::shared_ptr<const HotKeyReplica<Key>> replica{std::atomic_load(&load.replica)};
+    stats.replica_size = replica ? replica->size() : 0;
+  }
+  return stats;
+}
+
 template <typename Key>
 size_t HashMapBackend<Key>::size(const std::string& table_name) const {
   const std::shared_lock lock(read_write_guard_);
@@ -49,6 +139,37 @@ size_t HashMapBackend<Key>::size(const std::string& table_name) const {
                          [](const size_t a, const Partition& b) { return a + b.entries.size(); });
 }
 
+template <typename Key>
+DatabaseTableStats HashMapBackend<Key>::table_stats(const std::string& table_name) const {
+  const std::shared_lock lock(read_write_guard_);
+
+  DatabaseTableStats stats;
+  const auto& tables_it{tables_.find(table_name)};
+  if (tables_it == tables_.end()) {
+    return stats;
+  }
+  for (const Partition& part : tables_it->second) {
+    const size_t stride{(part.value_size + value_page_alignment - 1) / value_page_alignment *
+                        value_page_alignment};
+    stats.num_keys += part.entries.size();
+    stats.bytes_resident += part.entries.size() * part.value_size;
+    size_t num_bytes{0};
+    for (const ValuePage& value_page : part.value_pages) {
+      num_bytes += value_page.size();
+    }
+    stats.bytes_allocated += num_bytes;
+    // Includes the slots that compaction withholds.
+    stats.free_slot_bytes += num_bytes - part.entries.size() * stride;
+  }
+
+  const auto& loads_it{table_loads_.find(table_name)};
+  if (loads_it != table_loads_.end()) {
+    stats.num_overflows = loads_it->second->num_overflows.load(std::memory_order_relaxed);
+    stats.num_evictions = loads_it->second->num_evictions.load(std::memory_order_relaxed);
+  }
+  return stats;
+}
+
 template <typename Key>
 size_t HashMapBackend<Key>::contains(const std::string& table_name, const size_t num_keys,
                                      const Key* const keys,
@@ -94,7 +215,7 @@ size_t HashMapBackend<Key>::contains(const std::string& table_name, const size_t
     std::atomic<size_t> joint_hit_count{0};
     std::atomic<size_t> joint_skip_count{0};
 
-    HCTR_HPS_DB_PARALLEL_FOR_EACH_PART_({
+    HCTR_HPS_HASH_MAP_PARALLEL_FOR_EACH_PART_({
       const Partition& part{parts[part_index]};
 
       size_t hit_count{0};
@@ -144,6 +265,7 @@ size_t HashMapBackend<Key>::insert(const std::string& table_name, const size_t n
     while (parts.size() < this->params_.num_partitions) {
       parts.emplace_back(value_size, this->params_);
     }
+    table_loads_[table_name] = std::make_unique<TableLoad>(parts.size(), this->params_);
   }
 
   const Key* const keys_end{&keys[num_pairs]};
@@ -160,27 +282,36 @@ size_t HashMapBackend<Key>::insert(const std::string& table_name, const size_t n
     Partition& part{parts[part_index]};
     HCTR_CHECK(part.value_size == value_size);
 
-    // Step through batch-by-batch.
-    for (const Key* k{keys}; k != keys_end;) {
-      // Check overflow condition.
-      if (part.entries.size() >= this->params_.overflow_margin) {
-        resolve_overflow_(table_name, part_index, part);
-      }
+    const auto insert_batches{[&]() {
+      // Step through batch-by-batch.
+      for (const Key* k{keys}; k != keys_end;) {
+        // Check overflow condition.
+        if (part.entries.size() >= this->params_.overflow_margin) {
+          resolve_overflow_(table_name, part_index, part);
+        }
 
-      // Perform insertion.
-      const size_t prev_num_inserts{num_inserts};
-      const size_t batch_size{std::min<size_t>(keys_end - k, max_batch_size)};
-      HCTR_HPS_HASH_MAP_INSERT_(SEQUENTIAL_DIRECT);
+        // Perform insertion.
+        const size_t prev_num_inserts{num_inserts};
+        const size_t batch_size{std::min<size_t>(keys_end - k, max_batch_size)};
+        HCTR_HPS_HASH_MAP_INSERT_(SEQUENTIAL_DIRECT);
 
-      HCTR_LOG_C(TRACE, WORLD, get_name(), " backend; Partition ", table_name, '/', part_index,
-                 ", batch ", (k - keys - 1) / max_batch_size, ": Inserted ",
-                 num_inserts - prev_num_inserts, " + updated ",
-                 batch_size - num_inserts + prev_num_inserts, " = ", batch_size, " entries.\n");
+        HCTR_LOG_C(TRACE, WORLD, get_name(), " backend; Partition ", table_name, '/', part_index,
+                   ", batch ", (k - keys - 1) / max_batch_size, ": Inserted ",
+                   num_inserts - prev_num_inserts, " + updated ",
+                   batch_size - num_inserts + prev_num_inserts, " = ", batch_size, " entries.\n");
+      }
+    }};
+
+    // Memory must be first-touched by a thread of the partition's node.
+    if (numa_thread_pools_.empty()) {
+      insert_batches();
+    } else {
+      part_thread_pool_(part_index).submit(insert_batches).get();
     }
   } else {
     std::atomic<size_t> joint_num_inserts{0};
 
-    HCTR_HPS_DB_PARALLEL_FOR_EACH_PART_({
+    HCTR_HPS_HASH_MAP_PARALLEL_FOR_EACH_PART_({
       Partition& part{parts[part_index]};
       HCTR_CHECK(part.value_size == value_size);
 
@@ -211,6 +342,18 @@ size_t HashMapBackend<Key>::insert(const std::string& table_name, const size_t n
     num_inserts += joint_num_inserts;
   }
 
+  // Keep replicated values in sync (exclusive access, because we hold the write lock).
+  const std::shared_ptr<HotKeyReplica<Key>> replica{
+      std::atomic_load(&table_loads_.at(table_name)->replica)};
+  if (replica && replica->size()) {
+    for (const Key* k{keys}; k != keys_end; ++k) {
+      char* const value{replica->find(*k)};
+      if (value) {
+        std::copy_n(&values[(k - keys) * value_stride], value_size, value);
+      }
+    }
+  }
+
   HCTR_LOG_C(TRACE, WORLD, get_name(), " backend; Table ", table_name, ": Inserted ", num_inserts,
              " + updated ", num_pairs - num_inserts, " = ", num_pairs, " entries.\n");
   return num_inserts;
@@ -230,7 +373,85 @@ size_t HashMapBackend<Key>::fetch(const std::string& table_name, const size_t nu
     return Base::fetch(table_name, num_keys, keys, values, value_stride, on_miss, time_budget);
   }
   std::vector<Partition>& parts{tables_it->second};
+  TableLoad& load{*table_loads_.at(table_name)};
+
+  if (!load.tracker) {
+    return fetch_direct_(table_name, parts, load, num_keys, keys, values, value_stride, on_miss,
+                         time_budget, begin);
+  }
+  load.tracker->record(num_keys, keys);
+
+  // Serve replicated keys first, and only dispatch the remaining keys to the partitions.
+  std::vector<size_t> cold_indices;
+  size_t hit_count{
+      fetch_replicated_(load, num_keys, nullptr, keys, values, value_stride, cold_indices)};
+  if (hit_count) {
+    hit_count += fetch_indirect_(table_name, parts, load, cold_indices.size(),
+                                 cold_indices.data(), keys, values, value_stride, on_miss,
+                                 time_budget, begin);
+  } else {
+    hit_count = fetch_direct_(table_name, parts, load, num_keys, keys, values, value_stride,
+                              on_miss, time_budget, begin);
+  }
+
+  if (load.num_keys_since_refresh.fetch_add(num_keys, std::memory_order_relaxed) + num_keys >=
+      this->params_.hot_key_refresh_interval) {
+    refresh_hot_keys_(table_name, parts, load);
+  }
+  return hit_count;
+}
 
+template <typename Key>
+size_t HashMapBackend<Key>::fetch(const std::string& table_name, const size_t num_indices,
+                                  const size_t* const indices, const Key* const keys,
+                                  char* const values, const size_t value_stride,
+                                  const DatabaseMissCallback& on_miss,
+                                  const std::chrono::nanoseconds& time_budget) {
+  const auto begin{std::chrono::high_resolution_clock::now()};
+  const std::shared_lock lock(read_write_guard_);
+
+  // Locate the partitions.
+  const auto& tables_it{tables_.find(table_name)};
+  if (tables_it == tables_.end()) {
+    return Base::fetch(table_name, num_indices, indices, keys, values, value_stride, on_miss,
+                       time_budget);
+  }
+  std::vector<Partition>& parts{tables_it->second};
+  TableLoad& load{*table_loads_.at(table_name)};
+
+  if (!load.tracker) {
+    return fetch_indirect_(table_name, parts, load, num_indices, indices, keys, values,
+                           value_stride, on_miss, time_budget, begin);
+  }
+  load.tracker->record(num_indices, indices, keys);
+
+  // Serve replicated keys first, and only dispatch the remaining keys to the partitions.
+  std::vector<size_t> cold_indices;
+  size_t hit_count{
+      fetch_replicated_(load, num_indices, indices, keys, values, value_stride, cold_indices)};
+  if (hit_count) {
+    hit_count += fetch_indirect_(table_name, parts, load, cold_indices.size(),
+                                 cold_indices.data(), keys, values, value_stride, on_miss,
+                                 time_budget, begin);
+  } else {
+    hit_count = fetch_indirect_(table_name, parts, load, num_indices, indices, keys, values,
+                                value_stride, on_miss, time_budget, begin);
+  }
+
+  if (load.num_keys_since_refresh.fetch_add(num_indices, std::memory_order_relaxed) +
+          num_indices >=
+      this->params_.hot_key_refresh_interval) {
+    refresh_hot_keys_(table_name, parts, load);
+  }
+  return hit_count;
+}
+
+template <typename Key>
+size_t HashMapBackend<Key>::fetch_direct_(
+    const std::string& table_name, std::vector<Partition>& parts, TableLoad& load,
+    const size_t num_keys, const Key* const keys, char* const values, const size_t value_stride,
+    const DatabaseMissCallback& on_miss, const std::chrono::nanoseconds& time_budget,
+    const std::chrono::high_resolution_clock::time_point& begin) {
   const Key* const keys_end{&keys[num_keys]};
   const size_t num_partitions{parts.size()};
   const size_t max_batch_size{this->params_.max_batch_size};
@@ -245,6 +466,7 @@ size_t HashMapBackend<Key>::fetch(const std::string& table_name, const size_t nu
     const size_t part_index{num_partitions == 1 ? 0 : HCTR_HPS_KEY_TO_PART_INDEX_(*keys)};
     Partition& part{parts[part_index]};
     HCTR_CHECK(part.value_size <= value_stride);
+    load.part_loads[part_index].fetch_add(num_keys, std::memory_order_relaxed);
 
     // Step through input batch-by-batch.
     std::chrono::nanoseconds elapsed;
@@ -264,11 +486,12 @@ size_t HashMapBackend<Key>::fetch(const std::string& table_name, const size_t nu
     std::atomic<size_t> joint_miss_count{0};
     std::atomic<size_t> joint_skip_count{0};
 
-    HCTR_HPS_DB_PARALLEL_FOR_EACH_PART_({
+    HCTR_HPS_HASH_MAP_PARALLEL_FOR_EACH_PART_({
       Partition& part{parts[part_index]};
       HCTR_CHECK(part.value_size <= value_stride);
 
       size_t miss_count{0};
+      size_t num_dispatched{0};
 
       // Step through input batch-by-batch.
       std::chrono::nanoseconds elapsed;
@@ -279,6 +502,7 @@ size_t HashMapBackend<Key>::fetch(const std::string& table_name, const size_t nu
         const size_t prev_miss_count{miss_count};
         size_t batch_size{0};
         HCTR_HPS_HASH_MAP_FETCH_(PARALLEL_DIRECT);
+        num_dispatched += batch_size;
 
         HCTR_LOG_C(TRACE, WORLD, get_name(), " backend; Partition ", table_name, '/', part_index,
                    ", batch ", num_batches, ": ", batch_size - miss_count + prev_miss_count, " / ",
@@ -287,6 +511,7 @@ size_t HashMapBackend<Key>::fetch(const std::string& table_name, const size_t nu
       }
 
       joint_miss_count += miss_count;
+      load.part_loads[part_index].fetch_add(num_dispatched, std::memory_order_relaxed);
     });
 
     miss_count += joint_miss_count;
@@ -300,22 +525,12 @@ size_t HashMapBackend<Key>::fetch(const std::string& table_name, const size_t nu
 }
 
 template <typename Key>
-size_t HashMapBackend<Key>::fetch(const std::string& table_name, const size_t num_indices,
-                                  const size_t* const indices, const Key* const keys,
-                                  char* const values, const size_t value_stride,
-                                  const DatabaseMissCallback& on_miss,
-                                  const std::chrono::nanoseconds& time_budget) {
-  const auto begin{std::chrono::high_resolution_clock::now()};
-  const std::shared_lock lock(read_write_guard_);
-
-  // Locate the partitions.
-  const auto& tables_it{tables_.find(table_name)};
-  if (tables_it == tables_.end()) {
-    return Base::fetch(table_name, num_indices, indices, keys, values, value_stride, on_miss,
-                       time_budget);
-  }
-  std::vector<Partition>& parts{tables_it->second};
-
+size_t HashMapBackend<Key>::fetch_indirect_(
+    const std::string& table_name, std::vector<Partition>& parts, TableLoad& load,
+    const size_t num_indices, const size_t* const indices, const Key* const keys,
+    char* const values, const size_t value_stride, const DatabaseMissCallback& on_miss,
+    const std::chrono::nanoseconds& time_budget,
+    const std::chrono::high_resolution_clock::time_point& begin) {
   const size_t* const indices_end{&indices[num_indices]};
   const size_t num_partitions{parts.size()};
   const size_t max_batch_size{this->params_.max_batch_size};
@@ -327,9 +542,10 @@ size_t HashMapBackend<Key>::fetch(const std::string& table_name, const size_t nu
   if (num_indices == 0) {
     // Do nothing ;-).
   } else if (num_indices == 1 || num_partitions == 1) {
-    const size_t part_index{num_partitions == 1 ? 0 : HCTR_HPS_KEY_TO_PART_INDEX_(*keys)};
+    const size_t part_index{num_partitions == 1 ? 0 : HCTR_HPS_KEY_TO_PART_INDEX_(keys[*indices])};
     Partition& part{parts[part_index]};
     HCTR_CHECK(part.value_size <= value_stride);
+    load.part_loads[part_index].fetch_add(num_indices, std::memory_order_relaxed);
 
     // Step through input batch-by-batch.
     std::chrono::nanoseconds elapsed;
@@ -349,11 +565,12 @@ size_t HashMapBackend<Key>::fetch(const std::string& table_name, const size_t nu
     std::atomic<size_t> joint_miss_count{0};
     std::atomic<size_t> joint_skip_count{0};
 
-    HCTR_HPS_DB_PARALLEL_FOR_EACH_PART_({
+    HCTR_HPS_HASH_MAP_PARALLEL_FOR_EACH_PART_({
       Partition& part{parts[part_index]};
       HCTR_CHECK(part.value_size <= value_stride);
 
       size_t miss_count{0};
+      size_t num_dispatched{0};
 
       // Step through input batch-by-batch.
       std::chrono::nanoseconds elapsed;
@@ -364,6 +581,7 @@ size_t HashMapBackend<Key>::fetch(const std::string& table_name, const size_t nu
         const size_t prev_miss_count{miss_count};
         size_t batch_size{0};
         HCTR_HPS_HASH_MAP_FETCH_(PARALLEL_INDIRECT);
+        num_dispatched += batch_size;
 
         HCTR_LOG_C(TRACE, WORLD, get_name(), " backend; Partition ", table_name, '/', part_index,
                    ", batch ", num_batches, ": ", batch_size - miss_count + prev_miss_count, " / ",
@@ -372,6 +590,7 @@ size_t HashMapBackend<Key>::fetch(const std::string& table_name, const size_t nu
       }
 
       joint_miss_count += miss_count;
+      load.part_loads[part_index].fetch_add(num_dispatched, std::memory_order_relaxed);
     });
 
     miss_count += joint_miss_count;
@@ -384,6 +603,83 @@ size_t HashMapBackend<Key>::fetch(const std::string& table_name, const size_t nu
   return hit_count;
 }
 
+template <typename Key>
+size_t HashMapBackend<Key>::fetch_replicated_(TableLoad& load, const size_t num_indices,
+                                              const size_t* const indices, const Key* const keys,
+                                              char* const values, const size_t value_stride,
+                                              std::vector<size_t>& cold_indices) const {
+  const std::shared_ptr<const HotKeyReplica<Key>> replica{std::atomic_load(&load.replica)};
+  if (!replica || !replica->size()) {
+    return 0;
+  }
+  HCTR_CHECK(replica->value_size() <= value_stride);
+
+  cold_indices.reserve(num_indices);
+  for (size_t j{0}; j < num_indices; ++j) {
+    const size_t index{indices ? indices[j] : j};
+    const char* const value{replica->find(keys[index])};
+    if (value) {
+      std::copy_n(value, replica->value_size(), &values[index * value_stride]);
+    } else {
+      cold_indices.emplace_back(index);
+    }
+  }
+
+  const size_t hit_count{num_indices - cold_indices.size()};
+  if (!hit_count) {
+    cold_indices.clear();
+  }
+  load.replica_hits.fetch_add(hit_count, std::memory_order_relaxed);
+  return hit_count;
+}
+
+template <typename Key>
+void HashMapBackend<Key>::refresh_hot_keys_(const std::string& table_name,
+                                            std::vector<Partition>& parts, TableLoad& load) {
+  // Only one thread refreshes. Others continue with the current replica.
+  const std::unique_lock refresh_lock(load.refresh_guard, std::try_to_lock);
+  if (!refresh_lock.owns_lock()) {
+    return;
+  }
+  load.num_keys_since_refresh.store(0, std::memory_order_relaxed);
+
+  const std::vector<std::pair<Key, uint32_t>>& hot_keys{load.tracker->top()};
+  const size_t num_partitions{parts.size()};
+  auto replica{std::make_shared<HotKeyReplica<Key>>(hot_keys.size(), parts.front().value_size)};
+
+  const time_t now{std::time(nullptr)};
+  for (const auto& [key, count] : hot_keys) {
+    Partition& part{parts[HCTR_HPS_KEY_TO_PART_INDEX_(key)]};
+    const auto& it{part.entries.find(key)};
+    if (it == part.entries.end()) {
+      continue;
+    }
+
+    // Replica hits bypass the partitions. Credit them here, so that overflow resolution does not
+    // consider hot keys as unused. Race-conditions are ignored, like in regular fetches.
+    Payload& payload{it->second};
+    switch (this->params_.overflow_policy) {
+      case DatabaseOverflowPolicy_t::EvictRandom:
+        break;
+      case DatabaseOverflowPolicy_t::EvictLeastUsed:
+        payload.access_count += count * hot_key_sample_stride;
+        break;
+      case DatabaseOverflowPolicy_t::EvictOldest:
+        payload.last_access = now;
+        break;
+    }
+    replica->insert(key, payload.value);
+  }
+
+  // Age the statistics, so that the replica follows shifts of the key distribution.
+  load.tracker->decay();
+  std::atomic_store(&load.replica, replica);
+
+  HCTR_LOG_C(DEBUG, WORLD, get_name(), " backend; Table ", table_name, ": Replicated ",
+             replica->size(), " hot keys (hottest sampled ",
+             hot_keys.empty() ? 0 : hot_keys.front().second, " times).\n");
+}
+
 template <typename Key>
 size_t HashMapBackend<Key>::evict(const std::string& table_name) {
   const std::unique_lock lock(read_write_guard_);
@@ -401,6 +697,7 @@ size_t HashMapBackend<Key>::evict(const std::string& table_name) {
     num_deletions += part.entries.size();
   }
   tables_.erase(tables_it);
+  table_loads_.erase(table_name);
 
   HCTR_LOG_C(TRACE, WORLD, get_name(), " backend; Table ", table_name, ": Erased ", num_deletions,
              " entries.\n");
@@ -444,7 +741,7 @@ size_t HashMapBackend<Key>::evict(const std::string& table_name, const size_t nu
   } else {
     std::atomic<size_t> joint_num_deletions{0};
 
-    HCTR_HPS_DB_PARALLEL_FOR_EACH_PART_({
+    HCTR_HPS_HASH_MAP_PARALLEL_FOR_EACH_PART_({
       Partition& part{parts[part_index]};
 
       size_t num_deletions{0};
@@ -467,6 +764,12 @@ size_t HashMapBackend<Key>::evict(const std::string& table_name, const size_t nu
     num_deletions += joint_num_deletions;
   }
 
+  // Drop the replica if it holds any of the evicted keys. It will be rebuilt at the next refresh.
+  std::shared_ptr<HotKeyReplica<Key>>& replica{table_loads_.at(table_name)->replica};
+  if (replica && std::any_of(keys, keys_end, [&](const Key k) { return replica->find(k); })) {
+    std::atomic_store(&replica, std::shared_ptr<HotKeyReplica<Key>>());
+  }
+
   HCTR_LOG_C(TRACE, WORLD, get_name(), " backend; Table ", table_name, ": Erased ", num_deletions,
              " / ", num_keys, " entries.\n");
   return num_deletions;
@@ -564,6 +867,10 @@ size_t HashMapBackend<Key>::resolve_overflow_(const std::string& table_name,
 
   size_t num_deletions{0};
 
+  // Replicated keys may be evicted. Drop the replica. It will be rebuilt at the next refresh.
+  TableLoad& load{*table_loads_.at(table_name)};
+  std::atomic_store(&load.replica, std::shared_ptr<HotKeyReplica<Key>>());
+
   switch (this->params_.overflow_policy) {
     case DatabaseOverflowPolicy_t::EvictRandom: {
       // Fetch all keys.
@@ -684,9 +991,195 @@ size_t HashMapBackend<Key>::resolve_overflow_(const std::string& table_name,
     } break;
   }
 
+  load.num_overflows.fetch_add(1, std::memory_order_relaxed);
+  load.num_evictions.fetch_add(num_deletions, std::memory_order_relaxed);
   return num_deletions;
 }
 
+template <typename Key>
+size_t HashMapBackend<Key>::compact(const std::string& table_name,
+                                   const std::chrono::microseconds& time_budget) {
+  std::unique_lock lock(read_write_guard_);
+  const auto deadline{std::chrono::steady_clock::now() + time_budget};
+
+  // Locate the partitions.
+  const auto& tables_it{tables_.find(table_name)};
+  if (tables_it == tables_.end()) {
+    return 0;
+  }
+  std::vector<Partition>& parts{tables_it->second};
+  TableLoad& load{*table_loads_.at(table_name)};
+
+  // Continue where the previous compaction ran out of time.
+  size_t num_released{0};
+  for (size_t i{0}; i != parts.size(); ++i) {
+    num_released += compact_partition_(parts[load.next_compaction_part], deadline);
+    if (std::chrono::steady_clock::now() >= deadline) {
+      break;
+    }
+    load.next_compaction_part = (load.next_compaction_part + 1) % parts.size();
+  }
+  lock.unlock();
+
+  if (num_released) {
+#ifdef __GLIBC__
+    // Pages smaller than the mmap threshold are returned to the heap, which keeps them mapped.
+    malloc_trim(0);
+#endif
+    HCTR_LOG_C(DEBUG, WORLD, get_name(), " backend; Table ", table_name, ": Compaction released ",
+               num_released, " bytes.\n");
+  }
+  return num_released;
+}
+
+template <typename Key>
+bool HashMapBackend<Key>::select_draining_page_(Partition& part) const {
+  const size_t num_pages{part.value_pages.size()};
+  if (!num_pages) {
+    return false;
+  }
+  const size_t stride{(part.value_size + value_page_alignment - 1) / value_page_alignment *
+                      value_page_alignment};
+  const size_t page_size{part.value_pages.front().size()};
+  const size_t slots_per_page{page_size / stride};
+
+  // Only compact if at least one page can be released, and the slack is exceeded.
+  const size_t num_keep{(part.entries.size() + slots_per_page - 1) / slots_per_page};
+  if (num_keep == num_pages ||
+      static_cast<double>(part.value_slots.size() * stride) <=
+          this->params_.compaction_slack * static_cast<double>(num_pages * page_size)) {
+    return false;
+  }
+
+  part.draining_page = static_cast<size_t>(
+      std::min_element(part.page_loads.begin(), part.page_loads.end()) - part.page_loads.begin());
+  part.slots_withheld = false;
+  part.slot_cursor = 0;
+  part.next_key.reset();
+  return true;
+}
+
+template <typename Key>
+size_t HashMapBackend<Key>::compact_partition_(
+    Partition& part, const std::chrono::steady_clock::time_point& deadline) {
+  // Every step is bounded, so that the lock is released soon after the deadline. Progress is kept
+  // in the partition, because inserts and evictions may happen before the next call.
+  size_t num_visits{0};
+  const auto out_of_time{[&num_visits, &deadline]() {
+    return ++num_visits % compaction_step == 0 && std::chrono::steady_clock::now() >= deadline;
+  }};
+
+  size_t num_released{0};
+  while (part.draining_page != Partition::no_page || select_draining_page_(part)) {
+    const size_t page{part.draining_page};
+
+    // Withhold the free slots of the page. Inserts take slots from the back, and evictions of
+    // values in the page no longer return their slot, so the slots below the cursor stay clean.
+    if (!part.slots_withheld) {
+      std::vector<ValuePtr>& slots{part.value_slots};
+      part.slot_cursor = std::min(part.slot_cursor, slots.size());
+      while (part.slot_cursor != slots.size()) {
+        if (part.find_page(slots[part.slot_cursor]) == page) {
+          slots[part.slot_cursor] = slots.back();
+          slots.pop_back();
+        } else {
+          ++part.slot_cursor;
+        }
+        if (out_of_time()) {
+          return num_released;
+        }
+      }
+      part.slots_withheld = true;
+    }
+
+    // Move its values to free slots of other pages. Rehashing may reorder the entries between
+    // calls, so the search wraps around until the page is empty.
+    if (part.page_loads[page]) {
+      auto it{part.next_key ? part.entries.find(*part.next_key) : part.entries.end()};
+      part.next_key.reset();
+      while (part.page_loads[page]) {
+        if (it == part.entries.end()) {
+          it = part.entries.begin();
+        }
+        Payload& payload{it->second};
+        if (part.find_page(payload.value) == page) {
+          if (part.value_slots.empty()) {
+            // Resume once inserts allocated more memory.
+            part.next_key = it->first;
+            return num_released;
+          }
+          const ValuePtr value{part.value_slots.back()};
+          part.value_slots.pop_back();
+          std::copy_n(payload.value, part.value_size, value);
+          --part.page_loads[page];
+          part.on_store(value);
+          payload.value = value;
+        }
+        ++it;
+        if (out_of_time()) {
+          if (it != part.entries.end()) {
+            part.next_key = it->first;
+          }
+          return num_released;
+        }
+      }
+    }
+
+    // Release the empty page.
+    num_released += part.value_pages[page].size();
+    part.value_pages.erase(part.value_pages.begin() + static_cast<std::ptrdiff_t>(page));
+    part.page_loads.erase(part.page_loads.begin() + static_cast<std::ptrdiff_t>(page));
+    part.page_addrs.erase(std::find_if(part.page_addrs.begin(), part.page_addrs.end(),
+                                       [page](const auto& addr) { return addr.second == page; }));
+    for (auto& addr : part.page_addrs) {
+      if (addr.second > page) {
+        --addr.second;
+      }
+    }
+    part.draining_page = Partition::no_page;
+
+    if (std::chrono::steady_clock::now() >= deadline) {
+      break;
+    }
+  }
+  return num_released;
+}
+
+template <typename Key>
+void HashMapBackend<Key>::run_compaction_() {
+  const std::chrono::milliseconds interval(this->params_.compaction_interval_ms);
+  const std::chrono::microseconds time_budget(this->params_.compaction_time_budget_us);
+
+  std::unique_lock lock(compaction_guard_);
+  while (!compaction_cv_.wait_for(lock, interval, [this]() { return stop_compaction_; })) {
+    lock.unlock();
+
+    // Lookups can proceed between tables.
+    std::vector<std::string> table_names;
+    {
+      const std::shared_lock tables_lock(read_write_guard_);
+      for (const auto& table : tables_) {
+        table_names.emplace_back(table.first);
+      }
+    }
+    for (const std::string& table_name : table_names) {
+      compact(table_name, time_budget);
+    }
+
+    lock.lock();
+  }
+}
+
+double HashMapBackendLoadStats::imbalance() const {
+  const size_t total{std::accumulate(partition_loads.begin(), partition_loads.end(), size_t{0})};
+  if (!total) {
+    return 1;
+  }
+  const size_t max{*std::max_element(partition_loads.begin(), partition_loads.end())};
+  return static_cast<double>(max) * static_cast<double>(partition_loads.size()) /
+         static_cast<double>(total);
+}
+
 template class HashMapBackend<unsigned int>;
 template class HashMapBackend<long long>;
 
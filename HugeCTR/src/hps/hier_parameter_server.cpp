@@ -118,6 +118,12 @@ HierParameterServer<TypeHashKey>::HierParameterServer(const parameter_server_con
             conf.overflow_policy,
             conf.overflow_resolution_target,
             conf.allocation_rate,
+            conf.numa_aware,
+            conf.hot_key_capacity,
+            conf.hot_key_refresh_interval,
+            conf.compaction_interval_ms,
+            conf.compaction_time_budget_us,
+            conf.compaction_slack,
         };
         volatile_db_ = std::make_unique<HashMapBackend<TypeHashKey>>(params);
       } break;
@@ -170,10 +176,21 @@ HierParameterServer<TypeHashKey>::HierParameterServer(const parameter_server_con
     volatile_db_initialize_after_startup_ = conf.initialize_after_startup;
     volatile_db_cache_rate_ = conf.initial_cache_rate;
     volatile_db_cache_missed_embeddings_ = conf.cache_missed_embeddings;
+    volatile_db_elevation_admission_threshold_ = conf.elevation_admission_threshold;
+    volatile_db_elevation_admission_window_ = conf.elevation_admission_window;
+    HCTR_CHECK_HINT(
+        volatile_db_elevation_admission_threshold_ <= AdmissionFilter<TypeHashKey>::max_threshold,
+        "Volatile DB: elevation_admission_threshold must not exceed ",
+        AdmissionFilter<TypeHashKey>::max_threshold, ".");
     HCTR_LOG_S(INFO, WORLD) << "Volatile DB: initial cache rate = " << volatile_db_cache_rate_
                             << std::endl;
     HCTR_LOG_S(INFO, WORLD) << "Volatile DB: cache missed embeddings = "
                             << volatile_db_cache_missed_embeddings_ << std::endl;
+    if (volatile_db_cache_missed_embeddings_ && volatile_db_elevation_admission_threshold_) {
+      HCTR_LOG_S(INFO, WORLD) << "Volatile DB: elevation admission threshold = "
+                              << volatile_db_elevation_admission_threshold_ << " (window = "
+                              << volatile_db_elevation_admission_window_ << ")" << std::endl;
+    }
   }
 
   // Connect to persistent database.
@@ -201,6 +218,7 @@ HierParameterServer<TypeHashKey>::HierParameterServer(const parameter_server_con
         break;
     }
     persistent_db_initialize_after_startup_ = conf.initialize_after_startup;
+    persistent_db_read_only_ = conf.read_only;
   }
 
   // initialize the profiler
@@ -235,6 +253,7 @@ HierParameterServer<TypeHashKey>::HierParameterServer(const parameter_server_con
 template <typename TypeHashKey>
 HierParameterServer<TypeHashKey>::~HierParameterServer() {
   // Await all pending volatile database transactions.
+  versioned_table_reclaimer_.await_idle();
   volatile_db_async_inserter_.await_idle();
 
   for (auto it = model_cache_map_.begin(); it != model_cache_map_.end(); it++) {
@@ -653,13 +672,20 @@ void HierParameterServer<TypeHashKey>::create_embedding_cache_per_model(
       inference_params.number_of_worker_buffers_in_pool;
   memory_pool_config_.num_refresh_buffer_size_per_model[inference_params.model_name] =
       inference_params.number_of_refresh_buffers_in_pool;
+  memory_pool_config_.max_num_woker_buffer_size_per_model[inference_params.model_name] =
+      inference_params.max_number_of_worker_buffers_in_pool;
+  memory_pool_config_.wait_timeout_ms_per_model[inference_params.model_name] =
+      inference_params.memory_pool_wait_timeout_ms;
   if (buffer_pool_ != nullptr) {
-    buffer_pool_->_create_memory_pool_per_model(inference_params.model_name,
-                                                inference_params.number_of_worker_buffers_in_pool,
-                                                embedding_cache_map, CACHE_SPACE_TYPE::WORKER);
-    buffer_pool_->_create_memory_pool_per_model(inference_params.model_name,
-                                                inference_params.number_of_refresh_buffers_in_pool,
-                                                embedding_cache_map, CACHE_SPACE_TYPE::REFRESHER);
+    buffer_pool_->_create_memory_pool_per_model(
+        inference_params.model_name, inference_params.number_of_worker_buffers_in_pool,
+        embedding_cache_map, CACHE_SPACE_TYPE::WORKER,
+        inference_params.max_number_of_worker_buffers_in_pool,
+        inference_params.memory_pool_wait_timeout_ms);
+    buffer_pool_->_create_memory_pool_per_model(
+        inference_params.model_name, inference_params.number_of_refresh_buffers_in_pool,
+        embedding_cache_map, CACHE_SPACE_TYPE::REFRESHER, 0,
+        inference_params.memory_pool_wait_timeout_ms);
   }
 }
 
@@ -677,6 +703,41 @@ void HierParameterServer<TypeHashKey>::destory_embedding_cache_per_model(
 
 template <typename TypeHashKey>
 void HierParameterServer<TypeHashKey>::erase_model_from_hps(const std::string& model_name) {
+  {
+    // Pending merges hold references to the versioned tables.
+    versioned_table_reclaimer_.await_idle();
+    const std::unique_lock lock(versioned_tables_guard_);
+    const std::string& prefix = make_tag_name(model_name, "", false);
+    for (auto it = versioned_tables_.begin(); it != versioned_tables_.end();) {
+      if (it->first.rfind(prefix, 0) == 0) {
+        it = versioned_tables_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+  }
+  {
+    const std::unique_lock lock(table_counters_guard_);
+    const std::string& prefix = make_tag_name(model_name, "", false);
+    for (auto it = table_counters_.begin(); it != table_counters_.end();) {
+      if (it->first.rfind(prefix, 0) == 0) {
+        it = table_counters_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+  }
+  {
+    const std::unique_lock lock(elevation_filters_guard_);
+    const std::string& prefix = make_tag_name(model_name, "", false);
+    for (auto it = elevation_filters_.begin(); it != elevation_filters_.end();) {
+      if (it->first.rfind(prefix, 0) == 0) {
+        it = elevation_filters_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+  }
   if (volatile_db_) {
     const std::vector<std::string>& table_names = volatile_db_->find_tables(model_name);
     volatile_db_->evict(table_names);
@@ -737,6 +798,12 @@ void HierParameterServer<TypeHashKey>::free_buffer(void* p) {
   return;
 }
 
+template <typename TypeHashKey>
+MemoryPoolStats HierParameterServer<TypeHashKey>::get_buffer_pool_stats(
+    const std::string& model_name, int device_id, CACHE_SPACE_TYPE cache_type) {
+  return buffer_pool_->GetStats(model_name, device_id, cache_type);
+}
+
 template <typename TypeHashKey>
 void HierParameterServer<TypeHashKey>::lookup(const void* const h_keys, const size_t length,
                                               float* const h_vectors, const std::string& model_name,
@@ -758,6 +825,7 @@ void HierParameterServer<TypeHashKey>::lookup(const void* const h_keys, const si
   const std::string& embedding_table_name = ps_config_.emb_table_name_[model_name][table_id];
   const std::string& tag_name = make_tag_name(model_name, embedding_table_name);
   const float default_vec_value = ps_config_.default_emb_vec_value_[*model_id][table_id];
+  const std::shared_ptr<HPSTableCounters> counters = find_table_counters_(tag_name);
 
 #ifdef ENABLE_INFERENCE
   HCTR_LOG_S(TRACE, WORLD) << "Looking up " << length << " embeddings (each with " << embedding_size
@@ -769,17 +837,35 @@ void HierParameterServer<TypeHashKey>::lookup(const void* const h_keys, const si
     std::fill_n(&h_vectors[index * embedding_size], embedding_size, default_vec_value);
   }};
 
+  // Tables that received model updates must be resolved through their current version.
+  const std::shared_ptr<VersionedTable<TypeHashKey>>& versioned_table =
+      find_versioned_table_(tag_name);
+
   // If have volatile and persistent database.
   if (volatile_db_ && persistent_db_) {
+    // Elevated embeddings must not be older than the version that they were looked up from.
+    const std::shared_ptr<const typename VersionedTable<TypeHashKey>::Version>& version =
+        versioned_table && volatile_db_cache_missed_embeddings_ ? versioned_table->pin() : nullptr;
+
     // Do a sequential lookup in the volatile DB, and remember the missing keys.
     constexpr size_t invalid_index{std::numeric_limits<size_t>::max()};
     std::vector<size_t> indices(length, invalid_index);
+    const DatabaseMissCallback remember_missing{
+        [&](const size_t index) { indices[index] = index; }};
 
     start = profiler::start();
-    hit_count += volatile_db_->fetch(tag_name, length, reinterpret_cast<const TypeHashKey*>(h_keys),
-                                     reinterpret_cast<char*>(h_vectors), expected_value_size,
-                                     [&](const size_t index) { indices[index] = index; });
+    if (versioned_table) {
+      hit_count += versioned_table->fetch(length, reinterpret_cast<const TypeHashKey*>(h_keys),
+                                          reinterpret_cast<char*>(h_vectors), expected_value_size,
+                                          remember_missing);
+    } else {
+      hit_count += volatile_db_->fetch(tag_name, length,
+                                       reinterpret_cast<const TypeHashKey*>(h_keys),
+                                       reinterpret_cast<char*>(h_vectors), expected_value_size,
+                                       remember_missing);
+    }
     hps_profiler->end(start, "Lookup the embedding key from VDB");
+    counters->volatile_db.record(length, hit_count);
 
     HCTR_LOG_C(TRACE, WORLD, volatile_db_->get_name(), ": ", hit_count, " hits, ",
                length - hit_count, " missing!\n");
@@ -790,44 +876,68 @@ void HierParameterServer<TypeHashKey>::lookup(const void* const h_keys, const si
 
       // Do a sparse lookup in the persisent DB, to fill gaps and set others to default.
       start = profiler::start();
-      hit_count += persistent_db_->fetch(
+      const size_t pdb_hit_count = persistent_db_->fetch(
           tag_name, indices.size(), indices.data(), reinterpret_cast<const TypeHashKey*>(h_keys),
           reinterpret_cast<char*>(h_vectors), expected_value_size, fill_default);
       hps_profiler->end(start, "Lookup the missing embedding key from the PDB");
+      counters->persistent_db.record(indices.size(), pdb_hit_count);
+      hit_count += pdb_hit_count;
 
       HCTR_LOG_C(TRACE, WORLD, persistent_db_->get_name(), ": ", hit_count, " hits, ",
                  length - hit_count, " still missing!\n");
 
-      // Elevate KV pairs if desired and possible.
-      if (volatile_db_cache_missed_embeddings_) {
-        // If the layer 0 cache should be optimized as we go, elevate missed keys.
-        auto keys_to_elevate{std::make_shared<std::vector<TypeHashKey>>(indices.size())};
-        auto values_to_elevate{
-            std::make_shared<std::vector<float>>(indices.size() * embedding_size)};
+      // Elevate KV pairs if desired and possible. Until a published version has been merged, the
+      // persistent DB may hold outdated values.
+      if (volatile_db_cache_missed_embeddings_ &&
+          (!version || version->delta_table_name.empty())) {
+        // If the layer 0 cache should be optimized as we go, elevate missed keys. Rarely requested
+        // keys would only displace other embeddings, so they must pass the admission filter.
+        const size_t num_candidates{indices.size()};
+        if (volatile_db_elevation_admission_threshold_) {
+          find_elevation_filter_(tag_name)->filter(indices,
+                                                   reinterpret_cast<const TypeHashKey*>(h_keys));
+        }
+        counters->record_elevations(num_candidates, indices.size());
+
+        if (!indices.empty()) {
+          auto keys_to_elevate{std::make_shared<std::vector<TypeHashKey>>(indices.size())};
+          auto values_to_elevate{
+              std::make_shared<std::vector<float>>(indices.size() * embedding_size)};
 
-        start = profiler::start();
-        for (size_t i{}; i != indices.size(); ++i) {
-          const size_t index{indices[i]};
+          start = profiler::start();
+          for (size_t i{}; i != indices.size(); ++i) {
+            const size_t index{indices[i]};
 
-          (*keys_to_elevate)[i] = reinterpret_cast<const TypeHashKey*>(h_keys)[index];
-          std::copy_n(&h_vectors[index * embedding_size], embedding_size,
-                      &(*values_to_elevate)[i * embedding_size]);
+            (*keys_to_elevate)[i] = reinterpret_cast<const TypeHashKey*>(h_keys)[index];
+            std::copy_n(&h_vectors[index * embedding_size], embedding_size,
+                        &(*values_to_elevate)[i * embedding_size]);
+          }
+          hps_profiler->end(start, "Insert the missing embedding key into the VDB");
+
+          HCTR_LOG_C(DEBUG, WORLD, "Attempting to migrate ", keys_to_elevate->size(),
+                     " embeddings from ", persistent_db_->get_name(), " to ",
+                     volatile_db_->get_name(), ".\n");
+
+          start = profiler::start();
+          const uint64_t version_id = version ? version->id : 0;
+          volatile_db_async_inserter_.submit([this, tag_name, keys_to_elevate, values_to_elevate,
+                                              expected_value_size, version_id, start]() {
+            // Skip if a model update was published in the meantime. Otherwise, the pin defers the
+            // merge of the next update until the insert completed.
+            const std::shared_ptr<VersionedTable<TypeHashKey>>& versioned_table =
+                find_versioned_table_(tag_name);
+            const std::shared_ptr<const typename VersionedTable<TypeHashKey>::Version>& version =
+                versioned_table ? versioned_table->pin() : nullptr;
+            if (version && (version->id != version_id || !version->delta_table_name.empty())) {
+              return;
+            }
+            volatile_db_->insert(tag_name, keys_to_elevate->size(), keys_to_elevate->data(),
+                                 reinterpret_cast<char*>(values_to_elevate->data()),
+                                 expected_value_size, expected_value_size);
+            hps_profiler->end(
+                start, "Insert the missing embedding key from the PDB into the VDB asynchronously");
+          });
         }
-        hps_profiler->end(start, "Insert the missing embedding key into the VDB");
-
-        HCTR_LOG_C(DEBUG, WORLD, "Attempting to migrate ", keys_to_elevate->size(),
-                   " embeddings from ", persistent_db_->get_name(), " to ",
-                   volatile_db_->get_name(), ".\n");
-
-        start = profiler::start();
-        volatile_db_async_inserter_.submit([this, tag_name, keys_to_elevate, values_to_elevate,
-                                            expected_value_size, start]() {
-          volatile_db_->insert(tag_name, keys_to_elevate->size(), keys_to_elevate->data(),
-                               reinterpret_cast<char*>(values_to_elevate->data()),
-                               expected_value_size, expected_value_size);
-          hps_profiler->end(
-              start, "Insert the missing embedding key from the PDB into the VDB asynchronously");
-        });
       }
     }
   } else {
@@ -838,9 +948,17 @@ void HierParameterServer<TypeHashKey>::lookup(const void* const h_keys, const si
     if (db) {
       start = profiler::start();
       // Do a sequential lookup in the volatile DB, but fill gaps with a default value.
-      hit_count += db->fetch(tag_name, length, reinterpret_cast<const TypeHashKey*>(h_keys),
-                             reinterpret_cast<char*>(h_vectors), expected_value_size, fill_default);
+      if (versioned_table) {
+        hit_count += versioned_table->fetch(length, reinterpret_cast<const TypeHashKey*>(h_keys),
+                                            reinterpret_cast<char*>(h_vectors),
+                                            expected_value_size, fill_default);
+      } else {
+        hit_count += db->fetch(tag_name, length, reinterpret_cast<const TypeHashKey*>(h_keys),
+                               reinterpret_cast<char*>(h_vectors), expected_value_size,
+                               fill_default);
+      }
       hps_profiler->end(start, "Lookup the embedding key from default HPS database Backend");
+      (volatile_db_ ? counters->volatile_db : counters->persistent_db).record(length, hit_count);
       HCTR_LOG_C(TRACE, WORLD, db->get_name(), ": ", hit_count, " hits, ", length - hit_count,
                  " missing!\n");
     } else {
@@ -850,6 +968,8 @@ void HierParameterServer<TypeHashKey>::lookup(const void* const h_keys, const si
     }
   }
 
+  counters->record_defaults(length - hit_count);
+
   const auto end_time = std::chrono::high_resolution_clock::now();
   const auto duration =
       std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time);
@@ -859,6 +979,229 @@ void HierParameterServer<TypeHashKey>::lookup(const void* const h_keys, const si
 #endif
 }
 
+template <typename TypeHashKey>
+std::shared_ptr<VersionedTable<TypeHashKey>>
+HierParameterServer<TypeHashKey>::find_versioned_table_(const std::string& tag_name) const {
+  const std::shared_lock lock(versioned_tables_guard_);
+  const auto it = versioned_tables_.find(tag_name);
+  return it != versioned_tables_.end() ? it->second : nullptr;
+}
+
+template <typename TypeHashKey>
+std::shared_ptr<HPSTableCounters> HierParameterServer<TypeHashKey>::find_table_counters_(
+    const std::string& tag_name) {
+  {
+    const std::shared_lock lock(table_counters_guard_);
+    const auto it = table_counters_.find(tag_name);
+    if (it != table_counters_.end()) {
+      return it->second;
+    }
+  }
+
+  const std::unique_lock lock(table_counters_guard_);
+  std::shared_ptr<HPSTableCounters>& counters = table_counters_[tag_name];
+  if (!counters) {
+    counters = std::make_shared<HPSTableCounters>();
+  }
+  return counters;
+}
+
+template <typename TypeHashKey>
+std::shared_ptr<AdmissionFilter<TypeHashKey>>
+HierParameterServer<TypeHashKey>::find_elevation_filter_(const std::string& tag_name) {
+  {
+    const std::shared_lock lock(elevation_filters_guard_);
+    const auto it = elevation_filters_.find(tag_name);
+    if (it != elevation_filters_.end()) {
+      return it->second;
+    }
+  }
+
+  const std::unique_lock lock(elevation_filters_guard_);
+  std::shared_ptr<AdmissionFilter<TypeHashKey>>& filter = elevation_filters_[tag_name];
+  if (!filter) {
+    filter = std::make_shared<AdmissionFilter<TypeHashKey>>(
+        static_cast<uint32_t>(volatile_db_elevation_admission_threshold_),
+        volatile_db_elevation_admission_window_);
+  }
+  return filter;
+}
+
+template <typename TypeHashKey>
+std::shared_ptr<HPSTableCounters> HierParameterServer<TypeHashKey>::get_table_counters(
+    const std::string& model_name, const size_t table_id) {
+  const auto it = ps_config_.emb_table_name_.find(model_name);
+  HCTR_CHECK_HINT(it != ps_config_.emb_table_name_.end() && table_id < it->second.size(),
+                  "Error: parameter server unknown model name or table id.\n");
+  return find_table_counters_(make_tag_name(model_name, it->second[table_id]));
+}
+
+template <typename TypeHashKey>
+std::vector<HPSTableStats> HierParameterServer<TypeHashKey>::get_stats(
+    const std::string& model_name) {
+  std::vector<HPSTableStats> stats;
+  for (const auto& [name, table_names] : ps_config_.emb_table_name_) {
+    if (!model_name.empty() && name != model_name) {
+      continue;
+    }
+    for (const std::string& table_name : table_names) {
+      const std::string& tag_name = make_tag_name(name, table_name);
+
+      HPSTableStats table_stats;
+      table_stats.model_name = name;
+      table_stats.table_name = table_name;
+      find_table_counters_(tag_name)->snapshot(table_stats);
+      if (volatile_db_) {
+        table_stats.volatile_db_table = volatile_db_->table_stats(tag_name);
+      }
+      if (persistent_db_) {
+        table_stats.persistent_db_table = persistent_db_->table_stats(tag_name);
+      }
+      stats.emplace_back(std::move(table_stats));
+    }
+  }
+  return stats;
+}
+
+template <typename TypeHashKey>
+void HierParameterServer<TypeHashKey>::stage_model_update(const std::string& model_name,
+                                                          const size_t table_id,
+                                                          const void* const h_keys,
+                                                          const float* const h_vectors,
+                                                          const size_t length) {
+  HCTR_CHECK_HINT(static_cast<bool>(ps_config_.find_model_id(model_name)),
+                  "Error: parameter server unknown model name.\n");
+  DatabaseBackendBase<TypeHashKey>* const db =
+      volatile_db_ ? static_cast<DatabaseBackendBase<TypeHashKey>*>(volatile_db_.get())
+                   : static_cast<DatabaseBackendBase<TypeHashKey>*>(persistent_db_.get());
+  HCTR_CHECK_HINT(db, "Model updates require a volatile or persistent database.\n");
+  HCTR_CHECK_HINT(!persistent_db_ || !persistent_db_read_only_,
+                  "Model updates cannot be written to a read-only persistent database.\n");
+
+  const size_t embedding_size = ps_config_.embedding_vec_size_[model_name][table_id];
+  const size_t expected_value_size = embedding_size * sizeof(float);
+  const std::string& tag_name =
+      make_tag_name(model_name, ps_config_.emb_table_name_[model_name][table_id]);
+
+  std::shared_ptr<VersionedTable<TypeHashKey>> versioned_table = find_versioned_table_(tag_name);
+  if (!versioned_table) {
+    bool created = false;
+    {
+      const std::unique_lock lock(versioned_tables_guard_);
+      auto& entry = versioned_tables_[tag_name];
+      if (!entry) {
+        // The volatile database only caches the persistent one. Hence, both must be updated.
+        entry = std::make_shared<VersionedTable<TypeHashKey>>(
+            *db, tag_name, db == volatile_db_.get() ? persistent_db_.get() : nullptr);
+        created = true;
+      }
+      versioned_table = entry;
+    }
+    // Pending elevations that did not see the versioned table hold no pin, and could otherwise
+    // overwrite merged rows.
+    if (created) {
+      volatile_db_async_inserter_.await_idle();
+    }
+  }
+
+  // Staging into the same table as the pending merge is serialized by the versioned table.
+  const size_t num_staged = versioned_table->stage(
+      length, reinterpret_cast<const TypeHashKey*>(h_keys),
+      reinterpret_cast<const char*>(h_vectors), expected_value_size, expected_value_size);
+  HCTR_LOG_S(DEBUG, WORLD) << "Staged " << length << " embeddings for '" << tag_name << "' ("
+                           << num_staged << " in total)." << std::endl;
+}
+
+template <typename TypeHashKey>
+void HierParameterServer<TypeHashKey>::publish_model_update(const std::string& model_name) {
+  const auto table_names = ps_config_.emb_table_name_.find(model_name);
+  HCTR_CHECK_HINT(table_names != ps_config_.emb_table_name_.end(),
+                  "Error: parameter server unknown model name.\n");
+
+  for (size_t table_id = 0; table_id < table_names->second.size(); ++table_id) {
+    const std::shared_ptr<VersionedTable<TypeHashKey>>& versioned_table =
+        find_versioned_table_(make_tag_name(model_name, table_names->second[table_id]));
+    if (!versioned_table || !versioned_table->num_staged()) {
+      continue;
+    }
+    std::vector<TypeHashKey> published_keys;
+    const uint64_t version = versioned_table->publish(&published_keys);
+    HCTR_LOG_S(INFO, WORLD) << "Published version " << version << " of '"
+                            << versioned_table->table_name() << "'." << std::endl;
+
+    // Embedding caches are looked up first. Hence, they must not keep serving the old rows.
+    update_embedding_cache_(model_name, table_id, published_keys);
+
+    // Merge the delta into the base table once in-flight lookups of the old version drained.
+    versioned_table_reclaimer_.submit([versioned_table]() { versioned_table->reclaim(); });
+  }
+}
+
+template <typename TypeHashKey>
+void HierParameterServer<TypeHashKey>::update_embedding_cache_(
+    const std::string& model_name, const size_t table_id, const std::vector<TypeHashKey>& keys) {
+  const auto caches = model_cache_map_.find(model_name);
+  if (caches == model_cache_map_.end() || keys.empty()) {
+    return;
+  }
+
+  for (const auto& [device_id, embedding_cache] : caches->second) {
+    const embedding_cache_config cache_config = embedding_cache->get_cache_config();
+    // The host embedding cache is updated in host memory.
+    const bool on_device = embedding_cache->use_gpu_embedding_cache();
+    if (!on_device && !cache_config.use_host_embedding_cache_) {
+      continue;
+    }
+    CudaDeviceContext dev_restorer{cache_config.cuda_dev_id_};
+    // Pending asynchronous inserts may have looked up the previous version.
+    embedding_cache->finalize();
+    std::vector<cudaStream_t> streams = embedding_cache->get_refresh_streams();
+    streams.resize(cache_config.num_emb_table_, nullptr);
+    const cudaStream_t stream = streams[table_id];
+
+    MemoryBlock* memory_block = nullptr;
+    while (memory_block == nullptr) {
+      memory_block = reinterpret_cast<struct MemoryBlock*>(
+          this->apply_buffer(model_name, static_cast<int>(device_id), CACHE_SPACE_TYPE::REFRESHER));
+    }
+    const EmbeddingCacheRefreshspace& refreshspace_handler = memory_block->refresh_buffer;
+    TypeHashKey* const h_keys =
+        static_cast<TypeHashKey*>(refreshspace_handler.h_refresh_embeddingcolumns_);
+    float* const h_vectors = refreshspace_handler.h_refresh_emb_vec_;
+
+    // The refresh workspace is rounded up to whole cache sets.
+    const size_t keys_per_set = SLAB_SIZE * SET_ASSOCIATIVITY;
+    const size_t batch_size =
+        std::max<size_t>(cache_config.num_set_in_refresh_workspace_, 2) * keys_per_set -
+        keys_per_set;
+    const size_t embedding_size = cache_config.embedding_vec_size_[table_id];
+    for (size_t i = 0; i < keys.size(); i += batch_size) {
+      const size_t length = std::min(keys.size() - i, batch_size);
+      std::copy_n(&keys[i], length, h_keys);
+      // Resolves the keys through the published version.
+      this->lookup(h_keys, length, h_vectors, model_name, table_id);
+
+      if (on_device) {
+        HCTR_LIB_THROW(cudaMemcpyAsync(refreshspace_handler.d_refresh_embeddingcolumns_, h_keys,
+                                       length * sizeof(TypeHashKey), cudaMemcpyHostToDevice,
+                                       stream));
+        HCTR_LIB_THROW(cudaMemcpyAsync(refreshspace_handler.d_refresh_emb_vec_, h_vectors,
+                                       length * embedding_size * sizeof(float),
+                                       cudaMemcpyHostToDevice, stream));
+        embedding_cache->refresh(table_id, refreshspace_handler.d_refresh_embeddingcolumns_,
+                                 refreshspace_handler.d_refresh_emb_vec_, length, stream);
+        HCTR_LIB_THROW(cudaStreamSynchronize(stream));
+      } else {
+        embedding_cache->refresh(table_id, h_keys, h_vectors, length, stream);
+      }
+    }
+    this->free_buffer(memory_block);
+    HCTR_LOG_S(DEBUG, WORLD) << "Updated " << keys.size() << " embeddings of table " << table_id
+                             << " in the embedding cache of model '" << model_name
+                             << "' on device " << device_id << '.' << std::endl;
+  }
+}
+
 template <typename TypeHashKey>
 void HierParameterServer<TypeHashKey>::refresh_embedding_cache(const std::string& model_name,
                                                                const int device_id) {
@@ -867,12 +1210,14 @@ void HierParameterServer<TypeHashKey>::refresh_embedding_cache(const std::string
   HugeCTR::Timer timer_refresh;
 
   std::shared_ptr<EmbeddingCacheBase> embedding_cache = get_embedding_cache(model_name, device_id);
-  if (!embedding_cache->use_gpu_embedding_cache()) {
-    HCTR_LOG(WARNING, WORLD, "GPU embedding cache is not enabled and cannot be refreshed!\n");
+  embedding_cache_config cache_config = embedding_cache->get_cache_config();
+  // The host embedding cache is dumped and refreshed in host memory.
+  const bool on_device = embedding_cache->use_gpu_embedding_cache();
+  if (!on_device && !cache_config.use_host_embedding_cache_) {
+    HCTR_LOG(WARNING, WORLD, "Embedding cache is not enabled and cannot be refreshed!\n");
     return;
   }
 
-  embedding_cache_config cache_config = embedding_cache->get_cache_config();
   if (cache_config.cache_refresh_percentage_per_iteration <= 0) {
     HCTR_LOG(WARNING, WORLD,
              "The configuration of cache refresh percentage per iteration must be greater than 0 "
@@ -881,6 +1226,7 @@ void HierParameterServer<TypeHashKey>::refresh_embedding_cache(const std::string
   }
   timer_refresh.start();
   std::vector<cudaStream_t> streams = embedding_cache->get_refresh_streams();
+  streams.resize(cache_config.num_emb_table_, nullptr);
   // apply the memory block for embedding cache refresh workspace
   MemoryBlock* memory_block = nullptr;
   while (memory_block == nullptr) {
@@ -888,6 +1234,12 @@ void HierParameterServer<TypeHashKey>::refresh_embedding_cache(const std::string
         this->apply_buffer(model_name, device_id, CACHE_SPACE_TYPE::REFRESHER));
   }
   EmbeddingCacheRefreshspace refreshspace_handler = memory_block->refresh_buffer;
+  void* const refresh_keys = on_device ? refreshspace_handler.d_refresh_embeddingcolumns_
+                                       : refreshspace_handler.h_refresh_embeddingcolumns_;
+  float* const refresh_vectors =
+      on_device ? refreshspace_handler.d_refresh_emb_vec_ : refreshspace_handler.h_refresh_emb_vec_;
+  size_t* const refresh_length =
+      on_device ? refreshspace_handler.d_length_ : refreshspace_handler.h_length_;
   // Refresh the embedding cache for each table
   const size_t stride_set = cache_config.num_set_in_refresh_workspace_;
   HugeCTR::Timer timer;
@@ -897,17 +1249,19 @@ void HierParameterServer<TypeHashKey>::refresh_embedding_cache(const std::string
                                  ? cache_config.num_set_in_cache_[i]
                                  : idx_set + stride_set;
       timer.start();
-      embedding_cache->dump(i, refreshspace_handler.d_refresh_embeddingcolumns_,
-                            refreshspace_handler.d_length_, idx_set, end_idx, streams[i]);
-
-      HCTR_LIB_THROW(cudaMemcpyAsync(refreshspace_handler.h_length_, refreshspace_handler.d_length_,
-                                     sizeof(size_t), cudaMemcpyDeviceToHost, streams[i]));
-      HCTR_LIB_THROW(cudaStreamSynchronize(streams[i]));
-      HCTR_LIB_THROW(cudaMemcpyAsync(refreshspace_handler.h_refresh_embeddingcolumns_,
-                                     refreshspace_handler.d_refresh_embeddingcolumns_,
-                                     *refreshspace_handler.h_length_ * sizeof(TypeHashKey),
-                                     cudaMemcpyDeviceToHost, streams[i]));
-      HCTR_LIB_THROW(cudaStreamSynchronize(streams[i]));
+      embedding_cache->dump(i, refresh_keys, refresh_length, idx_set, end_idx, streams[i]);
+
+      if (on_device) {
+        HCTR_LIB_THROW(cudaMemcpyAsync(refreshspace_handler.h_length_,
+                                       refreshspace_handler.d_length_, sizeof(size_t),
+                                       cudaMemcpyDeviceToHost, streams[i]));
+        HCTR_LIB_THROW(cudaStreamSynchronize(streams[i]));
+        HCTR_LIB_THROW(cudaMemcpyAsync(refreshspace_handler.h_refresh_embeddingcolumns_,
+                                       refreshspace_handler.d_refresh_embeddingcolumns_,
+                                       *refreshspace_handler.h_length_ * sizeof(TypeHashKey),
+                                       cudaMemcpyDeviceToHost, streams[i]));
+        HCTR_LIB_THROW(cudaStreamSynchronize(streams[i]));
+      }
       timer.stop();
       HCTR_LOG_S(TRACE, ROOT) << "Embedding Cache dumping the number of " << stride_set
                               << " sets takes: " << timer.elapsedSeconds() << "s" << std::endl;
@@ -915,24 +1269,27 @@ void HierParameterServer<TypeHashKey>::refresh_embedding_cache(const std::string
       this->lookup(
           reinterpret_cast<const TypeHashKey*>(refreshspace_handler.h_refresh_embeddingcolumns_),
           *refreshspace_handler.h_length_, refreshspace_handler.h_refresh_emb_vec_, model_name, i);
-      HCTR_LIB_THROW(cudaMemcpyAsync(
-          refreshspace_handler.d_refresh_emb_vec_, refreshspace_handler.h_refresh_emb_vec_,
-          *refreshspace_handler.h_length_ * cache_config.embedding_vec_size_[i] * sizeof(float),
-          cudaMemcpyHostToDevice, streams[i]));
-      HCTR_LIB_THROW(cudaStreamSynchronize(streams[i]));
+      if (on_device) {
+        HCTR_LIB_THROW(cudaMemcpyAsync(
+            refreshspace_handler.d_refresh_emb_vec_, refreshspace_handler.h_refresh_emb_vec_,
+            *refreshspace_handler.h_length_ * cache_config.embedding_vec_size_[i] * sizeof(float),
+            cudaMemcpyHostToDevice, streams[i]));
+        HCTR_LIB_THROW(cudaStreamSynchronize(streams[i]));
+      }
       timer.stop();
       HCTR_LOG_S(TRACE, ROOT) << "Parameter Server looking up the number of "
                               << *refreshspace_handler.h_length_
                               << " keys takes: " << timer.elapsedSeconds() << "s" << std::endl;
       timer.start();
-      embedding_cache->refresh(
-          static_cast<int>(i), refreshspace_handler.d_refresh_embeddingcolumns_,
-          refreshspace_handler.d_refresh_emb_vec_, *refreshspace_handler.h_length_, streams[i]);
+      embedding_cache->refresh(static_cast<int>(i), refresh_keys, refresh_vectors,
+                               *refreshspace_handler.h_length_, streams[i]);
       timer.stop();
       HCTR_LOG_S(TRACE, ROOT) << "Embedding Cache refreshing the number of "
                               << *refreshspace_handler.h_length_
                               << " keys takes: " << timer.elapsedSeconds() << "s" << std::endl;
-      HCTR_LIB_THROW(cudaStreamSynchronize(streams[i]));
+      if (on_device) {
+        HCTR_LIB_THROW(cudaStreamSynchronize(streams[i]));
+      }
     }
   }
   // apply the memory block for embedding cache refresh workspace
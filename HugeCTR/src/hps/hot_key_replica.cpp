@@ -0,0 +1,209 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <core23/logger.hpp>
+#include <hps/database_backend_detail.hpp>
+#include <hps/hot_key_replica.hpp>
+
+namespace HugeCTR {
+
+namespace {
+
+inline size_t next_pow2(const size_t n) {
+  size_t p{1};
+  while (p < n) {
+    p <<= 1;
+  }
+  return p;
+}
+
+}  // namespace
+
+template <typename Key>
+HotKeyTracker<Key>::HotKeyTracker(const size_t capacity, const size_t sample_stride)
+    : capacity_{capacity}, sample_stride_{std::max(sample_stride, size_t{1})} {
+  HCTR_CHECK_HINT(capacity_ > 0, "Hot key tracker capacity must be positive.");
+
+  // A width of a few times the number of tracked keys keeps the overestimation of heavy hitters
+  // small compared to their actual frequency.
+  const size_t width{next_pow2(std::max(capacity_ * 8, size_t{1024}))};
+  width_mask_ = width - 1;
+  counters_ = std::vector<std::atomic<uint32_t>>(depth_ * width);
+  candidates_.reserve(2 * capacity_);
+}
+
+template <typename Key>
+size_t HotKeyTracker<Key>::counter_index_(const Key key, const size_t row) const {
+  // Kirsch-Mitzenmacher: derive the row hashes from two halves of a single strong hash.
+  const uint64_t h{rrxmrrxmsx_0(static_cast<uint64_t>(key) ^ UINT64_C(0x5851F42D4C957F2D))};
+  const size_t h1{static_cast<size_t>(h)};
+  const size_t h2{static_cast<size_t>(h >> 32) | 1};
+  return row * (width_mask_ + 1) + ((h1 + row * h2) & width_mask_);
+}
+
+template <typename Key>
+uint32_t HotKeyTracker<Key>::increment_(const Key key) {
+  uint32_t count{std::numeric_limits<uint32_t>::max()};
+  for (size_t row{0}; row < depth_; ++row) {
+    std::atomic<uint32_t>& counter{counters_[counter_index_(key, row)]};
+    count = std::min(count, counter.fetch_add(1, std::memory_order_relaxed) + 1);
+  }
+  return count;
+}
+
+template <typename Key>
+uint32_t HotKeyTracker<Key>::estimate(const Key key) const {
+  uint32_t count{std::numeric_limits<uint32_t>::max()};
+  for (size_t row{0}; row < depth_; ++row) {
+    count = std::min(count, counters_[counter_index_(key, row)].load(std::memory_order_relaxed));
+  }
+  return count;
+}
+
+template <typename Key>
+void HotKeyTracker<Key>::record(const size_t num_keys, const Key* const keys) {
+  const uint32_t threshold{admission_threshold_.load(std::memory_order_relaxed)};
+  std::vector<std::pair<Key, uint32_t>> admissions;
+
+  // Rotate the sampling offset, so that all positions of a batch are sampled over time.
+  const size_t offset{sample_offset_.fetch_add(1, std::memory_order_relaxed) % sample_stride_};
+  for (size_t i{offset}; i < num_keys; i += sample_stride_) {
+    const uint32_t count{increment_(keys[i])};
+    if (count > threshold) {
+      admissions.emplace_back(keys[i], count);
+    }
+  }
+  if (!admissions.empty()) {
+    admit_(admissions);
+  }
+}
+
+template <typename Key>
+void HotKeyTracker<Key>::record(const size_t num_indices, const size_t* const indices,
+                                const Key* const keys) {
+  const uint32_t threshold{admission_threshold_.load(std::memory_order_relaxed)};
+  std::vector<std::pair<Key, uint32_t>> admissions;
+
+  const size_t offset{sample_offset_.fetch_add(1, std::memory_order_relaxed) % sample_stride_};
+  for (size_t i{offset}; i < num_indices; i += sample_stride_) {
+    const Key key{keys[indices[i]]};
+    const uint32_t count{increment_(key)};
+    if (count > threshold) {
+      admissions.emplace_back(key, count);
+    }
+  }
+  if (!admissions.empty()) {
+    admit_(admissions);
+  }
+}
+
+template <typename Key>
+void HotKeyTracker<Key>::admit_(const std::vector<std::pair<Key, uint32_t>>& keys) {
+  const std::lock_guard lock(candidates_guard_);
+
+  for (const auto& [key, count] : keys) {
+    uint32_t& candidate_count{candidates_[key]};
+    candidate_count = std::max(candidate_count, count);
+  }
+
+  // Prune back to `capacity_` keys. Amortized over at least `capacity_` admissions.
+  if (candidates_.size() >= 2 * capacity_) {
+    std::vector<std::pair<Key, uint32_t>> sorted(candidates_.begin(), candidates_.end());
+    std::nth_element(sorted.begin(), sorted.begin() + static_cast<ptrdiff_t>(capacity_ - 1),
+                     sorted.end(),
+                     [](const auto& a, const auto& b) { return a.second > b.second; });
+    sorted.resize(capacity_);
+
+    candidates_.clear();
+    candidates_.insert(sorted.begin(), sorted.end());
+    admission_threshold_.store(sorted.back().second, std::memory_order_relaxed);
+  }
+}
+
+template <typename Key>
+std::vector<std::pair<Key, uint32_t>> HotKeyTracker<Key>::top() const {
+  std::vector<std::pair<Key, uint32_t>> sorted;
+  {
+    const std::lock_guard lock(candidates_guard_);
+    sorted.assign(candidates_.begin(), candidates_.end());
+  }
+
+  const auto by_count{[](const auto& a, const auto& b) { return a.second > b.second; }};
+  if (sorted.size() > capacity_) {
+    std::nth_element(sorted.begin(), sorted.begin() + static_cast<ptrdiff_t>(capacity_ - 1),
+                     sorted.end(), by_count);
+    sorted.resize(capacity_);
+  }
+  std::sort(sorted.begin(), sorted.end(), by_count);
+  return sorted;
+}
+
+template <typename Key>
+void HotKeyTracker<Key>::decay() {
+  // Concurrent increments may be lost. That is acceptable for an estimate.
+  for (std::atomic<uint32_t>& counter : counters_) {
+    counter.store(counter.load(std::memory_order_relaxed) / 2, std::memory_order_relaxed);
+  }
+
+  const std::lock_guard lock(candidates_guard_);
+  for (auto& candidate : candidates_) {
+    candidate.second /= 2;
+  }
+  admission_threshold_.store(admission_threshold_.load(std::memory_order_relaxed) / 2,
+                             std::memory_order_relaxed);
+}
+
+template <typename Key>
+HotKeyReplica<Key>::HotKeyReplica(const size_t capacity, const uint32_t value_size)
+    : capacity_{capacity},
+      value_size_{value_size},
+      value_stride_{(value_size + AlignedAllocator<char>::alignment - 1) /
+                    AlignedAllocator<char>::alignment * AlignedAllocator<char>::alignment} {
+  HCTR_CHECK(capacity_ < empty_slot);
+
+  // Load factor <= 0.5 keeps probe sequences short.
+  mask_ = next_pow2(std::max(capacity_ * 2, size_t{2})) - 1;
+  slots_.resize(mask_ + 1, Slot{Key{}, empty_slot});
+  values_.resize(capacity_ * value_stride_);
+}
+
+template <typename Key>
+bool HotKeyReplica<Key>::insert(const Key key, const char* const value) {
+  size_t i{hash_(key) & mask_};
+  for (; slots_[i].value_index != empty_slot; i = (i + 1) & mask_) {
+    if (slots_[i].key == key) {
+      std::copy_n(value, value_size_, &values_[slots_[i].value_index * value_stride_]);
+      return true;
+    }
+  }
+  if (size_ >= capacity_) {
+    return false;
+  }
+
+  slots_[i] = {key, static_cast<uint32_t>(size_)};
+  std::copy_n(value, value_size_, &values_[size_ * value_stride_]);
+  ++size_;
+  return true;
+}
+
+template class HotKeyTracker<unsigned int>;
+template class HotKeyTracker<long long>;
+
+template class HotKeyReplica<unsigned int>;
+template class HotKeyReplica<long long>;
+
+}  // namespace HugeCTR
@@ -36,6 +36,11 @@ bool VolatileDatabaseParams::operator==(const VolatileDatabaseParams& p) const {
          // Backend specific.
          address == p.address && user_name == p.user_name && password == p.password &&
          num_partitions == p.num_partitions && allocation_rate == p.allocation_rate &&
+         numa_aware == p.numa_aware && hot_key_capacity == p.hot_key_capacity &&
+         hot_key_refresh_interval == p.hot_key_refresh_interval &&
+         compaction_interval_ms == p.compaction_interval_ms &&
+         compaction_time_budget_us == p.compaction_time_budget_us &&
+         compaction_slack == p.compaction_slack &&
          shared_memory_size == p.shared_memory_size && shared_memory_name == p.shared_memory_name &&
          shared_memory_auto_remove == p.shared_memory_auto_remove &&
          num_node_connections == p.num_node_connections && max_batch_size == p.max_batch_size &&
@@ -49,6 +54,8 @@ bool VolatileDatabaseParams::operator==(const VolatileDatabaseParams& p) const {
          initialize_after_startup == p.initialize_after_startup &&
          initial_cache_rate == p.initial_cache_rate &&
          cache_missed_embeddings == p.cache_missed_embeddings &&
+         elevation_admission_threshold == p.elevation_admission_threshold &&
+         elevation_admission_window == p.elevation_admission_window &&
          // Real-time update mechanism related.
          update_filters == p.update_filters;
 }
@@ -89,7 +96,10 @@ VolatileDatabaseParams::VolatileDatabaseParams(
     const DatabaseType_t type,
     // Backend specific.
     const std::string& address, const std::string& user_name, const std::string& password,
-    const size_t num_partitions, const size_t allocation_rate, const size_t shared_memory_size,
+    const size_t num_partitions, const size_t allocation_rate, const bool numa_aware,
+    const size_t hot_key_capacity, const size_t hot_key_refresh_interval,
+    const size_t compaction_interval_ms, const size_t compaction_time_budget_us,
+    const double compaction_slack, const size_t shared_memory_size,
     const std::string& shared_memory_name, const bool shared_memory_auto_remove,
     const size_t num_node_connections, const size_t max_batch_size, const bool enable_tls,
     const std::string& tls_ca_certificate, const std::string& tls_client_certificate,
@@ -99,7 +109,8 @@ VolatileDatabaseParams::VolatileDatabaseParams(
     const double overflow_resolution_target,
     // Caching behavior related.
     const bool initialize_after_startup, const double initial_cache_rate,
-    const bool cache_missed_embeddings,
+    const bool cache_missed_embeddings, const size_t elevation_admission_threshold,
+    const size_t elevation_admission_window,
     // Real-time update mechanism related.
     const std::vector<std::string>& update_filters)
     : type{type},
@@ -109,6 +120,12 @@ VolatileDatabaseParams::VolatileDatabaseParams(
       password{password},
       num_partitions{num_partitions},
       allocation_rate{allocation_rate},
+      numa_aware{numa_aware},
+      hot_key_capacity{hot_key_capacity},
+      hot_key_refresh_interval{hot_key_refresh_interval},
+      compaction_interval_ms{compaction_interval_ms},
+      compaction_time_budget_us{compaction_time_budget_us},
+      compaction_slack{compaction_slack},
       shared_memory_size{shared_memory_size},
       shared_memory_name{shared_memory_name},
       shared_memory_auto_remove{shared_memory_auto_remove},
@@ -127,6 +144,8 @@ VolatileDatabaseParams::VolatileDatabaseParams(
       initialize_after_startup{initialize_after_startup},
       initial_cache_rate{initial_cache_rate},
       cache_missed_embeddings{cache_missed_embeddings},
+      elevation_admission_threshold{elevation_admission_threshold},
+      elevation_admission_window{elevation_admission_window},
       // Real-time update mechanism related.
       update_filters{update_filters} {}
 
@@ -193,7 +212,9 @@ InferenceParams::InferenceParams(
     const size_t label_dim, const size_t slot_num, const std::string& non_trainable_params_file,
     bool use_static_table, EmbeddingCacheType_t embedding_cache_type, bool use_context_stream,
     bool fuse_embedding_table, bool use_hctr_cache_implementation, bool init_ec,
-    bool enable_pagelock, bool fp8_quant)
+    bool enable_pagelock, bool fp8_quant, int max_number_of_worker_buffers_in_pool,
+    int memory_pool_wait_timeout_ms, bool enable_lookup_batching, int lookup_batching_delay_us,
+    int lookup_batching_max_keys, bool use_host_embedding_cache)
     : model_name(model_name),
       max_batchsize(max_batchsize),
       hit_rate_threshold(hit_rate_threshold),
@@ -235,7 +256,13 @@ InferenceParams::InferenceParams(
       use_hctr_cache_implementation(use_hctr_cache_implementation),
       init_ec(init_ec),
       enable_pagelock(enable_pagelock),
-      fp8_quant(fp8_quant) {
+      fp8_quant(fp8_quant),
+      max_number_of_worker_buffers_in_pool(max_number_of_worker_buffers_in_pool),
+      memory_pool_wait_timeout_ms(memory_pool_wait_timeout_ms),
+      enable_lookup_batching(enable_lookup_batching),
+      lookup_batching_delay_us(lookup_batching_delay_us),
+      lookup_batching_max_keys(lookup_batching_max_keys),
+      use_host_embedding_cache(use_host_embedding_cache) {
   // this code path is only used by hps python interface!
   if (this->default_value_for_each_table.size() != this->sparse_model_files.size()) {
     HCTR_LOG(
@@ -450,6 +477,17 @@ void parameter_server_config::init(const std::string& hps_json_config_file) {
 
     params.allocation_rate =
         get_value_from_json_soft(volatile_db, "allocation_rate", params.allocation_rate);
+    params.numa_aware = get_value_from_json_soft(volatile_db, "numa_aware", params.numa_aware);
+    params.hot_key_capacity =
+        get_value_from_json_soft(volatile_db, "hot_key_capacity", params.hot_key_capacity);
+    params.hot_key_refresh_interval = get_value_from_json_soft(
+        volatile_db, "hot_key_refresh_interval", params.hot_key_refresh_interval);
+    params.compaction_interval_ms = get_value_from_json_soft(
+        volatile_db, "compaction_interval_ms", params.compaction_interval_ms);
+    params.compaction_time_budget_us = get_value_from_json_soft(
+        volatile_db, "compaction_time_budget_us", params.compaction_time_budget_us);
+    params.compaction_slack =
+        get_value_from_json_soft(volatile_db, "compaction_slack", params.compaction_slack);
 
     params.shared_memory_size =
         get_value_from_json_soft(volatile_db, "shared_memory_size", params.shared_memory_size);
@@ -488,6 +526,10 @@ void parameter_server_config::init(const std::string& hps_json_config_file) {
 
     params.cache_missed_embeddings = get_value_from_json_soft(
         volatile_db, "cache_missed_embeddings", params.cache_missed_embeddings);
+    params.elevation_admission_threshold = get_value_from_json_soft(
+        volatile_db, "elevation_admission_threshold", params.elevation_admission_threshold);
+    params.elevation_admission_window = get_value_from_json_soft(
+        volatile_db, "elevation_admission_window", params.elevation_admission_window);
 
     // Real-time update mechanism related.
     if (volatile_db.find("update_filters") != volatile_db.end()) {
@@ -672,6 +714,24 @@ void parameter_server_config::init(const std::string& hps_json_config_file) {
     params.enable_pagelock = get_value_from_json_soft<bool>(model, "enable_pagelock", false);
     // [27] fp8_quant -> bool
     params.fp8_quant = get_value_from_json_soft<bool>(model, "fp8_quant", false);
+    // [28] max_num_of_worker_buffer_in_pool -> int
+    params.max_number_of_worker_buffers_in_pool =
+        get_value_from_json_soft<int>(model, "max_num_of_worker_buffer_in_pool", 0);
+    // [29] memory_pool_wait_timeout_ms -> int
+    params.memory_pool_wait_timeout_ms =
+        get_value_from_json_soft<int>(model, "memory_pool_wait_timeout_ms", 1000);
+    // [30] enable_lookup_batching -> bool
+    params.enable_lookup_batching =
+        get_value_from_json_soft<bool>(model, "enable_lookup_batching", false);
+    // [31] lookup_batching_delay_us -> int
+    params.lookup_batching_delay_us =
+        get_value_from_json_soft<int>(model, "lookup_batching_delay_us", 100);
+    // [32] lookup_batching_max_keys -> int
+    params.lookup_batching_max_keys =
+        get_value_from_json_soft<int>(model, "lookup_batching_max_keys", 0);
+    // [33] use_host_embedding_cache -> bool
+    params.use_host_embedding_cache =
+        get_value_from_json_soft<bool>(model, "use_host_embedding_cache", false);
 
     params.volatile_db = volatile_db_params;
     params.persistent_db = persistent_db_params;
@@ -0,0 +1,171 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <core23/logger.hpp>
+#include <cstring>
+#include <hps/lookup_batcher.hpp>
+
+namespace HugeCTR {
+
+LookupBatcher::LookupBatcher(const std::vector<size_t>& max_batch_keys_per_table,
+                             const size_t key_size, const std::chrono::microseconds max_delay,
+                             LookupFunction lookup_fn)
+    : key_size_{key_size}, max_delay_{max_delay}, lookup_fn_{std::move(lookup_fn)} {
+  HCTR_CHECK_HINT(key_size_ > 0, "Key size must be positive.");
+  HCTR_CHECK_HINT(max_delay_.count() >= 0, "Batching delay must not be negative.");
+  HCTR_CHECK_HINT(lookup_fn_, "Lookup function is missing.");
+
+  tables_.reserve(max_batch_keys_per_table.size());
+  for (const size_t max_batch_keys : max_batch_keys_per_table) {
+    HCTR_CHECK_HINT(max_batch_keys > 0, "Batch key limit must be positive.");
+    tables_.emplace_back(std::make_unique<Table>());
+    tables_.back()->max_batch_keys = max_batch_keys;
+  }
+  for (size_t table_id{0}; table_id < tables_.size(); ++table_id) {
+    tables_[table_id]->dispatcher = std::thread(&LookupBatcher::dispatch_, this, table_id);
+  }
+}
+
+LookupBatcher::~LookupBatcher() {
+  for (const auto& table : tables_) {
+    {
+      const std::lock_guard lock(table->mutex);
+      table->stop = true;
+    }
+    table->cv.notify_all();
+  }
+  for (const auto& table : tables_) {
+    table->dispatcher.join();
+  }
+}
+
+std::future<void> LookupBatcher::submit(const size_t table_id, const void* const keys,
+                                        const size_t num_keys, float* const vectors) {
+  HCTR_CHECK_HINT(table_id < tables_.size(), "Table ", table_id, " does not exist.");
+  Table& table{*tables_[table_id]};
+
+  std::promise<void> promise;
+  std::future<void> future{promise.get_future()};
+  if (num_keys == 0) {
+    promise.set_value();
+    return future;
+  }
+
+  bool notify;
+  {
+    const std::lock_guard lock(table.mutex);
+    if (table.stop) {
+      HCTR_OWN_THROW(Error_t::IllegalCall, "Lookup batcher is shutting down.");
+    }
+    table.pending.push_back(
+        {keys, num_keys, vectors, std::chrono::steady_clock::now(), std::move(promise)});
+    table.num_pending_keys += num_keys;
+
+    // The dispatcher only needs to wake up if it has nothing to do yet, or if it can cut the batch
+    // short. Otherwise, it is either busy or already waiting for the oldest request's deadline.
+    notify = table.pending.size() == 1 || table.num_pending_keys >= table.max_batch_keys;
+  }
+  if (notify) {
+    table.cv.notify_one();
+  }
+  return future;
+}
+
+LookupBatcherStats LookupBatcher::get_stats() const {
+  LookupBatcherStats stats;
+  stats.num_batches = num_batches_.load(std::memory_order_relaxed);
+  stats.num_requests = num_requests_.load(std::memory_order_relaxed);
+  stats.num_keys = num_keys_.load(std::memory_order_relaxed);
+  return stats;
+}
+
+void LookupBatcher::dispatch_(const size_t table_id) {
+  Table& table{*tables_[table_id]};
+  std::vector<Request> batch;
+  std::vector<char> key_buffer;
+  std::vector<Slice> slices;
+
+  std::unique_lock lock(table.mutex);
+  while (true) {
+    table.cv.wait(lock, [&table]() { return table.stop || !table.pending.empty(); });
+    if (table.pending.empty()) {
+      break;
+    }
+
+    // Give other requests a chance to join the batch. When shutting down, pending requests are
+    // completed without further delay.
+    const auto deadline{table.pending.front().arrival + max_delay_};
+    table.cv.wait_until(lock, deadline, [&table]() {
+      return table.stop || table.num_pending_keys >= table.max_batch_keys;
+    });
+
+    size_t num_keys{0};
+    do {
+      num_keys += table.pending.front().num_keys;
+      batch.emplace_back(std::move(table.pending.front()));
+      table.pending.pop_front();
+    } while (!table.pending.empty() &&
+             num_keys + table.pending.front().num_keys <= table.max_batch_keys);
+    table.num_pending_keys -= num_keys;
+
+    lock.unlock();
+    execute_(table_id, batch, key_buffer, slices);
+    batch.clear();
+    lock.lock();
+  }
+}
+
+void LookupBatcher::execute_(const size_t table_id, std::vector<Request>& batch,
+                             std::vector<char>& key_buffer, std::vector<Slice>& slices) {
+  slices.clear();
+  size_t num_keys{0};
+  for (const Request& request : batch) {
+    slices.push_back({request.vectors, request.num_keys});
+    num_keys += request.num_keys;
+  }
+
+  std::exception_ptr error;
+  try {
+    if (batch.size() == 1) {
+      lookup_fn_(table_id, batch.front().keys, num_keys, slices);
+    } else {
+      key_buffer.resize(num_keys * key_size_);
+      char* dst{key_buffer.data()};
+      for (const Request& request : batch) {
+        std::memcpy(dst, request.keys, request.num_keys * key_size_);
+        dst += request.num_keys * key_size_;
+      }
+      lookup_fn_(table_id, key_buffer.data(), num_keys, slices);
+    }
+  } catch (...) {
+    error = std::current_exception();
+  }
+
+  // Account for the batch before the callers are released.
+  num_batches_.fetch_add(1, std::memory_order_relaxed);
+  num_requests_.fetch_add(batch.size(), std::memory_order_relaxed);
+  num_keys_.fetch_add(num_keys, std::memory_order_relaxed);
+
+  for (Request& request : batch) {
+    if (error) {
+      request.promise.set_exception(error);
+    } else {
+      request.promise.set_value();
+    }
+  }
+}
+
+}  // namespace HugeCTR
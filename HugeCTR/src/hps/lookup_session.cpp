@@ -14,6 +14,8 @@
  * limitations under the License.
  */
 
+#include <algorithm>
+#include <core23/tracer.hpp>
 #include <hps/lookup_session.hpp>
 #include <utils.hpp>
 
@@ -98,6 +100,42 @@ LookupSession::LookupSession(const InferenceParams& inference_params,
       }
     }
 
+    if (inference_params_.enable_lookup_batching) {
+      if (inference_params_.fuse_embedding_table) {
+        HCTR_LOG_S(WARNING, WORLD) << "Lookup batching cannot be combined with table fusion and "
+                                      "will be disabled for model "
+                                   << inference_params_.model_name << "." << std::endl;
+      } else {
+        std::vector<size_t> max_batch_keys_per_table;
+        for (size_t table_id{0}; table_id < num_tables; ++table_id) {
+          size_t max_batch_keys =
+              inference_params_.max_batchsize *
+              inference_params_.maxnum_catfeature_query_per_table_per_sample[table_id];
+          if (inference_params_.lookup_batching_max_keys > 0) {
+            max_batch_keys = std::min(
+                max_batch_keys, static_cast<size_t>(inference_params_.lookup_batching_max_keys));
+          }
+          float* current_vec_buffer;
+          HCTR_LIB_THROW(cudaMalloc(
+              reinterpret_cast<void**>(&current_vec_buffer),
+              max_batch_keys * inference_params_.embedding_vecsize_per_table[table_id] *
+                  sizeof(float)));
+          vec_buffer_for_each_batched_table_.push_back(current_vec_buffer);
+          max_batch_keys_per_table.push_back(max_batch_keys);
+        }
+        lookup_batcher_ = std::make_unique<LookupBatcher>(
+            max_batch_keys_per_table,
+            inference_params_.i64_input_key ? sizeof(long long) : sizeof(unsigned int),
+            std::chrono::microseconds(inference_params_.lookup_batching_delay_us),
+            [this](const size_t table_id, const void* const h_keys, const size_t num_keys,
+                   const std::vector<LookupBatcher::Slice>& slices) {
+              this->lookup_batch_(table_id, h_keys, num_keys, slices);
+            });
+        HCTR_LOG(INFO, ROOT, "Lookup batching enabled for %s (max. delay: %d us).\n",
+                 inference_params_.model_name.c_str(), inference_params_.lookup_batching_delay_us);
+      }
+    }
+
   } catch (const std::runtime_error& rt_err) {
     HCTR_LOG_S(ERROR, WORLD) << rt_err.what() << std::endl;
     throw;
@@ -108,6 +146,11 @@ LookupSession::LookupSession(const InferenceParams& inference_params,
 LookupSession::~LookupSession() {
   CudaDeviceContext dev_restorer;
   dev_restorer.set_device(inference_params_.device_id);
+  // Drain pending batches before the streams go away.
+  lookup_batcher_.reset();
+  for (float* vec_buffer : vec_buffer_for_each_batched_table_) {
+    HCTR_LIB_CHECK_(cudaFree(vec_buffer));
+  }
   for (auto stream : lookup_streams_) HCTR_LIB_CHECK_(cudaStreamDestroy(stream));
   if (inference_params_.fuse_embedding_table) {
     size_t num_tables = inference_params_.fused_sparse_model_files.size();
@@ -123,6 +166,7 @@ LookupSession::~LookupSession() {
 void LookupSession::lookup_with_table_fusion_impl(const void* keys, float* d_vectors,
                                                   size_t num_keys, size_t table_id, bool key_on_gpu,
                                                   cudaStream_t stream) {
+  HCTR_TRACE_SCOPE("LookupSession::lookup_with_table_fusion");
   size_t fused_table_id = inference_params_.original_table_id_to_fused_table_id_map[table_id];
   auto original_table_id_list =
       inference_params_.fused_table_id_to_original_table_id_map[fused_table_id];
@@ -238,6 +282,7 @@ void LookupSession::lookup_with_table_fusion_impl(const void* keys, float* d_vec
 
 void LookupSession::lookup_from_device_impl(const void* d_keys, float* d_vectors, size_t num_keys,
                                             size_t table_id, cudaStream_t stream) {
+  HCTR_TRACE_SCOPE("LookupSession::lookup_from_device");
   CudaDeviceContext dev_restorer;
   dev_restorer.set_device(inference_params_.device_id);
   embedding_cache_->lookup_from_device(table_id, d_vectors, d_keys, num_keys,
@@ -246,12 +291,42 @@ void LookupSession::lookup_from_device_impl(const void* d_keys, float* d_vectors
 
 void LookupSession::lookup_impl(const void* const h_keys, float* const d_vectors,
                                 const size_t num_keys, const size_t table_id, cudaStream_t stream) {
+  HCTR_TRACE_SCOPE("LookupSession::lookup");
   CudaDeviceContext dev_restorer;
   dev_restorer.set_device(inference_params_.device_id);
   embedding_cache_->lookup(table_id, d_vectors, h_keys, num_keys,
                            inference_params_.hit_rate_threshold, stream);
 }
 
+void LookupSession::lookup_batch_(const size_t table_id, const void* const h_keys,
+                                  const size_t num_keys,
+                                  const std::vector<LookupBatcher::Slice>& slices) {
+  HCTR_TRACE_SCOPE("LookupSession::lookup_batch");
+  const cudaStream_t stream = lookup_streams_[table_id];
+  if (slices.size() == 1) {
+    this->lookup_impl(h_keys, slices.front().vectors, num_keys, table_id, stream);
+  } else {
+    float* const vec_buffer = vec_buffer_for_each_batched_table_[table_id];
+    this->lookup_impl(h_keys, vec_buffer, num_keys, table_id, stream);
+
+    CudaDeviceContext dev_restorer;
+    dev_restorer.set_device(inference_params_.device_id);
+    const size_t emb_vec_size = inference_params_.embedding_vecsize_per_table[table_id];
+    size_t offset = 0;
+    for (const LookupBatcher::Slice& slice : slices) {
+      HCTR_LIB_THROW(cudaMemcpyAsync(slice.vectors, &vec_buffer[offset * emb_vec_size],
+                                     slice.num_keys * emb_vec_size * sizeof(float),
+                                     cudaMemcpyDeviceToDevice, stream));
+      offset += slice.num_keys;
+    }
+  }
+  HCTR_LIB_THROW(cudaStreamSynchronize(stream));
+}
+
+LookupBatcherStats LookupSession::get_batching_stats() const {
+  return lookup_batcher_ ? lookup_batcher_->get_stats() : LookupBatcherStats{};
+}
+
 void LookupSession::lookup(const void* const h_keys, float* const d_vectors, const size_t num_keys,
                            const size_t table_id, cudaStream_t stream) {
   if (inference_params_.fuse_embedding_table) {
@@ -271,6 +346,9 @@ void LookupSession::lookup(const void* const h_keys, float* const d_vectors, con
     this->lookup_with_table_fusion_impl(h_keys, d_vectors, num_keys, table_id, false,
                                         lookup_streams_[fused_table_id]);
     HCTR_LIB_THROW(cudaStreamSynchronize(lookup_streams_[fused_table_id]));
+  } else if (lookup_batcher_) {
+    // Merged with concurrent requests for the same table. Returns once the outputs are ready.
+    lookup_batcher_->lookup(table_id, h_keys, num_keys, d_vectors);
   } else {
     this->lookup_impl(h_keys, d_vectors, num_keys, table_id, lookup_streams_[table_id]);
     HCTR_LIB_THROW(cudaStreamSynchronize(lookup_streams_[table_id]));
@@ -0,0 +1,174 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <core23/logger.hpp>
+#include <cstdlib>
+#include <hps/plugin/lookup_executor.hpp>
+
+namespace HierarchicalParameterServer {
+
+using namespace HugeCTR;
+
+LookupExecutorParams LookupExecutorParams::from_env() {
+  LookupExecutorParams params;
+  const auto read = [](const char* const name, size_t& value) {
+    if (const char* const text{getenv(name)}) {
+      value = static_cast<size_t>(std::max(atoll(text), 0LL));
+    }
+  };
+  read("HPS_LOOKUP_WORKERS", params.num_workers);
+  read("HPS_LOOKUP_MAX_INFLIGHT_PER_DEVICE", params.max_inflight_per_device);
+  read("HPS_LOOKUP_MAX_INFLIGHT_PER_TABLE", params.max_inflight_per_table);
+  read("HPS_LOOKUP_MAX_COALESCED_TASKS", params.max_coalesced_tasks);
+  return params;
+}
+
+LookupExecutor::LookupExecutor(const LookupExecutorParams& params)
+    : params_{params},
+      num_workers_{params.num_workers ? params.num_workers
+                                      : std::max(std::thread::hardware_concurrency(), 1U)} {
+  HCTR_LOG_S(INFO, WORLD) << "Creating HPS lookup executor with " << num_workers_
+                          << " worker(s); max. in-flight per device: "
+                          << params_.max_inflight_per_device
+                          << ", per table: " << params_.max_inflight_per_table
+                          << ", max. coalesced tasks: " << params_.max_coalesced_tasks << std::endl;
+
+  workers_.reserve(num_workers_);
+  for (size_t i{0}; i < num_workers_; ++i) {
+    workers_.emplace_back(&LookupExecutor::run_, this);
+  }
+}
+
+LookupExecutor::~LookupExecutor() {
+  {
+    const std::lock_guard lock(mutex_);
+    stop_ = true;
+  }
+  cv_.notify_all();
+  for (std::thread& worker : workers_) {
+    worker.join();
+  }
+}
+
+void LookupExecutor::submit(const std::string& model_name, const int table_id, const int device_id,
+                            Task task) {
+  {
+    const std::lock_guard lock(mutex_);
+    if (stop_) {
+      HCTR_OWN_THROW(Error_t::IllegalCall, "HPS lookup executor is shutting down.");
+    }
+
+    std::unique_ptr<Queue>& queue{queues_[{model_name, table_id, device_id}]};
+    if (!queue) {
+      queue = std::make_unique<Queue>();
+      queue->device_id = device_id;
+      queue_list_.push_back(queue.get());
+    }
+    queue->tasks.emplace_back(std::move(task));
+
+    ++stats_.num_tasks;
+    ++stats_.num_pending;
+    stats_.peak_pending = std::max(stats_.peak_pending, stats_.num_pending);
+  }
+  cv_.notify_one();
+}
+
+LookupExecutorStats LookupExecutor::get_stats() const {
+  const std::lock_guard lock(mutex_);
+  return stats_;
+}
+
+LookupExecutor& LookupExecutor::shared() {
+  static LookupExecutor executor(LookupExecutorParams::from_env());
+  return executor;
+}
+
+LookupExecutor::Queue* LookupExecutor::pick_() {
+  for (size_t i{0}; i < queue_list_.size(); ++i) {
+    const size_t index{(next_queue_ + i) % queue_list_.size()};
+    Queue* const queue{queue_list_[index]};
+    if (queue->tasks.empty()) {
+      continue;
+    }
+    if (params_.max_inflight_per_table && queue->num_inflight >= params_.max_inflight_per_table) {
+      continue;
+    }
+    if (params_.max_inflight_per_device &&
+        num_inflight_per_device_[queue->device_id] >= params_.max_inflight_per_device) {
+      continue;
+    }
+    next_queue_ = index + 1;
+    return queue;
+  }
+  return nullptr;
+}
+
+void LookupExecutor::run_() {
+  std::vector<Task> tasks;
+
+  std::unique_lock lock(mutex_);
+  while (true) {
+    Queue* queue{nullptr};
+    cv_.wait(lock, [&]() {
+      queue = pick_();
+      return queue || (stop_ && stats_.num_pending == 0);
+    });
+    if (!queue) {
+      break;
+    }
+
+    // Only coalesce if there is more work queued up than the workers could start right away.
+    size_t num_tasks{(queue->tasks.size() + num_workers_ - 1) / num_workers_};
+    num_tasks = std::clamp(num_tasks, size_t{1}, std::max(params_.max_coalesced_tasks, size_t{1}));
+    for (size_t i{0}; i < num_tasks; ++i) {
+      tasks.emplace_back(std::move(queue->tasks.front()));
+      queue->tasks.pop_front();
+    }
+
+    ++queue->num_inflight;
+    ++num_inflight_per_device_[queue->device_id];
+    ++num_inflight_;
+    ++stats_.num_dispatches;
+    stats_.num_pending -= num_tasks;
+    stats_.peak_inflight = std::max(stats_.peak_inflight, num_inflight_);
+
+    lock.unlock();
+    for (Task& task : tasks) {
+      try {
+        task();
+      } catch (const std::exception& error) {
+        HCTR_LOG_S(ERROR, WORLD) << "HPS lookup task failed: " << error.what() << std::endl;
+      }
+    }
+    tasks.clear();
+    lock.lock();
+
+    --queue->num_inflight;
+    --num_inflight_per_device_[queue->device_id];
+    --num_inflight_;
+
+    // Queued tasks might have been held back by the in-flight limits. When shutting down, idle
+    // workers also need to learn that there is nothing left to do.
+    if (stop_) {
+      cv_.notify_all();
+    } else if (stats_.num_pending) {
+      cv_.notify_one();
+    }
+  }
+}
+
+}  // namespace HierarchicalParameterServer
@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <core23/logger.hpp>
+#include <hps/unique_op/cpu_unique_op.hpp>
+#include <limits>
+
+namespace HugeCTR {
+namespace unique_op {
+
+namespace {
+
+inline void copy_row(float* __restrict__ const dst, const float* __restrict__ const src,
+                     const size_t n) {
+#ifdef _OPENMP
+#pragma omp simd
+#endif
+  for (size_t i = 0; i < n; ++i) {
+    dst[i] = src[i];
+  }
+}
+
+}  // namespace
+
+template <typename KeyType>
+void CpuUniqueOp<KeyType>::reserve_(const size_t num_keys) {
+  // Keep the load factor at or below 0.5, so that probe sequences stay short.
+  size_t capacity{16};
+  size_t shift{60};
+  while (capacity < 2 * num_keys) {
+    capacity <<= 1;
+    --shift;
+  }
+  if (capacity > slots_.size()) {
+    slots_.assign(capacity, Slot{0, 0, 0});
+    shift_ = shift;
+    epoch_ = 0;
+  }
+}
+
+template <typename KeyType>
+size_t CpuUniqueOp<KeyType>::unique(const KeyType* const keys, const size_t num_keys,
+                                    KeyType* const unique_keys) {
+  HCTR_CHECK_HINT(num_keys <= std::numeric_limits<uint32_t>::max(), "Batch too large (",
+                  num_keys, " keys).");
+  reserve_(num_keys);
+
+  // Invalidate all slots of the previous batch at once.
+  if (++epoch_ == 0) {
+    for (Slot& slot : slots_) {
+      slot.epoch = 0;
+    }
+    epoch_ = 1;
+  }
+
+  indices_.resize(num_keys);
+  const size_t mask{slots_.size() - 1};
+  uint32_t n{0};
+  for (size_t i{0}; i < num_keys; ++i) {
+    const KeyType key{keys[i]};
+    // Fibonacci hashing. The upper bits of the product are well mixed.
+    size_t j{static_cast<size_t>((static_cast<uint64_t>(key) * UINT64_C(0x9E3779B97F4A7C15)) >>
+                                 shift_)};
+    for (;; j = (j + 1) & mask) {
+      Slot& slot{slots_[j]};
+      if (slot.epoch != epoch_) {
+        slot = {key, epoch_, n};
+        // `n <= i`. Hence, `keys[i]` has already been read if the buffers alias.
+        unique_keys[n] = key;
+        indices_[i] = n++;
+        break;
+      }
+      if (slot.key == key) {
+        indices_[i] = slot.index;
+        break;
+      }
+    }
+  }
+  num_unique_ = n;
+  return num_unique_;
+}
+
+template <typename KeyType>
+void CpuUniqueOp<KeyType>::expand(float* const values, const size_t value_size) const {
+  if (num_unique_ == indices_.size()) {
+    return;
+  }
+
+  // Distinct keys are numbered in order of their first occurrence, so `indices_[i] <= i`. Going
+  // backwards, a row is therefore never overwritten before the last time it is read.
+  for (size_t i{indices_.size()}; i-- > 0;) {
+    const size_t src{indices_[i]};
+    if (src != i) {
+      copy_row(&values[i * value_size], &values[src * value_size], value_size);
+    }
+  }
+}
+
+template class CpuUniqueOp<unsigned int>;
+template class CpuUniqueOp<long long>;
+
+}  // namespace unique_op
+}  // namespace HugeCTR
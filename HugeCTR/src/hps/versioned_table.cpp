@@ -0,0 +1,249 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <core23/logger.hpp>
+#include <hps/versioned_table.hpp>
+#include <limits>
+
+namespace HugeCTR {
+
+template <typename Key>
+VersionedTable<Key>::VersionedTable(DatabaseBackendBase<Key>& db, const std::string& table_name,
+                                    DatabaseBackendBase<Key>* const write_through_db)
+    : db_{db}, table_name_{table_name}, write_through_db_{write_through_db} {
+  std::atomic_store(&current_, std::make_shared<const Version>(Version{0, ""}));
+}
+
+template <typename Key>
+VersionedTable<Key>::~VersionedTable() {
+  const std::lock_guard lock(writer_guard_);
+  // Published rows are kept. Staged rows are discarded.
+  try {
+    reclaim_();
+  } catch (const std::exception& error) {
+    HCTR_LOG_S(ERROR, WORLD) << "Table '" << table_name_ << "': Unable to merge published delta. "
+                             << error.what() << std::endl;
+  }
+  if (!staged_keys_.empty()) {
+    db_.evict(make_delta_table_name_(next_id_));
+  }
+}
+
+template <typename Key>
+std::shared_ptr<const typename VersionedTable<Key>::Version> VersionedTable<Key>::pin() const {
+  // The returned pointer keeps the version alive, and wakes up `await_drain_` once released.
+  std::shared_ptr<const Version> version{std::atomic_load(&current_)};
+  const Version* const ptr{version.get()};
+  return std::shared_ptr<const Version>(
+      ptr, [version = std::move(version), drain = drain_](const Version*) mutable {
+        version.reset();
+        const std::lock_guard lock(drain->mutex);
+        drain->released.notify_all();
+      });
+}
+
+template <typename Key>
+std::string VersionedTable<Key>::make_delta_table_name_(const uint64_t id) const {
+  // Embedding table names cannot contain '.'. Hence, this cannot collide with a regular table, but
+  // will still be found by `find_tables` for the model.
+  return table_name_ + ".v" + std::to_string(id);
+}
+
+template <typename Key>
+void VersionedTable<Key>::await_drain_(const std::shared_ptr<const Version>& version) const {
+  // Readers only hold on to a version for the duration of a lookup.
+  std::unique_lock lock(drain_->mutex);
+  drain_->released.wait(lock, [&version]() { return version.use_count() <= 1; });
+}
+
+template <typename Key>
+size_t VersionedTable<Key>::stage(const size_t num_pairs, const Key* const keys,
+                                  const char* const values, const uint32_t value_size,
+                                  const size_t value_stride) {
+  const std::lock_guard lock(writer_guard_);
+  HCTR_CHECK_HINT(value_size_ == 0 || value_size_ == value_size, "Table '", table_name_,
+                  "': Value size mismatch (", value_size, " <> ", value_size_, ").");
+  value_size_ = value_size;
+
+  // Only one delta may be published at a time.
+  reclaim_();
+
+  db_.insert(make_delta_table_name_(next_id_), num_pairs, keys, values, value_size, value_stride);
+  staged_keys_.insert(staged_keys_.end(), keys, &keys[num_pairs]);
+  return staged_keys_.size();
+}
+
+template <typename Key>
+size_t VersionedTable<Key>::num_staged() const {
+  const std::lock_guard lock(writer_guard_);
+  return staged_keys_.size();
+}
+
+template <typename Key>
+uint64_t VersionedTable<Key>::publish(std::vector<Key>* const published_keys) {
+  const std::lock_guard lock(writer_guard_);
+  if (staged_keys_.empty()) {
+    return std::atomic_load(&current_)->id;
+  }
+  HCTR_CHECK(!retired_);
+
+  // Readers would silently fall back to the previous version of lost rows.
+  std::sort(staged_keys_.begin(), staged_keys_.end());
+  staged_keys_.erase(std::unique(staged_keys_.begin(), staged_keys_.end()), staged_keys_.end());
+  const std::string& delta_table_name{make_delta_table_name_(next_id_)};
+  const size_t num_lost{staged_keys_.size() - db_.contains(delta_table_name, staged_keys_.size(),
+                                                           staged_keys_.data(),
+                                                           std::chrono::nanoseconds::zero())};
+  if (num_lost) {
+    db_.evict(delta_table_name);
+    const size_t num_staged{staged_keys_.size()};
+    staged_keys_.clear();
+    staged_keys_.shrink_to_fit();
+    HCTR_OWN_THROW(Error_t::DataCheckError,
+                   "Table '" + table_name_ + "': " + std::to_string(num_lost) + " of " +
+                       std::to_string(num_staged) +
+                       " staged rows were lost. Was the delta evicted by an overflow policy? The "
+                       "update has been discarded.");
+  }
+
+  const uint64_t id{next_id_++};
+  retired_ = std::atomic_load(&current_);
+  std::atomic_store(&current_,
+                    std::make_shared<const Version>(Version{id, make_delta_table_name_(id)}));
+
+  published_keys_.swap(staged_keys_);
+  staged_keys_.clear();
+  staged_keys_.shrink_to_fit();
+  if (published_keys) {
+    *published_keys = published_keys_;
+  }
+
+  HCTR_LOG_S(DEBUG, WORLD) << "Table '" << table_name_ << "': Published version " << id << " ("
+                           << published_keys_.size() << " changed rows)." << std::endl;
+  return id;
+}
+
+template <typename Key>
+size_t VersionedTable<Key>::reclaim() {
+  const std::lock_guard lock(writer_guard_);
+  return reclaim_();
+}
+
+template <typename Key>
+size_t VersionedTable<Key>::reclaim_() {
+  if (!retired_) {
+    return 0;
+  }
+
+  // Readers of the retired version may still fall through to the base table. Hence, it must not
+  // be modified before they are done.
+  await_drain_(retired_);
+
+  // `retired_` is only released once the delta is gone. So, if the backend throws, the next call
+  // starts over. Merging is idempotent.
+  std::shared_ptr<const Version> version{std::atomic_load(&current_)};
+  const uint64_t id{version->id};
+  const std::string delta_table_name{version->delta_table_name};
+  size_t num_merged{0};
+  if (!delta_table_name.empty()) {
+    num_merged = merge_(*version);
+
+    // New readers bypass the delta, because the base table is now identical.
+    std::atomic_store(&current_, std::make_shared<const Version>(Version{id, ""}));
+    await_drain_(version);
+    version.reset();
+    db_.evict(delta_table_name);
+  }
+  retired_.reset();
+
+  HCTR_LOG_S(DEBUG, WORLD) << "Table '" << table_name_ << "': Merged " << num_merged
+                           << " rows of version " << id << " into base table." << std::endl;
+  return num_merged;
+}
+
+template <typename Key>
+size_t VersionedTable<Key>::merge_(const Version& version) {
+  // `published_keys_` is sorted and unique (see `publish`).
+  constexpr size_t batch_size{64 * 1024};
+  std::vector<Key> keys;
+  std::vector<char> values(std::min(published_keys_.size(), batch_size) * value_size_);
+  std::vector<char> missed;
+  size_t num_merged{0};
+  for (size_t i{0}; i < published_keys_.size(); i += batch_size) {
+    const size_t n{std::min(published_keys_.size() - i, batch_size)};
+    keys.assign(&published_keys_[i], &published_keys_[i + n]);
+    missed.assign(n, 0);
+    const size_t hits{db_.fetch(version.delta_table_name, n, keys.data(), values.data(),
+                                value_size_, [&missed](const size_t index) { missed[index] = 1; })};
+
+    // Rows that were lost after publishing cannot be recovered. Drop them, so that the remaining
+    // ones still make it into the base table.
+    if (hits != n) {
+      HCTR_LOG_S(ERROR, WORLD) << "Table '" << table_name_ << "': Delta of version " << version.id
+                               << " lost " << n - hits
+                               << " rows. Was it evicted by an overflow policy?" << std::endl;
+      size_t k{0};
+      for (size_t j{0}; j < n; ++j) {
+        if (!missed[j]) {
+          keys[k] = keys[j];
+          std::copy_n(&values[j * value_size_], value_size_, &values[k * value_size_]);
+          ++k;
+        }
+      }
+      keys.resize(k);
+    }
+    db_.insert(table_name_, keys.size(), keys.data(), values.data(), value_size_, value_size_);
+    if (write_through_db_) {
+      write_through_db_->insert(table_name_, keys.size(), keys.data(), values.data(), value_size_,
+                                value_size_);
+    }
+    num_merged += keys.size();
+  }
+  published_keys_.clear();
+  published_keys_.shrink_to_fit();
+  return num_merged;
+}
+
+template <typename Key>
+size_t VersionedTable<Key>::fetch(const size_t num_keys, const Key* const keys, char* const values,
+                                  const size_t value_stride, const DatabaseMissCallback& on_miss,
+                                  const std::chrono::nanoseconds& time_budget) const {
+  const std::shared_ptr<const Version> version{pin()};
+  if (version->delta_table_name.empty()) {
+    return db_.fetch(table_name_, num_keys, keys, values, value_stride, on_miss, time_budget);
+  }
+
+  // Resolve changed rows from the delta, and everything else from the base table.
+  static constexpr size_t invalid_index{std::numeric_limits<size_t>::max()};
+  std::vector<size_t> indices(num_keys, invalid_index);
+  size_t hit_count{db_.fetch(
+      version->delta_table_name, num_keys, keys, values, value_stride,
+      [&indices](const size_t index) { indices[index] = index; }, time_budget)};
+
+  // Compress indices (the callback may be invoked concurrently).
+  indices.erase(std::remove(indices.begin(), indices.end(), invalid_index), indices.end());
+  if (!indices.empty()) {
+    hit_count += db_.fetch(table_name_, indices.size(), indices.data(), keys, values,
+                           value_stride, on_miss, time_budget);
+  }
+  return hit_count;
+}
+
+template class VersionedTable<unsigned int>;
+template class VersionedTable<long long>;
+
+}  // namespace HugeCTR
@@ -0,0 +1,712 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <common.hpp>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <inference/cpu_dense_network.hpp>
+#include <io/filesystem.hpp>
+#include <numeric>
+
+namespace HugeCTR {
+
+/**
+ * Activations of \p max_batch_size samples, each of shape `dims`. A view shares the data of
+ * another tensor.
+ */
+struct CpuTensor {
+  std::vector<int64_t> dims;
+  int64_t size{1};  // Values per sample.
+  std::vector<float> storage;
+  float* data{nullptr};
+};
+
+class CpuLayer {
+ public:
+  virtual ~CpuLayer() = default;
+
+  virtual void fprop(int64_t batch_size) = 0;
+};
+
+namespace {
+
+/**
+ * Hands out the weights of the dense model in layer order.
+ */
+class WeightReader {
+ public:
+  WeightReader(const std::vector<float>& weights) : weights_{weights} {}
+
+  const float* take(const int64_t size, const std::string& layer) {
+    HCTR_THROW_IF(offset_ + size > weights_.size(), Error_t::WrongInput,
+                  "The dense model ends within the weights of layer \"", layer, "\". It holds ",
+                  weights_.size(), " values.");
+    const float* const weights{&weights_[offset_]};
+    offset_ += size;
+    return weights;
+  }
+
+  inline size_t offset() const { return offset_; }
+
+ private:
+  const std::vector<float>& weights_;
+  size_t offset_{0};
+};
+
+std::vector<std::string> get_names(const nlohmann::json& config, const char* key) {
+  if (!config.contains(key)) {
+    return {};
+  }
+  const nlohmann::json& names{config[key]};
+  if (names.is_string()) {
+    return {names.get<std::string>()};
+  }
+  return names.get<std::vector<std::string>>();
+}
+
+float sigmoid(const float x) { return 1.f / (1.f + std::exp(-x)); }
+
+class InnerProductLayer final : public CpuLayer {
+ public:
+  InnerProductLayer(const CpuTensor* in, CpuTensor* out, const float* weights, const float* bias,
+                    const CpuDenseNetworkParams& params)
+      : in_{in},
+        out_{out},
+        weights_{weights, in->dims.back(), out->dims.back(), params.bf16_weights},
+        bias_(bias, bias + out->dims.back()),
+        params_{params} {}
+
+  void fuse_relu() { relu_ = true; }
+
+  void fprop(const int64_t batch_size) override {
+    const int64_t rows{batch_size * in_->size / weights_.rows()};
+    cpu_gemm(in_->data, rows, weights_, bias_.data(), relu_, out_->data, params_.num_threads,
+             params_.isa);
+  }
+
+ private:
+  const CpuTensor* in_;
+  CpuTensor* out_;
+  const CpuPackedMatrix weights_;
+  const std::vector<float> bias_;
+  const CpuDenseNetworkParams& params_;
+  bool relu_{false};
+};
+
+class MLPLayer final : public CpuLayer {
+ public:
+  struct Dense {
+    CpuPackedMatrix weights;
+    std::vector<float> bias;  // Empty if not used.
+    bool relu;
+    std::vector<float> out;  // Empty for the last layer.
+  };
+
+  MLPLayer(const CpuTensor* in, CpuTensor* out, std::vector<Dense>&& layers,
+           const CpuDenseNetworkParams& params)
+      : in_{in}, out_{out}, layers_{std::move(layers)}, params_{params} {}
+
+  void fprop(const int64_t batch_size) override {
+    const int64_t rows{batch_size * in_->size / layers_.front().weights.rows()};
+    const float* in{in_->data};
+    for (Dense& layer : layers_) {
+      float* const out{layer.out.empty() ? out_->data : layer.out.data()};
+      cpu_gemm(in, rows, layer.weights, layer.bias.empty() ? nullptr : layer.bias.data(),
+               layer.relu, out, params_.num_threads, params_.isa);
+      in = out;
+    }
+  }
+
+ private:
+  const CpuTensor* in_;
+  CpuTensor* out_;
+  std::vector<Dense> layers_;
+  const CpuDenseNetworkParams& params_;
+};
+
+/**
+ * DCN v1 computes `x_{l+1} = x_0 * (x_l . w_l) + b_l + x_l`, and DCN v2 computes
+ * `x_{l+1} = x_0 * (x_l U_l V_l + b_l) + x_l`.
+ */
+class MultiCrossLayer final : public CpuLayer {
+ public:
+  struct Cross {
+    std::vector<float> w;  // DCN v1
+    CpuPackedMatrix u, v;  // DCN v2
+    std::vector<float> bias;
+  };
+
+  MultiCrossLayer(const CpuTensor* in, CpuTensor* out, std::vector<Cross>&& layers,
+                  const int64_t projection_dim, const CpuDenseNetworkParams& params)
+      : in_{in}, out_{out}, layers_{std::move(layers)}, params_{params} {
+    if (projection_dim) {
+      xu_.resize(params.max_batch_size * projection_dim);
+      hidden_.resize(params.max_batch_size * in->size);
+    }
+  }
+
+  void fprop(const int64_t batch_size) override {
+    const int64_t width{in_->size};
+    const float* const x0{in_->data};
+    float* const y{out_->data};
+    for (size_t l{0}; l < layers_.size(); ++l) {
+      const Cross& layer{layers_[l]};
+      const float* const x{l ? y : x0};
+      if (layer.w.empty()) {
+        cpu_gemm(x, batch_size, layer.u, nullptr, false, xu_.data(), params_.num_threads,
+                 params_.isa);
+        cpu_gemm(xu_.data(), batch_size, layer.v, layer.bias.data(), false, hidden_.data(),
+                 params_.num_threads, params_.isa);
+        for (int64_t i{0}; i < batch_size * width; ++i) {
+          y[i] = x0[i] * hidden_[i] + x[i];
+        }
+      } else {
+        for (int64_t s{0}; s < batch_size; ++s) {
+          const float* const x_s{&x[s * width]};
+          float dot{0};
+#pragma omp simd reduction(+ : dot)
+          for (int64_t i = 0; i < width; ++i) {
+            dot += x_s[i] * layer.w[i];
+          }
+          for (int64_t i{0}; i < width; ++i) {
+            y[s * width + i] = x0[s * width + i] * dot + layer.bias[i] + x_s[i];
+          }
+        }
+      }
+    }
+  }
+
+ private:
+  const CpuTensor* in_;
+  CpuTensor* out_;
+  std::vector<Cross> layers_;
+  const CpuDenseNetworkParams& params_;
+  std::vector<float> xu_;
+  std::vector<float> hidden_;
+};
+
+/**
+ * Dot interaction of DLRM. The output of each sample is the bottom MLP output, followed by the
+ * dot products of all pairs of rows in (bottom MLP output, embedding vectors), and a zero.
+ */
+class InteractionLayer final : public CpuLayer {
+ public:
+  InteractionLayer(const CpuTensor* mlp, const CpuTensor* emb, CpuTensor* out,
+                   const CpuDenseNetworkParams& params)
+      : mlp_{mlp}, emb_{emb}, out_{out}, params_{params} {}
+
+  void fprop(const int64_t batch_size) override {
+    const int64_t width{mlp_->size};
+    const int64_t num_rows{1 + emb_->size / width};
+    const bool parallel{params_.num_threads > 1};
+
+#pragma omp parallel for num_threads(params_.num_threads) schedule(static) if (parallel)
+    for (int64_t s = 0; s < batch_size; ++s) {
+      const float* const mlp{&mlp_->data[s * width]};
+      const float* const emb{&emb_->data[s * emb_->size]};
+      float* out{&out_->data[s * out_->size]};
+      out = std::copy_n(mlp, width, out);
+      for (int64_t col{1}; col < num_rows; ++col) {
+        const float* const x_col{&emb[(col - 1) * width]};
+        for (int64_t row{0}; row < col; ++row) {
+          const float* const x_row{row ? &emb[(row - 1) * width] : mlp};
+          float dot{0};
+#pragma omp simd reduction(+ : dot)
+          for (int64_t i = 0; i < width; ++i) {
+            dot += x_row[i] * x_col[i];
+          }
+          *out++ = dot;
+        }
+      }
+      *out = 0;
+    }
+  }
+
+ private:
+  const CpuTensor* mlp_;
+  const CpuTensor* emb_;
+  CpuTensor* out_;
+  const CpuDenseNetworkParams& params_;
+};
+
+class ElementwiseLayer final : public CpuLayer {
+ public:
+  using Function = std::function<void(const float* in, int64_t size, float* out)>;
+
+  ElementwiseLayer(const CpuTensor* in, CpuTensor* out, Function function)
+      : in_{in}, out_{out}, function_{std::move(function)} {}
+
+  void fprop(const int64_t batch_size) override {
+    function_(in_->data, batch_size * in_->size, out_->data);
+  }
+
+ private:
+  const CpuTensor* in_;
+  CpuTensor* out_;
+  const Function function_;
+};
+
+/**
+ * Add and ElementwiseMultiply.
+ */
+class BinaryOpLayer final : public CpuLayer {
+ public:
+  BinaryOpLayer(std::vector<const CpuTensor*>&& ins, CpuTensor* out, const bool multiply)
+      : ins_{std::move(ins)}, out_{out}, multiply_{multiply} {}
+
+  void fprop(const int64_t batch_size) override {
+    const int64_t size{batch_size * out_->size};
+    float* const out{out_->data};
+    std::copy_n(ins_.front()->data, size, out);
+    for (size_t j{1}; j < ins_.size(); ++j) {
+      const float* const in{ins_[j]->data};
+      if (multiply_) {
+        for (int64_t i{0}; i < size; ++i) {
+          out[i] *= in[i];
+        }
+      } else {
+        for (int64_t i{0}; i < size; ++i) {
+          out[i] += in[i];
+        }
+      }
+    }
+  }
+
+ private:
+  const std::vector<const CpuTensor*> ins_;
+  CpuTensor* out_;
+  const bool multiply_;
+};
+
+/**
+ * Copies contiguous blocks of the inputs to the output. Each sample consists of `num_blocks`
+ * blocks per input. Covers Concat, Slice and selecting slots in Reshape.
+ */
+class CopyLayer final : public CpuLayer {
+ public:
+  struct Block {
+    const CpuTensor* in;
+    int64_t in_offset;  // Per sample.
+    int64_t out_offset;
+    int64_t size;
+    CpuTensor* out;
+  };
+
+  CopyLayer(std::vector<Block>&& blocks) : blocks_{std::move(blocks)} {}
+
+  void fprop(const int64_t batch_size) override {
+    for (int64_t s{0}; s < batch_size; ++s) {
+      for (const Block& block : blocks_) {
+        std::copy_n(&block.in->data[s * block.in->size + block.in_offset], block.size,
+                    &block.out->data[s * block.out->size + block.out_offset]);
+      }
+    }
+  }
+
+ private:
+  const std::vector<Block> blocks_;
+};
+
+void relu(const float* const in, const int64_t size, float* const out) {
+  for (int64_t i{0}; i < size; ++i) {
+    out[i] = std::max(in[i], 0.f);
+  }
+}
+
+void sigmoid_all(const float* const in, const int64_t size, float* const out) {
+  for (int64_t i{0}; i < size; ++i) {
+    out[i] = sigmoid(in[i]);
+  }
+}
+
+std::vector<float> read_dense_model(const std::string& path) {
+  auto fs{FileSystemBuilder::build_unique_by_path(path)};
+  const size_t size{fs->get_file_size(path)};
+  HCTR_THROW_IF(size % sizeof(float) != 0, Error_t::BrokenFile, "The size of dense model \"", path,
+                "\" is not a multiple of ", sizeof(float), " bytes.");
+  std::vector<float> weights(size / sizeof(float));
+  fs->read(path, weights.data(), size, 0);
+  return weights;
+}
+
+nlohmann::json read_graph_config(const std::string& path) {
+  std::ifstream file(path);
+  HCTR_THROW_IF(!file.is_open(), Error_t::FileCannotOpen, "Unable to open \"", path, "\".");
+  nlohmann::json config;
+  file >> config;
+  return config;
+}
+
+}  // namespace
+
+CpuDenseNetwork::CpuDenseNetwork(const std::string& graph_config_file,
+                                 const std::string& dense_model_file,
+                                 const CpuDenseNetworkParams& params)
+    : params_{params} {
+  build_(read_graph_config(graph_config_file), read_dense_model(dense_model_file));
+  HCTR_LOG_S(INFO, WORLD) << "Loaded CPU dense network from \"" << graph_config_file << "\" and \""
+                          << dense_model_file << "\" (" << cpu_isa_name(params_.isa)
+                          << (params_.bf16_weights ? ", bf16 weights" : "") << ")." << std::endl;
+}
+
+CpuDenseNetwork::CpuDenseNetwork(const nlohmann::json& graph_config,
+                                 const std::vector<float>& dense_model,
+                                 const CpuDenseNetworkParams& params)
+    : params_{params} {
+  build_(graph_config, dense_model);
+}
+
+CpuDenseNetwork::~CpuDenseNetwork() = default;
+
+CpuTensor* CpuDenseNetwork::add_tensor_(const std::string& name, const std::vector<int64_t>& dims,
+                                        const CpuTensor* const alias) {
+  HCTR_THROW_IF(tensor_map_.find(name) != tensor_map_.end(), Error_t::WrongInput, "Tensor \"",
+                name, "\" is defined twice.");
+  CpuTensor* const tensor{tensors_.emplace_back(std::make_unique<CpuTensor>()).get()};
+  tensor->dims = dims;
+  tensor->size = std::accumulate(dims.begin(), dims.end(), 1L, std::multiplies<int64_t>());
+  HCTR_THROW_IF(tensor->size <= 0, Error_t::WrongInput, "Tensor \"", name, "\" is empty.");
+  if (alias) {
+    HCTR_THROW_IF(alias->size != tensor->size, Error_t::WrongInput, "Tensor \"", name,
+                  "\" has a different size than the tensor it is a view of.");
+    tensor->data = alias->data;
+  } else {
+    tensor->storage.resize(params_.max_batch_size * tensor->size);
+    tensor->data = tensor->storage.data();
+  }
+  tensor_map_.emplace(name, tensor);
+  return tensor;
+}
+
+CpuTensor* CpuDenseNetwork::get_tensor_(const std::string& name) const {
+  const auto it{tensor_map_.find(name)};
+  HCTR_THROW_IF(it == tensor_map_.end(), Error_t::WrongInput, "Tensor \"", name,
+                "\" is not produced by any preceding layer.");
+  return it->second;
+}
+
+void CpuDenseNetwork::build_(const nlohmann::json& graph_config,
+                             const std::vector<float>& dense_model) {
+  HCTR_THROW_IF(params_.max_batch_size == 0, Error_t::WrongInput,
+                "max_batch_size must be positive.");
+  HCTR_THROW_IF(params_.isa > cpu_isa(), Error_t::WrongInput, cpu_isa_name(params_.isa),
+                " is not supported by this CPU.");
+
+  const nlohmann::json& layers{graph_config.at("layers")};
+  std::unordered_map<std::string, size_t> num_consumers;
+  for (const nlohmann::json& layer : layers) {
+    for (const std::string& bottom : get_names(layer, "bottom")) {
+      ++num_consumers[bottom];
+    }
+  }
+
+  WeightReader weights{dense_model};
+  std::unordered_map<std::string, int64_t> slot_nums;
+  std::unordered_map<const CpuTensor*, InnerProductLayer*> inner_products;
+
+  for (const nlohmann::json& layer : layers) {
+    const auto type{layer.at("type").get<std::string>()};
+    const std::vector<std::string> bottoms{get_names(layer, "bottom")};
+    const std::vector<std::string> tops{get_names(layer, "top")};
+    const auto name{layer.value("name", tops.empty() ? type : tops.front())};
+    const auto check_arity = [&](const size_t num_bottoms, const size_t num_tops) {
+      HCTR_THROW_IF(bottoms.size() != num_bottoms || tops.size() != num_tops, Error_t::WrongInput,
+                    "Layer \"", name, "\" must have ", num_bottoms, " bottom(s) and ", num_tops,
+                    " top(s).");
+    };
+
+    if (type == "Data") {
+      const nlohmann::json& dense{layer.at("dense")};
+      dense_dim_ = dense.at("dense_dim").get<size_t>();
+      if (dense_dim_) {
+        dense_ = add_tensor_(dense.at("top").get<std::string>(),
+                             {static_cast<int64_t>(dense_dim_)});
+      }
+      for (const nlohmann::json& sparse : layer.at("sparse")) {
+        slot_nums[sparse.at("top").get<std::string>()] = sparse.at("slot_num").get<int64_t>();
+      }
+      continue;
+    }
+
+    if (type == "DistributedSlotSparseEmbeddingHash" ||
+        type == "LocalizedSlotSparseEmbeddingHash") {
+      check_arity(1, 1);
+      const auto it{slot_nums.find(bottoms[0])};
+      HCTR_THROW_IF(it == slot_nums.end(), Error_t::WrongInput, "Embedding \"", name,
+                    "\" does not read a sparse input.");
+      const int64_t ev_size{
+          layer.at("sparse_embedding_hparam").at("embedding_vec_size").get<int64_t>()};
+      embeddings_.push_back(add_tensor_(tops[0], {it->second, ev_size}));
+      embedding_names_.push_back(tops[0]);
+      embedding_dims_.push_back(embeddings_.back()->size);
+      continue;
+    }
+
+    if (type == "InnerProduct") {
+      check_arity(1, 1);
+      const CpuTensor* const in{get_tensor_(bottoms[0])};
+      std::vector<int64_t> dims{in->dims};
+      dims.back() = layer.at("fc_param").at("num_output").get<int64_t>();
+      CpuTensor* const out{add_tensor_(tops[0], dims)};
+      const float* const kernel{weights.take(in->dims.back() * dims.back(), name)};
+      const float* const bias{weights.take(dims.back(), name)};
+      auto fc{std::make_unique<InnerProductLayer>(in, out, kernel, bias, params_)};
+      inner_products.emplace(out, fc.get());
+      layers_.emplace_back(std::move(fc));
+    } else if (type == "MLP") {
+      check_arity(1, 1);
+      const nlohmann::json& mlp{layer.at("mlp_param")};
+      const CpuTensor* const in{get_tensor_(bottoms[0])};
+      const auto num_outputs{mlp.contains("num_outputs")
+                                 ? mlp["num_outputs"].get<std::vector<int64_t>>()
+                                 : std::vector<int64_t>{mlp.at("num_output").get<int64_t>()}};
+      const size_t n{num_outputs.size()};
+      const auto biases{mlp.value("biases", std::vector<bool>(n, mlp.value("use_bias", true)))};
+      const auto act{mlp.value("activation", std::string{"Relu"})};
+      const auto acts{mlp.value("activations", std::vector<std::string>(n, act))};
+      HCTR_THROW_IF(biases.size() != n || acts.size() != n, Error_t::WrongInput, "Layer \"", name,
+                    "\" must have one bias flag and activation per layer.");
+
+      std::vector<int64_t> dims{in->dims};
+      dims.back() = num_outputs.back();
+      CpuTensor* const out{add_tensor_(tops[0], dims)};
+      const int64_t rows_per_sample{in->size / in->dims.back()};
+
+      std::vector<MLPLayer::Dense> dense_layers;
+      int64_t in_dim{in->dims.back()};
+      for (size_t i{0}; i < n; ++i) {
+        HCTR_THROW_IF(acts[i] != "Relu" && acts[i] != "None", Error_t::WrongInput,
+                      "Unsupported activation \"", acts[i], "\" in layer \"", name, "\".");
+        const float* const kernel{weights.take(in_dim * num_outputs[i], name)};
+        const float* const bias{weights.take(num_outputs[i], name)};
+        MLPLayer::Dense& dense{dense_layers.emplace_back()};
+        dense.weights = CpuPackedMatrix(kernel, in_dim, num_outputs[i], params_.bf16_weights);
+        if (biases[i]) {
+          dense.bias.assign(bias, bias + num_outputs[i]);
+        }
+        dense.relu = acts[i] == "Relu";
+        if (i + 1 < n) {
+          dense.out.resize(params_.max_batch_size * rows_per_sample * num_outputs[i]);
+        }
+        in_dim = num_outputs[i];
+      }
+      layers_.emplace_back(std::make_unique<MLPLayer>(in, out, std::move(dense_layers), params_));
+    } else if (type == "MultiCross") {
+      check_arity(1, 1);
+      const nlohmann::json& mc{layer.at("mc_param")};
+      const CpuTensor* const in{get_tensor_(bottoms[0])};
+      HCTR_THROW_IF(in->dims.size() != 1, Error_t::WrongInput, "Layer \"", name,
+                    "\" expects a 2D input.");
+      const int64_t width{in->size};
+      const int64_t projection_dim{mc.value("projection_dim", 0L)};
+      const int num_layers{mc.at("num_layers").get<int>()};
+      HCTR_THROW_IF(num_layers < 1, Error_t::WrongInput, "num_layers < 1");
+      CpuTensor* const out{add_tensor_(tops[0], in->dims)};
+
+      std::vector<MultiCrossLayer::Cross> cross_layers(num_layers);
+      for (MultiCrossLayer::Cross& cross : cross_layers) {
+        if (projection_dim) {
+          const float* const u{weights.take(width * projection_dim, name)};
+          const float* const v{weights.take(projection_dim * width, name)};
+          cross.u = CpuPackedMatrix(u, width, projection_dim, params_.bf16_weights);
+          cross.v = CpuPackedMatrix(v, projection_dim, width, params_.bf16_weights);
+        } else {
+          const float* const w{weights.take(width, name)};
+          cross.w.assign(w, w + width);
+        }
+        const float* const bias{weights.take(width, name)};
+        cross.bias.assign(bias, bias + width);
+      }
+      layers_.emplace_back(std::make_unique<MultiCrossLayer>(in, out, std::move(cross_layers),
+                                                             projection_dim, params_));
+    } else if (type == "Interaction") {
+      HCTR_THROW_IF(bottoms.size() != 2 || tops.empty(), Error_t::WrongInput, "Layer \"", name,
+                    "\" must have 2 bottoms.");
+      const CpuTensor* const mlp{get_tensor_(bottoms[0])};
+      const CpuTensor* const emb{get_tensor_(bottoms[1])};
+      HCTR_THROW_IF(mlp->dims.size() != 1 || emb->dims.size() != 2 ||
+                        emb->dims[1] != mlp->dims[0],
+                    Error_t::WrongInput, "Layer \"", name,
+                    "\" expects inputs of shape (batch, n) and (batch, slots, n).");
+      const int64_t num_rows{1 + emb->dims[0]};
+      CpuTensor* const out{
+          add_tensor_(tops[0], {mlp->dims[0] + num_rows * (num_rows - 1) / 2 + 1})};
+      // In mixed precision, the second top is a copy for the gradient of the bottom MLP.
+      for (size_t i{1}; i < tops.size(); ++i) {
+        add_tensor_(tops[i], mlp->dims, mlp);
+      }
+      layers_.emplace_back(std::make_unique<InteractionLayer>(mlp, emb, out, params_));
+    } else if (type == "ReLU") {
+      check_arity(1, 1);
+      CpuTensor* const in{get_tensor_(bottoms[0])};
+      const auto fc{inner_products.find(in)};
+      if (fc != inner_products.end() && num_consumers[bottoms[0]] == 1) {
+        fc->second->fuse_relu();
+        add_tensor_(tops[0], in->dims, in);
+      } else {
+        layers_.emplace_back(
+            std::make_unique<ElementwiseLayer>(in, add_tensor_(tops[0], in->dims), relu));
+      }
+    } else if (type == "Sigmoid" || type == "BinaryCrossEntropyLoss") {
+      HCTR_THROW_IF(bottoms.empty() || tops.size() != 1, Error_t::WrongInput, "Layer \"", name,
+                    "\" must have 1 top.");
+      const CpuTensor* const in{get_tensor_(bottoms[0])};
+      layers_.emplace_back(
+          std::make_unique<ElementwiseLayer>(in, add_tensor_(tops[0], in->dims), sigmoid_all));
+    } else if (type == "Dropout" || type == "Cast") {
+      check_arity(1, 1);
+      const CpuTensor* const in{get_tensor_(bottoms[0])};
+      add_tensor_(tops[0], in->dims, in);
+    } else if (type == "Add" || type == "ElementwiseMultiply") {
+      HCTR_THROW_IF(bottoms.size() < 2 || tops.size() != 1, Error_t::WrongInput, "Layer \"", name,
+                    "\" must have at least 2 bottoms and 1 top.");
+      std::vector<const CpuTensor*> ins;
+      for (const std::string& bottom : bottoms) {
+        ins.push_back(get_tensor_(bottom));
+        HCTR_THROW_IF(ins.back()->dims != ins.front()->dims, Error_t::WrongInput,
+                      "The inputs of layer \"", name, "\" differ in shape.");
+      }
+      CpuTensor* const out{add_tensor_(tops[0], ins.front()->dims)};
+      layers_.emplace_back(
+          std::make_unique<BinaryOpLayer>(std::move(ins), out, type == "ElementwiseMultiply"));
+    } else if (type == "Concat") {
+      HCTR_THROW_IF(bottoms.empty() || tops.size() != 1, Error_t::WrongInput, "Layer \"", name,
+                    "\" must have 1 top.");
+      std::vector<const CpuTensor*> ins;
+      for (const std::string& bottom : bottoms) {
+        ins.push_back(get_tensor_(bottom));
+      }
+      // `axis` counts the batch dimension.
+      const size_t axis{layer.value("axis", 1UL)};
+      std::vector<int64_t> dims{ins.front()->dims};
+      HCTR_THROW_IF(axis < 1 || axis > dims.size(), Error_t::WrongInput, "Layer \"", name,
+                    "\" has an invalid axis.");
+      dims[axis - 1] = 0;
+      for (const CpuTensor* in : ins) {
+        HCTR_THROW_IF(in->dims.size() != dims.size(), Error_t::WrongInput,
+                      "The inputs of layer \"", name, "\" differ in rank.");
+        for (size_t d{0}; d < dims.size(); ++d) {
+          HCTR_THROW_IF(d != axis - 1 && in->dims[d] != dims[d], Error_t::WrongInput,
+                        "The inputs of layer \"", name, "\" differ in shape.");
+        }
+        dims[axis - 1] += in->dims[axis - 1];
+      }
+      CpuTensor* const out{add_tensor_(tops[0], dims)};
+
+      const int64_t num_blocks{std::accumulate(dims.begin(), dims.begin() + axis - 1, 1L,
+                                               std::multiplies<int64_t>())};
+      const int64_t out_block{out->size / num_blocks};
+      std::vector<CopyLayer::Block> blocks;
+      for (int64_t i{0}; i < num_blocks; ++i) {
+        int64_t out_offset{i * out_block};
+        for (const CpuTensor* in : ins) {
+          const int64_t in_block{in->size / num_blocks};
+          blocks.push_back({in, i * in_block, out_offset, in_block, out});
+          out_offset += in_block;
+        }
+      }
+      layers_.emplace_back(std::make_unique<CopyLayer>(std::move(blocks)));
+    } else if (type == "Reshape") {
+      check_arity(1, 1);
+      const CpuTensor* const in{get_tensor_(bottoms[0])};
+      if (layer.contains("selected")) {
+        HCTR_THROW_IF(in->dims.size() != 2, Error_t::WrongInput, "Layer \"", name,
+                      "\" expects an input of shape (batch, slots, n).");
+        const auto selected{layer["selected"].get<std::vector<int64_t>>()};
+        const int64_t width{in->dims[1]};
+        CpuTensor* const out{
+            add_tensor_(tops[0], {static_cast<int64_t>(selected.size()) * width})};
+        std::vector<CopyLayer::Block> blocks;
+        for (size_t i{0}; i < selected.size(); ++i) {
+          HCTR_THROW_IF(selected[i] < 0 || selected[i] >= in->dims[0], Error_t::WrongInput,
+                        "Layer \"", name, "\" selects slot ", selected[i],
+                        ", which is out of range.");
+          blocks.push_back({in, selected[i] * width, static_cast<int64_t>(i) * width, width, out});
+        }
+        layers_.emplace_back(std::make_unique<CopyLayer>(std::move(blocks)));
+      } else {
+        const int64_t leading_dim{layer.at("leading_dim").get<int64_t>()};
+        const int64_t time_step{layer.value("time_step", 0L)};
+        std::vector<int64_t> dims{leading_dim};
+        if (time_step) {
+          dims.insert(dims.begin(), time_step);
+        }
+        // Reshapes that change the number of rows per sample do not map to per-sample tensors.
+        HCTR_THROW_IF(leading_dim * std::max(time_step, 1L) != in->size, Error_t::WrongInput,
+                      "Layer \"", name, "\" must keep the number of values per sample (", in->size,
+                      ") on the CPU.");
+        add_tensor_(tops[0], dims, in);
+      }
+    } else if (type == "Slice") {
+      HCTR_THROW_IF(bottoms.size() != 1, Error_t::WrongInput, "Layer \"", name,
+                    "\" must have 1 bottom.");
+      const CpuTensor* const in{get_tensor_(bottoms[0])};
+      HCTR_THROW_IF(in->dims.size() != 1, Error_t::WrongInput, "Layer \"", name,
+                    "\" expects a 2D input.");
+      const auto ranges{layer.at("ranges").get<std::vector<std::pair<int64_t, int64_t>>>()};
+      HCTR_THROW_IF(ranges.size() != tops.size(), Error_t::WrongInput, "Layer \"", name,
+                    "\" must have one top per range.");
+      std::vector<CopyLayer::Block> blocks;
+      for (size_t i{0}; i < ranges.size(); ++i) {
+        const auto [begin, end] = ranges[i];
+        HCTR_THROW_IF(begin < 0 || end > in->size || begin >= end, Error_t::WrongInput,
+                      "Layer \"", name, "\" has an invalid range.");
+        blocks.push_back({in, begin, 0, end - begin, add_tensor_(tops[i], {end - begin})});
+      }
+      layers_.emplace_back(std::make_unique<CopyLayer>(std::move(blocks)));
+    } else {
+      HCTR_OWN_THROW(Error_t::UnSupportedFormat,
+                     "Layer \"" + name + "\" of type " + type + " is not supported on the CPU.");
+    }
+
+    if (!tops.empty()) {
+      output_ = get_tensor_(tops[0]);
+    }
+  }
+
+  HCTR_THROW_IF(weights.offset() != dense_model.size(), Error_t::WrongInput,
+                "The dense model holds ", dense_model.size(), " values, but the network only has ",
+                weights.offset(), " weights.");
+  HCTR_THROW_IF(!output_, Error_t::WrongInput, "The network has no dense layers.");
+  output_dim_ = output_->size;
+}
+
+void CpuDenseNetwork::predict(const float* const dense,
+                              const std::vector<const float*>& embeddings,
+                              const size_t batch_size, float* const output) {
+  HCTR_THROW_IF(embeddings.size() != embeddings_.size(), Error_t::WrongInput, "Expected ",
+                embeddings_.size(), " embedding inputs, but got ", embeddings.size(), ".");
+
+  for (size_t offset{0}; offset < batch_size; offset += params_.max_batch_size) {
+    const size_t n{std::min(params_.max_batch_size, batch_size - offset)};
+    if (dense_) {
+      std::copy_n(&dense[offset * dense_->size], n * dense_->size, dense_->data);
+    }
+    for (size_t i{0}; i < embeddings_.size(); ++i) {
+      const int64_t size{embeddings_[i]->size};
+      std::copy_n(&embeddings[i][offset * size], n * size, embeddings_[i]->data);
+    }
+    for (const auto& layer : layers_) {
+      layer->fprop(static_cast<int64_t>(n));
+    }
+    std::copy_n(output_->data, n * output_dim_, &output[offset * output_dim_]);
+  }
+}
+
+}  // namespace HugeCTR
@@ -0,0 +1,331 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <common.hpp>
+#include <cstring>
+#include <inference/cpu_gemm.hpp>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#define HCTR_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#define HCTR_TARGET_AVX512 __attribute__((target("avx512f")))
+#endif
+
+namespace HugeCTR {
+
+namespace {
+
+constexpr int64_t kNR{CpuPackedMatrix::panel_width};
+constexpr int64_t kKC{256};  // Rows of a panel slice. 256 x 16 fp32 values fill 16 KiB of L1.
+constexpr int64_t kMC{96};   // Rows of `a` per tile. Divisible by the row counts of all kernels.
+
+CpuIsa detect_isa() {
+#if defined(__x86_64__)
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f")) {
+    return CpuIsa::AVX512;
+  }
+  if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+    return CpuIsa::AVX2;
+  }
+#endif
+  return CpuIsa::Scalar;
+}
+
+inline float widen(const float value) { return value; }
+inline float widen(const uint16_t value) { return bf16_to_float(value); }
+
+template <typename W>
+const W* panel_of(const CpuPackedMatrix& b, int64_t panel);
+template <>
+const float* panel_of(const CpuPackedMatrix& b, const int64_t panel) {
+  return b.f32_panel(panel);
+}
+template <>
+const uint16_t* panel_of(const CpuPackedMatrix& b, const int64_t panel) {
+  return b.bf16_panel(panel);
+}
+
+/**
+ * Computes an `MR` x `kNR` tile of `c`. Each kernel multiplies \p kc columns of the rows \p a with
+ * \p kc rows of a panel, and adds the result to \p c if \p accumulate is set. The epilogue adds
+ * \p bias (unless nullptr) and applies ReLU.
+ */
+template <typename W>
+using Kernel = void (*)(const float* const* a, const W* b, int64_t kc, float* c, int64_t ldc,
+                        bool accumulate, const float* bias, bool relu);
+
+template <int MR, typename W>
+void scalar_kernel(const float* const* a, const W* b, const int64_t kc, float* c,
+                   const int64_t ldc, const bool accumulate, const float* bias, const bool relu) {
+  float acc[MR][kNR];
+  for (int i{0}; i < MR; ++i) {
+    for (int j{0}; j < kNR; ++j) {
+      acc[i][j] = accumulate ? c[i * ldc + j] : 0.f;
+    }
+  }
+  for (int64_t p{0}; p < kc; ++p) {
+    float row[kNR];
+    for (int j{0}; j < kNR; ++j) {
+      row[j] = widen(b[p * kNR + j]);
+    }
+    for (int i{0}; i < MR; ++i) {
+      const float a_ip{a[i][p]};
+      for (int j{0}; j < kNR; ++j) {
+        acc[i][j] += a_ip * row[j];
+      }
+    }
+  }
+  for (int i{0}; i < MR; ++i) {
+    for (int j{0}; j < kNR; ++j) {
+      float value{acc[i][j]};
+      if (bias) {
+        value += bias[j];
+      }
+      if (relu) {
+        value = std::max(value, 0.f);
+      }
+      c[i * ldc + j] = value;
+    }
+  }
+}
+
+#if defined(__x86_64__)
+
+HCTR_TARGET_AVX2 inline __m256 avx2_load(const float* const p) { return _mm256_loadu_ps(p); }
+
+HCTR_TARGET_AVX2 inline __m256 avx2_load(const uint16_t* const p) {
+  const __m128i bf16{_mm_loadu_si128(reinterpret_cast<const __m128i*>(p))};
+  return _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_cvtepu16_epi32(bf16), 16));
+}
+
+template <int MR, typename W>
+HCTR_TARGET_AVX2 void avx2_kernel(const float* const* a, const W* b, const int64_t kc, float* c,
+                                  const int64_t ldc, const bool accumulate, const float* bias,
+                                  const bool relu) {
+  __m256 acc[MR][2];
+  for (int i{0}; i < MR; ++i) {
+    acc[i][0] = accumulate ? _mm256_loadu_ps(&c[i * ldc]) : _mm256_setzero_ps();
+    acc[i][1] = accumulate ? _mm256_loadu_ps(&c[i * ldc + 8]) : _mm256_setzero_ps();
+  }
+  for (int64_t p{0}; p < kc; ++p) {
+    const __m256 b0{avx2_load(&b[p * kNR])};
+    const __m256 b1{avx2_load(&b[p * kNR + 8])};
+    for (int i{0}; i < MR; ++i) {
+      const __m256 a_ip{_mm256_broadcast_ss(&a[i][p])};
+      acc[i][0] = _mm256_fmadd_ps(a_ip, b0, acc[i][0]);
+      acc[i][1] = _mm256_fmadd_ps(a_ip, b1, acc[i][1]);
+    }
+  }
+  const __m256 bias0{bias ? _mm256_loadu_ps(bias) : _mm256_setzero_ps()};
+  const __m256 bias1{bias ? _mm256_loadu_ps(bias + 8) : _mm256_setzero_ps()};
+  for (int i{0}; i < MR; ++i) {
+    __m256 c0{_mm256_add_ps(acc[i][0], bias0)};
+    __m256 c1{_mm256_add_ps(acc[i][1], bias1)};
+    if (relu) {
+      c0 = _mm256_max_ps(c0, _mm256_setzero_ps());
+      c1 = _mm256_max_ps(c1, _mm256_setzero_ps());
+    }
+    _mm256_storeu_ps(&c[i * ldc], c0);
+    _mm256_storeu_ps(&c[i * ldc + 8], c1);
+  }
+}
+
+// The AVX-512 intrinsics of GCC 12 start from `_mm512_undefined_*`, which trips this warning.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+
+HCTR_TARGET_AVX512 inline __m512 avx512_load(const float* const p) { return _mm512_loadu_ps(p); }
+
+HCTR_TARGET_AVX512 inline __m512 avx512_load(const uint16_t* const p) {
+  const __m256i bf16{_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p))};
+  return _mm512_castsi512_ps(_mm512_slli_epi32(_mm512_cvtepu16_epi32(bf16), 16));
+}
+
+template <int MR, typename W>
+HCTR_TARGET_AVX512 void avx512_kernel(const float* const* a, const W* b, const int64_t kc,
+                                      float* c, const int64_t ldc, const bool accumulate,
+                                      const float* bias, const bool relu) {
+  __m512 acc[MR];
+  for (int i{0}; i < MR; ++i) {
+    acc[i] = accumulate ? _mm512_loadu_ps(&c[i * ldc]) : _mm512_setzero_ps();
+  }
+  for (int64_t p{0}; p < kc; ++p) {
+    const __m512 b0{avx512_load(&b[p * kNR])};
+    for (int i{0}; i < MR; ++i) {
+      acc[i] = _mm512_fmadd_ps(_mm512_set1_ps(a[i][p]), b0, acc[i]);
+    }
+  }
+  const __m512 bias0{bias ? _mm512_loadu_ps(bias) : _mm512_setzero_ps()};
+  for (int i{0}; i < MR; ++i) {
+    __m512 c0{_mm512_add_ps(acc[i], bias0)};
+    if (relu) {
+      c0 = _mm512_max_ps(c0, _mm512_setzero_ps());
+    }
+    _mm512_storeu_ps(&c[i * ldc], c0);
+  }
+}
+
+#pragma GCC diagnostic pop
+
+#endif
+
+template <int MR, typename W, Kernel<W> kernel>
+void gemm_tiles(const float* a, const int64_t m, const CpuPackedMatrix& b, const float* bias,
+                const bool relu, float* c, const size_t num_threads) {
+  const int64_t k{b.rows()};
+  const int64_t n{b.cols()};
+  const int64_t num_panels{b.num_panels()};
+  const int64_t num_tiles{(m + kMC - 1) / kMC * num_panels};
+  const bool parallel{num_threads > 1 && num_tiles > 1};
+
+#pragma omp parallel for num_threads(num_threads) schedule(static) if (parallel)
+  for (int64_t tile = 0; tile < num_tiles; ++tile) {
+    const int64_t row0{tile / num_panels * kMC};
+    const int64_t rows{std::min(kMC, m - row0)};
+    const int64_t col0{tile % num_panels * kNR};
+    const int64_t cols{std::min(kNR, n - col0)};
+    const W* const panel{panel_of<W>(b, tile % num_panels)};
+
+    // The last panel is padded, so partial tiles are computed in a buffer.
+    float tile_bias[kNR]{};
+    if (bias) {
+      std::copy_n(bias + col0, cols, tile_bias);
+    }
+    float buffer[MR * kNR]{};
+
+    for (int64_t kb{0}; kb < k; kb += kKC) {
+      const int64_t kc{std::min(kKC, k - kb)};
+      const bool last{kb + kc == k};
+      for (int64_t i{0}; i < rows; i += MR) {
+        const int64_t mr{std::min<int64_t>(MR, rows - i)};
+        const float* a_rows[MR];
+        for (int64_t r{0}; r < MR; ++r) {
+          a_rows[r] = &a[(row0 + i + std::min(r, mr - 1)) * k + kb];
+        }
+        float* const c_tile{&c[(row0 + i) * n + col0]};
+        if (mr == MR && cols == kNR) {
+          kernel(a_rows, &panel[kb * kNR], kc, c_tile, n, kb > 0,
+                 last && bias ? tile_bias : nullptr, last && relu);
+        } else {
+          if (kb > 0) {
+            for (int64_t r{0}; r < mr; ++r) {
+              std::copy_n(&c_tile[r * n], cols, &buffer[r * kNR]);
+            }
+          }
+          kernel(a_rows, &panel[kb * kNR], kc, buffer, kNR, kb > 0,
+                 last && bias ? tile_bias : nullptr, last && relu);
+          for (int64_t r{0}; r < mr; ++r) {
+            std::copy_n(&buffer[r * kNR], cols, &c_tile[r * n]);
+          }
+        }
+      }
+    }
+  }
+}
+
+template <typename W>
+void gemm(const float* a, const int64_t m, const CpuPackedMatrix& b, const float* bias,
+          const bool relu, float* c, const size_t num_threads, const CpuIsa isa) {
+  switch (isa) {
+#if defined(__x86_64__)
+    case CpuIsa::AVX512:
+      gemm_tiles<12, W, avx512_kernel<12, W>>(a, m, b, bias, relu, c, num_threads);
+      break;
+    case CpuIsa::AVX2:
+      gemm_tiles<6, W, avx2_kernel<6, W>>(a, m, b, bias, relu, c, num_threads);
+      break;
+#endif
+    default:
+      gemm_tiles<4, W, scalar_kernel<4, W>>(a, m, b, bias, relu, c, num_threads);
+      break;
+  }
+}
+
+}  // namespace
+
+CpuIsa cpu_isa() {
+  static const CpuIsa isa{detect_isa()};
+  return isa;
+}
+
+const char* cpu_isa_name(const CpuIsa isa) {
+  switch (isa) {
+    case CpuIsa::AVX512:
+      return "AVX-512";
+    case CpuIsa::AVX2:
+      return "AVX2";
+    default:
+      return "Scalar";
+  }
+}
+
+uint16_t float_to_bf16(const float value) {
+  uint32_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  if ((bits & 0x7fffffff) > 0x7f800000) {
+    return static_cast<uint16_t>((bits >> 16) | 0x40);  // Keep NaNs quiet.
+  }
+  bits += 0x7fff + ((bits >> 16) & 1);
+  return static_cast<uint16_t>(bits >> 16);
+}
+
+float bf16_to_float(const uint16_t value) {
+  const uint32_t bits{static_cast<uint32_t>(value) << 16};
+  float result;
+  std::memcpy(&result, &bits, sizeof(result));
+  return result;
+}
+
+CpuPackedMatrix::CpuPackedMatrix(const float* const b, const int64_t rows, const int64_t cols,
+                                 const bool bf16)
+    : rows_{rows}, cols_{cols}, bf16_{bf16} {
+  HCTR_THROW_IF(rows <= 0 || cols <= 0, Error_t::WrongInput, "Matrix must not be empty.");
+
+  std::vector<float> packed(num_panels() * rows * panel_width);
+  for (int64_t panel{0}; panel < num_panels(); ++panel) {
+    const int64_t col0{panel * panel_width};
+    const int64_t width{std::min(panel_width, cols - col0)};
+    for (int64_t row{0}; row < rows; ++row) {
+      std::copy_n(&b[row * cols + col0], width, &packed[(panel * rows + row) * panel_width]);
+    }
+  }
+
+  if (bf16) {
+    bf16_data_.resize(packed.size());
+    std::transform(packed.begin(), packed.end(), bf16_data_.begin(), float_to_bf16);
+  } else {
+    f32_ = std::move(packed);
+  }
+}
+
+void cpu_gemm(const float* const a, const int64_t m, const CpuPackedMatrix& b,
+              const float* const bias, const bool relu, float* const c, const size_t num_threads,
+              const CpuIsa isa) {
+  HCTR_THROW_IF(isa > cpu_isa(), Error_t::IllegalCall, cpu_isa_name(isa),
+                " is not supported by this CPU.");
+  if (m <= 0) {
+    return;
+  }
+  if (b.bf16()) {
+    gemm<uint16_t>(a, m, b, bias, relu, c, std::max<size_t>(num_threads, 1), isa);
+  } else {
+    gemm<float>(a, m, b, bias, relu, c, std::max<size_t>(num_threads, 1), isa);
+  }
+}
+
+}  // namespace HugeCTR
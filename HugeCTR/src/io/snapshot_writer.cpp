@@ -0,0 +1,385 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <core23/logger.hpp>
+#include <cstring>
+#include <filesystem>
+#include <io/io_utils.hpp>
+#include <io/snapshot_writer.hpp>
+
+namespace HugeCTR {
+
+void SnapshotBuffer::create_dir(const std::string& path) {
+  if (std::find(dirs_.begin(), dirs_.end(), path) == dirs_.end()) {
+    dirs_.emplace_back(path);
+  }
+}
+
+void SnapshotBuffer::write(const std::string& path, const void* const data, const size_t data_size,
+                           const bool overwrite) {
+  File* file{const_cast<File*>(find(path))};
+  if (!file) {
+    if (num_files_ == files_.size()) {
+      files_.emplace_back();
+    }
+    file = &files_[num_files_++];
+    file->path = path;
+    file->append = !overwrite;
+    file->data.clear();
+  } else if (overwrite) {
+    file->append = false;
+    file->data.clear();
+  }
+
+  const char* const bytes{reinterpret_cast<const char*>(data)};
+  if (data_size) {
+    file->data.insert(file->data.end(), bytes, bytes + data_size);
+  }
+}
+
+const SnapshotBuffer::File* SnapshotBuffer::find(const std::string& path) const {
+  const auto end{files_.begin() + num_files_};
+  const auto it{
+      std::find_if(files_.begin(), end, [&path](const File& f) { return f.path == path; })};
+  return it != end ? &*it : nullptr;
+}
+
+size_t SnapshotBuffer::size_in_bytes() const {
+  size_t size{0};
+  for (size_t i{0}; i < num_files_; ++i) {
+    size += files_[i].data.size();
+  }
+  return size;
+}
+
+void SnapshotBuffer::clear() {
+  dirs_.clear();
+  num_files_ = 0;
+}
+
+StagingFileSystem::StagingFileSystem(SnapshotBuffer& buffer) : buffer_{buffer} {}
+
+size_t StagingFileSystem::get_file_size(const std::string& path) const {
+  const SnapshotBuffer::File* const file{buffer_.find(path)};
+  HCTR_THROW_IF(!file, Error_t::IllegalCall, "File '", path, "' has not been staged.");
+  return file->data.size();
+}
+
+void StagingFileSystem::create_dir(const std::string& path) { buffer_.create_dir(path); }
+
+void StagingFileSystem::delete_file(const std::string& path) {
+  HCTR_OWN_THROW(Error_t::IllegalCall, "Cannot delete files while staging a snapshot.");
+}
+
+void StagingFileSystem::fetch(const std::string& source_path, const std::string& target_path) {
+  HCTR_OWN_THROW(Error_t::IllegalCall, "Cannot fetch files while staging a snapshot.");
+}
+
+void StagingFileSystem::upload(const std::string& source_path, const std::string& target_path) {
+  HCTR_OWN_THROW(Error_t::IllegalCall, "Cannot upload files while staging a snapshot.");
+}
+
+int StagingFileSystem::write(const std::string& path, const void* const data,
+                             const size_t data_size, const bool overwrite) {
+  buffer_.write(path, data, data_size, overwrite);
+  return data_size;
+}
+
+int StagingFileSystem::read(const std::string& path, void* const buffer, const size_t buffer_size,
+                            const size_t offset) {
+  const SnapshotBuffer::File* const file{buffer_.find(path)};
+  HCTR_THROW_IF(!file, Error_t::IllegalCall, "File '", path, "' has not been staged.");
+  if (offset >= file->data.size()) {
+    return 0;
+  }
+  const size_t num_bytes{std::min(buffer_size, file->data.size() - offset)};
+  std::memcpy(buffer, file->data.data() + offset, num_bytes);
+  return num_bytes;
+}
+
+void StagingFileSystem::copy(const std::string& source_file, const std::string& target_file) {
+  HCTR_OWN_THROW(Error_t::IllegalCall, "Cannot copy files while staging a snapshot.");
+}
+
+void StagingFileSystem::batch_fetch(const std::string& source_dir, const std::string& target_dir) {
+  HCTR_OWN_THROW(Error_t::IllegalCall, "Cannot fetch files while staging a snapshot.");
+}
+
+void StagingFileSystem::batch_upload(const std::string& source_dir, const std::string& target_dir) {
+  HCTR_OWN_THROW(Error_t::IllegalCall, "Cannot upload files while staging a snapshot.");
+}
+
+SnapshotWriter::SnapshotWriter(const SnapshotWriterParams& params) : params_{params} {
+  HCTR_CHECK_HINT(params_.num_buffers > 0, "Snapshot writer requires at least one buffer.");
+  HCTR_CHECK_HINT(params_.num_threads > 0, "Snapshot writer requires at least one thread.");
+  HCTR_CHECK_HINT(params_.chunk_size > 0, "Snapshot write chunk size must be positive.");
+
+  slots_.reserve(params_.num_buffers);
+  for (size_t i{0}; i < params_.num_buffers; ++i) {
+    slots_.emplace_back(std::make_unique<Slot>());
+  }
+  threads_.reserve(params_.num_threads);
+  for (size_t i{0}; i < params_.num_threads; ++i) {
+    threads_.emplace_back(&SnapshotWriter::run_, this);
+  }
+}
+
+SnapshotWriter::~SnapshotWriter() {
+  {
+    const std::lock_guard lock(mutex_);
+    stop_ = true;
+  }
+  job_cv_.notify_all();
+  for (std::thread& thread : threads_) {
+    thread.join();
+  }
+  if (error_) {
+    HCTR_LOG_S(ERROR, WORLD) << "Snapshot writer shut down with unreported write errors."
+                             << std::endl;
+  }
+}
+
+SnapshotBuffer& SnapshotWriter::acquire() {
+  std::unique_lock lock(mutex_);
+  HCTR_THROW_IF(stop_, Error_t::IllegalCall, "Snapshot writer is shutting down.");
+
+  const auto find_free_slot = [this]() -> Slot* {
+    for (const auto& slot : slots_) {
+      if (slot->state == BufferState::Free) {
+        return slot.get();
+      }
+    }
+    return nullptr;
+  };
+  Slot* slot{find_free_slot()};
+  if (!slot) {
+    const auto begin{std::chrono::steady_clock::now()};
+    slot_cv_.wait(lock, [&]() { return (slot = find_free_slot()) != nullptr; });
+    stats_.stall_time_s +=
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+  }
+
+  slot->state = BufferState::Staging;
+  slot->buffer.clear();
+  return slot->buffer;
+}
+
+void SnapshotWriter::submit(SnapshotBuffer& buffer) {
+  Slot& slot{find_slot_(buffer)};
+  {
+    const std::lock_guard lock(mutex_);
+    HCTR_THROW_IF(slot.state != BufferState::Staging, Error_t::IllegalCall,
+                  "Snapshot buffer has not been acquired.");
+  }
+
+  // Directories are cheap to create, and must exist before the files are written.
+  try {
+    for (const std::string& dir : buffer.dirs()) {
+      auto fs{FileSystemBuilder::build_unique_by_path(dir)};
+      fs->create_dir(dir);
+    }
+  } catch (...) {
+    discard(buffer);
+    throw;
+  }
+
+  {
+    const std::lock_guard lock(mutex_);
+    if (buffer.num_files() == 0) {
+      slot.state = BufferState::Free;
+      ++stats_.num_snapshots;
+    } else {
+      slot.state = BufferState::Writing;
+      slot.num_pending_files = buffer.num_files();
+      slot.submit_time = std::chrono::steady_clock::now();
+      for (size_t i{0}; i < buffer.num_files(); ++i) {
+        jobs_.push_back({&slot, i});
+      }
+    }
+  }
+  job_cv_.notify_all();
+  slot_cv_.notify_all();
+}
+
+void SnapshotWriter::discard(SnapshotBuffer& buffer) {
+  Slot& slot{find_slot_(buffer)};
+  {
+    const std::lock_guard lock(mutex_);
+    HCTR_THROW_IF(slot.state != BufferState::Staging, Error_t::IllegalCall,
+                  "Snapshot buffer has not been acquired.");
+    slot.state = BufferState::Free;
+    slot.buffer.clear();
+  }
+  slot_cv_.notify_all();
+}
+
+void SnapshotWriter::wait() {
+  std::exception_ptr error;
+  {
+    std::unique_lock lock(mutex_);
+    slot_cv_.wait(lock, [this]() {
+      return std::none_of(slots_.begin(), slots_.end(), [](const auto& slot) {
+        return slot->state == BufferState::Writing;
+      });
+    });
+    std::swap(error, error_);
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
+SnapshotWriterStats SnapshotWriter::get_stats() const {
+  const std::lock_guard lock(mutex_);
+  return stats_;
+}
+
+SnapshotWriter::Slot& SnapshotWriter::find_slot_(const SnapshotBuffer& buffer) {
+  for (const auto& slot : slots_) {
+    if (&slot->buffer == &buffer) {
+      return *slot;
+    }
+  }
+  HCTR_OWN_THROW(Error_t::WrongInput, "Buffer does not belong to this snapshot writer.");
+}
+
+void SnapshotWriter::run_() {
+  std::vector<char> compressed;
+
+  std::unique_lock lock(mutex_);
+  while (true) {
+    job_cv_.wait(lock, [this]() { return stop_ || !jobs_.empty(); });
+    if (jobs_.empty()) {
+      break;
+    }
+    const Job job{jobs_.front()};
+    jobs_.pop_front();
+    lock.unlock();
+
+    const SnapshotBuffer::File& file{job.slot->buffer.file(job.file_index)};
+    size_t num_bytes{0};
+    std::exception_ptr error;
+    try {
+      num_bytes = write_file_(file, compressed);
+    } catch (const std::exception& e) {
+      HCTR_LOG_S(ERROR, WORLD) << "Writing snapshot file '" << file.path << "' failed: " << e.what()
+                               << std::endl;
+      error = std::current_exception();
+    }
+
+    lock.lock();
+    ++stats_.num_files;
+    stats_.num_bytes += num_bytes;
+    if (error) {
+      ++stats_.num_errors;
+      if (!error_) {
+        error_ = error;
+      }
+    }
+
+    Slot& slot{*job.slot};
+    if (--slot.num_pending_files == 0) {
+      const double write_time_s{
+          std::chrono::duration<double>(std::chrono::steady_clock::now() - slot.submit_time)
+              .count()};
+      HCTR_LOG_S(INFO, ROOT) << "Snapshot with " << slot.buffer.num_files() << " file(s), "
+                             << slot.buffer.size_in_bytes() << " bytes written in " << write_time_s
+                             << "s" << std::endl;
+      slot.state = BufferState::Free;
+      ++stats_.num_snapshots;
+      stats_.write_time_s += write_time_s;
+      slot_cv_.notify_all();
+    }
+  }
+}
+
+size_t SnapshotWriter::write_file_(const SnapshotBuffer::File& file,
+                                   std::vector<char>& compressed) const {
+  std::string path{file.path};
+  const char* data{file.data.data()};
+  size_t data_size{file.data.size()};
+  if (params_.compress && !file.append) {
+    compressed.clear();
+    params_.compress(data, data_size, compressed);
+    path += params_.compressed_suffix;
+    data = compressed.data();
+    data_size = compressed.size();
+  }
+
+  if (IOUtils::is_local_path(path)) {
+    write_local_file_(path, data, data_size, file.append);
+  } else {
+    auto fs{FileSystemBuilder::build_unique_by_path(path)};
+    fs->write(path, data, data_size, !file.append);
+  }
+  return data_size;
+}
+
+void SnapshotWriter::write_local_file_(const std::string& path, const char* data,
+                                       const size_t data_size, const bool append) const {
+  const std::string parent_dir{IOUtils::get_parent_dir(path)};
+  if (!parent_dir.empty()) {
+    std::filesystem::create_directories(parent_dir);
+  }
+
+  // Replaced files are written next to their destination, and renamed once complete.
+  const std::string tmp_path{append ? path : path + ".tmp"};
+  const int flags{O_WRONLY | O_CREAT | O_CLOEXEC | (append ? O_APPEND : O_TRUNC)};
+  const int fd{open(tmp_path.c_str(), flags, 0644)};
+  HCTR_THROW_IF(fd < 0, Error_t::FileCannotOpen, "Cannot open '", tmp_path,
+                "': ", std::strerror(errno));
+
+  const auto fail = [&](const char* const what) {
+    const int error{errno};
+    close(fd);
+    if (!append) {
+      unlink(tmp_path.c_str());
+    }
+    HCTR_OWN_THROW(Error_t::BrokenFile,
+                   std::string("Cannot ") + what + " '" + tmp_path + "': " + std::strerror(error));
+  };
+
+  for (size_t offset{0}; offset < data_size;) {
+    const size_t chunk_size{std::min(params_.chunk_size, data_size - offset)};
+    const ssize_t n{::write(fd, data + offset, chunk_size)};
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      fail("write");
+    }
+    offset += static_cast<size_t>(n);
+  }
+  if (params_.sync && fdatasync(fd) != 0) {
+    fail("sync");
+  }
+  if (close(fd) != 0) {
+    const int error{errno};
+    HCTR_OWN_THROW(Error_t::BrokenFile,
+                   std::string("Cannot close '") + tmp_path + "': " + std::strerror(error));
+  }
+
+  if (!append) {
+    std::filesystem::rename(tmp_path, path);
+  }
+}
+
+}  // namespace HugeCTR
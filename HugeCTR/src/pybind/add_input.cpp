@@ -333,11 +333,11 @@ void add_input(Input& input, DataReaderParams& reader_params,
         train_data_reader->create_drwg_parquet(
             source_data, reader_params.read_file_sequentially, slot_offset, repeat_dataset,
             parquet_source_max_row_group_size, parquet_dense_cols + parquet_label_cols,
-            dense_dim + total_label_dim);
+            dense_dim + total_label_dim, reader_params.parquet_cpu_decoder_threads);
         evaluate_data_reader->create_drwg_parquet(
             eval_source, reader_params.read_file_sequentially, slot_offset, repeat_dataset,
             parquet_eval_max_row_group_size, parquet_dense_cols + parquet_label_cols,
-            dense_dim + total_label_dim);
+            dense_dim + total_label_dim, reader_params.parquet_cpu_decoder_threads);
 #endif
         break;
       }
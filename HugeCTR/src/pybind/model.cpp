@@ -20,6 +20,7 @@
 #include <core/hctr_impl/hctr_backend.hpp>
 #include <core23/logger.hpp>
 #include <core23/mpi_init_service.hpp>
+#include <core23/tracer.hpp>
 #include <core23_helper.hpp>
 #include <core23_network.hpp>
 #include <data_readers/multi_hot/async_data_reader.hpp>
@@ -75,7 +76,8 @@ DataReaderParams::DataReaderParams(DataReaderType_t data_reader_type,
                                    bool float_label_dense, bool read_file_sequentially,
                                    int num_workers, std::vector<long long>& slot_size_array,
                                    const DataSourceParams& data_source_params,
-                                   const AsyncParam& async_param)
+                                   const AsyncParam& async_param,
+                                   size_t parquet_cpu_decoder_threads)
     : data_reader_type(data_reader_type),
       source(source),
       keyset(keyset),
@@ -89,7 +91,8 @@ DataReaderParams::DataReaderParams(DataReaderType_t data_reader_type,
       num_workers(num_workers),
       slot_size_array(slot_size_array),
       data_source_params(data_source_params),
-      async_param(async_param) {}
+      async_param(async_param),
+      parquet_cpu_decoder_threads(parquet_cpu_decoder_threads) {}
 
 DataReaderParams::DataReaderParams(DataReaderType_t data_reader_type, std::string source,
                                    std::string keyset, std::string eval_source, Check_t check_type,
@@ -98,7 +101,8 @@ DataReaderParams::DataReaderParams(DataReaderType_t data_reader_type, std::strin
                                    bool read_file_sequentially, int num_workers,
                                    std::vector<long long>& slot_size_array,
                                    const DataSourceParams& data_source_params,
-                                   const AsyncParam& async_param)
+                                   const AsyncParam& async_param,
+                                   size_t parquet_cpu_decoder_threads)
     : data_reader_type(data_reader_type),
       eval_source(eval_source),
       check_type(check_type),
@@ -110,7 +114,8 @@ DataReaderParams::DataReaderParams(DataReaderType_t data_reader_type, std::strin
       num_workers(num_workers),
       slot_size_array(slot_size_array),
       data_source_params(data_source_params),
-      async_param(async_param) {
+      async_param(async_param),
+      parquet_cpu_decoder_threads(parquet_cpu_decoder_threads) {
   this->source.push_back(source);
   this->keyset.push_back(keyset);
 }
@@ -849,7 +854,7 @@ void Model::fit(int num_epochs, int max_iter, int display, int eval_interval, in
                                  << " iters: " << timer_eval.elapsedSeconds() << "s" << std::endl;
         }
         if (snapshot > 0 && (iter + 1) % snapshot == 0 && iter != 0) {
-          this->download_params_to_files(snapshot_prefix, iter + 1);
+          this->snapshot_params_to_files_(snapshot_prefix, iter + 1);
         }
         iter++;
       } while (data_reader_train_status_);
@@ -986,7 +991,7 @@ void Model::fit(int num_epochs, int max_iter, int display, int eval_interval, in
         }
       }
       if (snapshot > 0 && (iter + 1) % snapshot == 0 && iter != 0) {
-        this->download_params_to_files(snapshot_prefix, iter + 1);
+        this->snapshot_params_to_files_(snapshot_prefix, iter + 1);
       }
     }  // end for iter
     for (auto tc : training_callbacks_) {
@@ -1008,6 +1013,15 @@ void Model::fit(int num_epochs, int max_iter, int display, int eval_interval, in
 
   }  // end if else
   high_level_eval_ = false;
+
+  // Make sure that the last snapshot is complete before control returns to the user.
+  if (snapshot_writer_) {
+    try {
+      snapshot_writer_->wait();
+    } catch (const std::exception& err) {
+      Logger::get().print(err);
+    }
+  }
 }
 
 bool Model::skip_prefetch_in_last_batch(bool is_train) {
@@ -1020,6 +1034,7 @@ bool Model::skip_prefetch_in_last_batch(bool is_train) {
 }
 
 long long Model::read_a_batch(bool is_train) {
+  HCTR_TRACE_SCOPE("Model::read_a_batch");
   auto& data_reader = is_train ? train_data_reader_ : evaluate_data_reader_;
   bool drop_incomplete_batch = is_train ? solver_.drop_incomplete_batch : false;
   bool skip_prefetch_data_reading = skip_prefetch_in_last_batch(is_train);
@@ -1046,6 +1061,7 @@ long long Model::read_a_batch(bool is_train) {
 
 bool is_first_h2d = true;
 bool Model::train() {
+  HCTR_TRACE_SCOPE("Model::train");
   try {
     if (train_data_reader_->is_started() == false) {
       HCTR_OWN_THROW(Error_t::IllegalCall,
@@ -1094,12 +1110,16 @@ bool Model::train() {
 
     auto network_update = [&](int id) { networks_[id]->update_params(); };
 
-    for (auto& one_embedding : embeddings_) {
-      one_embedding->forward(true);
+    {
+      HCTR_TRACE_SCOPE("embedding forward");
+      for (auto& one_embedding : embeddings_) {
+        one_embedding->forward(true);
+      }
     }
 
 #pragma omp parallel num_threads(number_of_networks())
     {
+      HCTR_TRACE_SCOPE("dense train");
       size_t id = omp_get_thread_num();
       CudaCPUDeviceContext ctx(resource_manager_->get_local_gpu(id)->get_device_id());
       if (solver_.use_cuda_graph && !train_data_reader_->current_batch_incomplete()) {
@@ -1110,21 +1130,28 @@ bool Model::train() {
     }
 
     // Embedding backward
-    for (auto& one_embedding : embeddings_) {
-      one_embedding->backward();
+    {
+      HCTR_TRACE_SCOPE("embedding backward");
+      for (auto& one_embedding : embeddings_) {
+        one_embedding->backward();
+      }
     }
 
     // Exchange wgrad and update params
 #pragma omp parallel num_threads(number_of_networks())
     {
+      HCTR_TRACE_SCOPE("exchange wgrad and update");
       size_t id = omp_get_thread_num();
       CudaCPUDeviceContext ctx(resource_manager_->get_local_gpu(id)->get_device_id());
       exchange_wgrad(id);
       network_update(id);
     }
 
-    for (const auto& one_embedding : embeddings_) {
-      one_embedding->update_params();
+    {
+      HCTR_TRACE_SCOPE("embedding update");
+      for (const auto& one_embedding : embeddings_) {
+        one_embedding->update_params();
+      }
     }
     return true;
 #else
@@ -1138,6 +1165,7 @@ bool Model::train() {
 }
 
 bool Model::eval() {
+  HCTR_TRACE_SCOPE("Model::eval");
   try {
     if (evaluate_data_reader_ == nullptr) return true;
     if (evaluate_data_reader_->is_started() == false) {
@@ -1167,13 +1195,17 @@ bool Model::eval() {
       return true;
     }
 
-    for (size_t i = 0; i < embeddings_.size(); ++i) {
-      auto& one_embedding = embeddings_.at(i);
-      one_embedding->forward(false);
+    {
+      HCTR_TRACE_SCOPE("embedding forward");
+      for (size_t i = 0; i < embeddings_.size(); ++i) {
+        auto& one_embedding = embeddings_.at(i);
+        one_embedding->forward(false);
+      }
     }
 
 #pragma omp parallel num_threads(number_of_networks())
     {
+      HCTR_TRACE_SCOPE("dense evaluate");
       size_t id = omp_get_thread_num();
       auto gpu = resource_manager_->get_local_gpu(id);
 
@@ -1234,6 +1266,11 @@ Error_t Model::get_current_loss(float* loss) {
 }
 
 Error_t Model::download_params_to_files(std::string prefix, int iter) {
+  return download_params_to_files_(prefix, iter, nullptr);
+}
+
+Error_t Model::download_params_to_files_(const std::string& prefix, const int iter,
+                                         FileSystem* const fs) {
   std::string snapshot_dense_name = prefix + "_dense_" + std::to_string(iter) + ".model";
   std::string snapshot_dense_opt_name = prefix + "_opt_dense_" + std::to_string(iter) + ".model";
   std::vector<std::string> snapshot_sparse_names;
@@ -1244,8 +1281,46 @@ Error_t Model::download_params_to_files(std::string prefix, int iter) {
     snapshot_sparse_opt_names.push_back(prefix + std::to_string(i) + "_opt_sparse_" +
                                         std::to_string(iter) + ".model");
   }
-  download_sparse_params_to_files_(snapshot_sparse_names, snapshot_sparse_opt_names);
-  return download_dense_params_to_files_(snapshot_dense_name, snapshot_dense_opt_name);
+  download_sparse_params_to_files_(snapshot_sparse_names, snapshot_sparse_opt_names, fs);
+  return download_dense_params_to_files_(snapshot_dense_name, snapshot_dense_opt_name, fs);
+}
+
+Error_t Model::snapshot_params_to_files_(const std::string& prefix, const int iter) {
+  HCTR_TRACE_SCOPE("Model::snapshot");
+  if (!solver_.async_snapshot) {
+    return download_params_to_files(prefix, iter);
+  }
+
+  try {
+    if (!snapshot_writer_) {
+      SnapshotWriterParams params;
+      params.num_threads = solver_.num_snapshot_threads;
+      snapshot_writer_ = std::make_unique<SnapshotWriter>(params);
+    }
+
+    HugeCTR::Timer timer;
+    timer.start();
+    SnapshotBuffer& buffer = snapshot_writer_->acquire();
+    StagingFileSystem staging(buffer);
+    const Error_t err = download_params_to_files_(prefix, iter, &staging);
+    if (err != Error_t::Success) {
+      snapshot_writer_->discard(buffer);
+      return err;
+    }
+    const size_t num_bytes = buffer.size_in_bytes();
+    snapshot_writer_->submit(buffer);
+    timer.stop();
+    HCTR_LOG_S(INFO, ROOT) << "Staged snapshot of iteration " << iter << " (" << num_bytes
+                           << " bytes) in " << timer.elapsedSeconds()
+                           << "s, writing it in the background" << std::endl;
+  } catch (const core23::RuntimeError& rt_err) {
+    Logger::get().print(rt_err);
+    return rt_err.error;
+  } catch (const std::exception& err) {
+    Logger::get().print(err);
+    return Error_t::UnspecificError;
+  }
+  return Error_t::Success;
 }
 
 void Model::check_overflow() const {
@@ -1268,19 +1343,32 @@ void Model::copy_weights_for_evaluation() {
 }
 
 Error_t Model::download_dense_params_to_files_(std::string weights_file,
-                                               std::string dense_opt_states_file) {
+                                               std::string dense_opt_states_file,
+                                               FileSystem* const fs) {
   try {
     if (resource_manager_->is_master_process()) {
       auto op = [&](auto& network) {
-        network->download_params_to_host(weights_file);
+        if (fs) {
+          network->download_params_to_host(weights_file, *fs);
+        } else {
+          network->download_params_to_host(weights_file);
+        }
         HCTR_LOG(INFO, ROOT, "Dumping dense weights to file, successful\n");
-        network->download_opt_states_to_host(dense_opt_states_file);
+        if (fs) {
+          network->download_opt_states_to_host(dense_opt_states_file, *fs);
+        } else {
+          network->download_opt_states_to_host(dense_opt_states_file);
+        }
         HCTR_LOG(INFO, ROOT, "Dumping dense optimizer states to file, successful\n");
         std::string no_trained_params = network->get_no_trained_params_in_string();
         if (no_trained_params.length() != 0) {
           std::string ntp_file = weights_file + ".ntp.json";
-          auto fs = FileSystemBuilder::build_unique_by_path(ntp_file);
-          fs->write(ntp_file, no_trained_params.c_str(), no_trained_params.length(), true);
+          std::unique_ptr<FileSystem> ntp_fs;
+          if (!fs) {
+            ntp_fs = FileSystemBuilder::build_unique_by_path(ntp_file);
+          }
+          (fs ? *fs : *ntp_fs)
+              .write(ntp_file, no_trained_params.c_str(), no_trained_params.length(), true);
           HCTR_LOG(INFO, ROOT, "Dumping untrainable weights to file, successful\n");
         }
       };
@@ -1299,12 +1387,16 @@ Error_t Model::download_dense_params_to_files_(std::string weights_file,
 
 Error_t Model::download_sparse_params_to_files_(
     const std::vector<std::string>& embedding_files,
-    const std::vector<std::string>& sparse_opt_state_files) {
+    const std::vector<std::string>& sparse_opt_state_files, FileSystem* const fs) {
   try {
     {
       int i = 0;
       for (auto& embedding_file : embedding_files) {
-        embeddings_[i]->dump_parameters(embedding_file);
+        if (fs) {
+          embeddings_[i]->dump_parameters(embedding_file, *fs);
+        } else {
+          embeddings_[i]->dump_parameters(embedding_file);
+        }
         i++;
       }
     }
@@ -1312,7 +1404,11 @@ Error_t Model::download_sparse_params_to_files_(
     {
       int i = 0;
       for (auto& sparse_opt_state_file : sparse_opt_state_files) {
-        embeddings_[i]->dump_opt_states(sparse_opt_state_file);
+        if (fs) {
+          embeddings_[i]->dump_opt_states(sparse_opt_state_file, *fs);
+        } else {
+          embeddings_[i]->dump_opt_states(sparse_opt_state_file);
+        }
         i++;
       }
     }
@@ -17,6 +17,7 @@
 #include <HugeCTR/include/data_readers/multi_hot/async_data_reader.hpp>
 #include <algorithm>
 #include <core23/logger.hpp>
+#include <core23/tracer.hpp>
 #include <core23_network.hpp>
 #include <fstream>
 #include <iomanip>
@@ -420,6 +421,7 @@ void Model::create_train_pipeline_with_ebc(std::vector<std::shared_ptr<Network>>
 }
 
 void Model::train_pipeline_with_ebc() {
+  HCTR_TRACE_SCOPE("train pipeline");
   if (graph_.is_first_train_batch_ && solver_.train_inter_iteration_overlap) {
 #pragma omp parallel num_threads(number_of_networks())
     {
@@ -603,6 +605,7 @@ void Model::create_evaluate_pipeline_with_ebc(std::vector<std::shared_ptr<Networ
 }
 
 void Model::evaluate_pipeline_with_ebc() {
+  HCTR_TRACE_SCOPE("evaluate pipeline");
   if (graph_.is_first_eval_batch_ && solver_.eval_inter_iteration_overlap) {
 #pragma omp parallel num_threads(number_of_networks())
     {
@@ -26,6 +26,7 @@
 #include <pybind/model_wrapper.hpp>
 #include <pybind/optimizer_wrapper.hpp>
 #include <pybind/solver_wrapper.hpp>
+#include <pybind/tracer_wrapper.hpp>
 #include <pybind/training_callback_wrapper.hpp>
 
 using namespace HugeCTR::python_lib;
@@ -43,4 +44,5 @@ PYBIND11_MODULE(hugectr, m) {
   EmbeddingCollectionPybind(m);
   HPSPybind(m);
   TrainingCallbackPybind(m);
+  TracerPybind(m);
 }
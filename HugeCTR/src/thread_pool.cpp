@@ -23,7 +23,12 @@ namespace HugeCTR {
 
 ThreadPool::ThreadPool(const std::string& name) : ThreadPool(name, 0) {}
 
-ThreadPool::ThreadPool(const std::string& name, size_t num_workers) : name_(name) {
+ThreadPool::ThreadPool(const std::string& name, size_t num_workers)
+    : ThreadPool(name, num_workers, nullptr) {}
+
+ThreadPool::ThreadPool(const std::string& name, size_t num_workers,
+                       const std::function<void(size_t)>& on_start)
+    : name_(name), on_start_(on_start) {
   // Determine eventual number of threads.
   if (num_workers == 0) {
     const char* num_workers_str = getenv("HCTR_DEFAULT_CONCURRENCY");
@@ -108,6 +113,9 @@ void ThreadPool::run_(const size_t thread_index) {
   if (name_ != "") {
     Logger::set_thread_name(name_ + " #" + std::to_string(thread_index));
   }
+  if (on_start_) {
+    on_start_(thread_index);
+  }
   while (true) {
     thread_local std::packaged_task<void()> package;
 
@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <shared_mutex>
+#include <vector>
+
+#include "gpu_cache_api.hpp"
+
+namespace gpu_cache {
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Finalizer of MurmurHash3 (64-bit). `MurmurHash3_32` reads the key through a `uint32_t` pointer,
+// which the host compiler may assume not to alias a 64-bit key.
+template <typename key_type>
+struct Mix64_Hash {
+  using result_type = uint32_t;
+
+  static inline result_type hash(const key_type& key) {
+    uint64_t h = static_cast<uint64_t>(key);
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return static_cast<result_type>(h);
+  }
+};
+
+// CPU Cache
+//
+// Host memory counterpart of `gpu_cache`, with the same API contract and the same layout: a key is
+// hashed to one of `capacity_in_set` sets, and each set holds `set_associativity` slabs of
+// `slab_size` [key, value] pairs. All pointers passed to the API are host pointers, and all calls
+// are synchronous; the `stream` and `task_per_warp_tile` arguments are ignored.
+//
+// Each slot carries an 8-bit tag derived from the key hash (0 marks an unused slot). A lookup
+// compares the tags of the whole set with SIMD instructions, and only compares the full keys of the
+// slots whose tag matched. As in `gpu_cache`, every slot has a counter that is set to the global
+// counter whenever the slot is hit or written, and `Query` advances the global counter. `Replace`
+// evicts the slot with the smallest counter of the set, i.e. the least recently used one.
+//
+// The sets are protected by a fixed number of reader-writer locks (set `i` uses lock
+// `i % num_lock_stripes`). `Query` and `Dump` share the lock, `Replace` and `Update` hold it
+// exclusively. Batches are processed by up to `num_threads` OpenMP threads.
+template <typename key_type, typename ref_counter_type, key_type empty_key, int set_associativity,
+          int slab_size, typename set_hasher = Mix64_Hash<key_type>>
+class cpu_cache : public gpu_cache_api<key_type> {
+ public:
+  static constexpr size_t slots_per_set = set_associativity * slab_size;
+  static_assert(set_associativity > 0 && slab_size > 0, "Invalid cache set geometry.");
+  static_assert(slots_per_set <= 64, "The tags of a set must fit into a 64-bit mask.");
+
+  // Ctor
+  cpu_cache(const size_t capacity_in_set, const size_t embedding_vec_size,
+            const size_t num_threads = 1, const size_t num_lock_stripes = 4096);
+
+  // Dtor
+  ~cpu_cache() {}
+
+  // Query API, i.e. A single read from the cache
+  void Query(const key_type* h_keys, const size_t len, float* h_values, uint64_t* h_missing_index,
+             key_type* h_missing_keys, size_t* h_missing_len, cudaStream_t stream,
+             const size_t task_per_warp_tile = TASK_PER_WARP_TILE_MACRO) override;
+
+  // Replace API, i.e. Follow the Query API to update the content of the cache to Most Recent
+  void Replace(const key_type* h_keys, const size_t len, const float* h_values, cudaStream_t stream,
+               const size_t task_per_warp_tile = TASK_PER_WARP_TILE_MACRO) override;
+
+  // Update API, i.e. update the embeddings which exist in the cache
+  void Update(const key_type* h_keys, const size_t len, const float* h_values, cudaStream_t stream,
+              const size_t task_per_warp_tile = TASK_PER_WARP_TILE_MACRO) override;
+
+  // Dump API, i.e. dump some slabsets' keys from the cache
+  void Dump(key_type* h_keys, size_t* h_dump_counter, const size_t start_set_index,
+            const size_t end_set_index, cudaStream_t stream) override;
+
+  void Record(cudaStream_t stream) override {}
+
+  size_t capacity_in_set() const { return capacity_in_set_; }
+  size_t embedding_vec_size() const { return embedding_vec_size_; }
+
+ private:
+  // Batches smaller than this are not worth waking up the OpenMP threads for.
+  static constexpr size_t min_keys_per_thread_ = 256;
+
+  struct alignas(64) lock_stripe {
+    std::shared_mutex mutex;
+  };
+
+  // Cache data, `slots_per_set` consecutive entries per set
+  std::vector<uint8_t> tags_;
+  std::vector<key_type> keys_;
+  std::vector<float> vals_;
+  std::unique_ptr<std::atomic<ref_counter_type>[]> slot_counter_;
+
+  // Global counter
+  std::atomic<ref_counter_type> global_counter_;
+
+  std::unique_ptr<lock_stripe[]> locks_;
+  size_t num_lock_stripes_;
+
+  size_t capacity_in_set_;
+  size_t num_slot_;
+  size_t embedding_vec_size_;
+  size_t num_threads_;
+
+  static inline uint8_t tag_of(uint32_t hash) {
+    const uint8_t tag = static_cast<uint8_t>(hash >> 24);
+    return tag ? tag : 1;
+  }
+
+  // Bit `i` of the result is set if slot `i` of the set has tag `tag`.
+  static uint64_t match_tags(const uint8_t* tags, uint8_t tag);
+
+  // Index of the slot holding `key` within the set, or -1.
+  int find_(size_t set, key_type key, uint8_t tag) const;
+
+  size_t num_threads_for_(size_t len) const;
+
+  std::shared_mutex& lock_of_(size_t set) const { return locks_[set % num_lock_stripes_].mutex; }
+};
+
+}  // namespace gpu_cache
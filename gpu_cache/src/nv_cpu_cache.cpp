@@ -0,0 +1,293 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <nv_cpu_cache.hpp>
+#include <nv_gpu_cache.hpp>
+#include <stdexcept>
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace gpu_cache {
+
+template <typename key_type, typename ref_counter_type, key_type empty_key, int set_associativity,
+          int slab_size, typename set_hasher>
+cpu_cache<key_type, ref_counter_type, empty_key, set_associativity, slab_size,
+          set_hasher>::cpu_cache(const size_t capacity_in_set, const size_t embedding_vec_size,
+                                 const size_t num_threads, const size_t num_lock_stripes)
+    : capacity_in_set_(capacity_in_set),
+      embedding_vec_size_(embedding_vec_size),
+      num_threads_(num_threads) {
+  // Check parameter
+  if (capacity_in_set_ == 0) {
+    throw std::invalid_argument("Invalid value for capacity_in_set.");
+  }
+  if (embedding_vec_size_ == 0) {
+    throw std::invalid_argument("Invalid value for embedding_vec_size.");
+  }
+  if (num_threads_ == 0) {
+    throw std::invalid_argument("Invalid value for num_threads.");
+  }
+  if (num_lock_stripes == 0) {
+    throw std::invalid_argument("Invalid value for num_lock_stripes.");
+  }
+
+  // Calculate # of slot
+  num_slot_ = capacity_in_set_ * slots_per_set;
+
+  // Allocate host memory for cache, set all entry to unused <K,V>
+  tags_.resize(num_slot_, 0);
+  keys_.resize(num_slot_, empty_key);
+  vals_.resize(num_slot_ * embedding_vec_size_);
+  slot_counter_.reset(new std::atomic<ref_counter_type>[num_slot_]);
+  for (size_t i = 0; i < num_slot_; ++i) {
+    slot_counter_[i].store(0, std::memory_order_relaxed);
+  }
+  global_counter_.store(0, std::memory_order_relaxed);
+
+  // More locks than sets would never be used.
+  num_lock_stripes_ = std::min(num_lock_stripes, capacity_in_set_);
+  locks_.reset(new lock_stripe[num_lock_stripes_]);
+}
+
+template <typename key_type, typename ref_counter_type, key_type empty_key, int set_associativity,
+          int slab_size, typename set_hasher>
+uint64_t cpu_cache<key_type, ref_counter_type, empty_key, set_associativity, slab_size,
+                   set_hasher>::match_tags(const uint8_t* const tags, const uint8_t tag) {
+  uint64_t mask = 0;
+  size_t i = 0;
+#if defined(__AVX2__)
+  const __m256i needle_256 = _mm256_set1_epi8(static_cast<char>(tag));
+  for (; i + 32 <= slots_per_set; i += 32) {
+    const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&tags[i]));
+    mask |= static_cast<uint64_t>(
+                static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, needle_256))))
+            << i;
+  }
+#endif
+#if defined(__SSE2__)
+  const __m128i needle_128 = _mm_set1_epi8(static_cast<char>(tag));
+  for (; i + 16 <= slots_per_set; i += 16) {
+    const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&tags[i]));
+    mask |= static_cast<uint64_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, needle_128))) << i;
+  }
+#endif
+  for (; i < slots_per_set; ++i) {
+    mask |= static_cast<uint64_t>(tags[i] == tag) << i;
+  }
+  return mask;
+}
+
+template <typename key_type, typename ref_counter_type, key_type empty_key, int set_associativity,
+          int slab_size, typename set_hasher>
+int cpu_cache<key_type, ref_counter_type, empty_key, set_associativity, slab_size,
+              set_hasher>::find_(const size_t set, const key_type key, const uint8_t tag) const {
+  const size_t first_slot = set * slots_per_set;
+  for (uint64_t mask = match_tags(&tags_[first_slot], tag); mask; mask &= mask - 1) {
+    const int slot = __builtin_ctzll(mask);
+    if (keys_[first_slot + slot] == key) {
+      return slot;
+    }
+  }
+  return -1;
+}
+
+template <typename key_type, typename ref_counter_type, key_type empty_key, int set_associativity,
+          int slab_size, typename set_hasher>
+size_t cpu_cache<key_type, ref_counter_type, empty_key, set_associativity, slab_size,
+                 set_hasher>::num_threads_for_(const size_t len) const {
+  return std::max<size_t>(std::min(num_threads_, len / min_keys_per_thread_), 1);
+}
+
+template <typename key_type, typename ref_counter_type, key_type empty_key, int set_associativity,
+          int slab_size, typename set_hasher>
+void cpu_cache<key_type, ref_counter_type, empty_key, set_associativity, slab_size,
+               set_hasher>::Query(const key_type* const h_keys, const size_t len,
+                                  float* const h_values, uint64_t* const h_missing_index,
+                                  key_type* const h_missing_keys, size_t* const h_missing_len,
+                                  cudaStream_t stream, const size_t task_per_warp_tile) {
+  // Check if it is a valid query
+  if (len == 0) {
+    *h_missing_len = 0;
+    return;
+  }
+
+  // Update the global counter as user perform a new(most recent) read operation to the cache
+  const ref_counter_type now = global_counter_.fetch_add(1, std::memory_order_relaxed) + 1;
+
+  std::atomic<size_t> missing_len{0};
+  const size_t num_threads = num_threads_for_(len);
+#pragma omp parallel for num_threads(num_threads) schedule(static) if (num_threads > 1)
+  for (size_t i = 0; i < len; ++i) {
+    const key_type key = h_keys[i];
+    const uint32_t hash = set_hasher::hash(key);
+    const size_t set = hash % capacity_in_set_;
+
+    int slot = -1;
+    {
+      std::shared_lock<std::shared_mutex> lock(lock_of_(set));
+      slot = key == empty_key ? -1 : find_(set, key, tag_of(hash));
+      if (slot >= 0) {
+        // Touch and refresh the hitting slot
+        const size_t index = set * slots_per_set + slot;
+        slot_counter_[index].store(now, std::memory_order_relaxed);
+        std::memcpy(&h_values[i * embedding_vec_size_], &vals_[index * embedding_vec_size_],
+                    sizeof(float) * embedding_vec_size_);
+      }
+    }
+
+    if (slot < 0) {
+      const size_t missing_idx = missing_len.fetch_add(1, std::memory_order_relaxed);
+      h_missing_index[missing_idx] = i;
+      h_missing_keys[missing_idx] = key;
+    }
+  }
+  *h_missing_len = missing_len.load(std::memory_order_relaxed);
+}
+
+template <typename key_type, typename ref_counter_type, key_type empty_key, int set_associativity,
+          int slab_size, typename set_hasher>
+void cpu_cache<key_type, ref_counter_type, empty_key, set_associativity, slab_size,
+               set_hasher>::Replace(const key_type* const h_keys, const size_t len,
+                                    const float* const h_values, cudaStream_t stream,
+                                    const size_t task_per_warp_tile) {
+  // Check if it is a valid replacement
+  if (len == 0) {
+    return;
+  }
+
+  const ref_counter_type now = global_counter_.load(std::memory_order_relaxed);
+
+  // Try to insert the <k,v> paris into the cache as long as there are unused slot
+  // Then replace the <k,v> pairs into the cache
+  const size_t num_threads = num_threads_for_(len);
+#pragma omp parallel for num_threads(num_threads) schedule(static) if (num_threads > 1)
+  for (size_t i = 0; i < len; ++i) {
+    const key_type key = h_keys[i];
+    if (key == empty_key) {
+      continue;
+    }
+    const uint32_t hash = set_hasher::hash(key);
+    const size_t set = hash % capacity_in_set_;
+    const uint8_t tag = tag_of(hash);
+    const size_t first_slot = set * slots_per_set;
+
+    std::unique_lock<std::shared_mutex> lock(lock_of_(set));
+
+    // If found target key, the insertion/replace is no longer needed. Refresh the slot.
+    int slot = find_(set, key, tag);
+    if (slot >= 0) {
+      slot_counter_[first_slot + slot].store(now, std::memory_order_relaxed);
+      continue;
+    }
+
+    // Use an unused slot, or else the least recently used one.
+    const uint64_t unused = match_tags(&tags_[first_slot], 0);
+    if (unused) {
+      slot = __builtin_ctzll(unused);
+    } else {
+      ref_counter_type min_slot_counter_val = std::numeric_limits<ref_counter_type>::max();
+      for (size_t j = 0; j < slots_per_set; ++j) {
+        const ref_counter_type counter =
+            slot_counter_[first_slot + j].load(std::memory_order_relaxed);
+        if (counter < min_slot_counter_val) {
+          min_slot_counter_val = counter;
+          slot = static_cast<int>(j);
+        }
+      }
+    }
+
+    const size_t index = first_slot + slot;
+    tags_[index] = tag;
+    keys_[index] = key;
+    slot_counter_[index].store(now, std::memory_order_relaxed);
+    std::memcpy(&vals_[index * embedding_vec_size_], &h_values[i * embedding_vec_size_],
+                sizeof(float) * embedding_vec_size_);
+  }
+}
+
+template <typename key_type, typename ref_counter_type, key_type empty_key, int set_associativity,
+          int slab_size, typename set_hasher>
+void cpu_cache<key_type, ref_counter_type, empty_key, set_associativity, slab_size,
+               set_hasher>::Update(const key_type* const h_keys, const size_t len,
+                                   const float* const h_values, cudaStream_t stream,
+                                   const size_t task_per_warp_tile) {
+  // Check if it is a valid update request
+  if (len == 0) {
+    return;
+  }
+
+  const size_t num_threads = num_threads_for_(len);
+#pragma omp parallel for num_threads(num_threads) schedule(static) if (num_threads > 1)
+  for (size_t i = 0; i < len; ++i) {
+    const key_type key = h_keys[i];
+    if (key == empty_key) {
+      continue;
+    }
+    const uint32_t hash = set_hasher::hash(key);
+    const size_t set = hash % capacity_in_set_;
+
+    std::unique_lock<std::shared_mutex> lock(lock_of_(set));
+    const int slot = find_(set, key, tag_of(hash));
+    if (slot >= 0) {
+      const size_t index = set * slots_per_set + slot;
+      std::memcpy(&vals_[index * embedding_vec_size_], &h_values[i * embedding_vec_size_],
+                  sizeof(float) * embedding_vec_size_);
+    }
+  }
+}
+
+template <typename key_type, typename ref_counter_type, key_type empty_key, int set_associativity,
+          int slab_size, typename set_hasher>
+void cpu_cache<key_type, ref_counter_type, empty_key, set_associativity, slab_size,
+               set_hasher>::Dump(key_type* const h_keys, size_t* const h_dump_counter,
+                                 const size_t start_set_index, const size_t end_set_index,
+                                 cudaStream_t stream) {
+  // Check if it is a valid dump request
+  if (start_set_index >= capacity_in_set_) {
+    printf("Error: Invalid value for start_set_index. Nothing dumped.\n");
+    return;
+  }
+  if (end_set_index <= start_set_index || end_set_index > capacity_in_set_) {
+    printf("Error: Invalid value for end_set_index. Nothing dumped.\n");
+    return;
+  }
+
+  size_t dump_counter = 0;
+  for (size_t set = start_set_index; set < end_set_index; ++set) {
+    const size_t first_slot = set * slots_per_set;
+    std::shared_lock<std::shared_mutex> lock(lock_of_(set));
+    for (uint64_t mask = ~match_tags(&tags_[first_slot], 0); mask; mask &= mask - 1) {
+      const int slot = __builtin_ctzll(mask);
+      if (slot >= static_cast<int>(slots_per_set)) {
+        break;
+      }
+      h_keys[dump_counter++] = keys_[first_slot + slot];
+    }
+  }
+  *h_dump_counter = dump_counter;
+}
+
+template class cpu_cache<unsigned int, uint64_t, std::numeric_limits<unsigned int>::max(),
+                         SET_ASSOCIATIVITY, SLAB_SIZE>;
+template class cpu_cache<long long, uint64_t, std::numeric_limits<long long>::max(),
+                         SET_ASSOCIATIVITY, SLAB_SIZE>;
+}  // namespace gpu_cache
@@ -29,6 +29,7 @@
 #include <tensorflow/core/framework/op_kernel.h>
 
 #include <hps/plugin/facade.hpp>
+#include <hps/plugin/lookup_executor.hpp>
 
 namespace tensorflow {
 
@@ -42,14 +43,18 @@ using namespace stream_executor::cuda;
 template <typename Device>
 class Lookup : public AsyncOpKernel {
  public:
-  explicit Lookup(OpKernelConstruction *ctx) : AsyncOpKernel(ctx), thread_pool_("", 1) {
+  explicit Lookup(OpKernelConstruction *ctx) : AsyncOpKernel(ctx) {
     OP_REQUIRES_OK(ctx, ctx->GetAttr("model_name", &model_name_));
     OP_REQUIRES_OK(ctx, ctx->GetAttr("table_id", &table_id_));
     OP_REQUIRES_OK(ctx, ctx->GetAttr("emb_vec_size", &emb_vec_size_));
   }
 
   void ComputeAsync(OpKernelContext *ctx, DoneCallback done) override {
-    auto work_func = [this, ctx, done]() {
+    Tensor const *global_replica_id_tensor = nullptr;
+    OP_REQUIRES_OK_ASYNC(ctx, ctx->input("global_replica_id", &global_replica_id_tensor), done);
+    const int32_t global_replica_id_value = global_replica_id_tensor->scalar<int32_t>()();
+
+    auto work_func = [this, ctx, done, global_replica_id_value]() {
       auto stream = ctx->op_device_context()->stream();
       ScopedActivateExecutorContext scoped_activation{stream->parent()};
       cudaStream_t gpu_stream = AsGpuStreamValue(stream);
@@ -63,10 +68,6 @@ class Lookup : public AsyncOpKernel {
       Tensor const *values_tensor = nullptr;
       OP_REQUIRES_OK_ASYNC(ctx, ctx->input("values", &values_tensor), done);
 
-      Tensor const *global_replica_id_tensor = nullptr;
-      OP_REQUIRES_OK_ASYNC(ctx, ctx->input("global_replica_id", &global_replica_id_tensor), done);
-      const int32_t global_replica_id_value = global_replica_id_tensor->scalar<int32_t>()();
-
       // allocate output
       Tensor *emb_vector_tensor = nullptr;
       TensorShape emb_vector_tensor_shape = values_tensor->shape();
@@ -92,14 +93,14 @@ class Lookup : public AsyncOpKernel {
       }
       done();
     };
-    thread_pool_.submit(work_func);
+    // Shared by all Lookup ops, so that concurrent lookups are served in parallel.
+    LookupExecutor::shared().submit(model_name_, table_id_, global_replica_id_value, work_func);
   }
 
  private:
   std::string model_name_;
   tensorflow::int32 table_id_;
   tensorflow::int32 emb_vec_size_;
-  HugeCTR::ThreadPool thread_pool_;
 };
 
 #else
@@ -0,0 +1,151 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <embedding_cache_perf_test/host_key_generator.hpp>
+#include <gpu_cache/include/nv_cpu_cache.hpp>
+#include <gpu_cache/include/nv_gpu_cache.hpp>
+#include <hps/unique_op/cpu_unique_op.hpp>
+#include <iostream>
+#include <limits>
+#include <thread>
+#include <vector>
+
+namespace {
+constexpr size_t ONE_GiB = 1024 * 1024 * 1024;
+constexpr size_t num_key_candidates = 10000000;
+constexpr size_t key_range = num_key_candidates;
+constexpr size_t embedding_vec_size = 128;
+constexpr size_t num_sets = 15625;
+constexpr size_t num_keys_to_fill = 1000000;
+constexpr size_t max_batch_size = 4096;
+constexpr int repeat_times = 10;
+constexpr int seed = 4711;
+
+// Same flow as `EcTestHelper` (ec_test_helper.cuh), on the host: deduplicate the keys, query the
+// cache, and expand the vectors back to the original key order. The misses are then replaced, like
+// the embedding cache does after fetching them from the parameter server.
+template <typename key_type = long long>
+class CpuEcTestHelper {
+ public:
+  CpuEcTestHelper(size_t num_hot, float alpha, size_t num_threads)
+      : num_hot_(num_hot),
+        cache_(num_sets, embedding_vec_size, num_threads),
+        key_gen_(max_batch_size, num_hot, alpha, num_key_candidates, key_range, seed) {
+    const size_t query_length = max_batch_size * num_hot_;
+    h_values_.resize(query_length * embedding_vec_size);
+    h_missing_index_.resize(query_length);
+    h_missing_keys_.resize(query_length);
+    h_unique_keys_.resize(query_length);
+  }
+
+  void fill_cache(size_t len) {
+    for (size_t i = 0; i < len; i += max_batch_size * num_hot_) {
+      const auto keys = key_gen_.get_next_batch();
+      const size_t num_keys = std::min(max_batch_size * num_hot_, len - i);
+      cache_.Replace(keys.data(), num_keys, h_values_.data(), nullptr);
+    }
+  }
+
+  void test_query(size_t batch_size) {
+    const size_t num_query_keys = batch_size * num_hot_;
+    const auto keys = key_gen_.get_next_batch();
+
+    const auto start = std::chrono::steady_clock::now();
+    const size_t unique_len = unique_op_.unique(keys.data(), num_query_keys, h_unique_keys_.data());
+    size_t missing_len;
+    cache_.Query(h_unique_keys_.data(), unique_len, h_values_.data(), h_missing_index_.data(),
+                 h_missing_keys_.data(), &missing_len, nullptr);
+    unique_op_.expand(h_values_.data(), embedding_vec_size);
+    const auto end = std::chrono::steady_clock::now();
+    time_recorder_.push_back(std::chrono::duration<float, std::milli>(end - start).count());
+    missing_rate_recorder_.push_back(1.0f * missing_len / unique_len);
+
+    cache_.Replace(h_missing_keys_.data(), missing_len, h_values_.data(), nullptr);
+  }
+
+  std::vector<float> get_missing_rate() { return missing_rate_recorder_; }
+  std::vector<float> get_time_list() { return time_recorder_; }
+  size_t get_memory_read_in_bytes(size_t batch_size) {
+    return batch_size * num_hot_ * embedding_vec_size * sizeof(float);
+  }
+
+  void clear_results() {
+    missing_rate_recorder_.clear();
+    time_recorder_.clear();
+  }
+
+ private:
+  using Cache_t = gpu_cache::cpu_cache<key_type, uint64_t, std::numeric_limits<key_type>::max(),
+                                       SET_ASSOCIATIVITY, SLAB_SIZE>;
+
+  size_t num_hot_;
+  Cache_t cache_;
+  HugeCTR::unique_op::CpuUniqueOp<key_type> unique_op_;
+  HostKeyGenerator<key_type> key_gen_;
+
+  std::vector<float> h_values_;
+  std::vector<uint64_t> h_missing_index_;
+  std::vector<key_type> h_missing_keys_;
+  std::vector<key_type> h_unique_keys_;
+
+  std::vector<float> missing_rate_recorder_;
+  std::vector<float> time_recorder_;
+};
+
+void cpu_ec_perf_test(size_t num_hot, float alpha, size_t num_threads) {
+  CpuEcTestHelper<> test_helper(num_hot, alpha, num_threads);
+  for (int i = 0; i < repeat_times; i++) {
+    test_helper.fill_cache(num_keys_to_fill);
+  }
+  std::cout << "alpha: " << alpha << ", threads: " << num_threads << std::endl;
+  std::cout << "batch_size," << '\t' << "num_keys_in_query," << '\t' << "hit_rate," << '\t'
+            << "throughput" << std::endl;
+  for (size_t batch_size = max_batch_size; batch_size >= 256; batch_size /= 2) {
+    for (int i = 0; i < repeat_times; i++) {
+      test_helper.test_query(batch_size);
+    }
+    const auto time_list = test_helper.get_time_list();
+    std::vector<double> throughput_list;
+    for (const auto time : time_list) {
+      throughput_list.push_back(test_helper.get_memory_read_in_bytes(batch_size) * 2 /
+                                (time / 1000.0f) / ONE_GiB);
+    }
+    const auto max_throughput = *std::max_element(throughput_list.begin(), throughput_list.end());
+    const auto missing_rates = test_helper.get_missing_rate();
+    double hit_rate = 0;
+    for (const auto missing_rate : missing_rates) {
+      hit_rate += (1.0 - missing_rate) / missing_rates.size();
+    }
+    test_helper.clear_results();
+    EXPECT_GT(hit_rate, 0.0);
+    std::cout << batch_size << '\t' << batch_size * num_hot << '\t' << hit_rate << '\t'
+              << max_throughput << std::endl;
+  }
+}
+
+}  // namespace
+
+TEST(cpu_ec_perf_test, zipf_distribution) {
+  cpu_ec_perf_test(64, 1.05, std::max(std::thread::hardware_concurrency(), 1u));
+}
+TEST(cpu_ec_perf_test, zipf_distribution_1_thread) { cpu_ec_perf_test(64, 1.05, 1); }
+TEST(cpu_ec_perf_test, uniform_distribution) {
+  cpu_ec_perf_test(64, 0, std::max(std::thread::hardware_concurrency(), 1u));
+}
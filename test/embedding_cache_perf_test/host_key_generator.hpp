@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <random>
+#include <vector>
+
+#ifdef __CUDACC__
+#define KEY_GEN_HOST_DEVICE __host__ __device__ __forceinline__
+#else
+#define KEY_GEN_HOST_DEVICE inline
+#endif
+
+// Maps uniform random numbers in (0, 1] to keys in [0, num_key_candidates). The keys are either
+// uniformly distributed (alpha == 0), or follow a power law with exponent alpha. Shared by the
+// cuRAND-based `KeyGenerator` and `HostKeyGenerator`.
+template <typename key_type>
+struct KeyDistribution {
+  KeyDistribution(const float alpha, const size_t num_key_candidates)
+      : uniform(alpha == 0.0f),
+        gamma(1 - alpha),
+        pMax(std::pow(static_cast<float>(num_key_candidates), 1 - alpha)),
+        pMin(1.),  // assuming 1^gamma = 1 always hold
+        num_key_candidates(num_key_candidates) {}
+
+  KEY_GEN_HOST_DEVICE key_type operator()(const float random_number) const {
+    // 1 - random_number for turning (0, 1] to [0, 1) as generated by cuRand
+    if (uniform) {
+      return (key_type)((1 - random_number) * num_key_candidates);
+    }
+#ifdef __CUDA_ARCH__
+    return (key_type)__powf((1 - random_number) * (pMax - pMin) + pMin, 1. / gamma) - 1.0f;
+#else
+    return (key_type)std::pow((1 - random_number) * (pMax - pMin) + pMin, 1.f / gamma) - 1.0f;
+#endif
+  }
+
+  bool uniform;
+  float gamma;
+  float pMax;
+  float pMin;
+  size_t num_key_candidates;
+};
+
+// Host counterpart of `KeyGenerator` (key_generator.cuh), for benchmarking caches without a GPU.
+template <typename key_type>
+class HostKeyGenerator {
+ public:
+  HostKeyGenerator(const size_t batch_size, const size_t num_hot, const float alpha,
+                   const size_t num_key_candidates, const size_t key_range, const int seed = -1)
+      : batch_size_(batch_size),
+        num_hot_(num_hot),
+        key_range_(key_range),
+        distribution_(alpha, num_key_candidates),
+        gen_(seed == -1 ? static_cast<uint64_t>(time(NULL)) : static_cast<uint64_t>(seed)) {
+    h_keys_.resize(batch_size_ * num_hot_);
+  }
+
+  std::vector<key_type> get_next_batch() {
+    // Same range as curandGenerateUniform, (0, 1].
+    std::uniform_real_distribution<float> random_numbers(0.0f, 1.0f);
+    for (size_t i = 0; i < h_keys_.size(); i++) {
+      h_keys_[i] = map_key(distribution_(1.0f - random_numbers(gen_)));
+    }
+    return h_keys_;
+  }
+
+  uint64_t map_key(uint64_t key) { return key; }
+
+ private:
+  size_t batch_size_;
+  size_t num_hot_;
+  size_t key_range_;
+  KeyDistribution<key_type> distribution_;
+  std::mt19937_64 gen_;
+  std::vector<key_type> h_keys_;
+};
@@ -20,31 +20,19 @@
 #include <curand.h>
 
 #include <core23/logger.hpp>
+#include <embedding_cache_perf_test/host_key_generator.hpp>
 #include <iostream>
 #include <random>
 #include <stdexcept>
 #include <vector>
 
 template <typename key_type>
-__global__ void gen_keys_kernel(key_type* lookup_keys, bool uniform, const float alpha,
-                                float* random_numbers, const size_t lookup_length,
-                                const size_t num_key_candidates) {
+__global__ void gen_keys_kernel(key_type* lookup_keys, const KeyDistribution<key_type> distribution,
+                                float* random_numbers, const size_t lookup_length) {
   register size_t tId = blockIdx.x * blockDim.x + threadIdx.x, tNum = gridDim.x * blockDim.x;
-  if (uniform) {
 #pragma unroll
-    for (register size_t i = tId; i < lookup_length; i += tNum) {
-      lookup_keys[i] = (key_type)((1 - random_numbers[i]) * num_key_candidates);
-      // 1 - random_numbers[i] for turning (0, 1] to [0, 1) as generated by cuRand
-    }
-  } else {  // power-law
-    const float gamma = 1 - alpha;
-    const float pMax = __powf(num_key_candidates, gamma),
-                pMin = 1.;  // assuming 1^gamma = 1 always hold
-#pragma unroll
-    for (register size_t i = tId; i < lookup_length; i += tNum) {
-      lookup_keys[i] =
-          (key_type)__powf((1 - random_numbers[i]) * (pMax - pMin) + pMin, 1. / gamma) - 1.0f;
-    }
+  for (register size_t i = tId; i < lookup_length; i += tNum) {
+    lookup_keys[i] = distribution(random_numbers[i]);
   }
 }
 
@@ -91,10 +79,9 @@ class KeyGenerator {
 
   std::vector<key_type> get_next_batch() {
     HCTR_LIB_THROW(curandGenerateUniform(cu_generator_, d_random_numbers_, batch_size_ * num_hot_));
-    bool use_uniform = alpha_ == 0.0f;
     gen_keys_kernel<<<n_sm_ * max_block_num_per_sm_, 32, 0>>>(
-        d_keys_buffer_, use_uniform, alpha_, d_random_numbers_, batch_size_ * num_hot_,
-        num_key_candidates_);
+        d_keys_buffer_, KeyDistribution<key_type>(alpha_, num_key_candidates_), d_random_numbers_,
+        batch_size_ * num_hot_);
     HCTR_LIB_THROW(cudaMemcpy(h_keys_.data(), d_keys_buffer_,
                               sizeof(*d_keys_buffer_) * batch_size_ * num_hot_,
                               cudaMemcpyDeviceToHost));
@@ -16,9 +16,16 @@
 
 #include <gtest/gtest.h>
 
+#include <chrono>
 #include <common.hpp>
+#include <cstring>
 #include <data_readers/check_sum.hpp>
 #include <data_readers/file_source.hpp>
+#include <data_readers/mapped_file_source.hpp>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <random>
 
 using namespace HugeCTR;
 
@@ -65,3 +72,213 @@ TEST(checker, CheckSum) {
   // }
   EXPECT_EQ(strncmp(tmp1, str, NUM_CHAR), 0);
 }
+
+namespace {
+
+// Norm-like samples: a label and 13 dense features, followed by 26 slots with one key each.
+const int NUM_FLOATS = 14;
+const int NUM_SLOTS = 26;
+const int SAMPLE_SIZE = NUM_FLOATS * sizeof(float) + NUM_SLOTS * (sizeof(int) + sizeof(long long));
+
+void write_samples(const std::string& file, const size_t num_samples) {
+  std::mt19937 gen(42);
+  std::ofstream out_stream(file, std::ofstream::binary);
+  std::vector<char> sample(SAMPLE_SIZE);
+  for (size_t i = 0; i < num_samples; i++) {
+    for (auto& c : sample) {
+      c = static_cast<char>(gen());
+    }
+    // nnz of every slot is 1.
+    for (int slot = 0; slot < NUM_SLOTS; slot++) {
+      const int nnz = 1;
+      std::memcpy(&sample[NUM_FLOATS * sizeof(float) + slot * (sizeof(int) + sizeof(long long))],
+                  &nnz, sizeof(int));
+    }
+    const char sum = compute_check_sum(sample.data(), sample.size());
+    out_stream.write(reinterpret_cast<const char*>(&SAMPLE_SIZE), sizeof(int));
+    out_stream.write(sample.data(), sample.size());
+    out_stream.write(&sum, sizeof(char));
+  }
+  out_stream.close();
+
+  out_stream.open("file_list.txt", std::ofstream::out);
+  out_stream << "1\n" << file;
+  out_stream.close();
+}
+
+}  // namespace
+
+TEST(checker, compute_check_sum) {
+  std::mt19937 gen(7);
+  std::vector<char> data(5000);
+  for (auto& c : data) {
+    c = static_cast<char>(gen());
+  }
+  for (const size_t size : {0, 1, 7, 8, 9, 1023, 1024, 1025, 5000}) {
+    char expected = 0;
+    for (size_t i = 0; i < size; i++) {
+      expected += data[i];
+    }
+    EXPECT_EQ(compute_check_sum(data.data(), size), expected) << size;
+  }
+
+  // Worst case for lane overflows.
+  std::vector<char> ones(5000, static_cast<char>(0xFF));
+  EXPECT_EQ(compute_check_sum(ones.data(), ones.size()), static_cast<char>(5000 * 0xFF));
+}
+
+TEST(checker, MappedFileSource) {
+  const size_t num_samples = 1000;
+  write_samples("file2.txt", num_samples);
+
+  for (const bool use_mmap : {true, false}) {
+    // A small read size forces many refills.
+    FileSource file_source(0, 1, "file_list.txt", false);
+    MappedFileSource mapped_source(0, 1, "file_list.txt", false, use_mmap, 1000);
+    ASSERT_EQ(file_source.next_source(1), Error_t::Success);
+    ASSERT_EQ(mapped_source.next_source(1), Error_t::Success);
+
+    // Both sources return the same bytes, in pieces of varying sizes.
+    std::vector<char> expected(4096), actual(4096);
+    for (size_t size = 1;; size = size * 7 % 4001 + 1) {
+      const Error_t err = file_source.read(expected.data(), size);
+      ASSERT_EQ(mapped_source.read(actual.data(), size), err);
+      if (err != Error_t::Success) {
+        break;
+      }
+      ASSERT_EQ(std::memcmp(expected.data(), actual.data(), size), 0);
+    }
+    EXPECT_EQ(mapped_source.next_source(1), Error_t::EndOfFile);
+  }
+}
+
+TEST(checker, BlockCheckSum) {
+  const size_t num_samples = 1000;
+  write_samples("file3.txt", num_samples);
+
+  for (const bool use_mmap : {true, false}) {
+    MappedFileSource reference(0, 1, "file_list.txt", false, use_mmap);
+    MappedFileSource source(0, 1, "file_list.txt", false, use_mmap, 1000);
+    CheckSum check_sum(reference);
+    BlockCheckSum block_check_sum(source);
+    ASSERT_EQ(check_sum.next_source(1), Error_t::Success);
+    ASSERT_EQ(block_check_sum.next_source(1), Error_t::Success);
+
+    std::vector<BlockCheckSum::Sample> samples;
+    std::vector<char> expected(SAMPLE_SIZE);
+    size_t num_read = 0;
+    while (block_check_sum.read_block(64, samples) == Error_t::Success) {
+      for (const auto& sample : samples) {
+        ASSERT_EQ(sample.size, SAMPLE_SIZE);
+        ASSERT_EQ(check_sum.read(expected.data(), SAMPLE_SIZE), Error_t::Success);
+        ASSERT_EQ(std::memcmp(sample.data, expected.data(), SAMPLE_SIZE), 0);
+      }
+      num_read += samples.size();
+    }
+    EXPECT_EQ(num_read, num_samples);
+  }
+
+  // Flip one byte of the 100th sample.
+  {
+    std::fstream file("file3.txt", std::ios::binary | std::ios::in | std::ios::out);
+    file.seekp(99 * (sizeof(int) + SAMPLE_SIZE + 1) + sizeof(int) + 10);
+    file.put('x');
+  }
+  MappedFileSource source(0, 1, "file_list.txt", false);
+  BlockCheckSum block_check_sum(source);
+  ASSERT_EQ(block_check_sum.next_source(1), Error_t::Success);
+  std::vector<BlockCheckSum::Sample> samples;
+  EXPECT_EQ(block_check_sum.read_block(64, samples), Error_t::Success);
+  EXPECT_EQ(block_check_sum.read_block(64, samples), Error_t::DataCheckError);
+  EXPECT_EQ(block_check_sum.read_block(64, samples), Error_t::Success);
+
+  // Truncated files are reported.
+  std::filesystem::resize_file("file3.txt", 10 * (sizeof(int) + SAMPLE_SIZE + 1) + 100);
+  MappedFileSource truncated(0, 1, "file_list.txt", false);
+  BlockCheckSum truncated_check_sum(truncated);
+  ASSERT_EQ(truncated_check_sum.next_source(1), Error_t::Success);
+  EXPECT_EQ(truncated_check_sum.read_block(64, samples), Error_t::BrokenFile);
+}
+
+// Benchmark, disabled by default. Run it with --gtest_also_run_disabled_tests.
+TEST(checker, DISABLED_source_throughput) {
+  const size_t num_samples = 200000;
+  write_samples("file4.txt", num_samples);
+
+  // Read the fields of each sample, like the Norm reader does.
+  auto run = [num_samples](const char* name, auto&& read_sample) {
+    const auto begin = std::chrono::steady_clock::now();
+    size_t n = 0;
+    while (read_sample()) {
+      ++n;
+    }
+    const double elapsed_s =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    EXPECT_EQ(n, num_samples) << name;
+    const double samples_per_s = static_cast<double>(n) / elapsed_s;
+    std::cout << name << ": " << samples_per_s << " samples/s" << std::endl;
+    return samples_per_s;
+  };
+
+  float dense[NUM_FLOATS];
+  unsigned long long key_sum = 0;
+  unsigned long long expected_key_sum = 0;
+
+  FileSource file_source(0, 1, "file_list.txt", false);
+  CheckSum check_sum(file_source);
+  ASSERT_EQ(check_sum.next_source(1), Error_t::Success);
+  size_t num_stream_samples = 0;
+  const double stream_rate = run("FileSource + CheckSum", [&]() {
+    // CheckSum cannot tell the end of the file from a broken sample.
+    if (num_stream_samples++ == num_samples ||
+        check_sum.read(reinterpret_cast<char*>(dense), sizeof(dense)) != Error_t::Success) {
+      return false;
+    }
+    for (int slot = 0; slot < NUM_SLOTS; slot++) {
+      int nnz;
+      long long key;
+      check_sum.read(reinterpret_cast<char*>(&nnz), sizeof(int));
+      if (check_sum.read(reinterpret_cast<char*>(&key), nnz * sizeof(long long)) !=
+          Error_t::Success) {
+        return false;
+      }
+      expected_key_sum += key;
+    }
+    return true;
+  });
+
+  for (const bool use_mmap : {true, false}) {
+    MappedFileSource source(0, 1, "file_list.txt", false, use_mmap);
+    BlockCheckSum block_check_sum(source);
+    ASSERT_EQ(block_check_sum.next_source(1), Error_t::Success);
+    std::vector<BlockCheckSum::Sample> samples;
+    size_t i = 0;
+    key_sum = 0;
+    const double block_rate =
+        run(use_mmap ? "MappedFileSource (mmap) + BlockCheckSum"
+                     : "MappedFileSource (pread) + BlockCheckSum",
+            [&]() {
+              if (i == samples.size()) {
+                i = 0;
+                if (block_check_sum.read_block(1024, samples) != Error_t::Success) {
+                  return false;
+                }
+              }
+              const char* ptr = samples[i++].data;
+              std::memcpy(dense, ptr, sizeof(dense));
+              ptr += sizeof(dense);
+              for (int slot = 0; slot < NUM_SLOTS; slot++) {
+                int nnz;
+                long long key;
+                std::memcpy(&nnz, ptr, sizeof(int));
+                std::memcpy(&key, ptr + sizeof(int), nnz * sizeof(long long));
+                ptr += sizeof(int) + nnz * sizeof(long long);
+                key_sum += key;
+              }
+              return true;
+            });
+    EXPECT_EQ(key_sum, expected_key_sum);
+    EXPECT_GT(block_rate, stream_rate);
+  }
+  std::filesystem::remove("file4.txt");
+}
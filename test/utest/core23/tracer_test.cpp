@@ -0,0 +1,147 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <core23/logger.hpp>
+#include <core23/tracer.hpp>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using namespace HugeCTR;
+
+size_t count(const std::string& s, const std::string& pattern) {
+  size_t n = 0;
+  for (size_t pos = s.find(pattern); pos != std::string::npos; pos = s.find(pattern, pos + 1)) {
+    ++n;
+  }
+  return n;
+}
+
+std::string dump() {
+  std::ostringstream os;
+  Tracer::get().dump(os);
+  return os.str();
+}
+
+class tracer : public testing::Test {
+ protected:
+  void SetUp() override {
+    Tracer::get().disable();
+    Tracer::get().clear();
+  }
+  void TearDown() override {
+    Tracer::get().disable();
+    Tracer::get().clear();
+  }
+};
+
+TEST_F(tracer, records_nothing_while_disabled) {
+  {
+    HCTR_TRACE_SCOPE("disabled");
+  }
+  EXPECT_EQ(Tracer::get().num_events(), 0);
+  EXPECT_EQ(count(dump(), "\"disabled\""), 0);
+}
+
+TEST_F(tracer, records_nested_scopes) {
+  Tracer::get().enable();
+  {
+    HCTR_TRACE_SCOPE("outer");
+    for (int i = 0; i < 3; ++i) {
+      HCTR_TRACE_SCOPE("inner");
+      std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+  }
+  Tracer::get().disable();
+  {
+    HCTR_TRACE_SCOPE("disabled");
+  }
+
+  EXPECT_EQ(Tracer::get().num_events(), 4);
+  const std::string json = dump();
+  EXPECT_EQ(json.find("{\"displayTimeUnit\":\"ms\",\"traceEvents\":["), 0);
+  EXPECT_EQ(count(json, "\"outer\",\"ph\":\"X\""), 1);
+  EXPECT_EQ(count(json, "\"inner\",\"ph\":\"X\""), 3);
+  EXPECT_EQ(count(json, "\"disabled\""), 0);
+  EXPECT_EQ(count(json, "\"thread_name\""), 1);
+}
+
+TEST_F(tracer, separates_threads) {
+  Tracer::get().enable();
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([t]() {
+      Logger::set_thread_name("worker " + std::to_string(t));
+      for (int i = 0; i < 1000; ++i) {
+        HCTR_TRACE_SCOPE("work");
+      }
+    });
+  }
+
+  // Dumping concurrently with recording is allowed.
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_FALSE(dump().empty());
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  // Events of exited threads are kept.
+  EXPECT_EQ(Tracer::get().num_events(), 4000);
+  const std::string json = dump();
+  for (int t = 0; t < 4; ++t) {
+    EXPECT_EQ(count(json, "{\"name\":\"worker " + std::to_string(t) + "\"}"), 1);
+  }
+}
+
+TEST_F(tracer, overwrites_oldest_events) {
+  Tracer::get().enable();
+  const size_t n = Tracer::default_buffer_size + 10;
+  std::thread thread([n]() {
+    for (size_t i = 0; i < n; ++i) {
+      const int64_t t = static_cast<int64_t>(i);
+      Tracer::get().record(i < 10 ? "old" : "new", t, t + 1);
+    }
+  });
+  thread.join();
+
+  EXPECT_EQ(Tracer::get().num_events(), Tracer::default_buffer_size);
+  EXPECT_EQ(Tracer::get().num_dropped(), 10);
+  const std::string json = dump();
+  EXPECT_EQ(count(json, "\"old\""), 0);
+  EXPECT_EQ(count(json, "\"new\""), Tracer::default_buffer_size);
+}
+
+TEST_F(tracer, disabled_markers_are_cheap) {
+  const size_t n = 10000000;
+  const auto begin = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < n; ++i) {
+    HCTR_TRACE_SCOPE("disabled");
+  }
+  const double ns =
+      std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin).count();
+  std::cout << "disabled marker: " << ns / n << " ns" << std::endl;
+  EXPECT_EQ(Tracer::get().num_events(), 0);
+}
+
+}  // namespace
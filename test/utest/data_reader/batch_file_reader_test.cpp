@@ -0,0 +1,205 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <data_readers/multi_hot/detail/batch_file_reader.hpp>
+#include <data_readers/raw_async_repacker.hpp>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <utest/data_reader/batch_file_reader_test_utils.hpp>
+#include <vector>
+
+using namespace HugeCTR;
+using namespace HugeCTR::batch_file_reader_test;
+
+namespace {
+
+const std::string test_dir{"./batch_file_reader_test"};
+
+// Writes `data` RAID-0 striped over one file per directory.
+std::vector<std::string> write_striped(const std::vector<char>& data,
+                                       const std::vector<std::string>& dirs,
+                                       size_t stripe_size_bytes) {
+  std::vector<std::string> stripes;
+  std::vector<std::ofstream> files;
+  for (const auto& dir : dirs) {
+    std::filesystem::create_directories(dir);
+    stripes.push_back(dir + "/striped.bin");
+    files.emplace_back(stripes.back(), std::ios::binary);
+  }
+  for (size_t unit = 0; unit * stripe_size_bytes < data.size(); ++unit) {
+    const size_t size = std::min(stripe_size_bytes, data.size() - unit * stripe_size_bytes);
+    files[unit % files.size()].write(data.data() + unit * stripe_size_bytes, size);
+  }
+  return stripes;
+}
+
+std::vector<std::string> stripe_dirs(size_t num_stripes) {
+  std::vector<std::string> dirs;
+  for (size_t i = 0; i < num_stripes; ++i) {
+    dirs.push_back(test_dir + "/d" + std::to_string(i));
+  }
+  return dirs;
+}
+
+void striped_test(size_t num_stripes, size_t stripe_size_bytes, size_t batch_size_bytes,
+                  size_t num_shards, size_t shard_granularity_bytes) {
+  const size_t file_size = batch_size_bytes * 20 + 777;
+  const std::vector<char> data = make_data(file_size);
+
+  std::filesystem::create_directories(test_dir);
+  const std::string plain = test_dir + "/plain.bin";
+  write_file(plain, data);
+  const std::vector<std::string> stripes =
+      write_striped(data, stripe_dirs(num_stripes), stripe_size_bytes);
+
+  BatchLocations locations(batch_size_bytes, 0, file_size);
+  auto plain_shards = locations.shard(num_shards, shard_granularity_bytes);
+  auto striped_shards = locations.shard(num_shards, shard_granularity_bytes);
+  ASSERT_EQ(plain_shards.size(), striped_shards.size());
+
+  for (size_t shard = 0; shard < plain_shards.size(); ++shard) {
+    const size_t num_batches = plain_shards[shard]->count();
+    BatchFileReader plain_reader(plain, 0, 4, std::move(plain_shards[shard]));
+    BatchFileReader striped_reader(stripes, stripe_size_bytes, 0, 4,
+                                   std::move(striped_shards[shard]));
+
+    const auto expected = read_epoch(plain_reader, num_batches);
+    const auto actual = read_epoch(striped_reader, num_batches);
+    ASSERT_EQ(expected.size(), actual.size());
+    for (const auto& [id, batch] : expected) {
+      ASSERT_EQ(actual.at(id), batch) << "shard " << shard << ", batch " << id;
+    }
+  }
+  std::filesystem::remove_all(test_dir);
+}
+
+}  // namespace
+
+TEST(batch_file_reader, single_stripe) { striped_test(1, 4096, 40000, 1, 1); }
+TEST(batch_file_reader, two_stripes) { striped_test(2, 4096, 40000, 1, 1); }
+TEST(batch_file_reader, three_stripes_sharded) { striped_test(3, 8192, 50000, 3, 100); }
+TEST(batch_file_reader, eight_stripes_small_units) { striped_test(8, 4096, 100000, 2, 10); }
+TEST(batch_file_reader, units_larger_than_batch) { striped_test(4, 65536, 12345, 1, 1); }
+
+TEST(batch_file_reader, invalid_stripe_size) {
+  std::filesystem::create_directories(test_dir);
+  const std::vector<char> data = make_data(100000);
+  const auto stripes = write_striped(data, stripe_dirs(2), 4096);
+  EXPECT_THROW(BatchFileReader(stripes, 1000, 0, 4,
+                               std::make_unique<BatchLocations>(10000, 0, data.size())),
+               std::invalid_argument);
+  EXPECT_THROW(
+      BatchFileReader(stripes, 0, 0, 4, std::make_unique<BatchLocations>(10000, 0, data.size())),
+      std::invalid_argument);
+  std::filesystem::remove_all(test_dir);
+}
+
+TEST(batch_file_reader, reads_repacker_output) {
+  RawAsyncRepackerParams params;
+  params.format = DataReaderType_t::RawAsync;
+  params.label_dim = 1;
+  params.dense_dim = 3;
+  params.nnz_array = {2, 1};
+  params.float_label_dense = false;
+  params.float_output_label_dense = false;
+  params.output_dirs = stripe_dirs(3);
+  params.stripe_size_bytes = 8192;
+  params.block_size_bytes = 65536;
+  params.num_threads = 2;
+
+  const size_t num_samples = 10000;
+  RawAsyncRepacker repacker(params);
+  std::vector<char> data = make_data(num_samples * repacker.sample_size_bytes());
+  std::filesystem::create_directories(test_dir);
+  const std::string input = test_dir + "/input.bin";
+  write_file(input, data);
+  for (const auto& dir : params.output_dirs) {
+    std::filesystem::create_directories(dir);
+  }
+  repacker.repack({input}, "repacked");
+  const auto files = repacker.output_files("repacked");
+  ASSERT_EQ(files.size(), 1);
+
+  const size_t batch_size_bytes = 128 * repacker.sample_size_bytes();
+  auto locations = std::make_unique<BatchLocations>(batch_size_bytes, 0, data.size());
+  const size_t num_batches = locations->count();
+  BatchFileReader reader(files[0].stripes, params.stripe_size_bytes, 0, 8, std::move(locations));
+  const auto batches = read_epoch(reader, num_batches);
+  for (const auto& [id, batch] : batches) {
+    ASSERT_EQ(batch, std::string(data.data() + id * batch_size_bytes, batch.size()));
+  }
+  std::filesystem::remove_all(test_dir);
+}
+
+// Read throughput with 1 to 8 stripes. The stripes go to the directories in HCTR_STRIPE_DIRS
+// (separated by ':'), so that each can be on a different device, and to the test directory
+// otherwise, which only measures the overhead of splitting the reads.
+TEST(batch_file_reader, striping_benchmark) {
+  std::vector<std::string> devices;
+  if (const char* env = std::getenv("HCTR_STRIPE_DIRS")) {
+    std::stringstream ss(env);
+    for (std::string dir; std::getline(ss, dir, ':');) {
+      devices.push_back(dir + "/batch_file_reader_test");
+    }
+  } else {
+    devices = stripe_dirs(8);
+  }
+
+  const size_t stripe_size_bytes = 1 << 20;
+  const size_t batch_size_bytes = 8 << 20;
+  const size_t file_size = 64 * batch_size_bytes;
+  const std::vector<char> data = make_data(file_size);
+
+  for (size_t num_stripes = 1; num_stripes <= 8; ++num_stripes) {
+    std::vector<std::string> dirs;
+    for (size_t i = 0; i < num_stripes; ++i) {
+      dirs.push_back(devices[i % devices.size()] + "/" + std::to_string(i));
+    }
+    const auto stripes = write_striped(data, dirs, stripe_size_bytes);
+
+    auto locations = std::make_unique<BatchLocations>(batch_size_bytes, 0, file_size);
+    const size_t num_batches = locations->count();
+    BatchFileReader reader(stripes, stripe_size_bytes, 0, 8, std::move(locations));
+
+    const auto start = std::chrono::high_resolution_clock::now();
+    size_t num_read = 0;
+    while (num_read < num_batches) {
+      for (const auto batch : reader.read_batches(1000)) {
+        num_read++;
+        reader.release_batch(batch);
+      }
+    }
+    const auto end = std::chrono::high_resolution_clock::now();
+    const double seconds = std::chrono::duration<double>(end - start).count();
+    std::cout << "stripes: " << num_stripes << ", Time (ms): " << seconds * 1000
+              << ", Throughput (GB/s): " << file_size / 1e9 / seconds << std::endl;
+
+    for (const auto& dir : dirs) {
+      std::filesystem::remove_all(dir);
+    }
+  }
+  for (const auto& device : devices) {
+    std::filesystem::remove_all(device);
+  }
+  std::filesystem::remove_all(test_dir);
+}
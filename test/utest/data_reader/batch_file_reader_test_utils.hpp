@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstring>
+#include <data_readers/multi_hot/detail/batch_file_reader.hpp>
+#include <data_readers/raw_async_packed.hpp>
+#include <fstream>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace HugeCTR {
+
+namespace batch_file_reader_test {
+
+// Random letters, so that mismatches are easy to read.
+inline std::vector<char> make_data(size_t size) {
+  std::vector<char> data(size);
+  std::mt19937 gen(424242);
+  std::uniform_int_distribution<int> dis('a', 'z');
+  for (auto& c : data) {
+    c = static_cast<char>(dis(gen));
+  }
+  return data;
+}
+
+// Criteo-like samples: a 0/1 label, small integer dense values, and keys drawn from a per-slot
+// range. The last slot uses the full key range, so that it can't be packed.
+inline std::vector<uint8_t> make_samples(const RawAsyncPackedLayout& layout, size_t num_samples) {
+  std::vector<uint8_t> samples(num_samples * layout.sample_size_bytes());
+  std::mt19937_64 gen(424242);
+  uint8_t* sample = samples.data();
+  for (size_t i = 0; i < num_samples; ++i) {
+    const int32_t label = gen() % 4 == 0;
+    std::memcpy(sample, &label, 4);
+    for (size_t j = 1; j < layout.label_dense_dim; ++j) {
+      const int32_t value = gen() % 100;
+      std::memcpy(sample + j * 4, &value, 4);
+    }
+    uint8_t* keys = sample + layout.label_dense_dim * 4;
+    for (size_t j = 0; j < layout.num_keys; ++j) {
+      uint64_t key = gen();
+      if (j + 1 < layout.num_keys) {
+        key = (j << 24) + key % (uint64_t{1} << (2 + j));
+      }
+      std::memcpy(keys + j * layout.key_bytes, &key, layout.key_bytes);
+    }
+    sample += layout.sample_size_bytes();
+  }
+  return samples;
+}
+
+template <typename T>
+void write_file(const std::string& file_name, const std::vector<T>& data) {
+  std::ofstream file(file_name, std::ios::binary);
+  file.write(reinterpret_cast<const char*>(data.data()), data.size() * sizeof(T));
+}
+
+// Reads one epoch and returns the data of each shard by batch id.
+inline std::map<size_t, std::string> read_epoch(BatchFileReader& reader, size_t num_batches) {
+  std::map<size_t, std::string> batches;
+  while (batches.size() < num_batches) {
+    for (const auto batch : reader.read_batches(1000)) {
+      EXPECT_EQ(batches.count(batch->batch_id), 0);
+      batches[batch->batch_id] =
+          std::string(reinterpret_cast<const char*>(batch->data), batch->shard_size_bytes);
+      reader.release_batch(batch);
+    }
+  }
+  return batches;
+}
+
+}  // namespace batch_file_reader_test
+
+}  // namespace HugeCTR
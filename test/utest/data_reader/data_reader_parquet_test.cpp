@@ -302,7 +302,8 @@ void generate_parquet_input_files(int num_files, int sample_per_file,
 
 void data_reader_group_iter_strided_batch_test_impl(int num_files, long long sample_per_file,
                                                     const int batchsize,
-                                                    std::vector<int> device_list, int iter) {
+                                                    std::vector<int> device_list, int iter,
+                                                    size_t cpu_decoder_threads = 0) {
   auto p_mr = rmm::mr::get_current_device_resource();
   std::vector<bool> is_mhot(26, false);
   // following dense_dim has excluded label
@@ -349,7 +350,7 @@ void data_reader_group_iter_strided_batch_test_impl(int num_files, long long sam
                             device_list.size(), false);
   data_reader.create_drwg_parquet(file_list_name, false, slot_offset, true,
                                   sample_per_file + batchsize, label_dim + dense_dim_array.size(),
-                                  label_dim + dense_dim);
+                                  label_dim + dense_dim, cpu_decoder_threads);
 
   std::vector<size_t> nnz_offset(local_gpu_count, 0);
   std::vector<size_t> sample_offset(local_gpu_count, 0);
@@ -620,7 +621,8 @@ void data_reader_group_iter_squential_batch_test_impl(int num_files, long long s
 }
 void data_reader_group_epoch_strided_batch_test_impl(int num_files, long long sample_per_file,
                                                      const int batchsize,
-                                                     std::vector<int> device_list, int epochs) {
+                                                     std::vector<int> device_list, int epochs,
+                                                     size_t cpu_decoder_threads = 0) {
   auto p_mr = rmm::mr::get_current_device_resource();
   std::vector<bool> is_mhot(26, false);
   // following dense_dim has excluded label
@@ -661,7 +663,7 @@ void data_reader_group_epoch_strided_batch_test_impl(int num_files, long long sa
 
   data_reader.create_drwg_parquet(file_list_name, false, slot_offset, false,
                                   sample_per_file + batchsize, label_dim + dense_dim_array.size(),
-                                  label_dim + dense_dim);
+                                  label_dim + dense_dim, cpu_decoder_threads);
 
   std::vector<size_t> nnz_offset(local_gpu_count, 0);
   std::vector<size_t> sample_offset(local_gpu_count, 0);
@@ -1309,6 +1311,21 @@ TEST(parquet, group_test_comprehensive_strided_epoch) {
   HCTR_LOG(INFO, WORLD, "8, 51220, 4096,{0, 1,2,3,4,5,6,7}, 2 done\n");
 }
 
+//* ====== ====== ====== ====== ====== ====== CPU decoder ====== ====== ====== ====== ====== ======
+//====== *//
+TEST(parquet, group_test_cpu_decoder_strided_iter) {
+  data_reader_group_iter_strided_batch_test_impl(4, 2048, 1026, {0, 1}, 10, 1);
+  HCTR_LOG(INFO, WORLD, "4, 2048, 1026, {0, 1}, 10, 1 thread done\n");
+  data_reader_group_iter_strided_batch_test_impl(6, 40960, 1048, {0, 1}, 100, 4);
+  HCTR_LOG(INFO, WORLD, "6, 40960, 1048, {0, 1}, 100, 4 threads done\n");
+}
+TEST(parquet, group_test_cpu_decoder_strided_epoch) {
+  data_reader_group_epoch_strided_batch_test_impl(3, 40, 3 * 10, {0, 1}, 2, 1);
+  HCTR_LOG(INFO, WORLD, "3, 40, 3*10, {0,1}, 2, 1 thread done\n");
+  data_reader_group_epoch_strided_batch_test_impl(7, 172, 6 * 8, {1, 3, 4, 7}, 3, 4);
+  HCTR_LOG(INFO, WORLD, "7, 172, 6*8, {1,3,4,7}, 3, 4 threads done\n");
+}
+
 //* ====== ====== ====== ====== ====== ====== epoch seq ====== ====== ====== ====== ====== ======
 //====== *//
 TEST(parquet, group_test_debug_sequential_epoch) {
@@ -0,0 +1,198 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstring>
+#include <data_readers/multi_hot/detail/batch_file_reader.hpp>
+#include <data_readers/multi_hot/detail/host_batch_cache.hpp>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <utest/data_reader/batch_file_reader_test_utils.hpp>
+#include <vector>
+
+using namespace HugeCTR;
+using namespace HugeCTR::batch_file_reader_test;
+
+namespace {
+
+const std::string test_dir{"./host_batch_cache_test"};
+const size_t sample_size_bytes = 40 * 4;
+
+// A label, 13 dense values and 26 keys from small per-slot ranges, so that slabs compress.
+std::vector<uint8_t> make_samples(size_t num_samples) {
+  return batch_file_reader_test::make_samples({14, 26, 4}, num_samples);
+}
+
+void cache_slabs_test(bool compress) {
+  HostCacheParams params;
+  params.enabled = true;
+  params.compress = compress;
+  HostBatchCache cache(params);
+  const size_t source = cache.add_source(sample_size_bytes);
+
+  const auto samples = make_samples(1000);
+  const size_t slab_size = 100 * sample_size_bytes;
+  std::vector<uint8_t> slab(slab_size);
+  EXPECT_FALSE(cache.load(source, 0, slab_size, slab.data()));
+  for (size_t offset = 0; offset < samples.size(); offset += slab_size) {
+    EXPECT_TRUE(cache.store(source, offset, samples.data() + offset, slab_size));
+  }
+  EXPECT_FALSE(cache.store(source, 0, samples.data(), slab_size));
+
+  for (size_t offset = 0; offset < samples.size(); offset += slab_size) {
+    ASSERT_TRUE(cache.load(source, offset, slab_size, slab.data()));
+    ASSERT_EQ(std::memcmp(slab.data(), samples.data() + offset, slab_size), 0);
+  }
+  const auto stats = cache.get_stats();
+  EXPECT_EQ(stats.hits, 10);
+  EXPECT_EQ(stats.misses, 1);
+  EXPECT_EQ(stats.num_slabs, 10);
+  EXPECT_EQ(stats.num_raw_bytes, samples.size());
+  if (compress) {
+    EXPECT_LT(stats.num_bytes, stats.num_raw_bytes / 2);
+  } else {
+    EXPECT_EQ(stats.num_bytes, stats.num_raw_bytes);
+  }
+}
+
+// Reads a few epochs with a cache of `budget_fraction` of the file, and checks that they return
+// the same batches as the first one.
+void reader_test(bool packed, bool compress, double budget_fraction) {
+  const size_t batch_samples = 1000;
+  const auto samples = make_samples(batch_samples * 20 + 77);
+  std::filesystem::create_directories(test_dir);
+  std::string file_name = test_dir + "/plain.bin";
+  write_file(file_name, samples);
+  std::shared_ptr<const RawAsyncPackedIndex> index;
+  if (packed) {
+    pack_raw_async(file_name, test_dir + "/packed.bin", {40, 0, 4}, 256, 2);
+    file_name = test_dir + "/packed.bin";
+    index = RawAsyncPackedIndex::read(file_name);
+  }
+  ThreadPool decoder("decoder", 2);
+
+  HostCacheParams params;
+  params.enabled = true;
+  params.compress = compress;
+  params.max_bytes = static_cast<size_t>(samples.size() * budget_fraction);
+  auto cache = std::make_shared<HostBatchCache>(params);
+  const size_t source = cache->add_source(sample_size_bytes);
+
+  const size_t batch_size_bytes = batch_samples * sample_size_bytes;
+  BatchLocations locations(batch_size_bytes, 0, samples.size(), true, 1234);
+  auto shards = locations.shard(2, sample_size_bytes);
+  for (auto& shard : shards) {
+    const size_t num_batches = shard->count();
+    std::unique_ptr<BatchFileReader> reader;
+    if (packed) {
+      reader = std::make_unique<BatchFileReader>(file_name, index, decoder, 0, 4, std::move(shard));
+    } else {
+      reader = std::make_unique<BatchFileReader>(file_name, 0, 4, std::move(shard));
+    }
+    reader->set_cache(cache, source);
+
+    const auto expected = read_epoch(*reader, num_batches);
+    for (size_t epoch = 0; epoch < 2; ++epoch) {
+      const auto actual = read_epoch(*reader, num_batches);
+      ASSERT_EQ(expected, actual);
+    }
+  }
+
+  const auto stats = cache->get_stats();
+  EXPECT_GT(stats.hits, 0);
+  if (budget_fraction >= 1) {
+    // Every slab was read from disk in the first epoch only
+    EXPECT_EQ(stats.misses, stats.num_slabs);
+    EXPECT_EQ(stats.hits, 2 * stats.num_slabs);
+  } else {
+    EXPECT_LE(stats.num_bytes, params.max_bytes);
+    EXPECT_LT(stats.hit_ratio(), 2. / 3);
+  }
+  std::filesystem::remove_all(test_dir);
+}
+
+}  // namespace
+
+TEST(host_batch_cache, slabs) { cache_slabs_test(false); }
+TEST(host_batch_cache, compressed_slabs) { cache_slabs_test(true); }
+
+TEST(host_batch_cache, budget) {
+  HostCacheParams params;
+  params.enabled = true;
+  params.max_bytes = 2500;
+  HostBatchCache cache(params);
+  const size_t source = cache.add_source(4);
+  const std::vector<uint8_t> slab(1000, 42);
+  EXPECT_TRUE(cache.store(source, 0, slab.data(), slab.size()));
+  EXPECT_TRUE(cache.store(source, 1000, slab.data(), slab.size()));
+  EXPECT_FALSE(cache.store(source, 2000, slab.data(), slab.size()));
+  // Nothing is evicted, so the cache stays full
+  EXPECT_FALSE(cache.store(source, 3000, slab.data(), 100));
+  EXPECT_EQ(cache.get_stats().num_bytes, 2000);
+  EXPECT_EQ(cache.get_stats().num_slabs, 2);
+}
+
+TEST(host_batch_cache, reader) { reader_test(false, false, 1); }
+TEST(host_batch_cache, reader_compressed) { reader_test(false, true, 1); }
+TEST(host_batch_cache, reader_packed_file) { reader_test(true, true, 1); }
+TEST(host_batch_cache, reader_over_budget) { reader_test(false, false, 0.5); }
+
+// Epoch time from disk and from the cache. The file is usually in the page cache here, so this
+// mostly shows the cost of the AIO path versus a copy or a decode from host memory.
+TEST(host_batch_cache, epoch_benchmark) {
+  const size_t batch_samples = 65536;
+  const auto samples = make_samples(batch_samples * 32);
+  std::filesystem::create_directories(test_dir);
+  const std::string file_name = test_dir + "/plain.bin";
+  write_file(file_name, samples);
+
+  const size_t batch_size_bytes = batch_samples * sample_size_bytes;
+  for (const bool compress : {false, true}) {
+    HostCacheParams params;
+    params.enabled = true;
+    params.compress = compress;
+    auto cache = std::make_shared<HostBatchCache>(params);
+    auto locations = std::make_unique<BatchLocations>(batch_size_bytes, 0, samples.size());
+    const size_t num_batches = locations->count();
+    BatchFileReader reader(file_name, 0, 8, std::move(locations));
+    reader.set_cache(cache, cache->add_source(sample_size_bytes));
+
+    for (size_t epoch = 0; epoch < 3; ++epoch) {
+      const auto before = cache->get_stats();
+      const auto start = std::chrono::high_resolution_clock::now();
+      size_t num_read = 0;
+      while (num_read < num_batches) {
+        for (const auto batch : reader.read_batches(1000)) {
+          num_read++;
+          reader.release_batch(batch);
+        }
+      }
+      const auto end = std::chrono::high_resolution_clock::now();
+      const double seconds = std::chrono::duration<double>(end - start).count();
+      const auto after = cache->get_stats();
+      std::cout << (compress ? "compressed" : "uncompressed") << ", epoch " << epoch
+                << ", Time (ms): " << seconds * 1000
+                << ", Throughput (GB/s): " << samples.size() / 1e9 / seconds
+                << ", hits: " << after.hits - before.hits
+                << ", misses: " << after.misses - before.misses
+                << ", cached bytes: " << after.num_bytes << std::endl;
+    }
+  }
+  std::filesystem::remove_all(test_dir);
+}
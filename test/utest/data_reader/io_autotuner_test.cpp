@@ -0,0 +1,326 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <data_readers/multi_hot/detail/batch_file_reader.hpp>
+#include <data_readers/multi_hot/detail/io_autotuner.hpp>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace HugeCTR;
+
+namespace {
+
+using Decision = IOAutotuner::Decision;
+
+// A device that serves one request at a time at a fixed bandwidth.
+struct SimulatedDevice {
+  std::mutex mutex;
+  double bytes_per_s;
+  double busy_until = 0;
+};
+
+/**
+ * Completes every request `latency_s` after it was submitted, or after the simulated device has
+ * served it. Nothing is actually read.
+ */
+class SimulatedIOContext : public IOContext {
+ public:
+  SimulatedIOContext(size_t io_depth, double latency_s,
+                     std::shared_ptr<SimulatedDevice> device = nullptr)
+      : io_depth_(io_depth), latency_s_(latency_s), device_(std::move(device)) {}
+
+  void submit(const IORequest& request) override {
+    if (pending_.size() == io_depth_) {
+      throw std::runtime_error("IO depth exceeded");
+    }
+    double completion = time_double();
+    if (device_) {
+      std::lock_guard<std::mutex> lock(device_->mutex);
+      device_->busy_until =
+          std::max(completion, device_->busy_until) + request.size / device_->bytes_per_s;
+      completion = device_->busy_until;
+    }
+    pending_.emplace(completion + latency_s_, request.user_data);
+  }
+
+  const std::vector<IOEvent>& collect(size_t min_reqs, size_t timeout_us) override {
+    const double deadline = time_double() + timeout_us / 1e6;
+    events_.clear();
+    while (true) {
+      const double now = time_double();
+      while (!pending_.empty() && pending_.begin()->first <= now) {
+        events_.push_back({IOError::IO_SUCCESS, pending_.begin()->second});
+        pending_.erase(pending_.begin());
+      }
+      if (events_.size() >= min_reqs || now >= deadline) {
+        return events_;
+      }
+      const double wake = pending_.empty() ? deadline : std::min(deadline, pending_.begin()->first);
+      usleep(static_cast<useconds_t>(std::max(0., wake - now) * 1e6));
+    }
+  }
+
+  size_t get_alignment() const override { return 4096; }
+
+ private:
+  const size_t io_depth_;
+  const double latency_s_;
+  std::shared_ptr<SimulatedDevice> device_;
+  std::multimap<double, void*> pending_;  // By completion time
+  std::vector<IOEvent> events_;
+};
+
+IOAutotunerParams test_params() {
+  IOAutotunerParams params;
+  params.enabled = true;
+  params.interval_batches = 4;
+  params.hold_intervals = 2;
+  return params;
+}
+
+// Feeds one interval in which the consumer waits `wait_fraction` of the time.
+bool interval(IOAutotuner& tuner, double latency, double wait_fraction, double batches_per_s) {
+  const double step = 1 / batches_per_s;
+  bool changed = false;
+  for (size_t i = 0; i < 4; ++i) {
+    changed = tuner.record(latency, step * wait_fraction, step);
+  }
+  return changed;
+}
+
+struct ClosedLoopResult {
+  size_t window;
+  double wait_fraction;  // Over the last quarter of the batches
+};
+
+// Reads with a BatchFileReader on simulated IO contexts, consumes batches in order like
+// DataReaderImpl, and lets the autotuner adjust the reader.
+ClosedLoopResult closed_loop(const IOAutotunerParams& params, size_t num_batches,
+                             double consume_s, const BatchFileReader::IOContextFactory& factory) {
+  const std::string file_name = "./io_autotuner_test.bin";
+  const size_t batch_size_bytes = 4096;
+  const size_t file_batches = 1024;
+  {
+    std::ofstream file(file_name, std::ios::binary);
+  }
+  std::filesystem::resize_file(file_name, batch_size_bytes * file_batches);
+
+  const size_t max_window = 32;
+  BatchFileReader reader({file_name}, 0, 0, max_window,
+                         std::make_unique<BatchLocations>(batch_size_bytes, 0,
+                                                          batch_size_bytes * file_batches),
+                         factory);
+  IOAutotuner tuner(params, params.min_window, max_window);
+  reader.set_max_batches_inflight(tuner.window());
+
+  std::mutex mutex;
+  std::map<size_t, const BatchFileReader::Batch*> completed;
+  std::atomic<bool> running{true};
+  std::thread reader_thread([&]() {
+    while (running) {
+      for (const auto batch : reader.read_batches(100)) {
+        std::lock_guard<std::mutex> lock(mutex);
+        completed[batch->batch_i] = batch;
+      }
+    }
+  });
+
+  double wait_sum = 0;
+  double step_sum = 0;
+  double last_time = time_double();
+  for (size_t i = 0; i < num_batches; ++i) {
+    const double wait_start = time_double();
+    const BatchFileReader::Batch* batch = nullptr;
+    while (!batch) {
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = completed.find(i % file_batches);
+        if (it != completed.end()) {
+          batch = it->second;
+          completed.erase(it);
+          break;
+        }
+      }
+      std::this_thread::yield();
+    }
+    const double wait = time_double() - wait_start;
+    const double latency = batch->end_time - batch->start_time;
+    std::this_thread::sleep_for(std::chrono::duration<double>(consume_s));
+    reader.release_batch(batch);
+
+    const double now = time_double();
+    if (tuner.record(latency, wait, now - last_time)) {
+      reader.set_max_batches_inflight(tuner.window());
+    }
+    if (i >= num_batches * 3 / 4) {
+      wait_sum += wait;
+      step_sum += now - last_time;
+    }
+    last_time = now;
+  }
+  running = false;
+  reader_thread.join();
+  std::filesystem::remove(file_name);
+  return {tuner.window(), wait_sum / step_sum};
+}
+
+}  // namespace
+
+TEST(io_autotuner, slow_start) {
+  IOAutotuner tuner(test_params(), 1, 16);
+  EXPECT_EQ(tuner.window(), 1);
+  for (size_t expected : {2, 4, 8, 16}) {
+    EXPECT_TRUE(interval(tuner, 1e-3, 0.5, 100 * expected));
+    EXPECT_EQ(tuner.last_decision(), Decision::SlowStart);
+    EXPECT_EQ(tuner.window(), expected);
+  }
+  // Limited by max_window
+  EXPECT_FALSE(interval(tuner, 1e-3, 0.5, 3200));
+  EXPECT_EQ(tuner.window(), 16);
+}
+
+TEST(io_autotuner, hold_while_consumer_is_busy) {
+  IOAutotuner tuner(test_params(), 4, 16);
+  for (size_t i = 0; i < 10; ++i) {
+    EXPECT_FALSE(interval(tuner, 1e-3, 0.01, 1000));
+    EXPECT_EQ(tuner.last_decision(), Decision::Hold);
+  }
+  EXPECT_EQ(tuner.window(), 4);
+}
+
+TEST(io_autotuner, revert_without_gain) {
+  IOAutotuner tuner(test_params(), 1, 64);
+  EXPECT_TRUE(interval(tuner, 1e-3, 0.5, 100));
+  EXPECT_TRUE(interval(tuner, 1e-3, 0.5, 200));
+  EXPECT_EQ(tuner.window(), 4);
+  // Device is saturated, the larger window doesn't help
+  EXPECT_TRUE(interval(tuner, 1e-3, 0.5, 201));
+  EXPECT_EQ(tuner.last_decision(), Decision::Revert);
+  EXPECT_EQ(tuner.window(), 2);
+  // Hold, then probe additively
+  EXPECT_FALSE(interval(tuner, 1e-3, 0.5, 200));
+  EXPECT_FALSE(interval(tuner, 1e-3, 0.5, 200));
+  EXPECT_TRUE(interval(tuner, 1e-3, 0.5, 200));
+  EXPECT_EQ(tuner.last_decision(), Decision::Increase);
+  EXPECT_EQ(tuner.window(), 3);
+  EXPECT_TRUE(interval(tuner, 1e-3, 0.5, 300));
+  EXPECT_EQ(tuner.window(), 4);
+}
+
+TEST(io_autotuner, decrease_on_congestion) {
+  IOAutotuner tuner(test_params(), 16, 16);
+  EXPECT_FALSE(interval(tuner, 1e-3, 0, 1000));
+  // Consumer keeps up, but reads queue up in the device
+  EXPECT_TRUE(interval(tuner, 3e-3, 0, 1000));
+  EXPECT_EQ(tuner.last_decision(), Decision::Decrease);
+  EXPECT_EQ(tuner.window(), 8);
+  EXPECT_FALSE(interval(tuner, 3e-3, 0, 1000));
+  EXPECT_FALSE(interval(tuner, 3e-3, 0, 1000));
+  EXPECT_TRUE(interval(tuner, 3e-3, 0, 1000));
+  EXPECT_EQ(tuner.window(), 4);
+  // Consumer starts waiting, increase additively from here
+  EXPECT_FALSE(interval(tuner, 1e-3, 0.5, 500));
+  EXPECT_FALSE(interval(tuner, 1e-3, 0.5, 500));
+  EXPECT_TRUE(interval(tuner, 1e-3, 0.5, 500));
+  EXPECT_EQ(tuner.last_decision(), Decision::Increase);
+  EXPECT_EQ(tuner.window(), 5);
+}
+
+TEST(io_autotuner, min_window) {
+  IOAutotunerParams params = test_params();
+  params.min_window = 3;
+  IOAutotuner tuner(params, 1, 16);
+  EXPECT_EQ(tuner.window(), 3);
+  EXPECT_FALSE(interval(tuner, 1e-3, 0, 1000));
+  EXPECT_FALSE(interval(tuner, 1e-2, 0, 1000));
+  EXPECT_EQ(tuner.window(), 3);
+  EXPECT_THROW(IOAutotuner({true, 1, 0, 0, 0}, 1, 16), std::exception);
+}
+
+TEST(io_autotuner, reader_window) {
+  const std::string file_name = "./io_autotuner_test.bin";
+  {
+    std::ofstream file(file_name, std::ios::binary);
+  }
+  std::filesystem::resize_file(file_name, 4096 * 16);
+  auto factory = [](size_t io_depth) {
+    return std::make_unique<SimulatedIOContext>(io_depth, 1e-3);
+  };
+  BatchFileReader reader({file_name}, 0, 0, 8, std::make_unique<BatchLocations>(4096, 0, 4096 * 16),
+                         factory);
+  reader.set_max_batches_inflight(3);
+  EXPECT_EQ(reader.get_max_batches_inflight(), 3);
+  std::vector<const BatchFileReader::Batch*> batches;
+  for (size_t i = 0; i < 100 && batches.size() < 3; ++i) {
+    for (const auto batch : reader.read_batches(10000)) {
+      batches.push_back(batch);
+    }
+  }
+  EXPECT_EQ(batches.size(), 3);
+  EXPECT_EQ(reader.get_num_inflight(), 3);
+  EXPECT_TRUE(reader.read_batches(2000).empty());
+
+  reader.set_max_batches_inflight(100);
+  EXPECT_EQ(reader.get_max_batches_inflight(), 8);
+  reader.set_max_batches_inflight(0);
+  EXPECT_EQ(reader.get_max_batches_inflight(), 1);
+  for (const auto batch : batches) {
+    reader.release_batch(batch);
+  }
+  std::filesystem::remove(file_name);
+}
+
+// Fixed read latency: the window has to cover the latency with consumer time
+TEST(io_autotuner, closed_loop_latency_bound) {
+  IOAutotunerParams params;
+  params.enabled = true;
+  params.interval_batches = 16;
+  auto factory = [](size_t io_depth) {
+    return std::make_unique<SimulatedIOContext>(io_depth, 4e-3);
+  };
+  const ClosedLoopResult result = closed_loop(params, 3000, 2.5e-4, factory);
+  std::cout << "window: " << result.window << ", consumer wait: " << result.wait_fraction * 100
+            << "%" << std::endl;
+  EXPECT_GE(result.window, 8);
+  EXPECT_LT(result.wait_fraction, 0.25);
+}
+
+// Bandwidth-limited device: a larger window only adds queueing, so it stays small
+TEST(io_autotuner, closed_loop_bandwidth_bound) {
+  IOAutotunerParams params;
+  params.enabled = true;
+  params.interval_batches = 16;
+  auto device = std::make_shared<SimulatedDevice>();
+  device->bytes_per_s = 4096 / 1e-3;  // 1 ms per batch
+  auto factory = [device](size_t io_depth) {
+    return std::make_unique<SimulatedIOContext>(io_depth, 1e-4, device);
+  };
+  const ClosedLoopResult result = closed_loop(params, 1500, 1e-4, factory);
+  std::cout << "window: " << result.window << ", consumer wait: " << result.wait_fraction * 100
+            << "%" << std::endl;
+  EXPECT_LE(result.window, 8);
+}
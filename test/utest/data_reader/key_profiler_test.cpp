@@ -0,0 +1,304 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <data_readers/key_profiler.hpp>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace HugeCTR;
+
+namespace {
+
+const std::string file_name{"./key_profiler_test.bin"};
+constexpr size_t num_samples{20000};
+constexpr size_t label_dim{1};
+constexpr size_t dense_dim{3};
+const std::vector<int> nnz_array{1, 3, 2};
+
+typedef std::vector<std::map<int64_t, uint64_t>> Reference;
+
+/**
+ * Draws keys with a Zipf-like distribution over `vocabulary_size` keys.
+ */
+int64_t draw_key(std::mt19937_64& gen, const int64_t vocabulary_size) {
+  std::uniform_real_distribution<double> dist;
+  return static_cast<int64_t>(std::pow(static_cast<double>(vocabulary_size), dist(gen))) - 1;
+}
+
+template <typename T>
+void append(std::vector<char>& buffer, const T value) {
+  const char* const ptr{reinterpret_cast<const char*>(&value)};
+  buffer.insert(buffer.end(), ptr, ptr + sizeof(T));
+}
+
+template <typename Key>
+Reference write_raw_async(const int64_t vocabulary_size) {
+  std::mt19937_64 gen{4711};
+  Reference ref(nnz_array.size());
+  std::vector<char> buffer;
+  for (size_t sample{0}; sample < num_samples; ++sample) {
+    for (size_t i{0}; i < label_dim + dense_dim; ++i) {
+      append(buffer, 0.5f);
+    }
+    for (size_t slot{0}; slot < nnz_array.size(); ++slot) {
+      for (int i{0}; i < nnz_array[slot]; ++i) {
+        const Key key{static_cast<Key>(draw_key(gen, vocabulary_size))};
+        append(buffer, key);
+        ++ref[slot][static_cast<int64_t>(key)];
+      }
+    }
+  }
+  std::ofstream file(file_name, std::ios::binary);
+  file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+  return ref;
+}
+
+Reference write_norm(const bool check_sum) {
+  std::mt19937_64 gen{42};
+  std::uniform_int_distribution<int> nnz_dist{0, 4};
+  Reference ref(nnz_array.size());
+  std::vector<char> buffer;
+  const auto write_record{[&](const std::vector<char>& record) {
+    if (check_sum) {
+      append(buffer, static_cast<int>(record.size()));
+    }
+    buffer.insert(buffer.end(), record.begin(), record.end());
+    if (check_sum) {
+      char sum{0};
+      for (const char c : record) {
+        sum += c;
+      }
+      append(buffer, sum);
+    }
+  }};
+
+  const DataSetHeader header{check_sum ? 1 : 0,
+                             static_cast<long long>(num_samples),
+                             static_cast<long long>(label_dim),
+                             static_cast<long long>(dense_dim),
+                             static_cast<long long>(nnz_array.size()),
+                             {0, 0, 0}};
+  std::vector<char> record;
+  append(record, header);
+  write_record(record);
+  for (size_t sample{0}; sample < num_samples; ++sample) {
+    record.clear();
+    for (size_t i{0}; i < label_dim + dense_dim; ++i) {
+      append(record, 0.5f);
+    }
+    for (size_t slot{0}; slot < nnz_array.size(); ++slot) {
+      const int nnz{nnz_dist(gen)};
+      append(record, nnz);
+      for (int i{0}; i < nnz; ++i) {
+        const long long key{draw_key(gen, 100000)};
+        append(record, key);
+        ++ref[slot][key];
+      }
+    }
+    write_record(record);
+  }
+  std::ofstream file(file_name, std::ios::binary);
+  file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+  return ref;
+}
+
+void check_exact(const KeyProfiler& profiler, const Reference& ref) {
+  ASSERT_TRUE(profiler.exact());
+  const std::vector<KeyProfile> profiles{profiler.result()};
+  ASSERT_EQ(profiles.size(), ref.size());
+  for (size_t slot{0}; slot < ref.size(); ++slot) {
+    const KeyProfile& profile{profiles[slot]};
+    EXPECT_TRUE(profile.exact);
+    ASSERT_EQ(profile.cardinality, ref[slot].size());
+    ASSERT_EQ(profile.keys.size(), ref[slot].size());
+
+    uint64_t num_accesses{0};
+    for (size_t i{0}; i < profile.keys.size(); ++i) {
+      const auto& [key, count] = profile.keys[i];
+      ASSERT_EQ(ref[slot].count(key), 1u);
+      EXPECT_EQ(count, ref[slot].at(key));
+      if (i > 0) {
+        EXPECT_LE(count, profile.keys[i - 1].second);
+      }
+      num_accesses += count;
+    }
+    EXPECT_EQ(profile.num_accesses, num_accesses);
+  }
+}
+
+template <typename Key>
+void raw_async_test(const size_t num_threads) {
+  const Reference ref{write_raw_async<Key>(100000)};
+  KeyProfilerParams params;
+  params.format = DataReaderType_t::RawAsync;
+  params.label_dim = label_dim;
+  params.dense_dim = dense_dim;
+  params.nnz_array = nnz_array;
+  params.i64_input_key = sizeof(Key) == sizeof(int64_t);
+  params.num_threads = num_threads;
+  params.block_size_bytes = 4096;
+
+  KeyProfiler profiler{params};
+  profiler.profile(file_name);
+  EXPECT_EQ(profiler.num_samples(), num_samples);
+  check_exact(profiler, ref);
+
+  // Profiling a file again doubles all counts.
+  profiler.profile(file_name);
+  EXPECT_EQ(profiler.num_samples(), 2 * num_samples);
+  const std::vector<KeyProfile> profiles{profiler.result()};
+  EXPECT_EQ(profiles[1].num_accesses, 2 * num_samples * nnz_array[1]);
+  EXPECT_EQ(profiles[1].cardinality, ref[1].size());
+  std::remove(file_name.c_str());
+}
+
+void norm_test(const bool check_sum, const size_t num_threads) {
+  const Reference ref{write_norm(check_sum)};
+  KeyProfilerParams params;
+  params.format = DataReaderType_t::Norm;
+  params.i64_input_key = true;
+  params.num_threads = num_threads;
+  params.block_size_bytes = 1000;
+
+  KeyProfiler profiler{params};
+  profiler.profile(file_name);
+  EXPECT_EQ(profiler.num_samples(), num_samples);
+  check_exact(profiler, ref);
+  std::remove(file_name.c_str());
+}
+
+}  // namespace
+
+TEST(key_profiler, raw_async_u32_1_thread) { raw_async_test<uint32_t>(1); }
+TEST(key_profiler, raw_async_u32_4_threads) { raw_async_test<uint32_t>(4); }
+TEST(key_profiler, raw_async_i64_4_threads) { raw_async_test<int64_t>(4); }
+TEST(key_profiler, norm_check_sum_4_threads) { norm_test(true, 4); }
+TEST(key_profiler, norm_no_check_sum_4_threads) { norm_test(false, 4); }
+
+TEST(key_profiler, sketch_mode) {
+  const int64_t vocabulary_size{1000000};
+  const Reference ref{write_raw_async<int64_t>(vocabulary_size)};
+  KeyProfilerParams params;
+  params.format = DataReaderType_t::RawAsync;
+  params.label_dim = label_dim;
+  params.dense_dim = dense_dim;
+  params.nnz_array = nnz_array;
+  params.i64_input_key = true;
+  params.num_threads = 4;
+  params.block_size_bytes = 4096;
+  params.max_exact_bytes = 64 * 1024;
+  params.sketch_width = 1 << 16;
+  params.num_heavy_hitters = 256;
+
+  KeyProfiler profiler{params};
+  profiler.profile(file_name);
+  EXPECT_FALSE(profiler.exact());
+
+  const std::vector<KeyProfile> profiles{profiler.result()};
+  for (size_t slot{0}; slot < ref.size(); ++slot) {
+    const KeyProfile& profile{profiles[slot]};
+    EXPECT_FALSE(profile.exact);
+    EXPECT_EQ(profile.num_accesses, num_samples * nnz_array[slot]);
+
+    // HyperLogLog with 2^14 registers is accurate to about 1%.
+    const double cardinality{static_cast<double>(ref[slot].size())};
+    EXPECT_NEAR(static_cast<double>(profile.cardinality), cardinality, 0.05 * cardinality);
+
+    // The heaviest keys are found, and their counts are never underestimated.
+    std::vector<std::pair<uint64_t, int64_t>> sorted;
+    for (const auto& [key, count] : ref[slot]) {
+      sorted.emplace_back(count, key);
+    }
+    std::sort(sorted.rbegin(), sorted.rend());
+    ASSERT_GE(profile.keys.size(), 10u);
+    for (size_t i{0}; i < 10; ++i) {
+      const auto it{std::find_if(profile.keys.begin(), profile.keys.end(),
+                                 [&](const auto& p) { return p.first == sorted[i].second; })};
+      ASSERT_NE(it, profile.keys.end()) << "slot " << slot << ", rank " << i;
+      EXPECT_GE(it->second, sorted[i].first);
+      EXPECT_LE(it->second, sorted[i].first + profile.num_accesses / 1000);
+    }
+  }
+  std::remove(file_name.c_str());
+}
+
+TEST(key_profiler, coverage) {
+  KeyProfile profile;
+  profile.num_accesses = 100;
+  profile.cardinality = 10;
+  profile.keys = {{7, 50}, {3, 20}, {1, 10}};
+
+  // The 7 untracked keys share the remaining 20 accesses.
+  EXPECT_DOUBLE_EQ(profile.accesses_of_top(1), 50);
+  EXPECT_DOUBLE_EQ(profile.accesses_of_top(2.5), 75);
+  EXPECT_DOUBLE_EQ(profile.accesses_of_top(3), 80);
+  EXPECT_DOUBLE_EQ(profile.accesses_of_top(6.5), 90);
+  EXPECT_DOUBLE_EQ(profile.accesses_of_top(10), 100);
+
+  EXPECT_EQ(profile.keys_for_coverage(0.5), 1u);
+  EXPECT_EQ(profile.keys_for_coverage(0.7), 2u);
+  EXPECT_EQ(profile.keys_for_coverage(0.8), 3u);
+  EXPECT_EQ(profile.keys_for_coverage(0.9), 7u);
+  EXPECT_EQ(profile.keys_for_coverage(1), 10u);
+
+  const auto curve{profile.coverage(5)};
+  ASSERT_FALSE(curve.empty());
+  EXPECT_EQ(curve.back(), std::make_pair(1., 1.));
+  EXPECT_DOUBLE_EQ(curve.front().first, 0.1);
+  EXPECT_DOUBLE_EQ(curve.front().second, 0.5);
+  for (size_t i{1}; i < curve.size(); ++i) {
+    EXPECT_GT(curve[i].first, curve[i - 1].first);
+    EXPECT_GE(curve[i].second, curve[i - 1].second);
+  }
+}
+
+TEST(key_profiler, errors) {
+  write_raw_async<uint32_t>(1000);
+  KeyProfilerParams params;
+  params.format = DataReaderType_t::RawAsync;
+  params.label_dim = label_dim;
+  params.dense_dim = dense_dim;
+  params.nnz_array = {1, 3, 3};  // Does not match the file.
+  params.num_threads = 2;
+  EXPECT_THROW(KeyProfiler(params).profile(file_name), std::exception);
+
+  params.nnz_array.clear();
+  EXPECT_THROW(KeyProfiler{params}, std::exception);
+
+  // A Norm file that is cut off.
+  write_norm(false);
+  {
+    std::ifstream in(file_name, std::ios::binary);
+    std::vector<char> data{std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+    in.close();
+    std::ofstream out(file_name, std::ios::binary | std::ios::trunc);
+    out.write(data.data(), static_cast<std::streamsize>(data.size() - 3));
+  }
+  params.format = DataReaderType_t::Norm;
+  params.i64_input_key = true;
+  EXPECT_THROW(KeyProfiler(params).profile(file_name), std::exception);
+  EXPECT_THROW(KeyProfiler(params).profile("./does_not_exist.bin"), std::exception);
+  std::remove(file_name.c_str());
+}
@@ -0,0 +1,242 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <arrow/api.h>
+#include <arrow/io/file.h>
+#include <gtest/gtest.h>
+#include <parquet/arrow/writer.h>
+
+#include <cstdio>
+#include <data_readers/parquet_cpu_decoder.hpp>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace HugeCTR;
+
+namespace {
+
+const std::string file_name{"./parquet_cpu_decoder_test.parquet"};
+constexpr size_t num_rows{1000};
+constexpr size_t row_group_size{300};
+constexpr size_t vec_width{3};
+constexpr size_t max_nnz{4};
+
+/**
+ * Expected contents of the file, in row-major order.
+ */
+struct Reference {
+  std::vector<float> label;
+  std::vector<float> dense_vec;  // `vec_width` values per row.
+  std::vector<float> dense;
+  std::vector<int64_t> c0;
+  std::vector<std::vector<int64_t>> c1;  // Multi-hot.
+  std::vector<int64_t> c2;
+};
+
+template <typename ArrowType, typename CType>
+std::shared_ptr<arrow::Array> make_array(const std::vector<CType>& values) {
+  typename arrow::TypeTraits<ArrowType>::BuilderType builder;
+  EXPECT_TRUE(builder.AppendValues(values).ok());
+  return builder.Finish().ValueOrDie();
+}
+
+template <typename ArrowType, typename CType>
+std::shared_ptr<arrow::Array> make_list_array(const std::vector<std::vector<CType>>& rows) {
+  auto value_builder{std::make_shared<typename arrow::TypeTraits<ArrowType>::BuilderType>()};
+  arrow::ListBuilder builder{arrow::default_memory_pool(), value_builder};
+  for (const std::vector<CType>& row : rows) {
+    EXPECT_TRUE(builder.Append().ok());
+    EXPECT_TRUE(value_builder->AppendValues(row).ok());
+  }
+  return builder.Finish().ValueOrDie();
+}
+
+Reference write_test_file() {
+  std::mt19937 gen{4711};
+  std::uniform_real_distribution<float> real_dist;
+  std::uniform_int_distribution<int64_t> key_dist{0, 100000};
+  std::uniform_int_distribution<size_t> nnz_dist{0, max_nnz};
+
+  Reference ref;
+  std::vector<std::vector<float>> dense_vec_rows;
+  for (size_t row{0}; row < num_rows; ++row) {
+    ref.label.push_back(real_dist(gen));
+    dense_vec_rows.emplace_back();
+    for (size_t i{0}; i < vec_width; ++i) {
+      dense_vec_rows.back().push_back(real_dist(gen));
+      ref.dense_vec.push_back(dense_vec_rows.back().back());
+    }
+    ref.dense.push_back(real_dist(gen));
+    ref.c0.push_back(key_dist(gen));
+    ref.c1.emplace_back(nnz_dist(gen));
+    for (int64_t& key : ref.c1.back()) {
+      key = key_dist(gen);
+    }
+    ref.c2.push_back(key_dist(gen));
+  }
+
+  // Columns are deliberately not in output order.
+  const auto schema{arrow::schema({
+      arrow::field("C2", arrow::int64()),
+      arrow::field("I2", arrow::float32()),
+      arrow::field("label", arrow::float32()),
+      arrow::field("C1", arrow::list(arrow::int64())),
+      arrow::field("I1", arrow::list(arrow::float32())),
+      arrow::field("C0", arrow::int64()),
+  })};
+  const auto table{arrow::Table::Make(
+      schema, {
+                  make_array<arrow::Int64Type>(ref.c2),
+                  make_array<arrow::FloatType>(ref.dense),
+                  make_array<arrow::FloatType>(ref.label),
+                  make_list_array<arrow::Int64Type>(ref.c1),
+                  make_list_array<arrow::FloatType>(dense_vec_rows),
+                  make_array<arrow::Int64Type>(ref.c0),
+              })};
+
+  const auto sink{arrow::io::FileOutputStream::Open(file_name).ValueOrDie()};
+  EXPECT_TRUE(parquet::arrow::WriteTable(*table, arrow::default_memory_pool(), sink,
+                                         static_cast<int64_t>(row_group_size))
+                  .ok());
+  EXPECT_TRUE(sink->Close().ok());
+  return ref;
+}
+
+template <typename IndexType>
+void parquet_cpu_decoder_test(const size_t num_threads) {
+  const Reference ref{write_test_file()};
+
+  const std::vector<DataReaderSparseParam> params{
+      {"a", std::vector<int>{1, static_cast<int>(max_nnz)}, false, 2},
+      {"b", std::vector<int>{1}, true, 1},
+  };
+  const std::vector<long long> slot_offset{0, 1000000, 2000000};
+  ParquetCPUDecoder<long long, IndexType> decoder{
+      {"label", "I1", "I2"}, {"C0", "C1", "C2"}, params, slot_offset, num_threads, false};
+
+  const int num_row_groups{static_cast<int>((num_rows + row_group_size - 1) / row_group_size)};
+  for (int rg{0}; rg < num_row_groups; ++rg) {
+    decoder.submit(file_name, rg);
+  }
+  EXPECT_EQ(decoder.num_pending(), num_row_groups);
+
+  size_t first_row{0};
+  for (int rg{0}; rg < num_row_groups; ++rg) {
+    auto batch{decoder.next()};
+    ASSERT_EQ(batch->row_group, rg);
+    ASSERT_EQ(batch->num_rows, std::min(row_group_size, num_rows - first_row));
+    ASSERT_EQ(batch->label_dense_dim, 2 + vec_width);
+    ASSERT_EQ(batch->dense_dim_array, (std::vector<size_t>{1, vec_width, 1}));
+
+    for (size_t row{0}; row < batch->num_rows; ++row) {
+      const float* const values{batch->label_dense.data() + row * batch->label_dense_dim};
+      const size_t ref_row{first_row + row};
+      EXPECT_EQ(values[0], ref.label[ref_row]);
+      for (size_t i{0}; i < vec_width; ++i) {
+        EXPECT_EQ(values[1 + i], ref.dense_vec[ref_row * vec_width + i]);
+      }
+      EXPECT_EQ(values[1 + vec_width], ref.dense[ref_row]);
+    }
+
+    // First param: a one-hot and a multi-hot slot, interleaved per sample.
+    {
+      const auto& sparse{batch->sparse[0]};
+      const IndexType* const offsets{sparse.row_offsets.data()};
+      const long long* const keys{sparse.values.data()};
+      ASSERT_EQ(offsets[0], 0);
+      for (size_t row{0}; row < batch->num_rows; ++row) {
+        const size_t ref_row{first_row + row};
+        ASSERT_EQ(offsets[row * 2 + 1] - offsets[row * 2], 1);
+        EXPECT_EQ(keys[offsets[row * 2]], ref.c0[ref_row]);
+
+        const std::vector<int64_t>& c1{ref.c1[ref_row]};
+        ASSERT_EQ(static_cast<size_t>(offsets[row * 2 + 2] - offsets[row * 2 + 1]), c1.size());
+        for (size_t i{0}; i < c1.size(); ++i) {
+          EXPECT_EQ(keys[offsets[row * 2 + 1] + i], c1[i] + 1000000);
+        }
+      }
+      EXPECT_EQ(sparse.nnz, static_cast<size_t>(offsets[batch->num_rows * 2]));
+    }
+
+    // Second param: a single one-hot slot.
+    {
+      const auto& sparse{batch->sparse[1]};
+      ASSERT_EQ(sparse.nnz, batch->num_rows);
+      for (size_t row{0}; row <= batch->num_rows; ++row) {
+        EXPECT_EQ(sparse.row_offsets.data()[row], static_cast<IndexType>(row));
+      }
+      for (size_t row{0}; row < batch->num_rows; ++row) {
+        EXPECT_EQ(sparse.values.data()[row], ref.c2[first_row + row] + 2000000);
+      }
+    }
+
+    first_row += batch->num_rows;
+    decoder.recycle(std::move(batch));
+  }
+  EXPECT_EQ(first_row, num_rows);
+  EXPECT_EQ(decoder.num_pending(), 0);
+  std::remove(file_name.c_str());
+}
+
+void parquet_cpu_decoder_errors_test() {
+  write_test_file();
+
+  // Key columns are 64 bit wide.
+  const std::vector<DataReaderSparseParam> params{{"a", std::vector<int>{1}, true, 1}};
+  ParquetCPUDecoder<unsigned int, int32_t> narrow{{"label"}, {"C0"}, params, {}, 1, false};
+  narrow.submit(file_name, 0);
+  EXPECT_THROW(narrow.next(), std::exception);
+
+  ParquetCPUDecoder<long long, int32_t> decoder{{"label"}, {"C0"}, params, {}, 1, false};
+  decoder.submit(file_name, 0);
+  decoder.submit(file_name, 100);
+  EXPECT_NO_THROW(decoder.next());
+  EXPECT_THROW(decoder.next(), std::exception);
+
+  // Unknown and non-float dense columns.
+  ParquetCPUDecoder<long long, int32_t> bad_dense{{"C0"}, {"C2"}, params, {}, 1, false};
+  ParquetCPUDecoder<long long, int32_t>::Batch batch{params.size(), false};
+  EXPECT_THROW(bad_dense.decode(file_name, 0, batch), std::exception);
+  ParquetCPUDecoder<long long, int32_t> missing{{"I3"}, {"C2"}, params, {}, 1, false};
+  EXPECT_THROW(missing.decode(file_name, 0, batch), std::exception);
+  std::remove(file_name.c_str());
+}
+
+void parquet_cpu_decoder_reuse_test() {
+  write_test_file();
+
+  // The file stays open after the first row group, so the others can still be read once it is
+  // unlinked.
+  const std::vector<DataReaderSparseParam> params{{"a", std::vector<int>{1}, true, 1}};
+  ParquetCPUDecoder<long long, int32_t> decoder{{"label"}, {"C0"}, params, {}, 1, false};
+  ParquetCPUDecoder<long long, int32_t>::Batch batch{params.size(), false};
+  decoder.decode(file_name, 0, batch);
+  std::remove(file_name.c_str());
+  EXPECT_NO_THROW(decoder.decode(file_name, 1, batch));
+  EXPECT_EQ(batch.row_group, 1);
+
+  ParquetCPUDecoder<long long, int32_t> other{{"label"}, {"C0"}, params, {}, 1, false};
+  EXPECT_THROW(other.decode(file_name, 1, batch), std::exception);
+}
+
+}  // namespace
+
+TEST(parquet_cpu_decoder, int32_offsets_1_thread) { parquet_cpu_decoder_test<int32_t>(1); }
+TEST(parquet_cpu_decoder, int32_offsets_4_threads) { parquet_cpu_decoder_test<int32_t>(4); }
+TEST(parquet_cpu_decoder, int64_offsets_4_threads) { parquet_cpu_decoder_test<int64_t>(4); }
+TEST(parquet_cpu_decoder, errors) { parquet_cpu_decoder_errors_test(); }
+TEST(parquet_cpu_decoder, reuses_open_files) { parquet_cpu_decoder_reuse_test(); }
@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <data_generator/raw_async_generator.hpp>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+using namespace HugeCTR;
+
+namespace {
+
+RawAsyncGeneratorParams make_params() {
+  RawAsyncGeneratorParams params;
+  params.num_samples = 10007;
+  params.label_dim = 1;
+  params.dense_dim = 13;
+  params.slot_size_array = {1000, 50000, 1000, 7};
+  params.nnz_array = {1, 3, 2, 1};
+  params.block_size_bytes = 64 * 1024;
+  return params;
+}
+
+std::vector<char> read_file(const std::string& file_name) {
+  std::ifstream file(file_name, std::ios::binary);
+  return {std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+}
+
+}  // namespace
+
+TEST(raw_async_generator, philox_known_answer) {
+  const Philox4x32::Counter r{Philox4x32::generate({0, 0, 0, 0}, {0, 0})};
+  EXPECT_EQ(r[0], 0x6627e8d5u);
+  EXPECT_EQ(r[1], 0xe169c58du);
+  EXPECT_EQ(r[2], 0xbc57ac4cu);
+  EXPECT_EQ(r[3], 0x9b00dbd8u);
+}
+
+TEST(raw_async_generator, block_alignment) {
+  const RawAsyncGeneratorParams params{make_params()};
+  const RawAsyncGenerator generator(params);
+
+  EXPECT_EQ(generator.sample_size_bytes(), (1 + 13 + 7) * sizeof(float));
+  EXPECT_EQ((generator.samples_per_block() * generator.sample_size_bytes()) % params.io_alignment,
+            0);
+}
+
+TEST(raw_async_generator, deterministic_across_threads) {
+  RawAsyncGeneratorParams params{make_params()};
+
+  params.num_threads = 1;
+  const RawAsyncGeneratorStats stats{RawAsyncGenerator(params).generate("raw_async_gen_1.bin")};
+  params.num_threads = 8;
+  RawAsyncGenerator(params).generate("raw_async_gen_8.bin");
+
+  const std::vector<char> data_1{read_file("raw_async_gen_1.bin")};
+  const std::vector<char> data_8{read_file("raw_async_gen_8.bin")};
+  ASSERT_EQ(data_1.size(), stats.num_bytes);
+  ASSERT_EQ(data_1.size(), params.num_samples * RawAsyncGenerator(params).sample_size_bytes());
+  EXPECT_EQ(data_1, data_8);
+
+  std::remove("raw_async_gen_1.bin");
+  std::remove("raw_async_gen_8.bin");
+}
+
+TEST(raw_async_generator, keys_within_vocabulary) {
+  for (const bool i64_input_key : {false, true}) {
+    RawAsyncGeneratorParams params{make_params()};
+    params.i64_input_key = i64_input_key;
+    const RawAsyncGenerator generator(params);
+
+    const size_t num_samples{generator.samples_per_block()};
+    std::vector<char> buffer(num_samples * generator.sample_size_bytes());
+    generator.fill_block(3, num_samples, buffer.data());
+
+    for (size_t i{0}; i < num_samples; ++i) {
+      const char* sample{&buffer[i * generator.sample_size_bytes()]};
+      const float label{*reinterpret_cast<const float*>(sample)};
+      ASSERT_TRUE(label == 0 || label == 1);
+
+      const char* keys{sample + (params.label_dim + params.dense_dim) * sizeof(float)};
+      size_t k{0};
+      for (size_t slot{0}; slot < params.slot_size_array.size(); ++slot) {
+        for (int j{0}; j < params.nnz_array[slot]; ++j, ++k) {
+          const uint64_t key{i64_input_key
+                                 ? static_cast<uint64_t>(reinterpret_cast<const int64_t*>(keys)[k])
+                                 : reinterpret_cast<const uint32_t*>(keys)[k]};
+          ASSERT_LT(key, params.slot_size_array[slot]);
+        }
+      }
+    }
+  }
+}
+
+TEST(raw_async_generator, zipf_samplers) {
+  constexpr uint64_t vocabulary_size{1000};
+  constexpr double alpha{1.0};
+  constexpr size_t num_draws{1000000};
+
+  // Probability of rank 0 is 1 / H(n).
+  double h_n{0};
+  for (uint64_t k{1}; k <= vocabulary_size; ++k) {
+    h_n += 1.0 / static_cast<double>(k);
+  }
+
+  for (const uint64_t limit : {vocabulary_size, uint64_t{0}}) {
+    const std::shared_ptr<KeySampler> sampler{
+        make_zipf_key_sampler(vocabulary_size, alpha, limit)};
+    ASSERT_EQ(sampler->vocabulary_size(), vocabulary_size);
+
+    PhiloxStream rng(4711, 0);
+    std::vector<uint64_t> keys(num_draws);
+    sampler->sample(rng, keys.data(), keys.size());
+
+    std::vector<size_t> histogram(vocabulary_size);
+    for (const uint64_t key : keys) {
+      ASSERT_LT(key, vocabulary_size);
+      ++histogram[key];
+    }
+    EXPECT_NEAR(static_cast<double>(histogram[0]) / num_draws, 1.0 / h_n, 0.005);
+    EXPECT_NEAR(static_cast<double>(histogram[1]) / num_draws, 0.5 / h_n, 0.005);
+    EXPECT_GT(histogram[0], histogram[9]);
+  }
+}
@@ -0,0 +1,239 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstring>
+#include <data_readers/multi_hot/detail/batch_file_reader.hpp>
+#include <data_readers/raw_async_packed.hpp>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <utest/data_reader/batch_file_reader_test_utils.hpp>
+#include <vector>
+
+using namespace HugeCTR;
+using namespace HugeCTR::batch_file_reader_test;
+
+namespace {
+
+const std::string test_dir{"./raw_async_packed_test"};
+
+void roundtrip_test(const RawAsyncPackedLayout& layout, size_t num_samples) {
+  const RawAsyncPackedCodec codec(layout);
+  const auto samples = make_samples(layout, num_samples);
+  std::vector<uint8_t> encoded(codec.max_encoded_size(num_samples));
+  const size_t size = codec.encode(samples.data(), num_samples, encoded.data());
+  ASSERT_LE(size, encoded.size());
+  ASSERT_EQ(size % 8, 0);
+
+  std::vector<uint8_t> decoded(samples.size());
+  ASSERT_EQ(codec.decode(encoded.data(), size, decoded.data(), num_samples), num_samples);
+  ASSERT_EQ(decoded, samples);
+}
+
+void reader_test(size_t block_samples, size_t batch_samples, size_t num_shards, bool shuffle) {
+  const RawAsyncPackedLayout layout{14, 26, 4};
+  const size_t num_samples = batch_samples * 20 + 77;
+  const auto samples = make_samples(layout, num_samples);
+
+  std::filesystem::create_directories(test_dir);
+  const std::string plain = test_dir + "/plain.bin";
+  const std::string packed = test_dir + "/packed.bin";
+  write_file(plain, samples);
+  pack_raw_async(plain, packed, layout, block_samples, 4);
+  const auto index = RawAsyncPackedIndex::read(packed);
+  ASSERT_TRUE(index);
+  ThreadPool decoder("decoder", 2);
+
+  const size_t batch_size_bytes = batch_samples * layout.sample_size_bytes();
+  BatchLocations locations(batch_size_bytes, 0, samples.size(), shuffle, 1234);
+  auto plain_shards = locations.shard(num_shards, layout.sample_size_bytes());
+  auto packed_shards = locations.shard(num_shards, layout.sample_size_bytes());
+
+  for (size_t shard = 0; shard < plain_shards.size(); ++shard) {
+    const size_t num_batches = plain_shards[shard]->count();
+    BatchFileReader plain_reader(plain, 0, 4, std::move(plain_shards[shard]));
+    BatchFileReader packed_reader(packed, index, decoder, 0, 4, std::move(packed_shards[shard]));
+
+    const auto expected = read_epoch(plain_reader, num_batches);
+    // Twice, to make sure that reused buffers are decoded again
+    for (size_t epoch = 0; epoch < 2; ++epoch) {
+      const auto actual = read_epoch(packed_reader, num_batches);
+      ASSERT_EQ(expected.size(), actual.size());
+      for (const auto& [id, batch] : expected) {
+        ASSERT_EQ(actual.at(id), batch) << "shard " << shard << ", batch " << id;
+      }
+    }
+  }
+  std::filesystem::remove_all(test_dir);
+}
+
+}  // namespace
+
+TEST(raw_async_packed, codec_roundtrip) {
+  roundtrip_test({14, 26, 4}, 1000);
+  roundtrip_test({14, 26, 8}, 1000);
+  roundtrip_test({1, 3, 8}, 1);
+  roundtrip_test({2, 0, 4}, 333);
+  roundtrip_test({0, 5, 4}, 0);
+}
+
+TEST(raw_async_packed, codec_rejects_broken_blocks) {
+  const RawAsyncPackedLayout layout{14, 26, 4};
+  const RawAsyncPackedCodec codec(layout);
+  const auto samples = make_samples(layout, 100);
+  std::vector<uint8_t> encoded(codec.max_encoded_size(100));
+  const size_t size = codec.encode(samples.data(), 100, encoded.data());
+
+  std::vector<uint8_t> decoded(samples.size());
+  EXPECT_THROW(codec.decode(encoded.data(), size - 8, decoded.data(), 100), std::runtime_error);
+  EXPECT_THROW(codec.decode(encoded.data(), size, decoded.data(), 99), std::runtime_error);
+  EXPECT_THROW(RawAsyncPackedCodec({1, 1, 2}), std::runtime_error);
+}
+
+TEST(raw_async_packed, pack_and_index) {
+  const RawAsyncPackedLayout layout{14, 26, 4};
+  const size_t num_samples = 10000;
+  const auto samples = make_samples(layout, num_samples);
+  std::filesystem::create_directories(test_dir);
+  const std::string plain = test_dir + "/plain.bin";
+  const std::string packed = test_dir + "/packed.bin";
+  write_file(plain, samples);
+
+  EXPECT_FALSE(RawAsyncPackedIndex::read(plain));
+  const auto stats = pack_raw_async(plain, packed, layout, 1024, 3);
+  EXPECT_EQ(stats.num_samples, num_samples);
+  EXPECT_EQ(stats.num_bytes, samples.size());
+  EXPECT_EQ(stats.num_packed_bytes, std::filesystem::file_size(packed));
+  EXPECT_GT(stats.ratio(), 1.2);
+
+  const auto index = RawAsyncPackedIndex::read(packed);
+  ASSERT_TRUE(index);
+  EXPECT_EQ(index->num_samples, num_samples);
+  EXPECT_EQ(index->block_samples, 1024);
+  EXPECT_EQ(index->num_blocks(), 10);
+  EXPECT_EQ(index->size_bytes(), samples.size());
+  EXPECT_EQ(index->layout.sample_size_bytes(), layout.sample_size_bytes());
+
+  // Blocks decode to the original samples
+  const RawAsyncPackedCodec codec(index->layout);
+  std::ifstream file(packed, std::ios::binary);
+  std::vector<uint8_t> block;
+  std::vector<uint8_t> decoded(index->block_size_bytes());
+  for (size_t i = 0; i < index->num_blocks(); ++i) {
+    block.resize(index->offsets[i + 1] - index->offsets[i]);
+    file.seekg(index->offsets[i]);
+    file.read(reinterpret_cast<char*>(block.data()), block.size());
+    const size_t n = codec.decode(block.data(), block.size(), decoded.data(), 1024);
+    EXPECT_EQ(n, std::min<size_t>(1024, num_samples - i * 1024));
+    ASSERT_EQ(std::memcmp(decoded.data(), samples.data() + i * index->block_size_bytes(),
+                          n * layout.sample_size_bytes()),
+              0);
+  }
+
+  // Partial samples
+  write_file(plain, std::vector<uint8_t>(samples.begin(), samples.end() - 1));
+  EXPECT_THROW(pack_raw_async(plain, packed, layout, 1024, 1), std::runtime_error);
+  std::filesystem::remove_all(test_dir);
+}
+
+TEST(raw_async_packed, reader_rejects_broken_blocks) {
+  const RawAsyncPackedLayout layout{14, 26, 4};
+  const auto samples = make_samples(layout, 10000);
+  std::filesystem::create_directories(test_dir);
+  const std::string plain = test_dir + "/plain.bin";
+  const std::string packed = test_dir + "/packed.bin";
+  write_file(plain, samples);
+  pack_raw_async(plain, packed, layout, 1000, 1);
+  const auto index = RawAsyncPackedIndex::read(packed);
+  {
+    // Claims more samples than a block has
+    std::fstream file(packed, std::ios::binary | std::ios::in | std::ios::out);
+    file.seekp(index->offsets[5]);
+    const uint64_t num_samples = 1000000;
+    file.write(reinterpret_cast<const char*>(&num_samples), sizeof(num_samples));
+  }
+  ThreadPool decoder("decoder", 2);
+
+  const size_t batch_size_bytes = 1000 * layout.sample_size_bytes();
+  BatchFileReader reader(packed, index, decoder, 0, 4,
+                         std::make_unique<BatchLocations>(batch_size_bytes, 0, samples.size()));
+  // The failed batch is never returned, so reading ends with the error
+  EXPECT_THROW(
+      while (true) {
+        for (const auto batch : reader.read_batches(1000)) {
+          reader.release_batch(batch);
+        }
+      },
+      std::runtime_error);
+  std::filesystem::remove_all(test_dir);
+}
+
+TEST(raw_async_packed, reader_blocks_smaller_than_batch) { reader_test(100, 1000, 1, false); }
+TEST(raw_async_packed, reader_blocks_larger_than_batch) { reader_test(3000, 1000, 1, false); }
+TEST(raw_async_packed, reader_sharded_shuffled) { reader_test(256, 1000, 3, true); }
+
+// Read throughput of the uncompressed and the packed file. Reads of the uncompressed file are
+// usually served from the page cache here, so on a real device the packed file gains up to its
+// compression ratio as long as the decoders keep up.
+TEST(raw_async_packed, reader_benchmark) {
+  const RawAsyncPackedLayout layout{14, 26, 4};
+  const size_t batch_samples = 65536;
+  const size_t num_samples = batch_samples * 32;
+  const auto samples = make_samples(layout, num_samples);
+
+  std::filesystem::create_directories(test_dir);
+  const std::string plain = test_dir + "/plain.bin";
+  const std::string packed = test_dir + "/packed.bin";
+  write_file(plain, samples);
+  const auto stats = pack_raw_async(plain, packed, layout, 8192, 8);
+  const auto index = RawAsyncPackedIndex::read(packed);
+  ThreadPool decoder("decoder", 8);
+
+  const size_t batch_size_bytes = batch_samples * layout.sample_size_bytes();
+  for (const bool use_packed : {false, true}) {
+    auto locations = std::make_unique<BatchLocations>(batch_size_bytes, 0, samples.size());
+    const size_t num_batches = locations->count();
+    std::unique_ptr<BatchFileReader> reader;
+    if (use_packed) {
+      reader =
+          std::make_unique<BatchFileReader>(packed, index, decoder, 0, 8, std::move(locations));
+    } else {
+      reader = std::make_unique<BatchFileReader>(plain, 0, 8, std::move(locations));
+    }
+
+    const auto start = std::chrono::high_resolution_clock::now();
+    size_t num_read = 0;
+    while (num_read < num_batches) {
+      for (const auto batch : reader->read_batches(1000)) {
+        num_read++;
+        reader->release_batch(batch);
+      }
+    }
+    const auto end = std::chrono::high_resolution_clock::now();
+    const double seconds = std::chrono::duration<double>(end - start).count();
+    const size_t file_size = use_packed ? stats.num_packed_bytes : stats.num_bytes;
+    std::cout << (use_packed ? "packed" : "uncompressed") << ", file size (MB): " << file_size / 1e6
+              << ", Time (ms): " << seconds * 1000
+              << ", Throughput (GB/s): " << samples.size() / 1e9 / seconds << std::endl;
+  }
+  std::cout << "compression ratio: " << stats.ratio() << std::endl;
+  std::filesystem::remove_all(test_dir);
+}
@@ -0,0 +1,315 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <data_readers/raw_async_repacker.hpp>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <nlohmann/json.hpp>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace HugeCTR;
+
+namespace {
+
+const std::string input_name{"./raw_async_repacker_test.in"};
+const std::string output_dir{"./raw_async_repacker_test"};
+constexpr size_t num_samples{5003};
+constexpr size_t label_dim{1};
+constexpr size_t dense_dim{3};
+const std::vector<int> nnz_array{1, 3, 2};
+constexpr size_t total_nnz{6};
+
+/**
+ * Dataset in decoded form. Dense values are small integers, so that they are exact in any type.
+ */
+struct Reference {
+  std::vector<float> label_dense;
+  std::vector<int64_t> keys;
+};
+
+template <typename T>
+void append(std::vector<char>& buffer, const T value) {
+  const char* const ptr{reinterpret_cast<const char*>(&value)};
+  buffer.insert(buffer.end(), ptr, ptr + sizeof(T));
+}
+
+std::vector<char> read_file(const std::string& file_name) {
+  std::ifstream file(file_name, std::ios::binary);
+  return {std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+}
+
+void write_file(const std::string& file_name, const std::vector<char>& buffer) {
+  std::ofstream file(file_name, std::ios::binary);
+  file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+}
+
+Reference make_reference(const int64_t max_key) {
+  std::mt19937_64 gen{4711};
+  std::uniform_int_distribution<int> dense_dist{0, 1000};
+  std::uniform_int_distribution<int64_t> key_dist{0, max_key};
+  Reference ref;
+  for (size_t i{0}; i < num_samples; ++i) {
+    for (size_t j{0}; j < label_dim + dense_dim; ++j) {
+      ref.label_dense.push_back(static_cast<float>(dense_dist(gen)));
+    }
+    for (size_t j{0}; j < total_nnz; ++j) {
+      ref.keys.push_back(key_dist(gen));
+    }
+  }
+  return ref;
+}
+
+/**
+ * Writes \p ref in the Raw or RawAsync layout, which only differ in the type of integer dense
+ * values.
+ */
+template <typename Key, typename Dense>
+void write_fixed(const Reference& ref) {
+  std::vector<char> buffer;
+  for (size_t i{0}; i < num_samples; ++i) {
+    for (size_t j{0}; j < label_dim + dense_dim; ++j) {
+      append(buffer, static_cast<Dense>(ref.label_dense[i * (label_dim + dense_dim) + j]));
+    }
+    for (size_t j{0}; j < total_nnz; ++j) {
+      append(buffer, static_cast<Key>(ref.keys[i * total_nnz + j]));
+    }
+  }
+  write_file(input_name, buffer);
+}
+
+void write_norm(const Reference& ref, const bool check_sum) {
+  std::vector<char> buffer;
+  const auto write_record{[&](const std::vector<char>& record) {
+    if (check_sum) {
+      append(buffer, static_cast<int>(record.size()));
+    }
+    buffer.insert(buffer.end(), record.begin(), record.end());
+    if (check_sum) {
+      char sum{0};
+      for (const char c : record) {
+        sum += c;
+      }
+      append(buffer, sum);
+    }
+  }};
+
+  const DataSetHeader header{check_sum ? 1 : 0,
+                             static_cast<long long>(num_samples),
+                             static_cast<long long>(label_dim),
+                             static_cast<long long>(dense_dim),
+                             static_cast<long long>(nnz_array.size()),
+                             {0, 0, 0}};
+  std::vector<char> record;
+  append(record, header);
+  write_record(record);
+  for (size_t i{0}; i < num_samples; ++i) {
+    record.clear();
+    for (size_t j{0}; j < label_dim + dense_dim; ++j) {
+      append(record, ref.label_dense[i * (label_dim + dense_dim) + j]);
+    }
+    const int64_t* keys{&ref.keys[i * total_nnz]};
+    for (const int nnz : nnz_array) {
+      append(record, nnz);
+      for (int k{0}; k < nnz; ++k) {
+        append(record, static_cast<long long>(*keys++));
+      }
+    }
+    write_record(record);
+  }
+  write_file(input_name, buffer);
+}
+
+/**
+ * Expected content of a batch-major file, or of the files of a feature-major dataset.
+ */
+template <typename Key>
+std::vector<std::vector<char>> expected_files(const Reference& ref, const RawAsyncLayout layout,
+                                              const size_t num_out_samples = num_samples) {
+  std::vector<std::vector<char>> files(layout == RawAsyncLayout::BatchMajor
+                                           ? 1
+                                           : nnz_array.size() + 1);
+  for (size_t i{0}; i < num_out_samples; ++i) {
+    for (size_t j{0}; j < label_dim + dense_dim; ++j) {
+      append(files[0], ref.label_dense[i * (label_dim + dense_dim) + j]);
+    }
+    const int64_t* keys{&ref.keys[i * total_nnz]};
+    for (size_t slot{0}; slot < nnz_array.size(); ++slot) {
+      std::vector<char>& file{files[layout == RawAsyncLayout::BatchMajor ? 0 : slot + 1]};
+      for (int k{0}; k < nnz_array[slot]; ++k) {
+        append(file, static_cast<Key>(*keys++));
+      }
+    }
+  }
+  return files;
+}
+
+RawAsyncRepackerParams make_params(const DataReaderType_t format, const size_t num_dirs = 1) {
+  RawAsyncRepackerParams params;
+  params.format = format;
+  params.label_dim = label_dim;
+  params.dense_dim = dense_dim;
+  params.nnz_array = nnz_array;
+  params.num_threads = 4;
+  params.block_size_bytes = 16 * 1024;
+  params.stripe_size_bytes = 8192;
+  params.output_dirs.clear();
+  for (size_t i{0}; i < num_dirs; ++i) {
+    const std::string dir{output_dir + "/d" + std::to_string(i)};
+    std::filesystem::create_directories(dir);
+    params.output_dirs.push_back(dir);
+  }
+  return params;
+}
+
+void check_files(const RawAsyncRepacker& repacker, const std::vector<std::vector<char>>& expected) {
+  const std::vector<RawAsyncOutputFile> files{repacker.output_files("out")};
+  ASSERT_EQ(files.size(), expected.size());
+  for (size_t i{0}; i < files.size(); ++i) {
+    ASSERT_EQ(files[i].stripes.size(), 1);
+    EXPECT_EQ(files[i].slot_id, i);
+    EXPECT_EQ(read_file(files[i].stripes[0]), expected[i]) << files[i].name;
+  }
+}
+
+}  // namespace
+
+TEST(raw_async_repacker, block_alignment) {
+  RawAsyncRepackerParams params{make_params(DataReaderType_t::RawAsync)};
+  params.layout = RawAsyncLayout::FeatureMajor;
+  const RawAsyncRepacker repacker(params);
+
+  EXPECT_EQ(repacker.sample_size_bytes(), (label_dim + dense_dim + total_nnz) * sizeof(uint32_t));
+  for (const RawAsyncOutputFile& file : repacker.output_files("out")) {
+    EXPECT_EQ((repacker.samples_per_block() * file.sample_size_bytes) % params.io_alignment, 0);
+  }
+}
+
+TEST(raw_async_repacker, raw_async_identity) {
+  const Reference ref{make_reference(100000)};
+  write_fixed<uint32_t, float>(ref);
+  const RawAsyncRepacker repacker(make_params(DataReaderType_t::RawAsync));
+  const RawAsyncRepackerStats stats{repacker.repack({input_name}, "out")};
+
+  EXPECT_EQ(stats.num_samples, num_samples);
+  EXPECT_EQ(stats.num_bytes, num_samples * repacker.sample_size_bytes());
+  check_files(repacker, {read_file(input_name)});
+}
+
+TEST(raw_async_repacker, raw_to_feature_major) {
+  const Reference ref{make_reference(int64_t{1} << 40)};
+  write_fixed<long long, long long>(ref);
+  RawAsyncRepackerParams params{make_params(DataReaderType_t::Raw)};
+  params.i64_input_key = true;
+  params.float_label_dense = false;
+  params.i64_output_key = true;
+  params.layout = RawAsyncLayout::FeatureMajor;
+  const RawAsyncRepacker repacker(params);
+  repacker.repack({input_name}, "out");
+  check_files(repacker, expected_files<int64_t>(ref, RawAsyncLayout::FeatureMajor));
+}
+
+TEST(raw_async_repacker, norm_to_feature_major) {
+  const Reference ref{make_reference(100000)};
+  for (const bool check_sum : {false, true}) {
+    write_norm(ref, check_sum);
+    RawAsyncRepackerParams params{make_params(DataReaderType_t::Norm)};
+    params.i64_input_key = true;
+    params.layout = RawAsyncLayout::FeatureMajor;
+    const RawAsyncRepacker repacker(params);
+    repacker.repack({input_name}, "out");
+    check_files(repacker, expected_files<uint32_t>(ref, RawAsyncLayout::FeatureMajor));
+  }
+}
+
+TEST(raw_async_repacker, multiple_inputs_and_batch_size) {
+  // The same file twice, cut to whole batches of 1000 samples.
+  const Reference ref{make_reference(100000)};
+  write_norm(ref, false);
+  RawAsyncRepackerParams params{make_params(DataReaderType_t::Norm)};
+  params.i64_input_key = true;
+  params.batch_size = 1000;
+  const RawAsyncRepacker repacker(params);
+  const RawAsyncRepackerStats stats{repacker.repack({input_name, input_name}, "out")};
+  ASSERT_EQ(stats.num_samples, 10000);
+
+  std::vector<char> expected{expected_files<uint32_t>(ref, RawAsyncLayout::BatchMajor)[0]};
+  const std::vector<char> second{
+      expected_files<uint32_t>(ref, RawAsyncLayout::BatchMajor, 10000 - num_samples)[0]};
+  expected.insert(expected.end(), second.begin(), second.end());
+  check_files(repacker, {expected});
+}
+
+TEST(raw_async_repacker, striping) {
+  constexpr size_t num_dirs{3};
+  const Reference ref{make_reference(100000)};
+  write_fixed<uint32_t, float>(ref);
+  const RawAsyncRepacker repacker(make_params(DataReaderType_t::RawAsync, num_dirs));
+  repacker.repack({input_name}, "out");
+
+  // Reassemble the logical file from its stripes, unit by unit.
+  const std::vector<RawAsyncOutputFile> files{repacker.output_files("out")};
+  ASSERT_EQ(files.size(), 1);
+  ASSERT_EQ(files[0].stripes.size(), num_dirs);
+  std::vector<std::vector<char>> stripes;
+  for (const std::string& stripe : files[0].stripes) {
+    stripes.push_back(read_file(stripe));
+  }
+  constexpr size_t stripe_size{8192};
+  std::vector<char> logical;
+  for (size_t unit{0};; ++unit) {
+    const std::vector<char>& stripe{stripes[unit % num_dirs]};
+    const size_t begin{(unit / num_dirs) * stripe_size};
+    if (begin >= stripe.size()) {
+      break;
+    }
+    const size_t end{std::min(begin + stripe_size, stripe.size())};
+    logical.insert(logical.end(), stripe.begin() + begin, stripe.begin() + end);
+  }
+  EXPECT_EQ(logical, read_file(input_name));
+
+  // The manifest describes the stripes.
+  std::ifstream manifest_file(output_dir + "/d0/out.json");
+  const nlohmann::json manifest = nlohmann::json::parse(manifest_file);
+  EXPECT_EQ(manifest["num_samples"].get<size_t>(), num_samples);
+  EXPECT_EQ(manifest["stripe_size_bytes"].get<size_t>(), stripe_size);
+  EXPECT_EQ(manifest["files"][0]["stripes"].get<std::vector<std::string>>(), files[0].stripes);
+}
+
+TEST(raw_async_repacker, invalid_input) {
+  // Norm samples with a different number of keys than nnz_array.
+  const Reference ref{make_reference(100000)};
+  write_norm(ref, false);
+  RawAsyncRepackerParams params{make_params(DataReaderType_t::Norm)};
+  params.i64_input_key = true;
+  params.nnz_array = {1, 2, 3};
+  EXPECT_THROW(RawAsyncRepacker(params).repack({input_name}, "out"), std::exception);
+
+  // Keys that do not fit into uint32.
+  const Reference large{make_reference(int64_t{1} << 40)};
+  write_fixed<long long, float>(large);
+  params = make_params(DataReaderType_t::RawAsync);
+  params.i64_input_key = true;
+  EXPECT_THROW(RawAsyncRepacker(params).repack({input_name}, "out"), std::exception);
+
+  std::remove(input_name.c_str());
+  std::filesystem::remove_all(output_dir);
+}
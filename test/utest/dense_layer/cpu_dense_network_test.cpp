@@ -0,0 +1,412 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <inference/cpu_dense_network.hpp>
+#include <random>
+#include <vector>
+
+using namespace HugeCTR;
+
+namespace {
+
+std::vector<float> random_values(const size_t n, std::mt19937& gen, const float scale = 1.f) {
+  std::uniform_real_distribution<float> dist(-scale, scale);
+  std::vector<float> values(n);
+  for (float& v : values) {
+    v = dist(gen);
+  }
+  return values;
+}
+
+std::vector<CpuIsa> supported_isas() {
+  std::vector<CpuIsa> isas{CpuIsa::Scalar};
+  if (cpu_isa() >= CpuIsa::AVX2) {
+    isas.push_back(CpuIsa::AVX2);
+  }
+  if (cpu_isa() >= CpuIsa::AVX512) {
+    isas.push_back(CpuIsa::AVX512);
+  }
+  return isas;
+}
+
+/**
+ * Reference fully-connected layer: `out = in * w + b`, optionally followed by ReLU.
+ */
+std::vector<float> dense(const std::vector<float>& in, const int64_t k, const float* w,
+                         const float* b, const int64_t n, const bool relu) {
+  const int64_t m{static_cast<int64_t>(in.size()) / k};
+  std::vector<float> out(m * n);
+  for (int64_t i{0}; i < m; ++i) {
+    for (int64_t j{0}; j < n; ++j) {
+      double sum{b ? b[j] : 0.};
+      for (int64_t p{0}; p < k; ++p) {
+        sum += static_cast<double>(in[i * k + p]) * w[p * n + j];
+      }
+      out[i * n + j] = relu ? std::max(static_cast<float>(sum), 0.f) : static_cast<float>(sum);
+    }
+  }
+  return out;
+}
+
+float sigmoid(const float x) { return 1.f / (1.f + std::exp(-x)); }
+
+void expect_near(const std::vector<float>& actual, const std::vector<float>& expected,
+                 const float tolerance) {
+  ASSERT_EQ(actual.size(), expected.size());
+  for (size_t i{0}; i < actual.size(); ++i) {
+    ASSERT_NEAR(actual[i], expected[i], tolerance * (1.f + std::abs(expected[i]))) << "at " << i;
+  }
+}
+
+void gemm_test(const int64_t m, const int64_t k, const int64_t n, const bool bias,
+               const bool relu, const bool bf16, const size_t num_threads) {
+  std::mt19937 gen(m * 131 + k * 17 + n);
+  const std::vector<float> a{random_values(m * k, gen)};
+  std::vector<float> b{random_values(k * n, gen)};
+  const std::vector<float> bias_values{random_values(n, gen)};
+
+  const CpuPackedMatrix packed(b.data(), k, n, bf16);
+  if (bf16) {
+    for (float& v : b) {
+      v = bf16_to_float(float_to_bf16(v));
+    }
+  }
+  const std::vector<float> expected{
+      dense(a, k, b.data(), bias ? bias_values.data() : nullptr, n, relu)};
+
+  for (const CpuIsa isa : supported_isas()) {
+    std::vector<float> c(m * n, NAN);
+    cpu_gemm(a.data(), m, packed, bias ? bias_values.data() : nullptr, relu, c.data(),
+             num_threads, isa);
+    SCOPED_TRACE(cpu_isa_name(isa));
+    expect_near(c, expected, 1e-4f);
+  }
+}
+
+}  // namespace
+
+TEST(cpu_gemm, fp32_aligned) { gemm_test(96, 64, 32, true, false, false, 1); }
+TEST(cpu_gemm, fp32_tails) { gemm_test(37, 13, 21, true, true, false, 1); }
+TEST(cpu_gemm, fp32_deep) { gemm_test(50, 600, 40, false, true, false, 1); }
+TEST(cpu_gemm, fp32_4_threads) { gemm_test(300, 429, 100, true, true, false, 4); }
+TEST(cpu_gemm, bf16_tails) { gemm_test(37, 300, 21, true, true, true, 1); }
+TEST(cpu_gemm, bf16_4_threads) { gemm_test(200, 128, 64, true, false, true, 4); }
+
+TEST(cpu_gemm, bf16_rounding) {
+  EXPECT_EQ(float_to_bf16(1.f), 0x3f80);
+  EXPECT_EQ(bf16_to_float(float_to_bf16(-2.5f)), -2.5f);
+  // 1 + 2^-8 lies halfway between 1 and 1 + 2^-7, and rounds to the even mantissa.
+  EXPECT_EQ(float_to_bf16(1.00390625f), 0x3f80);
+  EXPECT_EQ(float_to_bf16(1.01171875f), 0x3f82);
+  EXPECT_TRUE(std::isnan(bf16_to_float(float_to_bf16(NAN))));
+}
+
+namespace {
+
+constexpr int64_t kDenseDim{13};
+constexpr int64_t kSlots{5};
+constexpr int64_t kEvSize{8};
+
+nlohmann::json input_layers() {
+  return nlohmann::json::parse(R"([
+    {"name": "data", "type": "Data", "label": {"top": "label", "label_dim": 1},
+     "dense": {"top": "dense", "dense_dim": 13},
+     "sparse": [{"top": "data1", "slot_num": 5, "is_fixed_length": false, "nnz_per_slot": 2}]},
+    {"name": "sparse_embedding1", "type": "DistributedSlotSparseEmbeddingHash",
+     "bottom": "data1", "top": "sparse_embedding1",
+     "sparse_embedding_hparam": {"embedding_vec_size": 8, "combiner": "sum",
+                                 "workspace_size_per_gpu_in_mb": 10}}
+  ])");
+}
+
+/**
+ * DLRM: bottom MLP, dot interaction and top MLP.
+ */
+nlohmann::json dlrm_graph() {
+  nlohmann::json layers = input_layers();
+  for (const auto& layer : nlohmann::json::parse(R"([
+    {"name": "mlp1", "type": "MLP", "bottom": "dense", "top": "mlp1",
+     "mlp_param": {"num_output": 8, "num_outputs": [16, 8], "activation": "Relu"}},
+    {"name": "interaction1", "type": "Interaction", "bottom": ["mlp1", "sparse_embedding1"],
+     "top": "interaction1"},
+    {"name": "mlp2", "type": "MLP", "bottom": "interaction1", "top": "mlp2",
+     "mlp_param": {"num_output": 1, "num_outputs": [32, 16, 1],
+                   "activations": ["Relu", "Relu", "None"], "biases": [true, false, true]}},
+    {"name": "loss", "type": "BinaryCrossEntropyLoss", "bottom": ["mlp2", "label"],
+     "top": "loss"}
+  ])")) {
+    layers.push_back(layer);
+  }
+  nlohmann::json graph;
+  graph["layers"] = layers;
+  return graph;
+}
+
+/**
+ * DCN: flattened embeddings concatenated with the dense features, cross layers and an MLP made of
+ * InnerProduct and ReLU layers.
+ */
+nlohmann::json dcn_graph(const int64_t projection_dim) {
+  nlohmann::json layers = input_layers();
+  for (const auto& layer : nlohmann::json::parse(R"([
+    {"name": "reshape1", "type": "Reshape", "bottom": "sparse_embedding1", "top": "reshape1",
+     "leading_dim": 40},
+    {"name": "concat1", "type": "Concat", "bottom": ["reshape1", "dense"], "top": "concat1"},
+    {"name": "multicross1", "type": "MultiCross", "bottom": "concat1", "top": "multicross1",
+     "mc_param": {"num_layers": 2}},
+    {"name": "fc1", "type": "InnerProduct", "bottom": "concat1", "top": "fc1",
+     "fc_param": {"num_output": 24}},
+    {"name": "relu1", "type": "ReLU", "bottom": "fc1", "top": "relu1"},
+    {"name": "dropout1", "type": "Dropout", "bottom": "relu1", "top": "dropout1", "rate": 0.5},
+    {"name": "concat2", "type": "Concat", "bottom": ["dropout1", "multicross1"], "top": "concat2"},
+    {"name": "fc2", "type": "InnerProduct", "bottom": "concat2", "top": "fc2",
+     "fc_param": {"num_output": 1}},
+    {"name": "sigmoid", "type": "Sigmoid", "bottom": "fc2", "top": "sigmoid"}
+  ])")) {
+    layers.push_back(layer);
+  }
+  if (projection_dim) {
+    layers[4]["mc_param"]["projection_dim"] = projection_dim;
+  }
+  nlohmann::json graph;
+  graph["layers"] = layers;
+  return graph;
+}
+
+/**
+ * Random weights, stored in the order of the dense model file.
+ */
+class Weights {
+ public:
+  Weights(std::mt19937& gen) : gen_{gen} {}
+
+  void add(const size_t n) {
+    const std::vector<float> values{random_values(n, gen_, 0.3f)};
+    offsets_.push_back(data_.size());
+    data_.insert(data_.end(), values.begin(), values.end());
+  }
+
+  const float* at(const size_t i) const { return &data_[offsets_[i]]; }
+  const std::vector<float>& data() const { return data_; }
+
+ private:
+  std::mt19937& gen_;
+  std::vector<float> data_;
+  std::vector<size_t> offsets_;
+};
+
+std::vector<float> dlrm_reference(const std::vector<float>& dense_in,
+                                  const std::vector<float>& emb, const Weights& w) {
+  const int64_t batch_size{static_cast<int64_t>(dense_in.size()) / kDenseDim};
+  std::vector<float> x{dense(dense_in, kDenseDim, w.at(0), w.at(1), 16, true)};
+  x = dense(x, 16, w.at(2), w.at(3), 8, true);
+
+  const int64_t num_rows{1 + kSlots};
+  const int64_t inter_dim{8 + num_rows * (num_rows - 1) / 2 + 1};
+  std::vector<float> inter;
+  for (int64_t s{0}; s < batch_size; ++s) {
+    std::vector<std::vector<float>> rows{{&x[s * 8], &x[(s + 1) * 8]}};
+    for (int64_t slot{0}; slot < kSlots; ++slot) {
+      const float* const v{&emb[(s * kSlots + slot) * kEvSize]};
+      rows.emplace_back(v, v + kEvSize);
+    }
+    inter.insert(inter.end(), rows[0].begin(), rows[0].end());
+    for (int64_t col{1}; col < num_rows; ++col) {
+      for (int64_t row{0}; row < col; ++row) {
+        float dot{0};
+        for (int64_t i{0}; i < kEvSize; ++i) {
+          dot += rows[row][i] * rows[col][i];
+        }
+        inter.push_back(dot);
+      }
+    }
+    inter.push_back(0);
+  }
+
+  x = dense(inter, inter_dim, w.at(4), w.at(5), 32, true);
+  x = dense(x, 32, w.at(6), nullptr, 16, true);
+  x = dense(x, 16, w.at(8), w.at(9), 1, false);
+  for (float& v : x) {
+    v = sigmoid(v);
+  }
+  return x;
+}
+
+std::vector<float> dcn_reference(const std::vector<float>& dense_in, const std::vector<float>& emb,
+                                 const Weights& w, const int64_t projection_dim) {
+  const int64_t batch_size{static_cast<int64_t>(dense_in.size()) / kDenseDim};
+  const int64_t width{kSlots * kEvSize + kDenseDim};
+  std::vector<float> x0;
+  for (int64_t s{0}; s < batch_size; ++s) {
+    x0.insert(x0.end(), &emb[s * kSlots * kEvSize], &emb[(s + 1) * kSlots * kEvSize]);
+    x0.insert(x0.end(), &dense_in[s * kDenseDim], &dense_in[(s + 1) * kDenseDim]);
+  }
+
+  size_t next{0};
+  std::vector<float> x{x0};
+  for (int l{0}; l < 2; ++l) {
+    std::vector<float> y(x.size());
+    if (projection_dim) {
+      const std::vector<float> xu{dense(x, width, w.at(next), nullptr, projection_dim, false)};
+      const std::vector<float> h{
+          dense(xu, projection_dim, w.at(next + 1), w.at(next + 2), width, false)};
+      for (size_t i{0}; i < y.size(); ++i) {
+        y[i] = x0[i] * h[i] + x[i];
+      }
+      next += 3;
+    } else {
+      const float* const k{w.at(next)};
+      const float* const b{w.at(next + 1)};
+      for (int64_t s{0}; s < batch_size; ++s) {
+        float dot{0};
+        for (int64_t i{0}; i < width; ++i) {
+          dot += x[s * width + i] * k[i];
+        }
+        for (int64_t i{0}; i < width; ++i) {
+          y[s * width + i] = x0[s * width + i] * dot + b[i] + x[s * width + i];
+        }
+      }
+      next += 2;
+    }
+    x = y;
+  }
+
+  const std::vector<float> fc1{dense(x0, width, w.at(next), w.at(next + 1), 24, true)};
+  std::vector<float> concat;
+  for (int64_t s{0}; s < batch_size; ++s) {
+    concat.insert(concat.end(), &fc1[s * 24], &fc1[(s + 1) * 24]);
+    concat.insert(concat.end(), &x[s * width], &x[(s + 1) * width]);
+  }
+  std::vector<float> out{dense(concat, 24 + width, w.at(next + 2), w.at(next + 3), 1, false)};
+  for (float& v : out) {
+    v = sigmoid(v);
+  }
+  return out;
+}
+
+void network_test(const nlohmann::json& graph, const Weights& weights,
+                  const std::vector<float>& dense_in, const std::vector<float>& emb,
+                  const std::vector<float>& expected, const bool bf16, const float tolerance) {
+  const size_t batch_size{dense_in.size() / kDenseDim};
+  for (const CpuIsa isa : supported_isas()) {
+    SCOPED_TRACE(cpu_isa_name(isa));
+    CpuDenseNetworkParams params;
+    params.max_batch_size = 64;  // Not a divisor of the batch size.
+    params.num_threads = 2;
+    params.bf16_weights = bf16;
+    params.isa = isa;
+    CpuDenseNetwork network(graph, weights.data(), params);
+    ASSERT_EQ(network.dense_dim(), kDenseDim);
+    ASSERT_EQ(network.embedding_names(), std::vector<std::string>{"sparse_embedding1"});
+    ASSERT_EQ(network.embedding_dims(), std::vector<size_t>{kSlots * kEvSize});
+    ASSERT_EQ(network.output_dim(), 1);
+
+    std::vector<float> output(batch_size, NAN);
+    network.predict(dense_in.data(), {emb.data()}, batch_size, output.data());
+    expect_near(output, expected, tolerance);
+  }
+}
+
+}  // namespace
+
+TEST(cpu_dense_network, dlrm) {
+  std::mt19937 gen(42);
+  Weights weights{gen};
+  for (const size_t n : {13 * 16, 16, 16 * 8, 8, 24 * 32, 32, 32 * 16, 16, 16, 1}) {
+    weights.add(n);
+  }
+  const size_t batch_size{150};
+  const std::vector<float> dense_in{random_values(batch_size * kDenseDim, gen)};
+  const std::vector<float> emb{random_values(batch_size * kSlots * kEvSize, gen)};
+  const std::vector<float> expected{dlrm_reference(dense_in, emb, weights)};
+
+  network_test(dlrm_graph(), weights, dense_in, emb, expected, false, 1e-4f);
+  network_test(dlrm_graph(), weights, dense_in, emb, expected, true, 2e-2f);
+}
+
+TEST(cpu_dense_network, dcn) {
+  const int64_t width{kSlots * kEvSize + kDenseDim};
+  for (const int64_t projection_dim : {0L, 12L}) {
+    SCOPED_TRACE(projection_dim);
+    std::mt19937 gen(7);
+    Weights weights{gen};
+    for (int l{0}; l < 2; ++l) {
+      if (projection_dim) {
+        weights.add(width * projection_dim);
+        weights.add(projection_dim * width);
+      } else {
+        weights.add(width);
+      }
+      weights.add(width);
+    }
+    for (const size_t n : {width * 24, 24L, (24 + width), 1L}) {
+      weights.add(n);
+    }
+    const size_t batch_size{150};
+    const std::vector<float> dense_in{random_values(batch_size * kDenseDim, gen)};
+    const std::vector<float> emb{random_values(batch_size * kSlots * kEvSize, gen)};
+    const std::vector<float> expected{dcn_reference(dense_in, emb, weights, projection_dim)};
+
+    network_test(dcn_graph(projection_dim), weights, dense_in, emb, expected, false, 1e-4f);
+  }
+}
+
+TEST(cpu_dense_network, files) {
+  std::mt19937 gen(3);
+  Weights weights{gen};
+  for (const size_t n : {13 * 16, 16, 16 * 8, 8, 24 * 32, 32, 32 * 16, 16, 16, 1}) {
+    weights.add(n);
+  }
+  const std::string graph_file{"cpu_dense_network_test.json"};
+  const std::string model_file{"cpu_dense_network_test_dense_0.model"};
+  std::ofstream(graph_file) << dlrm_graph().dump(2);
+  std::ofstream(model_file, std::ios::binary)
+      .write(reinterpret_cast<const char*>(weights.data().data()),
+             weights.data().size() * sizeof(float));
+
+  const size_t batch_size{10};
+  const std::vector<float> dense_in{random_values(batch_size * kDenseDim, gen)};
+  const std::vector<float> emb{random_values(batch_size * kSlots * kEvSize, gen)};
+  CpuDenseNetwork network(graph_file, model_file, CpuDenseNetworkParams{});
+  std::vector<float> output(batch_size);
+  network.predict(dense_in.data(), {emb.data()}, batch_size, output.data());
+  expect_near(output, dlrm_reference(dense_in, emb, weights), 1e-4f);
+
+  std::remove(graph_file.c_str());
+  std::remove(model_file.c_str());
+}
+
+TEST(cpu_dense_network, errors) {
+  std::mt19937 gen(5);
+  Weights weights{gen};
+  for (const size_t n : {13 * 16, 16, 16 * 8, 8, 24 * 32, 32, 32 * 16, 16, 16}) {
+    weights.add(n);
+  }
+  // The bias of the last layer is missing.
+  EXPECT_THROW(CpuDenseNetwork(dlrm_graph(), weights.data(), {}), std::runtime_error);
+  weights.add(1);
+  weights.add(1);
+  EXPECT_THROW(CpuDenseNetwork(dlrm_graph(), weights.data(), {}), std::runtime_error);
+
+  nlohmann::json graph = dlrm_graph();
+  graph["layers"][3]["type"] = "GRU";
+  EXPECT_THROW(CpuDenseNetwork(graph, weights.data(), {}), std::runtime_error);
+}
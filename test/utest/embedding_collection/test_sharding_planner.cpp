@@ -0,0 +1,244 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <embeddings/sharding_planner.hpp>
+#include <string>
+#include <vector>
+
+using namespace HugeCTR;
+
+namespace {
+
+ShardingTableStats make_table(const std::string& name, const int64_t vocabulary_size,
+                              const int ev_size, const double hotness = 1) {
+  ShardingTableStats table;
+  table.name = name;
+  table.vocabulary_size = vocabulary_size;
+  table.ev_size = ev_size;
+  table.hotness = hotness;
+  return table;
+}
+
+void check_consistency(const std::vector<ShardingTableStats>& tables, const ShardingPlan& plan,
+                       const size_t num_gpus) {
+  ASSERT_EQ(plan.placements.size(), tables.size());
+  const auto ids{plan.shard_matrix_ids(num_gpus)};
+  const auto names{plan.shard_matrix(tables, num_gpus)};
+  ASSERT_EQ(ids.size(), num_gpus);
+  ASSERT_EQ(names.size(), num_gpus);
+  for (size_t gpu{0}; gpu < num_gpus; ++gpu) {
+    // No GPU may be left without a table.
+    EXPECT_FALSE(names[gpu].empty()) << "GPU " << gpu;
+    size_t num_tables{0};
+    for (size_t table{0}; table < tables.size(); ++table) {
+      if (ids[gpu][table]) {
+        ASSERT_LT(num_tables, names[gpu].size());
+        EXPECT_EQ(names[gpu][num_tables++], tables[table].name);
+      }
+    }
+    EXPECT_EQ(num_tables, names[gpu].size());
+  }
+
+  // Every table belongs to exactly one group.
+  size_t num_grouped{0};
+  for (const auto& [strategy, group] : plan.shard_strategy(tables)) {
+    EXPECT_TRUE(strategy == "mp" || strategy == "dp");
+    EXPECT_FALSE(group.empty());
+    for (const std::string& name : group) {
+      const auto it{std::find_if(tables.begin(), tables.end(),
+                                 [&](const ShardingTableStats& t) { return t.name == name; })};
+      ASSERT_NE(it, tables.end());
+      EXPECT_EQ(plan.placements[it - tables.begin()].data_parallel, strategy == "dp");
+    }
+    num_grouped += group.size();
+  }
+  EXPECT_EQ(num_grouped, tables.size());
+}
+
+}  // namespace
+
+TEST(sharding_planner, expected_unique_keys) {
+  ShardingTableStats uniform{make_table("uniform", 1000000, 16)};
+  ShardingTableStats skewed{make_table("skewed", 1000000, 16)};
+  skewed.coverage = {{0.001, 0.8}, {0.1, 0.95}};
+  ShardingHardware hardware;
+  hardware.gpus_per_node = 1;
+  const ShardingPlanner planner{{uniform, skewed}, hardware, {}};
+
+  // Few accesses are nearly all distinct, many accesses saturate the vocabulary.
+  EXPECT_NEAR(planner.expected_unique_keys(0, 100), 100, 0.01);
+  EXPECT_NEAR(planner.expected_unique_keys(0, 1e9), 1e6, 1);
+  EXPECT_NEAR(planner.expected_unique_keys(0, 1e6), 1e6 * (1 - std::exp(-1)), 1);
+
+  // Skew reduces the number of distinct keys.
+  const double skewed_unique{planner.expected_unique_keys(1, 1e6)};
+  EXPECT_LT(skewed_unique, 0.5 * planner.expected_unique_keys(0, 1e6));
+  EXPECT_GT(skewed_unique, 1000);
+  EXPECT_LE(planner.expected_unique_keys(1, 10), 10);
+}
+
+TEST(sharding_planner, small_tables_data_parallel) {
+  std::vector<ShardingTableStats> tables{make_table("tiny0", 10, 128, 1),
+                                         make_table("tiny1", 20, 128, 1)};
+  for (int i{0}; i < 8; ++i) {
+    tables.push_back(make_table("large" + std::to_string(i), 50000000, 128, 1));
+  }
+  ShardingHardware hardware;
+  hardware.gpus_per_node = 8;
+  const ShardingPlan plan{ShardingPlanner{tables, hardware, {}}.plan()};
+
+  ASSERT_TRUE(plan.cost.fits);
+  EXPECT_TRUE(plan.placements[0].data_parallel);
+  EXPECT_TRUE(plan.placements[1].data_parallel);
+  for (size_t table{2}; table < tables.size(); ++table) {
+    EXPECT_FALSE(plan.placements[table].data_parallel) << tables[table].name;
+  }
+  check_consistency(tables, plan, hardware.num_gpus());
+}
+
+TEST(sharding_planner, memory_limits) {
+  // 4 x 8 GB tables on 4 GPUs with 10 GB each: exactly one table per GPU.
+  std::vector<ShardingTableStats> tables;
+  for (int i{0}; i < 4; ++i) {
+    tables.push_back(make_table("t" + std::to_string(i), 1000000000 / 64, 128));
+  }
+  ShardingHardware hardware;
+  hardware.gpus_per_node = 4;
+  hardware.memory_per_gpu = 10e9;
+  ShardingPlannerParams params;
+  params.emb_type_size = 4;
+  const ShardingPlan plan{ShardingPlanner{tables, hardware, params}.plan()};
+
+  ASSERT_TRUE(plan.cost.fits);
+  for (const double memory : plan.cost.memory) {
+    EXPECT_LE(memory, hardware.memory_per_gpu);
+  }
+  for (const ShardingTablePlacement& placement : plan.placements) {
+    EXPECT_FALSE(placement.data_parallel);
+  }
+  check_consistency(tables, plan, hardware.num_gpus());
+
+  // With Adam states the tables no longer fit.
+  params.optimizer_states = 2;
+  EXPECT_FALSE(ShardingPlanner(tables, hardware, params).plan().cost.fits);
+}
+
+TEST(sharding_planner, row_wise_split) {
+  // A table that exceeds the memory of a single GPU.
+  const std::vector<ShardingTableStats> tables{make_table("huge", 400000000, 64),
+                                               make_table("small", 1000000, 64)};
+  ShardingHardware hardware;
+  hardware.gpus_per_node = 4;
+  hardware.memory_per_gpu = 40e9;
+  const ShardingPlanner planner{tables, hardware, {}};
+  const ShardingPlan plan{planner.plan()};
+
+  ASSERT_TRUE(plan.cost.fits);
+  ASSERT_FALSE(plan.placements[0].data_parallel);
+  EXPECT_GE(plan.placements[0].gpus.size(), 4u);
+  check_consistency(tables, plan, hardware.num_gpus());
+
+  // The reported cost is reproduced by evaluate().
+  const ShardingCost cost{planner.evaluate(plan)};
+  EXPECT_DOUBLE_EQ(cost.step_time, plan.cost.step_time);
+
+  // Without row-wise splits there is no valid plan.
+  ShardingPlannerParams params;
+  params.allow_row_wise = false;
+  EXPECT_FALSE(ShardingPlanner(tables, hardware, params).plan().cost.fits);
+}
+
+TEST(sharding_planner, balances_load) {
+  // Equal tables should be spread evenly.
+  std::vector<ShardingTableStats> tables;
+  for (int i{0}; i < 16; ++i) {
+    tables.push_back(make_table("t" + std::to_string(i), 20000000, 64, 4));
+  }
+  ShardingHardware hardware;
+  hardware.gpus_per_node = 8;
+  ShardingPlannerParams params;
+  params.allow_data_parallel = false;
+  params.allow_row_wise = false;
+  const ShardingPlan plan{ShardingPlanner{tables, hardware, params}.plan()};
+
+  ASSERT_TRUE(plan.cost.fits);
+  const auto ids{plan.shard_matrix_ids(hardware.num_gpus())};
+  for (const auto& row : ids) {
+    EXPECT_EQ(std::count(row.begin(), row.end(), 1), 2);
+  }
+
+  // Any single move makes it worse.
+  const ShardingPlanner planner{tables, hardware, params};
+  ShardingPlan moved{plan};
+  moved.placements[0].gpus = {(plan.placements[0].gpus[0] + 1) % 8};
+  EXPECT_GT(planner.evaluate(moved).step_time, plan.cost.step_time);
+  check_consistency(tables, plan, hardware.num_gpus());
+
+  // Allowing row-wise splits must not lead to a worse plan.
+  params.allow_row_wise = true;
+  EXPECT_LE(ShardingPlanner(tables, hardware, params).plan().cost.step_time,
+            plan.cost.step_time * (1 + 1e-9));
+}
+
+TEST(sharding_planner, multi_node) {
+  std::vector<ShardingTableStats> tables;
+  for (int i{0}; i < 6; ++i) {
+    ShardingTableStats table{make_table("t" + std::to_string(i), 100000000, 128, 20)};
+    table.num_lookups = 1;
+    tables.push_back(table);
+  }
+  ShardingHardware hardware;
+  hardware.num_nodes = 4;
+  hardware.gpus_per_node = 8;
+  const ShardingPlanner planner{tables, hardware, {}};
+  const ShardingPlan plan{planner.plan()};
+  ASSERT_TRUE(plan.cost.fits);
+  check_consistency(tables, plan, hardware.num_gpus());
+
+  if (plan.hierarchical) {
+    // Hierarchical plans place tables on whole nodes.
+    for (const ShardingTablePlacement& placement : plan.placements) {
+      if (!placement.data_parallel) {
+        EXPECT_EQ(placement.gpus.size() % hardware.gpus_per_node, 0u);
+      }
+    }
+  }
+
+  // Pooled multi-hot lookups across a slow network benefit from reducing within the node first.
+  ShardingPlan uniform{plan};
+  uniform.hierarchical = false;
+  EXPECT_LE(planner.evaluate(plan).step_time, planner.evaluate(uniform).step_time);
+  EXPECT_TRUE(plan.hierarchical);
+}
+
+TEST(sharding_planner, invalid_input) {
+  ShardingHardware hardware;
+  EXPECT_THROW(ShardingPlanner({}, hardware, {}), std::exception);
+  EXPECT_THROW(ShardingPlanner({make_table("a", 0, 16)}, hardware, {}), std::exception);
+
+  ShardingTableStats table{make_table("a", 100, 16)};
+  table.coverage = {{0.5, 0.9}, {0.2, 0.95}};
+  EXPECT_THROW(ShardingPlanner({table}, hardware, {}), std::exception);
+
+  const ShardingPlanner planner{{make_table("a", 100, 16)}, hardware, {}};
+  ShardingPlan plan;
+  plan.placements = {{false, {42}}};
+  EXPECT_THROW(planner.evaluate(plan), std::exception);
+}
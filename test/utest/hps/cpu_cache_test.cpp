@@ -0,0 +1,240 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <limits>
+#include <nv_cpu_cache.hpp>
+#include <nv_gpu_cache.hpp>
+#include <numeric>
+#include <random>
+#include <set>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr size_t emb_vec_size = 8;
+
+template <typename KeyType>
+using Cache = gpu_cache::cpu_cache<KeyType, uint64_t, std::numeric_limits<KeyType>::max(),
+                                   SET_ASSOCIATIVITY, SLAB_SIZE>;
+
+// Every key has a unique vector, so that a hit can be checked without a reference map.
+template <typename KeyType>
+std::vector<float> make_values(const std::vector<KeyType>& keys, const float offset = 0) {
+  std::vector<float> values(keys.size() * emb_vec_size);
+  for (size_t i = 0; i < values.size(); ++i) {
+    values[i] = static_cast<float>(keys[i / emb_vec_size]) * 0.5f + (i % emb_vec_size) + offset;
+  }
+  return values;
+}
+
+template <typename KeyType>
+struct QueryResult {
+  std::vector<float> values;
+  std::vector<uint64_t> missing_index;
+  std::vector<KeyType> missing_keys;
+};
+
+template <typename KeyType>
+QueryResult<KeyType> query(Cache<KeyType>& cache, const std::vector<KeyType>& keys) {
+  QueryResult<KeyType> result;
+  result.values.resize(keys.size() * emb_vec_size);
+  result.missing_index.resize(keys.size());
+  result.missing_keys.resize(keys.size());
+  size_t missing_len = std::numeric_limits<size_t>::max();
+  cache.Query(keys.data(), keys.size(), result.values.data(), result.missing_index.data(),
+              result.missing_keys.data(), &missing_len, nullptr);
+  result.missing_index.resize(missing_len);
+  result.missing_keys.resize(missing_len);
+  return result;
+}
+
+template <typename KeyType>
+std::set<KeyType> dump(Cache<KeyType>& cache) {
+  std::vector<KeyType> keys(cache.capacity_in_set() * Cache<KeyType>::slots_per_set);
+  size_t dump_counter = 0;
+  cache.Dump(keys.data(), &dump_counter, 0, cache.capacity_in_set(), nullptr);
+  keys.resize(dump_counter);
+  std::set<KeyType> unique_keys(keys.begin(), keys.end());
+  EXPECT_EQ(unique_keys.size(), keys.size());
+  return unique_keys;
+}
+
+template <typename KeyType>
+void cpu_cache_query_replace_test(const size_t num_threads) {
+  constexpr size_t capacity_in_set = 1024;
+  Cache<KeyType> cache(capacity_in_set, emb_vec_size, num_threads);
+
+  // Fill a quarter of the cache, so that no set overflows.
+  std::vector<KeyType> keys(capacity_in_set * Cache<KeyType>::slots_per_set / 4);
+  std::iota(keys.begin(), keys.end(), 1000);
+  const std::vector<float> values = make_values(keys);
+  cache.Replace(keys.data(), keys.size(), values.data(), nullptr);
+
+  auto result = query(cache, keys);
+  EXPECT_TRUE(result.missing_keys.empty());
+  EXPECT_EQ(result.values, values);
+  EXPECT_EQ(dump(cache), std::set<KeyType>(keys.begin(), keys.end()));
+
+  // Interleave unknown keys (and the empty key, which is never a hit).
+  std::vector<KeyType> mixed;
+  for (size_t i = 0; i < keys.size(); ++i) {
+    mixed.push_back(keys[i]);
+    mixed.push_back(i % 7 == 0 ? std::numeric_limits<KeyType>::max() : keys[i] + 100000);
+  }
+  result = query(cache, mixed);
+  ASSERT_EQ(result.missing_keys.size(), keys.size());
+  std::vector<uint64_t> missing_index(result.missing_index);
+  std::sort(missing_index.begin(), missing_index.end());
+  for (size_t i = 0; i < missing_index.size(); ++i) {
+    ASSERT_EQ(missing_index[i], 2 * i + 1);
+  }
+  for (size_t i = 0; i < result.missing_keys.size(); ++i) {
+    ASSERT_EQ(result.missing_keys[i], mixed[result.missing_index[i]]);
+  }
+  for (size_t i = 0; i < keys.size(); ++i) {
+    ASSERT_TRUE(std::equal(&values[i * emb_vec_size], &values[(i + 1) * emb_vec_size],
+                           &result.values[2 * i * emb_vec_size]));
+  }
+
+  // Replacing keys again, with duplicates, does not duplicate them in the cache.
+  std::vector<KeyType> duplicates(keys);
+  duplicates.insert(duplicates.end(), keys.begin(), keys.end());
+  const std::vector<float> duplicate_values = make_values(duplicates);
+  cache.Replace(duplicates.data(), duplicates.size(), duplicate_values.data(), nullptr);
+  EXPECT_EQ(dump(cache).size(), keys.size());
+}
+
+template <typename KeyType>
+void cpu_cache_lru_test() {
+  // A single set, so that every replacement competes for the same slots.
+  constexpr size_t num_slots = Cache<KeyType>::slots_per_set;
+  Cache<KeyType> cache(1, emb_vec_size);
+
+  std::vector<KeyType> keys(num_slots);
+  std::iota(keys.begin(), keys.end(), 0);
+  std::vector<float> values = make_values(keys);
+  cache.Replace(keys.data(), keys.size(), values.data(), nullptr);
+
+  // Touch the even keys, and then insert new keys for half the set.
+  std::vector<KeyType> recent;
+  std::vector<KeyType> stale;
+  for (const KeyType k : keys) {
+    (k % 2 ? stale : recent).push_back(k);
+  }
+  EXPECT_TRUE(query(cache, recent).missing_keys.empty());
+
+  std::vector<KeyType> new_keys(num_slots / 2);
+  std::iota(new_keys.begin(), new_keys.end(), num_slots);
+  values = make_values(new_keys);
+  cache.Replace(new_keys.data(), new_keys.size(), values.data(), nullptr);
+
+  std::set<KeyType> expected(recent.begin(), recent.end());
+  expected.insert(new_keys.begin(), new_keys.end());
+  EXPECT_EQ(dump(cache), expected);
+  EXPECT_EQ(query(cache, stale).missing_keys.size(), stale.size());
+  EXPECT_TRUE(query(cache, new_keys).missing_keys.empty());
+}
+
+template <typename KeyType>
+void cpu_cache_update_test() {
+  Cache<KeyType> cache(64, emb_vec_size);
+  std::vector<KeyType> keys(500);
+  std::iota(keys.begin(), keys.end(), 0);
+  std::vector<float> values = make_values(keys);
+  cache.Replace(keys.data(), keys.size(), values.data(), nullptr);
+
+  // Update existing and unknown keys. Unknown keys must not be inserted.
+  std::vector<KeyType> update_keys(keys);
+  for (size_t i = 0; i < keys.size(); ++i) {
+    update_keys.push_back(keys[i] + 10000);
+  }
+  const std::vector<float> update_values = make_values(update_keys, 1.f);
+  cache.Update(update_keys.data(), update_keys.size(), update_values.data(), nullptr);
+
+  const auto result = query(cache, keys);
+  EXPECT_TRUE(result.missing_keys.empty());
+  EXPECT_TRUE(std::equal(result.values.begin(), result.values.end(), update_values.begin()));
+  EXPECT_EQ(dump(cache), std::set<KeyType>(keys.begin(), keys.end()));
+}
+
+template <typename KeyType>
+void cpu_cache_concurrency_test() {
+  constexpr size_t num_workers = 4;
+  constexpr size_t num_batches = 50;
+  constexpr size_t batch_size = 4096;
+  Cache<KeyType> cache(256, emb_vec_size, 2, 16);
+
+  // Workers query random keys and replace their misses, like a lookup session. Hits always have to
+  // return the vector of the requested key, while other workers are evicting.
+  std::vector<std::thread> workers;
+  std::vector<size_t> num_errors(num_workers, 0);
+  for (size_t w = 0; w < num_workers; ++w) {
+    workers.emplace_back([&, w]() {
+      std::mt19937_64 gen(w);
+      std::uniform_int_distribution<KeyType> key_dist(0, 100000);
+      for (size_t b = 0; b < num_batches; ++b) {
+        std::vector<KeyType> keys(batch_size);
+        for (auto& k : keys) {
+          k = key_dist(gen);
+        }
+        const auto result = query(cache, keys);
+        const std::vector<float> expected = make_values(keys);
+        std::vector<bool> missing(keys.size(), false);
+        for (const uint64_t i : result.missing_index) {
+          missing[i] = true;
+        }
+        for (size_t i = 0; i < keys.size(); ++i) {
+          if (!missing[i] && !std::equal(&expected[i * emb_vec_size],
+                                         &expected[(i + 1) * emb_vec_size],
+                                         &result.values[i * emb_vec_size])) {
+            ++num_errors[w];
+          }
+        }
+        const std::vector<float> missing_values = make_values(result.missing_keys);
+        cache.Replace(result.missing_keys.data(), result.missing_keys.size(),
+                      missing_values.data(), nullptr);
+      }
+    });
+  }
+  for (auto& worker : workers) {
+    worker.join();
+  }
+  for (const size_t n : num_errors) {
+    EXPECT_EQ(n, 0);
+  }
+  EXPECT_EQ(dump(cache).size(), cache.capacity_in_set() * Cache<KeyType>::slots_per_set);
+}
+
+}  // namespace
+
+TEST(cpu_cache, query_replace_uint32) { cpu_cache_query_replace_test<unsigned int>(1); }
+TEST(cpu_cache, query_replace_int64) { cpu_cache_query_replace_test<long long>(1); }
+TEST(cpu_cache, query_replace_int64_4_threads) { cpu_cache_query_replace_test<long long>(4); }
+TEST(cpu_cache, lru_uint32) { cpu_cache_lru_test<unsigned int>(); }
+TEST(cpu_cache, lru_int64) { cpu_cache_lru_test<long long>(); }
+TEST(cpu_cache, update_int64) { cpu_cache_update_test<long long>(); }
+TEST(cpu_cache, concurrency_uint32) { cpu_cache_concurrency_test<unsigned int>(); }
+TEST(cpu_cache, concurrency_int64) { cpu_cache_concurrency_test<long long>(); }
+
+TEST(cpu_cache, invalid_arguments) {
+  EXPECT_THROW(Cache<long long>(0, emb_vec_size), std::invalid_argument);
+  EXPECT_THROW(Cache<long long>(16, 0), std::invalid_argument);
+  EXPECT_THROW(Cache<long long>(16, emb_vec_size, 0), std::invalid_argument);
+}
@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <hps/unique_op/cpu_unique_op.hpp>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+using namespace HugeCTR;
+
+namespace {
+
+template <typename TypeHashKey>
+void cpu_unique_op_test(const size_t num_keys, const size_t vocabulary_size,
+                        const size_t emb_vec_size, const size_t num_batches) {
+  std::mt19937_64 gen(4711);
+  std::uniform_int_distribution<TypeHashKey> key_dist(0, vocabulary_size - 1);
+  unique_op::CpuUniqueOp<TypeHashKey> unique_op;
+
+  for (size_t batch = 0; batch < num_batches; ++batch) {
+    // Batch size varies, so that the hash set is reused, and also has to grow.
+    const size_t batch_size = num_keys >> (num_batches - 1 - batch);
+    std::vector<TypeHashKey> keys(batch_size);
+    for (auto& k : keys) {
+      k = key_dist(gen);
+    }
+
+    // Dedup in-place, like the embedding cache does.
+    std::vector<TypeHashKey> unique_keys(keys);
+    const size_t num_unique = unique_op.unique(unique_keys.data(), batch_size, unique_keys.data());
+    unique_keys.resize(num_unique);
+
+    std::unordered_map<TypeHashKey, size_t> first;
+    for (size_t i = 0; i < batch_size; ++i) {
+      first.emplace(keys[i], first.size());
+    }
+    ASSERT_EQ(num_unique, first.size());
+    ASSERT_EQ(unique_op.num_keys(), batch_size);
+    for (size_t i = 0; i < num_unique; ++i) {
+      ASSERT_EQ(first.at(unique_keys[i]), i);
+    }
+    if (batch_size > 0) {
+      EXPECT_DOUBLE_EQ(unique_op.dedup_ratio(), 1.0 - static_cast<double>(num_unique) /
+                                                          static_cast<double>(batch_size));
+    }
+
+    // Simulate the parameter server lookup, and check that rows end up with their keys.
+    std::vector<float> values(batch_size * emb_vec_size);
+    for (size_t i = 0; i < num_unique; ++i) {
+      for (size_t j = 0; j < emb_vec_size; ++j) {
+        values[i * emb_vec_size + j] = static_cast<float>(unique_keys[i]) + 0.001f * j;
+      }
+    }
+    unique_op.expand(values.data(), emb_vec_size);
+    for (size_t i = 0; i < batch_size; ++i) {
+      for (size_t j = 0; j < emb_vec_size; ++j) {
+        ASSERT_EQ(values[i * emb_vec_size + j], static_cast<float>(keys[i]) + 0.001f * j);
+      }
+    }
+  }
+}
+
+}  // namespace
+
+TEST(cpu_unique_op, long_long_heavy_duplicates) {
+  cpu_unique_op_test<long long>(16384, 1000, 16, 4);
+}
+TEST(cpu_unique_op, long_long_no_duplicates) {
+  cpu_unique_op_test<long long>(4096, 1L << 40, 8, 1);
+}
+TEST(cpu_unique_op, unsigned_int) { cpu_unique_op_test<unsigned int>(10000, 5000, 7, 3); }
+TEST(cpu_unique_op, empty) { cpu_unique_op_test<unsigned int>(0, 10, 4, 1); }
@@ -16,18 +16,24 @@
 
 #include <cuda_profiler_api.h>
 #include <gtest/gtest.h>
+#include <numa.h>
 
 #include <cassert>
+#include <cmath>
 #include <core23/logger.hpp>
 #include <filesystem>
 #include <fstream>
+#include <hps/admission_filter.hpp>
 #include <hps/database_backend.hpp>
 #include <hps/hash_map_backend.hpp>
 #include <hps/hier_parameter_server_base.hpp>
 #include <hps/mp_hash_map_backend.hpp>
 #include <hps/redis_backend.hpp>
 #include <hps/rocksdb_backend.hpp>
+#include <hps/versioned_table.hpp>
 #include <memory>
+#include <numeric>
+#include <thread>
 #include <vector>
 
 using namespace HugeCTR;
@@ -249,8 +255,523 @@ void db_backend_dump_test(DatabaseType_t database_type) {
   }
 }
 
+template <typename Key>
+void db_backend_numa_test(const size_t num_partitions) {
+  HashMapBackendParams params;
+  params.num_partitions = num_partitions;
+  params.allocation_rate = 1024 * 1024;
+  params.numa_aware = true;
+  HashMapBackend<Key> hm_db(params);
+  DatabaseBackendBase<Key>& db{hm_db};
+
+  // Partitions are spread round-robin (if NUMA is available at all).
+  const int num_nodes{numa_available() < 0 ? 0 : numa_num_configured_nodes()};
+  for (size_t i{0}; i < num_partitions; ++i) {
+    EXPECT_LT(hm_db.numa_node(i), num_nodes);
+  }
+
+  const std::string& tag{HierParameterServerBase::make_tag_name("numa", "test")};
+
+  // Insert some KV pairs (single + vector mode).
+  std::vector<Key> keys(1000);
+  std::vector<double> values(keys.size());
+  for (size_t i{0}; i < keys.size(); ++i) {
+    keys[i] = static_cast<Key>(i);
+    values[i] = static_cast<double>(i * i);
+  }
+  db.insert(tag, 1, keys.data(), reinterpret_cast<char*>(values.data()), sizeof(double),
+            sizeof(double));
+  EXPECT_EQ(db.insert(tag, keys.size() - 1, &keys[1], reinterpret_cast<char*>(&values[1]),
+                      sizeof(double), sizeof(double)),
+            keys.size() - 1);
+  EXPECT_EQ(db.size(tag), keys.size());
+
+  // Fetch them back.
+  std::vector<double> fetched(keys.size());
+  EXPECT_EQ(db.fetch(tag, keys.size(), keys.data(), reinterpret_cast<char*>(fetched.data()),
+                     sizeof(double), [&](size_t index) { FAIL(); }),
+            keys.size());
+  EXPECT_EQ(fetched, values);
+
+  // Evict half of them.
+  EXPECT_EQ(db.evict(tag, keys.size() / 2, keys.data()), keys.size() / 2);
+  EXPECT_EQ(db.contains(tag, keys.size(), keys.data(), std::chrono::nanoseconds::zero()),
+            keys.size() - keys.size() / 2);
+}
+
+template <typename Key>
+void db_backend_versioned_test() {
+  HashMapBackendParams params;
+  params.allocation_rate = 1024 * 1024;
+  HashMapBackend<Key> db(params);
+  HashMapBackend<Key> write_through_db(params);
+
+  const std::string& tag{HierParameterServerBase::make_tag_name("versioned", "test")};
+  VersionedTable<Key> table(db, tag, &write_through_db);
+
+  // Version 0 (base table).
+  std::vector<Key> keys(1000);
+  std::vector<double> values(keys.size());
+  for (size_t i{0}; i < keys.size(); ++i) {
+    keys[i] = static_cast<Key>(i);
+    values[i] = static_cast<double>(i);
+  }
+  db.insert(tag, keys.size(), keys.data(), reinterpret_cast<char*>(values.data()),
+            sizeof(double), sizeof(double));
+
+  // Update every 10th row and add some new rows. Staged rows must not be visible.
+  std::vector<Key> new_keys;
+  std::vector<double> new_values;
+  for (size_t i{0}; i < keys.size() + 10; i += i < keys.size() ? 10 : 1) {
+    new_keys.emplace_back(static_cast<Key>(i));
+    new_values.emplace_back(-static_cast<double>(i));
+  }
+  EXPECT_EQ(table.stage(new_keys.size(), new_keys.data(),
+                        reinterpret_cast<char*>(new_values.data()), sizeof(double),
+                        sizeof(double)),
+            new_keys.size());
+
+  std::vector<Key> all_keys(keys.size() + 10);
+  std::iota(all_keys.begin(), all_keys.end(), 0);
+  std::vector<double> fetched(all_keys.size());
+  const auto fetch = [&]() {
+    return table.fetch(all_keys.size(), all_keys.data(), reinterpret_cast<char*>(fetched.data()),
+                       sizeof(double), [&](size_t index) { fetched[index] = NAN; });
+  };
+  EXPECT_EQ(fetch(), keys.size());
+  EXPECT_EQ(fetched[10], 10);
+  EXPECT_TRUE(std::isnan(fetched[1005]));
+
+  // Publish version 1, while a reader still holds on to version 0.
+  std::shared_ptr<const typename VersionedTable<Key>::Version> pinned{table.pin()};
+  EXPECT_EQ(pinned->id, 0);
+  std::vector<Key> published_keys;
+  EXPECT_EQ(table.publish(&published_keys), 1);
+  EXPECT_EQ(published_keys, new_keys);
+  EXPECT_EQ(table.pin()->id, 1);
+  EXPECT_EQ(fetch(), all_keys.size());
+  for (size_t i{0}; i < all_keys.size(); ++i) {
+    EXPECT_EQ(fetched[i], i < keys.size() && i % 10 ? i : -static_cast<double>(i));
+  }
+  // Rows are shared, not copied.
+  EXPECT_EQ(db.size(tag), keys.size());
+  EXPECT_EQ(db.size(table.pin()->delta_table_name), new_keys.size());
+
+  // Reclaiming must wait for the reader of version 0.
+  std::thread reclaimer([&]() { EXPECT_EQ(table.reclaim(), new_keys.size()); });
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  EXPECT_FALSE(table.pin()->delta_table_name.empty());
+  EXPECT_EQ(db.size(tag), keys.size());
+  pinned.reset();
+  reclaimer.join();
+
+  // The delta has been merged into the base table.
+  EXPECT_EQ(table.pin()->id, 1);
+  EXPECT_TRUE(table.pin()->delta_table_name.empty());
+  EXPECT_EQ(db.find_tables("versioned").size(), 1);
+  EXPECT_EQ(db.size(tag), all_keys.size());
+  EXPECT_EQ(fetch(), all_keys.size());
+  for (size_t i{0}; i < all_keys.size(); ++i) {
+    EXPECT_EQ(fetched[i], i < keys.size() && i % 10 ? i : -static_cast<double>(i));
+  }
+
+  // ... and written through, so that evicted rows do not fall back to their previous version.
+  EXPECT_EQ(write_through_db.find_tables("versioned").size(), 1);
+  EXPECT_EQ(write_through_db.size(tag), new_keys.size());
+  EXPECT_EQ(write_through_db.fetch(tag, new_keys.size(), new_keys.data(),
+                                   reinterpret_cast<char*>(fetched.data()), sizeof(double),
+                                   [](size_t) {}, std::chrono::nanoseconds::zero()),
+            new_keys.size());
+  for (size_t i{0}; i < new_keys.size(); ++i) {
+    EXPECT_EQ(fetched[i], new_values[i]);
+  }
+}
+
+template <typename Key>
+void db_backend_versioned_lost_rows_test() {
+  HashMapBackendParams params;
+  params.num_partitions = 1;
+  params.allocation_rate = 1024 * 1024;
+  params.max_batch_size = 10;
+  params.overflow_margin = 100;
+  HashMapBackend<Key> db(params);
+
+  const std::string& tag{HierParameterServerBase::make_tag_name("versioned", "lost")};
+  VersionedTable<Key> table(db, tag);
+
+  std::vector<Key> keys(50);
+  std::iota(keys.begin(), keys.end(), 0);
+  std::vector<double> values(keys.size(), 1);
+  db.insert(tag, keys.size(), keys.data(), reinterpret_cast<char*>(values.data()),
+            sizeof(double), sizeof(double));
+
+  // The delta overflows. Publishing must fail, instead of mixing old and new rows.
+  std::vector<Key> new_keys(150);
+  std::iota(new_keys.begin(), new_keys.end(), 0);
+  std::vector<double> new_values(new_keys.size(), 2);
+  table.stage(new_keys.size(), new_keys.data(), reinterpret_cast<char*>(new_values.data()),
+              sizeof(double), sizeof(double));
+  EXPECT_THROW(table.publish(), std::exception);
+  EXPECT_EQ(table.num_staged(), 0);
+  EXPECT_EQ(table.pin()->id, 0);
+  EXPECT_EQ(db.find_tables("versioned").size(), 1);
+
+  // The next update starts over.
+  table.stage(keys.size(), keys.data(), reinterpret_cast<char*>(new_values.data()),
+              sizeof(double), sizeof(double));
+  EXPECT_EQ(table.publish(), 1);
+  EXPECT_EQ(table.reclaim(), keys.size());
+  EXPECT_EQ(table.fetch(keys.size(), keys.data(), reinterpret_cast<char*>(values.data()),
+                        sizeof(double), [](size_t) {}),
+            keys.size());
+  EXPECT_EQ(values, std::vector<double>(keys.size(), 2));
+}
+
+template <typename Key>
+void db_backend_hot_keys_test() {
+  // Heavy hitters are found, regardless of the noise.
+  {
+    HotKeyTracker<Key> tracker(8, 1);
+    std::vector<Key> keys;
+    for (size_t i{0}; i < 100000; ++i) {
+      keys.emplace_back(static_cast<Key>(i % 4 ? 1000 + i : i % 32));
+    }
+    tracker.record(keys.size(), keys.data());
+
+    const auto& top{tracker.top()};
+    ASSERT_EQ(top.size(), 8);
+    for (const auto& [key, count] : top) {
+      EXPECT_LT(key, 32);
+      EXPECT_GE(count, keys.size() / 4 / 8);
+    }
+  }
+
+  HashMapBackendParams params;
+  params.num_partitions = 16;
+  params.allocation_rate = 1024 * 1024;
+  params.hot_key_capacity = 64;
+  params.hot_key_refresh_interval = 10000;
+  HashMapBackend<Key> hm_db(params);
+  DatabaseBackendBase<Key>& db{hm_db};
+
+  const std::string& tag{HierParameterServerBase::make_tag_name("hot", "keys")};
+
+  std::vector<Key> keys(10000);
+  std::vector<double> values(keys.size());
+  for (size_t i{0}; i < keys.size(); ++i) {
+    keys[i] = static_cast<Key>(i);
+    values[i] = static_cast<double>(i);
+  }
+  db.insert(tag, keys.size(), keys.data(), reinterpret_cast<char*>(values.data()), sizeof(double),
+            sizeof(double));
+
+  // Skewed traffic: Half of the keys in each batch are drawn from 16 hot keys.
+  std::vector<Key> batch(1000);
+  std::vector<double> fetched(batch.size());
+  std::vector<size_t> indices(batch.size() / 2);
+  std::iota(indices.begin(), indices.end(), batch.size() / 4);
+  for (size_t n{0}; n < 100; ++n) {
+    for (size_t i{0}; i < batch.size(); ++i) {
+      batch[i] = static_cast<Key>(i % 2 ? (n * 7919 + i * 104729) % keys.size() : i % 16);
+    }
+    if (n % 2) {
+      EXPECT_EQ(db.fetch(tag, batch.size(), batch.data(), reinterpret_cast<char*>(fetched.data()),
+                         sizeof(double), [&](size_t index) { FAIL(); }),
+                batch.size());
+    } else {
+      EXPECT_EQ(db.fetch(tag, indices.size(), indices.data(), batch.data(),
+                         reinterpret_cast<char*>(fetched.data()), sizeof(double),
+                         [&](size_t index) { FAIL(); }),
+                indices.size());
+    }
+    for (size_t i{n % 2 ? 0 : indices.front()}; i < (n % 2 ? batch.size() : indices.back()); ++i) {
+      ASSERT_EQ(fetched[i], static_cast<double>(batch[i]));
+    }
+  }
+
+  // Hot keys are served by the replica, which reduces skew.
+  HashMapBackendLoadStats stats{hm_db.load_stats(tag)};
+  EXPECT_EQ(stats.partition_loads.size(), params.num_partitions);
+  EXPECT_GE(stats.replica_size, 16);
+  EXPECT_GT(stats.replica_hits, 0);
+  EXPECT_EQ(std::accumulate(stats.partition_loads.begin(), stats.partition_loads.end(),
+                            stats.replica_hits),
+            50 * (batch.size() + indices.size()));
+
+  // Updates and evictions are visible immediately.
+  const Key hot_key{3};
+  const double hot_value{-1};
+  db.insert(tag, 1, &hot_key, reinterpret_cast<const char*>(&hot_value), sizeof(double),
+            sizeof(double));
+  double value;
+  EXPECT_EQ(db.fetch(tag, 1, &hot_key, reinterpret_cast<char*>(&value), sizeof(double),
+                     [&](size_t index) { FAIL(); }),
+            1);
+  EXPECT_EQ(value, hot_value);
+  EXPECT_EQ(db.evict(tag, 1, &hot_key), 1);
+  EXPECT_EQ(db.fetch(tag, 1, &hot_key, reinterpret_cast<char*>(&value), sizeof(double),
+                     [&](size_t index) {}),
+            0);
+  EXPECT_LE(hm_db.load_stats(tag).replica_size, params.hot_key_capacity);
+}
+
+template <typename Key>
+void db_backend_table_stats_test() {
+  constexpr size_t value_dim{8};
+  constexpr uint32_t value_size{value_dim * sizeof(double)};
+
+  HashMapBackendParams params;
+  params.max_batch_size = 100;
+  params.num_partitions = 1;
+  params.allocation_rate = 1024 * value_size;
+  params.overflow_margin = 1000;
+  params.overflow_policy = DatabaseOverflowPolicy_t::EvictRandom;
+  params.overflow_resolution_target = 0.8;
+  HashMapBackend<Key> hm_db(params);
+  DatabaseBackendBase<Key>& db{hm_db};
+
+  const std::string& tag{HierParameterServerBase::make_tag_name("stats", "table")};
+  DatabaseTableStats stats{db.table_stats(tag)};
+  EXPECT_EQ(stats.num_keys, 0);
+  EXPECT_EQ(stats.bytes_allocated, 0);
+
+  std::vector<Key> keys(5000);
+  std::iota(keys.begin(), keys.end(), 0);
+  std::vector<double> values(keys.size() * value_dim, 1);
+  db.insert(tag, keys.size(), keys.data(), reinterpret_cast<char*>(values.data()), value_size,
+            value_size);
+
+  // Every key was either kept or evicted, and evicted slots are reused.
+  stats = db.table_stats(tag);
+  EXPECT_EQ(stats.num_keys, db.size(tag));
+  EXPECT_LE(stats.num_keys, params.overflow_margin);
+  EXPECT_GT(stats.num_overflows, 0);
+  EXPECT_EQ(stats.num_keys + stats.num_evictions, keys.size());
+  EXPECT_EQ(stats.bytes_resident, stats.num_keys * value_size);
+  EXPECT_EQ(stats.bytes_allocated, stats.bytes_resident + stats.free_slot_bytes);
+  EXPECT_EQ(stats.bytes_allocated % params.allocation_rate, 0);
+  EXPECT_LE(stats.bytes_allocated, 2 * params.allocation_rate);
+
+  // Evicted keys leave free slots behind.
+  EXPECT_EQ(db.evict(tag, 10, keys.data() + keys.size() - 10), 10);
+  const DatabaseTableStats prev_stats{stats};
+  stats = db.table_stats(tag);
+  EXPECT_EQ(stats.num_keys, prev_stats.num_keys - 10);
+  EXPECT_EQ(stats.free_slot_bytes, prev_stats.free_slot_bytes + 10 * value_size);
+  EXPECT_EQ(stats.bytes_allocated, prev_stats.bytes_allocated);
+  EXPECT_EQ(stats.num_evictions, prev_stats.num_evictions);
+
+  db.evict(tag);
+  EXPECT_EQ(db.table_stats(tag).num_keys, 0);
+  EXPECT_EQ(db.table_stats(tag).num_overflows, 0);
+
+  // Lookup counters.
+  HPSTableCounters counters;
+  counters.volatile_db.record(100, 75);
+  counters.volatile_db.record(100, 25);
+  counters.persistent_db.record(100, 60);
+  counters.record_defaults(40);
+  counters.record_elevations(60, 15);
+  counters.record_host_dedup(400, 100);
+  HPSTableStats table_stats;
+  counters.snapshot(table_stats);
+  EXPECT_EQ(table_stats.embedding_cache.num_lookups, 0);
+  EXPECT_EQ(table_stats.embedding_cache.hit_ratio(), 0.0);
+  EXPECT_EQ(table_stats.volatile_db.num_lookups, 200);
+  EXPECT_EQ(table_stats.volatile_db.num_misses(), 100);
+  EXPECT_EQ(table_stats.volatile_db.hit_ratio(), 0.5);
+  EXPECT_EQ(table_stats.persistent_db.num_hits, 60);
+  EXPECT_EQ(table_stats.num_defaults, 40);
+  EXPECT_EQ(table_stats.num_elevation_candidates, 60);
+  EXPECT_EQ(table_stats.num_elevations, 15);
+  EXPECT_EQ(table_stats.elevation_admission_ratio(), 0.25);
+  EXPECT_EQ(table_stats.num_host_keys, 400);
+  EXPECT_EQ(table_stats.host_dedup_ratio(), 0.75);
+}
+
+template <typename Key>
+void db_backend_compaction_test() {
+  constexpr size_t value_dim{8};
+  constexpr uint32_t value_size{value_dim * sizeof(double)};
+  constexpr size_t values_per_page{64};
+
+  HashMapBackendParams params;
+  params.num_partitions = 4;
+  params.allocation_rate = values_per_page * value_size;
+  HashMapBackend<Key> hm_db(params);
+  DatabaseBackendBase<Key>& db{hm_db};
+
+  const std::string& tag{HierParameterServerBase::make_tag_name("compaction", "table")};
+  std::vector<Key> keys(10000);
+  std::iota(keys.begin(), keys.end(), 0);
+  std::vector<double> values(keys.size() * value_dim);
+  for (size_t i{0}; i < values.size(); ++i) {
+    values[i] = static_cast<double>(i);
+  }
+  db.insert(tag, keys.size(), keys.data(), reinterpret_cast<char*>(values.data()), value_size,
+            value_size);
+
+  // Evict 90% of the keys, scattered across all pages.
+  std::vector<Key> evicted_keys;
+  std::vector<Key> live_keys;
+  for (const Key key : keys) {
+    (key % 10 ? evicted_keys : live_keys).emplace_back(key);
+  }
+  EXPECT_EQ(db.evict(tag, evicted_keys.size(), evicted_keys.data()), evicted_keys.size());
+  const DatabaseTableStats before{db.table_stats(tag)};
+  EXPECT_EQ(before.num_keys, live_keys.size());
+  EXPECT_GE(before.bytes_allocated, keys.size() * value_size);
+
+  // Compacting in small steps makes progress.
+  size_t released{0};
+  for (size_t i{0}; i < 100 && !released; ++i) {
+    released = hm_db.compact(tag, std::chrono::microseconds::zero());
+  }
+  EXPECT_GT(released, 0);
+  EXPECT_EQ(db.table_stats(tag).bytes_allocated, before.bytes_allocated - released);
+
+  // With enough time, all sparse pages are released.
+  hm_db.compact(tag, std::chrono::seconds(10));
+  const DatabaseTableStats after{db.table_stats(tag)};
+  EXPECT_EQ(after.num_keys, live_keys.size());
+  EXPECT_LE(after.bytes_allocated,
+            (live_keys.size() / params.num_partitions / values_per_page + 2) *
+                params.num_partitions * params.allocation_rate);
+  EXPECT_EQ(after.bytes_allocated, after.bytes_resident + after.free_slot_bytes);
+  EXPECT_EQ(hm_db.compact(tag, std::chrono::seconds(10)), 0);
+
+  // Values were moved intact.
+  const auto check_values{[&](DatabaseBackendBase<Key>& db) {
+    std::vector<double> fetched(live_keys.size() * value_dim);
+    EXPECT_EQ(db.fetch(tag, live_keys.size(), live_keys.data(),
+                       reinterpret_cast<char*>(fetched.data()), value_size,
+                       [&](size_t index) { FAIL(); }),
+              live_keys.size());
+    for (size_t i{0}; i < live_keys.size(); ++i) {
+      for (size_t j{0}; j < value_dim; ++j) {
+        ASSERT_EQ(fetched[i * value_dim + j],
+                  static_cast<double>(static_cast<size_t>(live_keys[i]) * value_dim + j));
+      }
+    }
+  }};
+  check_values(db);
+
+  // Free slots remain usable.
+  db.insert(tag, evicted_keys.size(), evicted_keys.data(), reinterpret_cast<char*>(values.data()),
+            value_size, value_size);
+  EXPECT_EQ(db.size(tag), keys.size());
+  check_values(db);
+
+  // Small steps resume correctly, also if keys are evicted and inserted between them.
+  HashMapBackend<Key> step_db(params);
+  step_db.insert(tag, keys.size(), keys.data(), reinterpret_cast<char*>(values.data()),
+                 value_size, value_size);
+  step_db.evict(tag, evicted_keys.size(), evicted_keys.data());
+  std::vector<double> churn_values(32 * value_dim);
+  for (size_t i{0}; i < 2000; ++i) {
+    std::vector<Key> churn_keys;
+    for (size_t j{0}; j < 32; ++j) {
+      const Key key{live_keys[(i * 32 + j) * 7 % live_keys.size()]};
+      churn_keys.emplace_back(key);
+      std::copy_n(&values[static_cast<size_t>(key) * value_dim], value_dim,
+                  &churn_values[j * value_dim]);
+    }
+    step_db.evict(tag, churn_keys.size(), churn_keys.data());
+    step_db.compact(tag, std::chrono::microseconds::zero());
+    step_db.insert(tag, churn_keys.size(), churn_keys.data(),
+                   reinterpret_cast<char*>(churn_values.data()), value_size, value_size);
+  }
+  step_db.compact(tag, std::chrono::seconds(10));
+  const DatabaseTableStats stepped{step_db.table_stats(tag)};
+  EXPECT_EQ(stepped.num_keys, live_keys.size());
+  EXPECT_LE(stepped.bytes_allocated, after.bytes_allocated);
+  EXPECT_EQ(stepped.bytes_allocated, stepped.bytes_resident + stepped.free_slot_bytes);
+  check_values(step_db);
+
+  // Compaction in the background.
+  params.compaction_interval_ms = 1;
+  HashMapBackend<Key> bg_db(params);
+  bg_db.insert(tag, keys.size(), keys.data(), reinterpret_cast<char*>(values.data()), value_size,
+               value_size);
+  bg_db.evict(tag, evicted_keys.size(), evicted_keys.data());
+  for (size_t i{0}; i < 1000 && bg_db.table_stats(tag).bytes_allocated > after.bytes_allocated;
+       ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  EXPECT_LE(bg_db.table_stats(tag).bytes_allocated, after.bytes_allocated);
+}
+
+template <typename Key>
+void db_backend_admission_filter_test() {
+  // A key is admitted with its third request. The doorkeeper absorbs the first one.
+  {
+    AdmissionFilter<Key> filter(3, 1024 * 1024);
+    const std::vector<Key> keys{1, 2, 3, 1, 2, 1, 1};
+    std::vector<size_t> indices(keys.size());
+    std::iota(indices.begin(), indices.end(), 0);
+    filter.filter(indices, keys.data());
+    EXPECT_EQ(indices, std::vector<size_t>({5, 6}));
+    EXPECT_EQ(filter.estimate(1), 4);
+    EXPECT_EQ(filter.estimate(2), 2);
+    EXPECT_EQ(filter.estimate(4), 0);
+  }
+
+  // One-hit wonders are rejected, while frequently requested keys are admitted.
+  {
+    AdmissionFilter<Key> filter(2, 64 * 1024);
+    std::vector<Key> keys(100000);
+    for (size_t i{0}; i < keys.size(); ++i) {
+      keys[i] = static_cast<Key>(i % 2 ? 1000000 + i : i / 2 % 64);
+    }
+    std::vector<size_t> indices(keys.size());
+    std::iota(indices.begin(), indices.end(), 0);
+    filter.filter(indices, keys.data());
+
+    const size_t num_cold{static_cast<size_t>(
+        std::count_if(indices.begin(), indices.end(), [&](const size_t i) { return i % 2; }))};
+    EXPECT_LT(num_cold, keys.size() / 2 / 100);
+    EXPECT_GT(indices.size() - num_cold, keys.size() / 2 - 64 * 2);
+  }
+
+  // Frequencies are halved after each window.
+  {
+    AdmissionFilter<Key> filter(AdmissionFilter<Key>::max_threshold, 1024);
+    std::vector<Key> keys(9, 7);
+    std::vector<size_t> indices(keys.size());
+    std::iota(indices.begin(), indices.end(), 0);
+    filter.filter(indices, keys.data());
+    EXPECT_TRUE(indices.empty());
+    EXPECT_EQ(filter.estimate(7), 9);
+
+    keys.resize(filter.window() - keys.size());
+    std::iota(keys.begin(), keys.end(), 100);
+    indices.resize(keys.size());
+    std::iota(indices.begin(), indices.end(), 0);
+    filter.filter(indices, keys.data());
+    EXPECT_TRUE(indices.empty());
+    EXPECT_EQ(filter.estimate(7), 4);
+  }
+}
+
 }  // namespace
 
+TEST(db_backend_admission_filter, TinyLFU) { db_backend_admission_filter_test<long long>(); }
+
+TEST(db_backend_compaction, HashMap) { db_backend_compaction_test<long long>(); }
+
+TEST(db_backend_table_stats, HashMap) { db_backend_table_stats_test<long long>(); }
+
+TEST(db_backend_hot_keys, HashMap) { db_backend_hot_keys_test<long long>(); }
+
+TEST(db_backend_versioned, HashMap) { db_backend_versioned_test<long long>(); }
+
+TEST(db_backend_versioned, LostRows) { db_backend_versioned_lost_rows_test<long long>(); }
+
+TEST(db_backend_numa, HashMap) {
+  db_backend_numa_test<long long>(1);
+  db_backend_numa_test<long long>(16);
+}
+
 TEST(db_backend_insert_fetch_test, HashMap) {
   db_backend_insert_fetch_test<long long>(DatabaseType_t::HashMap);
 }
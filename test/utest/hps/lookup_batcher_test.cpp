@@ -0,0 +1,194 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <hps/lookup_batcher.hpp>
+#include <numeric>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace HugeCTR;
+
+namespace {
+
+typedef long long Key;
+const size_t emb_vec_size = 4;
+
+// Writes `key + 0.25 * j` to the j-th element of each row. The largest batch is recorded per table.
+struct FakeLookup {
+  std::vector<std::atomic<size_t>> max_batch_keys;
+
+  explicit FakeLookup(const size_t num_tables) : max_batch_keys(num_tables) {}
+
+  void operator()(const size_t table_id, const void* const keys, const size_t num_keys,
+                  const std::vector<LookupBatcher::Slice>& slices) {
+    size_t n = max_batch_keys[table_id];
+    while (n < num_keys && !max_batch_keys[table_id].compare_exchange_weak(n, num_keys)) {
+    }
+
+    const Key* k = reinterpret_cast<const Key*>(keys);
+    size_t total = 0;
+    for (const LookupBatcher::Slice& slice : slices) {
+      for (size_t i = 0; i < slice.num_keys; ++i, ++k) {
+        for (size_t j = 0; j < emb_vec_size; ++j) {
+          slice.vectors[i * emb_vec_size + j] = static_cast<float>(*k * 4 + table_id) + 0.25f * j;
+        }
+      }
+      total += slice.num_keys;
+    }
+    ASSERT_EQ(total, num_keys);
+  }
+};
+
+void check_vectors(const size_t table_id, const std::vector<Key>& keys,
+                   const std::vector<float>& vectors) {
+  ASSERT_EQ(vectors.size(), keys.size() * emb_vec_size);
+  for (size_t i = 0; i < keys.size(); ++i) {
+    for (size_t j = 0; j < emb_vec_size; ++j) {
+      ASSERT_EQ(vectors[i * emb_vec_size + j],
+                static_cast<float>(keys[i] * 4 + table_id) + 0.25f * j);
+    }
+  }
+}
+
+}  // namespace
+
+TEST(lookup_batcher, merges_pending_requests) {
+  FakeLookup fake(1);
+  LookupBatcher batcher({1000}, sizeof(Key), std::chrono::milliseconds(50),
+                        [&fake](auto&&... args) { fake(args...); });
+
+  std::vector<std::vector<Key>> keys(8);
+  std::vector<std::vector<float>> vectors(keys.size());
+  std::vector<std::future<void>> futures;
+  for (size_t i = 0; i < keys.size(); ++i) {
+    keys[i].resize(i + 1);
+    std::iota(keys[i].begin(), keys[i].end(), static_cast<Key>(i * 100));
+    vectors[i].resize(keys[i].size() * emb_vec_size);
+    futures.emplace_back(batcher.submit(0, keys[i].data(), keys[i].size(), vectors[i].data()));
+  }
+  for (size_t i = 0; i < keys.size(); ++i) {
+    futures[i].get();
+    check_vectors(0, keys[i], vectors[i]);
+  }
+
+  const LookupBatcherStats stats = batcher.get_stats();
+  EXPECT_EQ(stats.num_batches, 1);
+  EXPECT_EQ(stats.num_requests, 8);
+  EXPECT_EQ(stats.num_keys, 36);
+  EXPECT_DOUBLE_EQ(stats.mean_requests_per_batch(), 8.0);
+}
+
+TEST(lookup_batcher, respects_key_limit) {
+  FakeLookup fake(1);
+  LookupBatcher batcher({10}, sizeof(Key), std::chrono::milliseconds(20),
+                        [&fake](auto&&... args) { fake(args...); });
+
+  // Requests with more keys than the limit are dispatched on their own.
+  std::vector<size_t> sizes = {4, 4, 4, 25, 4, 4};
+  std::vector<std::vector<Key>> keys(sizes.size());
+  std::vector<std::vector<float>> vectors(keys.size());
+  std::vector<std::future<void>> futures;
+  for (size_t i = 0; i < sizes.size(); ++i) {
+    keys[i].resize(sizes[i]);
+    std::iota(keys[i].begin(), keys[i].end(), static_cast<Key>(i * 100));
+    vectors[i].resize(keys[i].size() * emb_vec_size);
+    futures.emplace_back(batcher.submit(0, keys[i].data(), keys[i].size(), vectors[i].data()));
+  }
+  for (size_t i = 0; i < keys.size(); ++i) {
+    futures[i].get();
+    check_vectors(0, keys[i], vectors[i]);
+  }
+
+  EXPECT_EQ(fake.max_batch_keys[0], 25);
+  const LookupBatcherStats stats = batcher.get_stats();
+  EXPECT_GE(stats.num_batches, 4);
+  EXPECT_EQ(stats.num_requests, 6);
+}
+
+TEST(lookup_batcher, concurrent_tables) {
+  const size_t num_tables = 3;
+  const size_t num_threads = 8;
+  const size_t num_iterations = 500;
+  FakeLookup fake(num_tables);
+  LookupBatcher batcher(std::vector<size_t>(num_tables, 64), sizeof(Key),
+                        std::chrono::microseconds(200),
+                        [&fake](auto&&... args) { fake(args...); });
+
+  std::atomic<bool> failed{false};
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < num_threads; ++t) {
+    threads.emplace_back([&, t]() {
+      std::vector<Key> keys;
+      std::vector<float> vectors;
+      for (size_t i = 0; i < num_iterations; ++i) {
+        const size_t table_id = (t + i) % num_tables;
+        keys.resize(1 + (t * 7 + i) % 16);
+        std::iota(keys.begin(), keys.end(), static_cast<Key>(t * 1000000 + i * 100));
+        vectors.assign(keys.size() * emb_vec_size, -1.0f);
+        batcher.lookup(table_id, keys.data(), keys.size(), vectors.data());
+        for (size_t k = 0; k < keys.size(); ++k) {
+          if (vectors[k * emb_vec_size] != static_cast<float>(keys[k] * 4 + table_id)) {
+            failed = true;
+          }
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  EXPECT_FALSE(failed);
+
+  const LookupBatcherStats stats = batcher.get_stats();
+  EXPECT_EQ(stats.num_requests, num_threads * num_iterations);
+  EXPECT_LE(stats.num_batches, stats.num_requests);
+  for (size_t table_id = 0; table_id < num_tables; ++table_id) {
+    EXPECT_LE(fake.max_batch_keys[table_id], 64);
+  }
+}
+
+TEST(lookup_batcher, forwards_exceptions) {
+  LookupBatcher batcher({100}, sizeof(Key), std::chrono::milliseconds(10),
+                        [](size_t, const void*, size_t, const std::vector<LookupBatcher::Slice>&) {
+                          throw std::runtime_error("lookup failed");
+                        });
+  std::vector<Key> keys(4);
+  std::vector<float> vectors(keys.size() * emb_vec_size);
+  std::future<void> f0 = batcher.submit(0, keys.data(), keys.size(), vectors.data());
+  std::future<void> f1 = batcher.submit(0, keys.data(), keys.size(), vectors.data());
+  EXPECT_THROW(f0.get(), std::runtime_error);
+  EXPECT_THROW(f1.get(), std::runtime_error);
+}
+
+TEST(lookup_batcher, shutdown_completes_pending) {
+  FakeLookup fake(1);
+  std::vector<Key> keys = {1, 2, 3};
+  std::vector<float> vectors(keys.size() * emb_vec_size);
+  std::future<void> future;
+  const auto begin = std::chrono::steady_clock::now();
+  {
+    LookupBatcher batcher({100}, sizeof(Key), std::chrono::seconds(30),
+                          [&fake](auto&&... args) { fake(args...); });
+    future = batcher.submit(0, keys.data(), keys.size(), vectors.data());
+  }
+  EXPECT_LT(std::chrono::steady_clock::now() - begin, std::chrono::seconds(10));
+  future.get();
+  check_vectors(0, keys, vectors);
+}
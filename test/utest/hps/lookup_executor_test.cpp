@@ -0,0 +1,228 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <hps/plugin/lookup_executor.hpp>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+using namespace HierarchicalParameterServer;
+
+namespace {
+
+// Tracks how many tasks of a group run concurrently.
+struct ConcurrencyCounter {
+  std::atomic<size_t> current{0};
+  std::atomic<size_t> peak{0};
+
+  void enter() {
+    const size_t n = ++current;
+    size_t p = peak;
+    while (p < n && !peak.compare_exchange_weak(p, n)) {
+    }
+  }
+  void leave() { --current; }
+};
+
+// Stands in for a LookupSession on the CPU. Each lookup writes the rows, and then waits a fixed
+// time, like a lookup that waits for its CUDA stream.
+class StubLookupSession {
+ public:
+  StubLookupSession(const size_t emb_vec_size, const std::chrono::microseconds latency)
+      : emb_vec_size_(emb_vec_size), latency_(latency) {}
+
+  void lookup_from_device(const long long* const keys, float* const vectors, const size_t num_keys,
+                          const size_t table_id) {
+    for (size_t i = 0; i < num_keys; ++i) {
+      for (size_t j = 0; j < emb_vec_size_; ++j) {
+        vectors[i * emb_vec_size_ + j] = static_cast<float>(keys[i] + table_id);
+      }
+    }
+    std::this_thread::sleep_for(latency_);
+    ++num_lookups;
+  }
+
+  std::atomic<size_t> num_lookups{0};
+
+ private:
+  const size_t emb_vec_size_;
+  const std::chrono::microseconds latency_;
+};
+
+// Simulates TensorFlow's inter-op threads, each issuing asynchronous Lookup ops and waiting for
+// their completion. Returns ops/sec.
+double run_lookup_ops(LookupExecutor& executor, StubLookupSession& session,
+                      const size_t num_clients, const size_t num_ops_per_client,
+                      const size_t num_tables) {
+  const size_t num_keys = 64;
+  const size_t emb_vec_size = 16;
+  std::atomic<bool> failed{false};
+
+  const auto begin = std::chrono::steady_clock::now();
+  std::vector<std::thread> clients;
+  for (size_t c = 0; c < num_clients; ++c) {
+    clients.emplace_back([&, c]() {
+      std::vector<long long> keys(num_keys);
+      std::vector<float> vectors(num_keys * emb_vec_size);
+      for (size_t i = 0; i < num_ops_per_client; ++i) {
+        const int table_id = static_cast<int>((c + i) % num_tables);
+        for (size_t k = 0; k < num_keys; ++k) {
+          keys[k] = static_cast<long long>(c * 1000000 + i * num_keys + k);
+        }
+        std::promise<void> done;
+        executor.submit("model", table_id, 0, [&]() {
+          session.lookup_from_device(keys.data(), vectors.data(), num_keys, table_id);
+          done.set_value();
+        });
+        done.get_future().wait();
+        if (vectors.back() != static_cast<float>(keys.back() + table_id)) {
+          failed = true;
+        }
+      }
+    });
+  }
+  for (auto& client : clients) {
+    client.join();
+  }
+  const double elapsed_s =
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+  EXPECT_FALSE(failed);
+  return static_cast<double>(num_clients * num_ops_per_client) / elapsed_s;
+}
+
+}  // namespace
+
+TEST(lookup_executor, respects_inflight_limits) {
+  LookupExecutorParams params;
+  params.num_workers = 6;
+  params.max_inflight_per_device = 3;
+  params.max_inflight_per_table = 2;
+  LookupExecutor executor(params);
+
+  const size_t num_devices = 2;
+  const size_t num_tables = 3;
+  std::vector<ConcurrencyCounter> per_device(num_devices);
+  std::vector<ConcurrencyCounter> per_table(num_devices * num_tables);
+  std::atomic<size_t> num_done{0};
+
+  const size_t num_tasks = 600;
+  for (size_t i = 0; i < num_tasks; ++i) {
+    const int device_id = static_cast<int>(i % num_devices);
+    const int table_id = static_cast<int>((i / num_devices) % num_tables);
+    executor.submit("model", table_id, device_id, [&, device_id, table_id]() {
+      ConcurrencyCounter& device = per_device[device_id];
+      ConcurrencyCounter& table = per_table[device_id * num_tables + table_id];
+      device.enter();
+      table.enter();
+      std::this_thread::sleep_for(std::chrono::microseconds(100));
+      table.leave();
+      device.leave();
+      ++num_done;
+    });
+  }
+  while (num_done < num_tasks) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+
+  for (auto& device : per_device) {
+    EXPECT_LE(device.peak, 3);
+  }
+  for (auto& table : per_table) {
+    EXPECT_LE(table.peak, 2);
+  }
+  const LookupExecutorStats stats = executor.get_stats();
+  EXPECT_EQ(stats.num_tasks, num_tasks);
+  EXPECT_EQ(stats.num_pending, 0);
+  EXPECT_LE(stats.peak_inflight, 6);
+}
+
+TEST(lookup_executor, coalesces_backlog) {
+  LookupExecutorParams params;
+  params.num_workers = 1;
+  params.max_coalesced_tasks = 8;
+  LookupExecutor executor(params);
+
+  // Block the only worker, so that a backlog builds up.
+  std::promise<void> started;
+  std::promise<void> release;
+  std::shared_future<void> released = release.get_future().share();
+  executor.submit("model", 0, 0, [&]() {
+    started.set_value();
+    released.wait();
+  });
+  started.get_future().wait();
+
+  std::atomic<size_t> num_done{0};
+  for (size_t i = 0; i < 19; ++i) {
+    executor.submit("model", 0, 0, [&]() { ++num_done; });
+  }
+  release.set_value();
+  while (num_done < 19) {
+    std::this_thread::yield();
+  }
+
+  // 19 queued tasks are taken as 8 + 8 + 3.
+  const LookupExecutorStats stats = executor.get_stats();
+  EXPECT_EQ(stats.num_tasks, 20);
+  EXPECT_EQ(stats.num_dispatches, 4);
+  EXPECT_EQ(stats.peak_pending, 19);
+}
+
+TEST(lookup_executor, drains_on_destruction) {
+  std::atomic<size_t> num_done{0};
+  {
+    LookupExecutorParams params;
+    params.num_workers = 2;
+    LookupExecutor executor(params);
+    for (size_t i = 0; i < 100; ++i) {
+      executor.submit("model", static_cast<int>(i % 4), 0, [&]() {
+        std::this_thread::sleep_for(std::chrono::microseconds(50));
+        ++num_done;
+      });
+    }
+  }
+  EXPECT_EQ(num_done, 100);
+}
+
+TEST(lookup_executor, throughput_scales_with_workers) {
+  const size_t num_clients = 16;
+  const size_t num_ops_per_client = 200;
+  const size_t num_tables = 2;
+
+  std::vector<double> ops_per_s;
+  for (const size_t num_workers : {1, 2, 4, 8, 16}) {
+    StubLookupSession session(16, std::chrono::microseconds(200));
+    LookupExecutorParams params;
+    params.num_workers = num_workers;
+    LookupExecutor executor(params);
+    ops_per_s.push_back(
+        run_lookup_ops(executor, session, num_clients, num_ops_per_client, num_tables));
+    EXPECT_EQ(session.num_lookups, num_clients * num_ops_per_client);
+
+    const LookupExecutorStats stats = executor.get_stats();
+    std::cout << "workers: " << num_workers << ", ops/s: " << ops_per_s.back()
+              << ", tasks/dispatch: " << stats.mean_tasks_per_dispatch()
+              << ", peak in-flight: " << stats.peak_inflight << std::endl;
+  }
+
+  // The stub mostly waits, so even a small machine should overlap lookups.
+  EXPECT_GT(ops_per_s[3], 2.0 * ops_per_s[0]);
+}
@@ -0,0 +1,223 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <hps/memory_pool.hpp>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace HugeCTR;
+
+namespace {
+
+// Only provides what the memory pool needs. Workspaces are empty.
+class FakeEmbeddingCache : public EmbeddingCacheBase {
+ public:
+  FakeEmbeddingCache() { cache_config_.cuda_dev_id_ = 0; }
+  virtual ~FakeEmbeddingCache() = default;
+
+  void lookup(size_t, float*, const void*, size_t, float, cudaStream_t) override {}
+  void lookup_from_device(size_t, float*, const void*, size_t, float, cudaStream_t) override {}
+  void insert(size_t, EmbeddingCacheWorkspace&, cudaStream_t) override {}
+  void init(const size_t, EmbeddingCacheRefreshspace&, cudaStream_t) override {}
+  void init(const size_t, void*, void*, float*, size_t, cudaStream_t) override {}
+  void dump(size_t, void*, size_t*, size_t, size_t, cudaStream_t) override {}
+  void refresh(size_t, const void*, const void*, size_t, cudaStream_t) override {}
+  void finalize() override {}
+  void insert_stream_for_sync(std::vector<cudaStream_t>) override {}
+
+  EmbeddingCacheWorkspace create_workspace() override {
+    num_created++;
+    return {};
+  }
+  void destroy_workspace(EmbeddingCacheWorkspace&) override { num_destroyed++; }
+  EmbeddingCacheRefreshspace create_refreshspace() override { return {}; }
+  void destroy_refreshspace(EmbeddingCacheRefreshspace&) override {}
+
+  const embedding_cache_config& get_cache_config() override { return cache_config_; }
+  const std::vector<cudaStream_t>& get_refresh_streams() override { return streams_; }
+  const std::vector<cudaStream_t>& get_insert_streams() override { return streams_; }
+  int get_device_id() override { return cache_config_.cuda_dev_id_; }
+  bool use_gpu_embedding_cache() override { return false; }
+  void set_profiler(int, int, bool) override {}
+  void profiler_print() override {}
+
+  std::atomic<size_t> num_created{0};
+  std::atomic<size_t> num_destroyed{0};
+
+ private:
+  embedding_cache_config cache_config_;
+  std::vector<cudaStream_t> streams_;
+};
+
+void await_waiting(MemoryPool& pool, const size_t num_waiting) {
+  while (pool.GetStats().num_waiting != num_waiting) {
+    std::this_thread::yield();
+  }
+}
+
+}  // namespace
+
+TEST(memory_pool, grow_and_timeout) {
+  const auto cache = std::make_shared<FakeEmbeddingCache>();
+  MemoryPool pool(2, cache, CACHE_SPACE_TYPE::WORKER, 4, std::chrono::milliseconds(50));
+  EXPECT_EQ(cache->num_created, 2);
+
+  std::vector<void*> blocks;
+  for (size_t i = 0; i < 4; ++i) {
+    blocks.push_back(pool.AllocMemory());
+    ASSERT_NE(blocks.back(), nullptr);
+  }
+  EXPECT_EQ(cache->num_created, 4);
+
+  // Exhausted and at the size limit.
+  EXPECT_EQ(pool.AllocMemory(), nullptr);
+
+  MemoryPoolStats stats = pool.GetStats();
+  EXPECT_EQ(stats.num_blocks, 4);
+  EXPECT_EQ(stats.num_grows, 2);
+  EXPECT_EQ(stats.num_in_use, 4);
+  EXPECT_DOUBLE_EQ(stats.occupancy(), 1.0);
+  EXPECT_EQ(stats.num_waits, 1);
+  EXPECT_EQ(stats.num_timeouts, 1);
+  EXPECT_GE(stats.max_wait_ms, 40.0);
+
+  for (void* block : blocks) {
+    pool.FreeMemory(block);
+  }
+  stats = pool.GetStats();
+  EXPECT_EQ(stats.num_in_use, 0);
+  EXPECT_EQ(stats.peak_in_use, 4);
+  pool.DestoryMemoryPool();
+  EXPECT_EQ(cache->num_destroyed, 4);
+}
+
+TEST(memory_pool, fifo) {
+  const auto cache = std::make_shared<FakeEmbeddingCache>();
+  MemoryPool pool(1, cache);
+  void* const block = pool.AllocMemory();
+
+  std::mutex order_guard;
+  std::vector<size_t> order;
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < 4; ++i) {
+    threads.emplace_back([&, i]() {
+      void* const p = pool.AllocMemory();
+      {
+        const std::lock_guard lock(order_guard);
+        order.push_back(i);
+      }
+      pool.FreeMemory(p);
+    });
+    await_waiting(pool, i + 1);
+  }
+  pool.FreeMemory(block);
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(order, std::vector<size_t>({0, 1, 2, 3}));
+  EXPECT_EQ(pool.GetStats().num_waits, 4);
+  pool.DestoryMemoryPool();
+}
+
+TEST(memory_pool, concurrent) {
+  const size_t num_threads = 8;
+  const size_t num_blocks = 3;
+  const auto cache = std::make_shared<FakeEmbeddingCache>();
+  MemoryPool pool(num_blocks, cache);
+
+  std::vector<std::atomic<size_t>> owners(num_blocks);
+  std::atomic<bool> failed{false};
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < num_threads; ++i) {
+    threads.emplace_back([&]() {
+      for (size_t j = 0; j < 10000; ++j) {
+        MemoryBlock* const p = reinterpret_cast<MemoryBlock*>(pool.AllocMemory());
+        if (!p || owners[p->nIndex]++ != 0) {
+          failed = true;
+          return;
+        }
+        owners[p->nIndex]--;
+        pool.FreeMemory(p);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  EXPECT_FALSE(failed);
+
+  const MemoryPoolStats stats = pool.GetStats();
+  EXPECT_EQ(stats.num_allocs, num_threads * 10000);
+  EXPECT_EQ(stats.num_in_use, 0);
+  EXPECT_LE(stats.peak_in_use, num_blocks);
+  pool.DestoryMemoryPool();
+}
+
+TEST(memory_pool, destroy_releases_waiters) {
+  const auto cache = std::make_shared<FakeEmbeddingCache>();
+  MemoryPool pool(1, cache);
+  void* const block = pool.AllocMemory();
+
+  std::atomic<bool> threw{false};
+  std::thread waiter([&]() {
+    try {
+      pool.AllocMemory();
+    } catch (const std::exception&) {
+      threw = true;
+    }
+  });
+  await_waiting(pool, 1);
+  pool.DestoryMemoryPool();
+  // The waiter left before the workspaces were destroyed.
+  EXPECT_EQ(pool.GetStats().num_waiting, 0);
+  waiter.join();
+  EXPECT_TRUE(threw);
+  pool.FreeMemory(block);
+}
+
+TEST(memory_pool, destroy_manager_pool_with_blocked_waiter) {
+  const auto cache = std::make_shared<FakeEmbeddingCache>();
+  std::map<std::string, std::map<int64_t, std::shared_ptr<EmbeddingCacheBase>>> cache_map;
+  cache_map["model"][0] = cache;
+  inference_memory_pool_size_config config;
+  config.num_woker_buffer_size_per_model["model"] = 1;
+  config.num_refresh_buffer_size_per_model["model"] = 1;
+  ManagerPool manager(cache_map, config);
+  ASSERT_NE(manager.AllocBuffer("model", 0), nullptr);
+
+  // The waiter holds the last reference to the pool once it is removed from the manager.
+  std::atomic<bool> threw{false};
+  std::thread waiter([&]() {
+    try {
+      manager.AllocBuffer("model", 0);
+    } catch (const std::exception&) {
+      threw = true;
+    }
+  });
+  while (manager.GetStats("model", 0).num_waiting != 1) {
+    std::this_thread::yield();
+  }
+  manager.DestoryManagerPool("model");
+  EXPECT_EQ(cache->num_destroyed, 1);
+  waiter.join();
+  EXPECT_TRUE(threw);
+  EXPECT_EQ(manager.AllocBuffer("model", 0), nullptr);
+}
@@ -0,0 +1,224 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <io/snapshot_writer.hpp>
+#include <iterator>
+#include <numeric>
+#include <string>
+#include <vector>
+
+using namespace HugeCTR;
+
+namespace {
+
+const std::string dir = "./tmp/snapshot_writer_test";
+
+std::string read_file(const std::string& path) {
+  std::ifstream file(path, std::ios::binary);
+  return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+void stage(SnapshotBuffer& buffer, const std::string& path, const std::string& data,
+           const bool overwrite = true) {
+  StagingFileSystem fs(buffer);
+  fs.write(path, data.data(), data.size(), overwrite);
+}
+
+class snapshot_writer : public testing::Test {
+ protected:
+  void SetUp() override {
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+  }
+  void TearDown() override { std::filesystem::remove_all(dir); }
+};
+
+}  // namespace
+
+TEST_F(snapshot_writer, stages_writes_in_host_buffer) {
+  SnapshotBuffer buffer;
+  {
+    StagingFileSystem fs(buffer);
+    fs.create_dir(dir + "/model");
+    fs.write(dir + "/model/key", "abc", 3, true);
+    fs.write(dir + "/model/key", "def", 3, false);
+    fs.write(dir + "/dense.model", "xyz", 3, true);
+    fs.write(dir + "/dense.model", "uvw", 3, true);
+
+    EXPECT_EQ(fs.get_file_size(dir + "/model/key"), 6);
+    char data[4] = {};
+    EXPECT_EQ(fs.read(dir + "/model/key", data, 3, 2), 3);
+    EXPECT_STREQ(data, "cde");
+  }
+
+  // Nothing may touch the disk while staging.
+  EXPECT_FALSE(std::filesystem::exists(dir + "/model"));
+  EXPECT_FALSE(std::filesystem::exists(dir + "/dense.model"));
+
+  ASSERT_EQ(buffer.num_files(), 2);
+  ASSERT_EQ(buffer.dirs().size(), 1);
+  EXPECT_EQ(buffer.size_in_bytes(), 9);
+  const SnapshotBuffer::File* const file = buffer.find(dir + "/dense.model");
+  ASSERT_NE(file, nullptr);
+  EXPECT_FALSE(file->append);
+  EXPECT_EQ(std::string(file->data.begin(), file->data.end()), "uvw");
+
+  // Other file systems are not affected.
+  auto fs = FileSystemBuilder::build_unique_by_path(dir + "/direct");
+  fs->write(dir + "/direct", "123", 3, true);
+  EXPECT_EQ(read_file(dir + "/direct"), "123");
+}
+
+TEST_F(snapshot_writer, writes_files_atomically) {
+  SnapshotWriterParams params;
+  params.chunk_size = 1000;  // Force several write calls per file.
+  SnapshotWriter writer(params);
+
+  std::vector<char> large(123457);
+  std::iota(large.begin(), large.end(), 0);
+
+  SnapshotBuffer& buffer = writer.acquire();
+  {
+    StagingFileSystem fs(buffer);
+    fs.create_dir(dir + "/0_sparse_100.model");
+    fs.write(dir + "/0_sparse_100.model/emb_vector", large.data(), large.size(), true);
+    fs.write(dir + "/_dense_100.model", "dense", 5, true);
+    fs.write(dir + "/_opt_dense_100.model", "opt-", 4, true);
+    fs.write(dir + "/_opt_dense_100.model", "states", 6, false);
+  }
+  writer.submit(buffer);
+  writer.wait();
+
+  EXPECT_EQ(read_file(dir + "/0_sparse_100.model/emb_vector"),
+            std::string(large.begin(), large.end()));
+  EXPECT_EQ(read_file(dir + "/_dense_100.model"), "dense");
+  EXPECT_EQ(read_file(dir + "/_opt_dense_100.model"), "opt-states");
+  for (const auto& entry : std::filesystem::recursive_directory_iterator(dir)) {
+    EXPECT_NE(entry.path().extension(), ".tmp") << entry.path();
+  }
+
+  const SnapshotWriterStats stats = writer.get_stats();
+  EXPECT_EQ(stats.num_snapshots, 1);
+  EXPECT_EQ(stats.num_files, 3);
+  EXPECT_EQ(stats.num_bytes, large.size() + 15);
+  EXPECT_EQ(stats.num_errors, 0);
+}
+
+TEST_F(snapshot_writer, appends_to_existing_files) {
+  {
+    std::ofstream file(dir + "/log", std::ios::binary);
+    file << "head-";
+  }
+
+  SnapshotWriter writer(SnapshotWriterParams{});
+  SnapshotBuffer& buffer = writer.acquire();
+  stage(buffer, dir + "/log", "tail", false);
+  writer.submit(buffer);
+  writer.wait();
+  EXPECT_EQ(read_file(dir + "/log"), "head-tail");
+}
+
+TEST_F(snapshot_writer, blocks_when_all_buffers_are_busy) {
+  std::promise<void> release;
+  std::shared_future<void> released = release.get_future().share();
+
+  SnapshotWriterParams params;
+  params.num_buffers = 2;
+  params.num_threads = 1;
+  params.compress = [released](const char* data, size_t size, std::vector<char>& out) {
+    released.wait();
+    out.assign(data, data + size);
+  };
+  SnapshotWriter writer(params);
+
+  // Training can continue while two snapshots are in flight.
+  for (int i = 0; i < 2; ++i) {
+    SnapshotBuffer& buffer = writer.acquire();
+    stage(buffer, dir + "/_dense_" + std::to_string(i) + ".model", "dense");
+    writer.submit(buffer);
+  }
+
+  // A third snapshot has to wait until one of them is written.
+  auto third = std::async(std::launch::async, [&]() -> SnapshotBuffer& {
+    return writer.acquire();
+  });
+  EXPECT_EQ(third.wait_for(std::chrono::milliseconds(50)), std::future_status::timeout);
+  release.set_value();
+  SnapshotBuffer& buffer = third.get();
+  EXPECT_EQ(buffer.num_files(), 0);
+  writer.discard(buffer);
+  writer.wait();
+
+  EXPECT_EQ(read_file(dir + "/_dense_0.model"), "dense");
+  EXPECT_EQ(read_file(dir + "/_dense_1.model"), "dense");
+  const SnapshotWriterStats stats = writer.get_stats();
+  EXPECT_EQ(stats.num_snapshots, 2);
+  EXPECT_GT(stats.stall_time_s, 0.0);
+}
+
+TEST_F(snapshot_writer, compresses_files) {
+  SnapshotWriterParams params;
+  params.compress = [](const char* data, size_t size, std::vector<char>& out) {
+    // Run-length encoding, as a stand-in for a real codec.
+    for (size_t i = 0; i < size;) {
+      size_t n = 1;
+      while (i + n < size && data[i + n] == data[i] && n < 9) {
+        ++n;
+      }
+      out.push_back(static_cast<char>('0' + n));
+      out.push_back(data[i]);
+      i += n;
+    }
+  };
+  params.compressed_suffix = ".rle";
+  SnapshotWriter writer(params);
+
+  SnapshotBuffer& buffer = writer.acquire();
+  stage(buffer, dir + "/_dense_1.model", "aaaabbbcc");
+  writer.submit(buffer);
+  writer.wait();
+
+  EXPECT_FALSE(std::filesystem::exists(dir + "/_dense_1.model"));
+  EXPECT_EQ(read_file(dir + "/_dense_1.model.rle"), "4a3b2c");
+  EXPECT_EQ(writer.get_stats().num_bytes, 6);
+}
+
+TEST_F(snapshot_writer, reports_write_errors) {
+  SnapshotWriter writer(SnapshotWriterParams{});
+
+  // A regular file cannot be used as a directory.
+  {
+    std::ofstream file(dir + "/not_a_dir");
+  }
+  SnapshotBuffer& buffer = writer.acquire();
+  stage(buffer, dir + "/not_a_dir/_dense_1.model", "dense");
+  stage(buffer, dir + "/_dense_1.model", "dense");
+  writer.submit(buffer);
+
+  EXPECT_ANY_THROW(writer.wait());
+  EXPECT_NO_THROW(writer.wait());
+  EXPECT_EQ(read_file(dir + "/_dense_1.model"), "dense");
+
+  const SnapshotWriterStats stats = writer.get_stats();
+  EXPECT_EQ(stats.num_snapshots, 1);
+  EXPECT_EQ(stats.num_errors, 1);
+}
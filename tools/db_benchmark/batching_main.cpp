@@ -0,0 +1,312 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <argparse/argparse.hpp>
+#include <core23/logger.hpp>
+#include <cstring>
+#include <fstream>
+#include <hps/hash_map_backend.hpp>
+#include <hps/hier_parameter_server_base.hpp>
+#include <hps/lookup_batcher.hpp>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include "workload.hpp"
+
+using namespace HugeCTR;
+using namespace HugeCTR::db_bench;
+
+typedef long long Key;
+
+namespace {
+
+/**
+ * Stands in for the embedding cache behind `LookupSession::lookup_impl`. Each call pays a fixed
+ * overhead (kernel launches, stream synchronization, ...), and then fetches the keys from the
+ * backend.
+ */
+class BackendLookup final {
+ public:
+  BackendLookup(DatabaseBackendBase<Key>& db, const std::string& tag_name, const size_t value_size,
+                const std::chrono::nanoseconds call_overhead)
+      : db_{db}, tag_name_{tag_name}, value_size_{value_size}, call_overhead_{call_overhead} {}
+
+  void operator()(const size_t, const void* const keys, const size_t num_keys,
+                  const std::vector<LookupBatcher::Slice>& slices) const {
+    const auto t0{std::chrono::steady_clock::now()};
+    while (std::chrono::steady_clock::now() - t0 < call_overhead_) {
+    }
+
+    // Batches with several requests are gathered in a staging buffer first.
+    thread_local std::vector<char> staging;
+    char* values;
+    if (slices.size() == 1) {
+      values = reinterpret_cast<char*>(slices.front().vectors);
+    } else {
+      staging.resize(num_keys * value_size_);
+      values = staging.data();
+    }
+    db_.fetch(tag_name_, num_keys, reinterpret_cast<const Key*>(keys), values, value_size_,
+              [](const size_t) {});
+    if (slices.size() > 1) {
+      for (const LookupBatcher::Slice& slice : slices) {
+        std::memcpy(slice.vectors, values, slice.num_keys * value_size_);
+        values += slice.num_keys * value_size_;
+      }
+    }
+  }
+
+ private:
+  DatabaseBackendBase<Key>& db_;
+  const std::string tag_name_;
+  const size_t value_size_;
+  const std::chrono::nanoseconds call_overhead_;
+};
+
+/**
+ * Runs `params.num_threads` clients that issue requests of `params.batch_size` keys against the
+ * lookup function. If `window` is negative, clients call the function directly. Otherwise, their
+ * requests pass through a batcher with that maximum delay.
+ */
+nlohmann::json run(const BackendLookup& lookup, const std::chrono::microseconds window,
+                   const size_t max_batch_keys, const WorkloadParams& params) {
+  std::unique_ptr<LookupBatcher> batcher;
+  if (window.count() >= 0) {
+    batcher = std::make_unique<LookupBatcher>(std::vector<size_t>{max_batch_keys}, sizeof(Key),
+                                              window, lookup);
+  }
+
+  HCTR_LOG_S(INFO, WORLD) << "Running " << params.num_threads << " clients "
+                          << (batcher ? "with batching window " + std::to_string(window.count()) +
+                                            " us"
+                                      : std::string("without batching"))
+                          << "..." << std::endl;
+
+  std::shared_ptr<const std::vector<Key>> trace;
+  if (params.key_distribution == KeyDistribution_t::Trace) {
+    trace = load_key_trace<Key>(params.trace_path);
+  }
+
+  std::vector<uint64_t> samples;
+  std::mutex samples_guard;
+
+  const auto begin{std::chrono::high_resolution_clock::now()};
+  const auto deadline{begin + params.duration};
+
+  const auto client{[&](const size_t client_index) {
+    const std::unique_ptr<KeyGenerator<Key>> key_gen{
+        make_key_generator(params, trace, client_index)};
+    std::vector<Key> keys(params.batch_size);
+    std::vector<float> vectors(params.batch_size * params.value_size / sizeof(float));
+    const std::vector<LookupBatcher::Slice> slices{{vectors.data(), keys.size()}};
+
+    std::vector<uint64_t> local_samples;
+    while (true) {
+      key_gen->fill(keys.data(), keys.size());
+
+      const auto t0{std::chrono::high_resolution_clock::now()};
+      if (t0 >= deadline) {
+        break;
+      }
+      if (batcher) {
+        batcher->lookup(0, keys.data(), keys.size(), vectors.data());
+      } else {
+        lookup(0, keys.data(), keys.size(), slices);
+      }
+      const auto t1{std::chrono::high_resolution_clock::now()};
+      local_samples.emplace_back(
+          std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count());
+    }
+
+    const std::lock_guard lock(samples_guard);
+    samples.insert(samples.end(), local_samples.begin(), local_samples.end());
+  }};
+
+  std::vector<std::thread> clients;
+  clients.reserve(params.num_threads);
+  for (size_t i{0}; i < params.num_threads; ++i) {
+    clients.emplace_back(client, i);
+  }
+  for (std::thread& t : clients) {
+    t.join();
+  }
+  const double elapsed_s{
+      std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - begin).count()};
+
+  nlohmann::json report;
+  report["window_us"] = batcher ? nlohmann::json(window.count()) : nlohmann::json();
+  report["elapsed_s"] = elapsed_s;
+  report["requests_per_s"] = static_cast<double>(samples.size()) / elapsed_s;
+  report["keys_per_s"] = static_cast<double>(samples.size() * params.batch_size) / elapsed_s;
+  report["latency"] = LatencyStats::from_samples(samples).to_json();
+  if (batcher) {
+    const LookupBatcherStats stats{batcher->get_stats()};
+    report["num_batches"] = stats.num_batches;
+    report["mean_requests_per_batch"] = stats.mean_requests_per_batch();
+    report["mean_keys_per_batch"] = stats.mean_keys_per_batch();
+  }
+  return report;
+}
+
+std::vector<int64_t> parse_windows(const std::string& text) {
+  std::vector<int64_t> windows;
+  std::istringstream stream(text);
+  std::string token;
+  while (std::getline(stream, token, ',')) {
+    windows.emplace_back(std::stoll(token));
+    HCTR_CHECK_HINT(windows.back() >= 0, "Batching windows must not be negative.");
+  }
+  return windows;
+}
+
+}  // namespace
+
+/**
+ * Measures latency and throughput of many small concurrent lookups as a function of the batching
+ * window of LookupBatcher. The first run calls the backend directly and serves as the baseline.
+ *
+ * Example (64 clients, 32 keys per request, 20 us fixed cost per lookup):
+ *   db_batching_bench --threads 64 --batch_size 32 --call_overhead_us 20 \
+ *     --windows 0,25,50,100,200,500,1000 --output batching.json
+ */
+int main(int argc, char** argv) {
+  argparse::ArgumentParser args;
+
+  args.add_argument("--output")
+      .help("Path of the JSON report (default: print to stdout).")
+      .default_value<std::string>("");
+  args.add_argument("--key_dist")
+      .help("Key distribution (uniform, zipf, trace).")
+      .default_value<std::string>("zipf");
+  args.add_argument("--num_keys")
+      .help("Size of the key space. The table is prefilled with all keys.")
+      .default_value<size_t>(1000L * 1000)
+      .scan<'u', size_t>();
+  args.add_argument("--zipf_exponent")
+      .help("Skew of the Zipf distribution.")
+      .default_value<double>(1.1)
+      .scan<'g', double>();
+  args.add_argument("--trace").help("Key-log file to replay.").default_value<std::string>("");
+  args.add_argument("--batch_size")
+      .help("Number of keys per request.")
+      .default_value<size_t>(32)
+      .scan<'u', size_t>();
+  args.add_argument("--threads")
+      .help("Number of concurrent client threads.")
+      .default_value<size_t>(32)
+      .scan<'u', size_t>();
+  args.add_argument("--duration")
+      .help("Time budget for each run in seconds.")
+      .default_value<double>(5.0)
+      .scan<'g', double>();
+  args.add_argument("--emb_size")
+      .help("Size of one embedding.")
+      .default_value<size_t>(64)
+      .scan<'u', size_t>();
+  args.add_argument("--seed")
+      .help("Seed for the random number generators.")
+      .default_value<uint64_t>(4711)
+      .scan<'u', uint64_t>();
+  args.add_argument("--windows")
+      .help("Comma-separated list of batching windows in microseconds.")
+      .default_value<std::string>("0,25,50,100,200,500,1000");
+  args.add_argument("--max_batch_keys")
+      .help("Maximum number of keys per batch.")
+      .default_value<size_t>(16L * 1024)
+      .scan<'u', size_t>();
+  args.add_argument("--call_overhead_us")
+      .help("Fixed cost of each lookup call in microseconds.")
+      .default_value<double>(20.0)
+      .scan<'g', double>();
+  args.add_argument("--parts")
+      .help("Number of partitions.")
+      .default_value<size_t>(16)
+      .scan<'u', size_t>();
+
+  try {
+    args.parse_args(argc, argv);
+  } catch (const std::runtime_error& err) {
+    std::cerr << err.what() << std::endl;
+    std::cout << args;
+    return 1;
+  }
+
+  const auto output = args.get<std::string>("--output");
+
+  WorkloadParams params;
+  params.key_distribution = parse_key_distribution(args.get<std::string>("--key_dist"));
+  params.num_keys = args.get<size_t>("--num_keys");
+  params.zipf_exponent = args.get<double>("--zipf_exponent");
+  params.trace_path = args.get<std::string>("--trace");
+  params.read_ratio = 1.0;
+  params.batch_size = args.get<size_t>("--batch_size");
+  params.num_threads = args.get<size_t>("--threads");
+  params.value_size = args.get<size_t>("--emb_size") * sizeof(float);
+  params.duration = std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::duration<double>(args.get<double>("--duration")));
+  params.seed = args.get<uint64_t>("--seed");
+
+  const std::vector<int64_t> windows{parse_windows(args.get<std::string>("--windows"))};
+  const size_t max_batch_keys{args.get<size_t>("--max_batch_keys")};
+  const auto call_overhead{std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::duration<double, std::micro>(args.get<double>("--call_overhead_us")))};
+
+  HashMapBackendParams db_params;
+  db_params.num_partitions = args.get<size_t>("--parts");
+  db_params.max_batch_size = std::max(max_batch_keys, db_params.max_batch_size);
+  HashMapBackend<Key> db(db_params);
+
+  const std::string tag_name{HierParameterServerBase::make_tag_name("mdl", "tab1")};
+  prefill(db, tag_name, params, db_params.max_batch_size);
+  const BackendLookup lookup(db, tag_name, params.value_size, call_overhead);
+
+  nlohmann::json report;
+  report["workload"] = to_json(params);
+  report["max_batch_keys"] = max_batch_keys;
+  report["call_overhead_us"] = args.get<double>("--call_overhead_us");
+  report["baseline"] = run(lookup, std::chrono::microseconds(-1), max_batch_keys, params);
+  report["runs"] = nlohmann::json::array();
+  for (const int64_t window : windows) {
+    report["runs"].push_back(
+        run(lookup, std::chrono::microseconds(window), max_batch_keys, params));
+  }
+
+  if (output.empty()) {
+    std::cout << report.dump(2) << std::endl;
+  } else {
+    std::ofstream file(output);
+    HCTR_CHECK_HINT(file.is_open(), "Unable to open \"", output, "\" for writing.");
+    file << report.dump(2) << std::endl;
+    HCTR_LOG_S(INFO, WORLD) << "Report written to \"" << output << "\"." << std::endl;
+  }
+
+  const auto& baseline{report["baseline"]};
+  HCTR_LOG_S(INFO, WORLD) << "Baseline: " << baseline["requests_per_s"].get<double>()
+                          << " requests/s, p99 = " << baseline["latency"]["p99_us"].get<double>()
+                          << " us" << std::endl;
+  for (const auto& entry : report["runs"]) {
+    HCTR_LOG_S(INFO, WORLD) << "Window " << entry["window_us"].get<int64_t>()
+                            << " us: " << entry["requests_per_s"].get<double>()
+                            << " requests/s, p50 = " << entry["latency"]["p50_us"].get<double>()
+                            << " us, p99 = " << entry["latency"]["p99_us"].get<double>()
+                            << " us, " << entry["mean_requests_per_batch"].get<double>()
+                            << " requests/batch" << std::endl;
+  }
+  return 0;
+}
@@ -0,0 +1,188 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <argparse/argparse.hpp>
+#include <core23/logger.hpp>
+#include <fstream>
+#include <hps/hash_map_backend.hpp>
+#include <hps/hier_parameter_server_base.hpp>
+#include <iostream>
+#include <string>
+
+#include "workload.hpp"
+
+using namespace HugeCTR;
+using namespace HugeCTR::db_bench;
+
+typedef long long Key;
+
+namespace {
+
+nlohmann::json run(const size_t hot_key_capacity, const HashMapBackendParams& base_params,
+                   const std::string& tag_name, const WorkloadParams& params) {
+  HashMapBackendParams db_params{base_params};
+  db_params.hot_key_capacity = hot_key_capacity;
+  HashMapBackend<Key> db(db_params);
+
+  prefill(db, tag_name, params, db_params.max_batch_size);
+
+  HCTR_LOG_S(INFO, WORLD) << "Running " << to_string(params.key_distribution)
+                          << " workload with " << hot_key_capacity << " replicated hot keys..."
+                          << std::endl;
+  const WorkloadResult result{run_workload(db, tag_name, params)};
+  const HashMapBackendLoadStats stats{db.load_stats(tag_name)};
+
+  nlohmann::json report;
+  report["hot_key_capacity"] = hot_key_capacity;
+  report["partition_loads"] = stats.partition_loads;
+  report["replica_hits"] = stats.replica_hits;
+  report["replica_size"] = stats.replica_size;
+  report["imbalance"] = stats.imbalance();
+  report["result"] = result.to_json();
+  return report;
+}
+
+}  // namespace
+
+/**
+ * Compares HashMapBackend with and without hot key replication on the same workload, and reports
+ * how evenly the fetched keys are spread across partitions (imbalance = busiest partition / mean).
+ *
+ * Example (16 partitions, 8 clients, Zipf traffic over 10M keys):
+ *   db_hot_keys_bench --key_dist zipf --zipf_exponent 1.1 --threads 8 --hot_keys 16384 \
+ *     --output hot_keys.json
+ */
+int main(int argc, char** argv) {
+  argparse::ArgumentParser args;
+
+  args.add_argument("--output")
+      .help("Path of the JSON report (default: print to stdout).")
+      .default_value<std::string>("");
+  args.add_argument("--key_dist")
+      .help("Key distribution (uniform, zipf, trace).")
+      .default_value<std::string>("zipf");
+  args.add_argument("--num_keys")
+      .help("Size of the key space. The table is prefilled with all keys.")
+      .default_value<size_t>(10L * 1000 * 1000)
+      .scan<'u', size_t>();
+  args.add_argument("--zipf_exponent")
+      .help("Skew of the Zipf distribution.")
+      .default_value<double>(1.1)
+      .scan<'g', double>();
+  args.add_argument("--trace").help("Key-log file to replay.").default_value<std::string>("");
+  args.add_argument("--read_ratio")
+      .help("Fraction of requests that are fetches (others are upserts).")
+      .default_value<double>(1.0)
+      .scan<'g', double>();
+  args.add_argument("--batch_size")
+      .help("Number of keys per request.")
+      .default_value<size_t>(16L * 1024)
+      .scan<'u', size_t>();
+  args.add_argument("--threads")
+      .help("Number of concurrent client threads.")
+      .default_value<size_t>(8)
+      .scan<'u', size_t>();
+  args.add_argument("--duration")
+      .help("Time budget for each run in seconds.")
+      .default_value<double>(10.0)
+      .scan<'g', double>();
+  args.add_argument("--emb_size")
+      .help("Size of one embedding.")
+      .default_value<size_t>(128)
+      .scan<'u', size_t>();
+  args.add_argument("--seed")
+      .help("Seed for the random number generators.")
+      .default_value<uint64_t>(4711)
+      .scan<'u', uint64_t>();
+  args.add_argument("--batch_limit")
+      .help("Maximum batch size of the backend.")
+      .default_value<size_t>(64L * 1024)
+      .scan<'u', size_t>();
+  args.add_argument("--parts")
+      .help("Number of partitions.")
+      .default_value<size_t>(16)
+      .scan<'u', size_t>();
+  args.add_argument("--hm_alloc_rate")
+      .help("Memory pool allocation rate.")
+      .default_value<size_t>(256L * 1024 * 1024)
+      .scan<'u', size_t>();
+  args.add_argument("--hot_keys")
+      .help("Number of hot keys to replicate in the second run.")
+      .default_value<size_t>(16L * 1024)
+      .scan<'u', size_t>();
+  args.add_argument("--hot_key_refresh")
+      .help("Number of fetched keys between refreshes of the replica.")
+      .default_value<size_t>(1024L * 1024)
+      .scan<'u', size_t>();
+
+  try {
+    args.parse_args(argc, argv);
+  } catch (const std::runtime_error& err) {
+    std::cerr << err.what() << std::endl;
+    std::cout << args;
+    return 1;
+  }
+
+  const auto output = args.get<std::string>("--output");
+
+  WorkloadParams params;
+  params.key_distribution = parse_key_distribution(args.get<std::string>("--key_dist"));
+  params.num_keys = args.get<size_t>("--num_keys");
+  params.zipf_exponent = args.get<double>("--zipf_exponent");
+  params.trace_path = args.get<std::string>("--trace");
+  params.read_ratio = args.get<double>("--read_ratio");
+  params.batch_size = args.get<size_t>("--batch_size");
+  params.num_threads = args.get<size_t>("--threads");
+  params.value_size = args.get<size_t>("--emb_size") * sizeof(float);
+  params.duration = std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::duration<double>(args.get<double>("--duration")));
+  params.seed = args.get<uint64_t>("--seed");
+
+  HashMapBackendParams db_params;
+  db_params.max_batch_size = args.get<size_t>("--batch_limit");
+  db_params.num_partitions = args.get<size_t>("--parts");
+  db_params.allocation_rate = args.get<size_t>("--hm_alloc_rate");
+  db_params.hot_key_refresh_interval = args.get<size_t>("--hot_key_refresh");
+  const auto hot_keys = args.get<size_t>("--hot_keys");
+
+  const std::string tag_name{HierParameterServerBase::make_tag_name("mdl", "tab1")};
+
+  nlohmann::json report;
+  report["workload"] = to_json(params);
+  report["partitions"] = db_params.num_partitions;
+  report["runs"] = {run(0, db_params, tag_name, params),
+                    run(hot_keys, db_params, tag_name, params)};
+
+  const double off{report["runs"][0]["result"]["throughput"]["keys_per_s"].get<double>()};
+  const double on{report["runs"][1]["result"]["throughput"]["keys_per_s"].get<double>()};
+  report["speedup"] = off > 0 ? on / off : 0.0;
+
+  if (output.empty()) {
+    std::cout << report.dump(2) << std::endl;
+  } else {
+    std::ofstream file(output);
+    HCTR_CHECK_HINT(file.is_open(), "Unable to open \"", output, "\" for writing.");
+    file << report.dump(2) << std::endl;
+    HCTR_LOG_S(INFO, WORLD) << "Report written to \"" << output << "\"." << std::endl;
+  }
+
+  HCTR_LOG_S(INFO, WORLD) << "Partition imbalance: off = "
+                          << report["runs"][0]["imbalance"].get<double>()
+                          << ", on = " << report["runs"][1]["imbalance"].get<double>() << std::endl;
+  HCTR_LOG_S(INFO, WORLD) << "Throughput (keys/s): off = " << off << ", on = " << on
+                          << ", speedup = " << report["speedup"].get<double>() << std::endl;
+  return 0;
+}
@@ -0,0 +1,233 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <numa.h>
+
+#include <argparse/argparse.hpp>
+#include <core23/logger.hpp>
+#include <filesystem>
+#include <fstream>
+#include <hps/hash_map_backend.hpp>
+#include <hps/hier_parameter_server_base.hpp>
+#include <iostream>
+#include <map>
+#include <string>
+
+#include "workload.hpp"
+
+using namespace HugeCTR;
+using namespace HugeCTR::db_bench;
+
+typedef long long Key;
+
+namespace {
+
+/**
+ * System-wide NUMA page allocation counters (summed over all nodes), as reported by
+ * /sys/devices/system/node/node<N>/numastat. `other_node` counts pages that were allocated on a
+ * node while the allocating thread ran on a different node, i.e., memory that will later be
+ * accessed across the interconnect.
+ */
+using NumaStats = std::map<std::string, long long>;
+
+NumaStats read_numa_stats() {
+  NumaStats stats;
+  const std::filesystem::path root{"/sys/devices/system/node"};
+  if (!std::filesystem::exists(root)) {
+    return stats;
+  }
+  for (const auto& entry : std::filesystem::directory_iterator(root)) {
+    const std::string& name{entry.path().filename().string()};
+    if (name.rfind("node", 0) != 0 || !std::filesystem::exists(entry.path() / "numastat")) {
+      continue;
+    }
+    std::ifstream file(entry.path() / "numastat");
+    std::string key;
+    long long value;
+    while (file >> key >> value) {
+      stats[key] += value;
+    }
+  }
+  return stats;
+}
+
+nlohmann::json numa_stats_delta(const NumaStats& before, const NumaStats& after) {
+  nlohmann::json delta;
+  for (const auto& [key, value] : after) {
+    const auto it{before.find(key)};
+    delta[key] = value - (it == before.end() ? 0 : it->second);
+  }
+  const long long local{delta.value("local_node", 0LL)};
+  const long long other{delta.value("other_node", 0LL)};
+  delta["remote_alloc_ratio"] =
+      local + other > 0 ? static_cast<double>(other) / static_cast<double>(local + other) : 0.0;
+  return delta;
+}
+
+nlohmann::json run(const bool numa_aware, const HashMapBackendParams& base_params,
+                   const std::string& tag_name, const WorkloadParams& params) {
+  HashMapBackendParams db_params{base_params};
+  db_params.numa_aware = numa_aware;
+  HashMapBackend<Key> db(db_params);
+
+  const NumaStats stats_0{read_numa_stats()};
+  prefill(db, tag_name, params, db_params.max_batch_size);
+  const NumaStats stats_1{read_numa_stats()};
+
+  HCTR_LOG_S(INFO, WORLD) << "Running " << to_string(params.key_distribution)
+                          << " workload with NUMA placement " << (numa_aware ? "on" : "off")
+                          << "..." << std::endl;
+  const WorkloadResult result{run_workload(db, tag_name, params)};
+  const NumaStats stats_2{read_numa_stats()};
+
+  nlohmann::json report;
+  report["numa_aware"] = numa_aware;
+  report["nodes"] = nlohmann::json::array();
+  for (size_t i{0}; i < db_params.num_partitions; ++i) {
+    report["nodes"].push_back(db.numa_node(i));
+  }
+  report["numastat_prefill"] = numa_stats_delta(stats_0, stats_1);
+  report["numastat_run"] = numa_stats_delta(stats_1, stats_2);
+  report["result"] = result.to_json();
+  return report;
+}
+
+}  // namespace
+
+/**
+ * Compares HashMapBackend with and without NUMA-aware partition placement on the same workload.
+ *
+ * Example (dual-socket server, 32 clients, uniform traffic over 50M keys):
+ *   db_numa_bench --key_dist uniform --num_keys 50000000 --threads 32 --parts 32 \
+ *     --output numa.json
+ */
+int main(int argc, char** argv) {
+  argparse::ArgumentParser args;
+
+  args.add_argument("--output")
+      .help("Path of the JSON report (default: print to stdout).")
+      .default_value<std::string>("");
+  args.add_argument("--key_dist")
+      .help("Key distribution (uniform, zipf, trace).")
+      .default_value<std::string>("uniform");
+  args.add_argument("--num_keys")
+      .help("Size of the key space. The table is prefilled with all keys.")
+      .default_value<size_t>(10L * 1000 * 1000)
+      .scan<'u', size_t>();
+  args.add_argument("--zipf_exponent")
+      .help("Skew of the Zipf distribution.")
+      .default_value<double>(1.1)
+      .scan<'g', double>();
+  args.add_argument("--trace").help("Key-log file to replay.").default_value<std::string>("");
+  args.add_argument("--read_ratio")
+      .help("Fraction of requests that are fetches (others are upserts).")
+      .default_value<double>(1.0)
+      .scan<'g', double>();
+  args.add_argument("--batch_size")
+      .help("Number of keys per request.")
+      .default_value<size_t>(16L * 1024)
+      .scan<'u', size_t>();
+  args.add_argument("--threads")
+      .help("Number of concurrent client threads.")
+      .default_value<size_t>(8)
+      .scan<'u', size_t>();
+  args.add_argument("--duration")
+      .help("Time budget for each run in seconds.")
+      .default_value<double>(10.0)
+      .scan<'g', double>();
+  args.add_argument("--emb_size")
+      .help("Size of one embedding.")
+      .default_value<size_t>(128)
+      .scan<'u', size_t>();
+  args.add_argument("--seed")
+      .help("Seed for the random number generators.")
+      .default_value<uint64_t>(4711)
+      .scan<'u', uint64_t>();
+  args.add_argument("--batch_limit")
+      .help("Maximum batch size of the backend.")
+      .default_value<size_t>(64L * 1024)
+      .scan<'u', size_t>();
+  args.add_argument("--parts")
+      .help("Number of partitions.")
+      .default_value<size_t>(16)
+      .scan<'u', size_t>();
+  args.add_argument("--hm_alloc_rate")
+      .help("Memory pool allocation rate.")
+      .default_value<size_t>(256L * 1024 * 1024)
+      .scan<'u', size_t>();
+
+  try {
+    args.parse_args(argc, argv);
+  } catch (const std::runtime_error& err) {
+    std::cerr << err.what() << std::endl;
+    std::cout << args;
+    return 1;
+  }
+
+  const auto output = args.get<std::string>("--output");
+
+  WorkloadParams params;
+  params.key_distribution = parse_key_distribution(args.get<std::string>("--key_dist"));
+  params.num_keys = args.get<size_t>("--num_keys");
+  params.zipf_exponent = args.get<double>("--zipf_exponent");
+  params.trace_path = args.get<std::string>("--trace");
+  params.read_ratio = args.get<double>("--read_ratio");
+  params.batch_size = args.get<size_t>("--batch_size");
+  params.num_threads = args.get<size_t>("--threads");
+  params.value_size = args.get<size_t>("--emb_size") * sizeof(float);
+  params.duration = std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::duration<double>(args.get<double>("--duration")));
+  params.seed = args.get<uint64_t>("--seed");
+
+  HashMapBackendParams db_params;
+  db_params.max_batch_size = args.get<size_t>("--batch_limit");
+  db_params.num_partitions = args.get<size_t>("--parts");
+  db_params.allocation_rate = args.get<size_t>("--hm_alloc_rate");
+
+  if (numa_available() < 0) {
+    HCTR_LOG_S(WARNING, WORLD) << "NUMA is not available. Both runs will use the same placement."
+                               << std::endl;
+  } else {
+    HCTR_LOG_S(INFO, WORLD) << "System has " << numa_num_configured_nodes() << " NUMA node(s)."
+                            << std::endl;
+  }
+
+  const std::string tag_name{HierParameterServerBase::make_tag_name("mdl", "tab1")};
+
+  nlohmann::json report;
+  report["workload"] = to_json(params);
+  report["partitions"] = db_params.num_partitions;
+  report["numa_nodes"] = numa_available() < 0 ? 0 : numa_num_configured_nodes();
+  report["runs"] = {run(false, db_params, tag_name, params),
+                    run(true, db_params, tag_name, params)};
+
+  const double off{report["runs"][0]["result"]["throughput"]["keys_per_s"].get<double>()};
+  const double on{report["runs"][1]["result"]["throughput"]["keys_per_s"].get<double>()};
+  report["speedup"] = off > 0 ? on / off : 0.0;
+
+  if (output.empty()) {
+    std::cout << report.dump(2) << std::endl;
+  } else {
+    std::ofstream file(output);
+    HCTR_CHECK_HINT(file.is_open(), "Unable to open \"", output, "\" for writing.");
+    file << report.dump(2) << std::endl;
+    HCTR_LOG_S(INFO, WORLD) << "Report written to \"" << output << "\"." << std::endl;
+  }
+
+  HCTR_LOG_S(INFO, WORLD) << "Throughput (keys/s): off = " << off << ", on = " << on
+                          << ", speedup = " << report["speedup"].get<double>() << std::endl;
+  return 0;
+}
@@ -0,0 +1,342 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <cmath>
+#include <core/memory.hpp>
+#include <core23/logger.hpp>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <numeric>
+#include <thread>
+
+#include "workload.hpp"
+
+namespace HugeCTR {
+namespace db_bench {
+
+KeyDistribution_t parse_key_distribution(const std::string& name) {
+  if (name == "uniform") {
+    return KeyDistribution_t::Uniform;
+  } else if (name == "zipf") {
+    return KeyDistribution_t::Zipf;
+  } else if (name == "trace") {
+    return KeyDistribution_t::Trace;
+  }
+  HCTR_DIE("Unknown key distribution \"", name, "\"! Use one of: uniform, zipf, trace.");
+  return KeyDistribution_t::Uniform;
+}
+
+const char* to_string(const KeyDistribution_t distribution) {
+  switch (distribution) {
+    case KeyDistribution_t::Uniform:
+      return "uniform";
+    case KeyDistribution_t::Zipf:
+      return "zipf";
+    case KeyDistribution_t::Trace:
+      return "trace";
+  }
+  return "unknown";
+}
+
+template <typename Key>
+std::shared_ptr<const std::vector<Key>> load_key_trace(const std::string& path) {
+  auto trace{std::make_shared<std::vector<Key>>()};
+
+  if (std::filesystem::path(path).extension() == ".bin") {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    HCTR_CHECK_HINT(file.is_open(), "Unable to open key trace \"", path, "\".");
+    const size_t num_bytes{static_cast<size_t>(file.tellg())};
+    HCTR_CHECK_HINT(num_bytes % sizeof(Key) == 0, "Key trace \"", path,
+                    "\" is not a multiple of the key size.");
+    trace->resize(num_bytes / sizeof(Key));
+    file.seekg(0);
+    file.read(reinterpret_cast<char*>(trace->data()), static_cast<std::streamsize>(num_bytes));
+  } else {
+    std::ifstream file(path);
+    HCTR_CHECK_HINT(file.is_open(), "Unable to open key trace \"", path, "\".");
+    for (Key key; file >> key;) {
+      trace->emplace_back(key);
+    }
+  }
+
+  HCTR_CHECK_HINT(!trace->empty(), "Key trace \"", path, "\" is empty.");
+  HCTR_LOG_S(INFO, WORLD) << "Loaded " << trace->size() << " keys from trace \"" << path << "\"."
+                          << std::endl;
+  return trace;
+}
+
+nlohmann::json to_json(const WorkloadParams& params) {
+  nlohmann::json j;
+  j["key_distribution"] = to_string(params.key_distribution);
+  j["num_keys"] = params.num_keys;
+  j["zipf_exponent"] = params.zipf_exponent;
+  j["trace_path"] = params.trace_path;
+  j["read_ratio"] = params.read_ratio;
+  j["batch_size"] = params.batch_size;
+  j["num_threads"] = params.num_threads;
+  j["value_size"] = params.value_size;
+  j["duration_s"] = std::chrono::duration<double>(params.duration).count();
+  j["max_requests"] = params.max_requests;
+  j["request_time_budget_ns"] = params.request_time_budget.count();
+  j["seed"] = params.seed;
+  return j;
+}
+
+LatencyStats LatencyStats::from_samples(std::vector<uint64_t>& samples) {
+  LatencyStats stats;
+  stats.count = samples.size();
+  if (samples.empty()) {
+    return stats;
+  }
+
+  std::sort(samples.begin(), samples.end());
+  const auto percentile{[&](const double p) {
+    const size_t rank{static_cast<size_t>(std::ceil(p * static_cast<double>(samples.size())))};
+    return static_cast<double>(samples[std::clamp<size_t>(rank, 1, samples.size()) - 1]) / 1000.0;
+  }};
+
+  stats.mean_us = std::accumulate(samples.begin(), samples.end(), 0.0) /
+                  static_cast<double>(samples.size()) / 1000.0;
+  stats.p50_us = percentile(0.5);
+  stats.p99_us = percentile(0.99);
+  stats.p999_us = percentile(0.999);
+  stats.max_us = static_cast<double>(samples.back()) / 1000.0;
+  return stats;
+}
+
+nlohmann::json LatencyStats::to_json() const {
+  nlohmann::json j;
+  j["count"] = count;
+  j["mean_us"] = mean_us;
+  j["p50_us"] = p50_us;
+  j["p99_us"] = p99_us;
+  j["p999_us"] = p999_us;
+  j["max_us"] = max_us;
+  return j;
+}
+
+nlohmann::json WorkloadResult::to_json() const {
+  const size_t num_requests{num_fetch_requests + num_upsert_requests};
+  const size_t num_keys{num_fetched_keys + num_upserted_keys};
+
+  nlohmann::json j;
+  j["elapsed_s"] = elapsed_s;
+  j["throughput"] = {
+      {"requests_per_s", elapsed_s > 0 ? num_requests / elapsed_s : 0},
+      {"keys_per_s", elapsed_s > 0 ? num_keys / elapsed_s : 0},
+  };
+  j["fetch"] = {
+      {"requests", num_fetch_requests},
+      {"keys", num_fetched_keys},
+      {"hits", num_hits},
+      {"hit_rate", hit_rate()},
+      {"latency", fetch_latency.to_json()},
+  };
+  j["upsert"] = {
+      {"requests", num_upsert_requests},
+      {"keys", num_upserted_keys},
+      {"latency", upsert_latency.to_json()},
+  };
+  j["memory"] = {
+      {"table_size", table_size},
+      {"rss_before_fill_bytes", rss_before_fill_bytes},
+      {"rss_after_fill_bytes", rss_after_fill_bytes},
+      {"rss_after_run_bytes", rss_after_run_bytes},
+      {"rss_delta_bytes", rss_after_run_bytes > rss_before_fill_bytes
+                              ? rss_after_run_bytes - rss_before_fill_bytes
+                              : 0},
+  };
+  return j;
+}
+
+size_t resident_memory_bytes() {
+  std::ifstream statm("/proc/self/statm");
+  size_t num_pages{0};
+  size_t num_resident_pages{0};
+  if (!(statm >> num_pages >> num_resident_pages)) {
+    return 0;
+  }
+  return num_resident_pages * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+}
+
+template <typename Key>
+std::unique_ptr<KeyGenerator<Key>> make_key_generator(
+    const WorkloadParams& params, const std::shared_ptr<const std::vector<Key>>& trace,
+    const size_t client_index) {
+  const uint64_t seed{params.seed + client_index};
+  switch (params.key_distribution) {
+    case KeyDistribution_t::Uniform:
+      return std::make_unique<UniformKeyGenerator<Key>>(params.num_keys, seed);
+    case KeyDistribution_t::Zipf:
+      return std::make_unique<ZipfKeyGenerator<Key>>(params.num_keys, params.zipf_exponent, seed);
+    case KeyDistribution_t::Trace:
+      return std::make_unique<TraceKeyGenerator<Key>>(
+          trace, trace->size() / params.num_threads * client_index);
+  }
+  HCTR_DIE("Unreachable!");
+  return nullptr;
+}
+
+namespace {
+
+std::vector<char> make_random_values(const size_t num_values, const size_t value_size,
+                                     const uint64_t seed) {
+  std::mt19937_64 gen{seed};
+  std::uniform_int_distribution<int> dist(std::numeric_limits<char>::min(),
+                                          std::numeric_limits<char>::max());
+  std::vector<char> values(num_values * value_size);
+  std::generate(values.begin(), values.end(), [&]() { return static_cast<char>(dist(gen)); });
+  return values;
+}
+
+}  // namespace
+
+template <typename Key>
+void prefill(DatabaseBackendBase<Key>& db, const std::string& table_name,
+             const WorkloadParams& params, const size_t max_batch_size) {
+  const size_t batch_size{std::min(params.num_keys, max_batch_size)};
+  const std::vector<char> values{make_random_values(batch_size, params.value_size, params.seed)};
+  std::vector<Key> keys(batch_size);
+
+  const auto t0{std::chrono::high_resolution_clock::now()};
+  for (size_t i{0}; i < params.num_keys;) {
+    const size_t n{std::min(params.num_keys - i, batch_size)};
+    for (size_t j{0}; j < n; ++i, ++j) {
+      keys[j] = static_cast<Key>(i);
+    }
+    db.insert(table_name, n, keys.data(), values.data(), static_cast<uint32_t>(params.value_size),
+              params.value_size);
+  }
+  const auto t1{std::chrono::high_resolution_clock::now()};
+
+  HCTR_LOG_S(INFO, WORLD) << "Prefilled " << params.num_keys << " keys in "
+                          << std::chrono::duration<double>(t1 - t0).count()
+                          << " s. Table size = " << db.size(table_name) << '.' << std::endl;
+}
+
+template <typename Key>
+WorkloadResult run_workload(DatabaseBackendBase<Key>& db, const std::string& table_name,
+                            const WorkloadParams& params) {
+  HCTR_CHECK_HINT(params.num_threads > 0, "Need at least one client thread.");
+  HCTR_CHECK_HINT(params.batch_size > 0, "Batch size must be positive.");
+  HCTR_CHECK_HINT(params.read_ratio >= 0 && params.read_ratio <= 1,
+                  "Read ratio must be within [0, 1].");
+
+  std::shared_ptr<const std::vector<Key>> trace;
+  if (params.key_distribution == KeyDistribution_t::Trace) {
+    trace = load_key_trace<Key>(params.trace_path);
+  }
+
+  WorkloadResult result;
+  std::vector<uint64_t> fetch_samples;
+  std::vector<uint64_t> upsert_samples;
+  std::mutex result_guard;
+
+  const auto begin{std::chrono::high_resolution_clock::now()};
+  const auto deadline{begin + params.duration};
+
+  const auto client{[&](const size_t client_index) {
+    const std::unique_ptr<KeyGenerator<Key>> key_gen{
+        make_key_generator(params, trace, client_index)};
+
+    std::mt19937_64 gen{params.seed ^ (UINT64_C(0x9E3779B97F4A7C15) * (client_index + 1))};
+    std::bernoulli_distribution is_read{params.read_ratio};
+
+    std::vector<Key> keys(params.batch_size);
+    const std::vector<char> in_values{
+        make_random_values(params.batch_size, params.value_size, gen())};
+    std::vector<char, AlignedAllocator<char>> out_values(params.batch_size * params.value_size);
+
+    WorkloadResult local;
+    std::vector<uint64_t> local_fetch_samples;
+    std::vector<uint64_t> local_upsert_samples;
+
+    for (size_t num_requests{0};
+         params.max_requests == 0 || num_requests < params.max_requests; ++num_requests) {
+      key_gen->fill(keys.data(), keys.size());
+
+      const auto t0{std::chrono::high_resolution_clock::now()};
+      if (t0 >= deadline) {
+        break;
+      }
+
+      if (is_read(gen)) {
+        const size_t num_hits{db.fetch(table_name, keys.size(), keys.data(), out_values.data(),
+                                       params.value_size, [](const size_t) {},
+                                       params.request_time_budget)};
+        const auto t1{std::chrono::high_resolution_clock::now()};
+        local_fetch_samples.emplace_back(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count());
+        ++local.num_fetch_requests;
+        local.num_fetched_keys += keys.size();
+        local.num_hits += num_hits;
+      } else {
+        db.insert(table_name, keys.size(), keys.data(), in_values.data(),
+                  static_cast<uint32_t>(params.value_size), params.value_size);
+        const auto t1{std::chrono::high_resolution_clock::now()};
+        local_upsert_samples.emplace_back(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count());
+        ++local.num_upsert_requests;
+        local.num_upserted_keys += keys.size();
+      }
+    }
+
+    const std::lock_guard lock(result_guard);
+    result.num_fetch_requests += local.num_fetch_requests;
+    result.num_fetched_keys += local.num_fetched_keys;
+    result.num_hits += local.num_hits;
+    result.num_upsert_requests += local.num_upsert_requests;
+    result.num_upserted_keys += local.num_upserted_keys;
+    fetch_samples.insert(fetch_samples.end(), local_fetch_samples.begin(),
+                         local_fetch_samples.end());
+    upsert_samples.insert(upsert_samples.end(), local_upsert_samples.begin(),
+                          local_upsert_samples.end());
+  }};
+
+  std::vector<std::thread> clients;
+  clients.reserve(params.num_threads);
+  for (size_t i{0}; i < params.num_threads; ++i) {
+    clients.emplace_back(client, i);
+  }
+  for (std::thread& t : clients) {
+    t.join();
+  }
+
+  const auto end{std::chrono::high_resolution_clock::now()};
+  result.elapsed_s = std::chrono::duration<double>(end - begin).count();
+  result.fetch_latency = LatencyStats::from_samples(fetch_samples);
+  result.upsert_latency = LatencyStats::from_samples(upsert_samples);
+  result.table_size = db.size(table_name);
+  result.rss_after_run_bytes = resident_memory_bytes();
+  return result;
+}
+
+template class UniformKeyGenerator<long long>;
+template class TraceKeyGenerator<long long>;
+template std::unique_ptr<KeyGenerator<long long>> make_key_generator(
+    const WorkloadParams&, const std::shared_ptr<const std::vector<long long>>&, size_t);
+template std::shared_ptr<const std::vector<long long>> load_key_trace(const std::string&);
+template void prefill(DatabaseBackendBase<long long>&, const std::string&, const WorkloadParams&,
+                      size_t);
+template WorkloadResult run_workload(DatabaseBackendBase<long long>&, const std::string&,
+                                     const WorkloadParams&);
+
+}  // namespace db_bench
+}  // namespace HugeCTR
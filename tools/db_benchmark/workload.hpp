@@ -0,0 +1,210 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <data_generator/key_sampler.hpp>
+#include <hps/database_backend.hpp>
+#include <memory>
+#include <nlohmann/json.hpp>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace HugeCTR {
+namespace db_bench {
+
+enum class KeyDistribution_t {
+  Uniform,  // Every key in [0, num_keys) is equally likely.
+  Zipf,     // Power-law distribution over [0, num_keys). Rank 0 is the hottest key.
+  Trace,    // Replay keys recorded in a key-log file.
+};
+
+KeyDistribution_t parse_key_distribution(const std::string& name);
+
+const char* to_string(KeyDistribution_t distribution);
+
+/**
+ * Produces an infinite stream of keys. Each client thread owns its own generator instance.
+ */
+template <typename Key>
+class KeyGenerator {
+ public:
+  virtual ~KeyGenerator() = default;
+
+  virtual Key next() = 0;
+
+  void fill(Key* keys, const size_t num_keys) {
+    for (Key* const keys_end{&keys[num_keys]}; keys != keys_end; ++keys) {
+      *keys = next();
+    }
+  }
+};
+
+template <typename Key>
+class UniformKeyGenerator final : public KeyGenerator<Key> {
+ public:
+  UniformKeyGenerator(size_t num_keys, uint64_t seed) : gen_{seed}, dist_{0, num_keys - 1} {}
+
+  Key next() override { return static_cast<Key>(dist_(gen_)); }
+
+ private:
+  std::mt19937_64 gen_;
+  std::uniform_int_distribution<size_t> dist_;
+};
+
+/**
+ * Zipf keys drawn with the dataset generator's rejection-inversion sampler, so that benchmarks and
+ * generated datasets share one key distribution. Sampling is O(1) and needs no precomputed tables,
+ * so it works for key spaces with billions of keys.
+ */
+template <typename Key>
+class ZipfKeyGenerator final : public KeyGenerator<Key> {
+ public:
+  ZipfKeyGenerator(size_t num_keys, double exponent, uint64_t seed)
+      : sampler_{num_keys, exponent}, rng_{seed, 0} {}
+
+  Key next() override { return static_cast<Key>(sampler_.sample(rng_)); }
+
+ private:
+  const ZipfRejectionInversionKeySampler sampler_;
+  PhiloxStream rng_;
+};
+
+/**
+ * Replays a recorded key stream. The trace is loaded once and shared between all client threads.
+ * Each client starts at a different offset and wraps around at the end of the trace.
+ */
+template <typename Key>
+class TraceKeyGenerator final : public KeyGenerator<Key> {
+ public:
+  TraceKeyGenerator(std::shared_ptr<const std::vector<Key>> trace, size_t offset)
+      : trace_{std::move(trace)}, pos_{offset % trace_->size()} {}
+
+  Key next() override {
+    const Key key{(*trace_)[pos_]};
+    if (++pos_ == trace_->size()) {
+      pos_ = 0;
+    }
+    return key;
+  }
+
+ private:
+  const std::shared_ptr<const std::vector<Key>> trace_;
+  size_t pos_;
+};
+
+/**
+ * Loads a key-log file. Binary files (extension ".bin") are interpreted as a packed array of
+ * `Key`. Anything else is parsed as text with one key per line.
+ */
+template <typename Key>
+std::shared_ptr<const std::vector<Key>> load_key_trace(const std::string& path);
+
+struct WorkloadParams {
+  KeyDistribution_t key_distribution{KeyDistribution_t::Uniform};
+  size_t num_keys{1000L * 1000};  // Size of the key space (also used to prefill the table).
+  double zipf_exponent{1.1};      // Skew of the Zipf distribution.
+  std::string trace_path;         // Key-log file used by KeyDistribution_t::Trace.
+
+  double read_ratio{0.95};    // Fraction of requests that are fetches. Others are upserts.
+  size_t batch_size{1024};    // Number of keys per request.
+  size_t num_threads{1};      // Number of concurrent client threads.
+  size_t value_size{128 * sizeof(float)};  // Size of a single value in bytes.
+
+  std::chrono::nanoseconds duration{std::chrono::seconds{10}};  // Time budget for the run.
+  size_t max_requests{0};  // Stop after this many requests per thread (0 = unlimited).
+  std::chrono::nanoseconds request_time_budget{std::chrono::nanoseconds::zero()};  // Per fetch.
+
+  uint64_t seed{4711};
+};
+
+nlohmann::json to_json(const WorkloadParams& params);
+
+/**
+ * Creates the key generator of the `client_index`-th client. Clients draw from the same
+ * distribution, but use different seeds (or start at different positions of the trace).
+ */
+template <typename Key>
+std::unique_ptr<KeyGenerator<Key>> make_key_generator(
+    const WorkloadParams& params, const std::shared_ptr<const std::vector<Key>>& trace,
+    size_t client_index);
+
+/**
+ * Latency distribution of one request type.
+ */
+struct LatencyStats {
+  size_t count{0};
+  double mean_us{0};
+  double p50_us{0};
+  double p99_us{0};
+  double p999_us{0};
+  double max_us{0};
+
+  /**
+   * Summarizes a set of samples (given in nanoseconds). The input is sorted in-place.
+   */
+  static LatencyStats from_samples(std::vector<uint64_t>& samples);
+
+  nlohmann::json to_json() const;
+};
+
+struct WorkloadResult {
+  double elapsed_s{0};
+  size_t num_fetch_requests{0};
+  size_t num_upsert_requests{0};
+  size_t num_fetched_keys{0};
+  size_t num_hits{0};
+  size_t num_upserted_keys{0};
+
+  LatencyStats fetch_latency;
+  LatencyStats upsert_latency;
+
+  size_t table_size{0};
+  size_t rss_before_fill_bytes{0};
+  size_t rss_after_fill_bytes{0};
+  size_t rss_after_run_bytes{0};
+
+  inline double hit_rate() const {
+    return num_fetched_keys ? static_cast<double>(num_hits) / num_fetched_keys : 0;
+  }
+
+  nlohmann::json to_json() const;
+};
+
+/**
+ * Current resident set size of this process in bytes. Only meaningful for in-process backends.
+ */
+size_t resident_memory_bytes();
+
+/**
+ * Inserts keys [0, num_keys) with random values in batches of `max_batch_size`.
+ */
+template <typename Key>
+void prefill(DatabaseBackendBase<Key>& db, const std::string& table_name,
+             const WorkloadParams& params, size_t max_batch_size);
+
+/**
+ * Runs the configured workload with `params.num_threads` concurrent clients until either the
+ * time budget or the request limit is exhausted.
+ */
+template <typename Key>
+WorkloadResult run_workload(DatabaseBackendBase<Key>& db, const std::string& table_name,
+                            const WorkloadParams& params);
+
+}  // namespace db_bench
+}  // namespace HugeCTR
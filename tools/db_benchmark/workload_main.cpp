@@ -0,0 +1,271 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <argparse/argparse.hpp>
+#include <core23/logger.hpp>
+#include <fstream>
+#include <hps/hash_map_backend.hpp>
+#include <hps/hier_parameter_server_base.hpp>
+#include <hps/mp_hash_map_backend.hpp>
+#include <hps/redis_backend.hpp>
+#include <hps/rocksdb_backend.hpp>
+#include <iostream>
+#include <string>
+
+#include "workload.hpp"
+
+using namespace HugeCTR;
+using namespace HugeCTR::db_bench;
+
+typedef long long Key;
+
+/**
+ * Workload-replay benchmark for HPS database backends.
+ *
+ * Example (Zipf traffic, 90% reads, 8 clients, 30 s against a local Redis):
+ *   db_workload_bench --db_type redis --key_dist zipf --zipf_exponent 1.05 --read_ratio 0.9 \
+ *     --threads 8 --duration 30 --output redis_zipf.json
+ */
+int main(int argc, char** argv) {
+  argparse::ArgumentParser args;
+
+  args.add_argument("--model").help("Model name.").default_value<std::string>("mdl");
+  args.add_argument("--table").help("Table name.").default_value<std::string>("tab1");
+  args.add_argument("--db_type")
+      .help("Backend to test (hashmap, mp_hashmap, redis, rocksdb).")
+      .required();
+  args.add_argument("--output")
+      .help("Path of the JSON report (default: print to stdout).")
+      .default_value<std::string>("");
+
+  // Workload parameters.
+  args.add_argument("--key_dist")
+      .help("Key distribution (uniform, zipf, trace).")
+      .default_value<std::string>("zipf");
+  args.add_argument("--num_keys")
+      .help("Size of the key space. The table is prefilled with all keys.")
+      .default_value<size_t>(10L * 1000 * 1000)
+      .scan<'u', size_t>();
+  args.add_argument("--zipf_exponent")
+      .help("Skew of the Zipf distribution.")
+      .default_value<double>(1.1)
+      .scan<'g', double>();
+  args.add_argument("--trace").help("Key-log file to replay.").default_value<std::string>("");
+  args.add_argument("--read_ratio")
+      .help("Fraction of requests that are fetches (others are upserts).")
+      .default_value<double>(0.95)
+      .scan<'g', double>();
+  args.add_argument("--batch_size")
+      .help("Number of keys per request.")
+      .default_value<size_t>(1024)
+      .scan<'u', size_t>();
+  args.add_argument("--threads")
+      .help("Number of concurrent client threads.")
+      .default_value<size_t>(1)
+      .scan<'u', size_t>();
+  args.add_argument("--duration")
+      .help("Time budget for the run in seconds.")
+      .default_value<double>(10.0)
+      .scan<'g', double>();
+  args.add_argument("--max_requests")
+      .help("Maximum number of requests per client (0 = unlimited).")
+      .default_value<size_t>(0)
+      .scan<'u', size_t>();
+  args.add_argument("--request_time_budget")
+      .help("Time budget passed to every fetch in microseconds (0 = unlimited).")
+      .default_value<size_t>(0)
+      .scan<'u', size_t>();
+  args.add_argument("--emb_size")
+      .help("Size of one embedding.")
+      .default_value<size_t>(128)
+      .scan<'u', size_t>();
+  args.add_argument("--no_prefill")
+      .help("Do not prefill the table (e.g., when reusing a persistent database).")
+      .default_value(false)
+      .implicit_value(true);
+  args.add_argument("--seed")
+      .help("Seed for the random number generators.")
+      .default_value<uint64_t>(4711)
+      .scan<'u', uint64_t>();
+
+  // Common backend parameters.
+  args.add_argument("--batch_limit")
+      .help("Maximum batch size of the backend.")
+      .default_value<size_t>(64L * 1024)
+      .scan<'u', size_t>();
+  args.add_argument("--parts")
+      .help("Number of partitions (volatile backends).")
+      .default_value<size_t>(16)
+      .scan<'u', size_t>();
+  args.add_argument("--overflow_margin")
+      .help("Overflow margin per partition (volatile backends).")
+      .default_value<size_t>(std::numeric_limits<size_t>::max())
+      .scan<'u', size_t>();
+
+  // HM parameters.
+  args.add_argument("--hm_alloc_rate")
+      .help("Memory pool allocation rate.")
+      .default_value<size_t>(256L * 1024 * 1024)
+      .scan<'u', size_t>();
+  args.add_argument("--hm_numa")
+      .help("Enable NUMA-aware partition placement (hashmap only).")
+      .default_value(false)
+      .implicit_value(true);
+  args.add_argument("--hm_sm_size")
+      .help("Maximum shared memory size.")
+      .default_value<size_t>(16L * 1024 * 1024 * 1024)
+      .scan<'u', size_t>();
+
+  // Redis parameters.
+  args.add_argument("--re_address")
+      .help("Redis server address.")
+      .default_value<std::string>("localhost:7000");
+  args.add_argument("--re_connections")
+      .help("Number of connections per Redis node.")
+      .default_value<size_t>(5)
+      .scan<'u', size_t>();
+
+  // RocksDB parameters.
+  args.add_argument("--ro_path")
+      .help("RocksDB database path.")
+      .default_value<std::string>("/tmp/rocksdb");
+  args.add_argument("--ro_threads")
+      .help("Number of threads for RocksDB.")
+      .default_value<size_t>(16)
+      .scan<'u', size_t>();
+
+  try {
+    args.parse_args(argc, argv);
+  } catch (const std::runtime_error& err) {
+    std::cerr << err.what() << std::endl;
+    std::cout << args;
+    return 1;
+  }
+
+  const auto model_name = args.get<std::string>("--model");
+  const auto table_name = args.get<std::string>("--table");
+  const auto db_type = args.get<std::string>("--db_type");
+  const auto output = args.get<std::string>("--output");
+  const auto no_prefill = args.get<bool>("--no_prefill");
+  const auto batch_limit = args.get<size_t>("--batch_limit");
+  const auto parts = args.get<size_t>("--parts");
+  const auto overflow_margin = args.get<size_t>("--overflow_margin");
+
+  WorkloadParams params;
+  params.key_distribution = parse_key_distribution(args.get<std::string>("--key_dist"));
+  params.num_keys = args.get<size_t>("--num_keys");
+  params.zipf_exponent = args.get<double>("--zipf_exponent");
+  params.trace_path = args.get<std::string>("--trace");
+  params.read_ratio = args.get<double>("--read_ratio");
+  params.batch_size = args.get<size_t>("--batch_size");
+  params.num_threads = args.get<size_t>("--threads");
+  params.value_size = args.get<size_t>("--emb_size") * sizeof(float);
+  params.duration = std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::duration<double>(args.get<double>("--duration")));
+  params.max_requests = args.get<size_t>("--max_requests");
+  params.request_time_budget = std::chrono::microseconds(args.get<size_t>("--request_time_budget"));
+  params.seed = args.get<uint64_t>("--seed");
+
+  const std::string tag_name = HierParameterServerBase::make_tag_name(model_name, table_name);
+
+  WorkloadResult result;
+  result.rss_before_fill_bytes = resident_memory_bytes();
+
+  std::unique_ptr<DatabaseBackendBase<Key>> db;
+  if (db_type == "hashmap") {
+    HashMapBackendParams db_params;
+    db_params.max_batch_size = batch_limit;
+    db_params.num_partitions = parts;
+    db_params.overflow_margin = overflow_margin;
+    db_params.allocation_rate = args.get<size_t>("--hm_alloc_rate");
+    db_params.numa_aware = args.get<bool>("--hm_numa");
+    db = std::make_unique<HashMapBackend<Key>>(db_params);
+  } else if (db_type == "mp_hashmap") {
+    MultiProcessHashMapBackendParams db_params;
+    db_params.max_batch_size = batch_limit;
+    db_params.num_partitions = parts;
+    db_params.overflow_margin = overflow_margin;
+    db_params.allocation_rate = args.get<size_t>("--hm_alloc_rate");
+    db_params.shared_memory_size = args.get<size_t>("--hm_sm_size");
+    db = std::make_unique<MultiProcessHashMapBackend<Key>>(db_params);
+#ifdef HCTR_USE_REDIS
+  } else if (db_type == "redis") {
+    RedisClusterBackendParams db_params;
+    db_params.max_batch_size = batch_limit;
+    db_params.num_partitions = parts;
+    db_params.overflow_margin = overflow_margin;
+    db_params.address = args.get<std::string>("--re_address");
+    db_params.num_node_connections = args.get<size_t>("--re_connections");
+    db = std::make_unique<RedisClusterBackend<Key>>(db_params);
+#endif  // HCTR_USE_REDIS
+#ifdef HCTR_USE_ROCKS_DB
+  } else if (db_type == "rocksdb") {
+    RocksDBBackendParams db_params;
+    db_params.max_batch_size = batch_limit;
+    db_params.path = args.get<std::string>("--ro_path");
+    db_params.num_threads = args.get<size_t>("--ro_threads");
+    db = std::make_unique<RocksDBBackend<Key>>(db_params);
+#endif  // HCTR_USE_ROCKS_DB
+  } else {
+    HCTR_DIE("Unsupported db_type!");
+  }
+
+  nlohmann::json report;
+  report["backend"] = {
+      {"db_type", db_type},
+      {"name", db->get_name()},
+      {"shared", db->is_shared()},
+      {"batch_limit", batch_limit},
+      {"partitions", parts},
+      {"overflow_margin", overflow_margin},
+  };
+  report["workload"] = to_json(params);
+
+  try {
+    if (!no_prefill) {
+      prefill(*db, tag_name, params, batch_limit);
+    }
+    const size_t rss_before_fill_bytes{result.rss_before_fill_bytes};
+    const size_t rss_after_fill_bytes{resident_memory_bytes()};
+
+    HCTR_LOG_S(INFO, WORLD) << "Running " << to_string(params.key_distribution) << " workload with "
+                            << params.num_threads << " client(s)..." << std::endl;
+    result = run_workload(*db, tag_name, params);
+    result.rss_before_fill_bytes = rss_before_fill_bytes;
+    result.rss_after_fill_bytes = rss_after_fill_bytes;
+  } catch (const DatabaseBackendError& error) {
+    HCTR_LOG_S(ERROR, WORLD) << "Partition #" << error.partition() << ": " << error.what()
+                             << std::endl;
+    return 1;
+  }
+
+  report["result"] = result.to_json();
+
+  if (output.empty()) {
+    std::cout << report.dump(2) << std::endl;
+  } else {
+    std::ofstream file(output);
+    HCTR_CHECK_HINT(file.is_open(), "Unable to open \"", output, "\" for writing.");
+    file << report.dump(2) << std::endl;
+    HCTR_LOG_S(INFO, WORLD) << "Report written to \"" << output << "\"." << std::endl;
+  }
+
+  HCTR_LOG_S(INFO, WORLD) << "Throughput: "
+                          << report["result"]["throughput"]["keys_per_s"].get<double>()
+                          << " keys/s, fetch p99: " << result.fetch_latency.p99_us
+                          << " us, hit rate: " << result.hit_rate() << std::endl;
+  return 0;
+}
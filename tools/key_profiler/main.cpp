@@ -0,0 +1,274 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <argparse/argparse.hpp>
+#include <chrono>
+#include <core23/logger.hpp>
+#include <data_readers/file_list.hpp>
+#include <data_readers/key_profiler.hpp>
+#include <fstream>
+#include <iostream>
+#include <nlohmann/json.hpp>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace HugeCTR;
+
+namespace {
+
+std::vector<int64_t> parse_list(const std::string& list) {
+  std::vector<int64_t> values;
+  std::stringstream stream(list);
+  std::string value;
+  while (std::getline(stream, value, ',')) {
+    if (!value.empty()) {
+      values.push_back(std::stoll(value));
+    }
+  }
+  return values;
+}
+
+/**
+ * Writes the keys of all slots in the format of `tools/keyset_scripts/generate_keyset.py`. Keys
+ * are shifted by the sum of the sizes of the preceding slots, and only the most frequent keys that
+ * receive \p coverage of the accesses of a slot are written.
+ */
+void write_keyset(const std::string& path, const std::vector<KeyProfile>& profiles,
+                  const std::vector<int64_t>& slot_size_array, bool int32_keyset,
+                  double coverage) {
+  HCTR_CHECK_HINT(slot_size_array.empty() || slot_size_array.size() == profiles.size(),
+                  "--slot_size_array must have one entry per slot.");
+  std::ofstream file(path, std::ios::binary);
+  HCTR_CHECK_HINT(file.is_open(), "Unable to open \"", path, "\" for writing.");
+
+  int64_t offset{0};
+  size_t num_keys{0};
+  for (size_t slot{0}; slot < profiles.size(); ++slot) {
+    const KeyProfile& profile{profiles[slot]};
+    size_t n{profile.keys.size()};
+    if (coverage < 1) {
+      n = std::min<size_t>(n, profile.keys_for_coverage(coverage));
+    }
+    for (size_t i{0}; i < n; ++i) {
+      const int64_t key{profile.keys[i].first + offset};
+      if (int32_keyset) {
+        const int32_t key32{static_cast<int32_t>(key)};
+        file.write(reinterpret_cast<const char*>(&key32), sizeof(key32));
+      } else {
+        file.write(reinterpret_cast<const char*>(&key), sizeof(key));
+      }
+    }
+    num_keys += n;
+    if (!slot_size_array.empty()) {
+      offset += slot_size_array[slot];
+    }
+  }
+  HCTR_CHECK_HINT(file.good(), "Unable to write \"", path, "\".");
+  HCTR_LOG_S(INFO, WORLD) << "Wrote " << num_keys << " keys to \"" << path << "\"." << std::endl;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  argparse::ArgumentParser args;
+
+  args.add_argument("--format")
+      .help("Dataset format: raw_async or norm.")
+      .default_value<std::string>("raw_async");
+  args.add_argument("--file_list")
+      .help("File list of the dataset, in the format used by the data readers.")
+      .default_value<std::string>("");
+  args.add_argument("--data")
+      .help("Single data file. Alternative to --file_list.")
+      .default_value<std::string>("");
+  args.add_argument("--label_dim")
+      .help("Labels per RawAsync sample.")
+      .default_value<size_t>(1)
+      .scan<'u', size_t>();
+  args.add_argument("--dense_dim")
+      .help("Dense features per RawAsync sample.")
+      .default_value<size_t>(13)
+      .scan<'u', size_t>();
+  args.add_argument("--nnz_array")
+      .help("Comma-separated keys per slot of RawAsync samples.")
+      .default_value<std::string>("");
+  args.add_argument("--i64_input_key")
+      .help("RawAsync keys are int64 instead of uint32.")
+      .default_value(false)
+      .implicit_value(true);
+  args.add_argument("--num_threads")
+      .help("Number of threads (default: all hardware threads).")
+      .default_value<size_t>(0)
+      .scan<'u', size_t>();
+  args.add_argument("--max_exact_gb")
+      .help("GB of memory for exact counts before switching to count-min sketches.")
+      .default_value<double>(4)
+      .scan<'g', double>();
+  args.add_argument("--sketch_width")
+      .help("Counters per row of the count-min sketches.")
+      .default_value<size_t>(1 << 20)
+      .scan<'u', size_t>();
+  args.add_argument("--num_heavy_hitters")
+      .help("Keys per slot that are tracked once counts are no longer exact.")
+      .default_value<size_t>(1 << 16)
+      .scan<'u', size_t>();
+  args.add_argument("--coverage_points")
+      .help("Points of the coverage curve of each slot.")
+      .default_value<size_t>(32)
+      .scan<'u', size_t>();
+  args.add_argument("--keyset")
+      .help("Path of a keyset file for the embedding training cache (default: none).")
+      .default_value<std::string>("");
+  args.add_argument("--keyset_coverage")
+      .help("Only write the most frequent keys that receive this fraction of accesses.")
+      .default_value<double>(1)
+      .scan<'g', double>();
+  args.add_argument("--slot_size_array")
+      .help("Comma-separated offsets to add to the keys of each slot in the keyset.")
+      .default_value<std::string>("");
+  args.add_argument("--int32_keyset")
+      .help("Write int32 instead of int64 keys to the keyset.")
+      .default_value(false)
+      .implicit_value(true);
+  args.add_argument("--planner_tables")
+      .help("Path of a table statistics file for embedding_sharding_planner (default: none).")
+      .default_value<std::string>("");
+  args.add_argument("--ev_size")
+      .help("Embedding vector size written to --planner_tables.")
+      .default_value<size_t>(128)
+      .scan<'u', size_t>();
+  args.add_argument("--output")
+      .help("Path of the JSON report (default: print to stdout).")
+      .default_value<std::string>("");
+
+  try {
+    args.parse_args(argc, argv);
+  } catch (const std::runtime_error& err) {
+    std::cerr << err.what() << std::endl;
+    std::cout << args;
+    return 1;
+  }
+
+  KeyProfilerParams params;
+  const auto format = args.get<std::string>("--format");
+  if (format == "raw_async") {
+    params.format = DataReaderType_t::RawAsync;
+  } else if (format == "norm") {
+    params.format = DataReaderType_t::Norm;
+  } else {
+    HCTR_OWN_THROW(Error_t::WrongInput, "Unknown format \"" + format + "\".");
+  }
+  params.label_dim = args.get<size_t>("--label_dim");
+  params.dense_dim = args.get<size_t>("--dense_dim");
+  for (const int64_t nnz : parse_list(args.get<std::string>("--nnz_array"))) {
+    params.nnz_array.push_back(static_cast<int>(nnz));
+  }
+  params.i64_input_key = args.get<bool>("--i64_input_key");
+  params.num_threads = args.get<size_t>("--num_threads");
+  if (params.num_threads == 0) {
+    params.num_threads = std::max(std::thread::hardware_concurrency(), 1u);
+  }
+  params.max_exact_bytes = static_cast<size_t>(args.get<double>("--max_exact_gb") * 1e9);
+  params.sketch_width = args.get<size_t>("--sketch_width");
+  params.num_heavy_hitters = args.get<size_t>("--num_heavy_hitters");
+
+  std::vector<std::string> files;
+  if (!args.get<std::string>("--data").empty()) {
+    files.push_back(args.get<std::string>("--data"));
+  }
+  if (!args.get<std::string>("--file_list").empty()) {
+    FileList file_list{args.get<std::string>("--file_list")};
+    for (int i{0}; i < file_list.get_num_of_files(); ++i) {
+      files.push_back(file_list.get_a_file_with_id(i, false));
+    }
+  }
+  HCTR_CHECK_HINT(!files.empty(), "Either --data or --file_list must be given.");
+
+  KeyProfiler profiler{params};
+  const auto begin{std::chrono::steady_clock::now()};
+  for (const std::string& file : files) {
+    HCTR_LOG_S(INFO, WORLD) << "Profiling \"" << file << "\"." << std::endl;
+    profiler.profile(file);
+  }
+  const std::vector<KeyProfile> profiles{profiler.result()};
+  const double seconds{
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count()};
+  HCTR_LOG_S(INFO, WORLD) << "Profiled " << profiler.num_samples() << " samples in " << seconds
+                          << " s." << std::endl;
+
+  const size_t coverage_points{args.get<size_t>("--coverage_points")};
+  nlohmann::json report;
+  report["num_samples"] = profiler.num_samples();
+  report["exact"] = profiler.exact();
+  report["seconds"] = seconds;
+  nlohmann::json tables = nlohmann::json::array();
+  for (size_t slot{0}; slot < profiles.size(); ++slot) {
+    const KeyProfile& profile{profiles[slot]};
+    nlohmann::json entry;
+    entry["slot"] = slot;
+    entry["num_accesses"] = profile.num_accesses;
+    entry["cardinality"] = profile.cardinality;
+    entry["exact"] = profile.exact;
+    for (const double fraction : {0.5, 0.8, 0.9, 0.95, 0.99}) {
+      entry["keys_for_coverage"][std::to_string(fraction).substr(0, 4)] =
+          profile.keys_for_coverage(fraction);
+    }
+    entry["coverage"] = profile.coverage(coverage_points);
+    report["slots"].push_back(entry);
+
+    // Statistics in the format of `tools/sharding_planner`.
+    nlohmann::json table;
+    table["name"] = "slot" + std::to_string(slot);
+    table["vocabulary_size"] = profile.cardinality;
+    table["ev_size"] = args.get<size_t>("--ev_size");
+    table["hotness"] = profiler.num_samples() ? static_cast<double>(profile.num_accesses) /
+                                                    static_cast<double>(profiler.num_samples())
+                                              : 1.;
+    table["coverage"] = entry["coverage"];
+    tables.push_back(table);
+  }
+
+  const auto keyset = args.get<std::string>("--keyset");
+  if (!keyset.empty()) {
+    if (!profiler.exact()) {
+      HCTR_LOG_S(WARNING, WORLD) << "Counts are not exact. The keyset only contains the "
+                                 << params.num_heavy_hitters << " most frequent keys per slot."
+                                 << std::endl;
+    }
+    write_keyset(keyset, profiles, parse_list(args.get<std::string>("--slot_size_array")),
+                 args.get<bool>("--int32_keyset"), args.get<double>("--keyset_coverage"));
+  }
+
+  const auto planner_tables = args.get<std::string>("--planner_tables");
+  if (!planner_tables.empty()) {
+    std::ofstream file(planner_tables);
+    HCTR_CHECK_HINT(file.is_open(), "Unable to open \"", planner_tables, "\" for writing.");
+    file << tables.dump(2) << std::endl;
+  }
+
+  const auto output = args.get<std::string>("--output");
+  if (output.empty()) {
+    std::cout << report.dump(2) << std::endl;
+  } else {
+    std::ofstream file(output);
+    HCTR_CHECK_HINT(file.is_open(), "Unable to open \"", output, "\" for writing.");
+    file << report.dump(2) << std::endl;
+    HCTR_LOG_S(INFO, WORLD) << "Report written to \"" << output << "\"." << std::endl;
+  }
+  return 0;
+}
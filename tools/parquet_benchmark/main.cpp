@@ -0,0 +1,301 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <arrow/api.h>
+#include <arrow/io/file.h>
+#include <parquet/arrow/writer.h>
+#include <parquet/file_reader.h>
+
+#include <algorithm>
+#include <argparse/argparse.hpp>
+#include <chrono>
+#include <core23/logger.hpp>
+#include <data_readers/metadata.hpp>
+#include <data_readers/parquet_cpu_decoder.hpp>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <nlohmann/json.hpp>
+#include <random>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using namespace HugeCTR;
+
+typedef long long Key;
+
+namespace {
+
+struct DatasetParams {
+  size_t num_files;
+  size_t rows_per_file;
+  size_t row_group_size;
+  size_t num_dense;
+  size_t num_cat;
+  size_t max_nnz;
+};
+
+void check(const arrow::Status& status) {
+  HCTR_THROW_IF(!status.ok(), Error_t::UnspecificError, status.ToString());
+}
+
+/**
+ * Writes a synthetic dataset in the layout of the NVTabular preprocessing scripts: one float label,
+ * float dense features and int64 categorical features. The categorical features are multi-hot if
+ * `max_nnz > 1`.
+ */
+void generate_dataset(const std::string& data_dir, const DatasetParams& params) {
+  std::mt19937_64 gen{4711};
+  std::uniform_real_distribution<float> real_dist;
+  std::uniform_int_distribution<int64_t> key_dist{0, 1000L * 1000 * 1000};
+  std::uniform_int_distribution<size_t> nnz_dist{1, params.max_nnz};
+
+  std::vector<std::shared_ptr<arrow::Field>> fields{arrow::field("label", arrow::float32())};
+  nlohmann::json metadata;
+  metadata["labels"].push_back({{"col_name", "label"}, {"index", 0}});
+  for (size_t i{0}; i < params.num_dense; ++i) {
+    const std::string name{"I" + std::to_string(i + 1)};
+    fields.emplace_back(arrow::field(name, arrow::float32()));
+    metadata["conts"].push_back({{"col_name", name}, {"index", 1 + i}});
+  }
+  for (size_t i{0}; i < params.num_cat; ++i) {
+    const std::string name{"C" + std::to_string(i + 1)};
+    fields.emplace_back(arrow::field(
+        name, params.max_nnz > 1 ? arrow::list(arrow::int64()) : arrow::int64()));
+    metadata["cats"].push_back({{"col_name", name}, {"index", 1 + params.num_dense + i}});
+  }
+  const auto schema{arrow::schema(fields)};
+
+  for (size_t file{0}; file < params.num_files; ++file) {
+    std::vector<std::shared_ptr<arrow::Array>> columns;
+    for (size_t col{0}; col < 1 + params.num_dense; ++col) {
+      arrow::FloatBuilder builder;
+      check(builder.Reserve(static_cast<int64_t>(params.rows_per_file)));
+      for (size_t row{0}; row < params.rows_per_file; ++row) {
+        builder.UnsafeAppend(real_dist(gen));
+      }
+      columns.emplace_back(builder.Finish().ValueOrDie());
+    }
+    for (size_t col{0}; col < params.num_cat; ++col) {
+      auto key_builder{std::make_shared<arrow::Int64Builder>()};
+      arrow::ListBuilder list_builder{arrow::default_memory_pool(), key_builder};
+      for (size_t row{0}; row < params.rows_per_file; ++row) {
+        const size_t nnz{params.max_nnz > 1 ? nnz_dist(gen) : 1};
+        if (params.max_nnz > 1) {
+          check(list_builder.Append());
+        }
+        for (size_t i{0}; i < nnz; ++i) {
+          check(key_builder->Append(key_dist(gen)));
+        }
+      }
+      columns.emplace_back(params.max_nnz > 1 ? list_builder.Finish().ValueOrDie()
+                                              : key_builder->Finish().ValueOrDie());
+    }
+
+    const std::string file_name{std::to_string(file) + ".parquet"};
+    const auto sink{arrow::io::FileOutputStream::Open(data_dir + "/" + file_name).ValueOrDie()};
+    check(parquet::arrow::WriteTable(*arrow::Table::Make(schema, columns),
+                                     arrow::default_memory_pool(), sink,
+                                     static_cast<int64_t>(params.row_group_size)));
+    check(sink->Close());
+    metadata["file_stats"].push_back(
+        {{"file_name", file_name}, {"num_rows", params.rows_per_file}});
+  }
+
+  std::ofstream file(data_dir + "/_metadata.json");
+  HCTR_CHECK_HINT(file.is_open(), "Unable to write the metadata to \"", data_dir, "\".");
+  file << metadata.dump(2) << std::endl;
+  HCTR_LOG_S(INFO, WORLD) << "Generated " << params.num_files << " files in \"" << data_dir
+                          << "\"." << std::endl;
+}
+
+/**
+ * Decodes all row groups `num_epochs` times, keeping `in_flight` row groups queued.
+ */
+nlohmann::json run(const std::vector<std::pair<std::string, int>>& row_groups,
+                   const std::vector<std::string>& label_dense_cols,
+                   const std::vector<std::string>& cat_cols, const size_t max_nnz,
+                   const size_t num_threads, const size_t in_flight, const size_t num_epochs) {
+  const std::vector<DataReaderSparseParam> params{
+      {"data", std::vector<int>(cat_cols.size(), static_cast<int>(max_nnz)), max_nnz == 1,
+       static_cast<int>(cat_cols.size())}};
+  ParquetCPUDecoder<Key, int64_t> decoder{label_dense_cols, cat_cols, params, {}, num_threads,
+                                          false};
+
+  size_t num_rows{0};
+  size_t num_bytes{0};
+  const auto begin{std::chrono::steady_clock::now()};
+  const size_t num_tasks{row_groups.size() * num_epochs};
+  for (size_t submitted{0}, completed{0}; completed < num_tasks;) {
+    while (submitted < num_tasks && decoder.num_pending() < in_flight) {
+      const auto& row_group{row_groups[submitted++ % row_groups.size()]};
+      decoder.submit(row_group.first, row_group.second);
+    }
+    auto batch{decoder.next()};
+    ++completed;
+    num_rows += batch->num_rows;
+    num_bytes += batch->num_rows * batch->label_dense_dim * sizeof(float);
+    for (const auto& sparse : batch->sparse) {
+      num_bytes += (batch->num_rows * cat_cols.size() + 1) * sizeof(int64_t);
+      num_bytes += sparse.nnz * sizeof(Key);
+    }
+    decoder.recycle(std::move(batch));
+  }
+  const double seconds{
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count()};
+
+  nlohmann::json result;
+  result["threads"] = num_threads;
+  result["in_flight"] = in_flight;
+  result["rows"] = num_rows;
+  result["seconds"] = seconds;
+  result["rows_per_s"] = static_cast<double>(num_rows) / seconds;
+  result["output_mib_per_s"] = static_cast<double>(num_bytes) / seconds / (1024 * 1024);
+  HCTR_LOG_S(INFO, WORLD) << num_threads << " threads: " << result["rows_per_s"].get<double>()
+                          << " rows/s, " << result["output_mib_per_s"].get<double>()
+                          << " MiB/s" << std::endl;
+  return result;
+}
+
+}  // namespace
+
+/**
+ * Measures how fast `ParquetCPUDecoder` turns Parquet row groups into ready-to-upload batches,
+ * with 1, 2, 4, ... up to `--max_threads` decoding threads. No GPU is required.
+ *
+ * Example (generate 8 files of 1M Criteo-like rows, then decode them twice):
+ *   parquet_decode_bench --data_dir /tmp/pq --generate --num_files 8 --epochs 2 --max_threads 16
+ */
+int main(int argc, char** argv) {
+  argparse::ArgumentParser args;
+
+  args.add_argument("--data_dir")
+      .help("Directory with the Parquet files and their _metadata.json.")
+      .default_value<std::string>("./parquet_decode_bench");
+  args.add_argument("--generate")
+      .help("Write a synthetic dataset to the data directory first.")
+      .default_value(false)
+      .implicit_value(true);
+  args.add_argument("--num_files")
+      .help("Number of files to generate.")
+      .default_value<size_t>(4)
+      .scan<'u', size_t>();
+  args.add_argument("--rows_per_file")
+      .help("Number of rows per generated file.")
+      .default_value<size_t>(1000L * 1000)
+      .scan<'u', size_t>();
+  args.add_argument("--row_group_size")
+      .help("Number of rows per generated row group.")
+      .default_value<size_t>(128L * 1024)
+      .scan<'u', size_t>();
+  args.add_argument("--num_dense")
+      .help("Number of generated dense columns.")
+      .default_value<size_t>(13)
+      .scan<'u', size_t>();
+  args.add_argument("--num_cat")
+      .help("Number of generated categorical columns.")
+      .default_value<size_t>(26)
+      .scan<'u', size_t>();
+  args.add_argument("--max_nnz")
+      .help("Maximum number of keys per categorical feature (1 = one-hot).")
+      .default_value<size_t>(1)
+      .scan<'u', size_t>();
+  args.add_argument("--max_threads")
+      .help("Largest number of decoding threads to measure.")
+      .default_value<size_t>(std::thread::hardware_concurrency())
+      .scan<'u', size_t>();
+  args.add_argument("--epochs")
+      .help("Number of passes over all row groups per measurement.")
+      .default_value<size_t>(1)
+      .scan<'u', size_t>();
+  args.add_argument("--output")
+      .help("Path of the JSON report (default: print to stdout).")
+      .default_value<std::string>("");
+
+  try {
+    args.parse_args(argc, argv);
+  } catch (const std::runtime_error& err) {
+    std::cerr << err.what() << std::endl;
+    std::cout << args;
+    return 1;
+  }
+
+  const auto data_dir = args.get<std::string>("--data_dir");
+  const auto max_nnz = std::max(args.get<size_t>("--max_nnz"), size_t{1});
+  const auto max_threads = std::max(args.get<size_t>("--max_threads"), size_t{1});
+  const auto num_epochs = args.get<size_t>("--epochs");
+  const auto output = args.get<std::string>("--output");
+
+  if (args.get<bool>("--generate")) {
+    std::filesystem::create_directories(data_dir);
+    DatasetParams params;
+    params.num_files = args.get<size_t>("--num_files");
+    params.rows_per_file = args.get<size_t>("--rows_per_file");
+    params.row_group_size = args.get<size_t>("--row_group_size");
+    params.num_dense = args.get<size_t>("--num_dense");
+    params.num_cat = args.get<size_t>("--num_cat");
+    params.max_nnz = max_nnz;
+    generate_dataset(data_dir, params);
+  }
+
+  const std::string metadata_path{data_dir + "/_metadata.json"};
+  Metadata metadata;
+  metadata.get_parquet_metadata(metadata_path);
+  const std::vector<std::string> label_dense_cols{
+      ParquetCPUDecoder<Key, int64_t>::label_dense_columns(metadata)};
+  const std::vector<std::string> cat_cols{ParquetCPUDecoder<Key, int64_t>::cat_columns(metadata)};
+
+  std::vector<std::pair<std::string, int>> row_groups;
+  {
+    nlohmann::json config;
+    std::ifstream file(metadata_path);
+    file >> config;
+    for (const auto& stats : config["file_stats"]) {
+      const std::string path{data_dir + "/" + stats["file_name"].get<std::string>()};
+      const int num_row_groups{
+          parquet::ParquetFileReader::OpenFile(path)->metadata()->num_row_groups()};
+      for (int rg{0}; rg < num_row_groups; ++rg) {
+        row_groups.emplace_back(path, rg);
+      }
+    }
+  }
+  HCTR_CHECK_HINT(!row_groups.empty(), "No row groups found in \"", data_dir, "\".");
+
+  nlohmann::json report;
+  report["data_dir"] = data_dir;
+  report["row_groups"] = row_groups.size();
+  report["label_dense_columns"] = label_dense_cols.size();
+  report["cat_columns"] = cat_cols.size();
+  for (size_t num_threads{1};; num_threads = std::min(num_threads * 2, max_threads)) {
+    report["runs"].push_back(run(row_groups, label_dense_cols, cat_cols, max_nnz, num_threads,
+                                 2 * num_threads, num_epochs));
+    if (num_threads == max_threads) {
+      break;
+    }
+  }
+
+  if (output.empty()) {
+    std::cout << report.dump(2) << std::endl;
+  } else {
+    std::ofstream file(output);
+    HCTR_CHECK_HINT(file.is_open(), "Unable to open \"", output, "\" for writing.");
+    file << report.dump(2) << std::endl;
+    HCTR_LOG_S(INFO, WORLD) << "Report written to \"" << output << "\"." << std::endl;
+  }
+  return 0;
+}
@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <argparse/argparse.hpp>
+#include <core23/logger.hpp>
+#include <data_readers/raw_async_packed.hpp>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+using namespace HugeCTR;
+
+int main(int argc, char** argv) {
+  argparse::ArgumentParser args;
+
+  args.add_argument("--input")
+      .help("Batch-major RawAsync file, e.g. written by raw_async_repacker.")
+      .required();
+  args.add_argument("--output").help("Packed output file.").required();
+  args.add_argument("--label_dim")
+      .help("Labels per sample.")
+      .default_value<size_t>(1)
+      .scan<'u', size_t>();
+  args.add_argument("--dense_dim")
+      .help("Dense features per sample.")
+      .default_value<size_t>(13)
+      .scan<'u', size_t>();
+  args.add_argument("--nnz_array")
+      .help("Comma-separated keys per slot.")
+      .default_value<std::string>("");
+  args.add_argument("--i64_key")
+      .help("Keys are int64 instead of uint32.")
+      .default_value(false)
+      .implicit_value(true);
+  args.add_argument("--block_samples")
+      .help("Samples per encoded block. Readers decode whole blocks.")
+      .default_value<size_t>(8192)
+      .scan<'u', size_t>();
+  args.add_argument("--num_threads")
+      .help("Number of threads (default: all hardware threads).")
+      .default_value<size_t>(0)
+      .scan<'u', size_t>();
+
+  try {
+    args.parse_args(argc, argv);
+  } catch (const std::runtime_error& err) {
+    std::cerr << err.what() << std::endl;
+    std::cout << args;
+    return 1;
+  }
+
+  RawAsyncPackedLayout layout;
+  layout.label_dense_dim = args.get<size_t>("--label_dim") + args.get<size_t>("--dense_dim");
+  std::stringstream nnz_array(args.get<std::string>("--nnz_array"));
+  for (std::string nnz; std::getline(nnz_array, nnz, ',');) {
+    if (!nnz.empty()) {
+      layout.num_keys += std::stoul(nnz);
+    }
+  }
+  layout.key_bytes = args.get<bool>("--i64_key") ? 8 : 4;
+  size_t num_threads = args.get<size_t>("--num_threads");
+  if (num_threads == 0) {
+    num_threads = std::max(std::thread::hardware_concurrency(), 1u);
+  }
+
+  // The packer logs the compression ratio and time.
+  pack_raw_async(args.get<std::string>("--input"), args.get<std::string>("--output"), layout,
+                 args.get<size_t>("--block_samples"), num_threads);
+  return 0;
+}
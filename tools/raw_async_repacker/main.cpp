@@ -0,0 +1,178 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <argparse/argparse.hpp>
+#include <core23/logger.hpp>
+#include <data_readers/file_list.hpp>
+#include <data_readers/raw_async_repacker.hpp>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace HugeCTR;
+
+namespace {
+
+std::vector<std::string> split(const std::string& list) {
+  std::vector<std::string> values;
+  std::stringstream stream(list);
+  std::string value;
+  while (std::getline(stream, value, ',')) {
+    if (!value.empty()) {
+      values.push_back(value);
+    }
+  }
+  return values;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  argparse::ArgumentParser args;
+
+  args.add_argument("--format")
+      .help("Input format: norm, raw, raw_async or parquet.")
+      .default_value<std::string>("norm");
+  args.add_argument("--file_list")
+      .help("File list of the input dataset, in the format used by the data readers.")
+      .default_value<std::string>("");
+  args.add_argument("--data")
+      .help("Single input file. Alternative to --file_list.")
+      .default_value<std::string>("");
+  args.add_argument("--label_dim")
+      .help("Labels per sample.")
+      .default_value<size_t>(1)
+      .scan<'u', size_t>();
+  args.add_argument("--dense_dim")
+      .help("Dense features per sample.")
+      .default_value<size_t>(13)
+      .scan<'u', size_t>();
+  args.add_argument("--nnz_array")
+      .help("Comma-separated keys per slot. Every input sample must have exactly this many.")
+      .default_value<std::string>("");
+  args.add_argument("--i64_input_key")
+      .help("Input keys are int64 instead of uint32.")
+      .default_value(false)
+      .implicit_value(true);
+  args.add_argument("--int_label_dense")
+      .help("Raw and RawAsync input: label and dense values are integers instead of floats.")
+      .default_value(false)
+      .implicit_value(true);
+  args.add_argument("--parquet_metadata")
+      .help("Path of _metadata.json (default: next to the first Parquet file).")
+      .default_value<std::string>("");
+  args.add_argument("--layout")
+      .help("Output layout: batch_major (one file) or feature_major (one file per slot).")
+      .default_value<std::string>("batch_major");
+  args.add_argument("--i64_output_key")
+      .help("Write keys as int64 instead of uint32.")
+      .default_value(false)
+      .implicit_value(true);
+  args.add_argument("--int_output_label_dense")
+      .help("Write label and dense values as int32 instead of float.")
+      .default_value(false)
+      .implicit_value(true);
+  args.add_argument("--output_dirs")
+      .help("Comma-separated output directories. Files are striped over all of them.")
+      .default_value<std::string>(".");
+  args.add_argument("--output_name")
+      .help("Name of the output dataset.")
+      .default_value<std::string>("data.bin");
+  args.add_argument("--stripe_size_kb")
+      .help("Stripe unit in KiB.")
+      .default_value<size_t>(1024)
+      .scan<'u', size_t>();
+  args.add_argument("--batch_size")
+      .help("Drop the samples that do not fill a whole batch of this size (default: keep all).")
+      .default_value<size_t>(0)
+      .scan<'u', size_t>();
+  args.add_argument("--num_threads")
+      .help("Number of threads (default: all hardware threads).")
+      .default_value<size_t>(0)
+      .scan<'u', size_t>();
+  args.add_argument("--block_size_mb")
+      .help("Target size of each write in MiB.")
+      .default_value<size_t>(16)
+      .scan<'u', size_t>();
+
+  try {
+    args.parse_args(argc, argv);
+  } catch (const std::runtime_error& err) {
+    std::cerr << err.what() << std::endl;
+    std::cout << args;
+    return 1;
+  }
+
+  RawAsyncRepackerParams params;
+  const auto format = args.get<std::string>("--format");
+  if (format == "norm") {
+    params.format = DataReaderType_t::Norm;
+  } else if (format == "raw") {
+    params.format = DataReaderType_t::Raw;
+  } else if (format == "raw_async") {
+    params.format = DataReaderType_t::RawAsync;
+  } else if (format == "parquet") {
+    params.format = DataReaderType_t::Parquet;
+  } else {
+    HCTR_OWN_THROW(Error_t::WrongInput, "Unknown format \"" + format + "\".");
+  }
+  params.label_dim = args.get<size_t>("--label_dim");
+  params.dense_dim = args.get<size_t>("--dense_dim");
+  for (const std::string& nnz : split(args.get<std::string>("--nnz_array"))) {
+    params.nnz_array.push_back(std::stoi(nnz));
+  }
+  params.i64_input_key = args.get<bool>("--i64_input_key");
+  params.float_label_dense = !args.get<bool>("--int_label_dense");
+  params.parquet_metadata = args.get<std::string>("--parquet_metadata");
+
+  const auto layout = args.get<std::string>("--layout");
+  if (layout == "batch_major") {
+    params.layout = RawAsyncLayout::BatchMajor;
+  } else if (layout == "feature_major") {
+    params.layout = RawAsyncLayout::FeatureMajor;
+  } else {
+    HCTR_OWN_THROW(Error_t::WrongInput, "Unknown layout \"" + layout + "\".");
+  }
+  params.i64_output_key = args.get<bool>("--i64_output_key");
+  params.float_output_label_dense = !args.get<bool>("--int_output_label_dense");
+  params.output_dirs = split(args.get<std::string>("--output_dirs"));
+  params.stripe_size_bytes = args.get<size_t>("--stripe_size_kb") * 1024;
+  params.batch_size = args.get<size_t>("--batch_size");
+  params.num_threads = args.get<size_t>("--num_threads");
+  if (params.num_threads == 0) {
+    params.num_threads = std::max(std::thread::hardware_concurrency(), 1u);
+  }
+  params.block_size_bytes = args.get<size_t>("--block_size_mb") * 1024 * 1024;
+
+  std::vector<std::string> files;
+  if (!args.get<std::string>("--data").empty()) {
+    files.push_back(args.get<std::string>("--data"));
+  }
+  if (!args.get<std::string>("--file_list").empty()) {
+    FileList file_list{args.get<std::string>("--file_list")};
+    for (int i{0}; i < file_list.get_num_of_files(); ++i) {
+      files.push_back(file_list.get_a_file_with_id(i, false));
+    }
+  }
+  HCTR_CHECK_HINT(!files.empty(), "Either --data or --file_list must be given.");
+
+  // The repacker logs the throughput.
+  const RawAsyncRepacker repacker{params};
+  repacker.repack(files, args.get<std::string>("--output_name"));
+  return 0;
+}
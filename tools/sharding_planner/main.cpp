@@ -0,0 +1,186 @@
+/*
+ * Copyright (c) 2023, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <argparse/argparse.hpp>
+#include <core23/logger.hpp>
+#include <embeddings/sharding_planner.hpp>
+#include <fstream>
+#include <iostream>
+#include <nlohmann/json.hpp>
+#include <string>
+#include <vector>
+
+using namespace HugeCTR;
+
+namespace {
+
+/**
+ * Reads the table statistics. The file holds a list of objects such as
+ *
+ *   {"name": "t0", "vocabulary_size": 1000000, "ev_size": 128, "hotness": 1, "num_lookups": 1,
+ *    "combiner": "sum", "coverage": [[0.01, 0.6], [0.1, 0.9]]}
+ *
+ * `hotness`, `num_lookups`, `combiner` and `coverage` are optional. `coverage` is in the format
+ * produced by the key-frequency profilers.
+ */
+std::vector<ShardingTableStats> load_tables(const std::string& path) {
+  std::ifstream file(path);
+  HCTR_CHECK_HINT(file.is_open(), "Unable to open \"", path, "\".");
+  nlohmann::json config;
+  file >> config;
+  if (config.is_object()) {
+    config = config.at("tables");
+  }
+
+  std::vector<ShardingTableStats> tables;
+  for (const auto& entry : config) {
+    ShardingTableStats& table{tables.emplace_back()};
+    table.name = entry.at("name").get<std::string>();
+    table.vocabulary_size = entry.at("vocabulary_size").get<int64_t>();
+    table.ev_size = entry.at("ev_size").get<int>();
+    table.hotness = entry.value("hotness", 1.);
+    table.num_lookups = entry.value("num_lookups", 1);
+    table.concat = entry.value("combiner", std::string{"sum"}) == "concat";
+    if (entry.contains("coverage")) {
+      table.coverage = entry["coverage"].get<std::vector<std::pair<double, double>>>();
+    }
+  }
+  return tables;
+}
+
+nlohmann::json to_json(const ShardingCost& cost) {
+  nlohmann::json json;
+  json["step_time_ms"] = cost.step_time * 1e3;
+  json["all_reduce_time_ms"] = cost.all_reduce_time * 1e3;
+  json["fits"] = cost.fits;
+  for (size_t gpu{0}; gpu < cost.memory.size(); ++gpu) {
+    nlohmann::json per_gpu;
+    per_gpu["gpu"] = gpu;
+    per_gpu["lookup_time_ms"] = cost.lookup_time[gpu] * 1e3;
+    per_gpu["comm_time_ms"] = cost.comm_time[gpu] * 1e3;
+    per_gpu["memory_gb"] = cost.memory[gpu] / 1e9;
+    json["gpus"].push_back(per_gpu);
+  }
+  return json;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  argparse::ArgumentParser args;
+
+  args.add_argument("--tables")
+      .help("JSON file with the statistics of the embedding tables.")
+      .required();
+  args.add_argument("--num_nodes")
+      .help("Number of nodes.")
+      .default_value<size_t>(1)
+      .scan<'u', size_t>();
+  args.add_argument("--gpus_per_node")
+      .help("Number of GPUs per node.")
+      .default_value<size_t>(8)
+      .scan<'u', size_t>();
+  args.add_argument("--memory_per_gpu")
+      .help("GB per GPU available for embedding tables and optimizer states.")
+      .default_value<double>(32)
+      .scan<'g', double>();
+  args.add_argument("--hbm_bandwidth")
+      .help("Effective GB/s of random embedding row accesses.")
+      .default_value<double>(1000)
+      .scan<'g', double>();
+  args.add_argument("--intra_node_bandwidth")
+      .help("GB/s per GPU within a node.")
+      .default_value<double>(150)
+      .scan<'g', double>();
+  args.add_argument("--inter_node_bandwidth")
+      .help("GB/s per GPU between nodes.")
+      .default_value<double>(25)
+      .scan<'g', double>();
+  args.add_argument("--batch_size")
+      .help("Global batch size.")
+      .default_value<size_t>(65536)
+      .scan<'u', size_t>();
+  args.add_argument("--optimizer_states")
+      .help("Optimizer state values per embedding value (SGD: 0, Adagrad: 1, Adam: 2).")
+      .default_value<size_t>(0)
+      .scan<'u', size_t>();
+  args.add_argument("--no_data_parallel")
+      .help("Do not replicate tables.")
+      .default_value(false)
+      .implicit_value(true);
+  args.add_argument("--no_row_wise")
+      .help("Do not split tables across GPUs.")
+      .default_value(false)
+      .implicit_value(true);
+  args.add_argument("--no_hierarchical")
+      .help("Do not consider hierarchical communication.")
+      .default_value(false)
+      .implicit_value(true);
+  args.add_argument("--output")
+      .help("Path of the JSON plan (default: print to stdout).")
+      .default_value<std::string>("");
+
+  try {
+    args.parse_args(argc, argv);
+  } catch (const std::runtime_error& err) {
+    std::cerr << err.what() << std::endl;
+    std::cout << args;
+    return 1;
+  }
+
+  const std::vector<ShardingTableStats> tables{load_tables(args.get<std::string>("--tables"))};
+
+  ShardingHardware hardware;
+  hardware.num_nodes = args.get<size_t>("--num_nodes");
+  hardware.gpus_per_node = args.get<size_t>("--gpus_per_node");
+  hardware.memory_per_gpu = args.get<double>("--memory_per_gpu") * 1e9;
+  hardware.hbm_bandwidth = args.get<double>("--hbm_bandwidth") * 1e9;
+  hardware.intra_node_bandwidth = args.get<double>("--intra_node_bandwidth") * 1e9;
+  hardware.inter_node_bandwidth = args.get<double>("--inter_node_bandwidth") * 1e9;
+
+  ShardingPlannerParams params;
+  params.batch_size = args.get<size_t>("--batch_size");
+  params.optimizer_states = args.get<size_t>("--optimizer_states");
+  params.allow_data_parallel = !args.get<bool>("--no_data_parallel");
+  params.allow_row_wise = !args.get<bool>("--no_row_wise");
+  params.allow_hierarchical = !args.get<bool>("--no_hierarchical");
+
+  const ShardingPlanner planner{tables, hardware, params};
+  const ShardingPlan plan{planner.plan()};
+  if (!plan.cost.fits) {
+    HCTR_LOG_S(WARNING, WORLD) << "No plan satisfies the memory limit of "
+                               << args.get<double>("--memory_per_gpu") << " GB per GPU."
+                               << std::endl;
+  }
+
+  // Arguments of EmbeddingCollectionConfig.shard() and the communication strategy.
+  nlohmann::json report;
+  report["shard_matrix"] = plan.shard_matrix(tables, hardware.num_gpus());
+  report["shard_strategy"] = plan.shard_strategy(tables);
+  report["comm_strategy"] = plan.hierarchical ? "Hierarchical" : "Uniform";
+  report["cost"] = to_json(plan.cost);
+
+  const auto output = args.get<std::string>("--output");
+  if (output.empty()) {
+    std::cout << report.dump(2) << std::endl;
+  } else {
+    std::ofstream file(output);
+    HCTR_CHECK_HINT(file.is_open(), "Unable to open \"", output, "\" for writing.");
+    file << report.dump(2) << std::endl;
+    HCTR_LOG_S(INFO, WORLD) << "Plan written to \"" << output << "\"." << std::endl;
+  }
+  return 0;
+}